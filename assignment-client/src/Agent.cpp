@@ -409,6 +409,7 @@ void Agent::executeScript() {
 
         using namespace recording;
         static const FrameType AVATAR_FRAME_TYPE = Frame::registerFrameType(AvatarData::FRAME_NAME);
+        Frame::registerKeyframeTest(AVATAR_FRAME_TYPE, AvatarFrameCodec::isKeyframe);
         Frame::registerFrameHandler(AVATAR_FRAME_TYPE, [scriptedAvatar](Frame::ConstPointer frame) {
 
             auto recordingInterface = DependencyManager::get<RecordingScriptingInterface>();
@@ -519,6 +520,7 @@ void Agent::executeScript() {
 
         Frame::clearFrameHandler(AUDIO_FRAME_TYPE);
         Frame::clearFrameHandler(AVATAR_FRAME_TYPE);
+        Frame::clearKeyframeTest(AVATAR_FRAME_TYPE);
 
         if (recordingInterface->isPlaying()) {
             recordingInterface->stopPlaying();
@@ -764,14 +766,32 @@ void Agent::processAgentAvatarAudio() {
                 _shouldMuteRecordingAudio = true;
             }
             
-            auto audioData = _avatarSound->getAudioData();
-            nextSoundOutput = reinterpret_cast<const int16_t*>(audioData->rawData()
-                    + _numAvatarSoundSentBytes);
+            bool isSoundFinished = false;
+            if (_avatarSound->isStreaming()) {
+                // long sounds are decoded as they are sent
+                if (!_avatarSoundReader) {
+                    _avatarSoundReader.reset(new StreamingAudioReader(_avatarSound->getStreamingData()));
+                }
+                int numChannels = _avatarSoundReader->getData()->getNumChannels();
+                int numFramesToRead = AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL / numChannels;
+                int numFramesRead = _avatarSoundReader->read(_avatarSoundBuffer, numFramesToRead, false);
+
+                nextSoundOutput = _avatarSoundBuffer;
+                numAvailableSamples = (int16_t)(numFramesRead * numChannels);
+                isSoundFinished = numFramesRead < numFramesToRead;
+            } else {
+                auto audioData = _avatarSound->getAudioData();
+                nextSoundOutput = reinterpret_cast<const int16_t*>(audioData->rawData()
+                        + _numAvatarSoundSentBytes);
+
+                int numAvailableBytes = (audioData->getNumBytes() - _numAvatarSoundSentBytes) > AudioConstants::NETWORK_FRAME_BYTES_PER_CHANNEL
+                    ? AudioConstants::NETWORK_FRAME_BYTES_PER_CHANNEL
+                    : audioData->getNumBytes() - _numAvatarSoundSentBytes;
+                numAvailableSamples = (int16_t)numAvailableBytes / sizeof(int16_t);
 
-            int numAvailableBytes = (audioData->getNumBytes() - _numAvatarSoundSentBytes) > AudioConstants::NETWORK_FRAME_BYTES_PER_CHANNEL
-                ? AudioConstants::NETWORK_FRAME_BYTES_PER_CHANNEL
-                : audioData->getNumBytes() - _numAvatarSoundSentBytes;
-            numAvailableSamples = (int16_t)numAvailableBytes / sizeof(int16_t);
+                _numAvatarSoundSentBytes += numAvailableBytes;
+                isSoundFinished = _numAvatarSoundSentBytes == (int)audioData->getNumBytes();
+            }
 
 
             // check if the all of the _numAvatarAudioBufferSamples to be sent are silence
@@ -782,11 +802,11 @@ void Agent::processAgentAvatarAudio() {
                 }
             }
 
-            _numAvatarSoundSentBytes += numAvailableBytes;
-            if (_numAvatarSoundSentBytes == (int)audioData->getNumBytes()) {
+            if (isSoundFinished) {
                 // we're done with this sound object - so set our pointer back to NULL
                 // and our sent bytes back to zero
                 _avatarSound.clear();
+                _avatarSoundReader.reset();
                 _numAvatarSoundSentBytes = 0;
                 _flushEncoder = true;
 
@@ -878,6 +898,15 @@ void Agent::processAgentAvatarAudio() {
     }
 }
 
+void Agent::sendStatsPacket() {
+    QJsonObject statsObject;
+    auto injectorManager = DependencyManager::get<AudioInjectorManager>();
+    if (injectorManager) {
+        statsObject["audio_injectors"] = injectorManager->getStats();
+    }
+    ThreadedAssignment::addPacketStatsAndSendStatsPacket(statsObject);
+}
+
 void Agent::aboutToFinish() {
     // our entity tree is going to go away so tell that to the EntityScriptingInterface
     DependencyManager::get<EntityScriptingInterface>()->setEntityTree(nullptr);
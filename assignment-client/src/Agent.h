@@ -58,6 +58,7 @@ public:
     QUuid getSessionUUID() const;
 
     virtual void aboutToFinish() override;
+    virtual void sendStatsPacket() override;
 
 public slots:
     void run() override;
@@ -97,7 +98,7 @@ private:
     MixedAudioStream _receivedAudioStream;
     float _lastReceivedAudioLoudness;
 
-    void setAvatarSound(SharedSoundPointer avatarSound) { _avatarSound = avatarSound; }
+    void setAvatarSound(SharedSoundPointer avatarSound) { _avatarSound = avatarSound; _avatarSoundReader.reset(); }
 
     void sendAvatarIdentityPacket();
     void queryAvatars();
@@ -109,6 +110,8 @@ private:
     SharedSoundPointer _avatarSound;
     bool _shouldMuteRecordingAudio { false };
     int _numAvatarSoundSentBytes = 0;
+    std::unique_ptr<StreamingAudioReader> _avatarSoundReader;
+    int16_t _avatarSoundBuffer[AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL];
     bool _isAvatar = false;
     QTimer* _avatarIdentityTimer = nullptr;
     QTimer* _avatarQueryTimer = nullptr;
@@ -0,0 +1,152 @@
+//
+//  AssetFileCache.cpp
+//  assignment-client/src/assets
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AssetFileCache.h"
+
+#include "AssetServerLogging.h"
+
+const qint64 AssetFileCache::DEFAULT_MAX_SIZE = 512 * 1024 * 1024;
+
+// a single asset may not take more than this fraction of the cache, so one large file can't flush all the others
+static const qint64 MAX_ENTRY_SIZE_DIVISOR = 8;
+
+std::shared_ptr<MappedAssetFile> MappedAssetFile::open(const QString& filePath, qint64 maxSize) {
+    std::shared_ptr<MappedAssetFile> mappedFile(new MappedAssetFile(filePath));
+    if (!mappedFile->_file.open(QIODevice::ReadOnly)) {
+        return nullptr;
+    }
+
+    mappedFile->_size = mappedFile->_file.size();
+    if (mappedFile->_size > maxSize) {
+        // a large asset would flush the rest of the cache, the requested ranges are streamed from disk instead
+        qCDebug(asset_server) << "Asset file" << filePath << "is" << mappedFile->_size << "bytes, over the"
+            << maxSize << "byte cache entry limit - streaming it from disk";
+        return nullptr;
+    }
+    if (mappedFile->_size > 0) {
+        auto data = mappedFile->_file.map(0, mappedFile->_size);
+        if (data) {
+            mappedFile->_data = reinterpret_cast<const char*>(data);
+            mappedFile->_isMapped = true;
+        } else {
+            // some file systems don't support mapping, the requested ranges are streamed from disk instead
+            qCWarning(asset_server) << "Could not map asset file" << filePath << "-" << mappedFile->_file.errorString()
+                << "- streaming it from disk";
+            return nullptr;
+        }
+    }
+    return mappedFile;
+}
+
+MappedAssetFile::~MappedAssetFile() {
+    if (_isMapped) {
+        _file.unmap(reinterpret_cast<uchar*>(const_cast<char*>(_data)));
+    }
+}
+
+AssetFileCache::AssetFileCache(const QDir& filesDirectory, qint64 maxSize) :
+    _filesDirectory(filesDirectory),
+    _maxSize(maxSize),
+    _maxEntrySize(maxSize / MAX_ENTRY_SIZE_DIVISOR)
+{
+}
+
+MappedAssetFilePointer AssetFileCache::get(const QString& hexHash, bool& fromCache) {
+    QMutexLocker locker(&_mutex);
+    ++_requests;
+
+    // another request is already mapping this asset, wait for it
+    bool waited = false;
+    while (_mappingHashes.contains(hexHash)) {
+        waited = true;
+        _mappingFinished.wait(&_mutex);
+    }
+
+    auto it = _entriesByHash.find(hexHash);
+    if (it != _entriesByHash.end()) {
+        ++_hits;
+        if (waited) {
+            ++_coalesced;
+        }
+        _entries.splice(_entries.begin(), _entries, it.value());
+        fromCache = true;
+        return _entries.front().file;
+    }
+
+    fromCache = false;
+    _mappingHashes.insert(hexHash);
+    auto maxEntrySize = _maxEntrySize;
+    locker.unlock();
+
+    auto file = MappedAssetFile::open(getFilePath(hexHash), maxEntrySize);
+
+    locker.relock();
+    _mappingHashes.remove(hexHash);
+    if (file && file->getSize() <= _maxEntrySize) {
+        _entries.push_front({ hexHash, file });
+        _entriesByHash.insert(hexHash, _entries.begin());
+        _size += file->getSize();
+        evict();
+    }
+    _mappingFinished.wakeAll();
+
+    return file;
+}
+
+void AssetFileCache::remove(const QString& hexHash) {
+    QMutexLocker locker(&_mutex);
+    auto it = _entriesByHash.find(hexHash);
+    if (it != _entriesByHash.end()) {
+        _size -= it.value()->file->getSize();
+        _entries.erase(it.value());
+        _entriesByHash.erase(it);
+    }
+}
+
+void AssetFileCache::recordServed(qint64 bytes, bool fromCache) {
+    QMutexLocker locker(&_mutex);
+    _bytesServed += bytes;
+    if (fromCache) {
+        _bytesServedFromCache += bytes;
+    }
+}
+
+void AssetFileCache::setMaxSize(qint64 maxSize) {
+    QMutexLocker locker(&_mutex);
+    _maxSize = maxSize;
+    _maxEntrySize = maxSize / MAX_ENTRY_SIZE_DIVISOR;
+    evict();
+}
+
+// Must be called with _mutex held
+void AssetFileCache::evict() {
+    while (_size > _maxSize && !_entries.empty()) {
+        auto& entry = _entries.back();
+        _size -= entry.file->getSize();
+        _entriesByHash.remove(entry.hash);
+        _entries.pop_back();
+    }
+}
+
+QJsonObject AssetFileCache::getStats() const {
+    QMutexLocker locker(&_mutex);
+
+    QJsonObject stats;
+    stats["cached_assets"] = (int)_entries.size();
+    stats["cached_bytes"] = (double)_size;
+    stats["max_bytes"] = (double)_maxSize;
+    stats["requests"] = (double)_requests;
+    stats["hits"] = (double)_hits;
+    stats["coalesced_requests"] = (double)_coalesced;
+    stats["hit_rate"] = _requests > 0 ? (double)_hits / _requests : 0.0;
+    stats["bytes_served"] = (double)_bytesServed;
+    stats["bytes_served_from_cache"] = (double)_bytesServedFromCache;
+    return stats;
+}
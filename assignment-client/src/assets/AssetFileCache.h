@@ -0,0 +1,102 @@
+//
+//  AssetFileCache.h
+//  assignment-client/src/assets
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AssetFileCache_h
+#define hifi_AssetFileCache_h
+
+#include <list>
+#include <memory>
+
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QHash>
+#include <QtCore/QJsonObject>
+#include <QtCore/QMutex>
+#include <QtCore/QSet>
+#include <QtCore/QWaitCondition>
+
+// An asset file mapped into memory, kept mapped for as long as a request is reading from it
+class MappedAssetFile {
+public:
+    // Returns nullptr if the file doesn't exist, is larger than maxSize or can't be mapped
+    static std::shared_ptr<MappedAssetFile> open(const QString& filePath, qint64 maxSize);
+    ~MappedAssetFile();
+
+    const char* getData() const { return _data; }
+    qint64 getSize() const { return _size; }
+
+private:
+    MappedAssetFile(const QString& filePath) : _file(filePath) {}
+
+    QFile _file;
+    bool _isMapped { false };
+    const char* _data { nullptr };
+    qint64 _size { 0 };
+};
+
+using MappedAssetFilePointer = std::shared_ptr<MappedAssetFile>;
+
+// Size bounded cache of the most recently requested asset files, keyed by content hash.
+// Asset files are named by the hash of their content and never change, so a cached mapping stays valid until the file
+// is deleted.  Concurrent requests for an asset that is being mapped wait for that mapping instead of opening the file
+// again.  All methods are thread safe.
+class AssetFileCache {
+public:
+    static const qint64 DEFAULT_MAX_SIZE;
+
+    AssetFileCache(const QDir& filesDirectory, qint64 maxSize = DEFAULT_MAX_SIZE);
+
+    // Returns the mapped asset file, or nullptr if there is no such asset or it is too large or can't be mapped.
+    // Those are served by reading the requested range from getFilePath().
+    // fromCache is set if the file was already mapped by another request.
+    MappedAssetFilePointer get(const QString& hexHash, bool& fromCache);
+
+    QString getFilePath(const QString& hexHash) const { return _filesDirectory.filePath(hexHash); }
+
+    // Must be called before an asset file is deleted, requests in flight keep their mapping
+    void remove(const QString& hexHash);
+
+    void recordServed(qint64 bytes, bool fromCache);
+
+    void setMaxSize(qint64 maxSize);
+    QJsonObject getStats() const;
+
+private:
+    struct Entry {
+        QString hash;
+        MappedAssetFilePointer file;
+    };
+    using EntryList = std::list<Entry>;
+
+    void evict();
+
+    const QDir _filesDirectory;
+
+    mutable QMutex _mutex;
+    QWaitCondition _mappingFinished;
+    qint64 _maxSize;
+    qint64 _maxEntrySize;
+    qint64 _size { 0 };
+
+    // most recently used first
+    EntryList _entries;
+    QHash<QString, EntryList::iterator> _entriesByHash;
+    QSet<QString> _mappingHashes;
+
+    quint64 _requests { 0 };
+    quint64 _hits { 0 };
+    quint64 _coalesced { 0 };
+    quint64 _bytesServed { 0 };
+    quint64 _bytesServedFromCache { 0 };
+};
+
+using AssetFileCachePointer = std::shared_ptr<AssetFileCache>;
+
+#endif // hifi_AssetFileCache_h
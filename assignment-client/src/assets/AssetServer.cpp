@@ -419,6 +419,13 @@ void AssetServer::completeSetup() {
         return;
     }
 
+    // size of the memory cache of hot assets
+    static const QString ASSETS_MEMORY_CACHE_SIZE_OPTION = "assets_memory_cache_size";
+    static const qint64 BYTES_PER_MEGABYTE = 1024 * 1024;
+    auto memoryCacheSizeJSONValue = assetServerObject[ASSETS_MEMORY_CACHE_SIZE_OPTION];
+    auto memoryCacheSize = (qint64)memoryCacheSizeJSONValue.toInt(AssetFileCache::DEFAULT_MAX_SIZE / BYTES_PER_MEGABYTE);
+    _fileCache = std::make_shared<AssetFileCache>(_filesDirectory, memoryCacheSize * BYTES_PER_MEGABYTE);
+
     // load whatever mappings we currently have from the local file
     if (loadMappingsFromFile()) {
         qCInfo(asset_server) << "Serving files from: " << _filesDirectory.path();
@@ -532,6 +539,7 @@ void AssetServer::cleanupUnmappedFiles() {
             if (!matched) {
                 // remove the unmapped file
                 QFile removeableFile { fileInfo.absoluteFilePath() };
+                _fileCache->remove(filename);
 
                 if (removeableFile.remove()) {
                     qCDebug(asset_server) << "\tDeleted" << filename << "from asset files directory since it is unmapped.";
@@ -872,7 +880,7 @@ void AssetServer::handleAssetGet(QSharedPointer<ReceivedMessage> message, Shared
     }
 
     // Queue task
-    auto task = new SendAssetTask(message, senderNode, _filesDirectory);
+    auto task = new SendAssetTask(message, senderNode, _fileCache);
     _transferTaskPool.start(task);
 }
 
@@ -962,6 +970,10 @@ void AssetServer::sendStatsPacket() {
         serverStats[uuid] = nodeStats;
     });
 
+    if (_fileCache) {
+        serverStats["asset_cache"] = _fileCache->getStats();
+    }
+
     // send off the stats packets
     ThreadedAssignment::addPacketStatsAndSendStatsPacket(serverStats);
 }
@@ -1176,6 +1188,7 @@ bool AssetServer::deleteMappings(const AssetUtils::AssetPathList& paths) {
         for (auto& hash : hashesToCheckForDeletion) {
             // remove the unmapped file
             QFile removeableFile { _filesDirectory.absoluteFilePath(hash) };
+            _fileCache->remove(hash);
 
             if (removeableFile.remove()) {
                 qCDebug(asset_server) << "\tDeleted" << hash << "from asset files directory since it is now unmapped.";
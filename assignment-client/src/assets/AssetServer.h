@@ -18,6 +18,7 @@
 
 #include <ThreadedAssignment.h>
 
+#include "AssetFileCache.h"
 #include "AssetUtils.h"
 #include "ReceivedMessage.h"
 
@@ -156,6 +157,9 @@ private:
     QDir _resourcesDirectory;
     QDir _filesDirectory;
 
+    /// Memory mapped hot assets, shared with the send tasks
+    AssetFileCachePointer _fileCache;
+
     /// Task pool for handling uploads and downloads of assets
     QThreadPool _transferTaskPool;
 
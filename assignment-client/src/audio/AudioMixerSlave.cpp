@@ -512,37 +512,18 @@ void AudioMixerSlave::addStream(AudioMixerClientData::MixableStream& mixableStre
     const int HRTF_DATASET_INDEX = 1;
 
     if (!streamToAdd->lastPopSucceeded()) {
-        bool forceSilentBlock = true;
-
-        if (!streamToAdd->getLastPopOutput().isNull()) {
-            bool isInjector = dynamic_cast<const InjectedAudioStream*>(streamToAdd);
-
-            // in an injector, just go silent - the injector has likely ended
-            // in other inputs (microphone, &c.), repeat with fade to avoid the harsh jump to silence
-            if (!isInjector) {
-                // calculate its fade factor, which depends on how many times it's already been repeated.
-                float fadeFactor = calculateRepeatedFrameFadeFactor(streamToAdd->getConsecutiveNotMixedCount() - 1);
-                if (fadeFactor > 0.0f) {
-                    // apply the fadeFactor to the gain
-                    gain *= fadeFactor;
-                    forceSilentBlock = false;
-                }
-            }
+        // the stream conceals its own starves, so it has either faded out or is an injector that has likely ended;
+        // call renderSilent with a forced silent block to reduce artifacts
+        // (this is not done for stereo streams since they do not go through the HRTF)
+        if (!streamToAdd->isStereo() && !isEcho) {
+            static int16_t silentMonoBlock[AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL] = {};
+            mixableStream.hrtf->render(silentMonoBlock, _mixSamples, HRTF_DATASET_INDEX, azimuth, distance, gain,
+                                       AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+
+            ++stats.hrtfRenders;
         }
 
-        if (forceSilentBlock) {
-            // call renderSilent with a forced silent block to reduce artifacts
-            // (this is not done for stereo streams since they do not go through the HRTF)
-            if (!streamToAdd->isStereo() && !isEcho) {
-                static int16_t silentMonoBlock[AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL] = {};
-                mixableStream.hrtf->render(silentMonoBlock, _mixSamples, HRTF_DATASET_INDEX, azimuth, distance, gain,
-                                           AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
-
-                ++stats.hrtfRenders;
-            }
-
-            return;
-        }
+        return;
     }
 
     // grab the stream from the ring buffer
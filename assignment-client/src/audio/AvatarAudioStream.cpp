@@ -50,6 +50,7 @@ int AvatarAudioStream::parseStreamProperties(PacketType type, const QByteArray&
                 }
                 _decoder = _codec->createDecoder(AudioConstants::SAMPLE_RATE, isStereo ? AudioConstants::STEREO : AudioConstants::MONO);
             }
+            setPlayoutFormat(AudioConstants::SAMPLE_RATE, isStereo ? AudioConstants::STEREO : AudioConstants::MONO);
             qCDebug(audio) << "resetting AvatarAudioStream... codec:" << _selectedCodecName << "isStereo:" << isStereo;
 
             _isStereo = isStereo;
@@ -126,6 +126,9 @@ public:
     void setLastOtherAvatarEncodeTime(NLPacket::LocalID otherAvatar, uint64_t time);
 
     QVector<JointData>& getLastOtherAvatarSentJoints(NLPacket::LocalID otherAvatar) { return _lastOtherAvatarSentJoints[otherAvatar]; }
+    AvatarJointCodec::History& getLastOtherAvatarJointHistory(NLPacket::LocalID otherAvatar) {
+        return _lastOtherAvatarJointHistories[otherAvatar];
+    }
 
     void queuePacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer node);
     int processPackets(const SlaveSharedData& slaveSharedData); // returns number of packets processed
@@ -173,6 +176,8 @@ private:
     // sending to "this" node
     std::unordered_map<NLPacket::LocalID, uint64_t> _lastOtherAvatarEncodeTime;
     std::unordered_map<NLPacket::LocalID, QVector<JointData>> _lastOtherAvatarSentJoints;
+    // what this node knows of the joints of other avatars, their joints are predicted from it
+    std::unordered_map<NLPacket::LocalID, AvatarJointCodec::History> _lastOtherAvatarJointHistories;
 
     uint64_t _identityChangeTimestamp;
     bool _avatarSessionDisplayNameMustChange{ true };
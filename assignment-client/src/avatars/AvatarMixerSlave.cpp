@@ -535,6 +535,7 @@ void AvatarMixerSlave::broadcastAvatarDataToAgent(const SharedNodePointer& node)
         }
 
         QVector<JointData>& lastSentJointsForOther = nodeData->getLastOtherAvatarSentJoints(otherNode->getLocalID());
+        AvatarJointCodec::History& jointHistoryForOther = nodeData->getLastOtherAvatarJointHistory(otherNode->getLocalID());
 
         const bool distanceAdjust = true;
         const bool dropFaceTracking = false;
@@ -545,7 +546,7 @@ void AvatarMixerSlave::broadcastAvatarDataToAgent(const SharedNodePointer& node)
             auto startSerialize = chrono::high_resolution_clock::now();
             QByteArray bytes = otherAvatar->toByteArray(detail, lastEncodeForOther, lastSentJointsForOther,
                 sendStatus, dropFaceTracking, distanceAdjust, myPosition,
-                &lastSentJointsForOther, avatarSpaceAvailable);
+                &lastSentJointsForOther, avatarSpaceAvailable, nullptr, &jointHistoryForOther);
             auto endSerialize = chrono::high_resolution_clock::now();
             _stats.toByteArrayElapsedTime +=
                 (quint64)chrono::duration_cast<chrono::microseconds>(endSerialize - startSerialize).count();
@@ -11,6 +11,8 @@
 
 #include "MessagesMixer.h"
 
+#include <algorithm>
+
 #include <QtCore/QCoreApplication>
 #include <QtCore/QJsonObject>
 #include <QBuffer>
@@ -31,45 +33,55 @@ MessagesMixer::MessagesMixer(ReceivedMessage& message) : ThreadedAssignment(mess
 }
 
 void MessagesMixer::nodeKilled(SharedNodePointer killedNode) {
-    for (auto& channel : _channelSubscribers) {
-        channel.remove(killedNode->getUUID());
+    for (auto& channel : _channels) {
+        removeSubscriber(channel, killedNode);
     }
 }
 
+void MessagesMixer::removeSubscriber(Channel& channel, const SharedNodePointer& node) {
+    auto& subscribers = channel.subscribers;
+    subscribers.erase(std::remove(subscribers.begin(), subscribers.end(), node), subscribers.end());
+}
+
 void MessagesMixer::handleMessages(QSharedPointer<ReceivedMessage> receivedMessage, SharedNodePointer senderNode) {
-    QString channel, message;
+    QString channelName, message;
     QByteArray data;
     QUuid senderID;
     bool isText;
-    MessagesClient::decodeMessagesPacket(receivedMessage, channel, isText, message, data, senderID);
+    MessagesClient::decodeMessagesPacket(receivedMessage, channelName, isText, message, data, senderID);
 
-    auto nodeList = DependencyManager::get<NodeList>();
+    auto& channel = _channels[channelName];
+    ++channel.messagesIn;
+    channel.bytesIn += receivedMessage->getSize();
+    if (channel.subscribers.empty()) {
+        return;
+    }
 
-    nodeList->eachMatchingNode(
-        [&](const SharedNodePointer& node)->bool {
-        return node->getActiveSocket() && _channelSubscribers[channel].contains(node->getUUID());
-    },
-        [&](const SharedNodePointer& node) {
-        auto packetList = isText ? MessagesClient::encodeMessagesPacket(channel, message, senderID) :
-                                   MessagesClient::encodeMessagesDataPacket(channel, data, senderID);
-        nodeList->sendPacketList(std::move(packetList), *node);
-    });
+    // encode once, the slaves copy the payload into the packet of each subscriber
+    auto payload = MessagesClient::encodeMessagesPayload(channelName, isText, isText ? message.toUtf8() : data, senderID);
+    channel.messagesOut += channel.subscribers.size();
+    channel.bytesOut += channel.subscribers.size() * payload.size();
+    _slavePool.send(payload, channel.subscribers);
 }
 
 void MessagesMixer::handleMessagesSubscribe(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode) {
-    QString channel = QString::fromUtf8(message->getMessage());
-    _channelSubscribers[channel] << senderNode->getUUID();
+    QString channelName = QString::fromUtf8(message->getMessage());
+    auto& subscribers = _channels[channelName].subscribers;
+    if (std::find(subscribers.begin(), subscribers.end(), senderNode) == subscribers.end()) {
+        subscribers.push_back(senderNode);
+    }
 }
 
 void MessagesMixer::handleMessagesUnsubscribe(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode) {
-    QString channel = QString::fromUtf8(message->getMessage());
-    if (_channelSubscribers.contains(channel)) {
-        _channelSubscribers[channel].remove(senderNode->getUUID());
+    QString channelName = QString::fromUtf8(message->getMessage());
+    auto it = _channels.find(channelName);
+    if (it != _channels.end()) {
+        removeSubscriber(it.value(), senderNode);
     }
 }
 
 void MessagesMixer::sendStatsPacket() {
-    QJsonObject statsObject, messagesMixerObject;
+    QJsonObject statsObject, messagesMixerObject, channelsObject;
 
     // add stats for each listerner
     DependencyManager::get<NodeList>()->eachNode([&](const SharedNodePointer& node) {
@@ -80,7 +92,33 @@ void MessagesMixer::sendStatsPacket() {
         messagesMixerObject[uuidStringWithoutCurlyBraces(node->getUUID())] = clientStats;
     });
 
+    // add the throughput of each channel since the last stats packet, and forget the channels nobody uses anymore
+    for (auto it = _channels.begin(); it != _channels.end();) {
+        auto& channel = it.value();
+        if (channel.subscribers.empty() && channel.messagesIn == 0) {
+            it = _channels.erase(it);
+            continue;
+        }
+
+        QJsonObject channelStats;
+        channelStats["subscribers"] = (int)channel.subscribers.size();
+        channelStats["messages_in"] = (double)channel.messagesIn;
+        channelStats["bytes_in"] = (double)channel.bytesIn;
+        channelStats["messages_out"] = (double)channel.messagesOut;
+        channelStats["bytes_out"] = (double)channel.bytesOut;
+        channelsObject[it.key()] = channelStats;
+
+        channel.messagesIn = 0;
+        channel.bytesIn = 0;
+        channel.messagesOut = 0;
+        channel.bytesOut = 0;
+        ++it;
+    }
+
     statsObject["messages"] = messagesMixerObject;
+    statsObject["channels"] = channelsObject;
+    statsObject["threads"] = _slavePool.numThreads();
+    statsObject["slave_queue_waits"] = (double)_slavePool.takeNumWaits();
     ThreadedAssignment::addPacketStatsAndSendStatsPacket(statsObject);
 }
 
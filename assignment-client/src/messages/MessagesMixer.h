@@ -15,8 +15,12 @@
 #ifndef hifi_MessagesMixer_h
 #define hifi_MessagesMixer_h
 
+#include <vector>
+
 #include <ThreadedAssignment.h>
 
+#include "MessagesMixerSlavePool.h"
+
 /// Handles assignments of type MessagesMixer - distribution of avatar data to various clients
 class MessagesMixer : public ThreadedAssignment {
     Q_OBJECT
@@ -34,7 +38,20 @@ private slots:
     void handleMessagesUnsubscribe(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode);
 
 private:
-    QHash<QString,QSet<QUuid>> _channelSubscribers;
+    struct Channel {
+        std::vector<SharedNodePointer> subscribers;
+
+        // since the last stats packet
+        quint64 messagesIn { 0 };
+        quint64 bytesIn { 0 };
+        quint64 messagesOut { 0 };
+        quint64 bytesOut { 0 };
+    };
+
+    void removeSubscriber(Channel& channel, const SharedNodePointer& node);
+
+    QHash<QString, Channel> _channels;
+    MessagesMixerSlavePool _slavePool;
 };
 
 #endif // hifi_MessagesMixer_h
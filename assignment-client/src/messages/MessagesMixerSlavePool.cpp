@@ -0,0 +1,110 @@
+//
+//  MessagesMixerSlavePool.cpp
+//  assignment-client/src/messages
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "MessagesMixerSlavePool.h"
+
+#include <algorithm>
+
+#include <MessagesClient.h>
+#include <NodeList.h>
+
+// The mixer waits for a slave this far behind, rather than queueing messages until it runs out of memory.  The lists are
+// reliable and ordered, so none can be dropped.
+static const size_t MAX_QUEUED_FAN_OUTS = 1024;
+
+void MessagesMixerSlaveThread::run() {
+    while (true) {
+        MessagesFanOut fanOut;
+        {
+            Lock lock(_mutex);
+            _condition.wait(lock, [&] { return _stop || !_queue.empty(); });
+            if (_queue.empty()) {
+                return;
+            }
+            fanOut = std::move(_queue.front());
+            _queue.pop_front();
+        }
+        _dequeued.notify_one();
+
+        // each packet list gets a copy of the payload encoded by the mixer
+        auto nodeList = DependencyManager::get<NodeList>();
+        if (!nodeList) {
+            continue;
+        }
+        for (const auto& node : fanOut.recipients) {
+            if (node->getActiveSocket()) {
+                nodeList->sendPacketList(MessagesClient::encodeMessagesPayloadPacket(fanOut.payload), *node);
+            }
+        }
+    }
+}
+
+bool MessagesMixerSlaveThread::queue(MessagesFanOut&& fanOut) {
+    bool waited = false;
+    {
+        Lock lock(_mutex);
+        if (_queue.size() >= MAX_QUEUED_FAN_OUTS) {
+            waited = true;
+            _dequeued.wait(lock, [&] { return _queue.size() < MAX_QUEUED_FAN_OUTS; });
+        }
+        _queue.push_back(std::move(fanOut));
+    }
+    _condition.notify_one();
+    return waited;
+}
+
+void MessagesMixerSlaveThread::stop() {
+    {
+        Lock lock(_mutex);
+        _stop = true;
+    }
+    _condition.notify_one();
+}
+
+void MessagesMixerSlavePool::send(const QByteArray& payload, const std::vector<SharedNodePointer>& recipients) {
+    std::vector<MessagesFanOut> fanOuts(_slaves.size());
+    for (const auto& node : recipients) {
+        auto& fanOut = fanOuts[node->getLocalID() % _slaves.size()];
+        if (fanOut.recipients.empty()) {
+            // shares the payload data, it is only read by the slaves
+            fanOut.payload = payload;
+        }
+        fanOut.recipients.push_back(node);
+    }
+
+    for (size_t i = 0; i < _slaves.size(); ++i) {
+        if (!fanOuts[i].recipients.empty() && _slaves[i]->queue(std::move(fanOuts[i]))) {
+            ++_numWaits;
+        }
+    }
+}
+
+quint64 MessagesMixerSlavePool::takeNumWaits() {
+    auto numWaits = _numWaits;
+    _numWaits = 0;
+    return numWaits;
+}
+
+void MessagesMixerSlavePool::resize(int numThreads) {
+    numThreads = std::max(numThreads, 0);
+
+    // stop the extra slaves, they drain their queue first
+    while ((int)_slaves.size() > numThreads) {
+        auto& slave = _slaves.back();
+        slave->stop();
+        slave->wait();
+        _slaves.pop_back();
+    }
+
+    while ((int)_slaves.size() < numThreads) {
+        _slaves.emplace_back(new MessagesMixerSlaveThread());
+        _slaves.back()->start();
+    }
+}
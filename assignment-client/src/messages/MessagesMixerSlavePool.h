@@ -0,0 +1,75 @@
+//
+//  MessagesMixerSlavePool.h
+//  assignment-client/src/messages
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_MessagesMixerSlavePool_h
+#define hifi_MessagesMixerSlavePool_h
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QThread>
+
+#include <Node.h>
+
+// A message encoded once, to be sent to each of its recipients
+struct MessagesFanOut {
+    QByteArray payload;
+    std::vector<SharedNodePointer> recipients;
+};
+
+class MessagesMixerSlaveThread : public QThread {
+    Q_OBJECT
+    using Mutex = std::mutex;
+    using Lock = std::unique_lock<Mutex>;
+
+public:
+    void run() override final;
+
+    // blocks while the slave is too far behind, returns whether it had to wait
+    bool queue(MessagesFanOut&& fanOut);
+    void stop();
+
+private:
+    Mutex _mutex;
+    std::condition_variable _condition;
+    std::condition_variable _dequeued;
+    std::deque<MessagesFanOut> _queue; // guarded by _mutex
+    bool _stop { false }; // guarded by _mutex
+};
+
+// Slave pool for the messages mixer
+//   Each recipient is always sent to by the same slave, so messages reach it in the order the mixer received them.
+//   MessagesMixerSlavePool is not thread-safe! It should be instantiated and used from a single thread.
+class MessagesMixerSlavePool {
+public:
+    MessagesMixerSlavePool(int numThreads = QThread::idealThreadCount()) { resize(std::max(numThreads, 1)); }
+    ~MessagesMixerSlavePool() { resize(0); }
+
+    // send the payload to the recipients on slave threads
+    void send(const QByteArray& payload, const std::vector<SharedNodePointer>& recipients);
+
+    int numThreads() const { return (int)_slaves.size(); }
+
+    // the times the mixer waited for a slave to catch up, since the last call
+    quint64 takeNumWaits();
+
+private:
+    void resize(int numThreads);
+
+    std::vector<std::unique_ptr<MessagesMixerSlaveThread>> _slaves;
+    quint64 _numWaits { 0 };
+};
+
+#endif // hifi_MessagesMixerSlavePool_h
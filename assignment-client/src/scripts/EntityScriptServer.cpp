@@ -157,6 +157,16 @@ void EntityScriptServer::handleSettings() {
 
     auto entityScriptServerSettings = settingsObject[ENTITY_SCRIPT_SERVER_SETTINGS_KEY].toObject();
 
+    static const QString CALLBACK_PROFILING_OPTION = "callback_profiling";
+    static const QString CALLBACK_BUDGET_OPTION = "callback_budget_usecs";
+
+    _callbackProfiling = entityScriptServerSettings[CALLBACK_PROFILING_OPTION].toBool();
+    _callbackBudgetUsecs = std::max(0, entityScriptServerSettings[CALLBACK_BUDGET_OPTION].toInt());
+    if (_entitiesScriptEngine) {
+        _entitiesScriptEngine->getCallbackProfiler().setEnabled(_callbackProfiling);
+        _entitiesScriptEngine->getCallbackProfiler().setBudgetUsecs(_callbackBudgetUsecs);
+    }
+
     static const QString MAX_ENTITY_PPS_OPTION = "max_total_entity_pps";
     static const QString ENTITY_PPS_PER_SCRIPT = "entity_pps_per_script";
 
@@ -444,6 +454,9 @@ void EntityScriptServer::resetEntitiesScriptEngine() {
 
     newEngine->registerGlobalObject("SoundCache", DependencyManager::get<SoundCacheScriptingInterface>().data());
 
+    newEngine->getCallbackProfiler().setEnabled(_callbackProfiling);
+    newEngine->getCallbackProfiler().setBudgetUsecs(_callbackBudgetUsecs);
+
     // connect this script engines printedMessage signal to the global ScriptEngines these various messages
     auto scriptEngines = DependencyManager::get<ScriptEngines>().data();
     connect(newEngine.data(), &ScriptEngine::printedMessage, scriptEngines, &ScriptEngines::onPrintedMessage);
@@ -548,7 +561,23 @@ void EntityScriptServer::checkAndCallPreload(const EntityItemID& entityID, bool
 }
 
 void EntityScriptServer::sendStatsPacket() {
+    QJsonObject statsObject;
+
+    if (_entitiesScriptEngine) {
+        statsObject["running_entity_scripts"] = _entitiesScriptEngine->getNumRunningEntityScripts();
+
+        auto& profiler = _entitiesScriptEngine->getCallbackProfiler();
+        if (profiler.isActive()) {
+            statsObject["entity_script_callbacks"] = QJsonObject::fromVariantMap(profiler.toVariantMap());
+        }
+    }
+
+    auto injectorManager = DependencyManager::get<AudioInjectorManager>();
+    if (injectorManager) {
+        statsObject["audio_injectors"] = injectorManager->getStats();
+    }
 
+    ThreadedAssignment::addPacketStatsAndSendStatsPacket(statsObject);
 }
 
 void EntityScriptServer::handleOctreePacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode) {
@@ -81,6 +81,9 @@ private:
     int _maxEntityPPS { DEFAULT_MAX_ENTITY_PPS };
     int _entityPPSPerScript { DEFAULT_ENTITY_PPS_PER_SCRIPT };
 
+    bool _callbackProfiling { false };
+    quint64 _callbackBudgetUsecs { 0 };
+
     std::set<QUuid> _logListeners;
     std::vector<std::pair<QUuid, quint64>> _killedListeners;
 
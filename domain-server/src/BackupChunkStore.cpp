@@ -0,0 +1,173 @@
+//
+//  BackupChunkStore.cpp
+//  domain-server/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "BackupChunkStore.h"
+
+#include <array>
+#include <chrono>
+#include <thread>
+
+#include <QCryptographicHash>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+
+const qint64 BackupChunkStore::DEFAULT_MAX_BYTES_PER_SECOND = 16 * 1024 * 1024;
+
+static const QString CHUNKS_DIR { "/chunks/" };
+
+// Chunk boundaries are picked from the content with a gear rolling hash, so an edit only changes the chunks around it
+// instead of shifting every chunk after it.  Chunks average 64KB.
+static const int MIN_CHUNK_SIZE = 16 * 1024;
+static const int MAX_CHUNK_SIZE = 256 * 1024;
+static const int CHUNK_BOUNDARY_SHIFT = 48;
+
+static std::array<uint64_t, 256> makeGearTable() {
+    // the table must never change, or previously stored content would no longer deduplicate
+    std::array<uint64_t, 256> table;
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    for (auto& entry : table) {
+        // splitmix64
+        state += 0x9E3779B97F4A7C15ULL;
+        uint64_t value = state;
+        value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+        entry = value ^ (value >> 31);
+    }
+    return table;
+}
+
+static const std::array<uint64_t, 256> GEAR_TABLE = makeGearTable();
+
+static QString hashChunk(const char* data, int size) {
+    return QCryptographicHash::hash(QByteArray::fromRawData(data, size), QCryptographicHash::Sha256).toHex();
+}
+
+BackupChunkStore::BackupChunkStore(const QString& directory, qint64 maxBytesPerSecond) :
+    _chunksDirectory(directory + CHUNKS_DIR),
+    _maxBytesPerSecond(maxBytesPerSecond)
+{
+    QDir chunksDir { _chunksDirectory };
+    chunksDir.mkpath(".");
+
+    for (const auto& chunkName : chunksDir.entryList(QDir::Files)) {
+        _chunksOnDisk.insert(chunkName);
+    }
+}
+
+bool BackupChunkStore::store(const QByteArray& data, QStringList& chunkHashes) {
+    chunkHashes.clear();
+
+    const char* bytes = data.constData();
+    const int size = data.size();
+    int chunkStart = 0;
+    uint64_t rollingHash = 0;
+    for (int i = 0; i < size; ++i) {
+        rollingHash = (rollingHash << 1) + GEAR_TABLE[(uint8_t)bytes[i]];
+
+        int chunkSize = i + 1 - chunkStart;
+        bool isBoundary = (chunkSize >= MIN_CHUNK_SIZE && (rollingHash >> CHUNK_BOUNDARY_SHIFT) == 0) ||
+            chunkSize >= MAX_CHUNK_SIZE || i == size - 1;
+        if (!isBoundary) {
+            continue;
+        }
+
+        auto chunkHash = hashChunk(bytes + chunkStart, chunkSize);
+        if (!contains(chunkHash)) {
+            QSaveFile chunkFile { _chunksDirectory + chunkHash };
+            if (!chunkFile.open(QIODevice::WriteOnly)) {
+                qCritical() << "Could not open backup chunk for write:" << chunkFile.fileName();
+                return false;
+            }
+
+            auto compressed = qCompress(QByteArray::fromRawData(bytes + chunkStart, chunkSize));
+            if (chunkFile.write(compressed) != compressed.size() || !chunkFile.commit()) {
+                qCritical() << "Could not write backup chunk" << chunkFile.fileName();
+                return false;
+            }
+            _chunksOnDisk.insert(chunkHash);
+            throttle(compressed.size());
+        }
+
+        chunkHashes << chunkHash;
+        chunkStart = i + 1;
+        rollingHash = 0;
+    }
+
+    return true;
+}
+
+bool BackupChunkStore::load(const QStringList& chunkHashes, QByteArray& data) {
+    data.clear();
+
+    for (const auto& chunkHash : chunkHashes) {
+        QFile chunkFile { _chunksDirectory + chunkHash };
+        if (!chunkFile.open(QIODevice::ReadOnly)) {
+            qCritical() << "Missing backup chunk" << chunkHash;
+            return false;
+        }
+
+        auto compressed = chunkFile.readAll();
+        throttle(compressed.size());
+
+        auto chunk = qUncompress(compressed);
+        if (chunk.isEmpty() || hashChunk(chunk.constData(), chunk.size()) != chunkHash) {
+            qCritical() << "Corrupted backup chunk" << chunkHash;
+            return false;
+        }
+        data.append(chunk);
+    }
+
+    return true;
+}
+
+void BackupChunkStore::removeUnreferencedChunks(const std::set<QString>& referencedChunks) {
+    int removedChunks = 0;
+    auto it = _chunksOnDisk.begin();
+    while (it != _chunksOnDisk.end()) {
+        if (referencedChunks.find(*it) != referencedChunks.end()) {
+            ++it;
+        } else if (QFile::remove(_chunksDirectory + *it)) {
+            it = _chunksOnDisk.erase(it);
+            ++removedChunks;
+        } else {
+            qWarning() << "Could not delete backup chunk:" << *it;
+            ++it;
+        }
+    }
+
+    if (removedChunks > 0) {
+        qDebug() << "Removed" << removedChunks << "unreferenced backup chunks";
+    }
+}
+
+void BackupChunkStore::throttle(qint64 bytes) {
+    if (_maxBytesPerSecond <= 0) {
+        return;
+    }
+
+    static const qint64 MSECS_PER_WINDOW = 1000;
+    if (!_throttleTimer.isValid() || _throttleTimer.elapsed() >= MSECS_PER_WINDOW) {
+        _throttleTimer.start();
+        _bytesThisSecond = 0;
+    }
+
+    _bytesThisSecond += bytes;
+    if (_bytesThisSecond >= _maxBytesPerSecond) {
+        // this runs on the backup thread, so waiting out the rest of the second only delays the backup
+        auto remaining = MSECS_PER_WINDOW - _throttleTimer.elapsed();
+        if (remaining > 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(remaining));
+        }
+        _throttleTimer.start();
+        _bytesThisSecond = 0;
+    }
+}
@@ -0,0 +1,51 @@
+//
+//  BackupChunkStore.h
+//  domain-server/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_BackupChunkStore_h
+#define hifi_BackupChunkStore_h
+
+#include <set>
+
+#include <QElapsedTimer>
+#include <QString>
+#include <QStringList>
+
+// Content addressed storage shared by all backups.  Data is split into content defined chunks that are stored once,
+// named by their SHA-256 hash, so consecutive backups of mostly unchanged content only write the chunks that changed.
+// Disk access is throttled so that backing up large content does not saturate the disk.
+class BackupChunkStore {
+public:
+    static const qint64 DEFAULT_MAX_BYTES_PER_SECOND;
+
+    BackupChunkStore(const QString& directory, qint64 maxBytesPerSecond = DEFAULT_MAX_BYTES_PER_SECOND);
+
+    // Stores the chunks of data that are not stored yet, returns the hashes of all its chunks in order
+    bool store(const QByteArray& data, QStringList& chunkHashes);
+
+    // Reassembles data from its chunk hashes
+    bool load(const QStringList& chunkHashes, QByteArray& data);
+
+    bool contains(const QString& chunkHash) const { return _chunksOnDisk.find(chunkHash) != _chunksOnDisk.end(); }
+
+    // Deletes the stored chunks that are not part of any backup anymore
+    void removeUnreferencedChunks(const std::set<QString>& referencedChunks);
+
+private:
+    void throttle(qint64 bytes);
+
+    QString _chunksDirectory;
+    std::set<QString> _chunksOnDisk;
+
+    qint64 _maxBytesPerSecond;
+    qint64 _bytesThisSecond { 0 };
+    QElapsedTimer _throttleTimer;
+};
+
+#endif /* hifi_BackupChunkStore_h */
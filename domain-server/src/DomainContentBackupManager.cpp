@@ -481,6 +481,11 @@ void DomainContentBackupManager::removeOldBackupVersions(const BackupRule& rule)
                 QFile backupFile(fileInfo);
                 if (backupFile.remove()) {
                     qCDebug(domain_server) << "Removed old backup: " << backupFile.fileName();
+
+                    // let the handlers release the content only this backup referenced
+                    for (auto& handler : _backupHandlers) {
+                        handler->deleteBackup(matchingFiles[i].fileName());
+                    }
                 } else {
                     qCDebug(domain_server) << "Failed to remove old backup: " << backupFile.fileName();
                 }
@@ -310,7 +310,8 @@ DomainServer::DomainServer(int argc, char* argv[]) :
     _contentManager.reset(new DomainContentBackupManager(getContentBackupDir(), backupRulesVariant.toList()));
 
     connect(_contentManager.get(), &DomainContentBackupManager::started, _contentManager.get(), [this](){
-        _contentManager->addBackupHandler(BackupHandlerPointer(new EntitiesBackupHandler(getEntitiesFilePath(), getEntitiesReplacementFilePath())));
+        _contentManager->addBackupHandler(BackupHandlerPointer(new EntitiesBackupHandler(getEntitiesFilePath(),
+            getEntitiesReplacementFilePath(), getContentBackupDir())));
         _contentManager->addBackupHandler(BackupHandlerPointer(new AssetsBackupHandler(getContentBackupDir(), isAssetServerEnabled())));
         _contentManager->addBackupHandler(BackupHandlerPointer(new ContentSettingsBackupHandler(_settingsManager)));
     });
@@ -1045,6 +1046,7 @@ void DomainServer::processListRequestPacket(QSharedPointer<ReceivedMessage> mess
     // update this node's sockets in case they have changed
     sendingNode->setPublicSocket(nodeRequestData.publicSockAddr);
     sendingNode->setLocalSocket(nodeRequestData.localSockAddr);
+    updateDomainListEntry(sendingNode);
 
     DomainServerNodeData* nodeData = static_cast<DomainServerNodeData*>(sendingNode->getLinkedData());
 
@@ -1061,13 +1063,16 @@ void DomainServer::processListRequestPacket(QSharedPointer<ReceivedMessage> mess
         safeInterestSet.remove(NodeType::Agent);
     }
 
-    // update the NodeInterestSet in case there have been any changes
+    // update the NodeInterestSet in case there have been any changes, a delta would miss the newly interesting nodes
+    if (safeInterestSet != nodeData->getNodeInterestSet()) {
+        nodeData->requestFullDomainList();
+    }
     nodeData->setNodeInterestSet(safeInterestSet);
 
     // update the connecting hostname in case it has changed
     nodeData->setPlaceName(nodeRequestData.placeName);
 
-    sendDomainListToNode(sendingNode, message->getSenderSockAddr());
+    sendDomainListToNode(sendingNode, message->getSenderSockAddr(), nodeRequestData.acknowledgedListRevision);
 }
 
 bool DomainServer::isInInterestSet(const SharedNodePointer& nodeA, const SharedNodePointer& nodeB) {
@@ -1144,68 +1149,163 @@ void DomainServer::handleConnectedNode(SharedNodePointer newNode) {
         qDebug() << "Setting node to replicated: " << newNode->getUUID();
         newNode->setIsReplicated(true);
     }
+    updateDomainListEntry(newNode);
 
     // send out this node to our other connected nodes
     broadcastNewNode(newNode);
 }
 
-void DomainServer::sendDomainListToNode(const SharedNodePointer& node, const HifiSockAddr &senderSockAddr) {
+void DomainServer::sendDomainListToNode(const SharedNodePointer& node, const HifiSockAddr &senderSockAddr,
+                                        quint32 acknowledgedListRevision) {
     const int NUM_DOMAIN_LIST_EXTENDED_HEADER_BYTES = NUM_BYTES_RFC4122_UUID + NLPacket::NUM_BYTES_LOCALID +
-        NUM_BYTES_RFC4122_UUID + NLPacket::NUM_BYTES_LOCALID + 4;
+        NUM_BYTES_RFC4122_UUID + NLPacket::NUM_BYTES_LOCALID + sizeof(quint32) + sizeof(quint8) + 4 * sizeof(quint32);
+
+    // a node is told about at most this many removed nodes in a delta, beyond that it gets a full list
+    const int MAX_DELTA_LIST_REMOVED_NODES = 32;
+
+    auto limitedNodeList = DependencyManager::get<LimitedNodeList>();
+
+    DomainServerNodeData* nodeData = static_cast<DomainServerNodeData*>(node->getLinkedData());
+
+    // store the nodeInterestSet on this DomainServerNodeData, in case it has changed
+    auto& nodeInterestSet = nodeData->getNodeInterestSet();
+
+    // DTLSServerSession* dtlsSession = _isUsingDTLS ? _dtlsSessions[senderSockAddr] : NULL;
+    // if this authenticated node has any interest types, send back those nodes as well
+    bool hasInterestingNodes = nodeInterestSet.size() > 0 && nodeData->isAuthenticated();
+
+    // if the node has every list up to the revision it acknowledged, only send what changed since then
+    bool isDelta = nodeData->nextDomainListIsDelta(hasInterestingNodes && canSendDeltaDomainList(acknowledgedListRevision));
+
+    QList<QUuid> removedNodes;
+    if (isDelta) {
+        for (int i = _removedListNodes.size() - 1; i >= 0 && _removedListNodes[i].revision > acknowledgedListRevision; --i) {
+            if (nodeInterestSet.contains(_removedListNodes[i].type)) {
+                removedNodes << _removedListNodes[i].uuid;
+            }
+        }
+
+        if (removedNodes.size() > MAX_DELTA_LIST_REMOVED_NODES) {
+            isDelta = false;
+            removedNodes.clear();
+        }
+    }
+
+    int fullListSize = 0;
+    std::vector<SharedNodePointer> listedNodes;
+    if (hasInterestingNodes) {
+        limitedNodeList->eachNode([&](const SharedNodePointer& otherNode) {
+            if (otherNode->getUUID() != node->getUUID() && isInInterestSet(node, otherNode)) {
+                ++fullListSize;
+
+                auto otherNodeData = static_cast<DomainServerNodeData*>(otherNode->getLinkedData());
+                if (!isDelta || !otherNodeData || otherNodeData->getListEntryRevision() == 0 ||
+                    otherNodeData->getListEntryRevision() > acknowledgedListRevision) {
+                    listedNodes.push_back(otherNode);
+                }
+            }
+        });
+    }
 
     // setup the extended header for the domain list packets
     // this data is at the beginning of each of the domain list packets
     QByteArray extendedHeader(NUM_DOMAIN_LIST_EXTENDED_HEADER_BYTES, 0);
     QDataStream extendedHeaderStream(&extendedHeader, QIODevice::WriteOnly);
 
-    auto limitedNodeList = DependencyManager::get<LimitedNodeList>();
-
     extendedHeaderStream << limitedNodeList->getSessionUUID();
     extendedHeaderStream << limitedNodeList->getSessionLocalID();
     extendedHeaderStream << node->getUUID();
     extendedHeaderStream << node->getLocalID();
     extendedHeaderStream << node->getPermissions();
     extendedHeaderStream << limitedNodeList->getAuthenticatePackets();
+
+    // the revision of this list, the revision a delta is based on (zero for a full list) and the number of nodes and of
+    // removed nodes in the whole list, so the node can tell when every packet of it has arrived
+    extendedHeaderStream << _domainListRevision;
+    extendedHeaderStream << (isDelta ? acknowledgedListRevision : (quint32)0);
+    extendedHeaderStream << (quint32)listedNodes.size();
+    extendedHeaderStream << (quint32)removedNodes.size();
     auto domainListPackets = NLPacketList::create(PacketType::DomainList, extendedHeader);
 
     // always send the node their own UUID back
     QDataStream domainListStream(domainListPackets.get());
 
-    DomainServerNodeData* nodeData = static_cast<DomainServerNodeData*>(node->getLinkedData());
-
-    // store the nodeInterestSet on this DomainServerNodeData, in case it has changed
-    auto& nodeInterestSet = nodeData->getNodeInterestSet();
-
-    if (nodeInterestSet.size() > 0) {
+    // the removed nodes are only needed once, so they go in the first packet rather than the extended header
+    if (!removedNodes.empty()) {
+        domainListPackets->startSegment();
+        domainListStream << DOMAIN_LIST_REMOVED_NODES_SEGMENT << removedNodes;
+        domainListPackets->endSegment();
+    }
 
-        // DTLSServerSession* dtlsSession = _isUsingDTLS ? _dtlsSessions[senderSockAddr] : NULL;
-        if (nodeData->isAuthenticated()) {
-            // if this authenticated node has any interest types, send back those nodes as well
-            limitedNodeList->eachNode([this, node, &domainListPackets, &domainListStream](const SharedNodePointer& otherNode) {
-                if (otherNode->getUUID() != node->getUUID() && isInInterestSet(node, otherNode)) {
-                    // since we're about to add a node to the packet we start a segment
-                    domainListPackets->startSegment();
+    for (const auto& otherNode : listedNodes) {
+        // since we're about to add a node to the packet we start a segment
+        domainListPackets->startSegment();
 
-                    // don't send avatar nodes to other avatars, that will come from avatar mixer
-                    domainListStream << *otherNode.data();
+        // don't send avatar nodes to other avatars, that will come from avatar mixer
+        domainListStream << *otherNode.data();
 
-                    // pack the secret that these two nodes will use to communicate with each other
-                    domainListStream << connectionSecretForNodes(node, otherNode);
+        // pack the secret that these two nodes will use to communicate with each other
+        domainListStream << connectionSecretForNodes(node, otherNode);
 
-                    // we've added the node we wanted so end the segment now
-                    domainListPackets->endSegment();
-                }
-            });
-        }
+        // we've added the node we wanted so end the segment now
+        domainListPackets->endSegment();
     }
 
     // send an empty list to the node, in case there were no other nodes
     domainListPackets->closeCurrentPacket(true);
 
+    _domainListBytesSent += domainListPackets->getDataSize();
+    if (isDelta) {
+        ++_deltaDomainListsSent;
+
+        // estimate what the entries left out would have cost from the size of the entries in the last full list
+        _domainListBytesSaved += (quint64)((fullListSize - (int)listedNodes.size()) * _domainListEntryBytes);
+    } else {
+        ++_fullDomainListsSent;
+
+        if (!listedNodes.empty()) {
+            size_t headerBytes = domainListPackets->getNumPackets() * extendedHeader.size();
+            size_t entryBytes = domainListPackets->getMessageSize() - std::min(headerBytes, domainListPackets->getMessageSize());
+            _domainListEntryBytes = (float)entryBytes / listedNodes.size();
+        }
+    }
+
     // write the PacketList to this node
     limitedNodeList->sendPacketList(std::move(domainListPackets), *node);
 }
 
+void DomainServer::updateDomainListEntry(const SharedNodePointer& node) {
+    auto nodeData = static_cast<DomainServerNodeData*>(node->getLinkedData());
+    if (!nodeData) {
+        return;
+    }
+
+    // compare the entry other nodes would receive, so a delta includes this node only when it actually changed
+    QByteArray entry;
+    QDataStream entryStream(&entry, QIODevice::WriteOnly);
+    entryStream << *node.data();
+
+    uint entryHash = qHash(entry);
+    if (nodeData->getListEntryRevision() == 0 || entryHash != nodeData->getListEntryHash()) {
+        nodeData->setListEntry(entryHash, ++_domainListRevision);
+    }
+}
+
+bool DomainServer::canSendDeltaDomainList(quint32 acknowledgedListRevision) const {
+    return acknowledgedListRevision != 0 && acknowledgedListRevision >= _oldestDeltaListRevision &&
+        acknowledgedListRevision <= _domainListRevision;
+}
+
+QJsonObject DomainServer::domainListStatsJSON() const {
+    QJsonObject statsJSON;
+    statsJSON["revision"] = (double)_domainListRevision;
+    statsJSON["full_lists_sent"] = (double)_fullDomainListsSent;
+    statsJSON["delta_lists_sent"] = (double)_deltaDomainListsSent;
+    statsJSON["bytes_sent"] = (double)_domainListBytesSent;
+    statsJSON["bytes_saved"] = (double)_domainListBytesSaved;
+    return statsJSON;
+}
+
 QUuid DomainServer::connectionSecretForNodes(const SharedNodePointer& nodeA, const SharedNodePointer& nodeB) {
     DomainServerNodeData* nodeAData = static_cast<DomainServerNodeData*>(nodeA->getLinkedData());
     DomainServerNodeData* nodeBData = static_cast<DomainServerNodeData*>(nodeB->getLinkedData());
@@ -2105,6 +2205,7 @@ bool DomainServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
             });
 
             rootJSON["nodes"] = nodesJSONArray;
+            rootJSON["domain_lists"] = domainListStatsJSON();
 
             // print out the created JSON
             QJsonDocument nodesDocument(rootJSON);
@@ -3001,6 +3102,7 @@ void DomainServer::updateReplicatedNodes() {
                     << otherNode->getPermissions().getVerifiedUserName() << otherNode->getUUID();
             }
             otherNode->setIsReplicated(shouldReplicate);
+            updateDomainListEntry(otherNode);
         }
     );
 }
@@ -3065,6 +3167,13 @@ void DomainServer::nodeKilled(SharedNodePointer node) {
         }
     }
 
+    // remember the removal so that delta domain lists can report it
+    const int MAX_REMOVED_LIST_NODES = 1024;
+    _removedListNodes.enqueue({ ++_domainListRevision, node->getUUID(), node->getType() });
+    while (_removedListNodes.size() > MAX_REMOVED_LIST_NODES) {
+        _oldestDeltaListRevision = _removedListNodes.dequeue().revision;
+    }
+
     broadcastNodeDisconnect(node);
 }
 
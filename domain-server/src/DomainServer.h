@@ -171,7 +171,11 @@ private:
     void handleKillNode(SharedNodePointer nodeToKill);
     void broadcastNodeDisconnect(const SharedNodePointer& disconnnectedNode);
 
-    void sendDomainListToNode(const SharedNodePointer& node, const HifiSockAddr& senderSockAddr);
+    void sendDomainListToNode(const SharedNodePointer& node, const HifiSockAddr& senderSockAddr,
+                              quint32 acknowledgedListRevision = 0);
+    void updateDomainListEntry(const SharedNodePointer& node);
+    bool canSendDeltaDomainList(quint32 acknowledgedListRevision) const;
+    QJsonObject domainListStatsJSON() const;
 
     bool isInInterestSet(const SharedNodePointer& nodeA, const SharedNodePointer& nodeB);
 
@@ -266,6 +270,24 @@ private:
 
     DomainType _type { DomainType::NonMetaverse };
 
+    struct RemovedListNode {
+        quint32 revision;
+        QUuid uuid;
+        NodeType_t type;
+    };
+
+    // bumped whenever a node is added to, changed in or removed from the domain lists
+    quint32 _domainListRevision { 0 };
+    // deltas can't be built from revisions older than the oldest removal we still remember
+    quint32 _oldestDeltaListRevision { 0 };
+    QQueue<RemovedListNode> _removedListNodes;
+
+    quint64 _fullDomainListsSent { 0 };
+    quint64 _deltaDomainListsSent { 0 };
+    quint64 _domainListBytesSent { 0 };
+    quint64 _domainListBytesSaved { 0 };
+    float _domainListEntryBytes { 0.0f };
+
     friend class DomainGatekeeper;
     friend class DomainMetadata;
 
@@ -21,10 +21,23 @@
 
 DomainServerNodeData::StringPairHash DomainServerNodeData::_overrideHash;
 
+// nodes check in about once a second, so this resends the full list roughly every half minute
+const int DELTA_DOMAIN_LISTS_PER_FULL_LIST = 30;
+
 DomainServerNodeData::DomainServerNodeData() {
     _paymentIntervalTimer.start();
 }
 
+bool DomainServerNodeData::nextDomainListIsDelta(bool canSendDelta) {
+    if (!canSendDelta || _deltaDomainListsUntilFull <= 0) {
+        _deltaDomainListsUntilFull = DELTA_DOMAIN_LISTS_PER_FULL_LIST;
+        return false;
+    }
+
+    --_deltaDomainListsUntilFull;
+    return true;
+}
+
 void DomainServerNodeData::updateJSONStats(QByteArray statsByteArray) {
     auto document = QJsonDocument::fromBinaryData(statsByteArray);
     Q_ASSERT(document.isObject());
@@ -72,6 +72,15 @@ public:
 
     bool hasCheckedIn() const { return _hasCheckedIn; }
     void setHasCheckedIn(bool hasCheckedIn) { _hasCheckedIn = hasCheckedIn; }
+
+    // domain list revision at which this node's own entry in other nodes' lists last changed
+    quint32 getListEntryRevision() const { return _listEntryRevision; }
+    uint getListEntryHash() const { return _listEntryHash; }
+    void setListEntry(uint entryHash, quint32 revision) { _listEntryHash = entryHash; _listEntryRevision = revision; }
+
+    // counts down to the next periodic full domain list, returns true if the next list sent to this node can be a delta
+    bool nextDomainListIsDelta(bool canSendDelta);
+    void requestFullDomainList() { _deltaDomainListsUntilFull = 0; }
     
 private:
     QJsonObject overrideValuesIfNeeded(const QJsonObject& newStats);
@@ -99,6 +108,10 @@ private:
     bool _wasAssigned { false };
 
     bool _hasCheckedIn { false };
+
+    quint32 _listEntryRevision { 0 };
+    uint _listEntryHash { 0 };
+    int _deltaDomainListsUntilFull { 0 };
 };
 
 #endif // hifi_DomainServerNodeData_h
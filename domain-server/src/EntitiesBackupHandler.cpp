@@ -12,6 +12,9 @@
 #include "EntitiesBackupHandler.h"
 
 #include <QDebug>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
 
 #if !defined(__clang__) && defined(__GNUC__)
 #pragma GCC diagnostic push
@@ -25,51 +28,137 @@
 #pragma GCC diagnostic pop
 #endif
 
+#include <Gzip.h>
 #include <OctreeDataUtils.h>
 
-EntitiesBackupHandler::EntitiesBackupHandler(QString entitiesFilePath, QString entitiesReplacementFilePath) :
+EntitiesBackupHandler::EntitiesBackupHandler(QString entitiesFilePath, QString entitiesReplacementFilePath,
+                                             QString backupDirectory) :
     _entitiesFilePath(entitiesFilePath),
-    _entitiesReplacementFilePath(entitiesReplacementFilePath)
+    _entitiesReplacementFilePath(entitiesReplacementFilePath),
+    _chunkStore(backupDirectory)
 {
 }
 
 static const QString ENTITIES_BACKUP_FILENAME = "models.json.gz";
+static const QString ENTITIES_MANIFEST_FILENAME = "models.chunks.json";
+static const QString MANIFEST_SIZE_KEY = "size";
+static const QString MANIFEST_CHUNKS_KEY = "chunks";
+
+bool EntitiesBackupHandler::readManifest(QuaZip& zip, QStringList& chunkHashes) {
+    QuaZipFile zipFile { &zip };
+    if (!zip.setCurrentFile(ENTITIES_MANIFEST_FILENAME) || !zipFile.open(QIODevice::ReadOnly)) {
+        qCritical() << "Failed to open" << ENTITIES_MANIFEST_FILENAME << "in backup";
+        return false;
+    }
+
+    auto document = QJsonDocument::fromJson(zipFile.readAll());
+    zipFile.close();
+    if (!document.isObject() || !document.object()[MANIFEST_CHUNKS_KEY].isArray()) {
+        qCritical() << "Could not parse" << ENTITIES_MANIFEST_FILENAME << "in backup";
+        return false;
+    }
+
+    chunkHashes.clear();
+    for (const auto& chunkHash : document.object()[MANIFEST_CHUNKS_KEY].toArray()) {
+        chunkHashes << chunkHash.toString();
+    }
+    return true;
+}
+
+void EntitiesBackupHandler::loadBackup(const QString& backupName, QuaZip& zip) {
+    // backups that carry the whole entities file don't use the chunk store
+    if (!zip.getFileNameList().contains(ENTITIES_MANIFEST_FILENAME)) {
+        return;
+    }
+
+    auto& backup = _backups[backupName];
+    backup.corruptedBackup = !readManifest(zip, backup.chunkHashes);
+    for (const auto& chunkHash : backup.chunkHashes) {
+        if (!_chunkStore.contains(chunkHash)) {
+            qCritical() << "Backup" << backupName << "is missing entity chunk" << chunkHash;
+            backup.corruptedBackup = true;
+        }
+    }
+}
+
+void EntitiesBackupHandler::loadingComplete() {
+    removeUnreferencedChunks();
+}
+
+bool EntitiesBackupHandler::isCorruptedBackup(const QString& backupName) {
+    auto it = _backups.find(backupName);
+    return it != _backups.end() && it->second.corruptedBackup;
+}
 
 void EntitiesBackupHandler::createBackup(const QString& backupName, QuaZip& zip) {
     QFile entitiesFile { _entitiesFilePath };
 
     if (entitiesFile.open(QIODevice::ReadOnly)) {
+        // chunk the uncompressed entities, gzip would spread any change across the rest of the file
+        auto entityData = entitiesFile.readAll();
+        QByteArray jsonData;
+        if (gunzip(entityData, jsonData)) {
+            entityData = jsonData;
+        }
+
+        QStringList chunkHashes;
+        if (!_chunkStore.store(entityData, chunkHashes)) {
+            qCritical() << "Failed to write entities to the backup chunk store";
+            return;
+        }
+
+        QJsonObject manifest;
+        manifest[MANIFEST_SIZE_KEY] = entityData.size();
+        manifest[MANIFEST_CHUNKS_KEY] = QJsonArray::fromStringList(chunkHashes);
+
         QuaZipFile zipFile { &zip };
-        if (!zipFile.open(QIODevice::WriteOnly, QuaZipNewInfo(ENTITIES_BACKUP_FILENAME, _entitiesFilePath))) {
-            qCritical().nospace() << "Failed to open " << ENTITIES_BACKUP_FILENAME << " for writing in zip";
+        if (!zipFile.open(QIODevice::WriteOnly, QuaZipNewInfo(ENTITIES_MANIFEST_FILENAME, _entitiesFilePath))) {
+            qCritical().nospace() << "Failed to open " << ENTITIES_MANIFEST_FILENAME << " for writing in zip";
             return;
         }
-        auto entityData = entitiesFile.readAll();
-        if (zipFile.write(entityData) != entityData.size()) {
-            qCritical() << "Failed to write entities file to backup";
+        auto manifestData = QJsonDocument(manifest).toJson(QJsonDocument::Compact);
+        if (zipFile.write(manifestData) != manifestData.size()) {
+            qCritical() << "Failed to write entities manifest to backup";
             zipFile.close();
             return;
         }
         zipFile.close();
         if (zipFile.getZipError() != UNZ_OK) {
-            qCritical().nospace() << "Failed to zip " << ENTITIES_BACKUP_FILENAME << ": " << zipFile.getZipError();
+            qCritical().nospace() << "Failed to zip " << ENTITIES_MANIFEST_FILENAME << ": " << zipFile.getZipError();
+            return;
         }
+
+        _backups[backupName] = { chunkHashes, false };
     }
 }
 
 void EntitiesBackupHandler::recoverBackup(const QString& backupName, QuaZip& zip) {
-    if (!zip.setCurrentFile(ENTITIES_BACKUP_FILENAME)) {
+    QByteArray rawData;
+
+    if (zip.setCurrentFile(ENTITIES_BACKUP_FILENAME)) {
+        QuaZipFile zipFile { &zip };
+        if (!zipFile.open(QIODevice::ReadOnly)) {
+            qCritical() << "Failed to open" << ENTITIES_BACKUP_FILENAME << "in backup";
+            return;
+        }
+        rawData = zipFile.readAll();
+
+        zipFile.close();
+
+        if (zipFile.getZipError() != UNZ_OK) {
+            qCritical().nospace() << "Failed to unzip " << ENTITIES_BACKUP_FILENAME << ": " << zipFile.getZipError();
+            return;
+        }
+    } else if (zip.getFileNameList().contains(ENTITIES_MANIFEST_FILENAME)) {
+        QStringList chunkHashes;
+        if (!readManifest(zip, chunkHashes) || !_chunkStore.load(chunkHashes, rawData)) {
+            qCritical() << "Failed to read entities from the backup chunk store while recovering" << backupName;
+            return;
+        }
+    } else {
         qWarning() << "Failed to find" << ENTITIES_BACKUP_FILENAME << "while recovering backup";
         return;
     }
-    QuaZipFile zipFile { &zip };
-    if (!zipFile.open(QIODevice::ReadOnly)) {
-        qCritical() << "Failed to open" << ENTITIES_BACKUP_FILENAME << "in backup";
-        return;
-    }
-    auto rawData = zipFile.readAll();
-
-    zipFile.close();
 
     OctreeUtils::RawEntityData data;
     if (!data.readOctreeDataInfoFromData(rawData)) {
@@ -79,14 +168,56 @@ void EntitiesBackupHandler::recoverBackup(const QString& backupName, QuaZip& zip
 
     data.resetIdAndVersion();
 
-    if (zipFile.getZipError() != UNZ_OK) {
-        qCritical().nospace() << "Failed to unzip " << ENTITIES_BACKUP_FILENAME << ": " << zipFile.getZipError();
-        return;
-    }
-
     QFile entitiesFile { _entitiesReplacementFilePath };
 
     if (entitiesFile.open(QIODevice::WriteOnly)) {
         entitiesFile.write(data.toGzippedByteArray());
     }
 }
+
+void EntitiesBackupHandler::deleteBackup(const QString& backupName) {
+    if (_backups.erase(backupName) > 0) {
+        removeUnreferencedChunks();
+    }
+}
+
+void EntitiesBackupHandler::consolidateBackup(const QString& backupName, QuaZip& zip) {
+    auto it = _backups.find(backupName);
+    if (it == _backups.end()) {
+        // this backup already carries the whole entities file
+        return;
+    }
+
+    QByteArray entityData;
+    QByteArray gzippedData;
+    if (!_chunkStore.load(it->second.chunkHashes, entityData) || !gzip(entityData, gzippedData)) {
+        qCritical() << "Failed to read entities from the backup chunk store while consolidating" << backupName;
+        return;
+    }
+
+    QuaZipFile zipFile { &zip };
+    if (!zipFile.open(QIODevice::WriteOnly, QuaZipNewInfo(ENTITIES_BACKUP_FILENAME))) {
+        qCritical().nospace() << "Failed to open " << ENTITIES_BACKUP_FILENAME << " for writing in zip";
+        return;
+    }
+    if (zipFile.write(gzippedData) != gzippedData.size()) {
+        qCritical() << "Failed to write entities file to consolidated backup";
+    }
+    zipFile.close();
+    if (zipFile.getZipError() != UNZ_OK) {
+        qCritical().nospace() << "Failed to zip " << ENTITIES_BACKUP_FILENAME << ": " << zipFile.getZipError();
+    }
+}
+
+void EntitiesBackupHandler::removeUnreferencedChunks() {
+    std::set<QString> referencedChunks;
+    for (const auto& backup : _backups) {
+        if (backup.second.corruptedBackup) {
+            qWarning() << "Some entity backups did not load properly, not deleting backup chunks for safety.";
+            return;
+        }
+        referencedChunks.insert(backup.second.chunkHashes.begin(), backup.second.chunkHashes.end());
+    }
+
+    _chunkStore.removeUnreferencedChunks(referencedChunks);
+}
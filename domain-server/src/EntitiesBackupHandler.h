@@ -12,36 +12,54 @@
 #ifndef hifi_EntitiesBackupHandler_h
 #define hifi_EntitiesBackupHandler_h
 
+#include <map>
+
+#include <QStringList>
+
+#include "BackupChunkStore.h"
 #include "BackupHandler.h"
 
 class EntitiesBackupHandler : public BackupHandlerInterface {
 public:
-    EntitiesBackupHandler(QString entitiesFilePath, QString entitiesReplacementFilePath);
+    EntitiesBackupHandler(QString entitiesFilePath, QString entitiesReplacementFilePath, QString backupDirectory);
 
     std::pair<bool, float> isAvailable(const QString& backupName) override { return { true, 1.0f }; }
     std::pair<bool, float> getRecoveryStatus() override { return { false, 1.0f }; }
 
-    void loadBackup(const QString& backupName, QuaZip& zip) override {}
+    // Read the chunk manifest of a backup
+    void loadBackup(const QString& backupName, QuaZip& zip) override;
 
-    void loadingComplete() override {}
+    // Drop the chunks that no backup references anymore
+    void loadingComplete() override;
 
-    // Create a skeleton backup
+    // Create a skeleton backup, only the chunks of the entities that changed since the last backup are written
     void createBackup(const QString& backupName, QuaZip& zip) override;
 
-    // Recover from a full backup
+    // Recover from a full or a skeleton backup
     void recoverBackup(const QString& backupName, QuaZip& zip) override;
 
     // Delete a skeleton backup
-    void deleteBackup(const QString& backupName) override {}
+    void deleteBackup(const QString& backupName) override;
 
     // Create a full backup
-    void consolidateBackup(const QString& backupName, QuaZip& zip) override {}
+    void consolidateBackup(const QString& backupName, QuaZip& zip) override;
 
-    bool isCorruptedBackup(const QString& backupName) override { return false; }
+    bool isCorruptedBackup(const QString& backupName) override;
 
 private:
+    bool readManifest(QuaZip& zip, QStringList& chunkHashes);
+    void removeUnreferencedChunks();
+
     QString _entitiesFilePath;
     QString _entitiesReplacementFilePath;
+
+    BackupChunkStore _chunkStore;
+
+    struct EntitiesBackup {
+        QStringList chunkHashes;
+        bool corruptedBackup { false };
+    };
+    std::map<QString, EntitiesBackup> _backups;
 };
 
 #endif /* hifi_EntitiesBackupHandler_h */
@@ -31,6 +31,9 @@ public:
     QString hardwareAddress;
     QUuid machineFingerprint;
 
+    // the last domain list revision the node received in full, only sent with list requests
+    quint32 acknowledgedListRevision { 0 };
+
     QByteArray protocolVersion;
 };
 
@@ -2077,6 +2077,7 @@ Application::Application(int& argc, char** argv, QElapsedTimer& startupTimer, bo
         properties["active_downloads"] = loadingRequests.size();
         properties["pending_downloads"] = (int)ResourceCache::getPendingRequestCount();
         properties["active_downloads_details"] = loadingRequestsStats;
+        properties["download_queues"] = QJsonObject::fromVariantMap(ResourceCache::getRequestStats());
 
         auto statTracker = DependencyManager::get<StatTracker>();
 
@@ -2557,6 +2558,8 @@ void Application::cleanupBeforeQuit() {
     // Must be done after shutdownScripting in case any scripts try to access these things
     {
         DependencyManager::destroy<StandAloneJSConsole>();
+        // batched picks may still be intersecting the entities on worker threads
+        DependencyManager::get<PickManager>()->waitForPickJobs();
         EntityTreePointer tree = getEntities()->getTree();
         tree->setSimulation(nullptr);
         DependencyManager::destroy<EntityTreeRenderer>();
@@ -55,6 +55,7 @@ static const quint64 MIN_TIME_BETWEEN_MY_AVATAR_DATA_SENDS = USECS_PER_SECOND /
 const QUuid MY_AVATAR_KEY;  // NULL key
 
 AvatarManager::AvatarManager(QObject* parent) :
+    AvatarHashMap(true),
     _myAvatar(new MyAvatar(qApp->thread()), [](MyAvatar* ptr) { ptr->deleteLater(); })
 {
     // register a meta type for the weak pointer we'll use for the owning avatar mixer for each avatar
@@ -203,6 +204,9 @@ float AvatarManager::getAvatarSimulationRate(const QUuid& sessionID, const QStri
 }
 
 void AvatarManager::updateOtherAvatars(float deltaTime) {
+    // bring in the avatar data decoded since the last frame, this is the only place the interface applies it
+    applyDecodedAvatarData();
+
     {
         // lock the hash for read to check the size
         QReadLocker lock(&_hashLock);
@@ -483,6 +487,7 @@ void AvatarManager::handleRemovedAvatar(const AvatarSharedPointer& removedAvatar
 
 void AvatarManager::clearOtherAvatars() {
     _myAvatar->clearLookAtTargetAvatar();
+    discardDecodedAvatarData();
 
     // setup a vector of removed avatars outside the scope of the hash lock
     std::vector<AvatarSharedPointer> removedAvatars;
@@ -225,12 +225,14 @@ MyAvatar::MyAvatar(QThread* thread) :
         if (recorder->isRecording()) {
             createRecordingIDs();
             setRecordingBasis();
+            _recordingFrameEncoder.reset();
         } else {
             clearRecordingBasis();
         }
     });
 
     static const recording::FrameType AVATAR_FRAME_TYPE = recording::Frame::registerFrameType(AvatarData::FRAME_NAME);
+    Frame::registerKeyframeTest(AVATAR_FRAME_TYPE, AvatarFrameCodec::isKeyframe);
     Frame::registerFrameHandler(AVATAR_FRAME_TYPE, [=](Frame::ConstPointer frame) {
         static AvatarData dummyAvatar;
         AvatarData::fromFrame(frame->data, dummyAvatar);
@@ -862,7 +864,7 @@ void MyAvatar::simulate(float deltaTime, bool inView) {
     auto recorder = DependencyManager::get<recording::Recorder>();
     if (recorder->isRecording()) {
         static const recording::FrameType FRAME_TYPE = recording::Frame::registerFrameType(AvatarData::FRAME_NAME);
-        recorder->recordFrame(FRAME_TYPE, toFrame(*this));
+        recorder->recordFrame(FRAME_TYPE, toFrame(*this, _recordingFrameEncoder));
     }
 
     locationChanged();
@@ -1846,6 +1848,24 @@ void MyAvatar::avatarEntityDataToJson(QJsonObject& root) const {
     });
 }
 
+uint MyAvatar::avatarEntityDataHash(uint seed) const {
+    updateStaleAvatarEntityBlobs();
+    uint hash = seed;
+    _avatarEntitiesLock.withReadLock([&] {
+        for (auto itr = _cachedAvatarEntityBlobs.begin(); itr != _cachedAvatarEntityBlobs.end(); ++itr) {
+            hash = qHash(itr.key(), hash);
+            hash = qHash(itr.value(), hash);
+        }
+        // a set, so combine the ids independently of their order
+        uint recordingIDsHash = 0;
+        for (const auto& id : _avatarEntityForRecording) {
+            recordingIDsHash ^= qHash(id);
+        }
+        hash = qHash(recordingIDsHash, hash);
+    });
+    return hash;
+}
+
 void MyAvatar::loadData() {
     if (!_myScriptEngine) {
         _myScriptEngine = new QScriptEngine();
@@ -1975,11 +1995,10 @@ AttachmentData MyAvatar::loadAttachmentData(const QUrl& modelURL, const QString&
 }
 
 
-int MyAvatar::parseDataFromBuffer(const QByteArray& buffer) {
+void MyAvatar::applyDecodedData(const DecodedAvatarData& decoded) {
+    // this packet is just bad, so we ignore it
     qCDebug(interfaceapp) << "Error: ignoring update packet for MyAvatar"
-        << " packetLength = " << buffer.size();
-    // this packet is just bad, so we pretend that we unpacked it ALL
-    return buffer.size();
+        << " packetLength = " << decoded.numBytes;
 }
 
 ScriptAvatarData* MyAvatar::getTargetAvatar() const {
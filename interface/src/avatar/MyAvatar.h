@@ -1211,6 +1211,7 @@ public:
     void setAvatarEntityData(const AvatarEntityMap& avatarEntityData) override;
     void updateAvatarEntity(const QUuid& entityID, const QByteArray& entityData) override;
     void avatarEntityDataToJson(QJsonObject& root) const override;
+    uint avatarEntityDataHash(uint seed) const override;
 
 public slots:
 
@@ -1654,7 +1655,7 @@ private:
     void setEnableDrawAverageFacing(bool drawAverage) { _drawAverageFacingEnabled = drawAverage; }
     bool getEnableDrawAverageFacing() const { return _drawAverageFacingEnabled; }
     bool isMyAvatar() const override { return true; }
-    virtual int parseDataFromBuffer(const QByteArray& buffer) override;
+    virtual void applyDecodedData(const DecodedAvatarData& decoded) override;
     virtual glm::vec3 getSkeletonPosition() const override;
     int _skeletonModelChangeCount { 0 };
 
@@ -1700,6 +1701,8 @@ private:
     std::array<float, MAX_DRIVE_KEYS> _driveKeys;
     std::bitset<MAX_DRIVE_KEYS> _disabledDriveKeys;
 
+    AvatarFrameCodec::EncoderState _recordingFrameEncoder;
+
     bool _enableFlying { false };
     bool _flyingPrefDesktop { true };
     bool _flyingPrefHMD { false };
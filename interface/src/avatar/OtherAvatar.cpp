@@ -111,12 +111,11 @@ void OtherAvatar::updateSpaceProxy(workload::Transaction& transaction) const {
     }
 }
 
-int OtherAvatar::parseDataFromBuffer(const QByteArray& buffer) {
-    int32_t bytesRead = Avatar::parseDataFromBuffer(buffer);
+void OtherAvatar::applyDecodedData(const DecodedAvatarData& decoded) {
+    Avatar::applyDecodedData(decoded);
     if (_moving && _motionState) {
         _motionState->addDirtyFlags(Simulation::DIRTY_POSITION);
     }
-    return bytesRead;
 }
 
 void OtherAvatar::setWorkloadRegion(uint8_t region) {
@@ -37,7 +37,7 @@ public:
     int32_t getSpaceIndex() const { return _spaceIndex; }
     void updateSpaceProxy(workload::Transaction& transaction) const;
 
-    int parseDataFromBuffer(const QByteArray& buffer) override;
+    void applyDecodedData(const DecodedAvatarData& decoded) override;
 
     bool isInPhysicsSimulation() const { return _motionState != nullptr; }
     void rebuildCollisionShape() override;
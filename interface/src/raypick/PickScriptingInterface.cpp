@@ -371,6 +371,14 @@ void PickScriptingInterface::setPerFrameTimeBudget(unsigned int numUsecs) {
     DependencyManager::get<PickManager>()->setPerFrameTimeBudget(numUsecs);
 }
 
+bool PickScriptingInterface::getBatchedPicking() const {
+    return DependencyManager::get<PickManager>()->getBatchedPicking();
+}
+
+void PickScriptingInterface::setBatchedPicking(bool batchedPicking) {
+    DependencyManager::get<PickManager>()->setBatchedPicking(batchedPicking);
+}
+
 void PickScriptingInterface::setParentTransform(std::shared_ptr<PickQuery> pick, const QVariantMap& propMap) {
     QUuid parentUuid;
     int parentJointIndex = 0;
@@ -50,6 +50,9 @@
  * @property {number} INTERSECTED_AVATAR An intersection type. Intersected an avatar. <em>Read-only.</em>
  * @property {number} INTERSECTED_HUD An intersection type. Intersected the HUD sphere. <em>Read-only.</em>
  * @property {number} perFrameTimeBudget - The max number of usec to spend per frame updating Pick results.
+ * @property {boolean} batchedPicking - If <code>true</code>, every Pick is updated each frame and entity intersections are
+ *     computed on worker threads, their results are available the next frame; <code>perFrameTimeBudget</code> only
+ *     applies when this is <code>false</code>. Defaults to <code>true</code>.
  */
 
 class PickScriptingInterface : public QObject, public Dependency {
@@ -80,6 +83,7 @@ class PickScriptingInterface : public QObject, public Dependency {
     Q_PROPERTY(unsigned int INTERSECTED_AVATAR READ INTERSECTED_AVATAR CONSTANT)
     Q_PROPERTY(unsigned int INTERSECTED_HUD READ INTERSECTED_HUD CONSTANT)
     Q_PROPERTY(unsigned int perFrameTimeBudget READ getPerFrameTimeBudget WRITE setPerFrameTimeBudget)
+    Q_PROPERTY(bool batchedPicking READ getBatchedPicking WRITE setBatchedPicking)
     SINGLETON_DEPENDENCY
 
 public:
@@ -254,6 +258,9 @@ public:
     unsigned int getPerFrameTimeBudget() const;
     void setPerFrameTimeBudget(unsigned int numUsecs);
 
+    bool getBatchedPicking() const;
+    void setBatchedPicking(bool batchedPicking);
+
 public slots:
 
     /**jsdoc
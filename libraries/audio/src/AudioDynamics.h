@@ -356,6 +356,15 @@ FORCEINLINE static int32_t fixexp2(int32_t x) {
     return c2 >> e;
 }
 
+// convert Q30 to Q15 with saturation
+FORCEINLINE static int32_t saturateQ30(int32_t x) {
+
+    x = (x + (1 << 14)) >> 15;
+    x = MIN(MAX(x, -32768), 32767);
+
+    return x;
+}
+
 // fast TPDF dither in [-1.0f, 1.0f]
 FORCEINLINE static float dither() {
     static uint32_t rz = 0;
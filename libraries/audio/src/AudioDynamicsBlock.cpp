@@ -0,0 +1,133 @@
+//
+//  AudioDynamicsBlock.cpp
+//  libraries/audio/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioDynamicsBlock.h"
+
+#include <assert.h>
+
+#include "AudioDynamics.h"
+
+void peaklog2Block_ref(const float* input, int32_t* output, int numFrames, int numChannels) {
+
+    float* in = const_cast<float*>(input);
+
+    switch (numChannels) {
+    case 1:
+        for (int n = 0; n < numFrames; n++) {
+            output[n] = peaklog2(&in[n]);
+        }
+        break;
+    case 2:
+        for (int n = 0; n < numFrames; n++) {
+            output[n] = peaklog2(&in[2*n+0], &in[2*n+1]);
+        }
+        break;
+    case 4:
+        for (int n = 0; n < numFrames; n++) {
+            output[n] = peaklog2(&in[4*n+0], &in[4*n+1], &in[4*n+2], &in[4*n+3]);
+        }
+        break;
+    default:
+        assert(0); // unsupported
+    }
+}
+
+void fixlog2Block_ref(const int32_t* input, int32_t* output, int numFrames) {
+    for (int n = 0; n < numFrames; n++) {
+        output[n] = fixlog2(input[n]);
+    }
+}
+
+void fixexp2Block_ref(const int32_t* input, int32_t* output, int numFrames) {
+    for (int n = 0; n < numFrames; n++) {
+        output[n] = fixexp2(input[n]);
+    }
+}
+
+void applyGainBlock_ref(const float* input, const float* gain, const float* dither, int16_t* output, int numFrames, int numChannels) {
+    for (int n = 0; n < numFrames; n++) {
+        for (int c = 0; c < numChannels; c++) {
+            float x = input[numChannels*n+c] * gain[n];
+            x += dither[n];
+            output[numChannels*n+c] = (int16_t)floatToInt(x);
+        }
+    }
+}
+
+void applyGainQ31Block_ref(const int32_t* input, const int32_t* gain, int16_t* output, int numFrames, int numChannels) {
+    for (int n = 0; n < numFrames; n++) {
+        for (int c = 0; c < numChannels; c++) {
+            int32_t x = MULQ31(input[numChannels*n+c], gain[n]);
+            output[numChannels*n+c] = (int16_t)saturateQ30(x);
+        }
+    }
+}
+
+//
+// Runtime CPU dispatch
+//
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+
+#include "CPUDetect.h"
+
+void peaklog2Block_AVX2(const float* input, int32_t* output, int numFrames, int numChannels);
+void fixlog2Block_AVX2(const int32_t* input, int32_t* output, int numFrames);
+void fixexp2Block_AVX2(const int32_t* input, int32_t* output, int numFrames);
+void applyGainBlock_AVX2(const float* input, const float* gain, const float* dither, int16_t* output, int numFrames, int numChannels);
+void applyGainQ31Block_AVX2(const int32_t* input, const int32_t* gain, int16_t* output, int numFrames, int numChannels);
+
+void peaklog2Block(const float* input, int32_t* output, int numFrames, int numChannels) {
+    static auto f = cpuSupportsAVX2() ? peaklog2Block_AVX2 : peaklog2Block_ref;
+    (*f)(input, output, numFrames, numChannels); // dispatch
+}
+
+void fixlog2Block(const int32_t* input, int32_t* output, int numFrames) {
+    static auto f = cpuSupportsAVX2() ? fixlog2Block_AVX2 : fixlog2Block_ref;
+    (*f)(input, output, numFrames); // dispatch
+}
+
+void fixexp2Block(const int32_t* input, int32_t* output, int numFrames) {
+    static auto f = cpuSupportsAVX2() ? fixexp2Block_AVX2 : fixexp2Block_ref;
+    (*f)(input, output, numFrames); // dispatch
+}
+
+void applyGainBlock(const float* input, const float* gain, const float* dither, int16_t* output, int numFrames, int numChannels) {
+    static auto f = cpuSupportsAVX2() ? applyGainBlock_AVX2 : applyGainBlock_ref;
+    (*f)(input, gain, dither, output, numFrames, numChannels); // dispatch
+}
+
+void applyGainQ31Block(const int32_t* input, const int32_t* gain, int16_t* output, int numFrames, int numChannels) {
+    static auto f = cpuSupportsAVX2() ? applyGainQ31Block_AVX2 : applyGainQ31Block_ref;
+    (*f)(input, gain, output, numFrames, numChannels); // dispatch
+}
+
+#else   // portable reference code
+
+void peaklog2Block(const float* input, int32_t* output, int numFrames, int numChannels) {
+    peaklog2Block_ref(input, output, numFrames, numChannels);
+}
+
+void fixlog2Block(const int32_t* input, int32_t* output, int numFrames) {
+    fixlog2Block_ref(input, output, numFrames);
+}
+
+void fixexp2Block(const int32_t* input, int32_t* output, int numFrames) {
+    fixexp2Block_ref(input, output, numFrames);
+}
+
+void applyGainBlock(const float* input, const float* gain, const float* dither, int16_t* output, int numFrames, int numChannels) {
+    applyGainBlock_ref(input, gain, dither, output, numFrames, numChannels);
+}
+
+void applyGainQ31Block(const int32_t* input, const int32_t* gain, int16_t* output, int numFrames, int numChannels) {
+    applyGainQ31Block_ref(input, gain, output, numFrames, numChannels);
+}
+
+#endif
@@ -0,0 +1,48 @@
+//
+//  AudioDynamicsBlock.h
+//  libraries/audio/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioDynamicsBlock_h
+#define hifi_AudioDynamicsBlock_h
+
+#include <stdint.h>
+
+//
+// Block versions of the stateless stages of the limiter and gate.
+// The recursive stages (envelope, min/max filter, delay) run per sample between them,
+// while these run a block at a time, vectorized at runtime when the CPU supports it.
+// Audio is interleaved, with 1, 2 or 4 channels.
+//
+
+// the largest block the limiter and gate process at once
+static const int DYNAMICS_BLOCK = 256;
+
+// peak detection and -log2(x) of each frame of float input, result in Q26
+void peaklog2Block(const float* input, int32_t* output, int numFrames, int numChannels);
+
+// -log2(x) for x=[0,1] in Q31, result in Q26 (in-place is allowed)
+void fixlog2Block(const int32_t* input, int32_t* output, int numFrames);
+
+// exp2(-x) for x=[0,32] in Q26, result in Q31 (in-place is allowed)
+void fixexp2Block(const int32_t* input, int32_t* output, int numFrames);
+
+// output = round(input * gain + dither), with one gain and dither per frame
+void applyGainBlock(const float* input, const float* gain, const float* dither, int16_t* output, int numFrames, int numChannels);
+
+// output = saturate(input * gain), with Q30 input, one Q31 gain per frame and Q15 output
+void applyGainQ31Block(const int32_t* input, const int32_t* gain, int16_t* output, int numFrames, int numChannels);
+
+// portable reference code, always scalar
+void peaklog2Block_ref(const float* input, int32_t* output, int numFrames, int numChannels);
+void fixlog2Block_ref(const int32_t* input, int32_t* output, int numFrames);
+void fixexp2Block_ref(const int32_t* input, int32_t* output, int numFrames);
+void applyGainBlock_ref(const float* input, const float* gain, const float* dither, int16_t* output, int numFrames, int numChannels);
+void applyGainQ31Block_ref(const int32_t* input, const int32_t* gain, int16_t* output, int numFrames, int numChannels);
+
+#endif // hifi_AudioDynamicsBlock_h
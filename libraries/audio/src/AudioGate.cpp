@@ -13,19 +13,11 @@
 #include <assert.h>
 
 #include "AudioDynamics.h"
+#include "AudioDynamicsBlock.h"
 
 // log2 domain headroom bits above 0dB (int32_t)
 static const int LOG2_HEADROOM_Q30 = 1;
 
-// convert Q30 to Q15 with saturation
-static inline int32_t saturateQ30(int32_t x) {
-
-    x = (x + (1 << 14)) >> 15;
-    x = MIN(MAX(x, -32768), 32767);
-
-    return x;
-}
-
 //
 // First-order DC-blocking filter, with zero at 1.0 and pole at 0.9999
 //
@@ -410,50 +402,63 @@ public:
 template<int N>
 void GateMono<N>::process(int16_t* input, int16_t* output, int numFrames) {
 
+    int32_t buffer[DYNAMICS_BLOCK];
+    int32_t peak[DYNAMICS_BLOCK];
+    int32_t attn[DYNAMICS_BLOCK];
+
     clearHistogram();
 
-    for (int n = 0; n < numFrames; n++) {
+    for (int i = 0; i < numFrames; i += DYNAMICS_BLOCK) {
 
-        int32_t x = input[n];
+        int count = MIN(numFrames - i, DYNAMICS_BLOCK);
 
-        // remove DC
-        _dc.process(x);
+        for (int n = 0; n < count; n++) {
+
+            int32_t x = input[i+n];
 
-        // peak detect
-        int32_t peak = abs(x);
+            // remove DC
+            _dc.process(x);
+            buffer[n] = x;
+
+            // peak detect
+            peak[n] = abs(x);
+        }
 
         // convert to log2 domain
-        peak = fixlog2(peak);
+        fixlog2Block(peak, peak, count);
+
+        for (int n = 0; n < count; n++) {
 
-        // apply peak hold
-        peak = peakhold(peak);
+            // apply peak hold
+            int32_t level = peakhold(peak[n]);
 
-        // count peak level
-        updateHistogram(peak);
+            // count peak level
+            updateHistogram(level);
 
-        // apply hysteresis
-        peak = hysteresis(peak);
+            // apply hysteresis
+            level = hysteresis(level);
 
-        // compute gate attenuation
-        int32_t attn = (peak > _threshAdapt) ? 0x7fffffff : 0;    // hard-knee, 1:inf ratio
+            // compute gate attenuation
+            attn[n] = (level > _threshAdapt) ? 0x7fffffff : 0;    // hard-knee, 1:inf ratio
 
-        // apply envelope
-        attn = envelope(attn);
+            // apply envelope
+            attn[n] = envelope(attn[n]);
+        }
 
         // convert from log2 domain
-        attn = fixexp2(attn);
+        fixexp2Block(attn, attn, count);
 
-        // lowpass filter
-        attn = _filter.process(attn);
+        for (int n = 0; n < count; n++) {
 
-        // delay audio
-        _delay.process(x);
+            // lowpass filter
+            attn[n] = _filter.process(attn[n]);
 
-        // apply gain
-        x = MULQ31(x, attn);
+            // delay audio
+            _delay.process(buffer[n]);
+        }
 
-        // store 16-bit output
-        output[n] = (int16_t)saturateQ30(x);
+        // apply gain, store 16-bit output
+        applyGainQ31Block(buffer, attn, &output[i], count, 1);
     }
 
     // update adaptive threshold
@@ -496,53 +501,65 @@ public:
 template<int N>
 void GateStereo<N>::process(int16_t* input, int16_t* output, int numFrames) {
 
+    int32_t buffer[2*DYNAMICS_BLOCK];
+    int32_t peak[DYNAMICS_BLOCK];
+    int32_t attn[DYNAMICS_BLOCK];
+
     clearHistogram();
 
-    for (int n = 0; n < numFrames; n++) {
+    for (int i = 0; i < numFrames; i += DYNAMICS_BLOCK) {
 
-        int32_t x0 = input[2*n+0];
-        int32_t x1 = input[2*n+1];
+        int count = MIN(numFrames - i, DYNAMICS_BLOCK);
 
-        // remove DC
-        _dc.process(x0, x1);
+        for (int n = 0; n < count; n++) {
 
-        // peak detect
-        int32_t peak = MAX(abs(x0), abs(x1));
+            int32_t x0 = input[2*(i+n)+0];
+            int32_t x1 = input[2*(i+n)+1];
+
+            // remove DC
+            _dc.process(x0, x1);
+            buffer[2*n+0] = x0;
+            buffer[2*n+1] = x1;
+
+            // peak detect
+            peak[n] = MAX(abs(x0), abs(x1));
+        }
 
         // convert to log2 domain
-        peak = fixlog2(peak);
+        fixlog2Block(peak, peak, count);
 
-        // apply peak hold
-        peak = peakhold(peak);
+        for (int n = 0; n < count; n++) {
 
-        // count peak level
-        updateHistogram(peak);
+            // apply peak hold
+            int32_t level = peakhold(peak[n]);
 
-        // apply hysteresis
-        peak = hysteresis(peak);
+            // count peak level
+            updateHistogram(level);
 
-        // compute gate attenuation
-        int32_t attn = (peak > _threshAdapt) ? 0x7fffffff : 0;    // hard-knee, 1:inf ratio
+            // apply hysteresis
+            level = hysteresis(level);
 
-        // apply envelope
-        attn = envelope(attn);
+            // compute gate attenuation
+            attn[n] = (level > _threshAdapt) ? 0x7fffffff : 0;    // hard-knee, 1:inf ratio
+
+            // apply envelope
+            attn[n] = envelope(attn[n]);
+        }
 
         // convert from log2 domain
-        attn = fixexp2(attn);
+        fixexp2Block(attn, attn, count);
 
-        // lowpass filter
-        attn = _filter.process(attn);
+        for (int n = 0; n < count; n++) {
 
-        // delay audio
-        _delay.process(x0, x1);
+            // lowpass filter
+            attn[n] = _filter.process(attn[n]);
 
-        // apply gain
-        x0 = MULQ31(x0, attn);
-        x1 = MULQ31(x1, attn);
+            // delay audio
+            _delay.process(buffer[2*n+0], buffer[2*n+1]);
+        }
 
-        // store 16-bit output
-        output[2*n+0] = (int16_t)saturateQ30(x0);
-        output[2*n+1] = (int16_t)saturateQ30(x1);
+        // apply gain, store 16-bit output
+        applyGainQ31Block(buffer, attn, &output[2*i], count, 2);
     }
 
     // update adaptive threshold
@@ -587,59 +604,69 @@ public:
 template<int N>
 void GateQuad<N>::process(int16_t* input, int16_t* output, int numFrames) {
 
+    int32_t buffer[4*DYNAMICS_BLOCK];
+    int32_t peak[DYNAMICS_BLOCK];
+    int32_t attn[DYNAMICS_BLOCK];
+
     clearHistogram();
 
-    for (int n = 0; n < numFrames; n++) {
+    for (int i = 0; i < numFrames; i += DYNAMICS_BLOCK) {
 
-        int32_t x0 = input[4*n+0];
-        int32_t x1 = input[4*n+1];
-        int32_t x2 = input[4*n+2];
-        int32_t x3 = input[4*n+3];
+        int count = MIN(numFrames - i, DYNAMICS_BLOCK);
 
-        // remove DC
-        _dc.process(x0, x1, x2, x3);
+        for (int n = 0; n < count; n++) {
+
+            int32_t x0 = input[4*(i+n)+0];
+            int32_t x1 = input[4*(i+n)+1];
+            int32_t x2 = input[4*(i+n)+2];
+            int32_t x3 = input[4*(i+n)+3];
+
+            // remove DC
+            _dc.process(x0, x1, x2, x3);
+            buffer[4*n+0] = x0;
+            buffer[4*n+1] = x1;
+            buffer[4*n+2] = x2;
+            buffer[4*n+3] = x3;
 
-        // peak detect
-        int32_t peak = MAX(MAX(abs(x0), abs(x1)), MAX(abs(x2), abs(x3)));
+            // peak detect
+            peak[n] = MAX(MAX(abs(x0), abs(x1)), MAX(abs(x2), abs(x3)));
+        }
 
         // convert to log2 domain
-        peak = fixlog2(peak);
+        fixlog2Block(peak, peak, count);
+
+        for (int n = 0; n < count; n++) {
 
-        // apply peak hold
-        peak = peakhold(peak);
+            // apply peak hold
+            int32_t level = peakhold(peak[n]);
 
-        // count peak level
-        updateHistogram(peak);
+            // count peak level
+            updateHistogram(level);
 
-        // apply hysteresis
-        peak = hysteresis(peak);
+            // apply hysteresis
+            level = hysteresis(level);
 
-        // compute gate attenuation
-        int32_t attn = (peak > _threshAdapt) ? 0x7fffffff : 0;    // hard-knee, 1:inf ratio
+            // compute gate attenuation
+            attn[n] = (level > _threshAdapt) ? 0x7fffffff : 0;    // hard-knee, 1:inf ratio
 
-        // apply envelope
-        attn = envelope(attn);
+            // apply envelope
+            attn[n] = envelope(attn[n]);
+        }
 
         // convert from log2 domain
-        attn = fixexp2(attn);
+        fixexp2Block(attn, attn, count);
 
-        // lowpass filter
-        attn = _filter.process(attn);
+        for (int n = 0; n < count; n++) {
 
-        // delay audio
-        _delay.process(x0, x1, x2, x3);
+            // lowpass filter
+            attn[n] = _filter.process(attn[n]);
 
-        // apply gain
-        x0 = MULQ31(x0, attn);
-        x1 = MULQ31(x1, attn);
-        x2 = MULQ31(x2, attn);
-        x3 = MULQ31(x3, attn);
+            // delay audio
+            _delay.process(buffer[4*n+0], buffer[4*n+1], buffer[4*n+2], buffer[4*n+3]);
+        }
 
-        // store 16-bit output
-        output[4*n+0] = (int16_t)saturateQ30(x0);
-        output[4*n+1] = (int16_t)saturateQ30(x1);
-        output[4*n+2] = (int16_t)saturateQ30(x2);
-        output[4*n+3] = (int16_t)saturateQ30(x3);
+        // apply gain, store 16-bit output
+        applyGainQ31Block(buffer, attn, &output[4*i], count, 4);
     }
 
     // update adaptive threshold
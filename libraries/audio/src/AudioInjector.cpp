@@ -41,6 +41,7 @@ AudioInjectorState& operator|= (AudioInjectorState& lhs, AudioInjectorState rhs)
 AudioInjector::AudioInjector(SharedSoundPointer sound, const AudioInjectorOptions& injectorOptions) :
     _sound(sound),
     _audioData(sound->getAudioData()),
+    _streamingData(sound->getStreamingData()),
     _options(injectorOptions)
 {
 }
@@ -51,6 +52,12 @@ AudioInjector::AudioInjector(AudioDataPointer audioData, const AudioInjectorOpti
 {
 }
 
+AudioInjector::AudioInjector(StreamingAudioDataPointer streamingData, const AudioInjectorOptions& injectorOptions) :
+    _streamingData(streamingData),
+    _options(injectorOptions)
+{
+}
+
 AudioInjector::~AudioInjector() {
     deleteLocalBuffer();
 }
@@ -111,6 +118,7 @@ void AudioInjector::restart() {
 
     // reset the current send offset to zero
     _currentSendOffset = 0;
+    _streamingReader.reset();
 
     // reset state to start sending from beginning again
     _nextFrame = 0;
@@ -156,9 +164,13 @@ bool AudioInjector::inject(bool(AudioInjectorManager::*injection)(const AudioInj
 bool AudioInjector::injectLocally() {
     bool success = false;
     if (_localAudioInterface) {
-        if (_audioData->getNumBytes() > 0) {
+        if (getNumAudioBytes() > 0) {
 
-            _localBuffer = new AudioInjectorLocalBuffer(_audioData);
+            if (_streamingData) {
+                _localBuffer = new AudioInjectorLocalBuffer(_streamingData);
+            } else {
+                _localBuffer = new AudioInjectorLocalBuffer(_audioData);
+            }
 
             _localBuffer->open(QIODevice::ReadOnly);
             _localBuffer->setShouldLoop(_options.loop);
@@ -181,6 +193,13 @@ bool AudioInjector::injectLocally() {
     return success;
 }
 
+uint32_t AudioInjector::getNumAudioBytes() const {
+    if (_streamingData) {
+        return _streamingData->getNumBytes();
+    }
+    return _audioData ? _audioData->getNumBytes() : 0;
+}
+
 void AudioInjector::deleteLocalBuffer() {
     if (_localBuffer) {
         _localBuffer->stop();
@@ -215,19 +234,14 @@ int64_t AudioInjector::injectNextFrame() {
     }
 
     // if we haven't setup the packet to send then do so now
-    static int loopbackOptionOffset = -1;
-    static int positionOptionOffset = -1;
-    static int volumeOptionOffset = -1;
-    static int audioDataOffset = -1;
-
     if (!_currentPacket) {
         if (_currentSendOffset < 0 ||
-            _currentSendOffset >= (int)_audioData->getNumBytes()) {
+            _currentSendOffset >= (int)getNumAudioBytes()) {
             _currentSendOffset = 0;
         }
 
         // make sure we actually have samples downloaded to inject
-        if (_audioData && _audioData->getNumSamples() > 0) {
+        if (getNumAudioBytes() > 0) {
             _outgoingSequenceNumber = 0;
             _nextFrame = 0;
 
@@ -256,12 +270,12 @@ int64_t AudioInjector::injectNextFrame() {
             audioPacketStream << _options.stereo;
 
             // pack the flag for loopback, if requested
-            loopbackOptionOffset = _currentPacket->pos();
+            _loopbackOptionOffset = _currentPacket->pos();
             uchar loopbackFlag = (_localAudioInterface && _localAudioInterface->shouldLoopbackInjectors());
             audioPacketStream << loopbackFlag;
 
             // pack the position for injected audio
-            positionOptionOffset = _currentPacket->pos();
+            _positionOptionOffset = _currentPacket->pos();
             audioPacketStream.writeRawData(reinterpret_cast<const char*>(&_options.position),
                                            sizeof(_options.position));
 
@@ -280,12 +294,12 @@ int64_t AudioInjector::injectNextFrame() {
             audioPacketStream << radius;
 
             // pack 255 for attenuation byte
-            volumeOptionOffset = _currentPacket->pos();
+            _volumeOptionOffset = _currentPacket->pos();
             quint8 volume = MAX_INJECTOR_VOLUME;
             audioPacketStream << volume;
             audioPacketStream << _options.ignorePenumbra;
 
-            audioDataOffset = _currentPacket->pos();
+            _audioDataOffset = _currentPacket->pos();
 
         } else {
             // no samples to inject, return immediately
@@ -299,28 +313,28 @@ int64_t AudioInjector::injectNextFrame() {
         _frameTimer->restart();
     }
 
-    assert(loopbackOptionOffset != -1);
-    assert(positionOptionOffset != -1);
-    assert(volumeOptionOffset != -1);
-    assert(audioDataOffset != -1);
+    assert(_loopbackOptionOffset != -1);
+    assert(_positionOptionOffset != -1);
+    assert(_volumeOptionOffset != -1);
+    assert(_audioDataOffset != -1);
 
     _currentPacket->seek(0);
 
     // pack the sequence number
     _currentPacket->writePrimitive(_outgoingSequenceNumber);
 
-    _currentPacket->seek(loopbackOptionOffset);
+    _currentPacket->seek(_loopbackOptionOffset);
     _currentPacket->writePrimitive((uchar)(_localAudioInterface && _localAudioInterface->shouldLoopbackInjectors()));
 
-    _currentPacket->seek(positionOptionOffset);
+    _currentPacket->seek(_positionOptionOffset);
     _currentPacket->writePrimitive(_options.position);
     _currentPacket->writePrimitive(_options.orientation);
 
     quint8 volume = packFloatGainToByte(_options.volume);
-    _currentPacket->seek(volumeOptionOffset);
+    _currentPacket->seek(_volumeOptionOffset);
     _currentPacket->writePrimitive(volume);
 
-    _currentPacket->seek(audioDataOffset);
+    _currentPacket->seek(_audioDataOffset);
 
     // This code is copying bytes from the _sound directly into the packet, handling looping appropriately.
     // Might be a reasonable place to do the encode step here.
@@ -329,29 +343,45 @@ int64_t AudioInjector::injectNextFrame() {
     int totalBytesLeftToCopy = (_options.stereo ? 2 : 1) * AudioConstants::NETWORK_FRAME_BYTES_PER_CHANNEL;
     if (!_options.loop) {
         // If we aren't looping, let's make sure we don't read past the end
-        int bytesLeftToRead = _audioData->getNumBytes() - _currentSendOffset;
+        int bytesLeftToRead = getNumAudioBytes() - _currentSendOffset;
         totalBytesLeftToCopy = std::min(totalBytesLeftToCopy, bytesLeftToRead);
     }
 
-    auto samples = _audioData->data();
-    auto currentSample = _currentSendOffset / AudioConstants::SAMPLE_SIZE;
     auto samplesLeftToCopy = totalBytesLeftToCopy / AudioConstants::SAMPLE_SIZE;
 
     using AudioConstants::AudioSample;
     decodedAudio.resize(totalBytesLeftToCopy);
     auto samplesOut = reinterpret_cast<AudioSample*>(decodedAudio.data());
 
-    //  Copy and Measure the loudness of this frame
+    if (_streamingData) {
+        // streaming sounds are decoded as they are sent, the reader is only moved when the send offset jumps
+        int bytesPerFrame = _streamingData->getNumChannels() * AudioConstants::SAMPLE_SIZE;
+        if (!_streamingReader) {
+            _streamingReader.reset(new StreamingAudioReader(_streamingData));
+            _streamingReader->seek(_currentSendOffset / bytesPerFrame);
+        }
+        int numFrames = totalBytesLeftToCopy / bytesPerFrame;
+        int framesRead = _streamingReader->read(samplesOut, numFrames, _options.loop);
+        if (framesRead < numFrames) {
+            // the decoded length is estimated, pad the end with silence
+            memset(samplesOut + framesRead * _streamingData->getNumChannels(), 0, (numFrames - framesRead) * bytesPerFrame);
+        }
+    } else {
+        auto samples = _audioData->data();
+        auto currentSample = _currentSendOffset / AudioConstants::SAMPLE_SIZE;
+        for (int i = 0; i < samplesLeftToCopy; ++i) {
+            samplesOut[i] = samples[(currentSample + i) % _audioData->getNumSamples()];
+        }
+    }
+
+    //  Measure the loudness of this frame
     _loudness = 0.0f;
     for (int i = 0; i < samplesLeftToCopy; ++i) {
-        auto index = (currentSample + i) % _audioData->getNumSamples();
-        auto sample = samples[index];
-        samplesOut[i] = sample;
-        _loudness += abs(sample) / (AudioConstants::MAX_SAMPLE_VALUE / 2.0f);
+        _loudness += abs(samplesOut[i]) / (AudioConstants::MAX_SAMPLE_VALUE / 2.0f);
     }
     _loudness /= (float)samplesLeftToCopy;
     _currentSendOffset = (_currentSendOffset + totalBytesLeftToCopy) %
-                         _audioData->getNumBytes();
+                         getNumAudioBytes();
 
     // FIXME -- good place to call codec encode here. We need to figure out how to tell the AudioInjector which
     // codec to use... possible through AbstractAudioInterface.
@@ -361,18 +391,12 @@ int64_t AudioInjector::injectNextFrame() {
     // set the correct size used for this packet
     _currentPacket->setPayloadSize(_currentPacket->pos());
 
-    // grab our audio mixer from the NodeList, if it exists
-    auto nodeList = DependencyManager::get<NodeList>();
-    SharedNodePointer audioMixer = nodeList->soloNodeOfType(NodeType::AudioMixer);
-
-    if (audioMixer) {
-        // send off this audio packet
-        nodeList->sendUnreliablePacket(*_currentPacket, *audioMixer);
-        _outgoingSequenceNumber++;
-    }
+    // the AudioInjectorManager sends the frames of all the injectors it served in one batch
+    _hasFrameToSend = true;
 
     if (_currentSendOffset == 0 && !_options.loop) {
-        finishNetworkInjection();
+        // network injection finishes once the AudioInjectorManager has sent this last frame
+        _isLastFrame = true;
         return NEXT_FRAME_DELTA_ERROR_OR_FINISHED;
     }
 
@@ -391,7 +415,10 @@ int64_t AudioInjector::injectNextFrame() {
         // If we are falling behind by more frames than our threshold, let's skip the frames ahead
         qCDebug(audio)  << this << "injectNextFrame() skipping ahead, fell behind by " << (currentFrameBasedOnElapsedTime - _nextFrame) << " frames";
         _nextFrame = currentFrameBasedOnElapsedTime;
-        _currentSendOffset = _nextFrame * AudioConstants::NETWORK_FRAME_BYTES_PER_CHANNEL * (_options.stereo ? 2 : 1) % _audioData->getNumBytes();
+        _currentSendOffset = _nextFrame * AudioConstants::NETWORK_FRAME_BYTES_PER_CHANNEL * (_options.stereo ? 2 : 1) % getNumAudioBytes();
+        if (_streamingReader) {
+            _streamingReader->seek(_currentSendOffset / (_streamingData->getNumChannels() * AudioConstants::SAMPLE_SIZE));
+        }
     }
 
     int64_t playNextFrameAt = ++_nextFrame * AudioConstants::NETWORK_FRAME_USECS;
@@ -399,6 +426,24 @@ int64_t AudioInjector::injectNextFrame() {
     return std::max(INT64_C(0), playNextFrameAt - currentTime);
 }
 
+void AudioInjector::sendFrame(LimitedNodeList& nodeList, const SharedNodePointer& audioMixer) {
+    if (!_hasFrameToSend) {
+        return;
+    }
+    _hasFrameToSend = false;
+
+    if (audioMixer) {
+        // send off this audio packet
+        nodeList.sendUnreliablePacket(*_currentPacket, *audioMixer);
+        _outgoingSequenceNumber++;
+    }
+
+    if (_isLastFrame) {
+        _isLastFrame = false;
+        finishNetworkInjection();
+    }
+}
+
 void AudioInjector::stop() {
     // trigger a call on the injector's thread to change state to finished
     QMetaObject::invokeMethod(this, "finish");
@@ -451,6 +496,17 @@ AudioInjectorPointer AudioInjector::playSound(SharedSoundPointer sound,  const A
         const float pitch = glm::clamp(options.pitch, 1 / 16.0f, 16.0f);
         const int resampledRate = glm::round(SAMPLE_RATE / pitch);
 
+        if (sound->isStreaming()) {
+            // the stream resamples as it decodes, so there is no need to resample the whole sound up front
+            auto streamingData = sound->getStreamingData()->withOutputSampleRate(resampledRate);
+            AudioInjectorPointer injector = AudioInjectorPointer::create(streamingData, options);
+
+            if (!injector->inject(&AudioInjectorManager::threadInjector)) {
+                qWarning() << "AudioInjector::playSound failed to thread pitch-shifted injector";
+            }
+            return injector;
+        }
+
         auto audioData = sound->getAudioData();
         auto numChannels = audioData->getNumChannels();
         auto numFrames = audioData->getNumFrames();
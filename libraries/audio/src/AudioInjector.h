@@ -22,6 +22,7 @@
 #include <glm/glm.hpp>
 #include <glm/gtx/quaternion.hpp>
 
+#include <LimitedNodeList.h>
 #include <NLPacket.h>
 
 #include "AudioInjectorLocalBuffer.h"
@@ -54,6 +55,7 @@ class AudioInjector : public QObject, public QEnableSharedFromThis<AudioInjector
 public:
     AudioInjector(SharedSoundPointer sound, const AudioInjectorOptions& injectorOptions);
     AudioInjector(AudioDataPointer audioData, const AudioInjectorOptions& injectorOptions);
+    AudioInjector(StreamingAudioDataPointer streamingData, const AudioInjectorOptions& injectorOptions);
     ~AudioInjector();
 
     bool isFinished() const { return (stateHas(AudioInjectorState::Finished)); }
@@ -101,20 +103,30 @@ signals:
 
 private:
     int64_t injectNextFrame();
+    void sendFrame(LimitedNodeList& nodeList, const SharedNodePointer& audioMixer);
     bool inject(bool(AudioInjectorManager::*injection)(const AudioInjectorPointer&));
     bool injectLocally();
     void deleteLocalBuffer();
+    uint32_t getNumAudioBytes() const;
 
     static AbstractAudioInterface* _localAudioInterface;
 
     const SharedSoundPointer _sound;
     AudioDataPointer _audioData;
+    StreamingAudioDataPointer _streamingData;
+    std::unique_ptr<StreamingAudioReader> _streamingReader;
     AudioInjectorOptions _options;
     AudioInjectorState _state { AudioInjectorState::NotFinished };
     bool _hasSentFirstFrame { false };
     float _loudness { 0.0f };
     int _currentSendOffset { 0 };
     std::unique_ptr<NLPacket> _currentPacket { nullptr };
+    bool _hasFrameToSend { false };
+    bool _isLastFrame { false };
+    int _loopbackOptionOffset { -1 };
+    int _positionOptionOffset { -1 };
+    int _volumeOptionOffset { -1 };
+    int _audioDataOffset { -1 };
     AudioInjectorLocalBuffer* _localBuffer { nullptr };
 
     int64_t _nextFrame { 0 };
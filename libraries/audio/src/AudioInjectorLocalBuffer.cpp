@@ -16,6 +16,20 @@ AudioInjectorLocalBuffer::AudioInjectorLocalBuffer(AudioDataPointer audioData) :
 {
 }
 
+AudioInjectorLocalBuffer::AudioInjectorLocalBuffer(StreamingAudioDataPointer streamingData) :
+    _streamingReader(new StreamingAudioReader(streamingData, true))
+{
+}
+
+void AudioInjectorLocalBuffer::setCurrentOffset(int currentOffset) {
+    if (_streamingReader) {
+        int bytesPerFrame = _streamingReader->getData()->getNumChannels() * AudioConstants::SAMPLE_SIZE;
+        _streamingReader->seek(currentOffset / bytesPerFrame);
+    } else {
+        _currentOffset = currentOffset;
+    }
+}
+
 void AudioInjectorLocalBuffer::stop() {
     _isStopped = true;
     
@@ -32,7 +46,13 @@ bool AudioInjectorLocalBuffer::seek(qint64 pos) {
 
 
 qint64 AudioInjectorLocalBuffer::readData(char* data, qint64 maxSize) {
-    if (!_isStopped) {
+    if (!_isStopped && _streamingReader) {
+        // streaming sounds are decoded ahead on the thread pool, this runs on the audio thread so it never waits on the decoder
+        int bytesPerFrame = _streamingReader->getData()->getNumChannels() * AudioConstants::SAMPLE_SIZE;
+        int framesRead = _streamingReader->read(reinterpret_cast<AudioConstants::AudioSample*>(data),
+                                                (int)(maxSize / bytesPerFrame), _shouldLoop);
+        return framesRead * bytesPerFrame;
+    } else if (!_isStopped) {
         
         // first copy to the end of the raw audio
         int bytesToEnd = (int)_audioData->getNumBytes() - _currentOffset;
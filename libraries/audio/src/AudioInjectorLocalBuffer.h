@@ -12,6 +12,8 @@
 #ifndef hifi_AudioInjectorLocalBuffer_h
 #define hifi_AudioInjectorLocalBuffer_h
 
+#include <memory>
+
 #include <QtCore/qiodevice.h>
 
 #include <glm/common.hpp>
@@ -22,6 +24,7 @@ class AudioInjectorLocalBuffer : public QIODevice {
     Q_OBJECT
 public:
     AudioInjectorLocalBuffer(AudioDataPointer audioData);
+    AudioInjectorLocalBuffer(StreamingAudioDataPointer streamingData);
 
     void stop();
 
@@ -31,12 +34,13 @@ public:
     qint64 writeData(const char* data, qint64 maxSize) override { return 0; }
 
     void setShouldLoop(bool shouldLoop) { _shouldLoop = shouldLoop; }
-    void setCurrentOffset(int currentOffset) { _currentOffset = currentOffset; }
+    void setCurrentOffset(int currentOffset);
 
 private:
     qint64 recursiveReadFromFront(char* data, qint64 maxSize);
 
     AudioDataPointer _audioData;
+    std::unique_ptr<StreamingAudioReader> _streamingReader;
     bool _shouldLoop { false };
     bool _isStopped { false };
     int _currentOffset { 0 };
@@ -11,114 +11,158 @@
 
 #include "AudioInjectorManager.h"
 
+#include <algorithm>
+
 #include <QtCore/QCoreApplication>
 
+#include <NodeList.h>
 #include <SharedUtil.h>
 
 #include "AudioConstants.h"
 #include "AudioInjector.h"
 #include "AudioLogging.h"
 
+static const int MAX_INJECTORS_PER_THREAD = 40; // calculated based on AudioInjector time to send frame, with sufficient padding
+static const int MAX_INJECTOR_THREADS = 4;
+
+// a new thread is started once every thread serves this many injectors
+static const int INJECTORS_PER_THREAD_BEFORE_NEW_THREAD = MAX_INJECTORS_PER_THREAD / 2;
+
+static int maxInjectorThreads() {
+    return std::max(1, std::min(MAX_INJECTOR_THREADS, QThread::idealThreadCount() / 2));
+}
+
 AudioInjectorManager::~AudioInjectorManager() {
     _shouldStop = true;
 
-    Lock lock(_injectorsMutex);
+    Lock threadsLock(_threadsMutex);
 
-    // make sure any still living injectors are stopped and deleted
-    while (!_injectors.empty()) {
-        // grab the injector at the front
-        auto& timePointerPair = _injectors.top();
+    for (auto& injectorThread : _threads) {
+        Lock lock(injectorThread->mutex);
 
-        // ask it to stop and be deleted
-        timePointerPair.second->stop();
+        // make sure any still living injectors are stopped and deleted
+        while (!injectorThread->injectors.empty()) {
+            // grab the injector at the front
+            auto& timePointerPair = injectorThread->injectors.top();
 
-        _injectors.pop();
-    }
+            // ask it to stop and be deleted
+            timePointerPair.second->stop();
 
-    // get rid of the lock now that we've stopped all living injectors
-    lock.unlock();
+            injectorThread->injectors.pop();
+        }
 
-    // in case the thread is waiting for injectors wake it up now
-    _injectorReady.notify_one();
+        // get rid of the lock now that we've stopped all living injectors
+        lock.unlock();
+
+        // in case the thread is waiting for injectors wake it up now
+        injectorThread->injectorReady.notify_one();
+    }
+
+    // an injector restarting on its thread needs the threads lock, release it before waiting on them
+    threadsLock.unlock();
 
-    // quit and wait on the manager thread, if we ever created it
-    if (_thread) {
-        _thread->quit();
-        _thread->wait();
+    // quit and wait on the injector threads
+    for (auto& injectorThread : _threads) {
+        injectorThread->thread->quit();
+        injectorThread->thread->wait();
+        delete injectorThread->thread;
     }
 }
 
-void AudioInjectorManager::createThread() {
-    _thread = new QThread;
-    _thread->setObjectName("Audio Injector Thread");
+// Must be called with _threadsMutex held
+AudioInjectorManager::InjectorThread* AudioInjectorManager::createThread() {
+    _threads.emplace_back(new InjectorThread());
+    auto injectorThread = _threads.back().get();
+
+    injectorThread->thread = new QThread;
+    injectorThread->thread->setObjectName(QString("Audio Injector Thread %1").arg(_threads.size()));
 
     // when the thread is started, have it call our run to handle injection of audio
-    connect(_thread, &QThread::started, this, &AudioInjectorManager::run, Qt::DirectConnection);
+    connect(injectorThread->thread, &QThread::started, this, [this, injectorThread] {
+        run(injectorThread);
+    }, Qt::DirectConnection);
 
     // start the thread
-    _thread->start();
+    injectorThread->thread->start();
+
+    return injectorThread;
+}
+
+// Must be called with _threadsMutex held
+AudioInjectorManager::InjectorThread* AudioInjectorManager::selectThread() {
+    InjectorThread* leastBusyThread = nullptr;
+    size_t leastInjectors = 0;
+    for (auto& injectorThread : _threads) {
+        Lock lock(injectorThread->mutex);
+        if (!leastBusyThread || injectorThread->injectors.size() < leastInjectors) {
+            leastBusyThread = injectorThread.get();
+            leastInjectors = injectorThread->injectors.size();
+        }
+    }
+
+    if (!leastBusyThread ||
+        (leastInjectors >= INJECTORS_PER_THREAD_BEFORE_NEW_THREAD && (int)_threads.size() < maxInjectorThreads())) {
+        return createThread();
+    }
+
+    if (leastInjectors >= MAX_INJECTORS_PER_THREAD) {
+        qCDebug(audio) << "AudioInjectorManager::threadInjector could not thread AudioInjector - at max of"
+            << MAX_INJECTORS_PER_THREAD * (int)_threads.size() << "current audio injectors.";
+        return nullptr;
+    }
+    return leastBusyThread;
+}
+
+// Must be called with _threadsMutex held
+AudioInjectorManager::InjectorThread* AudioInjectorManager::findThread(const AudioInjectorPointer& injector) {
+    for (auto& injectorThread : _threads) {
+        if (injectorThread->thread == injector->thread()) {
+            return injectorThread.get();
+        }
+    }
+    return nullptr;
+}
+
+void AudioInjectorManager::queueInjector(InjectorThread* injectorThread, const AudioInjectorPointer& injector) {
+    Lock lock(injectorThread->mutex);
+
+    // add the injector to the queue with a send timestamp of now
+    injectorThread->injectors.emplace(usecTimestampNow(), injector);
+
+    // notify our wait condition so we can inject two frames for this injector immediately
+    injectorThread->injectorReady.notify_one();
+}
+
+void AudioInjectorManager::notifyInjectorReadyCondition() {
+    Lock threadsLock(_threadsMutex);
+    for (auto& injectorThread : _threads) {
+        injectorThread->injectorReady.notify_one();
+    }
 }
 
-void AudioInjectorManager::run() {
+void AudioInjectorManager::run(InjectorThread* injectorThread) {
+    auto& injectors = injectorThread->injectors;
+
     while (!_shouldStop) {
         // wait until the next injector is ready, or until we get a new injector given to us
-        Lock lock(_injectorsMutex);
+        Lock lock(injectorThread->mutex);
 
-        if (_injectors.size() > 0) {
+        if (injectors.size() > 0) {
             // when does the next injector need to send a frame?
             // do we get to wait or should we just go for it now?
+            auto now = usecTimestampNow();
+            auto nextTimestamp = injectors.top().first;
 
-            auto timeInjectorPair = _injectors.top();
-
-            auto nextTimestamp = timeInjectorPair.first;
-            int64_t difference = int64_t(nextTimestamp - usecTimestampNow());
-
-            if (difference > 0) {
-                _injectorReady.wait_for(lock, std::chrono::microseconds(difference));
+            if (nextTimestamp > now) {
+                injectorThread->injectorReady.wait_for(lock, std::chrono::microseconds(nextTimestamp - now));
             }
 
-            if (_injectors.size() > 0) {
-                // loop through the injectors in the map and send whatever frames need to go out
-                auto front = _injectors.top();
-
-                // create an InjectorQueue to hold injectors to be queued
-                // this allows us to call processEvents even if a single injector wants to be re-queued immediately
-                std::vector<TimeInjectorPointerPair> heldInjectors;
-                heldInjectors.reserve(_injectors.size());
-
-                while (_injectors.size() > 0 && front.first <= usecTimestampNow()) {
-                    // either way we're popping this injector off - get a copy first
-                    auto injector = front.second;
-                    _injectors.pop();
-
-                    if (!injector.isNull()) {
-                        // this is an injector that's ready to go, have it send a frame now
-                        auto nextCallDelta = injector->injectNextFrame();
-
-                        if (nextCallDelta >= 0 && !injector->isFinished()) {
-                            // enqueue the injector with the correct timing in our holding queue
-                            heldInjectors.emplace(heldInjectors.end(), usecTimestampNow() + nextCallDelta, injector);
-                        }
-                    }
-
-                    if (_injectors.size() > 0) {
-                        front = _injectors.top();
-                    } else {
-                        // no more injectors to look at, break
-                        break;
-                    }
-                }
-
-                // if there are injectors in the holding queue, push them to our persistent queue now
-                while (!heldInjectors.empty()) {
-                    _injectors.push(heldInjectors.back());
-                    heldInjectors.pop_back();
-                }
+            if (!_shouldStop) {
+                injectFrames(injectorThread, lock);
             }
-
         } else {
             // we have no current injectors, wait until we get at least one before we do anything
-            _injectorReady.wait(lock);
+            injectorThread->injectorReady.wait(lock);
         }
 
         // unlock the lock in case something in process events needs to modify the queue
@@ -128,15 +172,93 @@ void AudioInjectorManager::run() {
     }
 }
 
-static const int MAX_INJECTORS_PER_THREAD = 40; // calculated based on AudioInjector time to send frame, with sufficient padding
+// Must be called with the lock of injectorThread held, releases it while sending
+void AudioInjectorManager::injectFrames(InjectorThread* injectorThread, Lock& lock) {
+    auto& injectors = injectorThread->injectors;
+    auto passStart = usecTimestampNow();
+
+    // hold the injectors that are re-queued until the pass is done,
+    // this allows us to call processEvents even if a single injector wants to be re-queued immediately
+    std::vector<TimeInjectorPointerPair> heldInjectors;
+    std::vector<AudioInjectorPointer> framesToSend;
+    uint64_t lateFrames = 0;
+
+    // prepare the frames of every injector that is due
+    while (injectors.size() > 0 && injectors.top().first <= passStart) {
+        // either way we're popping this injector off - get a copy first
+        auto timeInjectorPair = injectors.top();
+        injectors.pop();
+
+        auto& injector = timeInjectorPair.second;
+        if (injector.isNull()) {
+            continue;
+        }
+
+        if (passStart - timeInjectorPair.first > (uint64_t)AudioConstants::NETWORK_FRAME_USECS) {
+            ++lateFrames;
+        }
+
+        auto nextCallDelta = injector->injectNextFrame();
+        framesToSend.push_back(injector);
 
-bool AudioInjectorManager::wouldExceedLimits() { // Should be called inside of a lock.
-    if (_injectors.size() >= MAX_INJECTORS_PER_THREAD) {
-        qCDebug(audio)  << "AudioInjectorManager::threadInjector could not thread AudioInjector - at max of"
-            << MAX_INJECTORS_PER_THREAD << "current audio injectors.";
-        return true;
+        if (nextCallDelta >= 0 && !injector->isFinished()) {
+            // enqueue the injector with the correct timing in our holding queue
+            heldInjectors.emplace_back(usecTimestampNow() + nextCallDelta, injector);
+        }
+    }
+
+    // if there are injectors in the holding queue, push them to our persistent queue now
+    for (auto& heldInjector : heldInjectors) {
+        injectors.push(heldInjector);
+    }
+
+    lock.unlock();
+
+    // send all the frames of this pass together
+    if (!framesToSend.empty()) {
+        auto nodeList = DependencyManager::get<NodeList>();
+        SharedNodePointer audioMixer = nodeList->soloNodeOfType(NodeType::AudioMixer);
+        for (auto& injector : framesToSend) {
+            injector->sendFrame(*nodeList, audioMixer);
+        }
     }
-    return false;
+
+    injectorThread->framesSent += framesToSend.size();
+    injectorThread->lateFrames += lateFrames;
+    injectorThread->passes++;
+    injectorThread->processingUsecs += usecTimestampNow() - passStart;
+
+    lock.lock();
+}
+
+QJsonObject AudioInjectorManager::getStats() const {
+    Lock threadsLock(_threadsMutex);
+
+    uint64_t numInjectors = 0;
+    uint64_t framesSent = 0;
+    uint64_t lateFrames = 0;
+    uint64_t passes = 0;
+    uint64_t processingUsecs = 0;
+    for (auto& injectorThread : _threads) {
+        {
+            Lock lock(injectorThread->mutex);
+            numInjectors += injectorThread->injectors.size();
+        }
+        framesSent += injectorThread->framesSent;
+        lateFrames += injectorThread->lateFrames;
+        passes += injectorThread->passes;
+        processingUsecs += injectorThread->processingUsecs;
+    }
+
+    QJsonObject stats;
+    stats["threads"] = (int)_threads.size();
+    stats["injectors"] = (double)numInjectors;
+    stats["frames_sent"] = (double)framesSent;
+    stats["late_frames"] = (double)lateFrames;
+    stats["processing_usecs"] = (double)processingUsecs;
+    stats["usecs_per_frame"] = framesSent > 0 ? (double)processingUsecs / framesSent : 0.0;
+    stats["frames_per_pass"] = passes > 0 ? (double)framesSent / passes : 0.0;
+    return stats;
 }
 
 bool AudioInjectorManager::threadInjector(const AudioInjectorPointer& injector) {
@@ -145,27 +267,18 @@ bool AudioInjectorManager::threadInjector(const AudioInjectorPointer& injector)
         return false;
     }
 
-    // guard the injectors vector with a mutex
-    Lock lock(_injectorsMutex);
+    Lock threadsLock(_threadsMutex);
 
-    if (wouldExceedLimits()) {
+    auto injectorThread = selectThread();
+    if (!injectorThread) {
         return false;
-    } else {
-        if (!_thread) {
-            createThread();
-        }
-
-        // move the injector to the QThread
-        injector->moveToThread(_thread);
-
-        // add the injector to the queue with a send timestamp of now
-        _injectors.emplace(usecTimestampNow(), injector);
+    }
 
-        // notify our wait condition so we can inject two frames for this injector immediately
-        _injectorReady.notify_one();
+    // move the injector to the QThread
+    injector->moveToThread(injectorThread->thread);
 
-        return true;
-    }
+    queueInjector(injectorThread, injector);
+    return true;
 }
 
 bool AudioInjectorManager::restartFinishedInjector(const AudioInjectorPointer& injector) {
@@ -174,17 +287,23 @@ bool AudioInjectorManager::restartFinishedInjector(const AudioInjectorPointer& i
         return false;
     }
 
-    // guard the injectors vector with a mutex
-    Lock lock(_injectorsMutex);
+    Lock threadsLock(_threadsMutex);
 
-    if (wouldExceedLimits()) {
+    // the injector is restarted on the thread it already lives on
+    auto injectorThread = findThread(injector);
+    if (!injectorThread) {
         return false;
-    } else {
-        // add the injector to the queue with a send timestamp of now
-        _injectors.emplace(usecTimestampNow(), injector);
+    }
 
-        // notify our wait condition so we can inject two frames for this injector immediately
-        _injectorReady.notify_one();
+    {
+        Lock lock(injectorThread->mutex);
+        if (injectorThread->injectors.size() >= MAX_INJECTORS_PER_THREAD) {
+            qCDebug(audio) << "AudioInjectorManager::restartFinishedInjector could not restart AudioInjector - at max of"
+                << MAX_INJECTORS_PER_THREAD << "audio injectors on its thread.";
+            return false;
+        }
     }
+
+    queueInjector(injectorThread, injector);
     return true;
 }
@@ -14,10 +14,14 @@
 #ifndef hifi_AudioInjectorManager_h
 #define hifi_AudioInjectorManager_h
 
+#include <atomic>
 #include <condition_variable>
+#include <memory>
 #include <queue>
 #include <mutex>
+#include <vector>
 
+#include <QtCore/QJsonObject>
 #include <QtCore/QPointer>
 #include <QtCore/QThread>
 
@@ -25,13 +29,18 @@
 
 #include "AudioInjector.h"
 
+// Sends the network frames of the audio injectors.  Injectors are spread over a few threads, each thread wakes up when
+// its earliest injector is due, prepares the frames of all its injectors that are due by then and sends them after
+// releasing its lock.  Injectors keep their own timing, so only the ones due at the same time share a pass.
 class AudioInjectorManager : public QObject, public Dependency {
     Q_OBJECT
     SINGLETON_DEPENDENCY
 public:
     ~AudioInjectorManager();
-private slots:
-    void run();
+
+    // Number of injectors and threads, frames sent, frames sent late and the time spent preparing and sending them
+    QJsonObject getStats() const;
+
 private:
 
     using TimeInjectorPointerPair = std::pair<uint64_t, AudioInjectorPointer>;
@@ -48,22 +57,38 @@ private:
     using Mutex = std::mutex;
     using Lock = std::unique_lock<Mutex>;
 
+    struct InjectorThread {
+        QThread* thread { nullptr };
+        InjectorQueue injectors;
+        Mutex mutex;
+        std::condition_variable injectorReady;
+
+        std::atomic<uint64_t> framesSent { 0 };
+        std::atomic<uint64_t> lateFrames { 0 };
+        std::atomic<uint64_t> passes { 0 };
+        std::atomic<uint64_t> processingUsecs { 0 };
+    };
+
     bool threadInjector(const AudioInjectorPointer& injector);
     bool restartFinishedInjector(const AudioInjectorPointer& injector);
-    void notifyInjectorReadyCondition() { _injectorReady.notify_one(); }
-    bool wouldExceedLimits();
+    void notifyInjectorReadyCondition();
 
     AudioInjectorManager() {};
     AudioInjectorManager(const AudioInjectorManager&) = delete;
     AudioInjectorManager& operator=(const AudioInjectorManager&) = delete;
 
-    void createThread();
+    InjectorThread* createThread();
+    InjectorThread* selectThread();
+    InjectorThread* findThread(const AudioInjectorPointer& injector);
+    void queueInjector(InjectorThread* injectorThread, const AudioInjectorPointer& injector);
+    void run(InjectorThread* injectorThread);
+    void injectFrames(InjectorThread* injectorThread, Lock& lock);
+
+    std::atomic<bool> _shouldStop { false };
 
-    QThread* _thread { nullptr };
-    bool _shouldStop { false };
-    InjectorQueue _injectors;
-    Mutex _injectorsMutex;
-    std::condition_variable _injectorReady;
+    // guards the list of threads, each thread has its own lock for its injectors
+    mutable Mutex _threadsMutex;
+    std::vector<std::unique_ptr<InjectorThread>> _threads;
 
     friend class AudioInjector;
 };
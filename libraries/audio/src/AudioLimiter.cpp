@@ -11,6 +11,7 @@
 #include <assert.h>
 
 #include "AudioDynamics.h"
+#include "AudioDynamicsBlock.h"
 
 //
 // Limiter (common)
@@ -209,36 +210,48 @@ public:
 template<int N>
 void LimiterMono<N>::process(float* input, int16_t* output, int numFrames) {
 
-    for (int n = 0; n < numFrames; n++) {
+    int32_t peak[DYNAMICS_BLOCK];
+    int32_t attn[DYNAMICS_BLOCK];
+    float gain[DYNAMICS_BLOCK];
+    float noise[DYNAMICS_BLOCK];
+    float delayed[DYNAMICS_BLOCK];
+
+    for (int i = 0; i < numFrames; i += DYNAMICS_BLOCK) {
+
+        int count = MIN(numFrames - i, DYNAMICS_BLOCK);
+        float* in = &input[i];
 
         // peak detect and convert to log2 domain
-        int32_t peak = peaklog2(&input[n]);
+        peaklog2Block(in, peak, count, 1);
 
-        // compute limiter attenuation
-        int32_t attn = MAX(_threshold - peak, 0);
+        for (int n = 0; n < count; n++) {
 
-        // apply envelope
-        attn = envelope(attn);
+            // compute limiter attenuation
+            attn[n] = MAX(_threshold - peak[n], 0);
+
+            // apply envelope
+            attn[n] = envelope(attn[n]);
+        }
 
         // convert from log2 domain
-        attn = fixexp2(attn);
+        fixexp2Block(attn, attn, count);
 
-        // lowpass filter
-        attn = _filter.process(attn);
-        float gain = attn * _outGain;
+        for (int n = 0; n < count; n++) {
 
-        // delay audio
-        float x = input[n];
-        _delay.process(x);
+            // lowpass filter
+            gain[n] = _filter.process(attn[n]) * _outGain;
 
-        // apply gain
-        x *= gain;
+            // delay audio
+            float x = in[n];
+            _delay.process(x);
+            delayed[n] = x;
 
-        // apply dither
-        x += dither();
+            // compute dither
+            noise[n] = dither();
+        }
 
-        // store 16-bit output
-        output[n] = (int16_t)floatToInt(x);
+        // apply gain and dither, store 16-bit output
+        applyGainBlock(delayed, gain, noise, &output[i], count, 1);
     }
 }
 
@@ -261,41 +274,50 @@ public:
 template<int N>
 void LimiterStereo<N>::process(float* input, int16_t* output, int numFrames) {
 
-    for (int n = 0; n < numFrames; n++) {
+    int32_t peak[DYNAMICS_BLOCK];
+    int32_t attn[DYNAMICS_BLOCK];
+    float gain[DYNAMICS_BLOCK];
+    float noise[DYNAMICS_BLOCK];
+    float delayed[2*DYNAMICS_BLOCK];
+
+    for (int i = 0; i < numFrames; i += DYNAMICS_BLOCK) {
+
+        int count = MIN(numFrames - i, DYNAMICS_BLOCK);
+        float* in = &input[2*i];
 
         // peak detect and convert to log2 domain
-        int32_t peak = peaklog2(&input[2*n+0], &input[2*n+1]);
+        peaklog2Block(in, peak, count, 2);
+
+        for (int n = 0; n < count; n++) {
 
-        // compute limiter attenuation
-        int32_t attn = MAX(_threshold - peak, 0);
+            // compute limiter attenuation
+            attn[n] = MAX(_threshold - peak[n], 0);
 
-        // apply envelope
-        attn = envelope(attn);
+            // apply envelope
+            attn[n] = envelope(attn[n]);
+        }
 
         // convert from log2 domain
-        attn = fixexp2(attn);
+        fixexp2Block(attn, attn, count);
 
-        // lowpass filter
-        attn = _filter.process(attn);
-        float gain = attn * _outGain;
+        for (int n = 0; n < count; n++) {
 
-        // delay audio
-        float x0 = input[2*n+0];
-        float x1 = input[2*n+1];
-        _delay.process(x0, x1);
+            // lowpass filter
+            gain[n] = _filter.process(attn[n]) * _outGain;
 
-        // apply gain
-        x0 *= gain;
-        x1 *= gain;
+            // delay audio
+            float x0 = in[2*n+0];
+            float x1 = in[2*n+1];
+            _delay.process(x0, x1);
+            delayed[2*n+0] = x0;
+            delayed[2*n+1] = x1;
 
-        // apply dither
-        float d = dither();
-        x0 += d;
-        x1 += d;
+            // compute dither
+            noise[n] = dither();
+        }
 
-        // store 16-bit output
-        output[2*n+0] = (int16_t)floatToInt(x0);
-        output[2*n+1] = (int16_t)floatToInt(x1);
+        // apply gain and dither, store 16-bit output
+        applyGainBlock(delayed, gain, noise, &output[2*i], count, 2);
     }
 }
 
@@ -318,49 +340,54 @@ public:
 template<int N>
 void LimiterQuad<N>::process(float* input, int16_t* output, int numFrames) {
 
-    for (int n = 0; n < numFrames; n++) {
+    int32_t peak[DYNAMICS_BLOCK];
+    int32_t attn[DYNAMICS_BLOCK];
+    float gain[DYNAMICS_BLOCK];
+    float noise[DYNAMICS_BLOCK];
+    float delayed[4*DYNAMICS_BLOCK];
+
+    for (int i = 0; i < numFrames; i += DYNAMICS_BLOCK) {
+
+        int count = MIN(numFrames - i, DYNAMICS_BLOCK);
+        float* in = &input[4*i];
 
         // peak detect and convert to log2 domain
-        int32_t peak = peaklog2(&input[4*n+0], &input[4*n+1], &input[4*n+2], &input[4*n+3]);
+        peaklog2Block(in, peak, count, 4);
 
-        // compute limiter attenuation
-        int32_t attn = MAX(_threshold - peak, 0);
+        for (int n = 0; n < count; n++) {
 
-        // apply envelope
-        attn = envelope(attn);
+            // compute limiter attenuation
+            attn[n] = MAX(_threshold - peak[n], 0);
+
+            // apply envelope
+            attn[n] = envelope(attn[n]);
+        }
 
         // convert from log2 domain
-        attn = fixexp2(attn);
-
-        // lowpass filter
-        attn = _filter.process(attn);
-        float gain = attn * _outGain;
-
-        // delay audio
-        float x0 = input[4*n+0];
-        float x1 = input[4*n+1];
-        float x2 = input[4*n+2];
-        float x3 = input[4*n+3];
-        _delay.process(x0, x1, x2, x3);
-
-        // apply gain
-        x0 *= gain;
-        x1 *= gain;
-        x2 *= gain;
-        x3 *= gain;
-
-        // apply dither
-        float d = dither();
-        x0 += d;
-        x1 += d;
-        x2 += d;
-        x3 += d;
-
-        // store 16-bit output
-        output[4*n+0] = (int16_t)floatToInt(x0);
-        output[4*n+1] = (int16_t)floatToInt(x1);
-        output[4*n+2] = (int16_t)floatToInt(x2);
-        output[4*n+3] = (int16_t)floatToInt(x3);
+        fixexp2Block(attn, attn, count);
+
+        for (int n = 0; n < count; n++) {
+
+            // lowpass filter
+            gain[n] = _filter.process(attn[n]) * _outGain;
+
+            // delay audio
+            float x0 = in[4*n+0];
+            float x1 = in[4*n+1];
+            float x2 = in[4*n+2];
+            float x3 = in[4*n+3];
+            _delay.process(x0, x1, x2, x3);
+            delayed[4*n+0] = x0;
+            delayed[4*n+1] = x1;
+            delayed[4*n+2] = x2;
+            delayed[4*n+3] = x3;
+
+            // compute dither
+            noise[n] = dither();
+        }
+
+        // apply gain and dither, store 16-bit output
+        applyGainBlock(delayed, gain, noise, &output[4*i], count, 4);
     }
 }
 
@@ -0,0 +1,314 @@
+//
+//  AudioPlayout.cpp
+//  libraries/audio/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioPlayout.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+// voice pitch range
+static const int MIN_PITCH_HZ = 60;
+static const int MAX_PITCH_HZ = 400;
+
+// the pitch searches run on roughly 8kHz, then are refined around the best match
+static const int SEARCH_RATE = 8000;
+
+static const int PLC_SEARCH_MSECS = 5;
+static const int PLC_FADE_START_MSECS = 10;
+static const int PLC_FADE_END_MSECS = 60;
+static const int PLC_MAX_RECOVERY_MSECS = 10;
+
+static const float STRETCH_OVERLAP_MSECS = 2.5f;
+static const float STRETCH_MIN_SIMILARITY = 0.6f;
+
+// blocks quieter than this (rms, -50dBFS) are stretched wherever it fits, there is no waveform to match
+static const float STRETCH_QUIET_LEVEL = 0.003f * AudioConstants::MAX_SAMPLE_VALUE;
+
+static inline int msecsToFrames(int sampleRate, float msecs) {
+    return (int)(sampleRate * msecs / 1000.0f);
+}
+
+static inline int16_t crossfade(int16_t from, int16_t to, float weight) {
+    return (int16_t)((float)from + weight * (float)(to - from));
+}
+
+// normalized cross-correlation of two stretches of interleaved audio, summed over the channels,
+// looking at every step-th frame
+static float similarity(const int16_t* a, const int16_t* b, int numFrames, int numChannels, int step) {
+    float ab = 0.0f;
+    float aa = 0.0f;
+    float bb = 0.0f;
+    for (int i = 0; i < numFrames; i += step) {
+        for (int c = 0; c < numChannels; c++) {
+            float x = a[i * numChannels + c];
+            float y = b[i * numChannels + c];
+            ab += x * y;
+            aa += x * x;
+            bb += y * y;
+        }
+    }
+    const float EPSILON = 1.0f;
+    return ab / sqrtf(aa * bb + EPSILON);
+}
+
+// finds the lag in [minLag, maxLag] at which candidateAt(lag) best matches the target, coarsely first
+template <typename Candidate>
+static int findBestLag(const int16_t* target, int numFrames, int numChannels, int minLag, int maxLag, int step,
+                       Candidate candidateAt, float& bestSimilarity) {
+    int bestLag = minLag;
+    bestSimilarity = -1.0f;
+    for (int lag = minLag; lag <= maxLag; lag += step) {
+        float s = similarity(target, candidateAt(lag), numFrames, numChannels, step);
+        if (s > bestSimilarity) {
+            bestSimilarity = s;
+            bestLag = lag;
+        }
+    }
+
+    int coarseLag = bestLag;
+    bestSimilarity = -1.0f;
+    for (int lag = std::max(minLag, coarseLag - step + 1); lag <= std::min(maxLag, coarseLag + step - 1); lag++) {
+        float s = similarity(target, candidateAt(lag), numFrames, numChannels, 1);
+        if (s > bestSimilarity) {
+            bestSimilarity = s;
+            bestLag = lag;
+        }
+    }
+    return bestLag;
+}
+
+static bool isQuiet(const int16_t* samples, int numSamples) {
+    float energy = 0.0f;
+    for (int i = 0; i < numSamples; i++) {
+        energy += (float)samples[i] * (float)samples[i];
+    }
+    return energy < STRETCH_QUIET_LEVEL * STRETCH_QUIET_LEVEL * numSamples;
+}
+
+AudioPLC::AudioPLC(int sampleRate, int numChannels) {
+    setFormat(sampleRate, numChannels);
+}
+
+void AudioPLC::setFormat(int sampleRate, int numChannels) {
+    _sampleRate = sampleRate;
+    _numChannels = std::max(numChannels, 1);
+    _minPeriod = sampleRate / MAX_PITCH_HZ;
+    _maxPeriod = sampleRate / MIN_PITCH_HZ;
+    _searchFrames = msecsToFrames(sampleRate, PLC_SEARCH_MSECS);
+    _fadeStartFrames = msecsToFrames(sampleRate, PLC_FADE_START_MSECS);
+    _fadeEndFrames = msecsToFrames(sampleRate, PLC_FADE_END_MSECS);
+
+    // enough for the pitch search, and for a period plus its splice
+    _historyCapacity = _maxPeriod + std::max(_searchFrames, _maxPeriod / 4);
+    _history.assign(_historyCapacity * _numChannels, 0);
+    _period.reserve(_maxPeriod * _numChannels);
+    reset();
+}
+
+void AudioPLC::reset() {
+    _historyFrames = 0;
+    _periodFrames = 0;
+    _periodPosition = 0;
+    _concealedFrames = 0;
+}
+
+void AudioPLC::remember(const int16_t* samples, int numFrames) {
+    if (numFrames >= _historyCapacity) {
+        memcpy(_history.data(), samples + (numFrames - _historyCapacity) * _numChannels,
+               _historyCapacity * _numChannels * sizeof(int16_t));
+        _historyFrames = _historyCapacity;
+        return;
+    }
+    int framesKept = _historyCapacity - numFrames;
+    memmove(_history.data(), _history.data() + numFrames * _numChannels, framesKept * _numChannels * sizeof(int16_t));
+    memcpy(_history.data() + framesKept * _numChannels, samples, numFrames * _numChannels * sizeof(int16_t));
+    _historyFrames = std::min(_historyFrames + numFrames, _historyCapacity);
+}
+
+void AudioPLC::remember(AudioRingBuffer::ConstIterator samples, int numFrames) {
+    if (numFrames >= _historyCapacity) {
+        samples = samples + (numFrames - _historyCapacity) * _numChannels;
+        samples.readSamples(_history.data(), _historyCapacity * _numChannels);
+        _historyFrames = _historyCapacity;
+        return;
+    }
+    int framesKept = _historyCapacity - numFrames;
+    memmove(_history.data(), _history.data() + numFrames * _numChannels, framesKept * _numChannels * sizeof(int16_t));
+    samples.readSamples(_history.data() + framesKept * _numChannels, numFrames * _numChannels);
+    _historyFrames = std::min(_historyFrames + numFrames, _historyCapacity);
+}
+
+void AudioPLC::rememberSilence(int numFrames) {
+    numFrames = std::min(numFrames, _historyCapacity);
+    int framesKept = _historyCapacity - numFrames;
+    memmove(_history.data(), _history.data() + numFrames * _numChannels, framesKept * _numChannels * sizeof(int16_t));
+    memset(_history.data() + framesKept * _numChannels, 0, numFrames * _numChannels * sizeof(int16_t));
+    _historyFrames = std::min(_historyFrames + numFrames, _historyCapacity);
+
+    // there is nothing to cross-fade from after silence
+    _concealedFrames = 0;
+}
+
+bool AudioPLC::canConceal() const {
+    if (isConcealing()) {
+        return _concealedFrames < _fadeEndFrames;
+    }
+    return _historyFrames == _historyCapacity;
+}
+
+void AudioPLC::startConcealment() {
+    const int16_t* end = _history.data() + _historyCapacity * _numChannels;
+
+    // the pitch period is where the end of the history best matches what came before it
+    const int16_t* target = end - _searchFrames * _numChannels;
+    int step = std::max(_sampleRate / SEARCH_RATE, 1);
+    float periodSimilarity;
+    _periodFrames = findBestLag(target, _searchFrames, _numChannels, _minPeriod, _maxPeriod, step,
+                                [&](int lag) { return target - lag * _numChannels; }, periodSimilarity);
+    _periodPosition = 0;
+
+    // loop the last period, with its end blended into the audio that preceded its start
+    int overlap = std::max(_periodFrames / 4, 1);
+    _period.resize(_periodFrames * _numChannels);
+    const int16_t* periodStart = end - _periodFrames * _numChannels;
+    memcpy(_period.data(), periodStart, _periodFrames * _numChannels * sizeof(int16_t));
+    for (int i = 0; i < overlap; i++) {
+        float weight = (float)(i + 1) / (float)(overlap + 1);
+        int frame = _periodFrames - overlap + i;
+        for (int c = 0; c < _numChannels; c++) {
+            _period[frame * _numChannels + c] = crossfade(periodStart[frame * _numChannels + c],
+                                                          periodStart[(frame - _periodFrames) * _numChannels + c], weight);
+        }
+    }
+}
+
+float AudioPLC::getConcealmentGain() const {
+    if (_concealedFrames < _fadeStartFrames) {
+        return 1.0f;
+    } else if (_concealedFrames < _fadeEndFrames) {
+        return 1.0f - (float)(_concealedFrames - _fadeStartFrames) / (float)(_fadeEndFrames - _fadeStartFrames);
+    }
+    return 0.0f;
+}
+
+void AudioPLC::conceal(int16_t* output, int numFrames) {
+    if (!isConcealing()) {
+        if (!canConceal()) {
+            memset(output, 0, numFrames * _numChannels * sizeof(int16_t));
+            return;
+        }
+        startConcealment();
+    }
+
+    for (int i = 0; i < numFrames; i++) {
+        float gain = getConcealmentGain();
+        const int16_t* periodFrame = &_period[_periodPosition * _numChannels];
+        for (int c = 0; c < _numChannels; c++) {
+            output[i * _numChannels + c] = (int16_t)(periodFrame[c] * gain);
+        }
+        _periodPosition = (_periodPosition + 1) % _periodFrames;
+        _concealedFrames = std::min(_concealedFrames + 1, _fadeEndFrames);
+    }
+}
+
+void AudioPLC::recover(int16_t* samples, int numFrames) {
+    if (!isConcealing()) {
+        return;
+    }
+
+    // longer gaps get longer cross-fades
+    const int FRAMES_PER_EXTRA_MSEC = msecsToFrames(_sampleRate, 1);
+    int recoveryFrames = _periodFrames / 4 + (_concealedFrames / _fadeStartFrames) * 4 * FRAMES_PER_EXTRA_MSEC;
+    recoveryFrames = std::min(std::min(recoveryFrames, msecsToFrames(_sampleRate, PLC_MAX_RECOVERY_MSECS)), numFrames);
+
+    for (int i = 0; i < recoveryFrames; i++) {
+        float weight = (float)(i + 1) / (float)(recoveryFrames + 1);
+        float gain = getConcealmentGain();
+        const int16_t* periodFrame = &_period[_periodPosition * _numChannels];
+        for (int c = 0; c < _numChannels; c++) {
+            int16_t extension = (int16_t)(periodFrame[c] * gain);
+            samples[i * _numChannels + c] = crossfade(extension, samples[i * _numChannels + c], weight);
+        }
+        _periodPosition = (_periodPosition + 1) % _periodFrames;
+        _concealedFrames = std::min(_concealedFrames + 1, _fadeEndFrames);
+    }
+    _concealedFrames = 0;
+}
+
+AudioTimeStretch::AudioTimeStretch(int sampleRate, int numChannels) {
+    setFormat(sampleRate, numChannels);
+}
+
+void AudioTimeStretch::setFormat(int sampleRate, int numChannels) {
+    _sampleRate = sampleRate;
+    _numChannels = std::max(numChannels, 1);
+    _overlapFrames = msecsToFrames(sampleRate, STRETCH_OVERLAP_MSECS);
+    _minLag = std::max(sampleRate / MAX_PITCH_HZ, _overlapFrames);
+    _maxLag = sampleRate / MIN_PITCH_HZ;
+}
+
+int AudioTimeStretch::compress(const int16_t* input, int numFrames, int16_t* output) const {
+    // the removed stretch and the overlap after it must both lie in the block
+    int maxLag = std::min(_maxLag, numFrames - _overlapFrames);
+    float lagSimilarity = 0.0f;
+    int lag = 0;
+    if (maxLag >= _minLag) {
+        int step = std::max(_sampleRate / SEARCH_RATE, 1);
+        lag = findBestLag(input, _overlapFrames, _numChannels, _minLag, maxLag, step,
+                          [&](int lag) { return input + lag * _numChannels; }, lagSimilarity);
+    }
+    if (lag == 0 || (lagSimilarity < STRETCH_MIN_SIMILARITY && !isQuiet(input, numFrames * _numChannels))) {
+        memcpy(output, input, numFrames * _numChannels * sizeof(int16_t));
+        return numFrames;
+    }
+
+    // splice the start of the block into the waveform one lag later
+    for (int i = 0; i < _overlapFrames; i++) {
+        float weight = (float)(i + 1) / (float)(_overlapFrames + 1);
+        for (int c = 0; c < _numChannels; c++) {
+            output[i * _numChannels + c] = crossfade(input[i * _numChannels + c], input[(lag + i) * _numChannels + c], weight);
+        }
+    }
+    memcpy(output + _overlapFrames * _numChannels, input + (lag + _overlapFrames) * _numChannels,
+           (numFrames - lag - _overlapFrames) * _numChannels * sizeof(int16_t));
+    return numFrames - lag;
+}
+
+int AudioTimeStretch::expand(const int16_t* history, int historyFrames, const int16_t* input, int numFrames,
+                             int16_t* output) const {
+    // the repeated stretch comes from the history, and is spliced in over the start of the block
+    int maxLag = std::min(_maxLag, historyFrames);
+    float lagSimilarity = 0.0f;
+    int lag = 0;
+    if (numFrames >= _overlapFrames && maxLag >= _minLag) {
+        int step = std::max(_sampleRate / SEARCH_RATE, 1);
+        const int16_t* historyEnd = history + historyFrames * _numChannels;
+        lag = findBestLag(input, _overlapFrames, _numChannels, _minLag, maxLag, step,
+                          [&](int lag) { return historyEnd - lag * _numChannels; }, lagSimilarity);
+    }
+    if (lag == 0 || (lagSimilarity < STRETCH_MIN_SIMILARITY && !isQuiet(input, numFrames * _numChannels))) {
+        memcpy(output, input, numFrames * _numChannels * sizeof(int16_t));
+        return numFrames;
+    }
+
+    // replay the last lag of the history, entered with a cross-fade from the block, which then follows in full
+    const int16_t* repeated = history + (historyFrames - lag) * _numChannels;
+    for (int i = 0; i < _overlapFrames; i++) {
+        float weight = (float)(i + 1) / (float)(_overlapFrames + 1);
+        for (int c = 0; c < _numChannels; c++) {
+            output[i * _numChannels + c] = crossfade(input[i * _numChannels + c], repeated[i * _numChannels + c], weight);
+        }
+    }
+    memcpy(output + _overlapFrames * _numChannels, repeated + _overlapFrames * _numChannels,
+           (lag - _overlapFrames) * _numChannels * sizeof(int16_t));
+    memcpy(output + lag * _numChannels, input, numFrames * _numChannels * sizeof(int16_t));
+    return numFrames + lag;
+}
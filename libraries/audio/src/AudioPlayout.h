@@ -0,0 +1,105 @@
+//
+//  AudioPlayout.h
+//  libraries/audio/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioPlayout_h
+#define hifi_AudioPlayout_h
+
+#include <stdint.h>
+#include <vector>
+
+#include "AudioConstants.h"
+#include "AudioRingBuffer.h"
+
+//
+// Packet loss concealment by pitch-synchronous waveform extension, after ITU-T G.711 Appendix I.
+// The concealer remembers the audio that was played; when audio is missing it loops the last pitch period of it,
+// fading to silence over 60ms, and cross-fades back into the audio that arrives after the gap.
+// All audio is interleaved int16_t.
+//
+class AudioPLC {
+public:
+    AudioPLC(int sampleRate = AudioConstants::SAMPLE_RATE, int numChannels = AudioConstants::MONO);
+
+    // changing the format forgets the history
+    void setFormat(int sampleRate, int numChannels);
+    void reset();
+
+    int getNumChannels() const { return _numChannels; }
+
+    // remember audio that was played
+    void remember(const int16_t* samples, int numFrames);
+    void remember(AudioRingBuffer::ConstIterator samples, int numFrames);
+    void rememberSilence(int numFrames);
+
+    const int16_t* getHistory() const { return _history.data() + (_historyCapacity - _historyFrames) * _numChannels; }
+    int getHistoryFrames() const { return _historyFrames; }
+
+    // true while there is audio to extend and the extension has not faded out yet
+    bool canConceal() const;
+    bool isConcealing() const { return _concealedFrames > 0; }
+
+    // writes the extension of the remembered audio
+    void conceal(int16_t* output, int numFrames);
+
+    // cross-fades the first audio after a concealment from the extension, in place, and ends the concealment
+    void recover(int16_t* samples, int numFrames);
+
+private:
+    void startConcealment();
+    float getConcealmentGain() const;
+
+    int _sampleRate { AudioConstants::SAMPLE_RATE };
+    int _numChannels { AudioConstants::MONO };
+    int _minPeriod { 0 };
+    int _maxPeriod { 0 };
+    int _searchFrames { 0 };
+    int _fadeStartFrames { 0 };
+    int _fadeEndFrames { 0 };
+
+    std::vector<int16_t> _history;
+    int _historyCapacity { 0 };
+    int _historyFrames { 0 };
+
+    std::vector<int16_t> _period; // the last pitch period, made to loop seamlessly
+    int _periodFrames { 0 };
+    int _periodPosition { 0 };
+    int _concealedFrames { 0 };
+};
+
+//
+// Pitch-synchronous time-scale modification, to move a jitter buffer toward its target without dropping or inserting
+// whole frames.  A block is shortened or lengthened by a stretch of waveform that repeats, spliced with a short
+// cross-fade, so the pitch is unchanged.  All audio is interleaved int16_t.
+//
+class AudioTimeStretch {
+public:
+    AudioTimeStretch(int sampleRate = AudioConstants::SAMPLE_RATE, int numChannels = AudioConstants::MONO);
+
+    void setFormat(int sampleRate, int numChannels);
+
+    // the most frames expand() adds to a block
+    int getMaxStretchFrames() const { return _maxLag; }
+
+    // shortens the block, returns the frames written to output: numFrames when nothing could be removed
+    int compress(const int16_t* input, int numFrames, int16_t* output) const;
+
+    // lengthens the block by repeating the end of the history that precedes it,
+    // returns the frames written to output: numFrames when nothing could be added
+    int expand(const int16_t* history, int historyFrames, const int16_t* input, int numFrames, int16_t* output) const;
+
+private:
+    int _sampleRate { AudioConstants::SAMPLE_RATE };
+    int _numChannels { AudioConstants::MONO };
+    int _minLag { 0 };
+    int _maxLag { 0 };
+    int _overlapFrames { 0 };
+};
+
+#endif // hifi_AudioPlayout_h
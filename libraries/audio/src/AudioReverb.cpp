@@ -623,23 +623,80 @@ void PZShelf(double coef[3], double w0, double dbgain, int isHigh) {
     coef[2] = a1 * scale;
 }
 
+//
+// Two-lane float vector.
+// The reverb runs its left and right early paths, and each pair of late lines, side by side.
+// Lanes are computed with the same operations in the same order as a single path,
+// so the output is identical to processing each path on its own.
+//
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+
+#include <emmintrin.h>
+
+struct float2 {
+    __m128 v;
+};
+
+static inline float2 set2(float x0, float x1) { return { _mm_setr_ps(x0, x1, 0.0f, 0.0f) }; }
+static inline float2 gather2(const float* p0, const float* p1) { return { _mm_unpacklo_ps(_mm_load_ss(p0), _mm_load_ss(p1)) }; }
+static inline void store2(float* p, float2 a) { _mm_store_sd((double*)p, _mm_castps_pd(a.v)); }
+static inline float lane0(float2 a) { return _mm_cvtss_f32(a.v); }
+static inline float lane1(float2 a) { return _mm_cvtss_f32(_mm_shuffle_ps(a.v, a.v, _MM_SHUFFLE(1, 1, 1, 1))); }
+static inline float2 swap2(float2 a) { return { _mm_shuffle_ps(a.v, a.v, _MM_SHUFFLE(3, 2, 0, 1)) }; }
+
+static inline float2 operator+(float2 a, float2 b) { return { _mm_add_ps(a.v, b.v) }; }
+static inline float2 operator-(float2 a, float2 b) { return { _mm_sub_ps(a.v, b.v) }; }
+static inline float2 operator*(float2 a, float2 b) { return { _mm_mul_ps(a.v, b.v) }; }
+static inline float2 operator-(float2 a) { return { _mm_xor_ps(a.v, _mm_set1_ps(-0.0f)) }; }
+
+#else
+
+struct float2 {
+    float x0, x1;
+};
+
+static inline float2 set2(float x0, float x1) { return { x0, x1 }; }
+static inline float2 gather2(const float* p0, const float* p1) { return { *p0, *p1 }; }
+static inline void store2(float* p, float2 a) { p[0] = a.x0; p[1] = a.x1; }
+static inline float lane0(float2 a) { return a.x0; }
+static inline float lane1(float2 a) { return a.x1; }
+static inline float2 swap2(float2 a) { return { a.x1, a.x0 }; }
+
+static inline float2 operator+(float2 a, float2 b) { return { a.x0 + b.x0, a.x1 + b.x1 }; }
+static inline float2 operator-(float2 a, float2 b) { return { a.x0 - b.x0, a.x1 - b.x1 }; }
+static inline float2 operator*(float2 a, float2 b) { return { a.x0 * b.x0, a.x1 * b.x1 }; }
+static inline float2 operator-(float2 a) { return { -a.x0, -a.x1 }; }
+
+#endif
+
+static inline float2 splat2(float x) { return set2(x, x); }
+static inline float2 operator*(float a, float2 b) { return splat2(a) * b; }
+
+static inline void setLane(float2& a, int k, float x) {
+    a = (k == 0) ? set2(x, lane1(a)) : set2(lane0(a), x);
+}
+
+//
+// The components below each process two independent lanes.
+// Delays and gains are set per lane, coefficients are shared.
+// Buffers are interleaved, so both lanes are written with a single store.
+//
+
 class BandwidthEQ {
 
-    float _buffer[4] {};
+    float2 _buffer[2] {};
 
-    float _output0 = 0.0f;
-    float _output1 = 0.0f;
+    float2 _output {};
 
-    float _dcL = 0.0f;
-    float _dcR = 0.0f;
+    float2 _dc {};
 
-    float _b0 = 1.0f;
-    float _b1 = 0.0f;
-    float _b2 = 0.0f;
-    float _a1 = 0.0f;
-    float _a2 = 0.0f;
+    float2 _b0 = splat2(1.0f);
+    float2 _b1 = splat2(0.0f);
+    float2 _b2 = splat2(0.0f);
+    float2 _a1 = splat2(0.0f);
+    float2 _a2 = splat2(0.0f);
 
-    float _alpha = 0.0f;
+    float2 _alpha = splat2(0.0f);
 
 public:
     void setFreq(float freq, float sampleRate) {
@@ -648,131 +705,126 @@ public:
         // lowpass filter, -3dB @ freq
         double coef[5];
         BQFilter(coef, TWOPI * freq / sampleRate, 0);
-        _b0 = (float)coef[0];
-        _b1 = (float)coef[1];
-        _b2 = (float)coef[2];
-        _a1 = (float)coef[3];
-        _a2 = (float)coef[4];
+        _b0 = splat2((float)coef[0]);
+        _b1 = splat2((float)coef[1]);
+        _b2 = splat2((float)coef[2]);
+        _a1 = splat2((float)coef[3]);
+        _a2 = splat2((float)coef[4]);
 
         // DC-blocking filter, -3dB @ 10Hz
-        _alpha = 1.0f - expf(-TWOPI * 10.0f / sampleRate);
+        _alpha = splat2(1.0f - expf(-TWOPI * 10.0f / sampleRate));
     }
 
-    void process(float input0, float input1, float& output0, float& output1) {
-        output0 = _output0;
-        output1 = _output1;
+    void process(float2 input, float2& output) {
+        output = _output;
 
         // prevent denormalized zero-input limit cycles in the reverb
-        input0 += 1.0e-20f;
-        input1 += 1.0e-20f;
+        input = input + splat2(1.0e-20f);
 
         // remove DC
-        input0 -= _dcL;
-        input1 -= _dcR;
+        input = input - _dc;
 
-        _dcL += _alpha * input0;
-        _dcR += _alpha * input1;
+        _dc = _dc + _alpha * input;
 
         // transposed Direct Form II
-        _output0   = _b0 * input0 + _buffer[0];
-        _buffer[0] = _b1 * input0 - _a1 * _output0 + _buffer[1];
-        _buffer[1] = _b2 * input0 - _a2 * _output0;
-
-        _output1   = _b0 * input1 + _buffer[2];
-        _buffer[2] = _b1 * input1 - _a1 * _output1 + _buffer[3];
-        _buffer[3] = _b2 * input1 - _a2 * _output1;
+        _output    = _b0 * input + _buffer[0];
+        _buffer[0] = _b1 * input - _a1 * _output + _buffer[1];
+        _buffer[1] = _b2 * input - _a2 * _output;
     }
 
     void reset() {
-        memset(_buffer, 0, sizeof(_buffer));
-        _output0 = 0.0f;
-        _output1 = 0.0f;
-        _dcL = 0.0f;
-        _dcR = 0.0f;
+        _buffer[0] = splat2(0.0f);
+        _buffer[1] = splat2(0.0f);
+        _output = splat2(0.0f);
+        _dc = splat2(0.0f);
     }
 };
 
 template<int N>
 class DelayLine {
 
-    float _buffer[N] {};
+    float _buffer[N][2] {};
 
-    float _output = 0.0f;
+    float2 _output {};
 
     int _index = 0;
-    int _delay = N;
+    int _delay[2] = { N, N };
 
 public:
-    void setDelay(int d) {
+    void setDelay(int k, int d) {
         d = MIN(MAX(d, 1), N);
 
-        _delay = d;
+        _delay[k] = d;
     }
 
-    void process(float input, float& output) {
+    void process(float2 input, float2& output) {
         output = _output;
 
-        int k = (_index - _delay) & (N - 1);
+        int k0 = (_index - _delay[0]) & (N - 1);
+        int k1 = (_index - _delay[1]) & (N - 1);
 
-        _output = _buffer[k];
+        _output = gather2(&_buffer[k0][0], &_buffer[k1][1]);
 
-        _buffer[_index] = input;
+        store2(_buffer[_index], input);
         _index = (_index + 1) & (N - 1);
     }
 
     void reset() {
         memset(_buffer, 0, sizeof(_buffer));
-        _output = 0.0f;
+        _output = splat2(0.0f);
     }
 };
 
 template<int N>
 class Allpass {
 
-    float _buffer[N] {};
+    float _buffer[N][2] {};
 
-    float _output = 0.0f;
-    float _coef = 0.5f;
+    float2 _output {};
+    float2 _coef = splat2(0.5f);
 
     int _index0 = 0;
-    int _index1 = 0;
-    int _delay = N;
+    int _index1[2] = { 0, 0 };
+    int _delay[2] = { N, N };
 
 public:
-    void setDelay(int d) {   
+    void setDelay(int k, int d) {
         d = MIN(MAX(d, 1), N);
 
-        _index1 = (_index0 - d) & (N - 1);
-        _delay = d; 
+        _index1[k] = (_index0 - d) & (N - 1);
+        _delay[k] = d;
     }
 
-    int getDelay() {
-        return _delay;
+    int getDelay(int k) {
+        return _delay[k];
     }
 
     void setCoef(float coef) {
         coef = MIN(MAX(coef, -1.0f), 1.0f);
 
-        _coef = coef;
+        _coef = splat2(coef);
     }
 
-    void process(float input, float& output) {
+    void process(float2 input, float2& output) {
         output = _output;
 
-        _output = _buffer[_index1] - _coef * input; // feedforward path
-        _buffer[_index0] = input + _coef * _output; // feedback path
+        float2 x = gather2(&_buffer[_index1[0]][0], &_buffer[_index1[1]][1]);
+
+        _output = x - _coef * input;                        // feedforward path
+        store2(_buffer[_index0], input + _coef * _output);  // feedback path
 
         _index0 = (_index0 + 1) & (N - 1);
-        _index1 = (_index1 + 1) & (N - 1);
+        _index1[0] = (_index1[0] + 1) & (N - 1);
+        _index1[1] = (_index1[1] + 1) & (N - 1);
     }
 
-    void getOutput(float& output) {
+    void getOutput(float2& output) {
         output = _output;
     }
 
     void reset() {
         memset(_buffer, 0, sizeof(_buffer));
-        _output = 0.0f;
+        _output = splat2(0.0f);
     }
 };
 
@@ -862,79 +914,75 @@ public:
 template<int N>
 class AllPassMod {
 
-    float _buffer[N] {};
+    float _buffer[N][2] {};
 
-    float _output = 0.0f;
-    float _coef = 0.5f;
+    float2 _output {};
+    float2 _coef = splat2(0.5f);
 
     int _index = 0;
-    int _delay = N;
+    int _delay[2] = { N, N };
 
 public:
-    void setDelay(int d) {   
+    void setDelay(int k, int d) {
         d = MIN(MAX(d, 1), N);
 
-        _delay = d; 
+        _delay[k] = d;
     }
 
-    int getDelay() {
-        return _delay;
+    int getDelay(int k) {
+        return _delay[k];
     }
 
     void setCoef(float coef) {
         coef = MIN(MAX(coef, -1.0f), 1.0f);
 
-        _coef = coef;
+        _coef = splat2(coef);
     }
 
-    void process(float input, int32_t mod, float& output) {
+    void process(float2 input, int32_t mod0, int32_t mod1, float2& output) {
         output = _output;
 
         // add modulation to delay
-        int32_t offset = _delay + (mod >> MOD_FRACBITS);
-        float frac = (mod & MOD_FRACMASK) * QMOD_TO_FLOAT;
+        int32_t offset0 = _delay[0] + (mod0 >> MOD_FRACBITS);
+        int32_t offset1 = _delay[1] + (mod1 >> MOD_FRACBITS);
+        float2 frac = set2((mod0 & MOD_FRACMASK) * QMOD_TO_FLOAT, (mod1 & MOD_FRACMASK) * QMOD_TO_FLOAT);
 
         // 3rd-order Lagrange interpolation
-        int k0 = (_index - (offset-1)) & (N - 1);
-        int k1 = (_index - (offset+0)) & (N - 1);
-        int k2 = (_index - (offset+1)) & (N - 1);
-        int k3 = (_index - (offset+2)) & (N - 1);
-
-        float x0 = _buffer[k0];
-        float x1 = _buffer[k1];
-        float x2 = _buffer[k2];
-        float x3 = _buffer[k3];
+        float2 x0 = gather2(&_buffer[(_index - (offset0-1)) & (N - 1)][0], &_buffer[(_index - (offset1-1)) & (N - 1)][1]);
+        float2 x1 = gather2(&_buffer[(_index - (offset0+0)) & (N - 1)][0], &_buffer[(_index - (offset1+0)) & (N - 1)][1]);
+        float2 x2 = gather2(&_buffer[(_index - (offset0+1)) & (N - 1)][0], &_buffer[(_index - (offset1+1)) & (N - 1)][1]);
+        float2 x3 = gather2(&_buffer[(_index - (offset0+2)) & (N - 1)][0], &_buffer[(_index - (offset1+2)) & (N - 1)][1]);
 
         // compute the polynomial coefficients
-        float c0 = (1/6.0f) * (x3 - x0) + (1/2.0f) * (x1 - x2);
-        float c1 = (1/2.0f) * (x0 + x2) - x1;
-        float c2 = x2 - (1/3.0f) * x0 - (1/2.0f) * x1 - (1/6.0f) * x3;
-        float c3 = x1;
+        float2 c0 = (1/6.0f) * (x3 - x0) + (1/2.0f) * (x1 - x2);
+        float2 c1 = (1/2.0f) * (x0 + x2) - x1;
+        float2 c2 = x2 - (1/3.0f) * x0 - (1/2.0f) * x1 - (1/6.0f) * x3;
+        float2 c3 = x1;
 
         // compute the polynomial
-        float delayMod = ((c0 * frac + c1) * frac + c2) * frac + c3;
+        float2 delayMod = ((c0 * frac + c1) * frac + c2) * frac + c3;
 
-        _output = delayMod - _coef * input;         // feedforward path
-        _buffer[_index] = input + _coef * _output;  // feedback path
+        _output = delayMod - _coef * input;                 // feedforward path
+        store2(_buffer[_index], input + _coef * _output);   // feedback path
 
         _index = (_index + 1) & (N - 1);
     }
 
     void reset() {
         memset(_buffer, 0, sizeof(_buffer));
-        _output = 0.0f;
+        _output = splat2(0.0f);
     }
 };
 
 class LowpassEQ {
 
-    float _buffer[2] {};
+    float2 _buffer[2] {};
 
-    float _output = 0.0f;
+    float2 _output {};
 
-    float _b0 = 1.0f;
-    float _b1 = 0.0f;
-    float _b2 = 0.0f;
+    float2 _b0 = splat2(1.0f);
+    float2 _b1 = splat2(0.0f);
+    float2 _b2 = splat2(0.0f);
 
 public:
     void setFreq(float sampleRate) {
@@ -942,12 +990,13 @@ public:
 
         // two-zero lowpass filter, with zeros at approximately 12khz
         // zero radius is adjusted to match the response from 0..9khz
-        _b0 = 0.5f;
-        _b1 = 0.5f * sqrtf(2.0f * 12000.0f/(0.5f * sampleRate) - 1.0f);
-        _b2 = 0.5f - _b1;
+        float b1 = 0.5f * sqrtf(2.0f * 12000.0f/(0.5f * sampleRate) - 1.0f);
+        _b0 = splat2(0.5f);
+        _b1 = splat2(b1);
+        _b2 = splat2(0.5f - b1);
     }
 
-    void process(float input, float& output) {
+    void process(float2 input, float2& output) {
         output = _output;
 
         _output = _b0 * input + _b1 * _buffer[0] + _b2 * _buffer[1];
@@ -956,22 +1005,23 @@ public:
     }
 
     void reset() {
-        memset(_buffer, 0, sizeof(_buffer));
-        _output = 0.0f;
+        _buffer[0] = splat2(0.0f);
+        _buffer[1] = splat2(0.0f);
+        _output = splat2(0.0f);
     }
 };
 
 class DampingEQ {
 
-    float _buffer[2] {};
+    float2 _buffer[2] {};
 
-    float _output = 0.0f;
+    float2 _output {};
 
-    float _b0 = 1.0f;
-    float _b1 = 0.0f;
-    float _b2 = 0.0f;
-    float _a1 = 0.0f;
-    float _a2 = 0.0f;
+    float2 _b0 = splat2(1.0f);
+    float2 _b1 = splat2(0.0f);
+    float2 _b2 = splat2(0.0f);
+    float2 _a1 = splat2(0.0f);
+    float2 _a2 = splat2(0.0f);
 
 public:
     void setCoef(float dBgain0, float dBgain1, float freq0, float freq1, float sampleRate) {
@@ -985,14 +1035,14 @@ public:
         PZShelf(coefHi, TWOPI * freq1 / sampleRate, dBgain1, 1);    // high shelf
 
         // convolve into a single biquad
-        _b0 = (float)(coefLo[0] * coefHi[0]);
-        _b1 = (float)(coefLo[0] * coefHi[1] + coefLo[1] * coefHi[0]);
-        _b2 = (float)(coefLo[1] * coefHi[1]);
-        _a1 = (float)(coefLo[2] + coefHi[2]);
-        _a2 = (float)(coefLo[2] * coefHi[2]);
+        _b0 = splat2((float)(coefLo[0] * coefHi[0]));
+        _b1 = splat2((float)(coefLo[0] * coefHi[1] + coefLo[1] * coefHi[0]));
+        _b2 = splat2((float)(coefLo[1] * coefHi[1]));
+        _a1 = splat2((float)(coefLo[2] + coefHi[2]));
+        _a2 = splat2((float)(coefLo[2] * coefHi[2]));
     }
 
-    void process(float input, float& output) {
+    void process(float2 input, float2& output) {
         output = _output;
 
         // transposed Direct Form II
@@ -1002,134 +1052,140 @@ public:
     }
 
     void reset() {
-        memset(_buffer, 0, sizeof(_buffer));
-        _output = 0.0f;
+        _buffer[0] = splat2(0.0f);
+        _buffer[1] = splat2(0.0f);
+        _output = splat2(0.0f);
     }
 };
 
 template<int N>
 class MultiTap2 {
 
-    float _buffer[N] {};
+    float _buffer[N][2] {};
 
-    float _output0 = 0.0f;
-    float _output1 = 0.0f;
+    float2 _output0 {};
+    float2 _output1 {};
 
-    float _gain0 = 1.0f;
-    float _gain1 = 1.0f;
+    float2 _gain0 = splat2(1.0f);
+    float2 _gain1 = splat2(1.0f);
 
     int _index = 0;
-    int _delay0 = N;
-    int _delay1 = N;
+    int _delay0[2] = { N, N };
+    int _delay1[2] = { N, N };
 
 public:
-    void setDelay(int d0, int d1) {
+    void setDelay(int k, int d0, int d1) {
         d0 = MIN(MAX(d0, 1), N);
         d1 = MIN(MAX(d1, 1), N);
 
-        _delay0 = d0;
-        _delay1 = d1;
+        _delay0[k] = d0;
+        _delay1[k] = d1;
     }
 
-    int getDelay(int k) {
-        switch (k) {
-            case 0: return _delay0;
-            case 1: return _delay1;
+    int getDelay(int k, int tap) {
+        switch (tap) {
+            case 0: return _delay0[k];
+            case 1: return _delay1[k];
             default: return 0;
         }
     }
 
-    void setGain(float g0, float g1) {
-        _gain0 = g0;
-        _gain1 = g1;
+    void setGain(int k, float g0, float g1) {
+        setLane(_gain0, k, g0);
+        setLane(_gain1, k, g1);
     }
 
-    void process(float input, float& output0, float& output1) {
+    void process(float2 input, float2& output0, float2& output1) {
         output0 = _output0;
         output1 = _output1;
 
-        int k0 = (_index - _delay0) & (N - 1);
-        int k1 = (_index - _delay1) & (N - 1);
+        int k0 = (_index - _delay0[0]) & (N - 1);
+        int k1 = (_index - _delay1[0]) & (N - 1);
+        int j0 = (_index - _delay0[1]) & (N - 1);
+        int j1 = (_index - _delay1[1]) & (N - 1);
 
-        _output0 = _gain0 * _buffer[k0];
-        _output1 = _gain1 * _buffer[k1];
+        _output0 = _gain0 * gather2(&_buffer[k0][0], &_buffer[j0][1]);
+        _output1 = _gain1 * gather2(&_buffer[k1][0], &_buffer[j1][1]);
 
-        _buffer[_index] = input;
+        store2(_buffer[_index], input);
         _index = (_index + 1) & (N - 1);
     }
 
     void reset() {
         memset(_buffer, 0, sizeof(_buffer));
-        _output0 = 0.0f;
-        _output1 = 0.0f;
+        _output0 = splat2(0.0f);
+        _output1 = splat2(0.0f);
     }
 };
 
 template<int N>
 class MultiTap3 {
 
-    float _buffer[N] {};
+    float _buffer[N][2] {};
 
-    float _output0 = 0.0f;
-    float _output1 = 0.0f;
-    float _output2 = 0.0f;
+    float2 _output0 {};
+    float2 _output1 {};
+    float2 _output2 {};
 
-    float _gain0 = 1.0f;
-    float _gain1 = 1.0f;
-    float _gain2 = 1.0f;
+    float2 _gain0 = splat2(1.0f);
+    float2 _gain1 = splat2(1.0f);
+    float2 _gain2 = splat2(1.0f);
 
     int _index = 0;
-    int _delay0 = N;
-    int _delay1 = N;
-    int _delay2 = N;
+    int _delay0[2] = { N, N };
+    int _delay1[2] = { N, N };
+    int _delay2[2] = { N, N };
 
 public:
-    void setDelay(int d0, int d2) {
+    void setDelay(int k, int d0, int d2) {
         d0 = MIN(MAX(d0, 1), N);
         d2 = MIN(MAX(d2, 1), N);
 
-        _delay0 = d0;
-        _delay1 = d0 - 1;
-        _delay2 = d2;
+        _delay0[k] = d0;
+        _delay1[k] = d0 - 1;
+        _delay2[k] = d2;
     }
 
-    int getDelay(int k) {
-        switch (k) {
-            case 0: return _delay0;
-            case 1: return _delay1;
-            case 2: return _delay2;
+    int getDelay(int k, int tap) {
+        switch (tap) {
+            case 0: return _delay0[k];
+            case 1: return _delay1[k];
+            case 2: return _delay2[k];
             default: return 0;
         }
     }
 
-    void setGain(float g0, float g1, float g2) {
-        _gain0 = g0;
-        _gain1 = g1;
-        _gain2 = g2;
+    void setGain(int k, float g0, float g1, float g2) {
+        setLane(_gain0, k, g0);
+        setLane(_gain1, k, g1);
+        setLane(_gain2, k, g2);
     }
 
-    void process(float input, float& output0, float& output1, float& output2) {
+    void process(float2 input, float2& output0, float2& output1, float2& output2) {
         output0 = _output0;
         output1 = _output1;
         output2 = _output2;
 
-        int k0 = (_index - _delay0) & (N - 1);
-        int k1 = (_index - _delay1) & (N - 1);
-        int k2 = (_index - _delay2) & (N - 1);
+        int k0 = (_index - _delay0[0]) & (N - 1);
+        int k1 = (_index - _delay1[0]) & (N - 1);
+        int k2 = (_index - _delay2[0]) & (N - 1);
+        int j0 = (_index - _delay0[1]) & (N - 1);
+        int j1 = (_index - _delay1[1]) & (N - 1);
+        int j2 = (_index - _delay2[1]) & (N - 1);
 
-        _output0 = _gain0 * _buffer[k0];
-        _output1 = _gain1 * _buffer[k1];
-        _output2 = _gain2 * _buffer[k2];
+        _output0 = _gain0 * gather2(&_buffer[k0][0], &_buffer[j0][1]);
+        _output1 = _gain1 * gather2(&_buffer[k1][0], &_buffer[j1][1]);
+        _output2 = _gain2 * gather2(&_buffer[k2][0], &_buffer[j2][1]);
 
-        _buffer[_index] = input;
+        store2(_buffer[_index], input);
         _index = (_index + 1) & (N - 1);
     }
 
     void reset() {
         memset(_buffer, 0, sizeof(_buffer));
-        _output0 = 0.0f;
-        _output1 = 0.0f;
-        _output2 = 0.0f;
+        _output0 = splat2(0.0f);
+        _output1 = splat2(0.0f);
+        _output2 = splat2(0.0f);
     }
 };
 
@@ -1141,67 +1197,40 @@ class ReverbImpl {
     // Preprocess
     BandwidthEQ _bw;
     DelayLine<NEXTPOW2(M_PD0)> _dl0;
-    DelayLine<NEXTPOW2(M_PD0)> _dl1;
 
-    // Early Left
-    float _earlyMix1L = 0.0f;
-    float _earlyMix2L = 0.0f;
+    // Early, left in lane 0 and right in lane 1
+    float2 _earlyMix1 {};
+    float2 _earlyMix2 {};
 
-    MultiTap3<NEXTPOW2(M_MT0)> _mt0;
-    Allpass<NEXTPOW2(M_AP0)> _ap0;
-    MultiTap3<NEXTPOW2(M_MT1_MAX)> _mt1;
-    Allpass<NEXTPOW2(M_AP1)> _ap1;
-    Allpass<NEXTPOW2(M_AP2)> _ap2;
-    MultiTap2<NEXTPOW2(M_MT2)> _mt2;
+    MultiTap3<NEXTPOW2(MAX(M_MT0, M_MT3))> _mt0;            // mt0, mt3
+    Allpass<NEXTPOW2(MAX(M_AP0, M_AP3))> _ap0;              // ap0, ap3
+    MultiTap3<NEXTPOW2(MAX(M_MT1_MAX, M_MT4_MAX))> _mt1;    // mt1, mt4
+    Allpass<NEXTPOW2(MAX(M_AP1, M_AP4))> _ap1;              // ap1, ap4
+    Allpass<NEXTPOW2(MAX(M_AP2, M_AP5))> _ap2;              // ap2, ap5
+    MultiTap2<NEXTPOW2(MAX(M_MT2, M_MT5))> _mt2;            // mt2, mt5
 
-    // Early Right
-    float _earlyMix1R = 0.0f;
-    float _earlyMix2R = 0.0f;
+    RandomLFO _lfo;
 
-    MultiTap3<NEXTPOW2(M_MT3)> _mt3;
-    Allpass<NEXTPOW2(M_AP3)> _ap3;
-    MultiTap3<NEXTPOW2(M_MT4_MAX)> _mt4;
-    Allpass<NEXTPOW2(M_AP4)> _ap4;
-    Allpass<NEXTPOW2(M_AP5)> _ap5;
-    MultiTap2<NEXTPOW2(M_MT5)> _mt5;
+    // Late, lines 0 and 1
+    Allpass<NEXTPOW2(MAX(M_AP6, M_AP8))> _ap6;              // ap6, ap8
+    AllPassMod<NEXTPOW2(MAX(M_AP7_MAX, M_AP9_MAX))> _ap7;   // ap7, ap9
+    DampingEQ _eq0;                                         // eq0, eq1
+    MultiTap2<NEXTPOW2(MAX(M_MT6_MAX, M_MT7_MAX))> _mt6;    // mt6, mt7
 
-    RandomLFO _lfo;
+    // Late, lines 2 and 3
+    Allpass<NEXTPOW2(MAX(M_AP10, M_AP14))> _ap10;           // ap10, ap14
+    Allpass<NEXTPOW2(MAX(M_AP11, M_AP15))> _ap11;           // ap11, ap15
+    Allpass<NEXTPOW2(MAX(M_AP12, M_AP16))> _ap12;           // ap12, ap16
+    Allpass<NEXTPOW2(MAX(M_AP13, M_AP17))> _ap13;           // ap13, ap17
+    MultiTap2<NEXTPOW2(MAX(M_MT8_MAX, M_MT9_MAX))> _mt8;    // mt8, mt9
+    LowpassEQ _lp0;                                         // lp0, lp1
 
-    // Late
-    Allpass<NEXTPOW2(M_AP6)> _ap6;
-    AllPassMod<NEXTPOW2(M_AP7_MAX)> _ap7;
-    DampingEQ _eq0;
-    MultiTap2<NEXTPOW2(M_MT6_MAX)> _mt6;
-
-    Allpass<NEXTPOW2(M_AP8)> _ap8;
-    AllPassMod<NEXTPOW2(M_AP9_MAX)> _ap9;
-    DampingEQ _eq1;
-    MultiTap2<NEXTPOW2(M_MT7_MAX)> _mt7;
-
-    Allpass<NEXTPOW2(M_AP10)> _ap10;
-    Allpass<NEXTPOW2(M_AP11)> _ap11;
-    Allpass<NEXTPOW2(M_AP12)> _ap12;
-    Allpass<NEXTPOW2(M_AP13)> _ap13;
-    MultiTap2<NEXTPOW2(M_MT8_MAX)> _mt8;
-    LowpassEQ _lp0;
-
-    Allpass<NEXTPOW2(M_AP14)> _ap14;
-    Allpass<NEXTPOW2(M_AP15)> _ap15;
-    Allpass<NEXTPOW2(M_AP16)> _ap16;
-    Allpass<NEXTPOW2(M_AP17)> _ap17;
-    MultiTap2<NEXTPOW2(M_MT9_MAX)> _mt9;
-    LowpassEQ _lp1;
-
-    // Output Left
-    Allpass<NEXTPOW2(M_AP18)> _ap18;
-    Allpass<NEXTPOW2(M_AP19)> _ap19;
-
-    // Output Right
-    Allpass<NEXTPOW2(M_AP20)> _ap20;
-    Allpass<NEXTPOW2(M_AP21)> _ap21;
-
-    float _earlyGain = 0.0f;
-    float _wetDryMix = 0.0f;
+    // Output, left in lane 0 and right in lane 1
+    Allpass<NEXTPOW2(MAX(M_AP18, M_AP20))> _ap18;           // ap18, ap20
+    Allpass<NEXTPOW2(MAX(M_AP19, M_AP21))> _ap19;           // ap19, ap21
+
+    float2 _earlyGain {};
+    float2 _wetDryMix {};
 
 public:
     void setParameters(ReverbParameters *p);
@@ -1410,8 +1439,8 @@ void ReverbImpl::setParameters(ReverbParameters *p) {
     //
     int preDelay = (int)(p->preDelay * (1/1000.0f) * sampleRate + 0.5f);
     preDelay = MIN(MAX(preDelay, 1), M_PD0);
-    _dl0.setDelay(preDelay);
-    _dl1.setDelay(preDelay);
+    _dl0.setDelay(0, preDelay);
+    _dl0.setDelay(1, preDelay);
 
     // RoomSize scalefactor
     float roomSize = interpolateTable(roomSizeTable, p->roomSize);
@@ -1427,66 +1456,66 @@ void ReverbImpl::setParameters(ReverbParameters *p) {
     density3 = MIN(MAX(density3, 0.0f), 1.0f);
 
     // Early delays
-    _ap0.setDelay(scaleDelay(M_AP0 * 1.0f, sampleRate));
-    _ap1.setDelay(scaleDelay(M_AP1 * 1.0f, sampleRate));
-    _ap2.setDelay(scaleDelay(M_AP2 * 1.0f, sampleRate));
-    _ap3.setDelay(scaleDelay(M_AP3 * 1.0f, sampleRate));
-    _ap4.setDelay(scaleDelay(M_AP4 * 1.0f, sampleRate));
-    _ap5.setDelay(scaleDelay(M_AP5 * 1.0f, sampleRate));
-
-    _mt0.setDelay(scaleDelay(M_MT0 * roomSize, sampleRate), 1);
-    _mt1.setDelay(scaleDelay(M_MT1 * roomSize, sampleRate), scaleDelay(M_MT1_2 * 1.0f, sampleRate));
-    _mt2.setDelay(scaleDelay(M_MT2 * roomSize, sampleRate), 1);
-    _mt3.setDelay(scaleDelay(M_MT3 * roomSize, sampleRate), 1);
-    _mt4.setDelay(scaleDelay(M_MT4 * roomSize, sampleRate), scaleDelay(M_MT4_2 * 1.0f, sampleRate));
-    _mt5.setDelay(scaleDelay(M_MT5 * roomSize, sampleRate), 1);
+    _ap0.setDelay(0, scaleDelay(M_AP0 * 1.0f, sampleRate));
+    _ap1.setDelay(0, scaleDelay(M_AP1 * 1.0f, sampleRate));
+    _ap2.setDelay(0, scaleDelay(M_AP2 * 1.0f, sampleRate));
+    _ap0.setDelay(1, scaleDelay(M_AP3 * 1.0f, sampleRate));
+    _ap1.setDelay(1, scaleDelay(M_AP4 * 1.0f, sampleRate));
+    _ap2.setDelay(1, scaleDelay(M_AP5 * 1.0f, sampleRate));
+
+    _mt0.setDelay(0, scaleDelay(M_MT0 * roomSize, sampleRate), 1);
+    _mt1.setDelay(0, scaleDelay(M_MT1 * roomSize, sampleRate), scaleDelay(M_MT1_2 * 1.0f, sampleRate));
+    _mt2.setDelay(0, scaleDelay(M_MT2 * roomSize, sampleRate), 1);
+    _mt0.setDelay(1, scaleDelay(M_MT3 * roomSize, sampleRate), 1);
+    _mt1.setDelay(1, scaleDelay(M_MT4 * roomSize, sampleRate), scaleDelay(M_MT4_2 * 1.0f, sampleRate));
+    _mt2.setDelay(1, scaleDelay(M_MT5 * roomSize, sampleRate), 1);
 
     // Late delays
-    _ap6.setDelay(scaleDelay(M_AP6 * roomSize * density3, sampleRate));
-    _ap7.setDelay(scaleDelay(M_AP7 * roomSize, sampleRate));
-    _ap8.setDelay(scaleDelay(M_AP8 * roomSize * density3, sampleRate));
-    _ap9.setDelay(scaleDelay(M_AP9 * roomSize, sampleRate));
-    _ap10.setDelay(scaleDelay(M_AP10 * roomSize * density1, sampleRate));
-    _ap11.setDelay(scaleDelay(M_AP11 * roomSize * density2, sampleRate));
-    _ap12.setDelay(scaleDelay(M_AP12 * roomSize, sampleRate));
-    _ap13.setDelay(scaleDelay(M_AP13 * roomSize * density3, sampleRate));
-    _ap14.setDelay(scaleDelay(M_AP14 * roomSize * density1, sampleRate));
-    _ap15.setDelay(scaleDelay(M_AP15 * roomSize * density2, sampleRate));
-    _ap16.setDelay(scaleDelay(M_AP16 * roomSize * density3, sampleRate));
-    _ap17.setDelay(scaleDelay(M_AP17 * roomSize * density3, sampleRate));
+    _ap6.setDelay(0, scaleDelay(M_AP6 * roomSize * density3, sampleRate));
+    _ap7.setDelay(0, scaleDelay(M_AP7 * roomSize, sampleRate));
+    _ap6.setDelay(1, scaleDelay(M_AP8 * roomSize * density3, sampleRate));
+    _ap7.setDelay(1, scaleDelay(M_AP9 * roomSize, sampleRate));
+    _ap10.setDelay(0, scaleDelay(M_AP10 * roomSize * density1, sampleRate));
+    _ap11.setDelay(0, scaleDelay(M_AP11 * roomSize * density2, sampleRate));
+    _ap12.setDelay(0, scaleDelay(M_AP12 * roomSize, sampleRate));
+    _ap13.setDelay(0, scaleDelay(M_AP13 * roomSize * density3, sampleRate));
+    _ap10.setDelay(1, scaleDelay(M_AP14 * roomSize * density1, sampleRate));
+    _ap11.setDelay(1, scaleDelay(M_AP15 * roomSize * density2, sampleRate));
+    _ap12.setDelay(1, scaleDelay(M_AP16 * roomSize * density3, sampleRate));
+    _ap13.setDelay(1, scaleDelay(M_AP17 * roomSize * density3, sampleRate));
 
     int lateDelay = scaleDelay(p->lateDelay * (1/1000.0f) * 48000, sampleRate);
     lateDelay = MIN(MAX(lateDelay, 1), M_LD0);
 
-    _mt6.setDelay(scaleDelay(M_MT6 * roomSize * density3, sampleRate), lateDelay);
-    _mt7.setDelay(scaleDelay(M_MT7 * roomSize * density2, sampleRate), lateDelay);
-    _mt8.setDelay(scaleDelay(M_MT8 * roomSize * density0, sampleRate), lateDelay);
-    _mt9.setDelay(scaleDelay(M_MT9 * roomSize, sampleRate), lateDelay);
+    _mt6.setDelay(0, scaleDelay(M_MT6 * roomSize * density3, sampleRate), lateDelay);
+    _mt6.setDelay(1, scaleDelay(M_MT7 * roomSize * density2, sampleRate), lateDelay);
+    _mt8.setDelay(0, scaleDelay(M_MT8 * roomSize * density0, sampleRate), lateDelay);
+    _mt8.setDelay(1, scaleDelay(M_MT9 * roomSize, sampleRate), lateDelay);
 
     // Output delays
-    _ap18.setDelay(scaleDelay(M_AP18 * 1.0f, sampleRate));
-    _ap19.setDelay(scaleDelay(M_AP19 * 1.0f, sampleRate));
-    _ap20.setDelay(scaleDelay(M_AP20 * 1.0f, sampleRate));
-    _ap21.setDelay(scaleDelay(M_AP21 * 1.0f, sampleRate));
+    _ap18.setDelay(0, scaleDelay(M_AP18 * 1.0f, sampleRate));
+    _ap19.setDelay(0, scaleDelay(M_AP19 * 1.0f, sampleRate));
+    _ap18.setDelay(1, scaleDelay(M_AP20 * 1.0f, sampleRate));
+    _ap19.setDelay(1, scaleDelay(M_AP21 * 1.0f, sampleRate));
 
     // RT60 is determined by mean delay of feedback paths
     int loopDelay;
-    loopDelay = _ap6.getDelay();
-    loopDelay += _ap7.getDelay();
-    loopDelay += _ap8.getDelay();
-    loopDelay += _ap9.getDelay();
-    loopDelay += _ap10.getDelay();
-    loopDelay += _ap11.getDelay();
-    loopDelay += _ap12.getDelay();
-    loopDelay += _ap13.getDelay();
-    loopDelay += _ap14.getDelay();
-    loopDelay += _ap15.getDelay();
-    loopDelay += _ap16.getDelay();
-    loopDelay += _ap17.getDelay();
-    loopDelay += _mt6.getDelay(0);
-    loopDelay += _mt7.getDelay(0);
-    loopDelay += _mt8.getDelay(0);
-    loopDelay += _mt9.getDelay(0);
+    loopDelay = _ap6.getDelay(0);
+    loopDelay += _ap7.getDelay(0);
+    loopDelay += _ap6.getDelay(1);
+    loopDelay += _ap7.getDelay(1);
+    loopDelay += _ap10.getDelay(0);
+    loopDelay += _ap11.getDelay(0);
+    loopDelay += _ap12.getDelay(0);
+    loopDelay += _ap13.getDelay(0);
+    loopDelay += _ap10.getDelay(1);
+    loopDelay += _ap11.getDelay(1);
+    loopDelay += _ap12.getDelay(1);
+    loopDelay += _ap13.getDelay(1);
+    loopDelay += _mt6.getDelay(0, 0);
+    loopDelay += _mt6.getDelay(1, 0);
+    loopDelay += _mt8.getDelay(0, 0);
+    loopDelay += _mt8.getDelay(1, 0);
     loopDelay /= 2;
 
     //
@@ -1503,165 +1532,120 @@ void ReverbImpl::setParameters(ReverbParameters *p) {
 
     // Damping
     _eq0.setCoef(bassGain, p->highGain, p->bassFreq, p->highFreq, sampleRate);
-    _eq1.setCoef(bassGain, p->highGain, p->bassFreq, p->highFreq, sampleRate);
     _lp0.setFreq(sampleRate);
-    _lp1.setFreq(sampleRate);
 
     float earlyDiffusionCoef = interpolateTable(diffusionCoefTable, p->earlyDiffusion);
 
-    // Early Left
-    _earlyMix1L = interpolateTable(earlyMix1Table, p->earlyMixRight);
-    _earlyMix2L = interpolateTable(earlyMix2Table, p->earlyMixLeft);
-
-    _mt0.setGain(0.2f, 0.4f, interpolateTable(earlyMix0Table, p->earlyMixLeft));
-
     _ap0.setCoef(earlyDiffusionCoef);
     _ap1.setCoef(earlyDiffusionCoef);
     _ap2.setCoef(earlyDiffusionCoef);
 
-    _mt1.setGain(0.2f, 0.6f, interpolateTable(lateMix0Table, p->lateMixLeft) * 0.125f);
+    _earlyMix1 = set2(interpolateTable(earlyMix1Table, p->earlyMixRight),   // left
+                      interpolateTable(earlyMix1Table, p->earlyMixLeft));   // right
+    _earlyMix2 = set2(interpolateTable(earlyMix2Table, p->earlyMixLeft),    // left
+                      interpolateTable(earlyMix2Table, p->earlyMixRight));  // right
 
-    _mt2.setGain(interpolateTable(lateMix1Table, p->lateMixLeft) * loopGain2, 
-                 interpolateTable(lateMix2Table, p->lateMixLeft) * loopGain2);
+    // Early Left
+    _mt0.setGain(0, 0.2f, 0.4f, interpolateTable(earlyMix0Table, p->earlyMixLeft));
 
-    // Early Right
-    _earlyMix1R = interpolateTable(earlyMix1Table, p->earlyMixLeft);
-    _earlyMix2R = interpolateTable(earlyMix2Table, p->earlyMixRight);
+    _mt1.setGain(0, 0.2f, 0.6f, interpolateTable(lateMix0Table, p->lateMixLeft) * 0.125f);
 
-    _mt3.setGain(0.2f, 0.4f, interpolateTable(earlyMix0Table, p->earlyMixRight));
+    _mt2.setGain(0, interpolateTable(lateMix1Table, p->lateMixLeft) * loopGain2, 
+                    interpolateTable(lateMix2Table, p->lateMixLeft) * loopGain2);
 
-    _ap3.setCoef(earlyDiffusionCoef);
-    _ap4.setCoef(earlyDiffusionCoef);
-    _ap5.setCoef(earlyDiffusionCoef);
+    // Early Right
+    _mt0.setGain(1, 0.2f, 0.4f, interpolateTable(earlyMix0Table, p->earlyMixRight));
 
-    _mt4.setGain(0.2f, 0.6f, interpolateTable(lateMix0Table, p->lateMixRight) * 0.125f);
+    _mt1.setGain(1, 0.2f, 0.6f, interpolateTable(lateMix0Table, p->lateMixRight) * 0.125f);
 
-    _mt5.setGain(interpolateTable(lateMix1Table, p->lateMixRight) * loopGain2, 
-                 interpolateTable(lateMix2Table, p->lateMixRight) * loopGain2);
+    _mt2.setGain(1, interpolateTable(lateMix1Table, p->lateMixRight) * loopGain2, 
+                    interpolateTable(lateMix2Table, p->lateMixRight) * loopGain2);
 
-    _earlyGain = dBToGain(p->earlyGain);
+    _earlyGain = splat2(dBToGain(p->earlyGain));
 
     // Late
     float lateDiffusionCoef = interpolateTable(diffusionCoefTable, p->lateDiffusion);
     _ap6.setCoef(lateDiffusionCoef);
     _ap7.setCoef(lateDiffusionCoef);
-    _ap8.setCoef(lateDiffusionCoef);
-    _ap9.setCoef(lateDiffusionCoef);
 
     _ap10.setCoef(PHI);
     _ap11.setCoef(PHI);
     _ap12.setCoef(lateDiffusionCoef);
     _ap13.setCoef(lateDiffusionCoef);
 
-    _ap14.setCoef(PHI);
-    _ap15.setCoef(PHI);
-    _ap16.setCoef(lateDiffusionCoef);
-    _ap17.setCoef(lateDiffusionCoef);
-
     float lateGain = dBToGain(p->lateGain) * 2.0f;
-    _mt6.setGain(loopGain1, lateGain * interpolateTable(lateMix0Table, p->lateMixLeft));
-    _mt7.setGain(loopGain1, lateGain * interpolateTable(lateMix0Table, p->lateMixRight));
-    _mt8.setGain(loopGain1, lateGain * interpolateTable(lateMix2Table, p->lateMixLeft) * loopGain2 * 0.125f);
-    _mt9.setGain(loopGain1, lateGain * interpolateTable(lateMix2Table, p->lateMixRight) * loopGain2 * 0.125f);
+    _mt6.setGain(0, loopGain1, lateGain * interpolateTable(lateMix0Table, p->lateMixLeft));
+    _mt6.setGain(1, loopGain1, lateGain * interpolateTable(lateMix0Table, p->lateMixRight));
+    _mt8.setGain(0, loopGain1, lateGain * interpolateTable(lateMix2Table, p->lateMixLeft) * loopGain2 * 0.125f);
+    _mt8.setGain(1, loopGain1, lateGain * interpolateTable(lateMix2Table, p->lateMixRight) * loopGain2 * 0.125f);
 
     // Output
     float outputDiffusionCoef = lateDiffusionCoef * 0.6f;
     _ap18.setCoef(outputDiffusionCoef);
     _ap19.setCoef(outputDiffusionCoef);
-    _ap20.setCoef(outputDiffusionCoef);
-    _ap21.setCoef(outputDiffusionCoef);
 
-    _wetDryMix = p->wetDryMix * (1/100.0f);
-    _wetDryMix = MIN(MAX(_wetDryMix, 0.0f), 1.0f);
+    float wetDryMix = p->wetDryMix * (1/100.0f);
+    _wetDryMix = splat2(MIN(MAX(wetDryMix, 0.0f), 1.0f));
 }
 
 void ReverbImpl::process(float** inputs, float** outputs, int numFrames) {
 
     for (int i = 0; i < numFrames; i++) {
-        float x0, x1, y0, y1, y2, y3;
+        float2 x0, x1, y0, y1, y2;
 
         // Preprocess
-        x0 = inputs[0][i];
-        x1 = inputs[1][i];
-        _bw.process(x0, x1, x0, x1);
+        _bw.process(set2(inputs[0][i], inputs[1][i]), x0);
 
-        float preL, preR;
-        _dl0.process(x0, preL);
-        _dl1.process(x1, preR);
+        float2 pre;
+        _dl0.process(x0, pre);
 
-        // Early Left
-        float early0L, early1L, early2L, earlyOutL;
-        _mt0.process(preL, x0, x1, y0);
+        // Early, left and right
+        float2 early0, early1, early2, earlyOut;
+        _mt0.process(pre, x0, x1, y0);
         _ap0.process(x0 + x1, y1);
-        _mt1.process(y1, x0, x1, early0L);
+        _mt1.process(y1, x0, x1, early0);
         _ap1.process(x0 + x1, y2);
         _ap2.process(y2, x0);
-        _mt2.process(x0, early1L, early2L);
+        _mt2.process(x0, early1, early2);
 
-        earlyOutL = (y0 + y1 * _earlyMix1L + y2 * _earlyMix2L) * _earlyGain;
-
-        // Early Right
-        float early0R, early1R, early2R, earlyOutR;
-        _mt3.process(preR, x0, x1, y0);
-        _ap3.process(x0 + x1, y1);
-        _mt4.process(y1, x0, x1, early0R);
-        _ap4.process(x0 + x1, y2);
-        _ap5.process(y2, x0);
-        _mt5.process(x0, early1R, early2R);
-
-        earlyOutR = (y0 + y1 * _earlyMix1R + y2 * _earlyMix2R) * _earlyGain;
+        earlyOut = (y0 + y1 * _earlyMix1 + y2 * _earlyMix2) * _earlyGain;
 
         // LFO update
         int32_t lfoSin, lfoCos;
         _lfo.process(lfoSin, lfoCos);
 
-        // Late
-        float lateOut0;
+        // Late, lines 0 and 1
+        float2 lateOut01, y01;
         _ap6.getOutput(x0);
-        _ap7.process(x0, lfoSin, x0);
-        _eq0.process(-early0L + x0, x0);
-        _mt6.process(x0, y0, lateOut0);
+        _ap7.process(x0, lfoSin, lfoCos, x0);
+        _eq0.process(-early0 + x0, x0);
+        _mt6.process(x0, y01, lateOut01);
 
-        float lateOut1;
-        _ap8.getOutput(x0);
-        _ap9.process(x0, lfoCos, x0);
-        _eq1.process(-early0R + x0, x0);
-        _mt7.process(x0, y1, lateOut1);
-
-        float lateOut2;
+        // Late, lines 2 and 3
+        float2 lateOut23, y23;
         _ap10.getOutput(x0);
-        _ap11.process(-early2L + x0, x0);
+        _ap11.process(-early2 + x0, x0);
         _ap12.process(x0, x0);
-        _ap13.process(-early2L - x0, x0);
-        _mt8.process(-early0L + x0, x0, lateOut2);
-        _lp0.process(x0, y2);
-
-        float lateOut3;
-        _ap14.getOutput(x0);
-        _ap15.process(-early2R + x0, x0);
-        _ap16.process(x0, x0);
-        _ap17.process(-early2R - x0, x0);
-        _mt9.process(-early0R + x0, x0, lateOut3);
-        _lp1.process(x0, y3);
+        _ap13.process(-early2 - x0, x0);
+        _mt8.process(-early0 + x0, x0, lateOut23);
+        _lp0.process(x0, y23);
 
         // Feedback matrix
-        _ap6.process(early1L + y2 - y3, x0);
-        _ap8.process(early1R - y2 - y3, x0);
-        _ap10.process(-early2R + y0 + y1, x0);
-        _ap14.process(-early2L - y0 + y1, x0);
-
-        // Output Left
-        _ap18.process(-earlyOutL + lateOut0 + lateOut3, x0);
+        float y0L = lane0(y01);
+        float y1R = lane1(y01);
+        float y2L = lane0(y23);
+        float y3R = lane1(y23);
+        _ap6.process(early1 + set2(y2L, -y2L) - splat2(y3R), x0);
+        _ap10.process(-swap2(early2) + set2(y0L, -y0L) + splat2(y1R), x0);
+
+        // Output, left and right
+        _ap18.process(-earlyOut + lateOut01 + swap2(lateOut23), x0);
         _ap19.process(x0, y0);
 
-        // Output Right
-        _ap20.process(-earlyOutR + lateOut1 + lateOut2, x1);
-        _ap21.process(x1, y1);
-
-        x0 = inputs[0][i];
-        x1 = inputs[1][i];
-        outputs[0][i] = x0 + (y0 - x0) * _wetDryMix;
-        outputs[1][i] = x1 + (y1 - x1) * _wetDryMix;
+        x0 = set2(inputs[0][i], inputs[1][i]);
+        x0 = x0 + (y0 - x0) * _wetDryMix;
+        outputs[0][i] = lane0(x0);
+        outputs[1][i] = lane1(x0);
     }
 }
 
@@ -1671,47 +1655,28 @@ void ReverbImpl::reset() {
     _bw.reset();
 
     _dl0.reset();
-    _dl1.reset();
 
     _mt0.reset();
     _mt1.reset();
     _mt2.reset();
-    _mt3.reset();
-    _mt4.reset();
-    _mt5.reset();
     _mt6.reset();
-    _mt7.reset();
     _mt8.reset();
-    _mt9.reset();
 
     _ap0.reset();
     _ap1.reset();
     _ap2.reset();
-    _ap3.reset();
-    _ap4.reset();
-    _ap5.reset();
     _ap6.reset();
     _ap7.reset();
-    _ap8.reset();
-    _ap9.reset();
     _ap10.reset();
     _ap11.reset();
     _ap12.reset();
     _ap13.reset();
-    _ap14.reset();
-    _ap15.reset();
-    _ap16.reset();
-    _ap17.reset();
     _ap18.reset();
     _ap19.reset();
-    _ap20.reset();
-    _ap21.reset();
 
     _eq0.reset();
-    _eq1.reset();
 
     _lp0.reset();
-    _lp1.reset();
 }
 
 //
@@ -1797,7 +1762,7 @@ void AudioReverb::render(float** inputs, float** outputs, int numFrames) {
 #include <emmintrin.h>
 
 // convert int16_t to float, deinterleave stereo
-void AudioReverb::convertInput(const int16_t* input, float** outputs, int numFrames) {
+static void convertInput16_SSE(const int16_t* input, float** outputs, int numFrames) {
     __m128 scale = _mm_set1_ps(1/32768.0f);
 
     int i = 0;
@@ -1849,7 +1814,7 @@ static inline __m128 dither4() {
 }
 
 // convert float to int16_t with dither, interleave stereo
-void AudioReverb::convertOutput(float** inputs, int16_t* output, int numFrames) {
+static void convertOutput16_SSE(float** inputs, int16_t* output, int numFrames) {
     __m128 scale = _mm_set1_ps(32768.0f);
 
     int i = 0;
@@ -1892,7 +1857,7 @@ void AudioReverb::convertOutput(float** inputs, int16_t* output, int numFrames)
 }
 
 // deinterleave stereo
-void AudioReverb::convertInput(const float* input, float** outputs, int numFrames) {
+static void convertInputFloat_SSE(const float* input, float** outputs, int numFrames) {
 
     int i = 0;
     for (; i < numFrames - 3; i += 4) {
@@ -1911,7 +1876,7 @@ void AudioReverb::convertInput(const float* input, float** outputs, int numFrame
 }
 
 // interleave stereo
-void AudioReverb::convertOutput(float** inputs, float* output, int numFrames) {
+static void convertOutputFloat_SSE(float** inputs, float* output, int numFrames) {
 
     int i = 0;
     for(; i < numFrames - 3; i += 4) {
@@ -1929,6 +1894,33 @@ void AudioReverb::convertOutput(float** inputs, float* output, int numFrames) {
     }
 }
 
+#include "CPUDetect.h"
+
+void convertInput16_AVX2(const int16_t* input, float** outputs, int numFrames);
+void convertOutput16_AVX2(float** inputs, int16_t* output, int numFrames);
+void convertInputFloat_AVX2(const float* input, float** outputs, int numFrames);
+void convertOutputFloat_AVX2(float** inputs, float* output, int numFrames);
+
+void AudioReverb::convertInput(const int16_t* input, float** outputs, int numFrames) {
+    static auto f = cpuSupportsAVX2() ? convertInput16_AVX2 : convertInput16_SSE;
+    (*f)(input, outputs, numFrames); // dispatch
+}
+
+void AudioReverb::convertOutput(float** inputs, int16_t* output, int numFrames) {
+    static auto f = cpuSupportsAVX2() ? convertOutput16_AVX2 : convertOutput16_SSE;
+    (*f)(inputs, output, numFrames); // dispatch
+}
+
+void AudioReverb::convertInput(const float* input, float** outputs, int numFrames) {
+    static auto f = cpuSupportsAVX2() ? convertInputFloat_AVX2 : convertInputFloat_SSE;
+    (*f)(input, outputs, numFrames); // dispatch
+}
+
+void AudioReverb::convertOutput(float** inputs, float* output, int numFrames) {
+    static auto f = cpuSupportsAVX2() ? convertOutputFloat_AVX2 : convertOutputFloat_SSE;
+    (*f)(inputs, output, numFrames); // dispatch
+}
+
 #else
 
 // convert int16_t to float, deinterleave stereo
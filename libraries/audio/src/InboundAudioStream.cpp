@@ -60,7 +60,10 @@ InboundAudioStream::InboundAudioStream(int numChannels, int numFrames, int numBl
     _incomingSequenceNumberStats(STATS_FOR_STATS_PACKET_WINDOW_SECONDS),
     _starveHistory(STARVE_HISTORY_CAPACITY),
     _unplayedMs(0, UNPLAYED_MS_WINDOW_SECS),
-    _timeGapStatsForStatsPacket(0, STATS_FOR_STATS_PACKET_WINDOW_SECONDS) {}
+    _timeGapStatsForStatsPacket(0, STATS_FOR_STATS_PACKET_WINDOW_SECONDS),
+    _writeConcealment(AudioConstants::SAMPLE_RATE, numChannels),
+    _popConcealment(AudioConstants::SAMPLE_RATE, numChannels),
+    _timeStretch(AudioConstants::SAMPLE_RATE, numChannels) {}
 
 InboundAudioStream::~InboundAudioStream() {
     cleanupCodec();
@@ -72,6 +75,9 @@ void InboundAudioStream::reset() {
     _lastPopOutput = AudioRingBuffer::ConstIterator();
     _isStarved = true;
     _hasStarted = false;
+    _writeConcealment.reset();
+    _popConcealment.reset();
+    _averagePlayoutFrames = 0.0f;
     resetStats();
     // FIXME: calling cleanupCodec() seems to be the cause of the buzzsaw -- we get an assert
     // after this is called in AudioClient.  Ponder and fix...
@@ -95,12 +101,18 @@ void InboundAudioStream::resetStats() {
     _currentJitterBufferFrames = 0;
     _timeGapStatsForStatsPacket.reset();
     _unplayedMs.reset();
+    _samplesConcealed = 0;
+    _timeStretchCompressions = 0;
+    _timeStretchExpansions = 0;
 }
 
 void InboundAudioStream::clearBuffer() {
     _ringBuffer.clear();
     _framesAvailableStat.reset();
     _currentJitterBufferFrames = 0;
+    _writeConcealment.reset();
+    _popConcealment.reset();
+    _averagePlayoutFrames = 0.0f;
 }
 
 void InboundAudioStream::setReverb(float reverbTime, float wetLevel) {
@@ -175,7 +187,7 @@ int InboundAudioStream::parseData(ReceivedMessage& message) {
                     if (packetPCM) {
                         // If there are PCM packets in-flight after the codec is changed, use them.
                         auto afterProperties = message.readWithoutCopy(message.getBytesLeftToRead());
-                        _ringBuffer.writeData(afterProperties.data(), afterProperties.size());
+                        writePlayoutData(afterProperties.data(), afterProperties.size());
                     } else {
                         // Since the data in the stream is using a codec that we aren't prepared for,
                         // we need to let the codec know that we don't have data for it, this will
@@ -249,11 +261,14 @@ int InboundAudioStream::lostAudioData(int numPackets) {
     while (numPackets--) {
         if (_decoder) {
             _decoder->lostFrame(decodedBuffer);
+            writePlayoutData(decodedBuffer.data(), decodedBuffer.size());
+        } else if (_adaptivePlayoutEnabled) {
+            writeConcealedFrames(AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
         } else {
             decodedBuffer.resize(AudioConstants::NETWORK_FRAME_BYTES_STEREO);
             memset(decodedBuffer.data(), 0, decodedBuffer.size());
+            _ringBuffer.writeData(decodedBuffer.data(), decodedBuffer.size());
         }
-        _ringBuffer.writeData(decodedBuffer.data(), decodedBuffer.size());
     }
     return 0;
 }
@@ -266,7 +281,72 @@ int InboundAudioStream::parseAudioData(PacketType type, const QByteArray& packet
         decodedBuffer = packetAfterStreamProperties;
     }
     auto actualSize = decodedBuffer.size();
-    return _ringBuffer.writeData(decodedBuffer.data(), actualSize);
+    return writePlayoutData(decodedBuffer.data(), actualSize);
+}
+
+void InboundAudioStream::setPlayoutFormat(int sampleRate, int numChannels) {
+    _writeConcealment.setFormat(sampleRate, numChannels);
+    _popConcealment.setFormat(sampleRate, numChannels);
+    _timeStretch.setFormat(sampleRate, numChannels);
+    _averagePlayoutFrames = 0.0f;
+}
+
+int InboundAudioStream::writePlayoutData(const char* data, int numBytes) {
+    if (!_adaptivePlayoutEnabled) {
+        return _ringBuffer.writeData(data, numBytes);
+    }
+
+    int numChannels = _writeConcealment.getNumChannels();
+    int numFrames = numBytes / (numChannels * (int)sizeof(int16_t));
+    int numSamples = numFrames * numChannels;
+    _playoutBuffer.resize(numSamples);
+    memcpy(_playoutBuffer.data(), data, numSamples * sizeof(int16_t));
+
+    // the first audio after lost packets continues from their concealment
+    _writeConcealment.recover(_playoutBuffer.data(), numFrames);
+
+    const int16_t* output = _playoutBuffer.data();
+    int outputFrames = numFrames;
+    if (!_isStarved && numFrames > 0) {
+        // steer the smoothed buffer length toward the desired frames by at most a pitch period per packet,
+        // instead of dropping whole frames once it is far off
+        const float PLAYOUT_AVERAGE_WEIGHT = 1.0f / 8.0f;
+        float frameSamples = (float)_ringBuffer.getNumFrameSamples();
+        float playoutFrames = (_ringBuffer.samplesAvailable() + numSamples) / frameSamples;
+        _averagePlayoutFrames += PLAYOUT_AVERAGE_WEIGHT * (playoutFrames - _averagePlayoutFrames);
+
+        _stretchBuffer.resize(numSamples + _timeStretch.getMaxStretchFrames() * numChannels);
+        int maxPlayoutFrames = _desiredJitterBufferFrames + DESIRED_JITTER_BUFFER_FRAMES_PADDING + 1;
+        if (_averagePlayoutFrames > maxPlayoutFrames && playoutFrames > maxPlayoutFrames) {
+            outputFrames = _timeStretch.compress(output, numFrames, _stretchBuffer.data());
+        } else if (_averagePlayoutFrames < _desiredJitterBufferFrames) {
+            outputFrames = _timeStretch.expand(_writeConcealment.getHistory(), _writeConcealment.getHistoryFrames(),
+                                               output, numFrames, _stretchBuffer.data());
+        }
+
+        if (outputFrames != numFrames) {
+            if (outputFrames < numFrames) {
+                _timeStretchCompressions++;
+            } else {
+                _timeStretchExpansions++;
+            }
+            output = _stretchBuffer.data();
+            _averagePlayoutFrames += (outputFrames - numFrames) * numChannels / frameSamples;
+        }
+    }
+
+    _writeConcealment.remember(output, outputFrames);
+    return _ringBuffer.writeSamples(output, outputFrames * numChannels) * sizeof(int16_t);
+}
+
+int InboundAudioStream::writeConcealedFrames(int numFrames) {
+    int numSamples = numFrames * _writeConcealment.getNumChannels();
+    _playoutBuffer.resize(numSamples);
+    _writeConcealment.conceal(_playoutBuffer.data(), numFrames);
+    if (_writeConcealment.isConcealing()) {
+        _samplesConcealed += numSamples;
+    }
+    return _ringBuffer.writeSamples(_playoutBuffer.data(), numSamples);
 }
 
 int InboundAudioStream::writeDroppableSilentFrames(int silentFrames) {
@@ -316,6 +396,9 @@ int InboundAudioStream::writeDroppableSilentFrames(int silentFrames) {
     }
 
     int ret = _ringBuffer.addSilentSamples(silentSamples - numSilentFramesToDrop * samplesPerFrame);
+    if (_adaptivePlayoutEnabled) {
+        _writeConcealment.rememberSilence(ret / _writeConcealment.getNumChannels());
+    }
     
     return ret;
 }
@@ -327,6 +410,7 @@ int InboundAudioStream::popSamples(int maxSamples, bool allOrNothing) {
         // we're still refilling; don't pop
         _consecutiveNotMixedCount++;
         _lastPopSucceeded = false;
+        samplesPopped = popConcealedSamples(maxSamples);
     } else {
         if (samplesAvailable >= maxSamples) {
             // we have enough samples to pop, so we're good to pop
@@ -342,6 +426,7 @@ int InboundAudioStream::popSamples(int maxSamples, bool allOrNothing) {
             setToStarved();
             _consecutiveNotMixedCount++;
             _lastPopSucceeded = false;
+            samplesPopped = popConcealedSamples(maxSamples);
         }
     }
     return samplesPopped;
@@ -358,6 +443,19 @@ void InboundAudioStream::popSamplesNoCheck(int samples) {
     _unplayedMs.update(unplayedMs);
 
     _lastPopOutput = _ringBuffer.nextOutput();
+    if (_adaptivePlayoutEnabled) {
+        int numFrames = samples / _popConcealment.getNumChannels();
+        if (_popConcealment.isConcealing()) {
+            // cross-fade out of the concealment of the last starve, in a copy of the output
+            _concealedOutput.resize(samples);
+            _lastPopOutput.readSamples(_concealedOutput.data(), samples);
+            _popConcealment.recover(_concealedOutput.data(), numFrames);
+            _popConcealment.remember(_concealedOutput.data(), numFrames);
+            _lastPopOutput = AudioRingBuffer::ConstIterator(_concealedOutput.data(), samples, _concealedOutput.data());
+        } else {
+            _popConcealment.remember(_lastPopOutput, numFrames);
+        }
+    }
     _ringBuffer.shiftReadPosition(samples);
     framesAvailableChanged();
 
@@ -365,6 +463,21 @@ void InboundAudioStream::popSamplesNoCheck(int samples) {
     _lastPopSucceeded = true;
 }
 
+int InboundAudioStream::popConcealedSamples(int maxSamples) {
+    // only once the stream has played something, and until the concealment has faded out
+    if (!_adaptivePlayoutEnabled || !_hasStarted || !_popConcealment.canConceal()) {
+        return 0;
+    }
+
+    _concealedOutput.resize(maxSamples);
+    _popConcealment.conceal(_concealedOutput.data(), maxSamples / _popConcealment.getNumChannels());
+    _samplesConcealed += maxSamples;
+
+    _lastPopOutput = AudioRingBuffer::ConstIterator(_concealedOutput.data(), maxSamples, _concealedOutput.data());
+    _lastPopSucceeded = true;
+    return maxSamples;
+}
+
 void InboundAudioStream::framesAvailableChanged() {
     _framesAvailableStat.updateWithSample(_ringBuffer.framesAvailable());
 
@@ -433,6 +546,13 @@ void InboundAudioStream::setDynamicJitterBufferEnabled(bool enable) {
     _dynamicJitterBufferEnabled = enable;
 }
 
+void InboundAudioStream::setAdaptivePlayoutEnabled(bool enable) {
+    _adaptivePlayoutEnabled = enable;
+    _writeConcealment.reset();
+    _popConcealment.reset();
+    _averagePlayoutFrames = 0.0f;
+}
+
 void InboundAudioStream::setStaticJitterBufferFrames(int staticJitterBufferFrames) {
     _staticJitterBufferFrames = staticJitterBufferFrames;
     if (!_dynamicJitterBufferEnabled) {
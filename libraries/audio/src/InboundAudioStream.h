@@ -21,6 +21,7 @@
 
 #include <plugins/CodecPlugin.h>
 
+#include "AudioPlayout.h"
 #include "AudioRingBuffer.h"
 #include "MovingMinMaxAvg.h"
 #include "SequenceNumberStats.h"
@@ -71,6 +72,10 @@ public:
     void setDynamicJitterBufferEnabled(bool enable);
     void setStaticJitterBufferFrames(int staticJitterBufferFrames);
 
+    /// time-stretches toward the desired jitter buffer frames and conceals lost packets and starves
+    void setAdaptivePlayoutEnabled(bool enable);
+    bool adaptivePlayoutEnabled() const { return _adaptivePlayoutEnabled; }
+
     virtual AudioStreamStats getAudioStreamStats() const;
 
     /// returns the desired number of jitter buffer frames under the dyanmic jitter buffers scheme
@@ -93,6 +98,9 @@ public:
     int getStarveCount() const { return _starveCount; }
     int getSilentFramesDropped() const { return _silentFramesDropped; }
     int getOverflowCount() const { return _ringBuffer.getOverflowCount(); }
+    int getSamplesConcealed() const { return _samplesConcealed; }
+    int getTimeStretchCompressions() const { return _timeStretchCompressions; }
+    int getTimeStretchExpansions() const { return _timeStretchExpansions; }
 
     int getPacketsReceived() const { return _incomingSequenceNumberStats.getReceived(); }
     
@@ -118,6 +126,7 @@ private:
     void packetReceivedUpdateTimingStats();
 
     void popSamplesNoCheck(int samples);
+    int popConcealedSamples(int maxSamples);
     void framesAvailableChanged();
 
 protected:
@@ -139,6 +148,16 @@ protected:
 
     /// writes silent frames to the buffer that may be dropped to reduce latency caused by the buffer
     virtual int writeDroppableSilentFrames(int silentFrames);
+
+    /// the format of the audio written to the ring buffer, for the adaptive playout
+    void setPlayoutFormat(int sampleRate, int numChannels);
+
+    /// writes audio to the ring buffer, cross-faded out of any concealment and time-stretched toward the desired
+    /// jitter buffer frames when adaptive playout is enabled
+    int writePlayoutData(const char* data, int numBytes);
+
+    /// writes audio that continues what was written last in place of a lost packet, or silence when there is none
+    int writeConcealedFrames(int numFrames);
     
 protected:
 
@@ -189,6 +208,19 @@ protected:
     QString _selectedCodecName;
     Decoder* _decoder { nullptr };
     int _mismatchedAudioCodecCount { 0 };
+
+    bool _adaptivePlayoutEnabled { true };
+    AudioPLC _writeConcealment; // for packets lost on the way in
+    AudioPLC _popConcealment; // for starves on the way out
+    AudioTimeStretch _timeStretch;
+    float _averagePlayoutFrames { 0.0f };
+    std::vector<int16_t> _playoutBuffer;
+    std::vector<int16_t> _stretchBuffer;
+    std::vector<int16_t> _concealedOutput;
+
+    int _samplesConcealed { 0 };
+    int _timeStretchCompressions { 0 };
+    int _timeStretchExpansions { 0 };
 };
 
 float calculateRepeatedFrameFadeFactor(int indexOfRepeat);
@@ -25,7 +25,10 @@ InjectedAudioStream::InjectedAudioStream(const QUuid& streamIdentifier, bool isS
     PositionalAudioStream(PositionalAudioStream::Injector, isStereo, numStaticJitterFrames),
     _streamIdentifier(streamIdentifier),
     _radius(0.0f),
-    _attenuationRatio(0) {} 
+    _attenuationRatio(0) {
+    // injectors play out as sent, and go silent when they end
+    setAdaptivePlayoutEnabled(false);
+}
 
 int InjectedAudioStream::parseStreamProperties(PacketType type,
                                                const QByteArray& packetAfterSeqNum,
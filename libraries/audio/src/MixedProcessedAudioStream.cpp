@@ -22,6 +22,7 @@ void MixedProcessedAudioStream::outputFormatChanged(int sampleRate, int channelC
     int deviceOutputFrameFrames = networkToDeviceFrames(AudioConstants::NETWORK_FRAME_SAMPLES_STEREO / AudioConstants::STEREO);
     int deviceOutputFrameSamples = deviceOutputFrameFrames * AudioConstants::STEREO;
     _ringBuffer.resizeForFrameSize(deviceOutputFrameSamples);
+    setPlayoutFormat(sampleRate, channelCount);
 }
 
 int MixedProcessedAudioStream::writeDroppableSilentFrames(int silentFrames) {
@@ -45,9 +46,15 @@ int MixedProcessedAudioStream::lostAudioData(int numPackets) {
 
         emit addedStereoSamples(decodedBuffer);
 
+        if (!_decoder && _adaptivePlayoutEnabled) {
+            // without a codec to interpolate, continue the processed audio in the device format
+            writeConcealedFrames(_ringBuffer.getNumFrameSamples() / (int)_outputChannelCount);
+            continue;
+        }
+
         emit processSamples(decodedBuffer, outputBuffer);
 
-        _ringBuffer.writeData(outputBuffer.data(), outputBuffer.size());
+        writePlayoutData(outputBuffer.data(), outputBuffer.size());
         qCDebug(audiostream, "Wrote %d samples to buffer (%d available)", outputBuffer.size() / (int)sizeof(int16_t), getSamplesAvailable());
     }
     return 0;
@@ -66,7 +73,7 @@ int MixedProcessedAudioStream::parseAudioData(PacketType type, const QByteArray&
     QByteArray outputBuffer;
     emit processSamples(decodedBuffer, outputBuffer);
 
-    _ringBuffer.writeData(outputBuffer.data(), outputBuffer.size());
+    writePlayoutData(outputBuffer.data(), outputBuffer.size());
     qCDebug(audiostream, "Wrote %d samples to buffer (%d available)", outputBuffer.size() / (int)sizeof(int16_t), getSamplesAvailable());
 
     return packetAfterStreamProperties.size();
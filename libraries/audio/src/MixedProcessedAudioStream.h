@@ -42,8 +42,8 @@ private:
     int deviceToNetworkFrames(int deviceFrames);
 
 private:
-    quint64 _outputSampleRate;
-    quint64 _outputChannelCount;
+    quint64 _outputSampleRate { AudioConstants::SAMPLE_RATE };
+    quint64 _outputChannelCount { AudioConstants::STEREO };
 };
 
 #endif // hifi_MixedProcessedAudioStream_h
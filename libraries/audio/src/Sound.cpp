@@ -34,6 +34,12 @@
 #include "flump3dec.h"
 
 int audioDataPointerMetaTypeID = qRegisterMetaType<AudioDataPointer>("AudioDataPointer");
+int streamingAudioDataPointerMetaTypeID = qRegisterMetaType<StreamingAudioDataPointer>("StreamingAudioDataPointer");
+
+// MP3s that would take more than this once decoded are streamed instead, about 90 seconds of mono audio.
+// WAV and RAW sounds are always decoded up front: they are already 16 bit PCM, and streaming would keep their data at
+// the source rate, which for the usual 44.1 or 48kHz files is twice the size of the 24kHz decoded copy.
+static const uint32_t MIN_STREAMING_DECODED_BYTES = 4 * 1024 * 1024;
 
 using AudioConstants::AudioSample;
 
@@ -78,6 +84,7 @@ void Sound::downloadFinished(const QByteArray& data) {
     // this is a QRunnable, will delete itself after it has finished running
     auto soundProcessor = new SoundProcessor(_self, data);
     connect(soundProcessor, &SoundProcessor::onSuccess, this, &Sound::soundProcessSuccess);
+    connect(soundProcessor, &SoundProcessor::onStreaming, this, &Sound::soundProcessStreaming);
     connect(soundProcessor, &SoundProcessor::onError, this, &Sound::soundProcessError);
     QThreadPool::globalInstance()->start(soundProcessor);
 }
@@ -91,6 +98,27 @@ void Sound::soundProcessSuccess(AudioDataPointer audioData) {
     emit ready();
 }
 
+void Sound::soundProcessStreaming(StreamingAudioDataPointer streamingData) {
+    qCDebug(audio) << "Setting ready state for streaming sound file" << _url.fileName();
+
+    _streamingData = std::move(streamingData);
+    finishedLoading(true);
+
+    emit ready();
+}
+
+bool Sound::isStereo() const {
+    return _audioData ? _audioData->isStereo() : (_streamingData ? _streamingData->isStereo() : false);
+}
+
+bool Sound::isAmbisonic() const {
+    return _audioData ? _audioData->isAmbisonic() : (_streamingData ? _streamingData->isAmbisonic() : false);
+}
+
+float Sound::getDuration() const {
+    return _audioData ? _audioData->getDuration() : (_streamingData ? _streamingData->getDuration() : 0.0f);
+}
+
 void Sound::soundProcessError(int error, QString str) {
     qCCritical(audio) << "Failed to process sound file: code =" << error << str;
     emit failed(QNetworkReply::UnknownContentError);
@@ -129,6 +157,21 @@ void SoundProcessor::run() {
         properties = interpretAsWav(_data, outputAudioByteArray);
     } else if (fileName.endsWith(MP3_EXTENSION)) {
         fileType = "MP3";
+
+        // long sounds keep their compressed data and are decoded while they play, short ones are decoded
+        // right away by the same stream, which already parsed the headers and resamples as it decodes
+        auto streamingData = StreamingAudioData::createFromMP3(_data);
+        if (streamingData && streamingData->getNumBytes() >= MIN_STREAMING_DECODED_BYTES) {
+            emit onStreaming(streamingData);
+            return;
+        } else if (streamingData) {
+            auto data = streamingData->decodeAll();
+            int numSamples = data.size() / AudioConstants::SAMPLE_SIZE;
+            auto audioData = AudioData::make(numSamples, streamingData->getNumChannels(),
+                                             (const AudioSample*)data.constData());
+            emit onSuccess(audioData);
+            return;
+        }
         properties = interpretAsMP3(_data, outputAudioByteArray);
     } else if (fileName.endsWith(STEREO_RAW_EXTENSION)) {
         // check if this was a stereo raw file
@@ -20,11 +20,13 @@
 #include <ResourceCache.h>
 
 #include "AudioConstants.h"
+#include "StreamingAudioData.h"
 
 class AudioData;
 using AudioDataPointer = std::shared_ptr<const AudioData>;
 
 Q_DECLARE_METATYPE(AudioDataPointer);
+Q_DECLARE_METATYPE(StreamingAudioDataPointer);
 
 // AudioData is designed to be immutable
 // All of its members and methods are const
@@ -62,13 +64,16 @@ class Sound : public Resource {
 public:
     Sound(const QUrl& url, bool isStereo = false, bool isAmbisonic = false);
     
-    bool isReady() const { return (bool)_audioData; }
+    bool isReady() const { return _audioData || _streamingData; }
 
-    bool isStereo() const { return _audioData ? _audioData->isStereo() : false; }
-    bool isAmbisonic() const { return _audioData ? _audioData->isAmbisonic() : false; }
-    float getDuration() const { return _audioData ? _audioData->getDuration() : 0.0f; }
+    bool isStereo() const;
+    bool isAmbisonic() const;
+    float getDuration() const;
 
+    // Long compressed sounds are streamed, they have streaming data instead of audio data
     AudioDataPointer getAudioData() const { return _audioData; }
+    StreamingAudioDataPointer getStreamingData() const { return _streamingData; }
+    bool isStreaming() const { return (bool)_streamingData; }
 
     int getNumChannels() const { return _numChannels; }
 
@@ -77,12 +82,14 @@ signals:
 
 protected slots:
     void soundProcessSuccess(AudioDataPointer audioData);
+    void soundProcessStreaming(StreamingAudioDataPointer streamingData);
     void soundProcessError(int error, QString str);
     
 private:
     virtual void downloadFinished(const QByteArray& data) override;
 
     AudioDataPointer _audioData;
+    StreamingAudioDataPointer _streamingData;
 
      // Only used for caching until the download has finished
     int _numChannels { 0 };
@@ -110,6 +117,7 @@ public:
 
 signals:
     void onSuccess(AudioDataPointer audioData);
+    void onStreaming(StreamingAudioDataPointer streamingData);
     void onError(int error, QString str);
 
 private:
@@ -0,0 +1,460 @@
+//
+//  StreamingAudioData.cpp
+//  libraries/audio/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "StreamingAudioData.h"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+
+#include <QtCore/QRunnable>
+#include <QtCore/QThreadPool>
+
+#include "AudioLogging.h"
+#include "AudioSRC.h"
+
+#include "flump3dec.h"
+
+using AudioConstants::AudioSample;
+
+// blocks are cut from the source, at 44.1kHz this decodes about a third of a second at a time
+static const uint32_t BLOCK_SOURCE_FRAMES = 16384;
+static const size_t MAX_CACHED_BLOCKS = 16;
+
+// frames decoded before a seek target to refill the MP3 bit reservoir
+static const uint64_t SEEK_PREROLL_FRAMES = 2 * 1152;
+
+static const int MP3_SAMPLES_MAX = 1152;
+static const int MP3_CHANNELS_MAX = 2;
+
+// Incremental MP3 decoding, one frame at a time
+class MP3StreamDecoder {
+public:
+    MP3StreamDecoder(const QByteArray& data);
+    ~MP3StreamDecoder();
+
+    bool isValid() const { return _decoder != nullptr; }
+
+    // Decodes or skips the next MP3 frame, returns its number of sample frames, 0 at the end of the stream.
+    // samples must hold MP3_SAMPLES_MAX frames of the stream's channel count.
+    int nextFrame(AudioSample* samples, bool skip);
+
+    uint64_t getPosition() const { return _position; }
+    uint32_t getNumChannels() const { return _numChannels; }
+    uint32_t getSampleRate() const { return _sampleRate; }
+
+private:
+    const QByteArray _data;
+    flump3dec::Bit_stream_struc* _bitstream { nullptr };
+    flump3dec::mp3tl* _decoder { nullptr };
+    flump3dec::Mp3TlRetcode _result { flump3dec::MP3TL_ERR_OK };
+    int _frameCount { 0 };
+    uint64_t _position { 0 };
+    uint32_t _numChannels { 0 };
+    uint32_t _sampleRate { 0 };
+    AudioSample _frameBuffer[MP3_SAMPLES_MAX * MP3_CHANNELS_MAX];
+};
+
+MP3StreamDecoder::MP3StreamDecoder(const QByteArray& data) : _data(data) {
+    using namespace flump3dec;
+
+    _bitstream = bs_new();
+    if (!_bitstream) {
+        return;
+    }
+    _decoder = mp3tl_new(_bitstream, MP3TL_MODE_16BIT);
+    if (!_decoder) {
+        return;
+    }
+
+    bs_set_data(_bitstream, (const uint8_t*)_data.constData(), _data.size());
+
+    // skip ID3 tag, if present
+    _result = mp3tl_skip_id3(_decoder);
+}
+
+MP3StreamDecoder::~MP3StreamDecoder() {
+    if (_decoder) {
+        flump3dec::mp3tl_free(_decoder);
+    }
+    if (_bitstream) {
+        flump3dec::bs_free(_bitstream);
+    }
+}
+
+int MP3StreamDecoder::nextFrame(AudioSample* samples, bool skip) {
+    using namespace flump3dec;
+
+    if (!_decoder) {
+        return 0;
+    }
+
+    while (!(_result == MP3TL_ERR_NO_SYNC || _result == MP3TL_ERR_NEED_DATA)) {
+
+        mp3tl_sync(_decoder);
+
+        // find MP3 header
+        const fr_header* header = nullptr;
+        _result = mp3tl_decode_header(_decoder, &header);
+        if (_result != MP3TL_ERR_OK) {
+            continue;
+        }
+
+        if (_frameCount++ == 0) {
+            _sampleRate = header->sample_rate;
+            _numChannels = header->channels;
+
+            // skip Xing header, if present
+            _result = mp3tl_skip_xing(_decoder, header);
+            if (_result != MP3TL_ERR_OK) {
+                continue;
+            }
+        }
+
+        int numFrames = header->frame_samples;
+        bool sameChannels = header->channels == _numChannels;
+        if (skip) {
+            _result = mp3tl_skip_frame(_decoder);
+        } else {
+            _result = mp3tl_decode_frame(_decoder, (uint8_t*)_frameBuffer, sizeof(_frameBuffer));
+        }
+
+        if (_result == MP3TL_ERR_OK || _result == MP3TL_ERR_BAD_FRAME) {
+            if (!skip) {
+                // fill bad frames with silence, as well as frames that would change the channel layout mid stream
+                int numSamples = numFrames * _numChannels;
+                if (_result == MP3TL_ERR_BAD_FRAME || !sameChannels) {
+                    memset(samples, 0, numSamples * sizeof(AudioSample));
+                } else {
+                    memcpy(samples, _frameBuffer, numSamples * sizeof(AudioSample));
+                }
+            }
+            _position += numFrames;
+            return numFrames;
+        }
+    }
+
+    return 0;
+}
+
+class BlockPrefetcher : public QRunnable {
+public:
+    BlockPrefetcher(std::function<void()> function) : _function(function) {}
+    void run() override { _function(); }
+
+private:
+    std::function<void()> _function;
+};
+
+StreamingAudioDataPointer StreamingAudioData::createFromMP3(const QByteArray& data) {
+    // skipping frames only parses their headers, so finding the length is much cheaper than decoding
+    MP3StreamDecoder scanner(data);
+    if (!scanner.isValid()) {
+        return StreamingAudioDataPointer();
+    }
+    while (scanner.nextFrame(nullptr, true) > 0) {}
+
+    if (scanner.getSampleRate() == 0 || scanner.getPosition() == 0 ||
+        (scanner.getNumChannels() != 1 && scanner.getNumChannels() != 2)) {
+        qCWarning(audio) << "Error scanning MP3 file for streaming";
+        return StreamingAudioDataPointer();
+    }
+
+    qCDebug(audio) << "Streaming MP3 with sample rate =" << scanner.getSampleRate()
+                   << "channels =" << scanner.getNumChannels()
+                   << "frames =" << scanner.getPosition();
+
+    return StreamingAudioDataPointer(new StreamingAudioData(data, scanner.getNumChannels(), scanner.getSampleRate(),
+                                                            scanner.getPosition(), AudioConstants::SAMPLE_RATE));
+}
+
+StreamingAudioDataPointer StreamingAudioData::withOutputSampleRate(int outputSampleRate) {
+    if (outputSampleRate == _outputSampleRate) {
+        return shared_from_this();
+    }
+
+    std::lock_guard<std::mutex> lock(_resampledStreamsMutex);
+    auto& weakStream = _resampledStreams[outputSampleRate];
+    auto stream = weakStream.lock();
+    if (!stream) {
+        stream = StreamingAudioDataPointer(new StreamingAudioData(_data, _numChannels, _sourceSampleRate,
+                                                                  _numSourceFrames, outputSampleRate));
+        weakStream = stream;
+    }
+
+    // forget the rates nothing plays anymore
+    for (auto it = _resampledStreams.begin(); it != _resampledStreams.end();) {
+        it = it->second.expired() ? _resampledStreams.erase(it) : std::next(it);
+    }
+    return stream;
+}
+
+QByteArray StreamingAudioData::decodeAll() {
+    QByteArray result;
+    result.reserve(getNumBytes());
+
+    // decoded in order, bypassing the cache
+    std::lock_guard<std::mutex> decoderLock(_decoderMutex);
+    for (int blockIndex = 0; blockIndex < _numBlocks; ++blockIndex) {
+        auto block = decodeBlock(blockIndex);
+        result.append(reinterpret_cast<const char*>(block->data()), (int)(block->size() * sizeof(AudioSample)));
+    }
+    return result;
+}
+
+StreamingAudioData::StreamingAudioData(const QByteArray& data, uint32_t numChannels, uint32_t sourceSampleRate,
+                                       uint64_t numSourceFrames, int outputSampleRate) :
+    _data(data),
+    _numChannels(numChannels),
+    _sourceSampleRate(sourceSampleRate),
+    _numSourceFrames(numSourceFrames),
+    _outputSampleRate(outputSampleRate),
+    _numFrames((uint32_t)(numSourceFrames * outputSampleRate / sourceSampleRate)),
+    _numBlocks((int)((numSourceFrames + BLOCK_SOURCE_FRAMES - 1) / BLOCK_SOURCE_FRAMES))
+{
+}
+
+StreamingAudioData::~StreamingAudioData() {
+}
+
+int StreamingAudioData::getBlockForFrame(uint32_t frame) const {
+    uint64_t sourceFrame = (uint64_t)frame * _sourceSampleRate / _outputSampleRate;
+    return std::min((int)(sourceFrame / BLOCK_SOURCE_FRAMES), _numBlocks - 1);
+}
+
+uint32_t StreamingAudioData::getFirstFrameOfBlock(int blockIndex) const {
+    return (uint32_t)((uint64_t)blockIndex * BLOCK_SOURCE_FRAMES * _outputSampleRate / _sourceSampleRate);
+}
+
+StreamingAudioData::BlockPointer StreamingAudioData::findCachedBlock(int blockIndex) {
+    std::lock_guard<std::mutex> lock(_cacheMutex);
+    return findCachedBlockLocked(blockIndex);
+}
+
+// Must be called with _cacheMutex held
+StreamingAudioData::BlockPointer StreamingAudioData::findCachedBlockLocked(int blockIndex) {
+    auto it = std::find_if(_cachedBlocks.begin(), _cachedBlocks.end(), [blockIndex](const std::pair<int, BlockPointer>& entry) {
+        return entry.first == blockIndex;
+    });
+    if (it == _cachedBlocks.end()) {
+        return BlockPointer();
+    }
+    _cachedBlocks.splice(_cachedBlocks.begin(), _cachedBlocks, it);
+    return _cachedBlocks.front().second;
+}
+
+StreamingAudioData::BlockPointer StreamingAudioData::getBlock(int blockIndex) {
+    if (blockIndex < 0 || blockIndex >= _numBlocks) {
+        return BlockPointer();
+    }
+
+    auto block = findCachedBlock(blockIndex);
+    if (block) {
+        return block;
+    }
+
+    std::lock_guard<std::mutex> decoderLock(_decoderMutex);
+
+    // another thread may have decoded it while we waited
+    block = findCachedBlock(blockIndex);
+    if (block) {
+        return block;
+    }
+
+    block = decodeBlock(blockIndex);
+
+    std::lock_guard<std::mutex> lock(_cacheMutex);
+    _cachedBlocks.emplace_front(blockIndex, block);
+    if (_cachedBlocks.size() > MAX_CACHED_BLOCKS) {
+        _cachedBlocks.pop_back();
+    }
+    return block;
+}
+
+StreamingAudioData::BlockPointer StreamingAudioData::tryGetCachedBlock(int blockIndex) {
+    std::unique_lock<std::mutex> lock(_cacheMutex, std::try_to_lock);
+    if (!lock.owns_lock()) {
+        return BlockPointer();
+    }
+    return findCachedBlockLocked(blockIndex);
+}
+
+void StreamingAudioData::prefetchBlock(int blockIndex) {
+    if (blockIndex < 0 || blockIndex >= _numBlocks) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_cacheMutex);
+        bool isCached = std::any_of(_cachedBlocks.begin(), _cachedBlocks.end(), [blockIndex](const std::pair<int, BlockPointer>& entry) {
+            return entry.first == blockIndex;
+        });
+        if (isCached || !_prefetchingBlocks.insert(blockIndex).second) {
+            return;
+        }
+    }
+
+    std::weak_ptr<StreamingAudioData> weakSelf = shared_from_this();
+    QThreadPool::globalInstance()->start(new BlockPrefetcher([weakSelf, blockIndex] {
+        if (auto self = weakSelf.lock()) {
+            self->getBlock(blockIndex);
+            std::lock_guard<std::mutex> lock(self->_cacheMutex);
+            self->_prefetchingBlocks.erase(blockIndex);
+        }
+    }));
+}
+
+// Must be called with _decoderMutex held
+StreamingAudioData::BlockPointer StreamingAudioData::decodeBlock(int blockIndex) {
+    const uint64_t firstSourceFrame = (uint64_t)blockIndex * BLOCK_SOURCE_FRAMES;
+    const uint64_t lastSourceFrame = std::min(firstSourceFrame + BLOCK_SOURCE_FRAMES, _numSourceFrames);
+    const uint32_t numSourceFrames = (uint32_t)(lastSourceFrame - firstSourceFrame);
+
+    AudioSample frameSamples[MP3_SAMPLES_MAX * MP3_CHANNELS_MAX];
+    auto pendingFrames = [&] { return (uint64_t)(_pendingSamples.size() / _numChannels); };
+    auto decodeUntil = [&](uint64_t numFrames) {
+        while (pendingFrames() < numFrames) {
+            int decodedFrames = _decoder->nextFrame(frameSamples, false);
+            if (decodedFrames == 0) {
+                break;
+            }
+            _pendingSamples.insert(_pendingSamples.end(), frameSamples, frameSamples + decodedFrames * _numChannels);
+        }
+    };
+
+    if (blockIndex != _nextDecodedBlock) {
+        // the blocks are not read in order, seek the decoder and restart the resampler
+        uint64_t position = _decoder ? _decoder->getPosition() - pendingFrames() : 0;
+        if (!_decoder || position > firstSourceFrame) {
+            _decoder.reset(new MP3StreamDecoder(_data));
+            _pendingSamples.clear();
+            position = 0;
+        }
+
+        if (position < firstSourceFrame) {
+            uint64_t framesToDrop = std::min(pendingFrames(), firstSourceFrame - position);
+            _pendingSamples.erase(_pendingSamples.begin(), _pendingSamples.begin() + framesToDrop * _numChannels);
+            position += framesToDrop;
+
+            while (position + MP3_SAMPLES_MAX + SEEK_PREROLL_FRAMES <= firstSourceFrame) {
+                int skippedFrames = _decoder->nextFrame(nullptr, true);
+                if (skippedFrames == 0) {
+                    break;
+                }
+                position += skippedFrames;
+            }
+
+            decodeUntil(firstSourceFrame - position);
+            framesToDrop = std::min(pendingFrames(), firstSourceFrame - position);
+            _pendingSamples.erase(_pendingSamples.begin(), _pendingSamples.begin() + framesToDrop * _numChannels);
+        }
+
+        if ((int)_sourceSampleRate != _outputSampleRate) {
+            _resampler.reset(new AudioSRC(_sourceSampleRate, _outputSampleRate, _numChannels));
+        }
+    }
+    _nextDecodedBlock = blockIndex + 1;
+
+    decodeUntil(numSourceFrames);
+
+    // a truncated stream is padded with silence so the blocks stay aligned with the source
+    std::vector<AudioSample> sourceSamples(numSourceFrames * _numChannels, 0);
+    size_t numAvailableSamples = std::min(sourceSamples.size(), _pendingSamples.size());
+    std::copy(_pendingSamples.begin(), _pendingSamples.begin() + numAvailableSamples, sourceSamples.begin());
+    _pendingSamples.erase(_pendingSamples.begin(), _pendingSamples.begin() + numAvailableSamples);
+
+    auto block = std::make_shared<Block>();
+    if (_resampler) {
+        block->resize(_resampler->getMaxOutput(numSourceFrames) * _numChannels);
+        int numFrames = _resampler->render(sourceSamples.data(), block->data(), numSourceFrames);
+        block->resize(numFrames * _numChannels);
+    } else {
+        block->swap(sourceSamples);
+    }
+    return block;
+}
+
+StreamingAudioReader::StreamingAudioReader(StreamingAudioDataPointer data, bool isRealtime) :
+    _data(data),
+    _isRealtime(isRealtime)
+{
+    seek(0);
+}
+
+void StreamingAudioReader::seek(uint32_t frame) {
+    if (frame >= _data->getNumFrames()) {
+        frame = 0;
+    }
+    _position = frame;
+    _blockIndex = _data->getBlockForFrame(frame);
+    _blockOffset = frame - _data->getFirstFrameOfBlock(_blockIndex);
+    _block.reset();
+    _data->prefetchBlock(_blockIndex);
+}
+
+bool StreamingAudioReader::nextBlock(bool loop) {
+    ++_blockIndex;
+    _blockOffset = 0;
+    if (_blockIndex >= _data->getNumBlocks()) {
+        if (!loop) {
+            return false;
+        }
+        _blockIndex = 0;
+        _position = 0;
+    }
+    _block.reset();
+    return true;
+}
+
+int StreamingAudioReader::read(AudioSample* output, int numFrames, bool loop) {
+    const uint32_t numChannels = _data->getNumChannels();
+    int framesRead = 0;
+    int emptyBlocks = 0;
+
+    while (framesRead < numFrames) {
+        if (!_block) {
+            if (_isRealtime && _blockIndex >= 0 && _blockIndex < _data->getNumBlocks()) {
+                _block = _data->tryGetCachedBlock(_blockIndex);
+                if (!_block) {
+                    // the decoder is behind, play silence rather than wait for it
+                    _data->prefetchBlock(_blockIndex);
+                    std::fill(output + framesRead * numChannels, output + numFrames * numChannels, 0);
+                    return numFrames;
+                }
+            } else {
+                _block = _data->getBlock(_blockIndex);
+            }
+            if (!_block) {
+                break;
+            }
+            // decode the next block ahead of time
+            _data->prefetchBlock(_blockIndex + 1 < _data->getNumBlocks() ? _blockIndex + 1 : (loop ? 0 : -1));
+        }
+
+        uint32_t blockFrames = (uint32_t)(_block->size() / numChannels);
+        if (_blockOffset >= blockFrames) {
+            // the resampler can leave a block empty, but a whole loop of them means there is nothing to read
+            if (++emptyBlocks > _data->getNumBlocks() || !nextBlock(loop)) {
+                break;
+            }
+            continue;
+        }
+        emptyBlocks = 0;
+
+        uint32_t framesToCopy = std::min(blockFrames - _blockOffset, (uint32_t)(numFrames - framesRead));
+        std::copy(_block->begin() + _blockOffset * numChannels, _block->begin() + (_blockOffset + framesToCopy) * numChannels,
+                  output + framesRead * numChannels);
+        _blockOffset += framesToCopy;
+        _position += framesToCopy;
+        framesRead += framesToCopy;
+    }
+
+    return framesRead;
+}
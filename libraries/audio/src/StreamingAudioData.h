@@ -0,0 +1,138 @@
+//
+//  StreamingAudioData.h
+//  libraries/audio/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_StreamingAudioData_h
+#define hifi_StreamingAudioData_h
+
+#include <atomic>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <vector>
+
+#include <QtCore/QByteArray>
+
+#include "AudioConstants.h"
+
+class AudioSRC;
+class MP3StreamDecoder;
+
+class StreamingAudioData;
+using StreamingAudioDataPointer = std::shared_ptr<StreamingAudioData>;
+
+// A sound that keeps its compressed data in memory and decodes it on demand.
+// The sound is decoded and resampled in blocks, and the most recently used blocks are cached, so all the injectors
+// playing the same sound share a single decoder and the blocks it produced.
+// All public methods are thread safe.
+class StreamingAudioData : public std::enable_shared_from_this<StreamingAudioData> {
+public:
+    using AudioSample = AudioConstants::AudioSample;
+    using Block = std::vector<AudioSample>;
+    using BlockPointer = std::shared_ptr<const Block>;
+
+    // Scans the MP3 for its format and length, returns nullptr if it can't be decoded
+    static StreamingAudioDataPointer createFromMP3(const QByteArray& data);
+
+    // Returns a stream of the same sound resampled to outputSampleRate instead of AudioConstants::SAMPLE_RATE,
+    // used for pitch shifting.  The compressed data is shared, and so is the stream while anything plays it.
+    StreamingAudioDataPointer withOutputSampleRate(int outputSampleRate);
+
+    // Decodes the whole sound at once, for sounds too short to be worth streaming
+    QByteArray decodeAll();
+
+    ~StreamingAudioData();
+
+    uint32_t getNumChannels() const { return _numChannels; }
+    bool isStereo() const { return _numChannels == 2; }
+    bool isAmbisonic() const { return _numChannels == 4; }
+
+    // The decoded length is estimated from the source length, the resampler may produce a few frames less
+    uint32_t getNumFrames() const { return _numFrames; }
+    uint32_t getNumSamples() const { return _numFrames * _numChannels; }
+    uint32_t getNumBytes() const { return getNumSamples() * sizeof(AudioSample); }
+    float getDuration() const { return (float)_numFrames / AudioConstants::SAMPLE_RATE; }
+    int getEncodedSize() const { return _data.size(); }
+
+    int getNumBlocks() const { return _numBlocks; }
+    int getBlockForFrame(uint32_t frame) const;
+    uint32_t getFirstFrameOfBlock(int blockIndex) const;
+
+    // Returns the decoded block, decoding it on the calling thread if it isn't cached
+    BlockPointer getBlock(int blockIndex);
+    // Returns the block only if it is cached and the cache isn't locked, never blocks
+    BlockPointer tryGetCachedBlock(int blockIndex);
+
+    // Starts decoding the block on a thread pool thread if it isn't cached yet
+    void prefetchBlock(int blockIndex);
+
+private:
+    StreamingAudioData(const QByteArray& data, uint32_t numChannels, uint32_t sourceSampleRate,
+                       uint64_t numSourceFrames, int outputSampleRate);
+
+    BlockPointer findCachedBlock(int blockIndex);
+    BlockPointer findCachedBlockLocked(int blockIndex);
+    BlockPointer decodeBlock(int blockIndex);
+
+    const QByteArray _data;
+    const uint32_t _numChannels;
+    const uint32_t _sourceSampleRate;
+    const uint64_t _numSourceFrames;
+    const int _outputSampleRate;
+    const uint32_t _numFrames;
+    const int _numBlocks;
+
+    // decoding is serialized, the decoder only seeks when blocks are not read in order
+    std::mutex _decoderMutex;
+    std::unique_ptr<MP3StreamDecoder> _decoder;
+    std::unique_ptr<AudioSRC> _resampler;
+    std::vector<AudioSample> _pendingSamples;
+    int _nextDecodedBlock { -1 };
+
+    // most recently used first
+    std::mutex _cacheMutex;
+    std::list<std::pair<int, BlockPointer>> _cachedBlocks;
+    std::set<int> _prefetchingBlocks;
+
+    // pitch shifted streams of this sound, so each rate has one decoder and cache however many injectors play it
+    std::mutex _resampledStreamsMutex;
+    std::map<int, std::weak_ptr<StreamingAudioData>> _resampledStreams;
+};
+
+// Reads a streaming sound sequentially, one reader per playback.
+// Not thread safe, but different readers can be used on different threads.
+class StreamingAudioReader {
+public:
+    using AudioSample = AudioConstants::AudioSample;
+
+    // A realtime reader never waits on the decoder, it outputs silence when a block hasn't been decoded in time
+    StreamingAudioReader(StreamingAudioDataPointer data, bool isRealtime = false);
+
+    const StreamingAudioDataPointer& getData() const { return _data; }
+
+    void seek(uint32_t frame);
+    uint32_t getPosition() const { return _position; }
+
+    // Reads up to numFrames frames, returns fewer only when the end of the sound was reached without looping
+    int read(AudioSample* output, int numFrames, bool loop);
+
+private:
+    bool nextBlock(bool loop);
+
+    StreamingAudioDataPointer _data;
+    const bool _isRealtime;
+    StreamingAudioData::BlockPointer _block;
+    int _blockIndex { -1 };
+    uint32_t _blockOffset { 0 };
+    uint32_t _position { 0 };
+};
+
+#endif // hifi_StreamingAudioData_h
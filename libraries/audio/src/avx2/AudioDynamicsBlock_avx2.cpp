@@ -0,0 +1,264 @@
+//
+//  AudioDynamicsBlock_avx2.cpp
+//  libraries/audio/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifdef __AVX2__
+
+#include <assert.h>
+#include <immintrin.h>
+
+#include "../AudioDynamics.h"
+#include "../AudioDynamicsBlock.h"
+
+// MULHI(a,b) of 8 lanes
+static inline __m256i mulhi(__m256i a, __m256i b) {
+    __m256i even = _mm256_mul_epi32(a, b);
+    __m256i odd = _mm256_mul_epi32(_mm256_srli_epi64(a, 32), _mm256_srli_epi64(b, 32));
+    return _mm256_blend_epi32(_mm256_srli_epi64(even, 32), odd, 0xaa);
+}
+
+// MULQ31(a,b) of 8 lanes
+static inline __m256i mulq31(__m256i a, __m256i b) {
+    __m256i even = _mm256_mul_epi32(a, b);
+    __m256i odd = _mm256_mul_epi32(_mm256_srli_epi64(a, 32), _mm256_srli_epi64(b, 32));
+    return _mm256_blend_epi32(_mm256_srli_epi64(even, 31), _mm256_slli_epi64(odd, 1), 0xaa);
+}
+
+// evaluate the piecewise polynomial c0*x^2 + c1*x + c2, with coefficients gathered from table
+static inline __m256i polynomial(const int32_t table[][3], __m256i x, int tabbits) {
+
+    __m256i k = _mm256_srli_epi32(x, 31 - tabbits);
+    k = _mm256_add_epi32(k, _mm256_slli_epi32(k, 1));   // k * 3
+
+    __m256i c0 = _mm256_i32gather_epi32((const int*)&table[0][0], k, 4);
+    __m256i c1 = _mm256_i32gather_epi32((const int*)&table[0][1], k, 4);
+    __m256i c2 = _mm256_i32gather_epi32((const int*)&table[0][2], k, 4);
+
+    c1 = _mm256_add_epi32(c1, mulhi(c0, x));
+    c2 = _mm256_add_epi32(c2, mulhi(c1, x));
+    return c2;
+}
+
+// -log2(x) from the float bits of the peak
+static inline __m256i peaklog2(__m256i peak) {
+
+    // split into e and x - 1.0
+    __m256i e = _mm256_sub_epi32(_mm256_set1_epi32(IEEE754_EXPN_BIAS + LOG2_HEADROOM), _mm256_srli_epi32(peak, IEEE754_MANT_BITS));
+    __m256i x = _mm256_and_si256(_mm256_slli_epi32(peak, IEEE754_EXPN_BITS), _mm256_set1_epi32(0x7fffffff));
+
+    __m256i c2 = polynomial(log2Table, x, LOG2_TABBITS);
+
+    // reconstruct result in Q26
+    __m256i result = _mm256_sub_epi32(_mm256_slli_epi32(e, LOG2_FRACBITS), _mm256_srai_epi32(c2, 3));
+
+    // saturate when e > 31 or e < 0
+    __m256i over = _mm256_cmpgt_epi32(e, _mm256_set1_epi32(31));
+    __m256i under = _mm256_cmpgt_epi32(_mm256_setzero_si256(), e);
+    result = _mm256_blendv_epi8(result, _mm256_set1_epi32(0x7fffffff), over);
+    return _mm256_andnot_si256(under, result);
+}
+
+void peaklog2Block_AVX2(const float* input, int32_t* output, int numFrames, int numChannels) {
+
+    assert(numChannels == 1 || numChannels == 2 || numChannels == 4);
+
+    const __m256 FABS_MASK = _mm256_castsi256_ps(_mm256_set1_epi32(IEEE754_FABS_MASK));
+
+    int n = 0;
+    for (; n < numFrames - 7; n += 8) {
+
+        __m256i peak;
+
+        if (numChannels == 1) {
+
+            peak = _mm256_castps_si256(_mm256_and_ps(_mm256_loadu_ps(&input[n]), FABS_MASK));
+
+        } else if (numChannels == 2) {
+
+            __m256 a = _mm256_and_ps(_mm256_loadu_ps(&input[2*n+0]), FABS_MASK);
+            __m256 b = _mm256_and_ps(_mm256_loadu_ps(&input[2*n+8]), FABS_MASK);
+
+            // max absolute value of each frame, as integer bits
+            peak = _mm256_max_epi32(_mm256_castps_si256(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(2,0,2,0))),
+                                    _mm256_castps_si256(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(3,1,3,1))));
+
+            // frames are ordered 0,1,4,5,2,3,6,7
+            peak = _mm256_permutevar8x32_epi32(peak, _mm256_setr_epi32(0,1,4,5,2,3,6,7));
+
+        } else {
+
+            __m256 a = _mm256_and_ps(_mm256_loadu_ps(&input[4*n+0]), FABS_MASK);
+            __m256 b = _mm256_and_ps(_mm256_loadu_ps(&input[4*n+8]), FABS_MASK);
+            __m256 c = _mm256_and_ps(_mm256_loadu_ps(&input[4*n+16]), FABS_MASK);
+            __m256 d = _mm256_and_ps(_mm256_loadu_ps(&input[4*n+24]), FABS_MASK);
+
+            // max of channel pairs
+            __m256i m0 = _mm256_max_epi32(_mm256_castps_si256(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(2,0,2,0))),
+                                          _mm256_castps_si256(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(3,1,3,1))));
+            __m256i m1 = _mm256_max_epi32(_mm256_castps_si256(_mm256_shuffle_ps(c, d, _MM_SHUFFLE(2,0,2,0))),
+                                          _mm256_castps_si256(_mm256_shuffle_ps(c, d, _MM_SHUFFLE(3,1,3,1))));
+
+            // max of each frame
+            __m256 f0 = _mm256_castsi256_ps(m0);
+            __m256 f1 = _mm256_castsi256_ps(m1);
+            peak = _mm256_max_epi32(_mm256_castps_si256(_mm256_shuffle_ps(f0, f1, _MM_SHUFFLE(2,0,2,0))),
+                                    _mm256_castps_si256(_mm256_shuffle_ps(f0, f1, _MM_SHUFFLE(3,1,3,1))));
+
+            // frames are ordered 0,2,4,6,1,3,5,7
+            peak = _mm256_permutevar8x32_epi32(peak, _mm256_setr_epi32(0,4,1,5,2,6,3,7));
+        }
+
+        _mm256_storeu_si256((__m256i*)&output[n], peaklog2(peak));
+    }
+
+    _mm256_zeroupper();
+
+    // remaining frames
+    peaklog2Block_ref(&input[numChannels*n], &output[n], numFrames - n, numChannels);
+}
+
+void fixlog2Block_AVX2(const int32_t* input, int32_t* output, int numFrames) {
+
+    int n = 0;
+    for (; n < numFrames - 7; n += 8) {
+
+        __m256i x = _mm256_loadu_si256((__m256i*)&input[n]);
+        __m256i valid = _mm256_cmpgt_epi32(x, _mm256_setzero_si256());
+        __m256i u = _mm256_max_epi32(x, _mm256_set1_epi32(1));
+
+        // floor(log2(u)) from the float exponent, corrected when the conversion rounds up
+        __m256i fl = _mm256_srli_epi32(_mm256_castps_si256(_mm256_cvtepi32_ps(u)), IEEE754_MANT_BITS);
+        fl = _mm256_sub_epi32(fl, _mm256_set1_epi32(IEEE754_EXPN_BIAS));
+        fl = _mm256_add_epi32(fl, _mm256_cmpeq_epi32(_mm256_srlv_epi32(u, fl), _mm256_setzero_si256()));
+
+        // split into e and x - 1.0
+        __m256i e = _mm256_sub_epi32(_mm256_set1_epi32(31), fl);
+        x = _mm256_and_si256(_mm256_sllv_epi32(u, e), _mm256_set1_epi32(0x7fffffff));
+
+        __m256i c2 = polynomial(log2Table, x, LOG2_TABBITS);
+
+        // reconstruct result in Q26
+        __m256i result = _mm256_sub_epi32(_mm256_slli_epi32(e, LOG2_FRACBITS), _mm256_srai_epi32(c2, 3));
+
+        // x <= 0 returns 0x7fffffff
+        result = _mm256_blendv_epi8(_mm256_set1_epi32(0x7fffffff), result, valid);
+
+        _mm256_storeu_si256((__m256i*)&output[n], result);
+    }
+
+    _mm256_zeroupper();
+
+    // remaining frames
+    fixlog2Block_ref(&input[n], &output[n], numFrames - n);
+}
+
+void fixexp2Block_AVX2(const int32_t* input, int32_t* output, int numFrames) {
+
+    int n = 0;
+    for (; n < numFrames - 7; n += 8) {
+
+        __m256i x = _mm256_loadu_si256((__m256i*)&input[n]);
+        __m256i valid = _mm256_cmpgt_epi32(x, _mm256_setzero_si256());
+
+        // split into e and 1.0 - x
+        __m256i e = _mm256_srli_epi32(x, LOG2_FRACBITS);
+        x = _mm256_andnot_si256(_mm256_slli_epi32(x, LOG2_INTBITS), _mm256_set1_epi32(0x7fffffff));
+
+        __m256i c2 = polynomial(exp2Table, x, EXP2_TABBITS);
+
+        // reconstruct result in Q31
+        __m256i result = _mm256_srav_epi32(c2, e);
+
+        // x <= 0 returns 0x7fffffff
+        result = _mm256_blendv_epi8(_mm256_set1_epi32(0x7fffffff), result, valid);
+
+        _mm256_storeu_si256((__m256i*)&output[n], result);
+    }
+
+    _mm256_zeroupper();
+
+    // remaining frames
+    fixexp2Block_ref(&input[n], &output[n], numFrames - n);
+}
+
+// permutation that repeats each per-frame value once per channel
+static inline __m256i expandFrames(int numChannels) {
+    switch (numChannels) {
+    case 1:
+        return _mm256_setr_epi32(0,1,2,3,4,5,6,7);
+    case 2:
+        return _mm256_setr_epi32(0,0,1,1,2,2,3,3);
+    default:
+        return _mm256_setr_epi32(0,0,0,0,1,1,1,1);
+    }
+}
+
+// saturate 8 int32_t to int16_t, and store in order
+static inline void storeInt16(int16_t* output, __m256i x) {
+    __m128i lo = _mm256_castsi256_si128(x);
+    __m128i hi = _mm256_extracti128_si256(x, 1);
+    _mm_storeu_si128((__m128i*)output, _mm_packs_epi32(lo, hi));
+}
+
+void applyGainBlock_AVX2(const float* input, const float* gain, const float* dither, int16_t* output, int numFrames, int numChannels) {
+
+    assert(numChannels == 1 || numChannels == 2 || numChannels == 4);
+
+    const int step = 8 / numChannels;   // frames per vector
+    const __m256i expand = expandFrames(numChannels);
+    const __m256i mask = _mm256_cmpgt_epi32(_mm256_set1_epi32(step), _mm256_setr_epi32(0,1,2,3,4,5,6,7));
+
+    int n = 0;
+    for (; n <= numFrames - step; n += step) {
+
+        __m256 g = _mm256_permutevar8x32_ps(_mm256_maskload_ps(&gain[n], mask), expand);
+        __m256 d = _mm256_permutevar8x32_ps(_mm256_maskload_ps(&dither[n], mask), expand);
+
+        // apply gain and dither
+        __m256 x = _mm256_mul_ps(_mm256_loadu_ps(&input[numChannels*n]), g);
+        x = _mm256_add_ps(x, d);
+
+        // round and store 16-bit output
+        storeInt16(&output[numChannels*n], _mm256_cvtps_epi32(x));
+    }
+
+    _mm256_zeroupper();
+
+    // remaining frames
+    applyGainBlock_ref(&input[numChannels*n], &gain[n], &dither[n], &output[numChannels*n], numFrames - n, numChannels);
+}
+
+void applyGainQ31Block_AVX2(const int32_t* input, const int32_t* gain, int16_t* output, int numFrames, int numChannels) {
+
+    assert(numChannels == 1 || numChannels == 2 || numChannels == 4);
+
+    const int step = 8 / numChannels;   // frames per vector
+    const __m256i expand = expandFrames(numChannels);
+    const __m256i mask = _mm256_cmpgt_epi32(_mm256_set1_epi32(step), _mm256_setr_epi32(0,1,2,3,4,5,6,7));
+
+    int n = 0;
+    for (; n <= numFrames - step; n += step) {
+
+        __m256i g = _mm256_permutevar8x32_epi32(_mm256_maskload_epi32(&gain[n], mask), expand);
+
+        // apply gain
+        __m256i x = mulq31(_mm256_loadu_si256((__m256i*)&input[numChannels*n]), g);
+
+        // convert Q30 to Q15, and store with saturation
+        x = _mm256_srai_epi32(_mm256_add_epi32(x, _mm256_set1_epi32(1 << 14)), 15);
+        storeInt16(&output[numChannels*n], x);
+    }
+
+    _mm256_zeroupper();
+
+    // remaining frames
+    applyGainQ31Block_ref(&input[numChannels*n], &gain[n], &output[numChannels*n], numFrames - n, numChannels);
+}
+
+#endif
@@ -0,0 +1,161 @@
+//
+//  AudioReverb_avx2.cpp
+//  libraries/audio/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifdef __AVX2__
+
+#include <assert.h>
+#include <stdint.h>
+#include <immintrin.h>
+
+// convert int16_t to float, deinterleave stereo
+void convertInput16_AVX2(const int16_t* input, float** outputs, int numFrames) {
+    __m256 scale = _mm256_set1_ps(1/32768.0f);
+
+    int i = 0;
+    for (; i < numFrames - 7; i += 8) {
+        __m256i a0 = _mm256_loadu_si256((__m256i*)&input[2*i]);
+        __m256i a1 = a0;
+
+        // deinterleave and sign-extend
+        a0 = _mm256_madd_epi16(a0, _mm256_set1_epi32(0x00000001));
+        a1 = _mm256_madd_epi16(a1, _mm256_set1_epi32(0x00010000));
+
+        __m256 f0 = _mm256_mul_ps(_mm256_cvtepi32_ps(a0), scale);
+        __m256 f1 = _mm256_mul_ps(_mm256_cvtepi32_ps(a1), scale);
+
+        _mm256_storeu_ps(&outputs[0][i], f0);
+        _mm256_storeu_ps(&outputs[1][i], f1);
+    }
+    for (; i < numFrames; i++) {
+        outputs[0][i] = (float)input[2*i + 0] * (1/32768.0f);
+        outputs[1][i] = (float)input[2*i + 1] * (1/32768.0f);
+    }
+
+    _mm256_zeroupper();
+}
+
+// fast TPDF dither in [-1.0f, 1.0f]
+static inline __m256 dither8() {
+
+    // the 16 different maximum-length LCGs, each with its own seed
+    static int16_t rz[16] = { 0, 0, 0, 0, 0, 0, 0, 0, 4567, -24611, 11287, 30011, -7193, 16921, -29347, 2243 };
+
+    __m256i r = _mm256_loadu_si256((__m256i*)rz);
+    r = _mm256_mullo_epi16(r, _mm256_set_epi16(25173, -25511, -5975, -23279, 19445, -27591, 30185, -3495,
+                                               25173, -25511, -5975, -23279, 19445, -27591, 30185, -3495));
+    r = _mm256_add_epi16(r, _mm256_set_epi16(13849, -32767, 105, -19675, -7701, -32679, -13225, 28013,
+                                             13849, -32767, 105, -19675, -7701, -32679, -13225, 28013));
+    _mm256_storeu_si256((__m256i*)rz, r);
+
+    // promote to 32-bit
+    __m256i r0 = _mm256_unpacklo_epi16(r, _mm256_setzero_si256());
+    __m256i r1 = _mm256_unpackhi_epi16(r, _mm256_setzero_si256());
+
+    // return (r0 - r1) * (1/65536.0f);
+    __m256 d0 = _mm256_cvtepi32_ps(_mm256_sub_epi32(r0, r1));
+    return _mm256_mul_ps(d0, _mm256_set1_ps(1/65536.0f));
+}
+
+// convert float to int16_t with dither, interleave stereo
+void convertOutput16_AVX2(float** inputs, int16_t* output, int numFrames) {
+    __m256 scale = _mm256_set1_ps(32768.0f);
+
+    int i = 0;
+    for (; i < numFrames - 7; i += 8) {
+        __m256 f0 = _mm256_mul_ps(_mm256_loadu_ps(&inputs[0][i]), scale);
+        __m256 f1 = _mm256_mul_ps(_mm256_loadu_ps(&inputs[1][i]), scale);
+
+        __m256 d0 = dither8();
+        f0 = _mm256_add_ps(f0, d0);
+        f1 = _mm256_add_ps(f1, d0);
+
+        // round
+        __m256i a0 = _mm256_cvtps_epi32(f0);
+        __m256i a1 = _mm256_cvtps_epi32(f1);
+
+        // interleave, saturate and store frames 0-3 and 4-7 from each lane
+        __m256i lo = _mm256_unpacklo_epi32(a0, a1);
+        __m256i hi = _mm256_unpackhi_epi32(a0, a1);
+        _mm256_storeu_si256((__m256i*)&output[2*i], _mm256_packs_epi32(lo, hi));
+    }
+    for (; i < numFrames; i++) {
+        __m128 f0 = _mm_mul_ps(_mm_load_ss(&inputs[0][i]), _mm256_castps256_ps128(scale));
+        __m128 f1 = _mm_mul_ps(_mm_load_ss(&inputs[1][i]), _mm256_castps256_ps128(scale));
+
+        __m128 d0 = _mm256_castps256_ps128(dither8());
+        f0 = _mm_add_ps(f0, d0);
+        f1 = _mm_add_ps(f1, d0);
+
+        // round and saturate
+        __m128i a0 = _mm_cvtps_epi32(f0);
+        __m128i a1 = _mm_cvtps_epi32(f1);
+        a0 = _mm_packs_epi32(a0, a0);
+        a1 = _mm_packs_epi32(a1, a1);
+
+        // interleave
+        a0 = _mm_unpacklo_epi16(a0, a1);
+        *(int32_t*)&output[2*i] = _mm_cvtsi128_si32(a0);
+    }
+
+    _mm256_zeroupper();
+}
+
+// deinterleave stereo
+void convertInputFloat_AVX2(const float* input, float** outputs, int numFrames) {
+
+    int i = 0;
+    for (; i < numFrames - 7; i += 8) {
+        __m256 f0 = _mm256_loadu_ps(&input[2*i + 0]);
+        __m256 f1 = _mm256_loadu_ps(&input[2*i + 8]);
+
+        // deinterleave, frames are ordered 0,1,4,5,2,3,6,7
+        __m256 l = _mm256_shuffle_ps(f0, f1, _MM_SHUFFLE(2,0,2,0));
+        __m256 r = _mm256_shuffle_ps(f0, f1, _MM_SHUFFLE(3,1,3,1));
+
+        l = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(l), _MM_SHUFFLE(3,1,2,0)));
+        r = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(r), _MM_SHUFFLE(3,1,2,0)));
+
+        _mm256_storeu_ps(&outputs[0][i], l);
+        _mm256_storeu_ps(&outputs[1][i], r);
+    }
+    for (; i < numFrames; i++) {
+        // deinterleave
+        outputs[0][i] = input[2*i + 0];
+        outputs[1][i] = input[2*i + 1];
+    }
+
+    _mm256_zeroupper();
+}
+
+// interleave stereo
+void convertOutputFloat_AVX2(float** inputs, float* output, int numFrames) {
+
+    int i = 0;
+    for (; i < numFrames - 7; i += 8) {
+        __m256 f0 = _mm256_loadu_ps(&inputs[0][i]);
+        __m256 f1 = _mm256_loadu_ps(&inputs[1][i]);
+
+        // interleave, frames are ordered 0,1,4,5 and 2,3,6,7
+        __m256 lo = _mm256_unpacklo_ps(f0, f1);
+        __m256 hi = _mm256_unpackhi_ps(f0, f1);
+
+        _mm256_storeu_ps(&output[2*i + 0], _mm256_permute2f128_ps(lo, hi, 0x20));
+        _mm256_storeu_ps(&output[2*i + 8], _mm256_permute2f128_ps(lo, hi, 0x31));
+    }
+    for (; i < numFrames; i++) {
+        // interleave
+        output[2*i + 0] = inputs[0][i];
+        output[2*i + 1] = inputs[1][i];
+    }
+
+    _mm256_zeroupper();
+}
+
+#endif
@@ -1477,7 +1477,7 @@ void Avatar::setAttachmentData(const QVector<AttachmentData>& attachmentData) {
 }
 
 
-int Avatar::parseDataFromBuffer(const QByteArray& buffer) {
+void Avatar::applyDecodedData(const DecodedAvatarData& decoded) {
     PerformanceTimer perfTimer("unpack");
     if (!_initialized) {
         // now that we have data for this Avatar we are go for init
@@ -1487,15 +1487,13 @@ int Avatar::parseDataFromBuffer(const QByteArray& buffer) {
     // change in position implies movement
     glm::vec3 oldPosition = getWorldPosition();
 
-    int bytesRead = AvatarData::parseDataFromBuffer(buffer);
+    AvatarData::applyDecodedData(decoded);
 
     const float MOVE_DISTANCE_THRESHOLD = 0.001f;
     _moving = glm::distance(oldPosition, getWorldPosition()) > MOVE_DISTANCE_THRESHOLD;
     if (_moving || _hasNewJointData) {
         locationChanged();
     }
-
-    return bytesRead;
 }
 
 int Avatar::_jointConesID = GeometryCache::UNKNOWN_ID;
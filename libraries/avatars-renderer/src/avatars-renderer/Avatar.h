@@ -234,7 +234,7 @@ public:
     void updateDisplayNameAlpha(bool showDisplayName);
     virtual void setSessionDisplayName(const QString& sessionDisplayName) override { }; // no-op
 
-    virtual int parseDataFromBuffer(const QByteArray& buffer) override;
+    virtual void applyDecodedData(const DecodedAvatarData& decoded) override;
 
     static void renderJointConnectingCone(gpu::Batch& batch, glm::vec3 position1, glm::vec3 position2,
                                                float radius1, float radius2, const glm::vec4& color);
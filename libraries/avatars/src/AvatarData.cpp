@@ -40,6 +40,7 @@
 #include <Profile.h>
 #include <VariantMapToScriptValue.h>
 #include <BitVectorHelpers.h>
+#include <FaceshiftConstants.h>
 
 #include "AvatarLogging.h"
 #include "AvatarTraits.h"
@@ -78,6 +79,8 @@ size_t AvatarDataPacket::maxJointDataSize(size_t numJoints, bool hasGrabJoints)
     size_t NUM_FAUX_JOINT = 2;
     totalSize += NUM_FAUX_JOINT * (sizeof(SixByteQuat) + sizeof(SixByteTrans)); // faux joints
 
+    totalSize += AvatarJointCodec::maxEncodingOverhead(numJoints); // in case the joints are predicted
+
     if (hasGrabJoints) {
         totalSize += sizeof(AvatarDataPacket::FarGrabJoints);
     }
@@ -239,7 +242,8 @@ QByteArray AvatarData::toByteArrayStateful(AvatarDataDetail dataDetail, bool dro
 QByteArray AvatarData::toByteArray(AvatarDataDetail dataDetail, quint64 lastSentTime,
                                    const QVector<JointData>& lastSentJointData,
     AvatarDataPacket::SendStatus& sendStatus, bool dropFaceTracking, bool distanceAdjust,
-    glm::vec3 viewerPosition, QVector<JointData>* sentJointDataOut, int maxDataSize, AvatarDataRate* outboundDataRateOut) const {
+    glm::vec3 viewerPosition, QVector<JointData>* sentJointDataOut, int maxDataSize, AvatarDataRate* outboundDataRateOut,
+    AvatarJointCodec::History* jointHistory) const {
 
     bool cullSmallChanges = (dataDetail == CullSmallData);
     bool sendAll = (dataDetail == SendAllData);
@@ -611,12 +615,27 @@ QByteArray AvatarData::toByteArray(AvatarDataDetail dataDetail, quint64 lastSent
     assert(numJoints <= 255);
     const int jointBitVectorSize = calcBitVectorSize(numJoints);
 
+    // With a joint history the joint values are predicted from the ones sent before, the values are collected while
+    // the validity bits are written and encoded by AvatarJointCodec after them.
+    const ptrdiff_t predictedOverhead = jointHistory ? (ptrdiff_t)AvatarJointCodec::maxEncodingOverhead(0) : 0;
+    std::vector<int> predictedRotationJoints;
+    std::vector<AvatarJointCodec::QuantizedRotation> predictedRotations;
+    std::vector<int> predictedTranslationJoints;
+    std::vector<AvatarJointCodec::QuantizedTranslation> predictedTranslations;
+    int predictedBits = 0;
+    auto spaceForJoints = [&] {
+        return (packetEnd - destinationBuffer) - (jointHistory ? predictedOverhead + (predictedBits + 7) / 8 : 0);
+    };
+
     // Start joints if room for at least the faux joints.
-    IF_AVATAR_SPACE(PACKET_HAS_JOINT_DATA, 1 + 2 * jointBitVectorSize + AvatarDataPacket::FAUX_JOINTS_SIZE) {
-        // Allow for faux joints + translation bit-vector:
+    IF_AVATAR_SPACE(PACKET_HAS_JOINT_DATA, 1 + 2 * jointBitVectorSize + AvatarDataPacket::FAUX_JOINTS_SIZE + predictedOverhead) {
+        // Allow for faux joints + translation bit-vector, a predicted joint takes at most a byte more:
         const ptrdiff_t minSizeForJoint = sizeof(AvatarDataPacket::SixByteQuat)
-            + jointBitVectorSize + AvatarDataPacket::FAUX_JOINTS_SIZE;
+            + jointBitVectorSize + AvatarDataPacket::FAUX_JOINTS_SIZE + (jointHistory ? 1 : 0);
         auto startSection = destinationBuffer;
+        if (jointHistory) {
+            includedFlags |= AvatarDataPacket::PACKET_HAS_PREDICTED_JOINTS;
+        }
 
         // joint rotation data
         *destinationBuffer++ = (uint8_t)numJoints;
@@ -645,7 +664,7 @@ QByteArray AvatarData::toByteArray(AvatarDataDetail dataDetail, quint64 lastSent
             const JointData& data = joints[i];
             const JointData& last = lastSentJointData[i];
 
-            if (packetEnd - destinationBuffer >= minSizeForJoint) {
+            if (spaceForJoints() >= minSizeForJoint) {
                 if (!data.rotationIsDefaultPose) {
                     // The dot product for larger rotations is a lower number,
                     // so if the dot() is less than the value, then the rotation is a larger angle of rotation
@@ -655,7 +674,13 @@ QByteArray AvatarData::toByteArray(AvatarDataDetail dataDetail, quint64 lastSent
 #ifdef WANT_DEBUG
                         rotationSentCount++;
 #endif
-                        destinationBuffer += packOrientationQuatToSixBytes(destinationBuffer, data.rotation);
+                        if (jointHistory) {
+                            predictedRotationJoints.push_back(i);
+                            predictedRotations.push_back(AvatarJointCodec::quantizeRotation(data.rotation));
+                            predictedBits += AvatarJointCodec::MAX_ROTATION_BITS;
+                        } else {
+                            destinationBuffer += packOrientationQuatToSixBytes(destinationBuffer, data.rotation);
+                        }
 
                         if (sentJoints) {
                             sentJoints[i].rotation = data.rotation;
@@ -692,7 +717,7 @@ QByteArray AvatarData::toByteArray(AvatarDataDetail dataDetail, quint64 lastSent
             const JointData& data = joints[i];
             const JointData& last = lastSentJointData[i];
 
-            if (packetEnd - destinationBuffer >= minSizeForJoint) {
+            if (spaceForJoints() >= minSizeForJoint) {
                 if (!data.translationIsDefaultPose) {
                     if (sendAll || last.translationIsDefaultPose || (!cullSmallChanges && last.translation != data.translation)
                         || (cullSmallChanges && glm::distance(data.translation, lastSentJointData[i].translation) > minTranslation)) {
@@ -704,8 +729,15 @@ QByteArray AvatarData::toByteArray(AvatarDataDetail dataDetail, quint64 lastSent
                         maxTranslationDimension = glm::max(fabsf(data.translation.y), maxTranslationDimension);
                         maxTranslationDimension = glm::max(fabsf(data.translation.z), maxTranslationDimension);
 
-                        destinationBuffer +=
-                            packFloatVec3ToSignedTwoByteFixed(destinationBuffer, data.translation, TRANSLATION_COMPRESSION_RADIX);
+                        if (jointHistory) {
+                            predictedTranslationJoints.push_back(i);
+                            predictedTranslations.push_back(
+                                AvatarJointCodec::quantizeTranslation(data.translation, TRANSLATION_COMPRESSION_RADIX));
+                            predictedBits += AvatarJointCodec::MAX_TRANSLATION_BITS;
+                        } else {
+                            destinationBuffer += packFloatVec3ToSignedTwoByteFixed(destinationBuffer, data.translation,
+                                TRANSLATION_COMPRESSION_RADIX);
+                        }
 
                         if (sentJoints) {
                             sentJoints[i].translation = data.translation;
@@ -723,6 +755,12 @@ QByteArray AvatarData::toByteArray(AvatarDataDetail dataDetail, quint64 lastSent
         }
         sendStatus.translationsSent = i;
 
+        if (jointHistory) {
+            destinationBuffer += AvatarJointCodec::encode(*jointHistory, sendAll, numJoints,
+                predictedRotationJoints, predictedRotations, predictedTranslationJoints, predictedTranslations,
+                destinationBuffer);
+        }
+
         // faux joints
         Transform controllerLeftHandTransform = Transform(getControllerLeftHandMatrix());
         destinationBuffer += packOrientationQuatToSixBytes(destinationBuffer, controllerLeftHandTransform.getRotation());
@@ -866,7 +904,7 @@ bool AvatarData::shouldLogError(const quint64& now) {
 }
 
 
-const unsigned char* unpackFauxJoint(const unsigned char* sourceBuffer, ThreadSafeValueCache<glm::mat4>& matrixCache) {
+static const unsigned char* unpackFauxJoint(const unsigned char* sourceBuffer, glm::mat4& matrix) {
     glm::quat orientation;
     glm::vec3 position;
     Transform transform;
@@ -874,61 +912,309 @@ const unsigned char* unpackFauxJoint(const unsigned char* sourceBuffer, ThreadSa
     sourceBuffer += unpackFloatVec3FromSignedTwoByteFixed(sourceBuffer, position, TRANSLATION_COMPRESSION_RADIX);
     transform.setTranslation(position);
     transform.setRotation(orientation);
-    matrixCache.set(transform.getMatrix());
+    matrix = transform.getMatrix();
     return sourceBuffer;
 }
 
+// reads validity bits into one byte per joint and returns the number of valid joints
+static int readValidityBits(const unsigned char*& sourceBuffer, int numJoints, std::vector<uint8_t>& valid) {
+    int numValid = 0;
+    valid.resize(numJoints);
+    unsigned char validity = 0;
+    int validityBit = 0;
+    for (int i = 0; i < numJoints; i++) {
+        if (validityBit == 0) {
+            validity = *sourceBuffer++;
+        }
+        valid[i] = (validity >> validityBit) & 1;
+        numValid += valid[i];
+        validityBit = (validityBit + 1) % BITS_IN_BYTE;
+    }
+    return numValid;
+}
 
-#define PACKET_READ_CHECK(ITEM_NAME, SIZE_TO_READ)                                        \
-    if ((endPosition - sourceBuffer) < (int)SIZE_TO_READ) {                               \
-        if (shouldLogError(now)) {                                                        \
-            qCWarning(avatars) << "AvatarData packet too small, attempting to read " <<   \
-                #ITEM_NAME << ", only " << (endPosition - sourceBuffer) <<                \
-                " bytes left, " << getSessionUUID();                                      \
-        }                                                                                 \
-        return buffer.size();                                                             \
+#define PACKET_READ_CHECK(ITEM_NAME, SIZE_TO_READ)                                                  \
+    if ((endPosition - sourceBuffer) < (int)SIZE_TO_READ) {                                         \
+        decoded.error = QString("AvatarData packet too small, attempting to read %1, only %2 bytes left") \
+            .arg(#ITEM_NAME).arg(endPosition - sourceBuffer);                                       \
+        decoded.numBytes = buffer.size();                                                           \
+        return decoded.numBytes;                                                                    \
     }
 
-// read data in packet starting at byte offset and return number of bytes parsed
-int AvatarData::parseDataFromBuffer(const QByteArray& buffer) {
-    // lazily allocate memory for HeadData in case we're not an Avatar instance
-    lazyInitHeadData();
+#define DISCARD_PACKET(REASON)                                          \
+    decoded.error = QString("Discard AvatarData packet: ") + REASON;    \
+    decoded.numBytes = buffer.size();                                   \
+    return decoded.numBytes;
+
+#define HAS_FLAG(B,F) ((B & F) == F)
 
+int AvatarData::decodeDataFromBuffer(const QByteArray& buffer, DecodedAvatarData& decoded) {
     AvatarDataPacket::HasFlags packetStateFlags;
 
     const unsigned char* startPosition = reinterpret_cast<const unsigned char*>(buffer.data());
     const unsigned char* endPosition = startPosition + buffer.size();
     const unsigned char* sourceBuffer = startPosition;
 
+    decoded.flags = 0;
+    decoded.error.clear();
+
     // read the packet flags
+    PACKET_READ_CHECK(PacketStateFlags, sizeof(packetStateFlags));
     memcpy(&packetStateFlags, sourceBuffer, sizeof(packetStateFlags));
     sourceBuffer += sizeof(packetStateFlags);
 
-    #define HAS_FLAG(B,F) ((B & F) == F)
-
-    bool hasAvatarGlobalPosition  = HAS_FLAG(packetStateFlags, AvatarDataPacket::PACKET_HAS_AVATAR_GLOBAL_POSITION);
-    bool hasAvatarBoundingBox     = HAS_FLAG(packetStateFlags, AvatarDataPacket::PACKET_HAS_AVATAR_BOUNDING_BOX);
-    bool hasAvatarOrientation     = HAS_FLAG(packetStateFlags, AvatarDataPacket::PACKET_HAS_AVATAR_ORIENTATION);
-    bool hasAvatarScale           = HAS_FLAG(packetStateFlags, AvatarDataPacket::PACKET_HAS_AVATAR_SCALE);
-    bool hasLookAtPosition        = HAS_FLAG(packetStateFlags, AvatarDataPacket::PACKET_HAS_LOOK_AT_POSITION);
-    bool hasAudioLoudness         = HAS_FLAG(packetStateFlags, AvatarDataPacket::PACKET_HAS_AUDIO_LOUDNESS);
-    bool hasSensorToWorldMatrix   = HAS_FLAG(packetStateFlags, AvatarDataPacket::PACKET_HAS_SENSOR_TO_WORLD_MATRIX);
-    bool hasAdditionalFlags       = HAS_FLAG(packetStateFlags, AvatarDataPacket::PACKET_HAS_ADDITIONAL_FLAGS);
-    bool hasParentInfo            = HAS_FLAG(packetStateFlags, AvatarDataPacket::PACKET_HAS_PARENT_INFO);
-    bool hasAvatarLocalPosition   = HAS_FLAG(packetStateFlags, AvatarDataPacket::PACKET_HAS_AVATAR_LOCAL_POSITION);
-    bool hasFaceTrackerInfo       = HAS_FLAG(packetStateFlags, AvatarDataPacket::PACKET_HAS_FACE_TRACKER_INFO);
-    bool hasJointData             = HAS_FLAG(packetStateFlags, AvatarDataPacket::PACKET_HAS_JOINT_DATA);
-    bool hasJointDefaultPoseFlags = HAS_FLAG(packetStateFlags, AvatarDataPacket::PACKET_HAS_JOINT_DEFAULT_POSE_FLAGS);
-    bool hasGrabJoints            = HAS_FLAG(packetStateFlags, AvatarDataPacket::PACKET_HAS_GRAB_JOINTS);
+    if (HAS_FLAG(packetStateFlags, AvatarDataPacket::PACKET_HAS_AVATAR_GLOBAL_POSITION)) {
+        PACKET_READ_CHECK(AvatarGlobalPosition, sizeof(AvatarDataPacket::AvatarGlobalPosition));
+        auto data = reinterpret_cast<const AvatarDataPacket::AvatarGlobalPosition*>(sourceBuffer);
+        decoded.globalPosition = glm::vec3(data->globalPosition[0], data->globalPosition[1], data->globalPosition[2]);
+        sourceBuffer += sizeof(AvatarDataPacket::AvatarGlobalPosition);
+        decoded.flags |= AvatarDataPacket::PACKET_HAS_AVATAR_GLOBAL_POSITION;
+    }
+
+    if (HAS_FLAG(packetStateFlags, AvatarDataPacket::PACKET_HAS_AVATAR_BOUNDING_BOX)) {
+        PACKET_READ_CHECK(AvatarBoundingBox, sizeof(AvatarDataPacket::AvatarBoundingBox));
+        auto data = reinterpret_cast<const AvatarDataPacket::AvatarBoundingBox*>(sourceBuffer);
+        decoded.boundingBoxDimensions = glm::vec3(data->avatarDimensions[0], data->avatarDimensions[1], data->avatarDimensions[2]);
+        decoded.boundingBoxOffset = glm::vec3(data->boundOriginOffset[0], data->boundOriginOffset[1], data->boundOriginOffset[2]);
+        sourceBuffer += sizeof(AvatarDataPacket::AvatarBoundingBox);
+        decoded.flags |= AvatarDataPacket::PACKET_HAS_AVATAR_BOUNDING_BOX;
+    }
+
+    if (HAS_FLAG(packetStateFlags, AvatarDataPacket::PACKET_HAS_AVATAR_ORIENTATION)) {
+        PACKET_READ_CHECK(AvatarOrientation, sizeof(AvatarDataPacket::AvatarOrientation));
+        sourceBuffer += unpackOrientationQuatFromSixBytes(sourceBuffer, decoded.orientation);
+        decoded.flags |= AvatarDataPacket::PACKET_HAS_AVATAR_ORIENTATION;
+    }
 
-    quint64 now = usecTimestampNow();
+    if (HAS_FLAG(packetStateFlags, AvatarDataPacket::PACKET_HAS_AVATAR_SCALE)) {
+        PACKET_READ_CHECK(AvatarScale, sizeof(AvatarDataPacket::AvatarScale));
+        auto data = reinterpret_cast<const AvatarDataPacket::AvatarScale*>(sourceBuffer);
+        unpackFloatRatioFromTwoByte((uint8_t*)&data->scale, decoded.scale);
+        if (isNaN(decoded.scale)) {
+            DISCARD_PACKET("scale NaN");
+        }
+        sourceBuffer += sizeof(AvatarDataPacket::AvatarScale);
+        decoded.flags |= AvatarDataPacket::PACKET_HAS_AVATAR_SCALE;
+    }
+
+    if (HAS_FLAG(packetStateFlags, AvatarDataPacket::PACKET_HAS_LOOK_AT_POSITION)) {
+        PACKET_READ_CHECK(LookAtPosition, sizeof(AvatarDataPacket::LookAtPosition));
+        auto data = reinterpret_cast<const AvatarDataPacket::LookAtPosition*>(sourceBuffer);
+        decoded.lookAtPosition = glm::vec3(data->lookAtPosition[0], data->lookAtPosition[1], data->lookAtPosition[2]);
+        if (isNaN(decoded.lookAtPosition)) {
+            DISCARD_PACKET("lookAtPosition is NaN");
+        }
+        sourceBuffer += sizeof(AvatarDataPacket::LookAtPosition);
+        decoded.flags |= AvatarDataPacket::PACKET_HAS_LOOK_AT_POSITION;
+    }
 
-    if (hasAvatarGlobalPosition) {
+    if (HAS_FLAG(packetStateFlags, AvatarDataPacket::PACKET_HAS_AUDIO_LOUDNESS)) {
+        PACKET_READ_CHECK(AudioLoudness, sizeof(AvatarDataPacket::AudioLoudness));
+        auto data = reinterpret_cast<const AvatarDataPacket::AudioLoudness*>(sourceBuffer);
+        decoded.audioLoudness = unpackFloatGainFromByte(data->audioLoudness) * AUDIO_LOUDNESS_SCALE;
+        sourceBuffer += sizeof(AvatarDataPacket::AudioLoudness);
+        if (isNaN(decoded.audioLoudness)) {
+            DISCARD_PACKET("audioLoudness is NaN");
+        }
+        decoded.flags |= AvatarDataPacket::PACKET_HAS_AUDIO_LOUDNESS;
+    }
+
+    if (HAS_FLAG(packetStateFlags, AvatarDataPacket::PACKET_HAS_SENSOR_TO_WORLD_MATRIX)) {
+        PACKET_READ_CHECK(SensorToWorldMatrix, sizeof(AvatarDataPacket::SensorToWorldMatrix));
+        auto data = reinterpret_cast<const AvatarDataPacket::SensorToWorldMatrix*>(sourceBuffer);
+        glm::quat sensorToWorldQuat;
+        unpackOrientationQuatFromSixBytes(data->sensorToWorldQuat, sensorToWorldQuat);
+        float sensorToWorldScale;
+        // Grab a local copy of sensorToWorldScale to be able to use the unpack function with a pointer on it,
+        // a direct pointer on the struct attribute triggers warnings because of potential misalignement.
+        auto srcSensorToWorldScale = data->sensorToWorldScale;
+        unpackFloatScalarFromSignedTwoByteFixed((int16_t*)&srcSensorToWorldScale, &sensorToWorldScale, SENSOR_TO_WORLD_SCALE_RADIX);
+        glm::vec3 sensorToWorldTrans(data->sensorToWorldTrans[0], data->sensorToWorldTrans[1], data->sensorToWorldTrans[2]);
+        decoded.sensorToWorldMatrix = createMatFromScaleQuatAndPos(glm::vec3(sensorToWorldScale), sensorToWorldQuat, sensorToWorldTrans);
+        sourceBuffer += sizeof(AvatarDataPacket::SensorToWorldMatrix);
+        decoded.flags |= AvatarDataPacket::PACKET_HAS_SENSOR_TO_WORLD_MATRIX;
+    }
+
+    if (HAS_FLAG(packetStateFlags, AvatarDataPacket::PACKET_HAS_ADDITIONAL_FLAGS)) {
+        PACKET_READ_CHECK(AdditionalFlags, sizeof(AvatarDataPacket::AdditionalFlags));
+        auto data = reinterpret_cast<const AvatarDataPacket::AdditionalFlags*>(sourceBuffer);
+        decoded.additionalFlags = data->flags;
+        sourceBuffer += sizeof(AvatarDataPacket::AdditionalFlags);
+        decoded.flags |= AvatarDataPacket::PACKET_HAS_ADDITIONAL_FLAGS;
+    }
+
+    if (HAS_FLAG(packetStateFlags, AvatarDataPacket::PACKET_HAS_PARENT_INFO)) {
+        PACKET_READ_CHECK(ParentInfo, sizeof(AvatarDataPacket::ParentInfo));
+        auto parentInfo = reinterpret_cast<const AvatarDataPacket::ParentInfo*>(sourceBuffer);
+        decoded.parentID = QUuid::fromRfc4122(QByteArray::fromRawData((const char*)parentInfo->parentUUID, NUM_BYTES_RFC4122_UUID));
+        decoded.parentJointIndex = parentInfo->parentJointIndex;
+        sourceBuffer += sizeof(AvatarDataPacket::ParentInfo);
+        decoded.flags |= AvatarDataPacket::PACKET_HAS_PARENT_INFO;
+    }
+
+    if (HAS_FLAG(packetStateFlags, AvatarDataPacket::PACKET_HAS_AVATAR_LOCAL_POSITION)) {
+        PACKET_READ_CHECK(AvatarLocalPosition, sizeof(AvatarDataPacket::AvatarLocalPosition));
+        auto data = reinterpret_cast<const AvatarDataPacket::AvatarLocalPosition*>(sourceBuffer);
+        decoded.localPosition = glm::vec3(data->localPosition[0], data->localPosition[1], data->localPosition[2]);
+        if (isNaN(decoded.localPosition)) {
+            DISCARD_PACKET("position NaN");
+        }
+        sourceBuffer += sizeof(AvatarDataPacket::AvatarLocalPosition);
+        decoded.flags |= AvatarDataPacket::PACKET_HAS_AVATAR_LOCAL_POSITION;
+    }
+
+    if (HAS_FLAG(packetStateFlags, AvatarDataPacket::PACKET_HAS_FACE_TRACKER_INFO)) {
         auto startSection = sourceBuffer;
 
-        PACKET_READ_CHECK(AvatarGlobalPosition, sizeof(AvatarDataPacket::AvatarGlobalPosition));
-        auto data = reinterpret_cast<const AvatarDataPacket::AvatarGlobalPosition*>(sourceBuffer);
+        PACKET_READ_CHECK(FaceTrackerInfo, sizeof(AvatarDataPacket::FaceTrackerInfo));
+        auto faceTrackerInfo = reinterpret_cast<const AvatarDataPacket::FaceTrackerInfo*>(sourceBuffer);
+        int numCoefficients = faceTrackerInfo->numBlendshapeCoefficients;
+        const int coefficientsSize = sizeof(float) * numCoefficients;
+        sourceBuffer += sizeof(AvatarDataPacket::FaceTrackerInfo);
+
+        PACKET_READ_CHECK(FaceTrackerCoefficients, coefficientsSize);
+        //only copy the blendshapes, not the procedural face info
+        decoded.blendshapeCoefficients.resize(numCoefficients);
+        memcpy(decoded.blendshapeCoefficients.data(), sourceBuffer, coefficientsSize);
+        sourceBuffer += coefficientsSize;
+
+        decoded.faceTrackerSize = sourceBuffer - startSection;
+        decoded.flags |= AvatarDataPacket::PACKET_HAS_FACE_TRACKER_INFO;
+    }
+
+    if (HAS_FLAG(packetStateFlags, AvatarDataPacket::PACKET_HAS_JOINT_DATA)) {
+        auto startSection = sourceBuffer;
+
+        PACKET_READ_CHECK(NumJoints, sizeof(uint8_t));
+        int numJoints = *sourceBuffer++;
+        decoded.numJoints = numJoints;
+        const int bytesOfValidity = (int)ceil((float)numJoints / (float)BITS_IN_BYTE);
+
+        int numValidJointRotations;
+        int numValidJointTranslations;
+        if (HAS_FLAG(packetStateFlags, AvatarDataPacket::PACKET_HAS_PREDICTED_JOINTS)) {
+            // the values can only be reconstructed by the receiving avatar, see applyDecodedData
+            PACKET_READ_CHECK(JointValidityBits, 2 * bytesOfValidity);
+            numValidJointRotations = readValidityBits(sourceBuffer, numJoints, decoded.validRotations);
+            numValidJointTranslations = readValidityBits(sourceBuffer, numJoints, decoded.validTranslations);
+
+            int bytesRead = AvatarJointCodec::read(sourceBuffer, (int)(endPosition - sourceBuffer),
+                numValidJointRotations, numValidJointTranslations, decoded.predictedJoints);
+            if (bytesRead < 0) {
+                decoded.error = QString("AvatarData packet has bad predicted joints");
+                decoded.numBytes = buffer.size();
+                return decoded.numBytes;
+            }
+            sourceBuffer += bytesRead;
+            decoded.flags |= AvatarDataPacket::PACKET_HAS_PREDICTED_JOINTS;
+        } else {
+            // each joint rotation is stored in 6 bytes.
+            PACKET_READ_CHECK(JointRotationValidityBits, bytesOfValidity);
+            numValidJointRotations = readValidityBits(sourceBuffer, numJoints, decoded.validRotations);
+            const int COMPRESSED_QUATERNION_SIZE = 6;
+            PACKET_READ_CHECK(JointRotations, numValidJointRotations * COMPRESSED_QUATERNION_SIZE);
+            decoded.rotations.resize(numValidJointRotations);
+            sourceBuffer += unpackOrientationQuatsFromSixBytes(sourceBuffer, decoded.rotations.data(), numValidJointRotations);
+
+            // get translation validity bits -- these indicate which translations were packed
+            PACKET_READ_CHECK(JointTranslationValidityBits, bytesOfValidity);
+            numValidJointTranslations = readValidityBits(sourceBuffer, numJoints, decoded.validTranslations);
+
+            // each joint translation component is stored in 6 bytes.
+            const int COMPRESSED_TRANSLATION_SIZE = 6;
+            PACKET_READ_CHECK(JointTranslation, numValidJointTranslations * COMPRESSED_TRANSLATION_SIZE);
+            decoded.translations.resize(numValidJointTranslations);
+            sourceBuffer += unpackFloatVec3sFromSignedTwoByteFixed(sourceBuffer, decoded.translations.data(),
+                                                                   numValidJointTranslations, TRANSLATION_COMPRESSION_RADIX);
+        }
+
+#ifdef WANT_DEBUG
+        if (numValidJointRotations > 15) {
+            qCDebug(avatars) << "RECEIVING -- rotations:" << numValidJointRotations
+                << "translations:" << numValidJointTranslations
+                << "size:" << (int)(sourceBuffer - startPosition);
+        }
+#endif
+        // faux joints
+        PACKET_READ_CHECK(FauxJoints, AvatarDataPacket::FAUX_JOINTS_SIZE);
+        sourceBuffer = unpackFauxJoint(sourceBuffer, decoded.controllerLeftHandMatrix);
+        sourceBuffer = unpackFauxJoint(sourceBuffer, decoded.controllerRightHandMatrix);
+
+        decoded.jointDataSize = sourceBuffer - startSection;
+        decoded.flags |= AvatarDataPacket::PACKET_HAS_JOINT_DATA;
+
+        if (HAS_FLAG(packetStateFlags, AvatarDataPacket::PACKET_HAS_GRAB_JOINTS)) {
+            PACKET_READ_CHECK(FarGrabJoints, sizeof(AvatarDataPacket::FarGrabJoints));
+
+            AvatarDataPacket::FarGrabJoints farGrabJoints;
+            memcpy(&farGrabJoints, sourceBuffer, sizeof(farGrabJoints)); // to avoid misaligned floats
+
+            glm::vec3 leftFarGrabPosition = glm::vec3(farGrabJoints.leftFarGrabPosition[0],
+                                                      farGrabJoints.leftFarGrabPosition[1],
+                                                      farGrabJoints.leftFarGrabPosition[2]);
+            glm::quat leftFarGrabRotation = glm::quat(farGrabJoints.leftFarGrabRotation[0],
+                                                      farGrabJoints.leftFarGrabRotation[1],
+                                                      farGrabJoints.leftFarGrabRotation[2],
+                                                      farGrabJoints.leftFarGrabRotation[3]);
+            glm::vec3 rightFarGrabPosition = glm::vec3(farGrabJoints.rightFarGrabPosition[0],
+                                                       farGrabJoints.rightFarGrabPosition[1],
+                                                       farGrabJoints.rightFarGrabPosition[2]);
+            glm::quat rightFarGrabRotation = glm::quat(farGrabJoints.rightFarGrabRotation[0],
+                                                       farGrabJoints.rightFarGrabRotation[1],
+                                                       farGrabJoints.rightFarGrabRotation[2],
+                                                       farGrabJoints.rightFarGrabRotation[3]);
+            glm::vec3 mouseFarGrabPosition = glm::vec3(farGrabJoints.mouseFarGrabPosition[0],
+                                                       farGrabJoints.mouseFarGrabPosition[1],
+                                                       farGrabJoints.mouseFarGrabPosition[2]);
+            glm::quat mouseFarGrabRotation = glm::quat(farGrabJoints.mouseFarGrabRotation[0],
+                                                       farGrabJoints.mouseFarGrabRotation[1],
+                                                       farGrabJoints.mouseFarGrabRotation[2],
+                                                       farGrabJoints.mouseFarGrabRotation[3]);
+
+            decoded.farGrabLeftMatrix = createMatFromQuatAndPos(leftFarGrabRotation, leftFarGrabPosition);
+            decoded.farGrabRightMatrix = createMatFromQuatAndPos(rightFarGrabRotation, rightFarGrabPosition);
+            decoded.farGrabMouseMatrix = createMatFromQuatAndPos(mouseFarGrabRotation, mouseFarGrabPosition);
+
+            sourceBuffer += sizeof(AvatarDataPacket::FarGrabJoints);
+            decoded.flags |= AvatarDataPacket::PACKET_HAS_GRAB_JOINTS;
+        }
+    }
+
+    if (HAS_FLAG(packetStateFlags, AvatarDataPacket::PACKET_HAS_JOINT_DEFAULT_POSE_FLAGS)) {
+        auto startSection = sourceBuffer;
+
+        PACKET_READ_CHECK(JointDefaultPoseFlagsNumJoints, sizeof(uint8_t));
+        int numJoints = (int)*sourceBuffer++;
+        decoded.numDefaultPoseJoints = numJoints;
+        decoded.rotationIsDefaultPose.resize(numJoints);
+        decoded.translationIsDefaultPose.resize(numJoints);
+
+        size_t bitVectorSize = calcBitVectorSize(numJoints);
+        PACKET_READ_CHECK(JointDefaultPoseFlagsRotationFlags, bitVectorSize);
+        sourceBuffer += readBitVector(sourceBuffer, numJoints, [&](int i, bool value) {
+            decoded.rotationIsDefaultPose[i] = value;
+        });
+
+        PACKET_READ_CHECK(JointDefaultPoseFlagsTranslationFlags, bitVectorSize);
+        sourceBuffer += readBitVector(sourceBuffer, numJoints, [&](int i, bool value) {
+            decoded.translationIsDefaultPose[i] = value;
+        });
+
+        decoded.jointDefaultPoseFlagsSize = sourceBuffer - startSection;
+        decoded.flags |= AvatarDataPacket::PACKET_HAS_JOINT_DEFAULT_POSE_FLAGS;
+    }
+
+    decoded.numBytes = sourceBuffer - startPosition;
+    return decoded.numBytes;
+}
 
+void AvatarData::applyDecodedData(const DecodedAvatarData& decoded) {
+    // lazily allocate memory for HeadData in case we're not an Avatar instance
+    lazyInitHeadData();
+
+    quint64 now = usecTimestampNow();
+
+    if (HAS_FLAG(decoded.flags, AvatarDataPacket::PACKET_HAS_AVATAR_GLOBAL_POSITION)) {
         glm::vec3 offset = glm::vec3(0.0f, 0.0f, 0.0f);
 
         if (_replicaIndex > 0) {
@@ -939,7 +1225,7 @@ int AvatarData::parseDataFromBuffer(const QByteArray& buffer) {
             offset = glm::vec3(row * SPACE_BETWEEN_AVATARS, 0.0f, col * SPACE_BETWEEN_AVATARS);
         }
 
-        _serverPosition = glm::vec3(data->globalPosition[0], data->globalPosition[1], data->globalPosition[2]) + offset;
+        _serverPosition = decoded.globalPosition + offset;
         if (_isClientAvatar) {
             auto oneStepDistance = glm::length(_globalPosition - _serverPosition);
             if (oneStepDistance <= AVATAR_TRANSIT_MIN_TRIGGER_DISTANCE || oneStepDistance >= AVATAR_TRANSIT_MAX_TRIGGER_DISTANCE) {
@@ -961,144 +1247,65 @@ int AvatarData::parseDataFromBuffer(const QByteArray& buffer) {
                 setLocalPosition(_serverPosition);
             }
         }
-        sourceBuffer += sizeof(AvatarDataPacket::AvatarGlobalPosition);
-        int numBytesRead = sourceBuffer - startSection;
-        _globalPositionRate.increment(numBytesRead);
+        _globalPositionRate.increment(sizeof(AvatarDataPacket::AvatarGlobalPosition));
         _globalPositionUpdateRate.increment();
     }
 
-    if (hasAvatarBoundingBox) {
-        auto startSection = sourceBuffer;
-
-        PACKET_READ_CHECK(AvatarBoundingBox, sizeof(AvatarDataPacket::AvatarBoundingBox));
-        auto data = reinterpret_cast<const AvatarDataPacket::AvatarBoundingBox*>(sourceBuffer);
-        auto newDimensions = glm::vec3(data->avatarDimensions[0], data->avatarDimensions[1], data->avatarDimensions[2]);
-        auto newOffset = glm::vec3(data->boundOriginOffset[0], data->boundOriginOffset[1], data->boundOriginOffset[2]);
-
-
-        if (_globalBoundingBoxDimensions != newDimensions) {
-            _globalBoundingBoxDimensions = newDimensions;
+    if (HAS_FLAG(decoded.flags, AvatarDataPacket::PACKET_HAS_AVATAR_BOUNDING_BOX)) {
+        if (_globalBoundingBoxDimensions != decoded.boundingBoxDimensions) {
+            _globalBoundingBoxDimensions = decoded.boundingBoxDimensions;
             _avatarBoundingBoxChanged = now;
         }
-        if (_globalBoundingBoxOffset != newOffset) {
-            _globalBoundingBoxOffset = newOffset;
+        if (_globalBoundingBoxOffset != decoded.boundingBoxOffset) {
+            _globalBoundingBoxOffset = decoded.boundingBoxOffset;
             _avatarBoundingBoxChanged = now;
         }
 
         _defaultBubbleBox = computeBubbleBox();
 
-        sourceBuffer += sizeof(AvatarDataPacket::AvatarBoundingBox);
-        int numBytesRead = sourceBuffer - startSection;
-        _avatarBoundingBoxRate.increment(numBytesRead);
+        _avatarBoundingBoxRate.increment(sizeof(AvatarDataPacket::AvatarBoundingBox));
         _avatarBoundingBoxUpdateRate.increment();
     }
 
-    if (hasAvatarOrientation) {
-        auto startSection = sourceBuffer;
-        PACKET_READ_CHECK(AvatarOrientation, sizeof(AvatarDataPacket::AvatarOrientation));
-        glm::quat newOrientation;
-        sourceBuffer += unpackOrientationQuatFromSixBytes(sourceBuffer, newOrientation);
+    if (HAS_FLAG(decoded.flags, AvatarDataPacket::PACKET_HAS_AVATAR_ORIENTATION)) {
         glm::quat currentOrientation = getLocalOrientation();
-
-        if (currentOrientation != newOrientation) {
+        if (currentOrientation != decoded.orientation) {
             _hasNewJointData = true;
-            setLocalOrientation(newOrientation);
+            setLocalOrientation(decoded.orientation);
         }
-        int numBytesRead = sourceBuffer - startSection;
-        _avatarOrientationRate.increment(numBytesRead);
+        _avatarOrientationRate.increment(sizeof(AvatarDataPacket::AvatarOrientation));
         _avatarOrientationUpdateRate.increment();
     }
 
-    if (hasAvatarScale) {
-        auto startSection = sourceBuffer;
-
-        PACKET_READ_CHECK(AvatarScale, sizeof(AvatarDataPacket::AvatarScale));
-        auto data = reinterpret_cast<const AvatarDataPacket::AvatarScale*>(sourceBuffer);
-        float scale;
-        unpackFloatRatioFromTwoByte((uint8_t*)&data->scale, scale);
-        if (isNaN(scale)) {
-            if (shouldLogError(now)) {
-                qCWarning(avatars) << "Discard AvatarData packet: scale NaN, uuid " << getSessionUUID();
-            }
-            return buffer.size();
-        }
-        setTargetScale(scale);
-        sourceBuffer += sizeof(AvatarDataPacket::AvatarScale);
-        int numBytesRead = sourceBuffer - startSection;
-        _avatarScaleRate.increment(numBytesRead);
+    if (HAS_FLAG(decoded.flags, AvatarDataPacket::PACKET_HAS_AVATAR_SCALE)) {
+        setTargetScale(decoded.scale);
+        _avatarScaleRate.increment(sizeof(AvatarDataPacket::AvatarScale));
         _avatarScaleUpdateRate.increment();
     }
 
-    if (hasLookAtPosition) {
-        auto startSection = sourceBuffer;
-
-        PACKET_READ_CHECK(LookAtPosition, sizeof(AvatarDataPacket::LookAtPosition));
-        auto data = reinterpret_cast<const AvatarDataPacket::LookAtPosition*>(sourceBuffer);
-        glm::vec3 lookAt = glm::vec3(data->lookAtPosition[0], data->lookAtPosition[1], data->lookAtPosition[2]);
-        if (isNaN(lookAt)) {
-            if (shouldLogError(now)) {
-                qCWarning(avatars) << "Discard AvatarData packet: lookAtPosition is NaN, uuid " << getSessionUUID();
-            }
-            return buffer.size();
-        }
-        _headData->setLookAtPosition(lookAt);
-        sourceBuffer += sizeof(AvatarDataPacket::LookAtPosition);
-        int numBytesRead = sourceBuffer - startSection;
-        _lookAtPositionRate.increment(numBytesRead);
+    if (HAS_FLAG(decoded.flags, AvatarDataPacket::PACKET_HAS_LOOK_AT_POSITION)) {
+        _headData->setLookAtPosition(decoded.lookAtPosition);
+        _lookAtPositionRate.increment(sizeof(AvatarDataPacket::LookAtPosition));
         _lookAtPositionUpdateRate.increment();
     }
 
-    if (hasAudioLoudness) {
-        auto startSection = sourceBuffer;
-
-        PACKET_READ_CHECK(AudioLoudness, sizeof(AvatarDataPacket::AudioLoudness));
-        auto data = reinterpret_cast<const AvatarDataPacket::AudioLoudness*>(sourceBuffer);
-        float audioLoudness;
-        audioLoudness = unpackFloatGainFromByte(data->audioLoudness) * AUDIO_LOUDNESS_SCALE;
-        sourceBuffer += sizeof(AvatarDataPacket::AudioLoudness);
-
-        if (isNaN(audioLoudness)) {
-            if (shouldLogError(now)) {
-                qCWarning(avatars) << "Discard AvatarData packet: audioLoudness is NaN, uuid " << getSessionUUID();
-            }
-            return buffer.size();
-        }
-        setAudioLoudness(audioLoudness);
-        int numBytesRead = sourceBuffer - startSection;
-        _audioLoudnessRate.increment(numBytesRead);
+    if (HAS_FLAG(decoded.flags, AvatarDataPacket::PACKET_HAS_AUDIO_LOUDNESS)) {
+        setAudioLoudness(decoded.audioLoudness);
+        _audioLoudnessRate.increment(sizeof(AvatarDataPacket::AudioLoudness));
         _audioLoudnessUpdateRate.increment();
     }
 
-    if (hasSensorToWorldMatrix) {
-        auto startSection = sourceBuffer;
-
-        PACKET_READ_CHECK(SensorToWorldMatrix, sizeof(AvatarDataPacket::SensorToWorldMatrix));
-        auto data = reinterpret_cast<const AvatarDataPacket::SensorToWorldMatrix*>(sourceBuffer);
-        glm::quat sensorToWorldQuat;
-        unpackOrientationQuatFromSixBytes(data->sensorToWorldQuat, sensorToWorldQuat);
-        float sensorToWorldScale;
-        // Grab a local copy of sensorToWorldScale to be able to use the unpack function with a pointer on it,
-        // a direct pointer on the struct attribute triggers warnings because of potential misalignement.
-        auto srcSensorToWorldScale = data->sensorToWorldScale;
-        unpackFloatScalarFromSignedTwoByteFixed((int16_t*)&srcSensorToWorldScale, &sensorToWorldScale, SENSOR_TO_WORLD_SCALE_RADIX);
-        glm::vec3 sensorToWorldTrans(data->sensorToWorldTrans[0], data->sensorToWorldTrans[1], data->sensorToWorldTrans[2]);
-        glm::mat4 sensorToWorldMatrix = createMatFromScaleQuatAndPos(glm::vec3(sensorToWorldScale), sensorToWorldQuat, sensorToWorldTrans);
-        if (_sensorToWorldMatrixCache.get() != sensorToWorldMatrix) {
-            _sensorToWorldMatrixCache.set(sensorToWorldMatrix);
+    if (HAS_FLAG(decoded.flags, AvatarDataPacket::PACKET_HAS_SENSOR_TO_WORLD_MATRIX)) {
+        if (_sensorToWorldMatrixCache.get() != decoded.sensorToWorldMatrix) {
+            _sensorToWorldMatrixCache.set(decoded.sensorToWorldMatrix);
             _sensorToWorldMatrixChanged = now;
         }
-        sourceBuffer += sizeof(AvatarDataPacket::SensorToWorldMatrix);
-        int numBytesRead = sourceBuffer - startSection;
-        _sensorToWorldRate.increment(numBytesRead);
+        _sensorToWorldRate.increment(sizeof(AvatarDataPacket::SensorToWorldMatrix));
         _sensorToWorldUpdateRate.increment();
     }
 
-    if (hasAdditionalFlags) {
-        auto startSection = sourceBuffer;
-
-        PACKET_READ_CHECK(AdditionalFlags, sizeof(AvatarDataPacket::AdditionalFlags));
-        auto data = reinterpret_cast<const AvatarDataPacket::AdditionalFlags*>(sourceBuffer);
-        uint16_t bitItems = data->flags;
+    if (HAS_FLAG(decoded.flags, AvatarDataPacket::PACKET_HAS_ADDITIONAL_FLAGS)) {
+        uint16_t bitItems = decoded.additionalFlags;
 
         // key state, stored as a semi-nibble in the bitItems
         auto newKeyState = (KeyState)getSemiNibbleAt(bitItems, KEY_STATE_START_BIT);
@@ -1142,246 +1349,133 @@ int AvatarData::parseDataFromBuffer(const QByteArray& buffer) {
         _headData->setHasProceduralBlinkFaceMovement(newHasProceduralBlinkFaceMovement);
         _collideWithOtherAvatars = newCollideWithOtherAvatars;
 
-        sourceBuffer += sizeof(AvatarDataPacket::AdditionalFlags);
-
         if (somethingChanged) {
             _additionalFlagsChanged = now;
         }
-        int numBytesRead = sourceBuffer - startSection;
-        _additionalFlagsRate.increment(numBytesRead);
+        _additionalFlagsRate.increment(sizeof(AvatarDataPacket::AdditionalFlags));
         _additionalFlagsUpdateRate.increment();
     }
 
-    if (hasParentInfo) {
-        auto startSection = sourceBuffer;
-        PACKET_READ_CHECK(ParentInfo, sizeof(AvatarDataPacket::ParentInfo));
-        auto parentInfo = reinterpret_cast<const AvatarDataPacket::ParentInfo*>(sourceBuffer);
-        sourceBuffer += sizeof(AvatarDataPacket::ParentInfo);
-
-        QByteArray byteArray((const char*)parentInfo->parentUUID, NUM_BYTES_RFC4122_UUID);
-
-        auto newParentID = QUuid::fromRfc4122(byteArray);
-
-        if ((getParentID() != newParentID) || (getParentJointIndex() != parentInfo->parentJointIndex)) {
-            SpatiallyNestable::setParentID(newParentID);
-            SpatiallyNestable::setParentJointIndex(parentInfo->parentJointIndex);
+    if (HAS_FLAG(decoded.flags, AvatarDataPacket::PACKET_HAS_PARENT_INFO)) {
+        if ((getParentID() != decoded.parentID) || (getParentJointIndex() != decoded.parentJointIndex)) {
+            SpatiallyNestable::setParentID(decoded.parentID);
+            SpatiallyNestable::setParentJointIndex(decoded.parentJointIndex);
             _parentChanged = now;
         }
 
-        int numBytesRead = sourceBuffer - startSection;
-        _parentInfoRate.increment(numBytesRead);
+        _parentInfoRate.increment(sizeof(AvatarDataPacket::ParentInfo));
         _parentInfoUpdateRate.increment();
     }
 
-    if (hasAvatarLocalPosition) {
-        auto startSection = sourceBuffer;
-
-        PACKET_READ_CHECK(AvatarLocalPosition, sizeof(AvatarDataPacket::AvatarLocalPosition));
-        auto data = reinterpret_cast<const AvatarDataPacket::AvatarLocalPosition*>(sourceBuffer);
-        glm::vec3 position = glm::vec3(data->localPosition[0], data->localPosition[1], data->localPosition[2]);
-        if (isNaN(position)) {
-            if (shouldLogError(now)) {
-                qCWarning(avatars) << "Discard AvatarData packet: position NaN, uuid " << getSessionUUID();
-            }
-            return buffer.size();
-        }
+    if (HAS_FLAG(decoded.flags, AvatarDataPacket::PACKET_HAS_AVATAR_LOCAL_POSITION)) {
         if (hasParent()) {
-            setLocalPosition(position);
+            setLocalPosition(decoded.localPosition);
         } else {
             qCWarning(avatars) << "received localPosition for avatar with no parent";
         }
-        sourceBuffer += sizeof(AvatarDataPacket::AvatarLocalPosition);
-        int numBytesRead = sourceBuffer - startSection;
-        _localPositionRate.increment(numBytesRead);
+        _localPositionRate.increment(sizeof(AvatarDataPacket::AvatarLocalPosition));
         _localPositionUpdateRate.increment();
     }
 
-    if (hasFaceTrackerInfo) {
-        auto startSection = sourceBuffer;
-
-        PACKET_READ_CHECK(FaceTrackerInfo, sizeof(AvatarDataPacket::FaceTrackerInfo));
-        auto faceTrackerInfo = reinterpret_cast<const AvatarDataPacket::FaceTrackerInfo*>(sourceBuffer);
-        int numCoefficients = faceTrackerInfo->numBlendshapeCoefficients;
-        const int coefficientsSize = sizeof(float) * numCoefficients;
-        sourceBuffer += sizeof(AvatarDataPacket::FaceTrackerInfo);
-
-        PACKET_READ_CHECK(FaceTrackerCoefficients, coefficientsSize);
-        _headData->_blendshapeCoefficients.resize(numCoefficients);  // make sure there's room for the copy!
-        //only copy the blendshapes to headData, not the procedural face info
-        memcpy(_headData->_blendshapeCoefficients.data(), sourceBuffer, coefficientsSize);
-        sourceBuffer += coefficientsSize;
-
-        int numBytesRead = sourceBuffer - startSection;
-        _faceTrackerRate.increment(numBytesRead);
+    if (HAS_FLAG(decoded.flags, AvatarDataPacket::PACKET_HAS_FACE_TRACKER_INFO)) {
+        _headData->_blendshapeCoefficients = decoded.blendshapeCoefficients;
+        _faceTrackerRate.increment(decoded.faceTrackerSize);
         _faceTrackerUpdateRate.increment();
     }
 
-    if (hasJointData) {
-        auto startSection = sourceBuffer;
-
-        PACKET_READ_CHECK(NumJoints, sizeof(uint8_t));
-        int numJoints = *sourceBuffer++;
-        const int bytesOfValidity = (int)ceil((float)numJoints / (float)BITS_IN_BYTE);
-        PACKET_READ_CHECK(JointRotationValidityBits, bytesOfValidity);
-
-        int numValidJointRotations = 0;
-        QVector<bool> validRotations;
-        validRotations.resize(numJoints);
-        { // rotation validity bits
-            unsigned char validity = 0;
-            int validityBit = 0;
-            for (int i = 0; i < numJoints; i++) {
-                if (validityBit == 0) {
-                    validity = *sourceBuffer++;
-                }
-                bool valid = (bool)(validity & (1 << validityBit));
-                if (valid) {
-                    ++numValidJointRotations;
-                }
-                validRotations[i] = valid;
-                validityBit = (validityBit + 1) % BITS_IN_BYTE;
-            }
+    if (HAS_FLAG(decoded.flags, AvatarDataPacket::PACKET_HAS_JOINT_DATA)) {
+        const std::vector<uint8_t>* validRotations = &decoded.validRotations;
+        const std::vector<uint8_t>* validTranslations = &decoded.validTranslations;
+        const std::vector<glm::quat>* rotations = &decoded.rotations;
+        const std::vector<glm::vec3>* translations = &decoded.translations;
+
+        // predicted joints are reconstructed against what we received before, leaving out the ones we can't
+        std::vector<uint8_t> predictedValidRotations;
+        std::vector<uint8_t> predictedValidTranslations;
+        std::vector<glm::quat> predictedRotations;
+        std::vector<glm::vec3> predictedTranslations;
+        if (HAS_FLAG(decoded.flags, AvatarDataPacket::PACKET_HAS_PREDICTED_JOINTS)) {
+            predictedValidRotations = decoded.validRotations;
+            predictedValidTranslations = decoded.validTranslations;
+            std::vector<AvatarJointCodec::QuantizedRotation> quantizedRotations;
+            std::vector<AvatarJointCodec::QuantizedTranslation> quantizedTranslations;
+            AvatarJointCodec::decode(_receivedJointHistory, decoded.predictedJoints,
+                predictedValidRotations, quantizedRotations, predictedValidTranslations, quantizedTranslations);
+            AvatarJointCodec::dequantizeRotations(quantizedRotations, predictedRotations);
+            AvatarJointCodec::dequantizeTranslations(quantizedTranslations, predictedTranslations, TRANSLATION_COMPRESSION_RADIX);
+
+            validRotations = &predictedValidRotations;
+            validTranslations = &predictedValidTranslations;
+            rotations = &predictedRotations;
+            translations = &predictedTranslations;
         }
 
-        // each joint rotation is stored in 6 bytes.
         QWriteLocker writeLock(&_jointDataLock);
-        _jointData.resize(numJoints);
+        _jointData.resize(decoded.numJoints);
 
-        const int COMPRESSED_QUATERNION_SIZE = 6;
-        PACKET_READ_CHECK(JointRotations, numValidJointRotations * COMPRESSED_QUATERNION_SIZE);
-        for (int i = 0; i < numJoints; i++) {
+        int rotationIndex = 0;
+        int translationIndex = 0;
+        for (int i = 0; i < decoded.numJoints; i++) {
             JointData& data = _jointData[i];
-            if (validRotations[i]) {
-                sourceBuffer += unpackOrientationQuatFromSixBytes(sourceBuffer, data.rotation);
-                _hasNewJointData = true;
+            if ((*validRotations)[i]) {
+                data.rotation = (*rotations)[rotationIndex++];
                 data.rotationIsDefaultPose = false;
-            }
-        }
-
-        PACKET_READ_CHECK(JointTranslationValidityBits, bytesOfValidity);
-
-        // get translation validity bits -- these indicate which translations were packed
-        int numValidJointTranslations = 0;
-        QVector<bool> validTranslations;
-        validTranslations.resize(numJoints);
-        { // translation validity bits
-            unsigned char validity = 0;
-            int validityBit = 0;
-            for (int i = 0; i < numJoints; i++) {
-                if (validityBit == 0) {
-                    validity = *sourceBuffer++;
-                }
-                bool valid = (bool)(validity & (1 << validityBit));
-                if (valid) {
-                    ++numValidJointTranslations;
-                }
-                validTranslations[i] = valid;
-                validityBit = (validityBit + 1) % BITS_IN_BYTE;
-            }
-        } // 1 + bytesOfValidity bytes
-
-        // each joint translation component is stored in 6 bytes.
-        const int COMPRESSED_TRANSLATION_SIZE = 6;
-        PACKET_READ_CHECK(JointTranslation, numValidJointTranslations * COMPRESSED_TRANSLATION_SIZE);
-
-        for (int i = 0; i < numJoints; i++) {
-            JointData& data = _jointData[i];
-            if (validTranslations[i]) {
-                sourceBuffer += unpackFloatVec3FromSignedTwoByteFixed(sourceBuffer, data.translation, TRANSLATION_COMPRESSION_RADIX);
                 _hasNewJointData = true;
-                data.translationIsDefaultPose = false;
             }
-        }
-
-#ifdef WANT_DEBUG
-        if (numValidJointRotations > 15) {
-            qCDebug(avatars) << "RECEIVING -- rotations:" << numValidJointRotations
-                << "translations:" << numValidJointTranslations
-                << "size:" << (int)(sourceBuffer - startPosition);
-        }
-#endif
-        // faux joints
-        sourceBuffer = unpackFauxJoint(sourceBuffer, _controllerLeftHandMatrixCache);
-        sourceBuffer = unpackFauxJoint(sourceBuffer, _controllerRightHandMatrixCache);
-
-        int numBytesRead = sourceBuffer - startSection;
-        _jointDataRate.increment(numBytesRead);
-        _jointDataUpdateRate.increment();
-
-        if (hasGrabJoints) {
-            auto startSection = sourceBuffer;
-
-            PACKET_READ_CHECK(FarGrabJoints, sizeof(AvatarDataPacket::FarGrabJoints));
-
-            AvatarDataPacket::FarGrabJoints farGrabJoints;
-            memcpy(&farGrabJoints, sourceBuffer, sizeof(farGrabJoints)); // to avoid misaligned floats
-
-            glm::vec3 leftFarGrabPosition = glm::vec3(farGrabJoints.leftFarGrabPosition[0],
-                                                      farGrabJoints.leftFarGrabPosition[1],
-                                                      farGrabJoints.leftFarGrabPosition[2]);
-            glm::quat leftFarGrabRotation = glm::quat(farGrabJoints.leftFarGrabRotation[0],
-                                                      farGrabJoints.leftFarGrabRotation[1],
-                                                      farGrabJoints.leftFarGrabRotation[2],
-                                                      farGrabJoints.leftFarGrabRotation[3]);
-            glm::vec3 rightFarGrabPosition = glm::vec3(farGrabJoints.rightFarGrabPosition[0],
-                                                       farGrabJoints.rightFarGrabPosition[1],
-                                                       farGrabJoints.rightFarGrabPosition[2]);
-            glm::quat rightFarGrabRotation = glm::quat(farGrabJoints.rightFarGrabRotation[0],
-                                                       farGrabJoints.rightFarGrabRotation[1],
-                                                       farGrabJoints.rightFarGrabRotation[2],
-                                                       farGrabJoints.rightFarGrabRotation[3]);
-            glm::vec3 mouseFarGrabPosition = glm::vec3(farGrabJoints.mouseFarGrabPosition[0],
-                                                       farGrabJoints.mouseFarGrabPosition[1],
-                                                       farGrabJoints.mouseFarGrabPosition[2]);
-            glm::quat mouseFarGrabRotation = glm::quat(farGrabJoints.mouseFarGrabRotation[0],
-                                                       farGrabJoints.mouseFarGrabRotation[1],
-                                                       farGrabJoints.mouseFarGrabRotation[2],
-                                                       farGrabJoints.mouseFarGrabRotation[3]);
-
-            _farGrabLeftMatrixCache.set(createMatFromQuatAndPos(leftFarGrabRotation, leftFarGrabPosition));
-            _farGrabRightMatrixCache.set(createMatFromQuatAndPos(rightFarGrabRotation, rightFarGrabPosition));
-            _farGrabMouseMatrixCache.set(createMatFromQuatAndPos(mouseFarGrabRotation, mouseFarGrabPosition));
-
-            sourceBuffer += sizeof(AvatarDataPacket::FarGrabJoints);
-            int numBytesRead = sourceBuffer - startSection;
-            _farGrabJointRate.increment(numBytesRead);
-            _farGrabJointUpdateRate.increment();
-        }
-    }
-
-    if (hasJointDefaultPoseFlags) {
-        auto startSection = sourceBuffer;
+            if ((*validTranslations)[i]) {
+                data.translation = (*translations)[translationIndex++];
+                data.translationIsDefaultPose = false;
+                _hasNewJointData = true;
+            }
+        }
 
-        QWriteLocker writeLock(&_jointDataLock);
+        _controllerLeftHandMatrixCache.set(decoded.controllerLeftHandMatrix);
+        _controllerRightHandMatrixCache.set(decoded.controllerRightHandMatrix);
 
-        PACKET_READ_CHECK(JointDefaultPoseFlagsNumJoints, sizeof(uint8_t));
-        int numJoints = (int)*sourceBuffer++;
+        _jointDataRate.increment(decoded.jointDataSize);
+        _jointDataUpdateRate.increment();
+    }
 
-        _jointData.resize(numJoints);
+    if (HAS_FLAG(decoded.flags, AvatarDataPacket::PACKET_HAS_GRAB_JOINTS)) {
+        _farGrabLeftMatrixCache.set(decoded.farGrabLeftMatrix);
+        _farGrabRightMatrixCache.set(decoded.farGrabRightMatrix);
+        _farGrabMouseMatrixCache.set(decoded.farGrabMouseMatrix);
 
-        size_t bitVectorSize = calcBitVectorSize(numJoints);
-        PACKET_READ_CHECK(JointDefaultPoseFlagsRotationFlags, bitVectorSize);
-        sourceBuffer += readBitVector(sourceBuffer, numJoints, [&](int i, bool value) {
-            _jointData[i].rotationIsDefaultPose = value;
-        });
+        _farGrabJointRate.increment(sizeof(AvatarDataPacket::FarGrabJoints));
+        _farGrabJointUpdateRate.increment();
+    }
 
-        PACKET_READ_CHECK(JointDefaultPoseFlagsTranslationFlags, bitVectorSize);
-        sourceBuffer += readBitVector(sourceBuffer, numJoints, [&](int i, bool value) {
-            _jointData[i].translationIsDefaultPose = value;
-        });
+    if (HAS_FLAG(decoded.flags, AvatarDataPacket::PACKET_HAS_JOINT_DEFAULT_POSE_FLAGS)) {
+        QWriteLocker writeLock(&_jointDataLock);
+        _jointData.resize(decoded.numDefaultPoseJoints);
+        for (int i = 0; i < decoded.numDefaultPoseJoints; i++) {
+            _jointData[i].rotationIsDefaultPose = decoded.rotationIsDefaultPose[i];
+            _jointData[i].translationIsDefaultPose = decoded.translationIsDefaultPose[i];
+        }
 
-        int numBytesRead = sourceBuffer - startSection;
-        _jointDefaultPoseFlagsRate.increment(numBytesRead);
+        _jointDefaultPoseFlagsRate.increment(decoded.jointDefaultPoseFlagsSize);
         _jointDefaultPoseFlagsUpdateRate.increment();
     }
 
-    int numBytesRead = sourceBuffer - startPosition;
-    _averageBytesReceived.updateAverage(numBytesRead);
+    if (!decoded.error.isEmpty()) {
+        if (shouldLogError(now)) {
+            qCWarning(avatars) << decoded.error << ", uuid " << getSessionUUID();
+        }
+        return;
+    }
+
+    _averageBytesReceived.updateAverage(decoded.numBytes);
 
-    _parseBufferRate.increment(numBytesRead);
+    _parseBufferRate.increment(decoded.numBytes);
     _parseBufferUpdateRate.increment();
+}
 
-    return numBytesRead;
+// read data in packet starting at byte offset and return number of bytes parsed
+int AvatarData::parseDataFromBuffer(const QByteArray& buffer) {
+    DecodedAvatarData decoded;
+    int bytesRead = decodeDataFromBuffer(buffer, decoded);
+    applyDecodedData(decoded);
+    return bytesRead;
 }
 
 float AvatarData::getDataRate(const QString& rateName) const {
@@ -2425,11 +2519,13 @@ void AvatarData::avatarEntityDataToJson(QJsonObject& root) const {
     // overridden where needed
 }
 
-QJsonObject AvatarData::toJson() const {
-    QJsonObject root;
-
-    root[JSON_AVATAR_VERSION] = (int)JsonAvatarFrameVersion::JointDefaultPoseBits;
+uint AvatarData::avatarEntityDataHash(uint seed) const {
+    // overridden where needed
+    return seed;
+}
 
+// The parts of a recorded frame that rarely change during a recording
+void AvatarData::recordingMetadataToJson(QJsonObject& root) const {
     if (!getSkeletonModelURL().isEmpty()) {
         root[JSON_AVATAR_BODY_MODEL] = getSkeletonModelURL().toString();
     }
@@ -2438,6 +2534,63 @@ QJsonObject AvatarData::toJson() const {
     }
 
     avatarEntityDataToJson(root);
+}
+
+// Cheap to compute every frame, a change in the hash means the metadata has to be written again
+uint AvatarData::recordingMetadataHash() const {
+    uint hash = qHash(getSkeletonModelURL().toString());
+    hash = qHash(getDisplayName(), hash);
+    return avatarEntityDataHash(hash);
+}
+
+void AvatarData::recordingMetadataFromJson(const QJsonObject& json, bool useFrameSkeleton) {
+    if (json.contains(JSON_AVATAR_BODY_MODEL)) {
+        auto bodyModelURL = json[JSON_AVATAR_BODY_MODEL].toString();
+        if (useFrameSkeleton && bodyModelURL != getSkeletonModelURL().toString()) {
+            setSkeletonModelURL(bodyModelURL);
+        }
+    }
+
+    QString newDisplayName = "";
+    if (json.contains(JSON_AVATAR_DISPLAY_NAME)) {
+        newDisplayName = json[JSON_AVATAR_DISPLAY_NAME].toString();
+    }
+    if (newDisplayName != getDisplayName()) {
+        setDisplayName(newDisplayName);
+    }
+
+    QVector<AttachmentData> attachments;
+    if (json.contains(JSON_AVATAR_ATTACHMENTS) && json[JSON_AVATAR_ATTACHMENTS].isArray()) {
+        QJsonArray attachmentsJson = json[JSON_AVATAR_ATTACHMENTS].toArray();
+        for (auto attachmentJson : attachmentsJson) {
+            AttachmentData attachment;
+            attachment.fromJson(attachmentJson.toObject());
+            attachments.push_back(attachment);
+        }
+    }
+    if (attachments != getAttachmentData()) {
+        setAttachmentData(attachments);
+    }
+
+    if (json.contains(JSON_AVATAR_ENTITIES) && json[JSON_AVATAR_ENTITIES].isArray()) {
+        QJsonArray attachmentsJson = json[JSON_AVATAR_ENTITIES].toArray();
+        for (auto attachmentJson : attachmentsJson) {
+            if (attachmentJson.isObject()) {
+                QVariantMap entityData = attachmentJson.toObject().toVariantMap();
+                QUuid id = entityData.value("id").toUuid();
+                QByteArray data = QByteArray::fromBase64(entityData.value("properties").toByteArray());
+                updateAvatarEntity(id, data);
+            }
+        }
+    }
+}
+
+QJsonObject AvatarData::toJson() const {
+    QJsonObject root;
+
+    root[JSON_AVATAR_VERSION] = (int)JsonAvatarFrameVersion::JointDefaultPoseBits;
+
+    recordingMetadataToJson(root);
 
     auto recordingBasis = getRecordingBasis();
     bool success;
@@ -2488,20 +2641,7 @@ void AvatarData::fromJson(const QJsonObject& json, bool useFrameSkeleton) {
         version = (int)JsonAvatarFrameVersion::JointRotationsInRelativeFrame;
     }
 
-    if (json.contains(JSON_AVATAR_BODY_MODEL)) {
-        auto bodyModelURL = json[JSON_AVATAR_BODY_MODEL].toString();
-        if (useFrameSkeleton && bodyModelURL != getSkeletonModelURL().toString()) {
-            setSkeletonModelURL(bodyModelURL);
-        }
-    }
-
-    QString newDisplayName = "";
-    if (json.contains(JSON_AVATAR_DISPLAY_NAME)) {
-        newDisplayName = json[JSON_AVATAR_DISPLAY_NAME].toString();
-    }
-    if (newDisplayName != getDisplayName()) {
-        setDisplayName(newDisplayName);
-    }
+    recordingMetadataFromJson(json, useFrameSkeleton);
 
     auto currentBasis = getRecordingBasis();
     if (!currentBasis) {
@@ -2541,31 +2681,6 @@ void AvatarData::fromJson(const QJsonObject& json, bool useFrameSkeleton) {
         setTargetScale((float)json[JSON_AVATAR_SCALE].toDouble());
     }
 
-    QVector<AttachmentData> attachments;
-    if (json.contains(JSON_AVATAR_ATTACHMENTS) && json[JSON_AVATAR_ATTACHMENTS].isArray()) {
-        QJsonArray attachmentsJson = json[JSON_AVATAR_ATTACHMENTS].toArray();
-        for (auto attachmentJson : attachmentsJson) {
-            AttachmentData attachment;
-            attachment.fromJson(attachmentJson.toObject());
-            attachments.push_back(attachment);
-        }
-    }
-    if (attachments != getAttachmentData()) {
-        setAttachmentData(attachments);
-    }
-
-    if (json.contains(JSON_AVATAR_ENTITIES) && json[JSON_AVATAR_ENTITIES].isArray()) {
-        QJsonArray attachmentsJson = json[JSON_AVATAR_ENTITIES].toArray();
-        for (auto attachmentJson : attachmentsJson) {
-            if (attachmentJson.isObject()) {
-                QVariantMap entityData = attachmentJson.toObject().toVariantMap();
-                QUuid id = entityData.value("id").toUuid();
-                QByteArray data = QByteArray::fromBase64(entityData.value("properties").toByteArray());
-                updateAvatarEntity(id, data);
-            }
-        }
-    }
-
     if (json.contains(JSON_AVATAR_JOINT_ARRAY)) {
         if (version == (int)JsonAvatarFrameVersion::JointRotationsInRelativeFrame) {
             // because we don't have the full joint hierarchy skeleton of the model,
@@ -2592,19 +2707,21 @@ void AvatarData::fromJson(const QJsonObject& json, bool useFrameSkeleton) {
 // transform at the start of playback, or relative to the transform of the recorded
 // avatar
 QByteArray AvatarData::toFrame(const AvatarData& avatar) {
-    QJsonObject root = avatar.toJson();
-#ifdef WANT_JSON_DEBUG
-    {
-        QJsonObject obj = root;
-        obj.remove(JSON_AVATAR_JOINT_ARRAY);
-        qCDebug(avatars).noquote() << QJsonDocument(obj).toJson(QJsonDocument::JsonFormat::Indented);
-    }
-#endif
-    return QJsonDocument(root).toBinaryData();
+    AvatarFrameCodec::EncoderState keyframeOnly;
+    return avatar.toCompactFrame(keyframeOnly);
 }
 
+QByteArray AvatarData::toFrame(const AvatarData& avatar, AvatarFrameCodec::EncoderState& encoderState) {
+    return avatar.toCompactFrame(encoderState);
+}
 
 void AvatarData::fromFrame(const QByteArray& frameData, AvatarData& result, bool useFrameSkeleton) {
+    if (AvatarFrameCodec::isCompactFrame(frameData)) {
+        result.fromCompactFrame(frameData, useFrameSkeleton);
+        return;
+    }
+
+    // recordings made before the compact frame format
     QJsonDocument doc = QJsonDocument::fromBinaryData(frameData);
 
 #ifdef WANT_JSON_DEBUG
@@ -2617,6 +2734,376 @@ void AvatarData::fromFrame(const QByteArray& frameData, AvatarData& result, bool
     result.fromJson(doc.object(), useFrameSkeleton);
 }
 
+static const int FRAME_TRANSFORM_SIZE = 10 * sizeof(float);
+static const int FRAME_BLENDSHAPE_RADIX = 14;
+
+static int packFrameTransform(unsigned char* buffer, const Transform& transform) {
+    const glm::vec3& translation = transform.getTranslation();
+    const glm::quat& rotation = transform.getRotation();
+    const glm::vec3& scale = transform.getScale();
+    float values[10] = { translation.x, translation.y, translation.z,
+                         rotation.x, rotation.y, rotation.z, rotation.w,
+                         scale.x, scale.y, scale.z };
+    memcpy(buffer, values, FRAME_TRANSFORM_SIZE);
+    return FRAME_TRANSFORM_SIZE;
+}
+
+static int unpackFrameTransform(const unsigned char* buffer, Transform& transform) {
+    float values[10];
+    memcpy(values, buffer, FRAME_TRANSFORM_SIZE);
+    transform.setTranslation(glm::vec3(values[0], values[1], values[2]));
+    transform.setRotation(glm::quat(values[6], values[3], values[4], values[5]));
+    transform.setScale(glm::vec3(values[7], values[8], values[9]));
+    return FRAME_TRANSFORM_SIZE;
+}
+
+QByteArray AvatarData::toCompactFrame(AvatarFrameCodec::EncoderState& encoderState) const {
+    using namespace AvatarFrameCodec;
+
+    const QVector<JointData>& joints = getRawJointData();
+    int numJoints = std::min(joints.size(), (int)UINT16_MAX);
+
+    bool isKeyframe = encoderState.keyframeInterval <= 1 || (encoderState.sequence % encoderState.keyframeInterval) == 0 ||
+        encoderState.lastJoints.size() != numJoints;
+
+    uint metadataHash = recordingMetadataHash();
+    bool hasMetadata = isKeyframe || metadataHash != encoderState.lastMetadataHash;
+    QByteArray metadata;
+    if (hasMetadata) {
+        QJsonObject metadataJson;
+        recordingMetadataToJson(metadataJson);
+        metadata = QJsonDocument(metadataJson).toBinaryData();
+    }
+
+    auto recordingBasis = getRecordingBasis();
+    bool success;
+    Transform avatarTransform = getTransform(success);
+    if (!success) {
+        qCWarning(avatars) << "Warning -- AvatarData::toCompactFrame couldn't get avatar transform";
+    }
+    avatarTransform.setScale(getDomainLimitedScale());
+    Transform relativeTransform = recordingBasis ? recordingBasis->relativeTransform(avatarTransform) : avatarTransform;
+    bool hasBasis = recordingBasis && isKeyframe;
+    bool hasRelative = !recordingBasis || !relativeTransform.isIdentity();
+
+    float scale = getDomainLimitedScale();
+    bool hasScale = scale != 1.0f;
+
+    const HeadData* head = getHeadData();
+    int numBlendshapes = 0;
+    if (head) {
+        numBlendshapes = std::min(head->getNumSummedBlendshapeCoefficients(), std::min(NUM_FACESHIFT_BLENDSHAPES, (int)UINT8_MAX));
+    }
+
+    int jointBitVectorSize = calcBitVectorSize(numJoints);
+    int maxSize = sizeof(Header) + (hasMetadata ? sizeof(uint32_t) + metadata.size() : 0) +
+        2 * FRAME_TRANSFORM_SIZE + sizeof(float) +
+        6 + 3 * sizeof(float) + sizeof(uint8_t) + numBlendshapes * sizeof(int16_t) +
+        4 * jointBitVectorSize + numJoints * (6 + 6);
+
+    QByteArray result(maxSize, 0);
+    unsigned char* destinationBuffer = reinterpret_cast<unsigned char*>(result.data());
+    unsigned char* startPosition = destinationBuffer;
+
+    Header* header = reinterpret_cast<Header*>(destinationBuffer);
+    header->magic = FRAME_MAGIC;
+    header->version = (uint8_t)Version::Current;
+    header->flags = (isKeyframe ? Keyframe : 0) | (hasMetadata ? HasMetadata : 0) | (hasBasis ? HasBasis : 0) |
+        (hasRelative ? HasRelative : 0) | (hasScale ? HasScale : 0) | (head ? HasHead : 0);
+    header->numJoints = (uint16_t)numJoints;
+    header->sequence = encoderState.sequence;
+    destinationBuffer += sizeof(Header);
+
+    if (hasMetadata) {
+        uint32_t metadataSize = metadata.size();
+        memcpy(destinationBuffer, &metadataSize, sizeof(metadataSize));
+        destinationBuffer += sizeof(metadataSize);
+        memcpy(destinationBuffer, metadata.constData(), metadataSize);
+        destinationBuffer += metadataSize;
+        encoderState.lastMetadataHash = metadataHash;
+    }
+
+    if (hasBasis) {
+        destinationBuffer += packFrameTransform(destinationBuffer, *recordingBasis);
+    }
+    if (hasRelative) {
+        destinationBuffer += packFrameTransform(destinationBuffer, relativeTransform);
+    }
+    if (hasScale) {
+        memcpy(destinationBuffer, &scale, sizeof(scale));
+        destinationBuffer += sizeof(scale);
+    }
+
+    if (head) {
+        destinationBuffer += packOrientationQuatToSixBytes(destinationBuffer, head->getRawOrientation());
+        glm::vec3 relativeLookAt;
+        if (head->getLookAtPosition() != glm::vec3()) {
+            relativeLookAt = glm::inverse(getWorldOrientation()) * (head->getLookAtPosition() - getWorldPosition());
+        }
+        memcpy(destinationBuffer, &relativeLookAt, sizeof(relativeLookAt));
+        destinationBuffer += sizeof(relativeLookAt);
+        *destinationBuffer++ = (uint8_t)numBlendshapes;
+        for (int i = 0; i < numBlendshapes; i++) {
+            float value = 0.0f;
+            if (i < head->_blendshapeCoefficients.size()) {
+                value += head->_blendshapeCoefficients[i];
+            }
+            if (i < head->_transientBlendshapeCoefficients.size()) {
+                value += head->_transientBlendshapeCoefficients[i];
+            }
+            destinationBuffer += packFloatScalarToSignedTwoByteFixed(destinationBuffer, value, FRAME_BLENDSHAPE_RADIX);
+        }
+    }
+
+    // Joints are quantized exactly as the avatar mixer protocol does.  Changes are detected on the quantized
+    // values, so a delta frame reproduces the encoder's view of the skeleton without accumulating error.
+    QVector<JointData>& lastJoints = encoderState.lastJoints;
+    lastJoints.resize(numJoints);
+
+    unsigned char packedRotation[6];
+    unsigned char* rotationChangedBits = destinationBuffer;
+    memset(rotationChangedBits, 0, jointBitVectorSize);
+    destinationBuffer += jointBitVectorSize;
+    destinationBuffer += writeBitVector(destinationBuffer, numJoints, [&](int i) {
+        return joints[i].rotationIsDefaultPose;
+    });
+    for (int i = 0; i < numJoints; i++) {
+        const JointData& data = joints[i];
+        JointData& last = lastJoints[i];
+        if (data.rotationIsDefaultPose) {
+            last.rotationIsDefaultPose = true;
+            continue;
+        }
+        packOrientationQuatToSixBytes(packedRotation, data.rotation);
+        glm::quat quantized;
+        unpackOrientationQuatFromSixBytes(packedRotation, quantized);
+        if (isKeyframe || last.rotationIsDefaultPose || quantized != last.rotation) {
+            rotationChangedBits[i / BITS_IN_BYTE] |= 1 << (i % BITS_IN_BYTE);
+            memcpy(destinationBuffer, packedRotation, sizeof(packedRotation));
+            destinationBuffer += sizeof(packedRotation);
+            last.rotation = quantized;
+        }
+        last.rotationIsDefaultPose = false;
+    }
+
+    unsigned char packedTranslation[6];
+    unsigned char* translationChangedBits = destinationBuffer;
+    memset(translationChangedBits, 0, jointBitVectorSize);
+    destinationBuffer += jointBitVectorSize;
+    destinationBuffer += writeBitVector(destinationBuffer, numJoints, [&](int i) {
+        return joints[i].translationIsDefaultPose;
+    });
+    for (int i = 0; i < numJoints; i++) {
+        const JointData& data = joints[i];
+        JointData& last = lastJoints[i];
+        if (data.translationIsDefaultPose) {
+            last.translationIsDefaultPose = true;
+            continue;
+        }
+        packFloatVec3ToSignedTwoByteFixed(packedTranslation, data.translation, TRANSLATION_COMPRESSION_RADIX);
+        glm::vec3 quantized;
+        unpackFloatVec3FromSignedTwoByteFixed(packedTranslation, quantized, TRANSLATION_COMPRESSION_RADIX);
+        if (isKeyframe || last.translationIsDefaultPose || quantized != last.translation) {
+            translationChangedBits[i / BITS_IN_BYTE] |= 1 << (i % BITS_IN_BYTE);
+            memcpy(destinationBuffer, packedTranslation, sizeof(packedTranslation));
+            destinationBuffer += sizeof(packedTranslation);
+            last.translation = quantized;
+        }
+        last.translationIsDefaultPose = false;
+    }
+
+    encoderState.sequence++;
+
+    int size = (int)(destinationBuffer - startPosition);
+    assert(size <= maxSize);
+    result.resize(size);
+    return result;
+}
+
+void AvatarData::fromCompactFrame(const QByteArray& frameData, bool useFrameSkeleton) {
+    using namespace AvatarFrameCodec;
+
+    const unsigned char* sourceBuffer = reinterpret_cast<const unsigned char*>(frameData.constData());
+    const unsigned char* endPosition = sourceBuffer + frameData.size();
+
+    auto checkSize = [&](int bytes) {
+        if (endPosition - sourceBuffer < bytes) {
+            quint64 now = usecTimestampNow();
+            if (shouldLogError(now)) {
+                qCWarning(avatars) << "Truncated avatar recording frame of" << frameData.size() << "bytes";
+            }
+            _recordingFrameDecoder.reset();
+            return false;
+        }
+        return true;
+    };
+
+    Header header;
+    memcpy(&header, sourceBuffer, sizeof(Header));
+    sourceBuffer += sizeof(Header);
+    if (header.version > (uint8_t)Version::Current) {
+        quint64 now = usecTimestampNow();
+        if (shouldLogError(now)) {
+            qCWarning(avatars) << "Unsupported avatar recording frame version" << header.version;
+        }
+        return;
+    }
+
+    DecoderState& decoder = _recordingFrameDecoder;
+    bool isKeyframe = header.flags & Keyframe;
+    int numJoints = header.numJoints;
+    if (isKeyframe) {
+        decoder.valid = true;
+        decoder.joints.resize(numJoints);
+
+        // a seek replays from this keyframe, blendshapes it doesn't set must not keep their values from before the seek
+        if (_headData) {
+            _headData->_blendshapeCoefficients.fill(0.0f);
+            _headData->_transientBlendshapeCoefficients.fill(0.0f);
+        }
+    } else if (!decoder.valid || header.sequence != decoder.lastSequence + 1 || decoder.joints.size() != numJoints) {
+        // We joined the stream mid-way.  The deck replays a seek from the preceding keyframe, so this only
+        // happens when frames were dropped; changed joints are applied on top of the current pose until the
+        // next keyframe restores the exact pose.
+        decoder.valid = false;
+        decoder.joints.resize(numJoints);
+    }
+    decoder.lastSequence = header.sequence;
+
+    if (header.flags & HasMetadata) {
+        if (!checkSize((int)sizeof(uint32_t))) {
+            return;
+        }
+        uint32_t metadataSize;
+        memcpy(&metadataSize, sourceBuffer, sizeof(metadataSize));
+        sourceBuffer += sizeof(metadataSize);
+        if (!checkSize((int)metadataSize)) {
+            return;
+        }
+        QJsonDocument metadata = QJsonDocument::fromBinaryData(
+            QByteArray::fromRawData(reinterpret_cast<const char*>(sourceBuffer), metadataSize));
+        sourceBuffer += metadataSize;
+        recordingMetadataFromJson(metadata.object(), useFrameSkeleton);
+    }
+
+    if (header.flags & HasBasis) {
+        if (!checkSize(FRAME_TRANSFORM_SIZE)) {
+            return;
+        }
+        decoder.basis = std::make_shared<Transform>();
+        sourceBuffer += unpackFrameTransform(sourceBuffer, *decoder.basis);
+    }
+
+    // See AvatarData::fromJson for how the recording basis is chosen
+    auto currentBasis = getRecordingBasis();
+    if (!currentBasis) {
+        currentBasis = decoder.basis ? decoder.basis : std::make_shared<Transform>();
+    }
+
+    glm::quat orientation;
+    if (header.flags & HasRelative) {
+        if (!checkSize(FRAME_TRANSFORM_SIZE)) {
+            return;
+        }
+        Transform relativeTransform;
+        sourceBuffer += unpackFrameTransform(sourceBuffer, relativeTransform);
+        auto worldTransform = currentBasis->worldTransform(relativeTransform);
+        setWorldPosition(worldTransform.getTranslation());
+        orientation = worldTransform.getRotation();
+    } else {
+        setWorldPosition(currentBasis->getTranslation());
+        orientation = currentBasis->getRotation();
+    }
+    setWorldOrientation(orientation);
+    updateAttitude(orientation);
+
+    if (header.flags & HasScale) {
+        if (!checkSize((int)sizeof(float))) {
+            return;
+        }
+        float scale;
+        memcpy(&scale, sourceBuffer, sizeof(scale));
+        sourceBuffer += sizeof(scale);
+        setTargetScale(scale);
+    }
+
+    // Do after avatar orientation because head look-at needs avatar orientation.
+    if (header.flags & HasHead) {
+        if (!checkSize(6 + (int)sizeof(glm::vec3) + (int)sizeof(uint8_t))) {
+            return;
+        }
+        if (!_headData) {
+            _headData = new HeadData(this);
+        }
+        glm::quat headOrientation;
+        sourceBuffer += unpackOrientationQuatFromSixBytes(sourceBuffer, headOrientation);
+        glm::vec3 relativeLookAt;
+        memcpy(&relativeLookAt, sourceBuffer, sizeof(relativeLookAt));
+        sourceBuffer += sizeof(relativeLookAt);
+        int numBlendshapes = *sourceBuffer++;
+        if (!checkSize(numBlendshapes * (int)sizeof(int16_t))) {
+            return;
+        }
+
+        auto& coefficients = _headData->_blendshapeCoefficients;
+        if (coefficients.size() < numBlendshapes) {
+            coefficients.resize(numBlendshapes);
+        }
+        if (_headData->_transientBlendshapeCoefficients.size() < numBlendshapes) {
+            _headData->_transientBlendshapeCoefficients.resize(numBlendshapes);
+        }
+        for (int i = 0; i < numBlendshapes; i++) {
+            sourceBuffer += unpackFloatScalarFromSignedTwoByteFixed(reinterpret_cast<const int16_t*>(sourceBuffer),
+                &coefficients[i], FRAME_BLENDSHAPE_RADIX);
+        }
+
+        if (glm::length2(relativeLookAt) > 0.01f) {
+            _headData->setLookAtPosition((getWorldOrientation() * relativeLookAt) + getWorldPosition());
+        }
+        _headData->setHeadOrientation(headOrientation);
+    }
+
+    QVector<JointData>& joints = decoder.joints;
+    int jointBitVectorSize = calcBitVectorSize(numJoints);
+
+    if (!checkSize(2 * jointBitVectorSize)) {
+        return;
+    }
+    const unsigned char* rotationChangedBits = sourceBuffer;
+    sourceBuffer += jointBitVectorSize;
+    sourceBuffer += readBitVector(sourceBuffer, numJoints, [&](int i, bool value) {
+        joints[i].rotationIsDefaultPose = value;
+    });
+    for (int i = 0; i < numJoints; i++) {
+        if (rotationChangedBits[i / BITS_IN_BYTE] & (1 << (i % BITS_IN_BYTE))) {
+            if (!checkSize(6)) {
+                return;
+            }
+            sourceBuffer += unpackOrientationQuatFromSixBytes(sourceBuffer, joints[i].rotation);
+        }
+    }
+
+    if (!checkSize(2 * jointBitVectorSize)) {
+        return;
+    }
+    const unsigned char* translationChangedBits = sourceBuffer;
+    sourceBuffer += jointBitVectorSize;
+    sourceBuffer += readBitVector(sourceBuffer, numJoints, [&](int i, bool value) {
+        joints[i].translationIsDefaultPose = value;
+    });
+    for (int i = 0; i < numJoints; i++) {
+        if (translationChangedBits[i / BITS_IN_BYTE] & (1 << (i % BITS_IN_BYTE))) {
+            if (!checkSize(6)) {
+                return;
+            }
+            sourceBuffer += unpackFloatVec3FromSignedTwoByteFixed(sourceBuffer, joints[i].translation,
+                TRANSLATION_COMPRESSION_RADIX);
+        }
+    }
+
+    setRawJointData(joints);
+}
+
 float AvatarData::getBodyYaw() const {
     glm::vec3 eulerAngles = glm::degrees(safeEulerAngles(getWorldOrientation()));
     return eulerAngles.y;
@@ -51,6 +51,8 @@
 #include <udt/SequenceNumber.h>
 
 #include "AABox.h"
+#include "AvatarFrameCodec.h"
+#include "AvatarJointCodec.h"
 #include "AvatarTraits.h"
 #include "HeadData.h"
 #include "PathUtils.h"
@@ -150,6 +152,7 @@ namespace AvatarDataPacket {
     const HasFlags PACKET_HAS_JOINT_DATA               = 1U << 11;
     const HasFlags PACKET_HAS_JOINT_DEFAULT_POSE_FLAGS = 1U << 12;
     const HasFlags PACKET_HAS_GRAB_JOINTS              = 1U << 13;
+    const HasFlags PACKET_HAS_PREDICTED_JOINTS         = 1U << 14; // joint data is encoded by AvatarJointCodec
     const size_t AVATAR_HAS_FLAGS_SIZE = 2;
 
     using SixByteQuat = uint8_t[6];
@@ -284,6 +287,19 @@ namespace AvatarDataPacket {
         SixByteQuat rightHandControllerRotation;
         SixByteTrans rightHandControllerTranslation;
     };
+
+    // with PACKET_HAS_PREDICTED_JOINTS
+    struct PredictedJointData {
+        uint8_t numJoints;
+        uint8_t rotationValidityBits[ceil(numJoints / 8)];
+        uint8_t translationValidityBits[ceil(numJoints / 8)];
+        uint8_t predictedJoints[];                             // see AvatarJointCodec.h
+
+        SixByteQuat leftHandControllerRotation;
+        SixByteTrans leftHandControllerTranslation;
+        SixByteQuat rightHandControllerRotation;
+        SixByteTrans rightHandControllerTranslation;
+    };
     */
     size_t maxJointDataSize(size_t numJoints, bool hasGrabJoints);
 
@@ -319,6 +335,50 @@ namespace AvatarDataPacket {
     };
 }
 
+// The data of one avatar in an AvatarData packet, decoded without touching the avatar so that bulk packets can be decoded
+// away from the thread that owns the avatars.  AvatarData::applyDecodedData applies it to an avatar.
+struct DecodedAvatarData {
+    AvatarDataPacket::HasFlags flags { 0 }; // the sections that were decoded
+    int numBytes { 0 };
+    QString error; // set if the data was bad, the sections decoded before it are still applied
+
+    glm::vec3 globalPosition;
+    glm::vec3 boundingBoxDimensions;
+    glm::vec3 boundingBoxOffset;
+    glm::quat orientation;
+    float scale { 1.0f };
+    glm::vec3 lookAtPosition;
+    float audioLoudness { 0.0f };
+    glm::mat4 sensorToWorldMatrix;
+    uint16_t additionalFlags { 0 };
+    QUuid parentID;
+    uint16_t parentJointIndex { 0 };
+    glm::vec3 localPosition;
+    QVector<float> blendshapeCoefficients;
+    int faceTrackerSize { 0 };
+
+    // rotations and translations only hold the valid ones, in joint order
+    int numJoints { 0 };
+    std::vector<uint8_t> validRotations;
+    std::vector<uint8_t> validTranslations;
+    std::vector<glm::quat> rotations;
+    std::vector<glm::vec3> translations;
+    // with PACKET_HAS_PREDICTED_JOINTS the valid joints are in here instead, they depend on what the avatar received before
+    AvatarJointCodec::EncodedJoints predictedJoints;
+    glm::mat4 controllerLeftHandMatrix;
+    glm::mat4 controllerRightHandMatrix;
+    int jointDataSize { 0 };
+
+    glm::mat4 farGrabLeftMatrix;
+    glm::mat4 farGrabRightMatrix;
+    glm::mat4 farGrabMouseMatrix;
+
+    int numDefaultPoseJoints { 0 };
+    std::vector<uint8_t> rotationIsDefaultPose;
+    std::vector<uint8_t> translationIsDefaultPose;
+    int jointDefaultPoseFlagsSize { 0 };
+};
+
 const float MAX_AUDIO_LOUDNESS = 1000.0f; // close enough for mouth animation
 
 // See also static AvatarData::defaultFullAvatarModelUrl().
@@ -457,8 +517,12 @@ public:
 
     static const QString FRAME_NAME;
 
+    // Reads both the compact binary frames and the QJsonDocument frames of older recordings.
     static void fromFrame(const QByteArray& frameData, AvatarData& avatar, bool useFrameSkeleton = true);
+    // Writes a self contained keyframe.
     static QByteArray toFrame(const AvatarData& avatar);
+    // Writes a frame delta encoded against the previous frame written with the same encoder state.
+    static QByteArray toFrame(const AvatarData& avatar, AvatarFrameCodec::EncoderState& encoderState);
 
     AvatarData();
     virtual ~AvatarData();
@@ -485,7 +549,8 @@ public:
 
     virtual QByteArray toByteArray(AvatarDataDetail dataDetail, quint64 lastSentTime, const QVector<JointData>& lastSentJointData,
         AvatarDataPacket::SendStatus& sendStatus, bool dropFaceTracking, bool distanceAdjust, glm::vec3 viewerPosition,
-        QVector<JointData>* sentJointDataOut, int maxDataSize = 0, AvatarDataRate* outboundDataRateOut = nullptr) const;
+        QVector<JointData>* sentJointDataOut, int maxDataSize = 0, AvatarDataRate* outboundDataRateOut = nullptr,
+        AvatarJointCodec::History* jointHistory = nullptr) const;
 
     virtual void doneEncoding(bool cullSmallChanges);
 
@@ -495,7 +560,14 @@ public:
     /// \param packet byte array of data
     /// \param offset number of bytes into packet where data starts
     /// \return number of bytes parsed
-    virtual int parseDataFromBuffer(const QByteArray& buffer);
+    int parseDataFromBuffer(const QByteArray& buffer);
+
+    /// Decodes the data of one avatar without touching any avatar, this is safe to call from any thread
+    /// \return number of bytes parsed
+    static int decodeDataFromBuffer(const QByteArray& buffer, DecodedAvatarData& decoded);
+
+    /// Applies data returned by decodeDataFromBuffer to this avatar
+    virtual void applyDecodedData(const DecodedAvatarData& decoded);
 
     // Body Rotation (degrees)
     float getBodyYaw() const;
@@ -1130,6 +1202,8 @@ public:
     void setRecordingBasis(TransformPointer recordingBasis = TransformPointer());
     void createRecordingIDs();
     virtual void avatarEntityDataToJson(QJsonObject& root) const;
+    // Combines seed with a hash of the avatar entities written by avatarEntityDataToJson
+    virtual uint avatarEntityDataHash(uint seed) const;
     QJsonObject toJson() const;
     void fromJson(const QJsonObject& json, bool useFrameSkeleton = true);
 
@@ -1337,6 +1411,12 @@ public slots:
     void resetLastSent() { _lastToByteArray = 0; }
 
 protected:
+    void recordingMetadataToJson(QJsonObject& root) const;
+    uint recordingMetadataHash() const;
+    void recordingMetadataFromJson(const QJsonObject& json, bool useFrameSkeleton);
+    QByteArray toCompactFrame(AvatarFrameCodec::EncoderState& encoderState) const;
+    void fromCompactFrame(const QByteArray& frameData, bool useFrameSkeleton);
+
     void insertRemovedEntityID(const QUuid entityID);
     void lazyInitHeadData() const;
 
@@ -1407,6 +1487,8 @@ protected:
     // During recording, this holds the starting position, orientation & scale of the recorded avatar
     // During playback, it holds the origin from which to play the relative positions in the clip
     TransformPointer _recordingBasis;
+    AvatarFrameCodec::DecoderState _recordingFrameDecoder;
+    AvatarJointCodec::History _receivedJointHistory;
 
     // _globalPosition is sent along with localPosition + parent because the avatar-mixer doesn't know
     // where Entities are located.  This is currently only used by the mixer to decide how often to send
@@ -0,0 +1,69 @@
+//
+//  AvatarDataDecoder.cpp
+//  libraries/avatars/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AvatarDataDecoder.h"
+
+#include <NodeList.h>
+#include <Profile.h>
+#include <ThreadHelpers.h>
+
+void AvatarDataDecoder::start() {
+    moveToNewNamedThread(this, "AvatarDataDecoder");
+
+    // the packet receiver queues the packets to the thread we now live on
+    auto& packetReceiver = DependencyManager::get<NodeList>()->getPacketReceiver();
+    packetReceiver.registerListener(PacketType::BulkAvatarData, this, "processAvatarDataPacket");
+    packetReceiver.registerListener(PacketType::KillAvatar, this, "processKillAvatar");
+}
+
+void AvatarDataDecoder::takeDecodedData(Entries& entries) {
+    entries.clear();
+    std::lock_guard<std::mutex> lock(_mutex);
+    std::swap(entries, _decoded);
+}
+
+void AvatarDataDecoder::append(Entries& entries) {
+    bool wasEmpty;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        wasEmpty = _decoded.empty();
+        _decoded.insert(_decoded.end(), std::make_move_iterator(entries.begin()), std::make_move_iterator(entries.end()));
+    }
+    if (wasEmpty) {
+        emit dataDecoded();
+    }
+}
+
+void AvatarDataDecoder::processAvatarDataPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode) {
+    DETAILED_PROFILE_RANGE(network, __FUNCTION__);
+
+    // enumerate over all of the avatars in this packet
+    Entries entries;
+    while (message->getBytesLeftToRead()) {
+        Entry entry;
+        entry.sessionUUID = QUuid::fromRfc4122(message->readWithoutCopy(NUM_BYTES_RFC4122_UUID));
+        entry.sendingNode = sendingNode;
+
+        int positionBeforeRead = message->getPosition();
+        QByteArray byteArray = message->readWithoutCopy(message->getBytesLeftToRead());
+        int bytesRead = AvatarData::decodeDataFromBuffer(byteArray, entry.data);
+        message->seek(positionBeforeRead + bytesRead);
+
+        entries.push_back(std::move(entry));
+    }
+    append(entries);
+}
+
+void AvatarDataDecoder::processKillAvatar(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode) {
+    Entries entries(1);
+    entries.back().sendingNode = sendingNode;
+    entries.back().killMessage = message;
+    append(entries);
+}
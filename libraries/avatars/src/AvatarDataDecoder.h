@@ -0,0 +1,63 @@
+//
+//  AvatarDataDecoder.h
+//  libraries/avatars/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AvatarDataDecoder_h
+#define hifi_AvatarDataDecoder_h
+
+#include <mutex>
+#include <vector>
+
+#include <QtCore/QObject>
+#include <QtCore/QSharedPointer>
+
+#include <Node.h>
+#include <ReceivedMessage.h>
+
+#include "AvatarData.h"
+
+// Decodes BulkAvatarData packets on its own thread.  The decoded data is added to a back buffer that the thread owning
+// the avatars swaps out and applies, once per frame or whenever dataDecoded is emitted.  KillAvatar packets go through
+// the same buffer so that they are applied in the order they were received.
+class AvatarDataDecoder : public QObject {
+    Q_OBJECT
+
+public:
+    struct Entry {
+        QUuid sessionUUID;
+        SharedNodePointer sendingNode;
+        DecodedAvatarData data;
+        QSharedPointer<ReceivedMessage> killMessage; // set for KillAvatar packets instead of data
+    };
+    using Entries = std::vector<Entry>;
+
+    // Moves the decoder to a new thread and registers it for the packets it decodes.  Its thread quits once the
+    // decoder is released with deleteLater.
+    void start();
+
+    // Hands over everything decoded since the last call, in the order it was received.
+    // The entries that are passed in are cleared and reused as the next back buffer.
+    void takeDecodedData(Entries& entries);
+
+signals:
+    // Emitted when data is decoded into an empty back buffer
+    void dataDecoded();
+
+private slots:
+    void processAvatarDataPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode);
+    void processKillAvatar(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode);
+
+private:
+    void append(Entries& entries);
+
+    std::mutex _mutex;
+    Entries _decoded;
+};
+
+#endif // hifi_AvatarDataDecoder_h
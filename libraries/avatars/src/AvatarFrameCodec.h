@@ -0,0 +1,121 @@
+//
+//  AvatarFrameCodec.h
+//  libraries/avatars/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AvatarFrameCodec_h
+#define hifi_AvatarFrameCodec_h
+
+#include <cstring>
+#include <memory>
+#include <stdint.h>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QVector>
+
+#include <JointData.h>
+#include <Transform.h>
+
+// Binary encoding for recorded avatar frames.
+//
+// Older recordings store every avatar frame as a QJsonDocument binary blob; those are still read by
+// AvatarData::fromFrame.  New recordings use the layout below, which quantizes joint data the same way
+// the avatar mixer protocol does and only stores the joints that changed since the previous frame.
+// Every KEYFRAME_INTERVAL frames a full keyframe is written so that playback can recover after a seek.
+//
+//    Header header;
+//    [uint32_t metadataSize; char metadata[metadataSize]]  // if HasMetadata, QJsonDocument binary data
+//    [float basis[10]]                                      // if HasBasis, translation, rotation, scale
+//    [float relative[10]]                                   // if HasRelative
+//    [float scale]                                          // if HasScale
+//    [SixByteQuat headRotation; float headLookAt[3];
+//     uint8_t numBlendshapes; int16_t blendshapes[numBlendshapes]]   // if HasHead
+//    uint8_t rotationChangedBits[ceil(numJoints / 8)];
+//    uint8_t rotationIsDefaultBits[ceil(numJoints / 8)];
+//    SixByteQuat rotations[numChangedRotations];
+//    uint8_t translationChangedBits[ceil(numJoints / 8)];
+//    uint8_t translationIsDefaultBits[ceil(numJoints / 8)];
+//    SixByteTrans translations[numChangedTranslations];
+//
+namespace AvatarFrameCodec {
+
+// 'HFAF' -- never collides with the 'qbjs' tag at the start of QJsonDocument binary data
+const uint32_t FRAME_MAGIC = 0x46414648;
+
+enum class Version : uint8_t {
+    Initial = 1,
+    Current = Initial
+};
+
+enum Flags : uint8_t {
+    Keyframe = 1 << 0,
+    HasMetadata = 1 << 1,
+    HasBasis = 1 << 2,
+    HasRelative = 1 << 3,
+    HasScale = 1 << 4,
+    HasHead = 1 << 5
+};
+
+#pragma pack(push, 1)
+struct Header {
+    uint32_t magic;
+    uint8_t version;
+    uint8_t flags;
+    uint16_t numJoints;
+    uint32_t sequence;
+};
+#pragma pack(pop)
+
+const uint32_t DEFAULT_KEYFRAME_INTERVAL = 90; // 1.5 seconds at the 60Hz avatar simulation rate
+
+// Per recording state kept by the writer, so that each frame can be encoded against the previous one.
+class EncoderState {
+public:
+    void reset() { *this = EncoderState(); }
+
+    uint32_t keyframeInterval { DEFAULT_KEYFRAME_INTERVAL };
+    uint32_t sequence { 0 };
+    // hash of the metadata last written, see AvatarData::recordingMetadataHash
+    uint lastMetadataHash { 0 };
+    // joint data as it will be seen by the decoder, i.e. after quantization
+    QVector<JointData> lastJoints;
+};
+
+// Per avatar state kept by the reader; delta frames are applied on top of it.
+class DecoderState {
+public:
+    void reset() { *this = DecoderState(); }
+
+    bool valid { false };
+    uint32_t lastSequence { 0 };
+    std::shared_ptr<Transform> basis;
+    QVector<JointData> joints;
+};
+
+inline bool isCompactFrame(const QByteArray& frameData) {
+    if (frameData.size() < (int)sizeof(Header)) {
+        return false;
+    }
+    uint32_t magic;
+    memcpy(&magic, frameData.constData(), sizeof(magic));
+    return magic == FRAME_MAGIC;
+}
+
+// Frames of older recordings are self contained, so they count as keyframes.
+inline bool isKeyframe(const QByteArray& frameData) {
+    if (!isCompactFrame(frameData)) {
+        return true;
+    }
+    Header header;
+    memcpy(&header, frameData.constData(), sizeof(Header));
+    return (header.flags & Keyframe) != 0;
+}
+
+}
+
+#endif // hifi_AvatarFrameCodec_h
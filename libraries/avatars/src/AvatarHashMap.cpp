@@ -51,11 +51,11 @@ std::vector<QUuid> AvatarReplicas::getReplicaIDs(const QUuid& parentID) {
     return ids;
 }
 
-void AvatarReplicas::parseDataFromBuffer(const QUuid& parentID, const QByteArray& buffer) {
+void AvatarReplicas::applyDecodedData(const QUuid& parentID, const DecodedAvatarData& decoded) {
     if (_replicasMap.find(parentID) != _replicasMap.end()) {
         auto &replicas = _replicasMap[parentID];
         for (auto avatar : replicas) {
-            avatar->parseDataFromBuffer(buffer);
+            avatar->applyDecodedData(decoded);
         }
     }
 }
@@ -117,12 +117,17 @@ void AvatarReplicas::processTraitInstance(const QUuid& parentID, AvatarTraits::T
     }
 }
 
-AvatarHashMap::AvatarHashMap() {
+AvatarHashMap::AvatarHashMap(bool appliesDecodedDataPerFrame) {
     auto nodeList = DependencyManager::get<NodeList>();
 
+    // bulk avatar data is decoded on its own thread, kills go through the same queue so they stay ordered with the data
+    _decoder = new AvatarDataDecoder();
+    if (!appliesDecodedDataPerFrame) {
+        connect(_decoder, &AvatarDataDecoder::dataDecoded, this, &AvatarHashMap::applyDecodedAvatarData, Qt::QueuedConnection);
+    }
+    _decoder->start();
+
     auto& packetReceiver = nodeList->getPacketReceiver();
-    packetReceiver.registerListener(PacketType::BulkAvatarData, this, "processAvatarDataPacket");
-    packetReceiver.registerListener(PacketType::KillAvatar, this, "processKillAvatar");
     packetReceiver.registerListener(PacketType::AvatarIdentity, this, "processAvatarIdentityPacket");
     packetReceiver.registerListener(PacketType::BulkAvatarTraits, this, "processBulkAvatarTraits");
 
@@ -135,6 +140,10 @@ AvatarHashMap::AvatarHashMap() {
     });
 }
 
+AvatarHashMap::~AvatarHashMap() {
+    _decoder->deleteLater();
+}
+
 QVector<QUuid> AvatarHashMap::getAvatarIdentifiers() {
     QReadLocker locker(&_hashLock);
     return _avatarHash.keys().toVector();
@@ -251,6 +260,15 @@ AvatarSharedPointer AvatarHashMap::parseAvatarData(QSharedPointer<ReceivedMessag
 
     QByteArray byteArray = message->readWithoutCopy(message->getBytesLeftToRead());
 
+    DecodedAvatarData decoded;
+    int bytesRead = AvatarData::decodeDataFromBuffer(byteArray, decoded);
+    message->seek(positionBeforeRead + bytesRead);
+
+    return applyAvatarData(sessionUUID, sendingNode, decoded);
+}
+
+AvatarSharedPointer AvatarHashMap::applyAvatarData(const QUuid& sessionUUID, const SharedNodePointer& sendingNode,
+                                                   const DecodedAvatarData& decoded) {
     // make sure this isn't our own avatar data or for a previously ignored node
     auto nodeList = DependencyManager::get<NodeList>();
     bool isNewAvatar;
@@ -268,22 +286,32 @@ AvatarSharedPointer AvatarHashMap::parseAvatarData(QSharedPointer<ReceivedMessag
             }
         } 
         
-        // have the matching (or new) avatar parse the data from the packet
-        int bytesRead = avatar->parseDataFromBuffer(byteArray);
-        message->seek(positionBeforeRead + bytesRead);
-        _replicas.parseDataFromBuffer(sessionUUID, byteArray);
-        
+        // have the matching (or new) avatar apply the data decoded from the packet
+        avatar->applyDecodedData(decoded);
+        _replicas.applyDecodedData(sessionUUID, decoded);
 
         return avatar;
     } else {
-        // create a dummy AvatarData class to throw this data on the ground
-        AvatarData dummyData;
-        int bytesRead = dummyData.parseDataFromBuffer(byteArray);
-        message->seek(positionBeforeRead + bytesRead);
+        // the data was already decoded, it is simply dropped
         return std::make_shared<AvatarData>();
     }
 }
 
+void AvatarHashMap::applyDecodedAvatarData() {
+    DETAILED_PROFILE_RANGE(network, __FUNCTION__);
+    PerformanceTimer perfTimer("receiveAvatar");
+
+    // swap the decoder's back buffer for ours, the entries we applied last time are reused for its next batch
+    _decoder->takeDecodedData(_decodedEntries);
+    for (const auto& entry : _decodedEntries) {
+        if (entry.killMessage) {
+            processKillAvatar(entry.killMessage, entry.sendingNode);
+        } else {
+            applyAvatarData(entry.sessionUUID, entry.sendingNode, entry.data);
+        }
+    }
+}
+
 void AvatarHashMap::processAvatarIdentityPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode) {
     QDataStream avatarIdentityStream(message->getMessage());
 
@@ -463,9 +491,16 @@ void AvatarHashMap::sessionUUIDChanged(const QUuid& sessionUUID, const QUuid& ol
     emit avatarSessionChangedEvent(sessionUUID, oldUUID);
 }
 
+void AvatarHashMap::discardDecodedAvatarData() {
+    _decoder->takeDecodedData(_decodedEntries);
+    _decodedEntries.clear();
+}
+
 void AvatarHashMap::clearOtherAvatars() {
     QList<AvatarSharedPointer> removedAvatars;
 
+    discardDecodedAvatarData();
+
     {
         QWriteLocker locker(&_hashLock);
 
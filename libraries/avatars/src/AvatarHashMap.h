@@ -30,6 +30,7 @@
 #include "ScriptAvatarData.h"
 
 #include "AvatarData.h"
+#include "AvatarDataDecoder.h"
 #include "AssociatedTraitValues.h"
 
 /**jsdoc
@@ -46,7 +47,7 @@ public:
     AvatarReplicas() {}
     void addReplica(const QUuid& parentID, AvatarSharedPointer replica);
     std::vector<QUuid> getReplicaIDs(const QUuid& parentID);
-    void parseDataFromBuffer(const QUuid& parentID, const QByteArray& buffer);
+    void applyDecodedData(const QUuid& parentID, const DecodedAvatarData& decoded);
     void processAvatarIdentity(const QUuid& parentID, const QByteArray& identityData, bool& identityChanged, bool& displayNameChanged);
     void removeReplicas(const QUuid& parentID);
     std::vector<AvatarSharedPointer> takeReplicas(const QUuid& parentID);
@@ -104,6 +105,10 @@ public:
 
     virtual void clearOtherAvatars();
 
+    // Applies the avatar data decoded off the main thread since the last call, called once per frame by the interface
+    // and whenever new data is decoded by the other users
+    void applyDecodedAvatarData();
+
 signals:
 
     /**jsdoc
@@ -176,9 +181,16 @@ protected slots:
     void processKillAvatar(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode);
 
 protected:
-    AvatarHashMap();
+    // Users calling applyDecodedAvatarData() once per frame pass true,
+    // otherwise the data is applied each time the decoder has new data
+    AvatarHashMap(bool appliesDecodedDataPerFrame = false);
+    virtual ~AvatarHashMap();
 
     virtual AvatarSharedPointer parseAvatarData(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode);
+    AvatarSharedPointer applyAvatarData(const QUuid& sessionUUID, const SharedNodePointer& sendingNode,
+        const DecodedAvatarData& decoded);
+    // Drops the decoded data that was not applied yet, anything still queued came from the avatars being cleared
+    void discardDecodedAvatarData();
     virtual AvatarSharedPointer newSharedAvatar();
     virtual AvatarSharedPointer addAvatar(const QUuid& sessionUUID, const QWeakPointer<Node>& mixerWeakPointer);
     AvatarSharedPointer newOrExistingAvatar(const QUuid& sessionUUID, const QWeakPointer<Node>& mixerWeakPointer,
@@ -196,6 +208,9 @@ protected:
 
 private:
     QUuid _lastOwnerSessionUUID;
+
+    AvatarDataDecoder* _decoder { nullptr };
+    AvatarDataDecoder::Entries _decodedEntries;
 };
 
 #endif // hifi_AvatarHashMap_h
@@ -0,0 +1,612 @@
+//
+//  AvatarJointCodec.cpp
+//  libraries/avatars/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AvatarJointCodec.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include <GLMHelpers.h>
+
+using namespace AvatarJointCodec;
+
+static const int ROTATION_COMPONENT_BITS = 15;
+static const int32_t MAX_ROTATION_COMPONENT = (1 << ROTATION_COMPONENT_BITS) - 1;
+static const int PREDICTION_BITS = 2;
+static const int MAX_GOLOMB_ORDER = 15;
+static const int MAX_GOLOMB_PREFIX = 24; // differences of 16 bit values never need more
+
+bool QuantizedRotation::operator==(const QuantizedRotation& other) const {
+    return words[0] == other.words[0] && words[1] == other.words[1] && words[2] == other.words[2];
+}
+
+bool QuantizedTranslation::operator==(const QuantizedTranslation& other) const {
+    return values[0] == other.values[0] && values[1] == other.values[1] && values[2] == other.values[2];
+}
+
+QuantizedRotation AvatarJointCodec::quantizeRotation(const glm::quat& rotation) {
+    unsigned char buffer[6];
+    packOrientationQuatToSixBytes(buffer, rotation);
+    QuantizedRotation result;
+    for (int i = 0; i < 3; i++) {
+        result.words[i] = (uint16_t)((buffer[2 * i] << 8) | buffer[2 * i + 1]);
+    }
+    return result;
+}
+
+QuantizedTranslation AvatarJointCodec::quantizeTranslation(const glm::vec3& translation, int radix) {
+    QuantizedTranslation result;
+    packFloatVec3ToSignedTwoByteFixed(reinterpret_cast<unsigned char*>(result.values), translation, radix);
+    return result;
+}
+
+void AvatarJointCodec::dequantizeRotations(const std::vector<QuantizedRotation>& quantized, std::vector<glm::quat>& rotations) {
+    // back to the packet layout so the batch unpacker can be used
+    std::vector<unsigned char> buffer(quantized.size() * 6);
+    for (size_t i = 0; i < quantized.size(); i++) {
+        for (int j = 0; j < 3; j++) {
+            buffer[6 * i + 2 * j] = (unsigned char)(quantized[i].words[j] >> 8);
+            buffer[6 * i + 2 * j + 1] = (unsigned char)(quantized[i].words[j] & 0xff);
+        }
+    }
+    rotations.resize(quantized.size());
+    unpackOrientationQuatsFromSixBytes(buffer.data(), rotations.data(), (int)quantized.size());
+}
+
+void AvatarJointCodec::dequantizeTranslations(const std::vector<QuantizedTranslation>& quantized,
+                                              std::vector<glm::vec3>& translations, int radix) {
+    static_assert(sizeof(QuantizedTranslation) == 6, "translations are unpacked in place");
+    translations.resize(quantized.size());
+    unpackFloatVec3sFromSignedTwoByteFixed(reinterpret_cast<const unsigned char*>(quantized.data()), translations.data(),
+                                           (int)quantized.size(), radix);
+}
+
+size_t AvatarJointCodec::maxEncodingOverhead(size_t numJoints) {
+    const size_t HEADER_SIZE = 2;
+    const size_t PADDING = 1;
+    size_t extraBits = numJoints * ((MAX_ROTATION_BITS - 48) + (MAX_TRANSLATION_BITS - 48));
+    return HEADER_SIZE + (extraBits + 7) / 8 + PADDING;
+}
+
+static inline uint32_t zigzag(int32_t value) {
+    return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+static inline int32_t unzigzag(uint32_t value) {
+    return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+}
+
+static inline int bitLength(uint32_t value) {
+    int length = 0;
+    while (value) {
+        value >>= 1;
+        length++;
+    }
+    return length;
+}
+
+static inline int golombBits(uint32_t value, int order) {
+    return 2 * bitLength((value >> order) + 1) - 1 + order;
+}
+
+namespace {
+
+// Bits are accumulated in a word and flushed a byte at a time, most significant bit first
+class BitWriter {
+public:
+    BitWriter(unsigned char* destination) : _destination(destination), _start(destination) {}
+
+    void write(uint32_t value, int numBits) {
+        _accumulator = (_accumulator << numBits) | (value & ((1ULL << numBits) - 1));
+        _numBits += numBits;
+        while (_numBits >= 8) {
+            _numBits -= 8;
+            *_destination++ = (unsigned char)(_accumulator >> _numBits);
+        }
+    }
+
+    void writeGolomb(uint32_t value, int order) {
+        uint32_t prefixed = (value >> order) + 1;
+        int length = bitLength(prefixed);
+        write(0, length - 1);
+        write(prefixed, length);
+        write(value, order);
+    }
+
+    int finish() {
+        if (_numBits > 0) {
+            write(0, 8 - _numBits);
+        }
+        return (int)(_destination - _start);
+    }
+
+private:
+    unsigned char* _destination;
+    unsigned char* _start;
+    uint64_t _accumulator { 0 };
+    int _numBits { 0 };
+};
+
+class BitReader {
+public:
+    BitReader(const unsigned char* source, int size) : _source(source), _end(source + size), _start(source) {}
+
+    bool read(uint32_t& value, int numBits) {
+        while (_numBits < numBits) {
+            if (_source == _end) {
+                return false;
+            }
+            _accumulator = (_accumulator << 8) | *_source++;
+            _numBits += 8;
+        }
+        _numBits -= numBits;
+        value = (uint32_t)(_accumulator >> _numBits) & (uint32_t)((1ULL << numBits) - 1);
+        return true;
+    }
+
+    bool readGolomb(uint32_t& value, int order) {
+        int zeros = 0;
+        uint32_t bit = 0;
+        while (true) {
+            if (!read(bit, 1)) {
+                return false;
+            }
+            if (bit) {
+                break;
+            }
+            if (++zeros > MAX_GOLOMB_PREFIX) {
+                return false;
+            }
+        }
+        uint32_t prefixed = 0;
+        uint32_t low = 0;
+        if (!read(prefixed, zeros) || !read(low, order)) {
+            return false;
+        }
+        prefixed |= 1U << zeros;
+        value = ((prefixed - 1) << order) | low;
+        return true;
+    }
+
+    int bytesRead() const { return (int)(_source - _start); }
+
+private:
+    const unsigned char* _source;
+    const unsigned char* _end;
+    const unsigned char* _start;
+    uint64_t _accumulator { 0 };
+    int _numBits { 0 };
+};
+
+}
+
+// An absolute value starts the joint over, so that extrapolation never uses a value the receiver may have missed
+template <typename T>
+static inline void pushValue(T (&values)[2], uint8_t& numValues, uint8_t& valueSequence, const T& value,
+                             Prediction prediction, uint8_t sequence) {
+    values[1] = values[0];
+    values[0] = value;
+    numValues = (prediction == Absolute) ? 1 : 2;
+    valueSequence = sequence;
+}
+
+static void predictRotation(const History::Joint& joint, Prediction prediction, int32_t predicted[3]) {
+    for (int i = 0; i < 3; i++) {
+        int32_t last = joint.rotations[0].component(i);
+        predicted[i] = last;
+        if (prediction == Extrapolated) {
+            predicted[i] = glm::clamp(2 * last - joint.rotations[1].component(i), 0, MAX_ROTATION_COMPONENT);
+        }
+    }
+}
+
+static void predictTranslation(const History::Joint& joint, Prediction prediction, int32_t predicted[3]) {
+    for (int i = 0; i < 3; i++) {
+        int32_t last = joint.translations[0].values[i];
+        predicted[i] = last;
+        if (prediction == Extrapolated) {
+            predicted[i] = glm::clamp(2 * last - (int32_t)joint.translations[1].values[i],
+                                      (int32_t)INT16_MIN, (int32_t)INT16_MAX);
+        }
+    }
+}
+
+// Picks the cheaper of the available predictions, or absolute when there is none
+template <typename Predict>
+static Code predictCode(const int32_t values[3], int numKnown, uint8_t referenceAge, Predict predict) {
+    Code code;
+    code.prediction = Absolute;
+    code.largestComponent = 0;
+    code.referenceAge = referenceAge;
+    std::copy(values, values + 3, code.values);
+
+    uint32_t bestCost = UINT32_MAX;
+    for (Prediction prediction : { Previous, Extrapolated }) {
+        if (numKnown < (prediction == Extrapolated ? 2 : 1)) {
+            continue;
+        }
+        int32_t predicted[3];
+        predict(prediction, predicted);
+        uint32_t cost = 0;
+        int32_t residuals[3];
+        for (int i = 0; i < 3; i++) {
+            residuals[i] = values[i] - predicted[i];
+            cost += zigzag(residuals[i]);
+        }
+        if (cost < bestCost) {
+            bestCost = cost;
+            code.prediction = prediction;
+            std::copy(residuals, residuals + 3, code.values);
+        }
+    }
+    return code;
+}
+
+static int codeCost(const Code& code, int order) {
+    int bits = (code.referenceAge == 1) ? 1 : 5;
+    for (int i = 0; i < 3; i++) {
+        bits += golombBits(zigzag(code.values[i]), order);
+    }
+    return bits;
+}
+
+// Chooses the Golomb order for the predicted codes, then falls back to absolute for the ones that would cost more
+template <typename MakeAbsolute>
+static int chooseOrder(std::vector<Code>& codes, int absoluteBits, MakeAbsolute makeAbsolute) {
+    uint64_t total = 0;
+    int numPredicted = 0;
+    for (const Code& code : codes) {
+        if (code.prediction != Absolute) {
+            for (int i = 0; i < 3; i++) {
+                total += zigzag(code.values[i]);
+            }
+            numPredicted += 3;
+        }
+    }
+    if (numPredicted == 0) {
+        return 0;
+    }
+
+    // the best order is close to the size of the mean difference, try its neighbours too
+    int estimate = std::max(bitLength((uint32_t)(total / numPredicted)) - 1, 0);
+    int bestOrder = 0;
+    int64_t bestCost = INT64_MAX;
+    for (int order = std::max(estimate - 1, 0); order <= std::min(estimate + 1, MAX_GOLOMB_ORDER); order++) {
+        int64_t cost = 0;
+        for (const Code& code : codes) {
+            if (code.prediction != Absolute) {
+                cost += std::min(codeCost(code, order), absoluteBits);
+            }
+        }
+        if (cost < bestCost) {
+            bestCost = cost;
+            bestOrder = order;
+        }
+    }
+
+    for (size_t i = 0; i < codes.size(); i++) {
+        if (codes[i].prediction != Absolute && codeCost(codes[i], bestOrder) >= absoluteBits) {
+            makeAbsolute(i);
+        }
+    }
+    return bestOrder;
+}
+
+static void writePredicted(BitWriter& writer, const Code& code, int order) {
+    if (code.referenceAge == 1) {
+        writer.write(1, 1);
+    } else {
+        writer.write(0, 1);
+        writer.write(code.referenceAge - 2, 4);
+    }
+    for (int j = 0; j < 3; j++) {
+        writer.writeGolomb(zigzag(code.values[j]), order);
+    }
+}
+
+static bool readPredicted(BitReader& reader, Code& code, int order) {
+    uint32_t recent;
+    if (!reader.read(recent, 1)) {
+        return false;
+    }
+    code.referenceAge = 1;
+    if (!recent) {
+        uint32_t age;
+        if (!reader.read(age, 4)) {
+            return false;
+        }
+        code.referenceAge = (uint8_t)(age + 2);
+    }
+    for (int j = 0; j < 3; j++) {
+        uint32_t value;
+        if (!reader.readGolomb(value, order)) {
+            return false;
+        }
+        code.values[j] = unzigzag(value);
+    }
+    return true;
+}
+
+int AvatarJointCodec::encode(History& history, bool refresh, int numJoints,
+                             const std::vector<int>& rotationJoints, const std::vector<QuantizedRotation>& rotations,
+                             const std::vector<int>& translationJoints, const std::vector<QuantizedTranslation>& translations,
+                             unsigned char* destination) {
+    if ((int)history.joints.size() != numJoints) {
+        history.joints.assign(numJoints, History::Joint());
+    }
+    uint8_t sequence = history.sequence++;
+
+    // how many values of a joint can be predicted from, none if the joint is due to be refreshed
+    auto numKnown = [&](int jointIndex, int numValues, uint8_t valueSequence) {
+        uint8_t age = sequence - valueSequence;
+        bool refreshed = refresh || (jointIndex + sequence) % JOINT_REFRESH_INTERVAL == 0;
+        return (refreshed || age > MAX_REFERENCE_AGE) ? 0 : numValues;
+    };
+
+    std::vector<Code> rotationCodes;
+    rotationCodes.reserve(rotations.size());
+    for (size_t i = 0; i < rotations.size(); i++) {
+        const History::Joint& joint = history.joints[rotationJoints[i]];
+        const QuantizedRotation& rotation = rotations[i];
+        int largest = rotation.largestComponent();
+        int32_t values[3] = { rotation.component(0), rotation.component(1), rotation.component(2) };
+
+        // the components only line up while the same component is dropped
+        int known = numKnown(rotationJoints[i], joint.numRotations, joint.rotationSequence);
+        if (known >= 1 && joint.rotations[0].largestComponent() != largest) {
+            known = 0;
+        } else if (known >= 2 && joint.rotations[1].largestComponent() != largest) {
+            known = 1;
+        }
+        Code code = predictCode(values, known, sequence - joint.rotationSequence,
+            [&](Prediction prediction, int32_t predicted[3]) {
+                predictRotation(joint, prediction, predicted);
+            });
+        code.largestComponent = (uint8_t)largest;
+        rotationCodes.push_back(code);
+    }
+
+    std::vector<Code> translationCodes;
+    translationCodes.reserve(translations.size());
+    for (size_t i = 0; i < translations.size(); i++) {
+        const History::Joint& joint = history.joints[translationJoints[i]];
+        const QuantizedTranslation& translation = translations[i];
+        int32_t values[3] = { translation.values[0], translation.values[1], translation.values[2] };
+
+        int known = numKnown(translationJoints[i], joint.numTranslations, joint.translationSequence);
+        translationCodes.push_back(predictCode(values, known, sequence - joint.translationSequence,
+            [&](Prediction prediction, int32_t predicted[3]) {
+                predictTranslation(joint, prediction, predicted);
+            }));
+    }
+
+    int rotationOrder = chooseOrder(rotationCodes, MAX_ROTATION_BITS - PREDICTION_BITS, [&](size_t i) {
+        Code& code = rotationCodes[i];
+        code.prediction = Absolute;
+        for (int j = 0; j < 3; j++) {
+            code.values[j] = rotations[i].component(j);
+        }
+    });
+    int translationOrder = chooseOrder(translationCodes, MAX_TRANSLATION_BITS - PREDICTION_BITS, [&](size_t i) {
+        Code& code = translationCodes[i];
+        code.prediction = Absolute;
+        for (int j = 0; j < 3; j++) {
+            code.values[j] = translations[i].values[j];
+        }
+    });
+
+    destination[0] = sequence;
+    destination[1] = (uint8_t)((rotationOrder << 4) | translationOrder);
+    BitWriter writer(destination + 2);
+
+    for (size_t i = 0; i < rotationCodes.size(); i++) {
+        const Code& code = rotationCodes[i];
+        writer.write(code.prediction, PREDICTION_BITS);
+        if (code.prediction == Absolute) {
+            writer.write(code.largestComponent, 2);
+            for (int j = 0; j < 3; j++) {
+                writer.write((uint32_t)code.values[j], ROTATION_COMPONENT_BITS);
+            }
+        } else {
+            writePredicted(writer, code, rotationOrder);
+        }
+        History::Joint& joint = history.joints[rotationJoints[i]];
+        pushValue(joint.rotations, joint.numRotations, joint.rotationSequence, rotations[i], code.prediction, sequence);
+    }
+
+    for (size_t i = 0; i < translationCodes.size(); i++) {
+        const Code& code = translationCodes[i];
+        writer.write(code.prediction, PREDICTION_BITS);
+        if (code.prediction == Absolute) {
+            for (int j = 0; j < 3; j++) {
+                writer.write((uint16_t)code.values[j], 16);
+            }
+        } else {
+            writePredicted(writer, code, translationOrder);
+        }
+        History::Joint& joint = history.joints[translationJoints[i]];
+        pushValue(joint.translations, joint.numTranslations, joint.translationSequence, translations[i],
+                  code.prediction, sequence);
+    }
+
+    return 2 + writer.finish();
+}
+
+int AvatarJointCodec::read(const unsigned char* source, int size, int numRotations, int numTranslations,
+                           EncodedJoints& encoded) {
+    const int HEADER_SIZE = 2;
+    if (size < HEADER_SIZE) {
+        return -1;
+    }
+    encoded.sequence = source[0];
+    int rotationOrder = source[1] >> 4;
+    int translationOrder = source[1] & 0x0f;
+    BitReader reader(source + HEADER_SIZE, size - HEADER_SIZE);
+
+    encoded.rotations.resize(numRotations);
+    for (Code& code : encoded.rotations) {
+        uint32_t prediction;
+        if (!reader.read(prediction, PREDICTION_BITS) || prediction > Extrapolated) {
+            return -1;
+        }
+        code.prediction = (Prediction)prediction;
+        code.largestComponent = 0;
+        code.referenceAge = 0;
+        if (code.prediction == Absolute) {
+            uint32_t largest;
+            if (!reader.read(largest, 2)) {
+                return -1;
+            }
+            code.largestComponent = (uint8_t)largest;
+            for (int j = 0; j < 3; j++) {
+                uint32_t value;
+                if (!reader.read(value, ROTATION_COMPONENT_BITS)) {
+                    return -1;
+                }
+                code.values[j] = (int32_t)value;
+            }
+        } else if (!readPredicted(reader, code, rotationOrder)) {
+            return -1;
+        }
+    }
+
+    encoded.translations.resize(numTranslations);
+    for (Code& code : encoded.translations) {
+        uint32_t prediction;
+        if (!reader.read(prediction, PREDICTION_BITS) || prediction > Extrapolated) {
+            return -1;
+        }
+        code.prediction = (Prediction)prediction;
+        code.largestComponent = 0;
+        code.referenceAge = 0;
+        if (code.prediction == Absolute) {
+            for (int j = 0; j < 3; j++) {
+                uint32_t value;
+                if (!reader.read(value, 16)) {
+                    return -1;
+                }
+                code.values[j] = (int16_t)value;
+            }
+        } else if (!readPredicted(reader, code, translationOrder)) {
+            return -1;
+        }
+    }
+
+    return HEADER_SIZE + reader.bytesRead();
+}
+
+void AvatarJointCodec::decode(History& history, const EncodedJoints& encoded,
+                              std::vector<uint8_t>& validRotations, std::vector<QuantizedRotation>& rotations,
+                              std::vector<uint8_t>& validTranslations, std::vector<QuantizedTranslation>& translations) {
+    const uint8_t MAX_SEQUENCE_GAP = 128;
+    int numJoints = (int)validRotations.size();
+    uint8_t sequence = encoded.sequence;
+    if ((int)history.joints.size() != numJoints) {
+        // a new stream
+        history.joints.assign(numJoints, History::Joint());
+    } else if ((uint8_t)(sequence - history.sequence) >= MAX_SEQUENCE_GAP) {
+        auto isAbsolute = [](const Code& code) { return code.prediction == Absolute; };
+        bool refresh = !(encoded.rotations.empty() && encoded.translations.empty()) &&
+            std::all_of(encoded.rotations.begin(), encoded.rotations.end(), isAbsolute) &&
+            std::all_of(encoded.translations.begin(), encoded.translations.end(), isAbsolute);
+        if (!refresh) {
+            // older than what we already decoded, drop it and keep the history the sender predicts from
+            std::fill(validRotations.begin(), validRotations.end(), 0);
+            std::fill(validTranslations.begin(), validTranslations.end(), 0);
+            rotations.clear();
+            translations.clear();
+            return;
+        }
+
+        // a refresh needs no history, it is either late or the first we got after losing more than the gap, so the
+        // stream restarts from it
+        history.joints.assign(numJoints, History::Joint());
+    }
+    history.sequence = sequence + 1;
+
+    // a prediction holds if we got the value it refers to, the sender never refers further back than MAX_REFERENCE_AGE
+    auto hasReference = [&](const Code& code, int numValues, uint8_t valueSequence) {
+        uint8_t age = sequence - valueSequence;
+        return numValues >= (code.prediction == Extrapolated ? 2 : 1) && age == code.referenceAge &&
+            age <= MAX_REFERENCE_AGE;
+    };
+
+    rotations.clear();
+    size_t codeIndex = 0;
+    for (int i = 0; i < numJoints; i++) {
+        if (!validRotations[i]) {
+            continue;
+        }
+        if (codeIndex == encoded.rotations.size()) {
+            validRotations[i] = 0;
+            continue;
+        }
+        const Code& code = encoded.rotations[codeIndex++];
+        History::Joint& joint = history.joints[i];
+        QuantizedRotation rotation;
+        int largest = code.largestComponent;
+        int32_t components[3] = { code.values[0], code.values[1], code.values[2] };
+        if (code.prediction != Absolute) {
+            if (!hasReference(code, joint.numRotations, joint.rotationSequence)) {
+                // predicted from a value we never got, wait for the joint to be refreshed
+                validRotations[i] = 0;
+                joint.numRotations = 0;
+                continue;
+            }
+            largest = joint.rotations[0].largestComponent();
+            int32_t predicted[3];
+            predictRotation(joint, code.prediction, predicted);
+            for (int j = 0; j < 3; j++) {
+                components[j] += predicted[j];
+            }
+        }
+        for (int j = 0; j < 3; j++) {
+            rotation.words[j] = (uint16_t)(components[j] & MAX_ROTATION_COMPONENT);
+        }
+        rotation.words[0] |= (uint16_t)((largest & 0x01) << 15);
+        rotation.words[1] |= (uint16_t)((largest & 0x02) << 14);
+        pushValue(joint.rotations, joint.numRotations, joint.rotationSequence, rotation, code.prediction, sequence);
+        rotations.push_back(rotation);
+    }
+
+    translations.clear();
+    codeIndex = 0;
+    for (int i = 0; i < numJoints; i++) {
+        if (!validTranslations[i]) {
+            continue;
+        }
+        if (codeIndex == encoded.translations.size()) {
+            validTranslations[i] = 0;
+            continue;
+        }
+        const Code& code = encoded.translations[codeIndex++];
+        History::Joint& joint = history.joints[i];
+        QuantizedTranslation translation;
+        int32_t values[3] = { code.values[0], code.values[1], code.values[2] };
+        if (code.prediction != Absolute) {
+            if (!hasReference(code, joint.numTranslations, joint.translationSequence)) {
+                validTranslations[i] = 0;
+                joint.numTranslations = 0;
+                continue;
+            }
+            int32_t predicted[3];
+            predictTranslation(joint, code.prediction, predicted);
+            for (int j = 0; j < 3; j++) {
+                values[j] += predicted[j];
+            }
+        }
+        for (int j = 0; j < 3; j++) {
+            translation.values[j] = (int16_t)values[j];
+        }
+        pushValue(joint.translations, joint.numTranslations, joint.translationSequence, translation,
+                  code.prediction, sequence);
+        translations.push_back(translation);
+    }
+}
@@ -0,0 +1,139 @@
+//
+//  AvatarJointCodec.h
+//  libraries/avatars/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AvatarJointCodec_h
+#define hifi_AvatarJointCodec_h
+
+#include <stdint.h>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+// Predictive encoding of the joint data the avatar mixer sends in BulkAvatarData packets.
+//
+// Joints are quantized exactly like the six byte encodings of the original joint data.  Each joint that is sent is then
+// coded as one of:
+//    Absolute      the quantized value
+//    Previous      the difference from the last value sent for that joint
+//    Extrapolated  the difference from the linear extrapolation of the last two values sent for that joint
+// Differences are zigzag encoded and written as exponential Golomb codes, whose order is picked per packet, so the small
+// differences of a smoothly moving joint take a few bits instead of six bytes.
+//
+// The sender and the receiver keep the same History of the quantized values for each stream, so prediction never
+// accumulates error.  Avatar data is not acknowledged, so every encoding is numbered and each prediction says how many
+// encodings ago its reference value was sent.  A receiver that missed that encoding skips the joint until it is sent
+// absolute again, which happens at least once every JOINT_REFRESH_INTERVAL encodings it is part of and in every full
+// update.  Extrapolation only follows a prediction, so both ends agree on the two values it uses.
+//
+// Layout written by encode, after the joint validity bits:
+//    uint8_t sequence;
+//    uint8_t orders;                       // Golomb order of rotation differences in the high nibble, translations low
+//    bits, most significant first, padded to a byte:
+//      for each valid rotation:    2 bits prediction, then Absolute: 2 bits largest component + 3 x 15 bits
+//                                                          otherwise: reference age, 3 Golomb codes
+//      for each valid translation: 2 bits prediction, then Absolute: 3 x 16 bits
+//                                                          otherwise: reference age, 3 Golomb codes
+//    where the reference age is a single 1 bit for the previous encoding, else a 0 bit and 4 bits of age - 2
+//
+namespace AvatarJointCodec {
+
+enum Prediction : uint8_t {
+    Absolute = 0,
+    Previous,
+    Extrapolated
+};
+
+const uint8_t JOINT_REFRESH_INTERVAL = 16;
+const uint8_t MAX_REFERENCE_AGE = 17;
+
+// the three words of packOrientationQuatToSixBytes, the largest component index is in their high bits
+struct QuantizedRotation {
+    uint16_t words[3];
+
+    int largestComponent() const { return (words[0] >> 15) | ((words[1] >> 15) << 1); }
+    int component(int i) const { return words[i] & 0x7fff; }
+    bool operator==(const QuantizedRotation& other) const;
+};
+
+// the three fixed point values of packFloatVec3ToSignedTwoByteFixed
+struct QuantizedTranslation {
+    int16_t values[3];
+
+    bool operator==(const QuantizedTranslation& other) const;
+};
+
+QuantizedRotation quantizeRotation(const glm::quat& rotation);
+QuantizedTranslation quantizeTranslation(const glm::vec3& translation, int radix);
+void dequantizeRotations(const std::vector<QuantizedRotation>& quantized, std::vector<glm::quat>& rotations);
+void dequantizeTranslations(const std::vector<QuantizedTranslation>& quantized, std::vector<glm::vec3>& translations,
+                            int radix);
+
+// upper bound of what encode writes beyond the six bytes per joint value of the original encoding
+size_t maxEncodingOverhead(size_t numJoints);
+const int MAX_ROTATION_BITS = 2 + 2 + 3 * 15; // absolute, predictions that cost more are sent absolute
+const int MAX_TRANSLATION_BITS = 2 + 3 * 16;
+
+// The last two values sent for each joint of one avatar stream, as both ends see them.
+class History {
+public:
+    struct Joint {
+        QuantizedRotation rotations[2]; // the last value first
+        QuantizedTranslation translations[2];
+        uint8_t numRotations { 0 }; // how many of the values above can be predicted from
+        uint8_t numTranslations { 0 };
+        uint8_t rotationSequence { 0 }; // the encoding the last value came in
+        uint8_t translationSequence { 0 };
+    };
+
+    void reset() { *this = History(); }
+
+    std::vector<Joint> joints;
+    uint8_t sequence { 0 }; // the next encoding
+};
+
+// A joint value as it was read from a packet, before it is reconstructed against a history
+struct Code {
+    Prediction prediction;
+    int32_t values[3]; // quantized components or differences from the prediction
+    uint8_t largestComponent; // of absolute rotations
+    uint8_t referenceAge; // of predictions
+};
+
+// Everything read from the joint data of a packet, this does not depend on the receiving avatar
+struct EncodedJoints {
+    uint8_t sequence { 0 };
+    std::vector<Code> rotations;
+    std::vector<Code> translations;
+};
+
+// Encodes the sent joints, given by index in increasing order with their quantized values, and advances the history.
+// With refresh every joint is sent absolute.  Returns the number of bytes written.
+int encode(History& history, bool refresh, int numJoints,
+           const std::vector<int>& rotationJoints, const std::vector<QuantizedRotation>& rotations,
+           const std::vector<int>& translationJoints, const std::vector<QuantizedTranslation>& translations,
+           unsigned char* destination);
+
+// Reads what encode wrote for the given number of valid rotations and translations.  Returns the number of bytes read,
+// or -1 if the data is truncated or malformed.
+int read(const unsigned char* source, int size, int numRotations, int numTranslations, EncodedJoints& encoded);
+
+// Reconstructs the quantized values against the history and advances it.  The valid flags come from the validity bits
+// of the packet and are cleared for the joints that could not be reconstructed, the values only hold the valid ones.
+// An encoding older than the last one decoded arrived out of order, it is dropped with every flag cleared, unless every
+// joint in it is absolute.  The sequence can't tell a late refresh from one that follows a long loss, so the history
+// restarts from it.
+void decode(History& history, const EncodedJoints& encoded,
+            std::vector<uint8_t>& validRotations, std::vector<QuantizedRotation>& rotations,
+            std::vector<uint8_t>& validTranslations, std::vector<QuantizedTranslation>& translations);
+
+}
+
+#endif // hifi_AvatarJointCodec_h
@@ -40,6 +40,7 @@
 #include "EntityTree.h"
 #include "EntitySimulation.h"
 #include "EntityDynamicFactoryInterface.h"
+#include "KinematicIntegrator.h"
 
 
 Q_DECLARE_METATYPE(EntityItemPointer);
@@ -1126,105 +1127,17 @@ bool EntityItem::stepKinematicMotion(float timeElapsed) {
     glm::vec3 angularVelocity;
     getLocalTransformAndVelocities(transform, linearVelocity, angularVelocity);
 
-    // find out if it is moving
-    bool isSpinning = (glm::length2(angularVelocity) > 0.0f);
-    float linearSpeedSquared = glm::length2(linearVelocity);
-    bool isTranslating = linearSpeedSquared > 0.0f;
-    bool moving = isTranslating || isSpinning;
-    if (!moving) {
-        return false;
-    }
-
-    if (timeElapsed <= 0.0f) {
-        // someone gave us a useless time value so bail early
-        // but return 'true' because it is moving
-        return true;
-    }
-
-    const float MAX_TIME_ELAPSED = 1.0f; // seconds
-    if (timeElapsed > MAX_TIME_ELAPSED) {
-        qCDebug(entities) << "kinematic timestep = " << timeElapsed << " truncated to " << MAX_TIME_ELAPSED;
-    }
-    timeElapsed = glm::min(timeElapsed, MAX_TIME_ELAPSED);
-
-    if (isSpinning) {
-        float angularDamping = getAngularDamping();
-        // angular damping
-        if (angularDamping > 0.0f) {
-            angularVelocity *= powf(1.0f - angularDamping, timeElapsed);
-        }
-
-        const float MIN_KINEMATIC_ANGULAR_SPEED_SQUARED =
-            KINEMATIC_ANGULAR_SPEED_THRESHOLD * KINEMATIC_ANGULAR_SPEED_THRESHOLD;
-        if (glm::length2(angularVelocity) < MIN_KINEMATIC_ANGULAR_SPEED_SQUARED) {
-            angularVelocity = Vectors::ZERO;
-        } else {
-            // for improved agreement with the way Bullet integrates rotations we use an approximation
-            // and break the integration into bullet-sized substeps
-            glm::quat rotation = transform.getRotation();
-            float dt = timeElapsed;
-            while (dt > 0.0f) {
-                glm::quat  dQ = computeBulletRotationStep(angularVelocity, glm::min(dt, PHYSICS_ENGINE_FIXED_SUBSTEP));
-                rotation = glm::normalize(dQ * rotation);
-                dt -= PHYSICS_ENGINE_FIXED_SUBSTEP;
-            }
-            transform.setRotation(rotation);
-        }
-    }
-
     glm::vec3 position = transform.getTranslation();
-    const float MIN_KINEMATIC_LINEAR_SPEED_SQUARED =
-        KINEMATIC_LINEAR_SPEED_THRESHOLD * KINEMATIC_LINEAR_SPEED_THRESHOLD;
-    if (isTranslating) {
-        glm::vec3 deltaVelocity = Vectors::ZERO;
-
-        // linear damping
-        float damping = getDamping();
-        if (damping > 0.0f) {
-            deltaVelocity = (powf(1.0f - damping, timeElapsed) - 1.0f) * linearVelocity;
-        }
-
-        const float MIN_KINEMATIC_LINEAR_ACCELERATION_SQUARED = 1.0e-4f; // 0.01 m/sec^2
-        vec3 acceleration = getAcceleration();
-        if (glm::length2(acceleration) > MIN_KINEMATIC_LINEAR_ACCELERATION_SQUARED) {
-            // yes acceleration
-            // acceleration is in world-frame but we need it in local-frame
-            glm::vec3 linearAcceleration = acceleration;
-            bool success;
-            Transform parentTransform = getParentTransform(success);
-            if (success) {
-                linearAcceleration = glm::inverse(parentTransform.getRotation()) * linearAcceleration;
-            }
-            deltaVelocity += linearAcceleration * timeElapsed;
-
-            if (linearSpeedSquared < MIN_KINEMATIC_LINEAR_SPEED_SQUARED
-                    && glm::length2(deltaVelocity) < MIN_KINEMATIC_LINEAR_SPEED_SQUARED
-                    && glm::length2(linearVelocity + deltaVelocity) < MIN_KINEMATIC_LINEAR_SPEED_SQUARED) {
-                linearVelocity = Vectors::ZERO;
-            } else {
-                // NOTE: we do NOT include the second-order acceleration term (0.5 * a * dt^2)
-                // when computing the displacement because Bullet also ignores that term.  Yes,
-                // this is an approximation and it works best when dt is small.
-                position += timeElapsed * linearVelocity;
-                linearVelocity += deltaVelocity;
-            }
-        } else {
-            // no acceleration
-            if (linearSpeedSquared < MIN_KINEMATIC_LINEAR_SPEED_SQUARED) {
-                linearVelocity = Vectors::ZERO;
-            } else {
-                // NOTE: we don't use second-order acceleration term for linear displacement
-                // because Bullet doesn't use it.
-                position += timeElapsed * linearVelocity;
-                linearVelocity += deltaVelocity;
-            }
-        }
+    glm::quat rotation = transform.getRotation();
+    KinematicStep step = integrateKinematicMotion(position, rotation, linearVelocity, angularVelocity,
+                                                  getKinematicAcceleration(*this), getDamping(), getAngularDamping(),
+                                                  timeElapsed);
+    if (step == KinematicStep::Moved) {
+        transform.setRotation(rotation);
+        transform.setTranslation(position);
+        setLocalTransformAndVelocities(transform, linearVelocity, angularVelocity);
     }
-
-    transform.setTranslation(position);
-    setLocalTransformAndVelocities(transform, linearVelocity, angularVelocity);
-
-    return true;
+    return step != KinematicStep::Stopped;
 }
 
 bool EntityItem::isMoving() const {
@@ -2574,6 +2487,13 @@ void EntityItem::dimensionsChanged() {
     somethingChangedNotification();
 }
 
+void EntityItem::queueWorldTransformUpdate() {
+    EntityTreePointer tree = getTree();
+    if (tree) {
+        tree->addToNeedsWorldTransformUpdateList(getThisPointer());
+    }
+}
+
 bool EntityItem::getScalesWithParent() const {
     // keep this logic the same as in EntityItemProperties::getScalesWithParent
     if (isAvatarEntity()) {
@@ -2874,9 +2794,18 @@ QString EntityItem::getName() const {
 }
 
 void EntityItem::setName(const QString& value) {
+    bool changed = false;
     withWriteLock([&] {
+        changed = _name != value;
         _name = value;
     });
+
+    if (changed) {
+        EntityTreePointer tree = getTree();
+        if (tree) {
+            tree->updateEntityNameIndex(getThisPointer());
+        }
+    }
 }
 
 QString EntityItem::getDebugName() {
@@ -235,6 +235,7 @@ void EntitySimulation::clearEntities() {
 
 void EntitySimulation::moveSimpleKinematics(uint64_t now) {
     PROFILE_RANGE_EX(simulation_physics, "MoveSimples", 0xffff00ff, (uint64_t)_simpleKinematicEntities.size());
+    _kinematicBatch.clear();
     SetOfEntities::iterator itemItr = _simpleKinematicEntities.begin();
     while (itemItr != _simpleKinematicEntities.end()) {
         EntityItemPointer entity = *itemItr;
@@ -246,14 +247,22 @@ void EntitySimulation::moveSimpleKinematics(uint64_t now) {
         bool hasAvatarAncestor = entity->hasAncestorOfType(NestableType::Avatar);
 
         if (entity->isMovingRelativeToParent() && !entity->getPhysicsInfo() && ancestryIsKnown && !hasAvatarAncestor) {
-            entity->simulate(now);
-            _entitiesToSort.insert(entity);
+            _kinematicBatch.add(entity, now);
             ++itemItr;
         } else {
             // the entity is no longer non-physical-kinematic
             itemItr = _simpleKinematicEntities.erase(itemItr);
         }
     }
+
+    // the integration only reads and writes the batch, the entities are updated afterwards on this thread
+    _kinematicBatch.integrate();
+
+    for (size_t i = 0; i < _kinematicBatch.size(); i++) {
+        _kinematicBatch.commit(i, now);
+        _entitiesToSort.insert(_kinematicBatch.getEntity(i));
+    }
+    _kinematicBatch.clear();
 }
 
 void EntitySimulation::addDynamic(EntityDynamicPointer dynamic) {
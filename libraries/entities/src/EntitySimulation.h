@@ -23,6 +23,7 @@
 #include "EntityDynamicInterface.h"
 #include "EntityItem.h"
 #include "EntityTree.h"
+#include "KinematicIntegrator.h"
 
 using EntitySimulationPointer = std::shared_ptr<EntitySimulation>;
 using SetOfEntities = QSet<EntityItemPointer>;
@@ -109,6 +110,8 @@ protected:
 private:
     void moveSimpleKinematics();
 
+    KinematicBatch _kinematicBatch; // reused so its storage is only allocated once
+
     // back pointer to EntityTree structure
     EntityTreePointer _entityTree;
 
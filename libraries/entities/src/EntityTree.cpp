@@ -78,7 +78,13 @@ void EntityTree::eraseAllOctreeElements(bool createNewRoot) {
     }
     _staleProxies.clear();
     QHash<EntityItemID, EntityItemPointer> localMap;
-    localMap.swap(_entityMap);
+    {
+        QWriteLocker locker(&_entityMapLock);
+        localMap.swap(_entityMap);
+        _entityNameIndex.clear();
+        _indexedEntityNames.clear();
+        _entityTypeIndex.clear();
+    }
     this->withWriteLock([&] {
         foreach(EntityItemPointer entity, localMap) {
             EntityTreeElementPointer element = entity->getElement();
@@ -1006,6 +1012,24 @@ bool evalInSphereWithTypeOperation(const OctreeElementPointer& element, void* ex
 
 // NOTE: assumes caller has handled locking
 void EntityTree::evalEntitiesInSphereWithType(const glm::vec3& center, float radius, EntityTypes::EntityType type, PickFilter searchFilter, QVector<QUuid>& foundEntities) {
+    QVector<EntityItemPointer> indexedEntities;
+    bool useIndex;
+    {
+        QReadLocker locker(&_entityMapLock);
+        auto it = _entityTypeIndex.constFind(type);
+        useIndex = findIndexedEntities(it != _entityTypeIndex.constEnd() ? &it.value() : nullptr, indexedEntities);
+    }
+    if (useIndex) {
+        foundEntities.clear();
+        for (const auto& entity : indexedEntities) {
+            if (entity->getType() == type && checkFilterSettings(entity, searchFilter) &&
+                EntityTreeElement::isEntityInSphere(entity, center, radius)) {
+                foundEntities.push_back(entity->getID());
+            }
+        }
+        return;
+    }
+
     FindEntitiesInSphereWithTypeArgs args = { center, radius, type, searchFilter, QVector<QUuid>() };
     recurseTreeWithOperation(evalInSphereWithTypeOperation, &args);
     foundEntities.swap(args.entities);
@@ -1042,6 +1066,24 @@ bool evalInSphereWithNameOperation(const OctreeElementPointer& element, void* ex
 
 // NOTE: assumes caller has handled locking
 void EntityTree::evalEntitiesInSphereWithName(const glm::vec3& center, float radius, const QString& name, bool caseSensitive, PickFilter searchFilter, QVector<QUuid>& foundEntities) {
+    QVector<EntityItemPointer> indexedEntities;
+    bool useIndex;
+    {
+        QReadLocker locker(&_entityMapLock);
+        auto it = _entityNameIndex.constFind(name.toLower());
+        useIndex = findIndexedEntities(it != _entityNameIndex.constEnd() ? &it.value() : nullptr, indexedEntities);
+    }
+    if (useIndex) {
+        foundEntities.clear();
+        for (const auto& entity : indexedEntities) {
+            if (EntityTreeElement::entityNameMatches(entity, name, caseSensitive) && checkFilterSettings(entity, searchFilter) &&
+                EntityTreeElement::isEntityInSphere(entity, center, radius)) {
+                foundEntities.push_back(entity->getID());
+            }
+        }
+        return;
+    }
+
     FindEntitiesInSphereWithNameArgs args = { center, radius, name, caseSensitive, searchFilter, QVector<QUuid>() };
     recurseTreeWithOperation(evalInSphereWithNameOperation, &args);
     foundEntities.swap(args.entities);
@@ -2043,6 +2085,35 @@ void EntityTree::addToNeedsParentFixupList(EntityItemPointer entity) {
     _needsParentFixup.append(entity);
 }
 
+void EntityTree::addToNeedsWorldTransformUpdateList(EntityItemPointer entity) {
+    if (!_isUpdated) {
+        return;
+    }
+    QWriteLocker locker(&_needsWorldTransformUpdateLock);
+    _needsWorldTransformUpdate.append(entity);
+}
+
+void EntityTree::updateNeedsWorldTransformUpdates() {
+    PROFILE_RANGE(simulation_physics, "WorldTransforms");
+    QVector<EntityItemWeakPointer> entitiesToUpdate;
+    {
+        QWriteLocker locker(&_needsWorldTransformUpdateLock);
+        entitiesToUpdate.swap(_needsWorldTransformUpdate);
+    }
+
+    std::vector<SpatiallyNestablePointer> objects;
+    objects.reserve(entitiesToUpdate.size());
+    for (auto& entityWP : entitiesToUpdate) {
+        EntityItemPointer entity = entityWP.lock();
+        if (entity && !entity->isDead()) {
+            objects.push_back(entity);
+        }
+    }
+    if (!objects.empty()) {
+        SpatiallyNestable::updateWorldTransforms(objects);
+    }
+}
+
 void EntityTree::update(bool simulate) {
     PROFILE_RANGE(simulation_physics, "UpdateTree");
     PerformanceTimer perfTimer("updateTree");
@@ -2068,6 +2139,10 @@ void EntityTree::update(bool simulate) {
             }
         }
     });
+
+    // outside of the write lock, finding the parents of the moved entities takes read locks from the worker threads
+    _isUpdated = true;
+    updateNeedsWorldTransformUpdates();
 }
 
 quint64 EntityTree::getAdjustedConsiderSince(quint64 sinceTime) {
@@ -2256,6 +2331,20 @@ EntityTreeElementPointer EntityTree::getContainingElement(const EntityItemID& en
     return EntityTreeElementPointer(nullptr);
 }
 
+static const int MAX_INDEXED_ENTITIES_FRACTION = 8;
+static const int MIN_INDEXED_ENTITIES_FOR_TRAVERSAL = 64;
+
+template <typename Key>
+static void removeFromEntityIndex(QHash<Key, QSet<EntityItemID>>& index, const Key& key, const EntityItemID& id) {
+    auto ids = index.find(key);
+    if (ids != index.end()) {
+        ids.value().remove(id);
+        if (ids.value().isEmpty()) {
+            index.erase(ids);
+        }
+    }
+}
+
 void EntityTree::addEntityMapEntry(EntityItemPointer entity) {
     EntityItemID id = entity->getEntityItemID();
     QWriteLocker locker(&_entityMapLock);
@@ -2266,11 +2355,62 @@ void EntityTree::addEntityMapEntry(EntityItemPointer entity) {
         return;
     }
     _entityMap.insert(id, entity);
+
+    QString name = entity->getName().toLower();
+    _entityNameIndex[name].insert(id);
+    _indexedEntityNames.insert(id, name);
+    _entityTypeIndex[(int)entity->getType()].insert(id);
 }
 
 void EntityTree::clearEntityMapEntry(const EntityItemID& id) {
     QWriteLocker locker(&_entityMapLock);
-    _entityMap.remove(id);
+    EntityItemPointer entity = _entityMap.take(id);
+    if (entity) {
+        removeFromEntityIndex(_entityTypeIndex, (int)entity->getType(), id);
+    }
+    auto indexedName = _indexedEntityNames.find(id);
+    if (indexedName != _indexedEntityNames.end()) {
+        removeFromEntityIndex(_entityNameIndex, indexedName.value(), id);
+        _indexedEntityNames.erase(indexedName);
+    }
+}
+
+// Entities can be renamed by edits, network updates and scripts, they all go through EntityItem::setName
+void EntityTree::updateEntityNameIndex(const EntityItemPointer& entity) {
+    EntityItemID id = entity->getEntityItemID();
+    QString name = entity->getName().toLower();
+
+    QWriteLocker locker(&_entityMapLock);
+    auto indexedName = _indexedEntityNames.find(id);
+    if (indexedName == _indexedEntityNames.end() || indexedName.value() == name) {
+        // not in the tree, or already indexed with this name
+        return;
+    }
+    removeFromEntityIndex(_entityNameIndex, indexedName.value(), id);
+    _entityNameIndex[name].insert(id);
+    indexedName.value() = name;
+}
+
+// The query planner: an index is scanned instead of the tree when it holds few enough entities, testing each of them
+// then costs less than visiting all the entities in the elements the query touches.
+// Returns false if the tree should be traversed instead.  Must be called with _entityMapLock held.
+bool EntityTree::findIndexedEntities(const QSet<EntityItemID>* ids, QVector<EntityItemPointer>& entities) const {
+    if (!ids) {
+        // no entity has this key
+        return true;
+    }
+    if (ids->size() > std::max(_entityMap.size() / MAX_INDEXED_ENTITIES_FRACTION, MIN_INDEXED_ENTITIES_FOR_TRAVERSAL)) {
+        return false;
+    }
+
+    entities.reserve(ids->size());
+    for (const auto& id : *ids) {
+        EntityItemPointer entity = _entityMap.value(id);
+        if (entity && entity->getElement()) {
+            entities.push_back(entity);
+        }
+    }
+    return true;
 }
 
 void EntityTree::debugDumpMap() {
@@ -12,6 +12,8 @@
 #ifndef hifi_EntityTree_h
 #define hifi_EntityTree_h
 
+#include <atomic>
+
 #include <QSet>
 #include <QVector>
 
@@ -170,6 +172,7 @@ public:
     EntityTreeElementPointer getContainingElement(const EntityItemID& entityItemID)  /*const*/;
     void addEntityMapEntry(EntityItemPointer entity);
     void clearEntityMapEntry(const EntityItemID& id);
+    void updateEntityNameIndex(const EntityItemPointer& entity);
     void debugDumpMap();
     virtual void dumpTree() override;
     virtual void pruneTree() override;
@@ -245,6 +248,7 @@ public:
     void removeFromChildrenOfAvatars(EntityItemPointer entity);
 
     void addToNeedsParentFixupList(EntityItemPointer entity);
+    void addToNeedsWorldTransformUpdateList(EntityItemPointer entity);
 
     void notifyNewCollisionSoundURL(const QString& newCollisionSoundURL, const EntityItemID& entityID);
 
@@ -326,6 +330,12 @@ protected:
     mutable QReadWriteLock _entityMapLock;
     QHash<EntityItemID, EntityItemPointer> _entityMap;
 
+    // Indexes of the entity map for the queries by name and by type, guarded by _entityMapLock
+    QHash<QString, QSet<EntityItemID>> _entityNameIndex; // by lower case name
+    QHash<EntityItemID, QString> _indexedEntityNames;
+    QHash<int, QSet<EntityItemID>> _entityTypeIndex;
+    bool findIndexedEntities(const QSet<EntityItemID>* ids, QVector<EntityItemPointer>& entities) const;
+
     mutable QReadWriteLock _entityCertificateIDMapLock;
     QHash<QString, EntityItemID> _entityCertificateIDMap;
 
@@ -361,6 +371,11 @@ protected:
     QVector<EntityItemWeakPointer> _needsParentFixup; // entites with a parentID but no (yet) known parent instance
     mutable QReadWriteLock _needsParentFixupLock;
 
+    void updateNeedsWorldTransformUpdates(); // refresh the cached world transforms of these entities and their children
+    QVector<EntityItemWeakPointer> _needsWorldTransformUpdate; // entities that moved or were reparented since the last update
+    mutable QReadWriteLock _needsWorldTransformUpdateLock;
+    std::atomic<bool> _isUpdated { false }; // trees that are never updated don't queue world transform updates
+
     // we maintain a list of avatarIDs to notice when an entity is a child of one.
     QSet<QUuid> _avatarIDs; // IDs of avatars connected to entity server
     QHash<QUuid, QSet<EntityItemID>> _childrenOfAvatars;  // which entities are children of which avatars
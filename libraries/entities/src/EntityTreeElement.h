@@ -30,6 +30,8 @@ using EntityTreeElementWeakPointer = std::weak_ptr<EntityTreeElement>;
 using EntityTreeElementPointer = std::shared_ptr<EntityTreeElement>;
 using EntityItemFilter = std::function<bool(EntityItemPointer&)>;
 
+bool checkFilterSettings(const EntityItemPointer& entity, PickFilter searchFilter);
+
 class EntityTreeUpdateArgs {
 public:
     EntityTreeUpdateArgs() :
@@ -88,6 +90,10 @@ class EntityTreeElement : public OctreeElement, ReadWriteLockable {
 public:
     virtual ~EntityTreeElement();
 
+    // elements are packed together in a pool rather than allocated one by one
+    static void* operator new(size_t size);
+    static void operator delete(void* pointer, size_t size);
+
     // type safe versions of OctreeElement methods
     EntityTreeElementPointer getChildAtIndex(int index) const {
         return std::static_pointer_cast<EntityTreeElement>(OctreeElement::getChildAtIndex(index));
@@ -177,6 +183,10 @@ public:
     void evalEntitiesInSphereWithType(const glm::vec3& position, float radius, EntityTypes::EntityType type, PickFilter searchFilter, QVector<QUuid>& foundEntities) const;
     void evalEntitiesInSphereWithName(const glm::vec3& position, float radius, const QString& name, bool caseSensitive, PickFilter searchFilter, QVector<QUuid>& foundEntities) const;
     void evalEntitiesInCube(const AACube& cube, PickFilter searchFilter, QVector<QUuid>& foundEntities) const;
+
+    // the tests of the sphere queries, also used by the tree for the entities it finds through its indexes
+    static bool isEntityInSphere(const EntityItemPointer& entity, const glm::vec3& position, float radius);
+    static bool entityNameMatches(const EntityItemPointer& entity, const QString& name, bool caseSensitive);
     void evalEntitiesInBox(const AABox& box, PickFilter searchFilter, QVector<QUuid>& foundEntities) const;
     void evalEntitiesInFrustum(const ViewFrustum& frustum, PickFilter searchFilter, QVector<QUuid>& foundEntities) const;
 
@@ -0,0 +1,192 @@
+//
+//  KinematicIntegrator.cpp
+//  libraries/entities/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "KinematicIntegrator.h"
+
+#include <glm/gtx/norm.hpp>
+
+#include <GLMHelpers.h>
+#include <NumericalConstants.h>
+#include <PhysicsHelpers.h>
+#include <TBBHelpers.h>
+
+#include "EntitiesLogging.h"
+
+static const float MIN_KINEMATIC_LINEAR_ACCELERATION_SQUARED = 1.0e-4f; // 0.01 m/sec^2
+
+// entities per task, small enough to spread a few thousand entities over the cores
+static const size_t KINEMATIC_BATCH_GRAIN_SIZE = 256;
+
+KinematicStep integrateKinematicMotion(glm::vec3& position, glm::quat& rotation, glm::vec3& linearVelocity,
+                                       glm::vec3& angularVelocity, const glm::vec3& acceleration, float damping,
+                                       float angularDamping, float timeElapsed) {
+    // find out if it is moving
+    bool isSpinning = (glm::length2(angularVelocity) > 0.0f);
+    float linearSpeedSquared = glm::length2(linearVelocity);
+    bool isTranslating = linearSpeedSquared > 0.0f;
+    bool moving = isTranslating || isSpinning;
+    if (!moving) {
+        return KinematicStep::Stopped;
+    }
+
+    if (timeElapsed <= 0.0f) {
+        // someone gave us a useless time value so bail early
+        // but it is still moving
+        return KinematicStep::Unchanged;
+    }
+
+    const float MAX_TIME_ELAPSED = 1.0f; // seconds
+    if (timeElapsed > MAX_TIME_ELAPSED) {
+        qCDebug(entities) << "kinematic timestep = " << timeElapsed << " truncated to " << MAX_TIME_ELAPSED;
+    }
+    timeElapsed = glm::min(timeElapsed, MAX_TIME_ELAPSED);
+
+    if (isSpinning) {
+        // angular damping
+        if (angularDamping > 0.0f) {
+            angularVelocity *= powf(1.0f - angularDamping, timeElapsed);
+        }
+
+        const float MIN_KINEMATIC_ANGULAR_SPEED_SQUARED =
+            KINEMATIC_ANGULAR_SPEED_THRESHOLD * KINEMATIC_ANGULAR_SPEED_THRESHOLD;
+        if (glm::length2(angularVelocity) < MIN_KINEMATIC_ANGULAR_SPEED_SQUARED) {
+            angularVelocity = Vectors::ZERO;
+        } else {
+            // for improved agreement with the way Bullet integrates rotations we use an approximation
+            // and break the integration into bullet-sized substeps
+            float dt = timeElapsed;
+            while (dt > 0.0f) {
+                glm::quat  dQ = computeBulletRotationStep(angularVelocity, glm::min(dt, PHYSICS_ENGINE_FIXED_SUBSTEP));
+                rotation = glm::normalize(dQ * rotation);
+                dt -= PHYSICS_ENGINE_FIXED_SUBSTEP;
+            }
+        }
+    }
+
+    const float MIN_KINEMATIC_LINEAR_SPEED_SQUARED =
+        KINEMATIC_LINEAR_SPEED_THRESHOLD * KINEMATIC_LINEAR_SPEED_THRESHOLD;
+    if (isTranslating) {
+        glm::vec3 deltaVelocity = Vectors::ZERO;
+
+        // linear damping
+        if (damping > 0.0f) {
+            deltaVelocity = (powf(1.0f - damping, timeElapsed) - 1.0f) * linearVelocity;
+        }
+
+        if (glm::length2(acceleration) > MIN_KINEMATIC_LINEAR_ACCELERATION_SQUARED) {
+            // yes acceleration
+            deltaVelocity += acceleration * timeElapsed;
+
+            if (linearSpeedSquared < MIN_KINEMATIC_LINEAR_SPEED_SQUARED
+                    && glm::length2(deltaVelocity) < MIN_KINEMATIC_LINEAR_SPEED_SQUARED
+                    && glm::length2(linearVelocity + deltaVelocity) < MIN_KINEMATIC_LINEAR_SPEED_SQUARED) {
+                linearVelocity = Vectors::ZERO;
+            } else {
+                // NOTE: we do NOT include the second-order acceleration term (0.5 * a * dt^2)
+                // when computing the displacement because Bullet also ignores that term.  Yes,
+                // this is an approximation and it works best when dt is small.
+                position += timeElapsed * linearVelocity;
+                linearVelocity += deltaVelocity;
+            }
+        } else {
+            // no acceleration
+            if (linearSpeedSquared < MIN_KINEMATIC_LINEAR_SPEED_SQUARED) {
+                linearVelocity = Vectors::ZERO;
+            } else {
+                // NOTE: we don't use second-order acceleration term for linear displacement
+                // because Bullet doesn't use it.
+                position += timeElapsed * linearVelocity;
+                linearVelocity += deltaVelocity;
+            }
+        }
+    }
+    return KinematicStep::Moved;
+}
+
+glm::vec3 getKinematicAcceleration(const EntityItem& entity) {
+    glm::vec3 acceleration = entity.getAcceleration();
+    if (glm::length2(acceleration) > MIN_KINEMATIC_LINEAR_ACCELERATION_SQUARED) {
+        // acceleration is in world-frame but we need it in local-frame
+        bool success;
+        Transform parentTransform = entity.getParentTransform(success);
+        if (success) {
+            acceleration = glm::inverse(parentTransform.getRotation()) * acceleration;
+        }
+    }
+    return acceleration;
+}
+
+void KinematicBatch::clear() {
+    _entities.clear();
+    _transforms.clear();
+    _positions.clear();
+    _rotations.clear();
+    _velocities.clear();
+    _angularVelocities.clear();
+    _accelerations.clear();
+    _dampings.clear();
+    _angularDampings.clear();
+    _timesElapsed.clear();
+    _steps.clear();
+}
+
+void KinematicBatch::add(const EntityItemPointer& entity, uint64_t now) {
+    if (entity->getLastSimulated() == 0) {
+        entity->setLastSimulated(now);
+    }
+
+    Transform transform;
+    glm::vec3 velocity;
+    glm::vec3 angularVelocity;
+    entity->getLocalTransformAndVelocities(transform, velocity, angularVelocity);
+
+    _entities.push_back(entity);
+    _positions.push_back(transform.getTranslation());
+    _rotations.push_back(transform.getRotation());
+    _transforms.push_back(transform);
+    _velocities.push_back(velocity);
+    _angularVelocities.push_back(angularVelocity);
+    _accelerations.push_back(getKinematicAcceleration(*entity));
+    _dampings.push_back(entity->getDamping());
+    _angularDampings.push_back(entity->getAngularDamping());
+    _timesElapsed.push_back((float)(now - entity->getLastSimulated()) / (float)(USECS_PER_SECOND));
+}
+
+void KinematicBatch::integrate() {
+    _steps.resize(_entities.size());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, _entities.size(), KINEMATIC_BATCH_GRAIN_SIZE),
+                      [&](const tbb::blocked_range<size_t>& range) {
+        for (size_t i = range.begin(); i < range.end(); i++) {
+            _steps[i] = integrateKinematicMotion(_positions[i], _rotations[i], _velocities[i], _angularVelocities[i],
+                                                 _accelerations[i], _dampings[i], _angularDampings[i], _timesElapsed[i]);
+        }
+    });
+}
+
+void KinematicBatch::commit(size_t i, uint64_t now) {
+    const EntityItemPointer& entity = _entities[i];
+    switch (_steps[i]) {
+        case KinematicStep::Stopped:
+            // flag it to transition from KINEMATIC to STATIC
+            entity->markDirtyFlags(Simulation::DIRTY_MOTION_TYPE);
+            entity->setAcceleration(Vectors::ZERO);
+            break;
+        case KinematicStep::Moved: {
+            Transform& transform = _transforms[i];
+            transform.setRotation(_rotations[i]);
+            transform.setTranslation(_positions[i]);
+            entity->setLocalTransformAndVelocities(transform, _velocities[i], _angularVelocities[i]);
+            break;
+        }
+        default:
+            break;
+    }
+    entity->setLastSimulated(now);
+}
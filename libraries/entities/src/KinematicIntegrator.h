@@ -0,0 +1,66 @@
+//
+//  KinematicIntegrator.h
+//  libraries/entities/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_KinematicIntegrator_h
+#define hifi_KinematicIntegrator_h
+
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <Transform.h>
+
+#include "EntityItem.h"
+
+enum class KinematicStep : uint8_t {
+    Stopped = 0, // no longer moving, nothing was changed
+    Unchanged, // still moving but no time elapsed
+    Moved
+};
+
+// Steps a kinematic motion forward the way Bullet would.  Everything is in the parent frame of the entity,
+// including the acceleration.  Touches no shared state so it may run on any thread.
+KinematicStep integrateKinematicMotion(glm::vec3& position, glm::quat& rotation, glm::vec3& velocity,
+                                       glm::vec3& angularVelocity, const glm::vec3& acceleration, float damping,
+                                       float angularDamping, float timeElapsed);
+
+// The acceleration of an entity in its parent frame, as integrateKinematicMotion expects it
+glm::vec3 getKinematicAcceleration(const EntityItem& entity);
+
+// The motion of many simple kinematic entities in structure-of-arrays form.  The state is gathered and committed on
+// the simulation thread, under the tree lock, and integrated in between on every core.
+class KinematicBatch {
+public:
+    void clear();
+    void add(const EntityItemPointer& entity, uint64_t now);
+    void integrate();
+
+    size_t size() const { return _entities.size(); }
+    const EntityItemPointer& getEntity(size_t i) const { return _entities[i]; }
+
+    // writes the integrated motion of entity i back the way EntityItem::simulate does
+    void commit(size_t i, uint64_t now);
+
+private:
+    std::vector<EntityItemPointer> _entities;
+    std::vector<Transform> _transforms;
+    std::vector<glm::vec3> _positions;
+    std::vector<glm::quat> _rotations;
+    std::vector<glm::vec3> _velocities;
+    std::vector<glm::vec3> _angularVelocities;
+    std::vector<glm::vec3> _accelerations;
+    std::vector<float> _dampings;
+    std::vector<float> _angularDampings;
+    std::vector<float> _timesElapsed;
+    std::vector<KinematicStep> _steps;
+};
+
+#endif // hifi_KinematicIntegrator_h
@@ -59,7 +59,7 @@ void SimpleEntitySimulation::addEntityInternal(EntityItemPointer entity) {
             // we don't allow dynamic objects to move without an owner so nothing to do here
         } else if (entity->isMovingRelativeToParent()) {
             SetOfEntities::iterator itr = _simpleKinematicEntities.find(entity);
-            if (itr != _simpleKinematicEntities.end()) {
+            if (itr == _simpleKinematicEntities.end()) {
                 _simpleKinematicEntities.insert(entity);
                 entity->setLastSimulated(usecTimestampNow());
             }
@@ -71,7 +71,7 @@ void SimpleEntitySimulation::addEntityInternal(EntityItemPointer entity) {
 
         if (entity->isMovingRelativeToParent()) {
             SetOfEntities::iterator itr = _simpleKinematicEntities.find(entity);
-            if (itr != _simpleKinematicEntities.end()) {
+            if (itr == _simpleKinematicEntities.end()) {
                 _simpleKinematicEntities.insert(entity);
                 entity->setLastSimulated(usecTimestampNow());
             }
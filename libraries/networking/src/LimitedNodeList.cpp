@@ -576,6 +576,7 @@ void LimitedNodeList::eraseAllNodes() {
                 killedNodes.insert(it->second);
                 it = _nodeHash.unsafe_erase(it);
             }
+            nodeMembershipChanged();
         }
     }
 
@@ -605,6 +606,7 @@ bool LimitedNodeList::killNodeWithUUID(const QUuid& nodeUUID, ConnectionID newCo
             QWriteLocker writeLocker(&_nodeMutex);
             _localIDMap.unsafe_erase(matchingNode->getLocalID());
             _nodeHash.unsafe_erase(it);
+            nodeMembershipChanged();
         }
 
         handleNodeKill(matchingNode, newConnectionID);
@@ -641,6 +643,30 @@ void LimitedNodeList::handleNodeKill(const SharedNodePointer& node, ConnectionID
     }
 }
 
+LimitedNodeList::NodeSnapshotPointer LimitedNodeList::getNodeSnapshot() const {
+    auto snapshot = std::atomic_load(&_nodeSnapshot);
+    if (snapshot && snapshot->epoch == _nodeMembershipEpoch) {
+        return snapshot;
+    }
+
+    // the membership changed since the last snapshot, publish a new one
+    QReadLocker readLock(&_nodeMutex);
+
+    // read the epoch before the nodes, a node added concurrently bumps it after its insertion
+    // so at worst the next call publishes yet another snapshot
+    uint64_t epoch = _nodeMembershipEpoch;
+    std::vector<SharedNodePointer> nodes;
+    nodes.reserve(_nodeHash.size());
+    std::transform(_nodeHash.cbegin(), _nodeHash.cend(), std::back_inserter(nodes), [&](const NodeHash::value_type& it) {
+        return it.second;
+    });
+    readLock.unlock();
+
+    snapshot = std::make_shared<const NodeSnapshot>(epoch, std::move(nodes));
+    std::atomic_store(&_nodeSnapshot, snapshot);
+    return snapshot;
+}
+
 SharedNodePointer LimitedNodeList::addOrUpdateNode(const QUuid& uuid, NodeType_t nodeType,
                                                    const HifiSockAddr& publicSocket, const HifiSockAddr& localSocket,
                                                    Node::LocalID localID, bool isReplicated, bool isUpstream,
@@ -700,6 +726,7 @@ SharedNodePointer LimitedNodeList::addOrUpdateNode(const QUuid& uuid, NodeType_t
 
                 _localIDMap.unsafe_erase(oldSoloNode->getLocalID());
                 _nodeHash.unsafe_erase(previousSoloIt);
+                nodeMembershipChanged();
                 handleNodeKill(oldSoloNode);
 
                 // convert the current lock back to a read lock for insertion of new node
@@ -716,6 +743,7 @@ SharedNodePointer LimitedNodeList::addOrUpdateNode(const QUuid& uuid, NodeType_t
         _nodeHash.emplace(newNode->getUUID(), newNodePointer);
         _localIDMap.emplace(localID, newNodePointer);
 #endif
+        nodeMembershipChanged();
         readLocker.unlock();
 
         qCDebug(networking) << "Added" << *newNode;
@@ -833,6 +861,7 @@ void LimitedNodeList::removeSilentNodes() {
             // call the NodeHash erase to get rid of this node
             _localIDMap.unsafe_erase(node->getLocalID());
             it = _nodeHash.unsafe_erase(it);
+            nodeMembershipChanged();
 
             killedNodes.insert(node);
         } else {
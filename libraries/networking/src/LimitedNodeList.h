@@ -14,6 +14,7 @@
 
 #include <assert.h>
 #include <stdint.h>
+#include <atomic>
 #include <iterator>
 #include <memory>
 #include <set>
@@ -66,6 +67,9 @@ const QHostAddress DEFAULT_ASSIGNMENT_CLIENT_MONITOR_HOSTNAME = QHostAddress::Lo
 
 const QString USERNAME_UUID_REPLACEMENT_STATS_KEY = "$username";
 
+// Leads the segment of a delta domain list that carries the removed node IDs, in place of a node type
+const NodeType_t DOMAIN_LIST_REMOVED_NODES_SEGMENT = 0;
+
 using ConnectionID = int64_t;
 const ConnectionID NULL_CONNECTION_ID { -1 };
 const ConnectionID INITIAL_CONNECTION_ID { 0 };
@@ -196,41 +200,47 @@ public:
     using value_type = SharedNodePointer;
     using const_iterator = std::vector<value_type>::const_iterator;
 
-    // Cede control of iteration under a single read lock (e.g. for use by thread pools)
+    // An immutable copy of the nodes, a new one is only published when nodes are added or removed
+    class NodeSnapshot {
+    public:
+        NodeSnapshot(uint64_t epoch, std::vector<value_type>&& nodes) : epoch(epoch), nodes(std::move(nodes)) {}
+
+        const_iterator cbegin() const { return nodes.cbegin(); }
+        const_iterator cend() const { return nodes.cend(); }
+        size_t size() const { return nodes.size(); }
+
+        const uint64_t epoch;
+        const std::vector<value_type> nodes;
+    };
+    using NodeSnapshotPointer = std::shared_ptr<const NodeSnapshot>;
+
+    // The current snapshot of the nodes, without taking the node lock unless the membership changed since the last one.
+    // The snapshot keeps its nodes alive, a node killed after it was taken stays in it until the next one.
+    NodeSnapshotPointer getNodeSnapshot() const;
+
+    // Cede control of iteration over a snapshot of the nodes (e.g. for use by thread pools)
     // Use this for nested loops instead of taking nested read locks!
-    //   This allows multiple threads (i.e. a thread pool) to share a lock
-    //   without deadlocking when a dying node attempts to acquire a write lock
+    //   Every reader of the same membership shares the same snapshot, so the
+    //   iteration neither takes the node lock nor copies the node pointers
     template<typename NestedNodeLambda>
     void nestedEach(NestedNodeLambda functor,
                     int* lockWaitOut = nullptr,
                     int* nodeTransformOut = nullptr,
                     int* functorOut = nullptr) {
         auto start = usecTimestampNow();
-        {
-            QReadLocker readLock(&_nodeMutex);
-            auto endLock = usecTimestampNow();
-            if (lockWaitOut) {
-                *lockWaitOut = (endLock - start);
-            }
-
-            // Size of _nodeHash could change at any time,
-            // so reserve enough memory for the current size
-            // and then back insert all the nodes found
-            std::vector<SharedNodePointer> nodes;
-            nodes.reserve(_nodeHash.size());
-            std::transform(_nodeHash.cbegin(), _nodeHash.cend(), std::back_inserter(nodes), [&](const NodeHash::value_type& it) {
-                return it.second;
-            });
-            auto endTransform = usecTimestampNow();
-            if (nodeTransformOut) {
-                *nodeTransformOut = (endTransform - endLock);
-            }
+        auto snapshot = getNodeSnapshot();
+        auto endSnapshot = usecTimestampNow();
+        if (lockWaitOut) {
+            *lockWaitOut = 0;
+        }
+        if (nodeTransformOut) {
+            *nodeTransformOut = (endSnapshot - start);
+        }
 
-            functor(nodes.cbegin(), nodes.cend());
-            auto endFunctor = usecTimestampNow();
-            if (functorOut) {
-                *functorOut = (endFunctor - endTransform);
-            }
+        functor(snapshot->cbegin(), snapshot->cend());
+        auto endFunctor = usecTimestampNow();
+        if (functorOut) {
+            *functorOut = (endFunctor - endSnapshot);
         }
     }
 
@@ -390,8 +400,13 @@ protected:
 
     bool sockAddrBelongsToNode(const HifiSockAddr& sockAddr);
 
+    // Must be called after nodes are added to or removed from _nodeHash
+    void nodeMembershipChanged() { ++_nodeMembershipEpoch; }
+
     NodeHash _nodeHash;
     mutable QReadWriteLock _nodeMutex { QReadWriteLock::Recursive };
+    std::atomic<uint64_t> _nodeMembershipEpoch { 0 };
+    mutable NodeSnapshotPointer _nodeSnapshot; // only accessed with std::atomic_load and std::atomic_store
     udt::Socket _nodeSocket;
     QUdpSocket* _dtlsSocket { nullptr };
     HifiSockAddr _localSockAddr;
@@ -167,6 +167,11 @@ public:
     static std::unique_ptr<NLPacketList> encodeMessagesPacket(QString channel, QString message, QUuid senderID);
     static std::unique_ptr<NLPacketList> encodeMessagesDataPacket(QString channel, QByteArray data, QUuid senderID);
 
+    // The payload of a MessagesData packet, encoded once by the messages mixer and copied into the packet of each recipient
+    static QByteArray encodeMessagesPayload(const QString& channel, bool isText, const QByteArray& messageData,
+                                            const QUuid& senderID);
+    static std::unique_ptr<NLPacketList> encodeMessagesPayloadPacket(const QByteArray& payload);
+
 signals:
     /**jsdoc
      * Triggered when the a text message is received.
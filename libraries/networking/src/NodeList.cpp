@@ -275,6 +275,13 @@ void NodeList::reset(bool skipDomainHandlerReset) {
     setSessionUUID(QUuid());
     setSessionLocalID(Node::NULL_LOCAL_ID);
 
+    // the next domain list has to be a full one
+    _domainListRevision = 0;
+    _pendingDomainListRevision = 0;
+    _pendingDomainListBaseRevision = 0;
+    _pendingDomainListNodes.clear();
+    _hasPendingDomainListRemovedNodes = false;
+
     // if we setup the DTLS socket, also disconnect from the DTLS socket readyRead() so it can handle handshaking
     if (_dtlsSocket) {
         disconnect(_dtlsSocket, 0, this, 0);
@@ -413,6 +420,10 @@ void NodeList::sendDomainServerCheckIn() {
         packetStream << _ownerType.load() << _publicSockAddr << _localSockAddr << _nodeTypesOfInterest.toList();
         packetStream << DependencyManager::get<AddressManager>()->getPlaceName();
 
+        if (domainPacketType == PacketType::DomainListRequest) {
+            packetStream << _domainListRevision;
+        }
+
         if (!_domainHandler.isConnected()) {
             DataServerAccountInfo& accountInfo = accountManager->getAccountInfo();
             packetStream << accountInfo.getUsername();
@@ -689,9 +700,46 @@ void NodeList::processDomainServerList(QSharedPointer<ReceivedMessage> message)
     packetStream >> isAuthenticated;
     setAuthenticatePackets(isAuthenticated);
 
-    // pull each node in the packet
+    // a base revision of zero is a full list, otherwise this only has the nodes that changed since that revision
+    quint32 listRevision;
+    quint32 baseRevision;
+    quint32 listNodeCount;
+    quint32 removedNodeCount;
+    packetStream >> listRevision >> baseRevision >> listNodeCount >> removedNodeCount;
+
+    if (listRevision < _domainListRevision) {
+        // this list was overtaken by one we already have, its entries could be stale
+        return;
+    }
+
+    if (listRevision != _pendingDomainListRevision || baseRevision != _pendingDomainListBaseRevision) {
+        _pendingDomainListRevision = listRevision;
+        _pendingDomainListBaseRevision = baseRevision;
+        _pendingDomainListNodes.clear();
+        _hasPendingDomainListRemovedNodes = false;
+    }
+
+    // pull each node in the packet, the first packet of a delta leads with the removed nodes
     while (packetStream.device()->pos() < message->getSize()) {
-        parseNodeFromPacketStream(packetStream);
+        char segmentType;
+        if (packetStream.device()->peek(&segmentType, 1) == 1 && (NodeType_t)segmentType == DOMAIN_LIST_REMOVED_NODES_SEGMENT) {
+            NodeType_t removedNodesSegment;
+            QList<QUuid> removedNodes;
+            packetStream >> removedNodesSegment >> removedNodes;
+            for (const auto& removedNode : removedNodes) {
+                killNodeWithUUID(removedNode);
+            }
+            _hasPendingDomainListRemovedNodes = true;
+            continue;
+        }
+
+        auto node = parseNodeFromPacketStream(packetStream);
+        _pendingDomainListNodes.insert(node->getUUID());
+    }
+
+    // a list can span several packets that may be lost, only acknowledge it once every node in it has been heard
+    if (_pendingDomainListNodes.size() >= (int)listNodeCount && (removedNodeCount == 0 || _hasPendingDomainListRemovedNodes)) {
+        _domainListRevision = listRevision;
     }
 }
 
@@ -710,7 +758,7 @@ void NodeList::processDomainServerRemovedNode(QSharedPointer<ReceivedMessage> me
     killNodeWithUUID(nodeUUID);
 }
 
-void NodeList::parseNodeFromPacketStream(QDataStream& packetStream) {
+SharedNodePointer NodeList::parseNodeFromPacketStream(QDataStream& packetStream) {
     // setup variables to read into from QDataStream
     qint8 nodeType;
     QUuid nodeUUID, connectionSecretUUID;
@@ -739,6 +787,8 @@ void NodeList::parseNodeFromPacketStream(QDataStream& packetStream) {
         node->setLastHeardMicrostamp(usecTimestampNow());
         node->activatePublicSocket();
     }
+
+    return node;
 }
 
 void NodeList::sendAssignment(Assignment& assignment) {
@@ -158,7 +158,7 @@ private:
 
     void sendDSPathQuery(const QString& newPath);
 
-    void parseNodeFromPacketStream(QDataStream& packetStream);
+    SharedNodePointer parseNodeFromPacketStream(QDataStream& packetStream);
 
     void pingPunchForInactiveNode(const SharedNodePointer& node);
 
@@ -174,6 +174,14 @@ private:
 
     bool _sendDomainServerCheckInEnabled { true };
 
+    // the last domain list revision received in full, acknowledged with each list request so the domain-server
+    // can reply with only the nodes that changed since then
+    quint32 _domainListRevision { 0 };
+    quint32 _pendingDomainListRevision { 0 };
+    quint32 _pendingDomainListBaseRevision { 0 };
+    QSet<QUuid> _pendingDomainListNodes;
+    bool _hasPendingDomainListRemovedNodes { false };
+
     mutable QReadWriteLock _ignoredSetLock;
     tbb::concurrent_unordered_set<QUuid, UUIDHasher> _ignoredNodeIDs;
     mutable QReadWriteLock _personalMutedSetLock;
@@ -12,6 +12,7 @@
 #include "ResourceCache.h"
 #include "ResourceRequestObserver.h"
 
+#include <algorithm>
 #include <cfloat>
 #include <cmath>
 #include <assert.h>
@@ -28,20 +29,203 @@
 #include "NetworkLogging.h"
 #include "NodeList.h"
 
+// requests whose priority changed without being flagged (e.g. an owner was deleted) are caught by a periodic full pass
+static const quint64 REPRIORITIZE_INTERVAL_USECS = USECS_PER_SECOND;
+
+// the concurrency of network protocols adapts to the measured throughput, between this and the request limit
+static const uint32_t MIN_ADAPTIVE_REQUEST_LIMIT = 2;
+static const quint64 ADAPTIVE_LIMIT_WINDOW_USECS = 2 * USECS_PER_SECOND;
+static const float ADAPTIVE_LIMIT_TOLERANCE = 0.05f;
+
+static const float WAIT_AVERAGE_WEIGHT = 0.1f;
+
+static const char* PROTOCOL_NAMES[ResourceCacheSharedItems::NUM_PROTOCOLS] = { "file", "atp", "http", "other" };
+
+const ResourceCacheSharedItems::PendingRequest* ResourceCacheSharedItems::PendingRequestHeap::find(Resource* key) const {
+    auto it = _index.find(key);
+    if (it == _index.end() || _entries[it.value()].resource.data() != key) {
+        return nullptr;
+    }
+    return &_entries[it.value()];
+}
+
+void ResourceCacheSharedItems::PendingRequestHeap::push(const PendingRequest& request) {
+    auto it = _index.find(request.key);
+    if (it != _index.end()) {
+        // replace the entry of a freed resource that lived at the same address
+        int index = it.value();
+        _entries[index] = request;
+        siftUp(index);
+        siftDown(_index.value(request.key));
+        return;
+    }
+
+    _entries.push_back(request);
+    _index.insert(request.key, (int)_entries.size() - 1);
+    siftUp((int)_entries.size() - 1);
+}
+
+ResourceCacheSharedItems::PendingRequest ResourceCacheSharedItems::PendingRequestHeap::pop() {
+    PendingRequest request = _entries.front();
+    removeAt(0);
+    return request;
+}
+
+void ResourceCacheSharedItems::PendingRequestHeap::update(Resource* key, float priority) {
+    auto it = _index.find(key);
+    if (it == _index.end()) {
+        return;
+    }
+
+    int index = it.value();
+    float previousPriority = _entries[index].priority;
+    _entries[index].priority = priority;
+    if (priority > previousPriority) {
+        siftUp(index);
+    } else if (priority < previousPriority) {
+        siftDown(index);
+    }
+}
+
+void ResourceCacheSharedItems::PendingRequestHeap::reprioritizeAll() {
+    for (int i = 0; i < (int)_entries.size();) {
+        auto resource = _entries[i].resource.lock();
+        if (!resource) {
+            _index.remove(_entries[i].key);
+            _entries[i] = _entries.back();
+            _entries.pop_back();
+            continue;
+        }
+        _entries[i].priority = resource->getLoadPriority();
+        i++;
+    }
+
+    _index.clear();
+    for (int i = 0; i < (int)_entries.size(); i++) {
+        _index.insert(_entries[i].key, i);
+    }
+    for (int i = (int)_entries.size() / 2 - 1; i >= 0; i--) {
+        siftDown(i);
+    }
+}
+
+void ResourceCacheSharedItems::PendingRequestHeap::clear() {
+    _entries.clear();
+    _index.clear();
+}
+
+bool ResourceCacheSharedItems::PendingRequestHeap::isHigher(int a, int b) const {
+    const auto& first = _entries[a];
+    const auto& second = _entries[b];
+    return first.priority > second.priority || (first.priority == second.priority && first.sequence < second.sequence);
+}
+
+void ResourceCacheSharedItems::PendingRequestHeap::swapEntries(int a, int b) {
+    std::swap(_entries[a], _entries[b]);
+    _index[_entries[a].key] = a;
+    _index[_entries[b].key] = b;
+}
+
+void ResourceCacheSharedItems::PendingRequestHeap::siftUp(int index) {
+    while (index > 0) {
+        int parent = (index - 1) / 2;
+        if (!isHigher(index, parent)) {
+            break;
+        }
+        swapEntries(index, parent);
+        index = parent;
+    }
+}
+
+void ResourceCacheSharedItems::PendingRequestHeap::siftDown(int index) {
+    int size = (int)_entries.size();
+    while (true) {
+        int highest = index;
+        int left = 2 * index + 1;
+        int right = left + 1;
+        if (left < size && isHigher(left, highest)) {
+            highest = left;
+        }
+        if (right < size && isHigher(right, highest)) {
+            highest = right;
+        }
+        if (highest == index) {
+            break;
+        }
+        swapEntries(index, highest);
+        index = highest;
+    }
+}
+
+void ResourceCacheSharedItems::PendingRequestHeap::removeAt(int index) {
+    _index.remove(_entries[index].key);
+    int last = (int)_entries.size() - 1;
+    if (index != last) {
+        _entries[index] = _entries[last];
+        _index[_entries[index].key] = index;
+    }
+    _entries.pop_back();
+    if (index < (int)_entries.size()) {
+        siftUp(index);
+        siftDown(_index.value(_entries[index].key, index));
+    }
+}
+
+ResourceCacheSharedItems::ResourceCacheSharedItems() {
+    for (int i = 0; i < NUM_PROTOCOLS; i++) {
+        _queues[i].limit = _requestLimit;
+        _queues[i].isAdaptive = (i == ATP_PROTOCOL || i == HTTP_PROTOCOL);
+    }
+}
+
+ResourceCacheSharedItems::RequestProtocol ResourceCacheSharedItems::getRequestProtocol(const QUrl& url) {
+    auto scheme = url.scheme();
+    if (scheme == HIFI_URL_SCHEME_FILE || scheme == URL_SCHEME_QRC) {
+        return FILE_PROTOCOL;
+    } else if (scheme == URL_SCHEME_ATP) {
+        return ATP_PROTOCOL;
+    } else if (scheme == HIFI_URL_SCHEME_HTTP || scheme == HIFI_URL_SCHEME_HTTPS) {
+        return HTTP_PROTOCOL;
+    }
+    return OTHER_PROTOCOL;
+}
+
 bool ResourceCacheSharedItems::appendRequest(QWeakPointer<Resource> resource) {
+    auto locked = resource.lock();
+    if (!locked) {
+        return false;
+    }
+
     Lock lock(_mutex);
-    if ((uint32_t)_loadingRequests.size() < _requestLimit) {
-        _loadingRequests.append(resource);
-        return true;
-    } else {
-        _pendingRequests.append(resource);
+    auto& queue = _queues[getRequestProtocol(locked->getURL())];
+    if (queue.pending.find(locked.data())) {
+        // already queued, the request may have been made again with a new priority
+        queue.pending.update(locked.data(), locked->getLoadPriority());
         return false;
     }
+
+    if ((uint32_t)queue.loading.size() < queue.limit && getLoadingRequestsCount() < _requestLimit) {
+        queue.loading.push_back({ resource, usecTimestampNow() });
+        return true;
+    }
+
+    PendingRequest request;
+    request.resource = resource;
+    request.key = locked.data();
+    request.priority = locked->getLoadPriority();
+    request.sequence = _nextSequence++;
+    request.queuedTime = usecTimestampNow();
+    queue.pending.push(request);
+    locked->_isPendingRequest = true;
+    return false;
 }
 
 void ResourceCacheSharedItems::setRequestLimit(uint32_t limit) {
     Lock lock(_mutex);
     _requestLimit = limit;
+    for (auto& queue : _queues) {
+        queue.limit = limit;
+    }
 }
 
 uint32_t ResourceCacheSharedItems::getRequestLimit() const {
@@ -53,10 +237,12 @@ QList<QSharedPointer<Resource>> ResourceCacheSharedItems::getPendingRequests() c
     QList<QSharedPointer<Resource>> result;
     Lock lock(_mutex);
 
-    foreach (QWeakPointer<Resource> resource, _pendingRequests) {
-        auto locked = resource.lock();
-        if (locked) {
-            result.append(locked);
+    for (const auto& queue : _queues) {
+        for (const auto& request : queue.pending.getEntries()) {
+            auto locked = request.resource.lock();
+            if (locked) {
+                result.append(locked);
+            }
         }
     }
 
@@ -65,17 +251,23 @@ QList<QSharedPointer<Resource>> ResourceCacheSharedItems::getPendingRequests() c
 
 uint32_t ResourceCacheSharedItems::getPendingRequestsCount() const {
     Lock lock(_mutex);
-    return _pendingRequests.size();
+    uint32_t count = 0;
+    for (const auto& queue : _queues) {
+        count += queue.pending.size();
+    }
+    return count;
 }
 
 QList<QSharedPointer<Resource>> ResourceCacheSharedItems::getLoadingRequests() const {
     QList<QSharedPointer<Resource>> result;
     Lock lock(_mutex);
 
-    foreach(QWeakPointer<Resource> resource, _loadingRequests) {
-        auto locked = resource.lock();
-        if (locked) {
-            result.append(locked);
+    for (const auto& queue : _queues) {
+        for (const auto& request : queue.loading) {
+            auto locked = request.resource.lock();
+            if (locked) {
+                result.append(locked);
+            }
         }
     }
 
@@ -84,66 +276,212 @@ QList<QSharedPointer<Resource>> ResourceCacheSharedItems::getLoadingRequests() c
 
 uint32_t ResourceCacheSharedItems::getLoadingRequestsCount() const {
     Lock lock(_mutex);
-    return _loadingRequests.size();
+    uint32_t count = 0;
+    for (const auto& queue : _queues) {
+        count += (uint32_t)queue.loading.size();
+    }
+    return count;
 }
 
 void ResourceCacheSharedItems::removeRequest(QWeakPointer<Resource> resource) {
+    auto locked = resource.lock();
+    auto now = usecTimestampNow();
     Lock lock(_mutex);
 
     // resource can only be removed if it still has a ref-count, as
     // QWeakPointer has no operator== implementation for two weak ptrs, so
     // manually loop in case resource has been freed.
-    for (int i = 0; i < _loadingRequests.size();) {
-        auto request = _loadingRequests.at(i);
-        // Clear our resource and any freed resources
-        if (!request || request.data() == resource.data()) {
-            _loadingRequests.removeAt(i);
-            continue;
+    for (auto& queue : _queues) {
+        bool finished = false;
+        for (size_t i = 0; i < queue.loading.size();) {
+            auto& request = queue.loading[i];
+            // Clear our resource and any freed resources
+            if (!request.resource || request.resource.data() == resource.data()) {
+                if (locked && request.resource.data() == locked.data()) {
+                    queue.windowBytes += locked->getBytesReceived();
+                }
+                queue.loading.erase(queue.loading.begin() + i);
+                finished = true;
+                continue;
+            }
+            i++;
+        }
+
+        if (finished && queue.pending.isEmpty()) {
+            // a free slot with nothing to fill it says nothing about the throughput of more requests
+            queue.windowSaturated = false;
+        }
+        if (queue.isAdaptive) {
+            updateAdaptiveLimit(queue, now);
+        }
+    }
+}
+
+// Hill climbs the concurrency limit: keeps moving it in the same direction while the throughput holds up,
+// and turns around when it drops.  Only windows where the queue stayed busy are taken into account.
+void ResourceCacheSharedItems::updateAdaptiveLimit(ProtocolQueue& queue, quint64 now) {
+    if (queue.windowStart == 0) {
+        queue.windowStart = now;
+        return;
+    }
+
+    quint64 elapsed = now - queue.windowStart;
+    if (elapsed < ADAPTIVE_LIMIT_WINDOW_USECS) {
+        return;
+    }
+
+    float throughput = (float)queue.windowBytes * USECS_PER_SECOND / elapsed;
+    if (queue.windowSaturated && queue.windowBytes > 0) {
+        if (throughput < queue.throughput * (1.0f - ADAPTIVE_LIMIT_TOLERANCE)) {
+            queue.limitDirection = -queue.limitDirection;
+        }
+        uint32_t maxLimit = std::max(_requestLimit, MIN_ADAPTIVE_REQUEST_LIMIT);
+        int newLimit = (int)queue.limit + queue.limitDirection;
+        queue.limit = (uint32_t)std::min(std::max(newLimit, (int)MIN_ADAPTIVE_REQUEST_LIMIT), (int)maxLimit);
+    }
+
+    queue.throughput = throughput;
+    queue.windowStart = now;
+    queue.windowBytes = 0;
+    queue.windowSaturated = !queue.pending.isEmpty();
+}
+
+void ResourceCacheSharedItems::invalidatePriority(Resource* resource) {
+    Lock lock(_mutex);
+    _invalidatedPriorities.insert(resource);
+}
+
+void ResourceCacheSharedItems::processInvalidatedPriorities() {
+    auto now = usecTimestampNow();
+    if (now - _lastReprioritization > REPRIORITIZE_INTERVAL_USECS) {
+        _lastReprioritization = now;
+        _invalidatedPriorities.clear();
+        for (auto& queue : _queues) {
+            queue.pending.reprioritizeAll();
+        }
+        return;
+    }
+
+    for (auto key : _invalidatedPriorities) {
+        for (auto& queue : _queues) {
+            auto request = queue.pending.find(key);
+            if (request) {
+                // the key is only dereferenced once the weak pointer proves it is still alive
+                auto resource = request->resource.lock();
+                if (resource) {
+                    queue.pending.update(key, resource->getLoadPriority());
+                }
+                break;
+            }
         }
-        i++;
     }
+    _invalidatedPriorities.clear();
 }
 
 QSharedPointer<Resource> ResourceCacheSharedItems::getHighestPendingRequest() {
-    // look for the highest priority pending request
-    int highestIndex = -1;
-    float highestPriority = -FLT_MAX;
-    QSharedPointer<Resource> highestResource;
     Lock lock(_mutex);
 
-    bool currentHighestIsFile = false;
+    processInvalidatedPriorities();
+
+    // the request limit caps the requests of all the protocols together
+    if (getLoadingRequestsCount() >= _requestLimit) {
+        return QSharedPointer<Resource>();
+    }
+
+    while (true) {
+        // local files are always started first, otherwise the highest priority request of any protocol with a free slot
+        ProtocolQueue* bestQueue = nullptr;
+        for (int i = 0; i < NUM_PROTOCOLS; i++) {
+            auto& queue = _queues[i];
+            if (queue.pending.isEmpty() || (uint32_t)queue.loading.size() >= queue.limit) {
+                continue;
+            }
+            if (!bestQueue || queue.pending.top().priority > bestQueue->pending.top().priority) {
+                bestQueue = &queue;
+            }
+            if (i == FILE_PROTOCOL) {
+                break;
+            }
+        }
+
+        if (!bestQueue) {
+            return QSharedPointer<Resource>();
+        }
 
-    for (int i = 0; i < _pendingRequests.size();) {
-        // Clear any freed resources
-        auto resource = _pendingRequests.at(i).lock();
+        auto request = bestQueue->pending.pop();
+        auto resource = request.resource.lock();
         if (!resource) {
-            _pendingRequests.removeAt(i);
+            // Clear any freed resources
             continue;
         }
 
-        // Check load priority
+        // the priority may have changed since it was last read, requeue the request if it is no longer the highest
         float priority = resource->getLoadPriority();
-        bool isFile = resource->getURL().scheme() == HIFI_URL_SCHEME_FILE;
-        if (priority >= highestPriority && (isFile || !currentHighestIsFile)) {
-            highestPriority = priority;
-            highestIndex = i;
-            highestResource = resource;
-            currentHighestIsFile = isFile;
+        if (priority != request.priority && !bestQueue->pending.isEmpty() && priority < bestQueue->pending.top().priority) {
+            request.priority = priority;
+            bestQueue->pending.push(request);
+            continue;
         }
-        i++;
-    }
 
-    if (highestIndex >= 0) {
-        _pendingRequests.takeAt(highestIndex);
+        auto now = usecTimestampNow();
+        float waitUsecs = (float)(now - request.queuedTime);
+        bestQueue->averageWaitUsecs = bestQueue->startedRequests == 0 ? waitUsecs :
+            bestQueue->averageWaitUsecs + (waitUsecs - bestQueue->averageWaitUsecs) * WAIT_AVERAGE_WEIGHT;
+        bestQueue->startedRequests++;
+
+        resource->_isPendingRequest = false;
+        bestQueue->loading.push_back({ resource, now });
+        return resource;
     }
+}
+
+QVariantMap ResourceCacheSharedItems::getStats() const {
+    Lock lock(_mutex);
+    auto now = usecTimestampNow();
 
-    return highestResource;
+    QVariantMap stats;
+    uint32_t totalPending = 0;
+    uint32_t totalLoading = 0;
+    for (int i = 0; i < NUM_PROTOCOLS; i++) {
+        const auto& queue = _queues[i];
+
+        quint64 oldestQueuedTime = now;
+        for (const auto& request : queue.pending.getEntries()) {
+            oldestQueuedTime = std::min(oldestQueuedTime, request.queuedTime);
+        }
+
+        QVariantMap protocolStats;
+        protocolStats["pending"] = queue.pending.size();
+        protocolStats["loading"] = (int)queue.loading.size();
+        protocolStats["limit"] = queue.limit;
+        protocolStats["started"] = queue.startedRequests;
+        protocolStats["average_wait_msecs"] = queue.averageWaitUsecs / USECS_PER_MSEC;
+        protocolStats["oldest_pending_msecs"] = (float)(now - oldestQueuedTime) / USECS_PER_MSEC;
+        protocolStats["throughput_kbps"] = queue.throughput / BYTES_PER_KILOBIT;
+        stats[PROTOCOL_NAMES[i]] = protocolStats;
+
+        totalPending += queue.pending.size();
+        totalLoading += (uint32_t)queue.loading.size();
+    }
+    stats["pending"] = totalPending;
+    stats["loading"] = totalLoading;
+    stats["request_limit"] = _requestLimit;
+    return stats;
 }
 
 void ResourceCacheSharedItems::clear() {
     Lock lock(_mutex);
-    _pendingRequests.clear();
-    _loadingRequests.clear();
+    for (auto& queue : _queues) {
+        for (const auto& request : queue.pending.getEntries()) {
+            auto locked = request.resource.lock();
+            if (locked) {
+                locked->_isPendingRequest = false;
+            }
+        }
+        queue.pending.clear();
+        queue.loading.clear();
+    }
+    _invalidatedPriorities.clear();
 }
 
 ScriptableResourceCache::ScriptableResourceCache(QSharedPointer<ResourceCache> resourceCache) {
@@ -333,8 +671,7 @@ void ResourceCache::setRequestLimit(uint32_t limit) {
     sharedItems->setRequestLimit(limit);
 
     // Now go fill any new request spots
-    while (sharedItems->getLoadingRequestsCount() < limit && sharedItems->getPendingRequestsCount() > 0) {
-        attemptHighestPriorityRequest();
+    while (attemptHighestPriorityRequest()) {
     }
 }
 
@@ -497,6 +834,10 @@ uint32_t ResourceCache::getLoadingRequestCount() {
     return DependencyManager::get<ResourceCacheSharedItems>()->getLoadingRequestsCount();
 }
 
+QVariantMap ResourceCache::getRequestStats() {
+    return DependencyManager::get<ResourceCacheSharedItems>()->getStats();
+}
+
 bool ResourceCache::attemptRequest(QSharedPointer<Resource> resource) {
     Q_ASSERT(!resource.isNull());
 
@@ -514,15 +855,19 @@ void ResourceCache::requestCompleted(QWeakPointer<Resource> resource) {
     sharedItems->removeRequest(resource);
 
     // Now go fill any new request spots
-    while (sharedItems->getLoadingRequestsCount() < sharedItems->getRequestLimit() && sharedItems->getPendingRequestsCount() > 0) {
-        attemptHighestPriorityRequest();
+    while (attemptHighestPriorityRequest()) {
     }
 }
 
 bool ResourceCache::attemptHighestPriorityRequest() {
     auto sharedItems = DependencyManager::get<ResourceCacheSharedItems>();
+    // the request already holds its slot, start it directly
     auto resource = sharedItems->getHighestPendingRequest();
-    return (resource && attemptRequest(resource));
+    if (resource) {
+        resource->makeRequest();
+        return true;
+    }
+    return false;
 }
 
 static int requestID = 0;
@@ -552,6 +897,7 @@ void Resource::ensureLoading() {
 void Resource::setLoadPriority(const QPointer<QObject>& owner, float priority) {
     if (!_failedToLoad) {
         _loadPriorities.insert(owner, priority);
+        invalidateLoadPriority();
     }
 }
 
@@ -563,11 +909,20 @@ void Resource::setLoadPriorities(const QHash<QPointer<QObject>, float>& prioriti
             it != priorities.constEnd(); it++) {
         _loadPriorities.insert(it.key(), it.value());
     }
+    invalidateLoadPriority();
 }
 
 void Resource::clearLoadPriority(const QPointer<QObject>& owner) {
     if (!_failedToLoad) {
         _loadPriorities.remove(owner);
+        invalidateLoadPriority();
+    }
+}
+
+void Resource::invalidateLoadPriority() {
+    // only a queued request needs to know, its position in the queue depends on the priority
+    if (_isPendingRequest) {
+        DependencyManager::get<ResourceCacheSharedItems>()->invalidatePriority(this);
     }
 }
 
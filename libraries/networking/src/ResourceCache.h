@@ -14,6 +14,7 @@
 
 #include <atomic>
 #include <mutex>
+#include <vector>
 
 #include <QtCore/QHash>
 #include <QtCore/QList>
@@ -24,6 +25,8 @@
 #include <QtCore/QWeakPointer>
 #include <QtCore/QReadWriteLock>
 #include <QtCore/QQueue>
+#include <QtCore/QSet>
+#include <QtCore/QVariantMap>
 
 #include <QtNetwork/QNetworkReply>
 #include <QtNetwork/QNetworkRequest>
@@ -66,23 +69,105 @@ class ResourceCacheSharedItems : public Dependency  {
     using Lock = std::unique_lock<Mutex>;
 
 public:
+    // Requests are scheduled separately for each kind of protocol, each one with its own concurrency limit,
+    // so that a slow server can't hold back local files or content from another server.
+    // The request limit caps the loading requests of all the protocols together.
+    enum RequestProtocol {
+        FILE_PROTOCOL = 0,
+        ATP_PROTOCOL,
+        HTTP_PROTOCOL,
+        OTHER_PROTOCOL,
+        NUM_PROTOCOLS
+    };
+    static RequestProtocol getRequestProtocol(const QUrl& url);
+
     bool appendRequest(QWeakPointer<Resource> newRequest);
     void removeRequest(QWeakPointer<Resource> doneRequest);
     void setRequestLimit(uint32_t limit);
     uint32_t getRequestLimit() const;
     QList<QSharedPointer<Resource>> getPendingRequests() const;
+    // Takes the highest priority pending request of a protocol that has a free slot and marks it as loading
     QSharedPointer<Resource> getHighestPendingRequest();
     uint32_t getPendingRequestsCount() const;
     QList<QSharedPointer<Resource>> getLoadingRequests() const;
     uint32_t getLoadingRequestsCount() const;
     void clear();
 
+    // Flags a pending request whose load priority changed, it is re-prioritized before the next request is started
+    void invalidatePriority(Resource* resource);
+
+    // Queue depths, wait times, limits and throughput of each protocol
+    QVariantMap getStats() const;
+
+    struct PendingRequest {
+        QWeakPointer<Resource> resource;
+        Resource* key { nullptr };
+        float priority { 0.0f };
+        uint64_t sequence { 0 }; // requests of equal priority are started in the order they were queued
+        quint64 queuedTime { 0 };
+    };
+
+    // Max heap of pending requests, indexed by resource so a request can be re-prioritized in place
+    class PendingRequestHeap {
+    public:
+        bool isEmpty() const { return _entries.empty(); }
+        int size() const { return (int)_entries.size(); }
+        const std::vector<PendingRequest>& getEntries() const { return _entries; }
+
+        const PendingRequest* find(Resource* key) const;
+        const PendingRequest& top() const { return _entries.front(); }
+        void push(const PendingRequest& request);
+        PendingRequest pop();
+        void update(Resource* key, float priority);
+
+        // Re-reads the priority of every request and drops the ones whose resource is gone
+        void reprioritizeAll();
+        void clear();
+
+    private:
+        bool isHigher(int a, int b) const;
+        void swapEntries(int a, int b);
+        void siftUp(int index);
+        void siftDown(int index);
+        void removeAt(int index);
+
+        std::vector<PendingRequest> _entries;
+        QHash<Resource*, int> _index;
+    };
+
 private:
-    ResourceCacheSharedItems() = default;
+    ResourceCacheSharedItems();
+
+    struct LoadingRequest {
+        QWeakPointer<Resource> resource;
+        quint64 startTime { 0 };
+    };
+
+    struct ProtocolQueue {
+        PendingRequestHeap pending;
+        std::vector<LoadingRequest> loading;
+        uint32_t limit { 0 };
+        bool isAdaptive { false };
+
+        // throughput measured over the current window, drives the adaptive limit
+        quint64 windowStart { 0 };
+        quint64 windowBytes { 0 };
+        bool windowSaturated { true };
+        float throughput { 0.0f };
+        int limitDirection { 1 };
+
+        float averageWaitUsecs { 0.0f };
+        quint64 startedRequests { 0 };
+    };
+
+    void processInvalidatedPriorities();
+    void updateAdaptiveLimit(ProtocolQueue& queue, quint64 now);
 
     mutable Mutex _mutex;
-    QList<QWeakPointer<Resource>> _pendingRequests;
-    QList<QWeakPointer<Resource>> _loadingRequests;
+    ProtocolQueue _queues[NUM_PROTOCOLS];
+    QSet<Resource*> _invalidatedPriorities;
+    uint64_t _nextSequence { 0 };
+    quint64 _lastReprioritization { 0 };
     const uint32_t DEFAULT_REQUEST_LIMIT = 10;
     uint32_t _requestLimit { DEFAULT_REQUEST_LIMIT };
 };
@@ -213,6 +298,7 @@ public:
     static QList<QSharedPointer<Resource>> getLoadingRequests();
     static uint32_t getPendingRequestCount();
     static uint32_t getLoadingRequestCount();
+    static QVariantMap getRequestStats();
 
     ResourceCache(QObject* parent = nullptr);
     virtual ~ResourceCache();
@@ -498,10 +584,13 @@ public slots:
 
 private:
     friend class ResourceCache;
+    friend class ResourceCacheSharedItems;
     friend class ScriptableResource;
     
     void setLRUKey(int lruKey) { _lruKey = lruKey; }
-    
+
+    void invalidateLoadPriority();
+
     void retry();
     void reinsert();
 
@@ -514,6 +603,7 @@ private:
     static const int MAX_ATTEMPTS = 8;
     unsigned int _attemptsRemaining { MAX_ATTEMPTS };
     bool _isInScript{ false };
+    std::atomic<bool> _isPendingRequest { false };
 };
 
 uint qHash(const QPointer<QObject>& value, uint seed = 0);
@@ -312,7 +312,8 @@ enum class AvatarMixerPacketVersion : PacketVersion {
     GrabTraits,
     CollisionFlag,
     AvatarTraitsAck,
-    FasterAvatarEntities
+    FasterAvatarEntities,
+    PredictedJointData
 };
 
 enum class DomainConnectRequestVersion : PacketVersion {
@@ -340,7 +341,13 @@ enum class DomainListVersion : PacketVersion {
     PermissionsGrid,
     GetUsernameFromUUIDSupport,
     GetMachineFingerprintFromUUIDSupport,
-    AuthenticationOptional
+    AuthenticationOptional,
+    DeltaUpdates
+};
+
+enum class DomainListRequestVersion : PacketVersion {
+    PreAcknowledgedListRevision = 22,
+    AcknowledgedListRevision
 };
 
 enum class AudioVersion : PacketVersion {
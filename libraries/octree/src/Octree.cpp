@@ -82,9 +82,10 @@ void Octree::recurseElementWithOperation(const OctreeElementPointer& element, co
         return;
     }
 
+    // operations don't modify the tree, so children are visited without taking a reference to them
     if (operation(element, extraData)) {
         for (int i = 0; i < NUMBER_OF_CHILDREN; i++) {
-            OctreeElementPointer child = element->getChildAtIndex(i);
+            const OctreeElementPointer& child = element->getChildRefAtIndex(i);
             if (child) {
                 recurseElementWithOperation(child, operation, extraData, recursionCount + 1);
             }
@@ -107,26 +108,26 @@ bool Octree::recurseElementWithOperationSorted(const OctreeElementPointer& eleme
 
     bool keepSearching = operation(element, extraData);
 
-    std::vector<SortedChild> sortedChildren;
+    SortedChild sortedChildren[NUMBER_OF_CHILDREN];
+    int numSortedChildren = 0;
     for (int i = 0; i < NUMBER_OF_CHILDREN; i++) {
-        OctreeElementPointer child = element->getChildAtIndex(i);
+        const OctreeElementPointer& child = element->getChildRefAtIndex(i);
         if (child) {
             float priority = sortingOperation(child, extraData);
             if (priority < FLT_MAX) {
-                sortedChildren.emplace_back(priority, child);
+                sortedChildren[numSortedChildren++] = SortedChild(priority, &child);
             }
         }
     }
 
-    if (sortedChildren.size() > 1) {
+    if (numSortedChildren > 1) {
         static auto comparator = [](const SortedChild& left, const SortedChild& right) { return left.first < right.first; };
-        std::sort(sortedChildren.begin(), sortedChildren.end(), comparator);
+        std::sort(sortedChildren, sortedChildren + numSortedChildren, comparator);
     }
 
-    for (auto it = sortedChildren.begin(); it != sortedChildren.end(); ++it) {
-        const SortedChild& sortedChild = *it;
+    for (int i = 0; i < numSortedChildren; i++) {
         // Our children were sorted, so if one hits something, we don't need to check the others
-        if (!recurseElementWithOperationSorted(sortedChild.second, operation, sortingOperation, extraData, recursionCount + 1)) {
+        if (!recurseElementWithOperationSorted(*sortedChildren[i].second, operation, sortingOperation, extraData, recursionCount + 1)) {
             return false;
         }
     }
@@ -148,6 +149,7 @@ bool Octree::recurseElementWithOperator(const OctreeElementPointer& element,
 
     if (operatorObject->preRecursion(element)) {
         for (int i = 0; i < NUMBER_OF_CHILDREN; i++) {
+            // operators may add or remove children, so hold on to the child while recursing into it
             OctreeElementPointer child = element->getChildAtIndex(i);
 
             // If there is no child at that location, the Operator may want to create a child at that location.
@@ -177,11 +179,11 @@ OctreeElementPointer Octree::nodeForOctalCode(const OctreeElementPointer& ancest
 
     // find the appropriate branch index based on this ancestorElement
     if (*needleCode > 0) {
-        int branchForNeedle = branchIndexWithDescendant(ancestorElement->getOctalCode(), needleCode);
-        OctreeElementPointer childElement = ancestorElement->getChildAtIndex(branchForNeedle);
+        int branchForNeedle = branchIndexWithDescendant(ancestorElement->getOctalCodeSections(), needleCode);
+        const OctreeElementPointer& childElement = ancestorElement->getChildRefAtIndex(branchForNeedle);
 
         if (childElement) {
-            if (*childElement->getOctalCode() == *needleCode) {
+            if (childElement->getOctalCodeSections() == *needleCode) {
 
                 // If the caller asked for the parent, then give them that too...
                 if (parentOfFoundElement) {
@@ -211,7 +213,11 @@ OctreeElementPointer Octree::createMissingElement(const OctreeElementPointer& la
         HIFI_FCDEBUG(octree(), "Octree::createMissingElement() reached DANGEROUSLY_DEEP_RECURSION, bailing!");
         return lastParentElement;
     }
-    int indexOfNewChild = branchIndexWithDescendant(lastParentElement->getOctalCode(), codeToReach);
+    if (*codeToReach > MAX_OCTAL_CODE_SECTIONS) {
+        HIFI_FCDEBUG(octree(), "Octree::createMissingElement() code deeper than MAX_OCTAL_CODE_SECTIONS, bailing!");
+        return lastParentElement;
+    }
+    int indexOfNewChild = branchIndexWithDescendant(lastParentElement->getOctalCodeSections(), codeToReach);
 
     // If this parent element is a leaf, then you know the child path doesn't exist, so deal with
     // breaking up the leaf first, which will also create a child path
@@ -223,7 +229,7 @@ OctreeElementPointer Octree::createMissingElement(const OctreeElementPointer& la
     }
 
     // This works because we know we traversed down the same tree so if the length is the same, then the whole code is the same
-    if (*lastParentElement->getChildAtIndex(indexOfNewChild)->getOctalCode() == *codeToReach) {
+    if (lastParentElement->getChildRefAtIndex(indexOfNewChild)->getOctalCodeSections() == *codeToReach) {
         return lastParentElement->getChildAtIndex(indexOfNewChild);
     } else {
         return createMissingElement(lastParentElement->getChildAtIndex(indexOfNewChild), codeToReach, recursionCount + 1);
@@ -376,7 +382,7 @@ void Octree::readBitstreamToTree(const unsigned char * bitstream, uint64_t buffe
             return;
         }
 
-        int numberOfThreeBitSectionsFromNode = numberOfThreeBitSectionsInCode(bitstreamRootElement->getOctalCode());
+        int numberOfThreeBitSectionsFromNode = bitstreamRootElement->getOctalCodeSections();
 
         // if the octal code returned is not on the same level as the code being searched for, we have OctreeElements to create
         if (numberOfThreeBitSectionsInStream != numberOfThreeBitSectionsFromNode) {
@@ -454,7 +460,7 @@ void Octree::reaverageOctreeElements(OctreeElementPointer startElement) {
 OctreeElementPointer Octree::getOctreeElementAt(float x, float y, float z, float s) const {
     unsigned char* octalCode = pointToOctalCode(x,y,z,s);
     OctreeElementPointer element = nodeForOctalCode(_rootElement, octalCode, NULL);
-    if (*element->getOctalCode() != *octalCode) {
+    if (element->getOctalCodeSections() != *octalCode) {
         element = NULL;
     }
     delete[] octalCode; // cleanup memory
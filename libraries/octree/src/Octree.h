@@ -51,7 +51,7 @@ public:
 using RecurseOctreeOperation = std::function<bool(const OctreeElementPointer&, void*)>;
 // Function for sorting octree children during recursion.  If return value == FLT_MAX, child is discarded
 using RecurseOctreeSortingOperation = std::function<float(const OctreeElementPointer&, void*)>;
-using SortedChild = std::pair<float, OctreeElementPointer>;
+using SortedChild = std::pair<float, const OctreeElementPointer*>;
 typedef QHash<uint, AACube> CubeList;
 
 const bool NO_EXISTS_BITS         = false;
@@ -14,6 +14,7 @@
 #include <assert.h>
 #include <cmath>
 #include <cstring>
+#include <new>
 #include <stdio.h>
 
 #include <QtCore/QDebug>
@@ -30,6 +31,7 @@
 #include "OctalCode.h"
 #include "Octree.h"
 #include "OctreeConstants.h"
+#include "OctreeElementPool.h"
 #include "OctreeLogging.h"
 #include "OctreeUtils.h"
 #include "SharedUtil.h"
@@ -40,6 +42,10 @@ AtomicUIntStat OctreeElement::_externalChildrenMemoryUsage { 0 };
 AtomicUIntStat OctreeElement::_voxelNodeCount { 0 };
 AtomicUIntStat OctreeElement::_voxelNodeLeafCount { 0 };
 
+const OctreeElementPointer OctreeElement::NULL_CHILD;
+
+static const size_t CHILDREN_BLOCK_SIZE = sizeof(OctreeElementPointer) * NUMBER_OF_CHILDREN;
+
 void OctreeElement::resetPopulationStatistics() {
     _voxelNodeCount = 0;
     _voxelNodeLeafCount = 0;
@@ -60,43 +66,23 @@ void OctreeElement::init(unsigned char * octalCode) {
     _voxelNodeLeafCount++; // all nodes start as leaf nodes
 
 
-    size_t octalCodeLength = bytesRequiredForCodeLength(numberOfThreeBitSectionsInCode(octalCode));
-    if (octalCodeLength > sizeof(_octalCode)) {
-        _octalCode.pointer = octalCode;
-        _octcodePointer = true;
-        _octcodeMemoryUsage += octalCodeLength;
-    } else {
-        _octcodePointer = false;
-        memcpy(_octalCode.buffer, octalCode, octalCodeLength);
-        delete[] octalCode;
+    // the octal code is only kept as the depth and path of the element
+    _octalCodeSections = numberOfThreeBitSectionsInCode(octalCode);
+    assert(_octalCodeSections <= MAX_OCTAL_CODE_SECTIONS);
+    _octalCodePath = glm::uvec3(0);
+    for (int section = 0; section < _octalCodeSections; section++) {
+        int branch = branchIndexWithDescendant(section, octalCode);
+        _octalCodePath = (_octalCodePath << 1u) | glm::uvec3((branch >> 2) & 1, (branch >> 1) & 1, branch & 1);
     }
+    calculateAACube(octalCode);
+    delete[] octalCode;
 
-    // set up the _children union
     _childBitmask = 0;
-    _childrenExternal = false;
-
-
     _childrenCount[0]++;
 
-    // default pointers to child nodes to NULL
-#ifdef SIMPLE_CHILD_ARRAY
-    for (int i = 0; i < NUMBER_OF_CHILDREN; i++) {
-        _simpleChildArray[i] = NULL;
-    }
-#endif
-
-#ifdef SIMPLE_EXTERNAL_CHILDREN
-    _childrenSingle.reset();
-#endif
-
-    for (int i = 0; i < NUMBER_OF_CHILDREN; i ++) {
-        _externalChildren[i].reset();
-    }
-
     _isDirty = true;
     _shouldRender = false;
     _sourceUUIDKey = 0;
-    calculateAACube();
     markWithChangedTime();
 }
 
@@ -106,11 +92,6 @@ OctreeElement::~OctreeElement() {
         _voxelNodeLeafCount--;
     }
 
-    if (_octcodePointer) {
-        _octcodeMemoryUsage -= bytesRequiredForCodeLength(numberOfThreeBitSectionsInCode(getOctalCode()));
-        delete[] _octalCode.pointer;
-    }
-
     // delete all of this node's children, this also takes care of all population tracking data
     deleteAllChildren();
 }
@@ -191,18 +172,39 @@ void OctreeElement::setShouldRender(bool shouldRender) {
     }
 }
 
-void OctreeElement::calculateAACube() {
+void OctreeElement::calculateAACube(const unsigned char* octalCode) {
     // copy corner into cube
     glm::vec3 corner;
-    copyFirstVertexForCode(getOctalCode(), (float*)&corner);
+    copyFirstVertexForCode(octalCode, (float*)&corner);
 
     // this tells you the "size" of the voxel
-    float voxelScale = (float)TREE_SCALE / powf(2.0f, numberOfThreeBitSectionsInCode(getOctalCode()));
+    float voxelScale = (float)TREE_SCALE / powf(2.0f, numberOfThreeBitSectionsInCode(octalCode));
     corner *= (float)TREE_SCALE;
     corner -= (float)HALF_TREE_SCALE;
     _cube.setBox(corner, voxelScale);
 }
 
+unsigned char* OctreeElement::createOctalCode() const {
+    int sections = _octalCodeSections;
+    size_t octalCodeLength = bytesRequiredForCodeLength(sections);
+    unsigned char* octalCode = new unsigned char[octalCodeLength];
+    memset(octalCode, 0, octalCodeLength);
+    octalCode[0] = sections;
+
+    for (int section = 0; section < sections; section++) {
+        int shift = sections - 1 - section;
+        glm::uvec3 bits = (_octalCodePath >> (unsigned int)shift) & 1u;
+        int branch = (bits.x << 2) | (bits.y << 1) | bits.z;
+        for (int bit = 0; bit < 3; bit++) {
+            int codeBit = section * 3 + bit;
+            if (branch & (4 >> bit)) {
+                octalCode[1 + codeBit / 8] |= 0x80 >> (codeBit % 8);
+            }
+        }
+    }
+    return octalCode;
+}
+
 void OctreeElement::deleteChildAtIndex(int childIndex) {
     OctreeElementPointer childAt = getChildAtIndex(childIndex);
     if (childAt) {
@@ -253,56 +255,17 @@ AtomicUIntStat OctreeElement::_setChildAtIndexCalls { 0 };
 AtomicUIntStat OctreeElement::_externalChildrenCount { 0 };
 AtomicUIntStat OctreeElement::_childrenCount[NUMBER_OF_CHILDREN + 1];
 
-OctreeElementPointer OctreeElement::getChildAtIndex(int childIndex) const {
-#ifdef SIMPLE_CHILD_ARRAY
-    return _simpleChildArray[childIndex];
-#endif // SIMPLE_CHILD_ARRAY
-
-#ifdef SIMPLE_EXTERNAL_CHILDREN
-    int childCount = getChildCount();
-
-    switch (childCount) {
-        case 0: {
-            return NULL;
-        } break;
-
-        case 1: {
-            // if our single child is the one being requested, return it, otherwise
-            // return null
-            int firstIndex = getNthBit(_childBitmask, 1);
-            if (firstIndex == childIndex) {
-                return _childrenSingle;
-            } else {
-                return NULL;
-            }
-        } break;
-
-        default : {
-            return _externalChildren[childIndex];
-        } break;
-    }
-#endif // def SIMPLE_EXTERNAL_CHILDREN
-}
-
 void OctreeElement::deleteAllChildren() {
-    // first delete all the OctreeElement objects...
-    for (int i = 0; i < NUMBER_OF_CHILDREN; i++) {
-        OctreeElementPointer childAt = getChildAtIndex(i);
-        if (childAt) {
-            childAt.reset();
-        }
-    }
-
-    if (_childrenExternal) {
-        // if the children_t union represents _children.external we need to delete it here
-        for (int i = 0; i < NUMBER_OF_CHILDREN; i ++) {
-            _externalChildren[i].reset();
-        }
+    if (_children) {
+        _children->~Children();
+        OctreeBlockPool::deallocate<CHILDREN_BLOCK_SIZE>(_children);
+        _children = nullptr;
+        _externalChildrenCount--;
+        _externalChildrenMemoryUsage -= sizeof(Children);
     }
 }
 
 void OctreeElement::setChildAtIndex(int childIndex, const OctreeElementPointer& child) {
-#ifdef SIMPLE_CHILD_ARRAY
     int previousChildCount = getChildCount();
     if (child) {
         setAtBit(_childBitmask, childIndex);
@@ -311,72 +274,23 @@ void OctreeElement::setChildAtIndex(int childIndex, const OctreeElementPointer&
     }
     int newChildCount = getChildCount();
 
-    // store the child in our child array
-    _simpleChildArray[childIndex] = child;
-
     // track our population data
     if (previousChildCount != newChildCount) {
         _childrenCount[previousChildCount]--;
         _childrenCount[newChildCount]++;
     }
-#endif
-
-#ifdef SIMPLE_EXTERNAL_CHILDREN
 
-    int firstIndex = getNthBit(_childBitmask, 1);
-    int secondIndex = getNthBit(_childBitmask, 2);
-
-    int previousChildCount = getChildCount();
-    if (child) {
-        setAtBit(_childBitmask, childIndex);
-    } else {
-        clearAtBit(_childBitmask, childIndex);
-    }
-    int newChildCount = getChildCount();
-
-    // track our population data
-    if (previousChildCount != newChildCount) {
-        _childrenCount[previousChildCount]--;
-        _childrenCount[newChildCount]++;
+    // the block of children only exists while there are children, so leaves don't pay for it
+    if (newChildCount == 0) {
+        deleteAllChildren();
+        return;
     }
-
-    if ((previousChildCount == 0 || previousChildCount == 1) && newChildCount == 0) {
-        _childrenSingle.reset();
-    } else if (previousChildCount == 0 && newChildCount == 1) {
-        _childrenSingle = child;
-    } else if (previousChildCount == 1 && newChildCount == 2) {
-        OctreeElementPointer previousChild = _childrenSingle;
-        for (int i = 0; i < NUMBER_OF_CHILDREN; i ++) {
-            _externalChildren[i].reset();
-        }
-        _externalChildren[firstIndex] = previousChild;
-        _externalChildren[childIndex] = child;
-
-        _childrenExternal = true;
-
-        _externalChildrenMemoryUsage += NUMBER_OF_CHILDREN * sizeof(OctreeElementPointer);
-
-    } else if (previousChildCount == 2 && newChildCount == 1) {
-        assert(!child); // we are removing a child, so this must be true!
-        OctreeElementPointer previousFirstChild = _externalChildren[firstIndex];
-        OctreeElementPointer previousSecondChild = _externalChildren[secondIndex];
-
-        for (int i = 0; i < NUMBER_OF_CHILDREN; i ++) {
-            _externalChildren[i].reset();
-        }
-        _childrenExternal = false;
-
-        _externalChildrenMemoryUsage -= NUMBER_OF_CHILDREN * sizeof(OctreeElementPointer);
-        if (childIndex == firstIndex) {
-            _childrenSingle = previousSecondChild;
-        } else {
-            _childrenSingle = previousFirstChild;
-        }
-    } else {
-        _externalChildren[childIndex] = child;
+    if (!_children) {
+        _children = new (OctreeBlockPool::allocate<CHILDREN_BLOCK_SIZE>()) Children();
+        _externalChildrenCount++;
+        _externalChildrenMemoryUsage += sizeof(Children);
     }
-
-#endif // def SIMPLE_EXTERNAL_CHILDREN
+    _children->elements[childIndex] = child;
 }
 
 
@@ -388,7 +302,9 @@ OctreeElementPointer OctreeElement::addChildAtIndex(int childIndex) {
             _voxelNodeLeafCount--;
         }
 
-        unsigned char* newChildCode = childOctalCode(getOctalCode(), childIndex);
+        unsigned char* octalCode = createOctalCode();
+        unsigned char* newChildCode = childOctalCode(octalCode, childIndex);
+        delete[] octalCode;
         childAt = createNewElement(newChildCode);
         setChildAtIndex(childIndex, childAt);
 
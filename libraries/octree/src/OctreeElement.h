@@ -12,8 +12,6 @@
 #ifndef hifi_OctreeElement_h
 #define hifi_OctreeElement_h
 
-//#define SIMPLE_CHILD_ARRAY
-#define SIMPLE_EXTERNAL_CHILDREN
 
 #include <atomic>
 
@@ -108,8 +106,16 @@ public:
                         glm::vec3& penetration, void** penetratedObject) const;
 
     // Base class methods you don't need to implement
-    const unsigned char* getOctalCode() const { return (_octcodePointer) ? _octalCode.pointer : &_octalCode.buffer[0]; }
-    OctreeElementPointer getChildAtIndex(int childIndex) const;
+    /// The number of three bit sections in the octal code of this element, which is its depth in the tree
+    int getOctalCodeSections() const { return _octalCodeSections; }
+    /// Rebuilds the octal code of this element from its path, the caller must delete[] the returned buffer
+    unsigned char* createOctalCode() const;
+    OctreeElementPointer getChildAtIndex(int childIndex) const { return getChildRefAtIndex(childIndex); }
+    /// Returns the child without taking a reference to it, for traversals that don't modify the tree. The reference is only
+    /// valid until the children of this element change.
+    const OctreeElementPointer& getChildRefAtIndex(int childIndex) const {
+        return _children ? _children->elements[childIndex] : NULL_CHILD;
+    }
     void deleteChildAtIndex(int childIndex);
     OctreeElementPointer removeChildAtIndex(int childIndex);
     bool isParentOf(const OctreeElementPointer& possibleChild) const;
@@ -121,7 +127,7 @@ public:
     const AACube& getAACube() const { return _cube; }
     const glm::vec3& getCorner() const { return _cube.getCorner(); }
     float getScale() const { return _cube.getScale(); }
-    int getLevel() const { return numberOfThreeBitSectionsInCode(getOctalCode()) + 1; }
+    int getLevel() const { return _octalCodeSections + 1; }
 
     float getEnclosingRadius() const;
     bool isInView(const ViewFrustum& viewFrustum) const { return computeViewIntersection(viewFrustum) != ViewFrustum::OUTSIDE; }
@@ -214,30 +220,27 @@ protected:
     void deleteAllChildren();
     void setChildAtIndex(int childIndex, const OctreeElementPointer& child);
 
-    void calculateAACube();
+    void calculateAACube(const unsigned char* octalCode);
 
     AACube _cube; /// Client and server, axis aligned box for bounds of this voxel, 48 bytes
 
-    /// Client and server, buffer containing the octal code or a pointer to octal code for this node, 8 bytes
-    union octalCode_t {
-      unsigned char buffer[8];
-      unsigned char* pointer;
-    } _octalCode;
+    /// Client and server, depth of this node.  Its octal code is rebuilt from its path below, 1 byte
+    unsigned char _octalCodeSections { 0 };
+
+    /// Client and server, the branches taken from the root to this node, one bit per level on each axis with the root's
+    /// branch in the highest bit.  The float cube can't tell the branches apart at the deepest levels, 12 bytes
+    glm::uvec3 _octalCodePath { 0 };
 
     quint64 _lastChanged; /// Client and server, timestamp this node was last changed, 8 bytes
     uint64_t _lastChangedContent { 0 };
 
-    /// Client and server, pointers to child nodes, various encodings
-#ifdef SIMPLE_CHILD_ARRAY
-    OctreeElementPointer _simpleChildArray[8]; /// Only used when SIMPLE_CHILD_ARRAY is enabled
-#endif
-
-#ifdef SIMPLE_EXTERNAL_CHILDREN
-    // union children_t {
-    OctreeElementPointer _childrenSingle;
-    OctreeElementPointer _externalChildren[NUMBER_OF_CHILDREN];
-    // } _children;
-#endif
+    /// Client and server, pointers to child nodes stored contiguously in a pooled block, only allocated while this
+    /// element has children, 8 bytes
+    struct Children {
+        OctreeElementPointer elements[NUMBER_OF_CHILDREN];
+    };
+    Children* _children { nullptr };
+    static const OctreeElementPointer NULL_CHILD;
 
     uint16_t _sourceUUIDKey; /// Client only, stores node id of voxel server that sent his voxel, 2 bytes
 
@@ -253,9 +256,7 @@ protected:
     bool _falseColored : 1, /// Client only, is this voxel false colored, 1 bit
          _isDirty : 1, /// Client only, has this voxel changed since being rendered, 1 bit
          _shouldRender : 1, /// Client only, should this voxel render at this time, 1 bit
-         _octcodePointer : 1, /// Client and Server only, is this voxel's octal code a pointer or buffer, 1 bit
-         _unknownBufferIndex : 1,
-         _childrenExternal : 1; /// Client only, is this voxel's VBO buffer the unknown buffer index, 1 bit
+         _unknownBufferIndex : 1; /// Client only, is this voxel's VBO buffer the unknown buffer index, 1 bit
 
     static AtomicUIntStat _voxelNodeCount;
     static AtomicUIntStat _voxelNodeLeafCount;
@@ -0,0 +1,173 @@
+//
+//  OctreeElementPool.cpp
+//  libraries/octree/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "OctreeElementPool.h"
+
+#include <algorithm>
+#include <assert.h>
+
+// An empty slab is kept, so a tree growing and shrinking around a slab boundary doesn't free and allocate it each time
+static const size_t MAX_EMPTY_SLABS = 1;
+
+// blocks are laid out back to back in a slab, keep each one aligned for any type
+static size_t alignedBlockSize(size_t blockSize) {
+    const size_t ALIGNMENT = alignof(std::max_align_t);
+    blockSize = std::max(blockSize, sizeof(void*));
+    return (blockSize + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+}
+
+OctreeBlockPool::OctreeBlockPool(size_t blockSize, size_t blocksPerSlab) :
+    _blockSize(alignedBlockSize(blockSize)),
+    _blocksPerSlab(std::max(blocksPerSlab, (size_t)1))
+{
+}
+
+void* OctreeBlockPool::allocateCached(ThreadCache& cache) {
+    if (!cache.blocks) {
+        cache.numBlocks = cache.isClosed ? 1 : THREAD_CACHE_BATCH;
+        acquire(cache.blocks, cache.numBlocks);
+    }
+    FreeBlock* block = cache.blocks;
+    cache.blocks = block->next;
+    --cache.numBlocks;
+    return block;
+}
+
+void OctreeBlockPool::deallocateCached(ThreadCache& cache, void* block) {
+    if (!block) {
+        return;
+    }
+    FreeBlock* freeBlock = static_cast<FreeBlock*>(block);
+    freeBlock->next = cache.blocks;
+    cache.blocks = freeBlock;
+    ++cache.numBlocks;
+    if (cache.isClosed) {
+        flushCache(cache);
+    } else if (cache.numBlocks >= 2 * THREAD_CACHE_BATCH) {
+        release(cache.blocks, THREAD_CACHE_BATCH);
+        cache.numBlocks -= THREAD_CACHE_BATCH;
+    }
+}
+
+void OctreeBlockPool::flushCache(ThreadCache& cache) {
+    if (cache.blocks) {
+        release(cache.blocks, cache.numBlocks);
+        cache.numBlocks = 0;
+    }
+}
+
+OctreeBlockPool::ThreadCacheCloser::~ThreadCacheCloser() {
+    _pool.flushCache(_cache);
+    _cache.isClosed = true;
+}
+
+void OctreeBlockPool::acquire(FreeBlock*& blocks, size_t count) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (size_t i = 0; i < count; i++) {
+        Slab* slab = _freeSlabs ? _freeSlabs : addSlab();
+        if (slab->numFreeBlocks == _blocksPerSlab) {
+            --_numEmptySlabs;
+        }
+
+        FreeBlock* block = slab->freeBlocks;
+        slab->freeBlocks = block->next;
+        if (--slab->numFreeBlocks == 0) {
+            unlinkFreeSlab(slab);
+        }
+
+        block->next = blocks;
+        blocks = block;
+    }
+    _allocatedBlocks += count;
+}
+
+void OctreeBlockPool::release(FreeBlock*& blocks, size_t count) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (size_t i = 0; i < count; i++) {
+        FreeBlock* block = blocks;
+        blocks = block->next;
+
+        // the slab of a block is the last one starting at or before it
+        auto it = _slabs.upper_bound(reinterpret_cast<uintptr_t>(block));
+        assert(it != _slabs.begin());
+        --it;
+        Slab* slab = &it->second;
+
+        block->next = slab->freeBlocks;
+        slab->freeBlocks = block;
+        if (slab->numFreeBlocks++ == 0) {
+            linkFreeSlab(slab);
+        }
+
+        if (slab->numFreeBlocks == _blocksPerSlab) {
+            if (_numEmptySlabs < MAX_EMPTY_SLABS) {
+                ++_numEmptySlabs;
+            } else {
+                unlinkFreeSlab(slab);
+                _slabs.erase(it);
+            }
+        }
+    }
+    _allocatedBlocks -= count;
+}
+
+size_t OctreeBlockPool::getAllocatedBlocks() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _allocatedBlocks;
+}
+
+size_t OctreeBlockPool::getNumSlabs() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _slabs.size();
+}
+
+size_t OctreeBlockPool::getSlabMemoryUsage() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _slabs.size() * _blocksPerSlab * _blockSize;
+}
+
+OctreeBlockPool::Slab* OctreeBlockPool::addSlab() {
+    char* memory = new char[_blocksPerSlab * _blockSize];
+    Slab* slab = &_slabs[reinterpret_cast<uintptr_t>(memory)];
+    slab->memory.reset(memory);
+
+    // thread the blocks on the free list in address order so consecutive allocations are adjacent
+    for (size_t i = _blocksPerSlab; i > 0; --i) {
+        FreeBlock* block = reinterpret_cast<FreeBlock*>(memory + (i - 1) * _blockSize);
+        block->next = slab->freeBlocks;
+        slab->freeBlocks = block;
+    }
+    slab->numFreeBlocks = _blocksPerSlab;
+    ++_numEmptySlabs;
+    linkFreeSlab(slab);
+    return slab;
+}
+
+void OctreeBlockPool::linkFreeSlab(Slab* slab) {
+    slab->previous = nullptr;
+    slab->next = _freeSlabs;
+    if (_freeSlabs) {
+        _freeSlabs->previous = slab;
+    }
+    _freeSlabs = slab;
+}
+
+void OctreeBlockPool::unlinkFreeSlab(Slab* slab) {
+    if (slab->previous) {
+        slab->previous->next = slab->next;
+    } else {
+        _freeSlabs = slab->next;
+    }
+    if (slab->next) {
+        slab->next->previous = slab->previous;
+    }
+    slab->previous = nullptr;
+    slab->next = nullptr;
+}
@@ -0,0 +1,122 @@
+//
+//  OctreeElementPool.h
+//  libraries/octree/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OctreeElementPool_h
+#define hifi_OctreeElementPool_h
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+
+// Hands out fixed size blocks carved from slabs, so the many small allocations of an octree are packed together
+// instead of each paying for its own heap allocation.  A slab is freed once all of its blocks are back in the pool.
+//
+// Each thread keeps a small cache of free blocks of each size, so allocating and freeing only take the lock of the pool
+// once per batch of blocks.  A cache is given back to the pool when its thread ends.
+class OctreeBlockPool {
+public:
+    static const size_t DEFAULT_BLOCKS_PER_SLAB = 256;
+
+    // blocks moved at once between the pool and a thread cache, which holds at most twice as many
+    static const size_t THREAD_CACHE_BATCH = 32;
+
+    template <size_t BlockSize>
+    static void* allocate() { return forSize<BlockSize>().allocateCached(threadCache<BlockSize>()); }
+
+    template <size_t BlockSize>
+    static void deallocate(void* block) { forSize<BlockSize>().deallocateCached(threadCache<BlockSize>(), block); }
+
+    // Gives the blocks cached by the calling thread back to the pool, so that their slabs can be freed
+    template <size_t BlockSize>
+    static void flushThreadCache() { forSize<BlockSize>().flushCache(threadCache<BlockSize>()); }
+
+    // One pool per block size, shared by every tree.  The pools are never destroyed since elements may be released
+    // during static destruction, but they don't keep any slab once their blocks are released.
+    template <size_t BlockSize>
+    static OctreeBlockPool& forSize() {
+        static OctreeBlockPool* pool = new OctreeBlockPool(BlockSize);
+        return *pool;
+    }
+
+    size_t getBlockSize() const { return _blockSize; }
+
+    // blocks out of the pool, including the free blocks cached by threads
+    size_t getAllocatedBlocks() const;
+    size_t getNumSlabs() const;
+    size_t getSlabMemoryUsage() const;
+
+private:
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    struct Slab {
+        std::unique_ptr<char[]> memory;
+        FreeBlock* freeBlocks { nullptr };
+        size_t numFreeBlocks { 0 };
+
+        // in the list of slabs with free blocks
+        Slab* previous { nullptr };
+        Slab* next { nullptr };
+    };
+
+    // Trivially destructible, so that blocks released by the destructors of other thread locals or statics still find it.
+    // Once its thread has ended, the blocks go straight to the pool.
+    struct ThreadCache {
+        FreeBlock* blocks;
+        size_t numBlocks;
+        bool isClosed;
+    };
+
+    class ThreadCacheCloser {
+    public:
+        ThreadCacheCloser(OctreeBlockPool& pool, ThreadCache& cache) : _pool(pool), _cache(cache) {}
+        ~ThreadCacheCloser();
+
+    private:
+        OctreeBlockPool& _pool;
+        ThreadCache& _cache;
+    };
+
+    template <size_t BlockSize>
+    static ThreadCache& threadCache() {
+        static thread_local ThreadCache cache { nullptr, 0, false };
+        static thread_local ThreadCacheCloser closer(forSize<BlockSize>(), cache);
+        return cache;
+    }
+
+    OctreeBlockPool(size_t blockSize, size_t blocksPerSlab = DEFAULT_BLOCKS_PER_SLAB);
+
+    void* allocateCached(ThreadCache& cache);
+    void deallocateCached(ThreadCache& cache, void* block);
+    void flushCache(ThreadCache& cache);
+
+    // move count blocks from the pool to the list, and back
+    void acquire(FreeBlock*& blocks, size_t count);
+    void release(FreeBlock*& blocks, size_t count);
+
+    // must be called with _mutex held
+    Slab* addSlab();
+    void linkFreeSlab(Slab* slab);
+    void unlinkFreeSlab(Slab* slab);
+
+    const size_t _blockSize;
+    const size_t _blocksPerSlab;
+
+    mutable std::mutex _mutex;
+    std::map<uintptr_t, Slab> _slabs; // by address, to find the slab of a block
+    Slab* _freeSlabs { nullptr };
+    size_t _numEmptySlabs { 0 };
+    size_t _allocatedBlocks { 0 };
+};
+
+#endif // hifi_OctreeElementPool_h
@@ -180,6 +180,9 @@ public:
     virtual PickResultPointer getAvatarIntersection(const T& pick) = 0;
     virtual PickResultPointer getHUDIntersection(const T& pick) = 0;
 
+    // Whether getEntityIntersection can be called from a worker thread while the main thread computes other intersections
+    virtual bool canIntersectEntitiesOffMainThread() const { return false; }
+
 protected:
     T _mathPick;
 };
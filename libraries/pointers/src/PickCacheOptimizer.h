@@ -8,7 +8,11 @@
 #ifndef hifi_PickCacheOptimizer_h
 #define hifi_PickCacheOptimizer_h
 
+#include <atomic>
+#include <functional>
+#include <memory>
 #include <unordered_map>
+#include <vector>
 
 #include "Pick.h"
 
@@ -31,6 +35,9 @@ namespace std {
     };
 }
 
+// Starts jobs on worker threads, returns without waiting for them
+using PickJobStarter = std::function<void(std::vector<std::function<void()>>& jobs)>;
+
 // T is a mathematical representation of a Pick (a MathPick)
 // For example: RayPicks use T = PickRay
 template<typename T>
@@ -39,9 +46,53 @@ class PickCacheOptimizer {
 public:
     QVector4D update(std::unordered_map<uint32_t, std::shared_ptr<PickQuery>>& picks, uint32_t& nextToUpdate, uint64_t expiry, bool shouldPickHUD);
 
+    // Updates every pick in one pass: the intersections needed by all the picks are gathered first, picks that share the
+    // same MathPick and filter share the same intersection, then the entity intersections of the picks that support it
+    // are started on worker threads while the main thread computes the others.  The results of a pass that started
+    // worker jobs are set on its picks by the next call, once the jobs are done, so the main thread never waits for them.
+    // While they are still running the next pass is skipped and the picks keep their previous results.
+    QVector4D updateBatched(std::unordered_map<uint32_t, std::shared_ptr<PickQuery>>& picks, bool shouldPickHUD, const PickJobStarter& startJobs);
+
+    // Forgets the pass waiting for its worker jobs, its results are never set
+    void discardBatch() { _pendingBatch.reset(); }
+
 protected:
     typedef std::unordered_map<T, std::unordered_map<PickCacheKey, PickResultPointer>> PickCache;
 
+    enum IntersectionTarget {
+        ENTITY_TARGET = 0,
+        OVERLAY_TARGET,
+        AVATAR_TARGET,
+        HUD_TARGET,
+        NUM_TARGETS
+    };
+
+    struct BatchedIntersection {
+        std::shared_ptr<Pick<T>> pick;
+        T mathPick;
+        PickResultPointer result;
+    };
+
+    struct BatchedPick {
+        std::shared_ptr<Pick<T>> pick;
+        T mathPick;
+        int intersections[NUM_TARGETS];
+    };
+
+    typedef std::unordered_map<T, std::unordered_map<PickCacheKey, int>> BatchedIntersectionIndex;
+
+    // Shared with the worker jobs, which may outlive a discarded pass
+    struct Batch {
+        std::vector<BatchedPick> picks;
+        std::vector<BatchedIntersection> intersections[NUM_TARGETS];
+        std::atomic<int> remainingJobs { 0 };
+    };
+    std::shared_ptr<Batch> _pendingBatch;
+
+    static void publishBatch(Batch& batch);
+
+    static PickResultPointer computeIntersection(IntersectionTarget target, BatchedIntersection& intersection);
+
     // Returns true if this pick exists in the cache, and if it does, update res if the cached result is closer
     bool checkAndCompareCachedResults(T& pick, PickCache& cache, PickResultPointer& res, const PickCacheKey& key);
     void cacheResult(const bool intersects, const PickResultPointer& resTemp, const PickCacheKey& key, PickResultPointer& res, T& mathPick, PickCache& cache, const std::shared_ptr<Pick<T>> pick);
@@ -153,4 +204,157 @@ QVector4D PickCacheOptimizer<T>::update(std::unordered_map<uint32_t, std::shared
     return numIntersectionsComputed;
 }
 
+template<typename T>
+PickResultPointer PickCacheOptimizer<T>::computeIntersection(IntersectionTarget target, BatchedIntersection& intersection) {
+    switch (target) {
+        case ENTITY_TARGET:
+            return intersection.pick->getEntityIntersection(intersection.mathPick);
+        case OVERLAY_TARGET:
+            return intersection.pick->getOverlayIntersection(intersection.mathPick);
+        case AVATAR_TARGET:
+            return intersection.pick->getAvatarIntersection(intersection.mathPick);
+        case HUD_TARGET:
+            return intersection.pick->getHUDIntersection(intersection.mathPick);
+        default:
+            return PickResultPointer();
+    }
+}
+
+template<typename T>
+QVector4D PickCacheOptimizer<T>::updateBatched(std::unordered_map<uint32_t, std::shared_ptr<PickQuery>>& picks,
+        bool shouldPickHUD, const PickJobStarter& startJobs) {
+    QVector4D numIntersectionsComputed;
+
+    // Publish the previous pass once its workers are done, without waiting for them
+    if (_pendingBatch) {
+        if (_pendingBatch->remainingJobs > 0) {
+            return numIntersectionsComputed;
+        }
+        publishBatch(*_pendingBatch);
+        _pendingBatch.reset();
+    }
+
+    auto batch = std::make_shared<Batch>();
+    auto& intersections = batch->intersections;
+    BatchedIntersectionIndex intersectionIndices[NUM_TARGETS];
+    batch->picks.reserve(picks.size());
+
+    // Returns the index of the intersection with this MathPick and key, the first pick that needs it computes it
+    auto addIntersection = [&](IntersectionTarget target, const std::shared_ptr<Pick<T>>& pick, T& mathPick, const PickCacheKey& key) {
+        auto& indices = intersectionIndices[target][mathPick];
+        auto indexItr = indices.find(key);
+        if (indexItr != indices.end()) {
+            return indexItr->second;
+        }
+        int index = (int)intersections[target].size();
+        intersections[target].push_back({ pick, mathPick, PickResultPointer() });
+        indices[key] = index;
+        return index;
+    };
+
+    // Gather the intersections needed by every active pick
+    for (auto& pickItr : picks) {
+        std::shared_ptr<Pick<T>> pick = std::static_pointer_cast<Pick<T>>(pickItr.second);
+        T mathematicalPick = pick->getMathematicalPick();
+
+        if (!pick->isEnabled() || pick->getMaxDistance() < 0.0f || !mathematicalPick) {
+            pick->setPickResult(pick->getDefaultResult(mathematicalPick.toVariantMap()));
+            continue;
+        }
+
+        BatchedPick batchedPick { pick, mathematicalPick, { -1, -1, -1, -1 } };
+        PickFilter filter = pick->getFilter();
+        if (filter.doesPickDomainEntities() || filter.doesPickAvatarEntities()) {
+            PickCacheKey entityKey = { filter.getEntityFlags(), pick->getIncludeItems(), pick->getIgnoreItems() };
+            batchedPick.intersections[ENTITY_TARGET] = addIntersection(ENTITY_TARGET, pick, mathematicalPick, entityKey);
+        }
+        if (filter.doesPickLocalEntities()) {
+            PickCacheKey overlayKey = { filter.getOverlayFlags(), pick->getIncludeItems(), pick->getIgnoreItems() };
+            batchedPick.intersections[OVERLAY_TARGET] = addIntersection(OVERLAY_TARGET, pick, mathematicalPick, overlayKey);
+        }
+        if (filter.doesPickAvatars()) {
+            PickCacheKey avatarKey = { filter.getAvatarFlags(), pick->getIncludeItems(), pick->getIgnoreItems() };
+            batchedPick.intersections[AVATAR_TARGET] = addIntersection(AVATAR_TARGET, pick, mathematicalPick, avatarKey);
+        }
+        // Can't intersect with HUD in desktop mode
+        if (filter.doesPickHUD() && shouldPickHUD) {
+            PickCacheKey hudKey = { filter.getHUDFlags(), QVector<QUuid>(), QVector<QUuid>() };
+            batchedPick.intersections[HUD_TARGET] = addIntersection(HUD_TARGET, pick, mathematicalPick, hudKey);
+        }
+        batch->picks.push_back(batchedPick);
+    }
+
+    // Entity intersections that are safe to compute off the main thread go to the workers, the others are computed now
+    std::vector<std::function<void()>> jobs;
+    for (size_t i = 0; i < intersections[ENTITY_TARGET].size(); i++) {
+        auto& intersection = intersections[ENTITY_TARGET][i];
+        if (intersection.pick->canIntersectEntitiesOffMainThread()) {
+            jobs.push_back([batch, i] {
+                auto& intersection = batch->intersections[ENTITY_TARGET][i];
+                intersection.result = computeIntersection(ENTITY_TARGET, intersection);
+                batch->remainingJobs--;
+            });
+        }
+    }
+    batch->remainingJobs = (int)jobs.size();
+    if (!jobs.empty()) {
+        startJobs(jobs);
+    }
+
+    for (auto& intersection : intersections[ENTITY_TARGET]) {
+        if (!intersection.pick->canIntersectEntitiesOffMainThread()) {
+            intersection.result = computeIntersection(ENTITY_TARGET, intersection);
+        }
+    }
+    for (int target = OVERLAY_TARGET; target < NUM_TARGETS; target++) {
+        for (auto& intersection : intersections[target]) {
+            intersection.result = computeIntersection((IntersectionTarget)target, intersection);
+        }
+    }
+
+    for (int target = ENTITY_TARGET; target < NUM_TARGETS; target++) {
+        numIntersectionsComputed[target] = (float)intersections[target].size();
+    }
+
+    // A pass without worker jobs is done already
+    if (jobs.empty()) {
+        publishBatch(*batch);
+    } else {
+        _pendingBatch = batch;
+    }
+    return numIntersectionsComputed;
+}
+
+// Combine the results of each pick, with the same semantics as the cached results of update()
+template<typename T>
+void PickCacheOptimizer<T>::publishBatch(Batch& batch) {
+    for (auto& batchedPick : batch.picks) {
+        auto& pick = batchedPick.pick;
+        PickResultPointer res = pick->getDefaultResult(batchedPick.mathPick.toVariantMap());
+        for (int target = ENTITY_TARGET; target < NUM_TARGETS; target++) {
+            int index = batchedPick.intersections[target];
+            if (index < 0) {
+                continue;
+            }
+            auto& intersection = batch.intersections[target][index];
+            if (!intersection.result) {
+                continue;
+            }
+
+            // HUD results always count, misses are cached as the default result of the pick that computed them
+            if (target == HUD_TARGET || intersection.result->doesIntersect()) {
+                res = res->compareAndProcessNewResult(intersection.result);
+            } else if (intersection.pick != pick) {
+                res = res->compareAndProcessNewResult(intersection.pick->getDefaultResult(intersection.mathPick.toVariantMap()));
+            }
+        }
+
+        if (pick->getMaxDistance() == 0.0f || (pick->getMaxDistance() > 0.0f && res->checkOrFilterAgainstMaxDistance(pick->getMaxDistance()))) {
+            pick->setPickResult(res);
+        } else {
+            pick->setPickResult(pick->getDefaultResult(batchedPick.mathPick.toVariantMap()));
+        }
+    }
+}
+
 #endif // hifi_PickCacheOptimizer_h
@@ -7,9 +7,28 @@
 //
 #include "PickManager.h"
 
+#include <algorithm>
+
+#include <QRunnable>
+#include <QThread>
+
+static const int MAX_PICK_THREADS = 4;
+
+class PickJobRunnable : public QRunnable {
+public:
+    PickJobRunnable(const std::function<void()>& work) : _work(work) {}
+    void run() override { _work(); }
+
+private:
+    std::function<void()> _work;
+};
+
 PickManager::PickManager() {
     setShouldPickHUDOperator([]() { return false; });
     setCalculatePos2DFromHUDOperator([](const glm::vec3& intersection) { return glm::vec2(NAN); });
+
+    // the main thread works on the picks too, leave it a core
+    _pickThreadPool.setMaxThreadCount(std::max(1, std::min(MAX_PICK_THREADS, QThread::idealThreadCount() - 1)));
 }
 
 unsigned int PickManager::addPick(PickQuery::PickType type, const std::shared_ptr<PickQuery> pick) {
@@ -109,14 +128,57 @@ Transform PickManager::getResultTransform(unsigned int uid) const {
     return Transform();
 }
 
+void PickManager::startPickJobs(std::vector<std::function<void()>>& jobs) {
+    // a few workers take the jobs in turn, rather than one runnable per job
+    struct SharedJobs {
+        std::vector<std::function<void()>> jobs;
+        std::atomic<size_t> nextJob { 0 };
+    };
+    auto sharedJobs = std::make_shared<SharedJobs>();
+    sharedJobs->jobs.swap(jobs);
+    auto runJobs = [sharedJobs] {
+        size_t job;
+        while ((job = sharedJobs->nextJob++) < sharedJobs->jobs.size()) {
+            sharedJobs->jobs[job]();
+        }
+    };
+
+    int numWorkers = std::min((int)sharedJobs->jobs.size(), _pickThreadPool.maxThreadCount());
+    for (int i = 0; i < numWorkers; i++) {
+        _pickThreadPool.start(new PickJobRunnable(runJobs));
+    }
+}
+
+void PickManager::waitForPickJobs() {
+    _pickThreadPool.waitForDone();
+}
+
 void PickManager::update() {
-    uint64_t expiry = usecTimestampNow() + _perFrameTimeBudget;
     std::unordered_map<PickQuery::PickType, std::unordered_map<unsigned int, std::shared_ptr<PickQuery>>> cachedPicks;
     withReadLock([&] {
         cachedPicks = _picks;
     });
 
     bool shouldPickHUD = _shouldPickHUDOperator();
+
+    if (_batchedPicking) {
+        auto startJobs = [this](std::vector<std::function<void()>>& jobs) {
+            startPickJobs(jobs);
+        };
+        _updatedPickCounts[PickQuery::Stylus] = _stylusPickCacheOptimizer.updateBatched(cachedPicks[PickQuery::Stylus], false, startJobs);
+        _updatedPickCounts[PickQuery::Ray] = _rayPickCacheOptimizer.updateBatched(cachedPicks[PickQuery::Ray], shouldPickHUD, startJobs);
+        _updatedPickCounts[PickQuery::Parabola] = _parabolaPickCacheOptimizer.updateBatched(cachedPicks[PickQuery::Parabola], shouldPickHUD, startJobs);
+        _updatedPickCounts[PickQuery::Collision] = _collisionPickCacheOptimizer.updateBatched(cachedPicks[PickQuery::Collision], false, startJobs);
+        return;
+    }
+
+    // results of a batched pass still running would be older than the ones set below
+    _stylusPickCacheOptimizer.discardBatch();
+    _rayPickCacheOptimizer.discardBatch();
+    _parabolaPickCacheOptimizer.discardBatch();
+    _collisionPickCacheOptimizer.discardBatch();
+
+    uint64_t expiry = usecTimestampNow() + _perFrameTimeBudget;
     // FIXME: give each type its own expiry
     // Each type will update at least one pick, regardless of the expiry
     _updatedPickCounts[PickQuery::Stylus] = _stylusPickCacheOptimizer.update(cachedPicks[PickQuery::Stylus], _nextPickToUpdate[PickQuery::Stylus], expiry, false);
@@ -16,7 +16,10 @@
 
 #include <NumericalConstants.h>
 
+#include <atomic>
+
 #include <QObject>
+#include <QThreadPool>
 
 class PickManager : public QObject, public Dependency, protected ReadWriteLockable {
     Q_OBJECT
@@ -61,6 +64,14 @@ public:
 
     bool getForceCoarsePicking() { return _forceCoarsePicking; }
 
+    // When batched, every pick is updated each frame and entity intersections are computed on worker threads, their
+    // results are set by the next update.  Otherwise picks are updated one at a time until the per frame time budget runs out
+    bool getBatchedPicking() const { return _batchedPicking; }
+    void setBatchedPicking(bool batchedPicking) { _batchedPicking = batchedPicking; }
+
+    // Blocks until the worker jobs of the batched picks are done
+    void waitForPickJobs();
+
     const std::vector<QVector4D>& getUpdatedPickCounts() { return _updatedPickCounts; }
     const std::vector<int>& getTotalPickCounts() { return _totalPickCounts; }
 
@@ -88,6 +99,11 @@ protected:
 
     static const unsigned int DEFAULT_PER_FRAME_TIME_BUDGET = 3 * USECS_PER_MSEC;
     unsigned int _perFrameTimeBudget { DEFAULT_PER_FRAME_TIME_BUDGET };
+
+    void startPickJobs(std::vector<std::function<void()>>& jobs);
+
+    std::atomic<bool> _batchedPicking { true };
+    QThreadPool _pickThreadPool;
 };
 
 #endif // hifi_PickManager_h
@@ -8,11 +8,15 @@
 
 #include "Clip.h"
 
+#include "ClipWriter.h"
 #include "Frame.h"
 #include "Logging.h"
 
-#include "impl/FileClip.h"
 #include "impl/BufferClip.h"
+#include "impl/ChunkedClip.h"
+#include "impl/FileClip.h"
+
+#include <algorithm>
 
 #include <QtCore/QJsonDocument>
 #include <QtCore/QJsonObject>
@@ -22,15 +26,33 @@
 using namespace recording;
 
 Clip::Pointer Clip::fromFile(const QString& filePath) {
-    auto result = std::make_shared<FileClip>(filePath);
+    Clip::Pointer result;
+    if (ChunkedClip::isChunkedFile(filePath)) {
+        result = std::make_shared<ChunkedClip>(filePath);
+    } else {
+        result = std::make_shared<FileClip>(filePath);
+    }
     if (result->frameCount() == 0) {
         return Clip::Pointer();
     }
     return result;
 }
 
-void Clip::toFile(const QString& filePath, const Clip::ConstPointer& clip) {
-    FileClip::write(filePath, clip->duplicate());
+ClipWriterPointer Clip::toFile(const QString& filePath, const Clip::ConstPointer& clip,
+                               std::function<void(bool success)> callback) {
+    if (0 == clip->frameCount()) {
+        return ClipWriterPointer();
+    }
+
+    // Only frame pointers are gathered here, compressing and writing happens on the writer's thread
+    auto source = clip->duplicate();
+    auto writer = ClipWriter::create(filePath);
+    source->seek(0);
+    for (auto frame = source->nextFrame(); frame; frame = source->nextFrame()) {
+        writer->addFrame(frame);
+    }
+    writer->finish(callback);
+    return writer;
 }
 
 QByteArray Clip::toBuffer(const Clip::ConstPointer& clip) {
@@ -54,6 +76,38 @@ float Clip::position() const {
     return Frame::frameTimeToSeconds(positionFrameTime());
 }
 
+Frame::Time Clip::keyframeTimeBefore(FrameType type, Frame::Time offset) {
+    Locker lock(_mutex);
+    if (_keyframeIndexFrameCount != frameCount()) {
+        indexKeyframes();
+    }
+
+    auto iterator = _keyframeTimes.find(type);
+    if (iterator == _keyframeTimes.end()) {
+        return Frame::INVALID_TIME;
+    }
+    const auto& times = *iterator;
+    auto itr = std::upper_bound(times.begin(), times.end(), offset);
+    if (itr == times.begin()) {
+        return Frame::INVALID_TIME;
+    }
+    return *(--itr);
+}
+
+void Clip::indexKeyframes() {
+    _keyframeTimes.clear();
+    auto keyframedTypes = Frame::getKeyframedTypes();
+    auto position = positionFrameTime();
+    seekFrameTime(0);
+    for (auto frame = nextFrame(); frame; frame = nextFrame()) {
+        if (keyframedTypes.contains(frame->type) && Frame::isKeyframe(frame)) {
+            _keyframeTimes[frame->type].push_back(frame->timeOffset);
+        }
+    }
+    seekFrameTime(position);
+    _keyframeIndexFrameCount = frameCount();
+}
+
 // FIXME move to frame?
 bool writeFrame(QIODevice& output, const Frame& frame, bool compressed = true) {
     if (frame.type == Frame::TYPE_INVALID) {
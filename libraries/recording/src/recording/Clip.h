@@ -12,9 +12,12 @@
 
 #include "Forward.h"
 
+#include <functional>
 #include <mutex>
+#include <vector>
 
 #include <QtCore/QObject>
+#include <QtCore/QMap>
 
 #include "Frame.h"
 
@@ -47,10 +50,17 @@ public:
     virtual void skipFrame() = 0;
     virtual void addFrame(FrameConstPointer) = 0;
 
+    // Time of the last keyframe of the given type at or before offset, or INVALID_TIME if there is none.
+    // The keyframe times are indexed on first use, which reads the whole clip once.
+    Frame::Time keyframeTimeBefore(FrameType type, Frame::Time offset);
+
     bool write(QIODevice& output);
 
     static Pointer fromFile(const QString& filePath);
-    static void toFile(const QString& filePath, const ConstPointer& clip);
+    // Writes an indexed clip in the background, use the returned writer or the callback to learn the outcome.
+    // Returns a null writer if the clip is empty.  The callback is invoked from the writing thread.
+    static ClipWriterPointer toFile(const QString& filePath, const ConstPointer& clip,
+                                   std::function<void(bool success)> callback = std::function<void(bool success)>());
     static QByteArray toBuffer(const ConstPointer& clip);
     static Pointer newClip();
     
@@ -65,6 +75,12 @@ protected:
     virtual void reset() = 0;
 
     mutable Mutex _mutex;
+
+private:
+    void indexKeyframes();
+
+    QMap<FrameType, std::vector<Frame::Time>> _keyframeTimes;
+    size_t _keyframeIndexFrameCount { 0 };
 };
 
 }
@@ -12,6 +12,7 @@
 
 #include <shared/QtHelpers.h>
 
+#include "impl/ChunkedClip.h"
 #include "impl/PointerClip.h"
 #include "Logging.h"
 
@@ -25,8 +26,34 @@ void NetworkClip::init(const QByteArray& clipData) {
     PointerClip::init((uchar*)_clipData.data(), _clipData.size());
 }
 
+void NetworkClipLoader::makeRequest() {
+    // Indexed clips on the local disk are streamed from the file instead of being read into memory first,
+    // so playback of long recordings can start right away
+    if (_activeUrl.isLocalFile() && ChunkedClip::isChunkedFile(_activeUrl.toLocalFile())) {
+        auto clip = std::make_shared<ChunkedClip>(_activeUrl.toLocalFile());
+        ClipCache::requestCompleted(_self);
+        if (clip->frameCount() == 0) {
+            emit failed(QNetworkReply::UnknownContentError);
+            finishedLoading(false);
+            return;
+        }
+        _clip = clip;
+        finishedLoading(true);
+        emit clipLoaded();
+        return;
+    }
+
+    Resource::makeRequest();
+}
+
 void NetworkClipLoader::downloadFinished(const QByteArray& data) {
-    _clip->init(data);
+    if (ChunkedClip::isChunkedData(data)) {
+        _clip = std::make_shared<ChunkedClip>(data, _url.toString());
+    } else {
+        auto clip = std::make_shared<NetworkClip>(_url);
+        clip->init(data);
+        _clip = clip;
+    }
     finishedLoading(true);
     emit clipLoaded();
 }
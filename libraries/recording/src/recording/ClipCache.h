@@ -40,8 +40,11 @@ public:
 signals:
     void clipLoaded();
 
+protected:
+    virtual void makeRequest() override;
+
 private:
-    const NetworkClip::Pointer _clip;
+    ClipPointer _clip;
 };
 
 using NetworkClipLoaderPointer = QSharedPointer<NetworkClipLoader>;
@@ -57,6 +60,8 @@ protected:
     virtual QSharedPointer<Resource> createResource(const QUrl& url, const QSharedPointer<Resource>& fallback, const void* extra) override;
 
 private:
+    friend class NetworkClipLoader;
+
     ClipCache(QObject* parent = nullptr);
 };
 
@@ -0,0 +1,213 @@
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ClipWriter.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QThreadPool>
+#include <QtConcurrent/QtConcurrentRun>
+
+#include "Clip.h"
+#include "Frame.h"
+#include "Logging.h"
+
+using namespace recording;
+using namespace recording::chunked;
+
+static QByteArray headerData() {
+    auto frameTypes = Frame::getFrameTypes();
+    QJsonObject frameTypeObj;
+    for (const auto& frameTypeName : frameTypes.keys()) {
+        frameTypeObj[frameTypeName] = frameTypes[frameTypeName];
+    }
+
+    QJsonObject rootObject;
+    rootObject.insert(Clip::FRAME_TYPE_MAP, frameTypeObj);
+    rootObject.insert(Clip::FRAME_COMREPSSION_FLAG, true);
+    return QJsonDocument(rootObject).toBinaryData();
+}
+
+template <typename T>
+static bool writeStruct(QIODevice& device, const T& value) {
+    return device.write(reinterpret_cast<const char*>(&value), sizeof(T)) == (qint64)sizeof(T);
+}
+
+static bool writeBlock(QIODevice& device, const QByteArray& data) {
+    uint32_t size = data.size();
+    return writeStruct(device, size) && device.write(data) == data.size();
+}
+
+ClipWriter::Pointer ClipWriter::create(const QString& filePath) {
+    return Pointer(new ClipWriter(filePath));
+}
+
+ClipWriter::ClipWriter(const QString& filePath) : _filePath(filePath) {
+}
+
+ClipWriter::~ClipWriter() {
+    if (!_finished) {
+        qCWarning(recordingLog) << "Clip writer for" << _filePath << "destroyed before finishing, the index was not written";
+    }
+    if (_file && _file->isOpen()) {
+        _file->close();
+    }
+}
+
+void ClipWriter::addFrame(const FrameConstPointer& frame) {
+    if (frame->type == Frame::TYPE_INVALID) {
+        qCWarning(recordingLog) << "Attempting to write invalid frame";
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    if (_finishing) {
+        return;
+    }
+    _pendingFrames.push_back(frame);
+    _pendingBytes += sizeof(ChunkFrameHeader) + frame->data.size();
+    Frame::Time chunkDuration = frame->timeOffset - _pendingFrames.front()->timeOffset;
+    if (_pendingBytes >= CHUNK_TARGET_BYTES || chunkDuration >= CHUNK_TARGET_DURATION) {
+        queueChunk(false);
+    }
+}
+
+void ClipWriter::finish(Callback callback) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    if (_finishing) {
+        return;
+    }
+    _finishing = true;
+    _callback = callback;
+    queueChunk(true);
+}
+
+bool ClipWriter::waitForFinished() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _finishedCondition.wait(lock, [this] { return _finished; });
+    return _success;
+}
+
+// Must be called with _mutex held
+void ClipWriter::queueChunk(bool last) {
+    Chunk chunk;
+    chunk.frames.swap(_pendingFrames);
+    chunk.last = last;
+    _chunks.push_back(std::move(chunk));
+    _pendingBytes = 0;
+
+    // A single task drains the queue at a time, which keeps the chunks in order in the file
+    if (!_workerScheduled) {
+        _workerScheduled = true;
+        auto self = shared_from_this();
+        QtConcurrent::run(QThreadPool::globalInstance(), [self] {
+            self->processChunks();
+        });
+    }
+}
+
+void ClipWriter::processChunks() {
+    while (true) {
+        Chunk chunk;
+        bool success;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            if (_chunks.empty()) {
+                _workerScheduled = false;
+                return;
+            }
+            chunk = std::move(_chunks.front());
+            _chunks.pop_front();
+            success = _success;
+        }
+
+        if (success && !_file) {
+            success = writeHeader();
+        }
+        if (success && !chunk.frames.empty()) {
+            success = writeChunk(chunk.frames);
+        }
+        if (success && chunk.last) {
+            success = writeIndex();
+        }
+
+        Callback callback;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            if (!success && _success) {
+                qCWarning(recordingLog) << "Failed writing clip to" << _filePath;
+            }
+            _success = success;
+            if (chunk.last) {
+                if (_file) {
+                    _file->close();
+                }
+                _finished = true;
+                callback = _callback;
+            }
+        }
+
+        if (chunk.last) {
+            _finishedCondition.notify_all();
+            if (callback) {
+                callback(success);
+            }
+        }
+    }
+}
+
+bool ClipWriter::writeHeader() {
+    _file = std::make_unique<QFile>(_filePath);
+    if (!_file->open(QFile::Truncate | QFile::WriteOnly)) {
+        qCWarning(recordingLog) << "Unable to open" << _filePath << "for writing";
+        return false;
+    }
+
+    FileHeader fileHeader { FILE_MAGIC, VERSION, 0 };
+    return writeStruct(*_file, fileHeader) && writeBlock(*_file, headerData());
+}
+
+bool ClipWriter::writeChunk(const std::vector<FrameConstPointer>& frames) {
+    // Frames of unregistered types could never be read back
+    auto frameTypeNames = Frame::getFrameTypeNames();
+
+    QByteArray chunkData;
+    ChunkHeader chunkHeader { CHUNK_MAGIC, 0, frames.front()->timeOffset, frames.back()->timeOffset, 0 };
+    for (const auto& frame : frames) {
+        if (frame->type == Frame::TYPE_HEADER || !frameTypeNames.contains(frame->type)) {
+            continue;
+        }
+        ChunkFrameHeader frameHeader { frame->type, frame->timeOffset, (uint32_t)frame->data.size() };
+        chunkData.append(reinterpret_cast<const char*>(&frameHeader), sizeof(ChunkFrameHeader));
+        chunkData.append(frame->data);
+        ++chunkHeader.frameCount;
+    }
+    if (chunkHeader.frameCount == 0) {
+        return true;
+    }
+
+    QByteArray compressed = qCompress(chunkData);
+    chunkHeader.dataSize = compressed.size();
+
+    ChunkIndexEntry entry { (quint64)_file->pos(), chunkHeader.firstTime, chunkHeader.lastTime, chunkHeader.frameCount };
+    if (!writeStruct(*_file, chunkHeader) || _file->write(compressed) != compressed.size()) {
+        return false;
+    }
+    _index.push_back(entry);
+    return true;
+}
+
+bool ClipWriter::writeIndex() {
+    Footer footer { (quint64)_file->pos(), FOOTER_MAGIC };
+    IndexHeader indexHeader { INDEX_MAGIC, (uint32_t)_index.size() };
+    qint64 indexSize = _index.size() * sizeof(ChunkIndexEntry);
+    return writeStruct(*_file, indexHeader) &&
+        _file->write(reinterpret_cast<const char*>(_index.data()), indexSize) == indexSize &&
+        writeBlock(*_file, headerData()) &&
+        writeStruct(*_file, footer);
+}
@@ -0,0 +1,84 @@
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+#ifndef hifi_Recording_ClipWriter_h
+#define hifi_Recording_ClipWriter_h
+
+#include "Forward.h"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include <QtCore/QString>
+
+#include "impl/ChunkedClipFormat.h"
+
+class QFile;
+
+namespace recording {
+
+// Incrementally writes frames to an indexed clip file.  Frames are grouped into chunks as they are added and each
+// completed chunk is compressed and written on a thread pool thread, so neither recording nor saving a clip ever
+// waits on the disk.
+class ClipWriter : public std::enable_shared_from_this<ClipWriter> {
+public:
+    using Pointer = std::shared_ptr<ClipWriter>;
+    using Callback = std::function<void(bool success)>;
+
+    static Pointer create(const QString& filePath);
+    ~ClipWriter();
+
+    const QString& getFilePath() const { return _filePath; }
+
+    // Frames must be added in time order
+    void addFrame(const FrameConstPointer& frame);
+
+    // Write the remaining frames and the index.  The callback is invoked from the writing thread.
+    void finish(Callback callback = Callback());
+
+    // Blocks until finish() has completed, returns true if the whole clip was written
+    bool waitForFinished();
+
+private:
+    ClipWriter(const QString& filePath);
+
+    struct Chunk {
+        std::vector<FrameConstPointer> frames;
+        bool last { false };
+    };
+
+    void queueChunk(bool last);
+    void processChunks();
+    bool writeHeader();
+    bool writeChunk(const std::vector<FrameConstPointer>& frames);
+    bool writeIndex();
+
+    const QString _filePath;
+
+    std::mutex _mutex;
+    std::condition_variable _finishedCondition;
+    std::vector<FrameConstPointer> _pendingFrames;
+    size_t _pendingBytes { 0 };
+    std::deque<Chunk> _chunks;
+    Callback _callback;
+    bool _finishing { false };
+    bool _finished { false };
+    bool _workerScheduled { false };
+    bool _success { true };
+
+    // only accessed from the writing thread
+    std::unique_ptr<QFile> _file;
+    std::vector<chunked::ChunkIndexEntry> _index;
+};
+
+}
+
+#endif
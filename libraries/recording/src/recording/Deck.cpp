@@ -7,6 +7,8 @@
 //
 
 #include "Deck.h"
+
+#include <algorithm>
  
 #include <QtCore/QThread>
 
@@ -85,7 +87,7 @@ void Deck::seek(float position) {
 
     // reset the clips to the appropriate spot
     for (auto& clip : _clips) {
-        clip->seekFrameTime(_position);
+        prerollClip(clip, _position);
     }
 
     if (!_pause) {
@@ -94,6 +96,35 @@ void Deck::seek(float position) {
     }
 }
 
+// Delta encoded frames only make sense on top of the frames before them, so seek the clip to the preceding
+// keyframe of each keyframed type and replay those types up to the requested position.
+void Deck::prerollClip(const ClipPointer& clip, Frame::Time position) {
+    auto keyframedTypes = Frame::getKeyframedTypes();
+    if (keyframedTypes.empty() || position == 0 || qApp->thread() != QThread::currentThread()) {
+        clip->seekFrameTime(position);
+        return;
+    }
+
+    QMap<FrameType, Frame::Time> keyframeTimes;
+    Frame::Time prerollPosition = position;
+    for (auto type : keyframedTypes) {
+        auto keyframeTime = clip->keyframeTimeBefore(type, position);
+        if (keyframeTime != Frame::INVALID_TIME) {
+            keyframeTimes[type] = keyframeTime;
+            prerollPosition = std::min(prerollPosition, keyframeTime);
+        }
+    }
+
+    clip->seekFrameTime(prerollPosition);
+    while (clip->positionFrameTime() < position) {
+        auto frame = clip->nextFrame();
+        auto iterator = keyframeTimes.find(frame->type);
+        if (iterator != keyframeTimes.end() && frame->timeOffset >= *iterator) {
+            Frame::handleFrame(frame);
+        }
+    }
+}
+
 float Deck::position() const {
     Locker lock(_mutex);
     auto currentPosition = _position;
@@ -66,6 +66,7 @@ private:
     using Locker = std::unique_lock<Mutex>;
 
     ClipPointer getNextClip();
+    void prerollClip(const ClipPointer& clip, Frame::Time position);
     void processFrames();
 
     mutable Mutex _mutex;
@@ -40,6 +40,11 @@ class Deck;
 // An interface for recording a single clip
 class Recorder;
 
+// Writes a clip to disk incrementally
+class ClipWriter;
+
+using ClipWriterPointer = std::shared_ptr<ClipWriter>;
+
 }
 
 #endif
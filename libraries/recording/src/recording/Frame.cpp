@@ -71,6 +71,7 @@ private:
 
 static Registry<FrameType, QString> frameTypes;
 static QMap<FrameType, Frame::Handler> handlerMap;
+static QMap<FrameType, Frame::KeyframeTest> keyframeTestMap;
 using Mutex = std::mutex;
 using Locker = std::unique_lock<Mutex>;
 static Mutex mutex;
@@ -162,3 +163,31 @@ void Frame::handleFrame(const Frame::ConstPointer& frame) {
     }
     handler(frame);
 }
+
+void Frame::registerKeyframeTest(FrameType type, KeyframeTest keyframeTest) {
+    Locker lock(mutex);
+    keyframeTestMap[type] = keyframeTest;
+}
+
+void Frame::clearKeyframeTest(FrameType type) {
+    Locker lock(mutex);
+    keyframeTestMap.remove(type);
+}
+
+QList<FrameType> Frame::getKeyframedTypes() {
+    Locker lock(mutex);
+    return keyframeTestMap.keys();
+}
+
+bool Frame::isKeyframe(const Frame::ConstPointer& frame) {
+    KeyframeTest keyframeTest;
+    {
+        Locker lock(mutex);
+        auto iterator = keyframeTestMap.find(frame->type);
+        if (iterator == keyframeTestMap.end()) {
+            return true;
+        }
+        keyframeTest = *iterator;
+    }
+    return keyframeTest(frame->data);
+}
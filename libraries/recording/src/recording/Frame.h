@@ -21,6 +21,7 @@
 #endif
 
 #include <QtCore/QObject>
+#include <QtCore/QList>
 
 namespace recording {
 
@@ -58,6 +59,8 @@ public:
     using Pointer = std::shared_ptr<Frame>;
     using ConstPointer = std::shared_ptr<const Frame>;
     using Handler = std::function<void(Frame::ConstPointer frame)>;
+    // Returns true if the frame data can be applied without any of the preceding frames of its type
+    using KeyframeTest = std::function<bool(const QByteArray& data)>;
 
     QByteArray data;
 
@@ -73,6 +76,13 @@ public:
     static QMap<QString, FrameType> getFrameTypes();
     static QMap<FrameType, QString> getFrameTypeNames();
     static void handleFrame(const ConstPointer& frame);
+
+    // Frame types with a keyframe test are delta encoded; on a seek the deck replays them from the
+    // preceding keyframe.  Types without a test are treated as if every frame were a keyframe.
+    static void registerKeyframeTest(FrameType type, KeyframeTest keyframeTest);
+    static void clearKeyframeTest(FrameType type);
+    static QList<FrameType> getKeyframedTypes();
+    static bool isKeyframe(const ConstPointer& frame);
 };
 
 }
@@ -0,0 +1,359 @@
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ChunkedClip.h"
+
+#include <algorithm>
+
+#include <QtCore/QBuffer>
+#include <QtCore/QDebug>
+#include <QtCore/QFile>
+#include <QtCore/QJsonObject>
+#include <QtCore/QThreadPool>
+#include <QtConcurrent/QtConcurrentRun>
+
+#include "../Frame.h"
+#include "../Logging.h"
+
+using namespace recording;
+using namespace recording::chunked;
+
+// defined in PointerClip.cpp
+QMap<FrameType, FrameType> parseTranslationMap(const QJsonDocument& doc);
+
+template <typename T>
+static bool readStruct(QIODevice& device, T& value) {
+    return device.read(reinterpret_cast<char*>(&value), sizeof(T)) == (qint64)sizeof(T);
+}
+
+bool ChunkedClip::isChunkedFile(const QString& filePath) {
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    FileHeader fileHeader;
+    return readStruct(file, fileHeader) && fileHeader.magic == FILE_MAGIC;
+}
+
+bool ChunkedClip::isChunkedData(const QByteArray& data) {
+    if (data.size() < (int)sizeof(FileHeader)) {
+        return false;
+    }
+    FileHeader fileHeader;
+    memcpy(&fileHeader, data.constData(), sizeof(FileHeader));
+    return fileHeader.magic == FILE_MAGIC;
+}
+
+ChunkedClip::ChunkedClip(const QString& filePath) : _device(std::make_unique<QFile>(filePath)), _name(filePath) {
+    if (!_device->open(QIODevice::ReadOnly)) {
+        qCWarning(recordingLog) << "Unable to open file " << filePath;
+        return;
+    }
+    if (!open()) {
+        reset();
+    }
+}
+
+ChunkedClip::ChunkedClip(const QByteArray& data, const QString& name) : _name(name) {
+    auto buffer = std::make_unique<QBuffer>();
+    buffer->setData(data);
+    buffer->open(QIODevice::ReadOnly);
+    _device = std::move(buffer);
+    if (!open()) {
+        reset();
+    }
+}
+
+ChunkedClip::~ChunkedClip() {
+    Locker lock(_mutex);
+    _prefetch.waitForFinished();
+    if (_device && _device->isOpen()) {
+        _device->close();
+    }
+}
+
+bool ChunkedClip::open() {
+    FileHeader fileHeader;
+    if (!readStruct(*_device, fileHeader) || fileHeader.magic != FILE_MAGIC) {
+        qCWarning(recordingLog) << "Not an indexed clip" << _name;
+        return false;
+    }
+    if (fileHeader.version > VERSION) {
+        qCWarning(recordingLog) << "Unsupported indexed clip version" << fileHeader.version << "in" << _name;
+        return false;
+    }
+
+    uint32_t headerSize;
+    if (!readStruct(*_device, headerSize)) {
+        return false;
+    }
+    QByteArray headerData = _device->read(headerSize);
+    if (headerData.size() != (int)headerSize) {
+        qCWarning(recordingLog) << "Truncated header, invalid file" << _name;
+        return false;
+    }
+    _header = QJsonDocument::fromBinaryData(headerData);
+    _firstChunkOffset = _device->pos();
+
+    if (!readIndex()) {
+        qCWarning(recordingLog) << "Missing index in" << _name << ", rebuilding it from the chunk headers";
+        rebuildIndex();
+    }
+
+    _translationMap = parseTranslationMap(_header);
+    if (_translationMap.empty()) {
+        qCWarning(recordingLog) << "Header missing frame type map, invalid file" << _name;
+        return false;
+    }
+
+    _frameCount = 0;
+    for (const auto& entry : _index) {
+        _frameCount += entry.frameCount;
+    }
+    qCDebug(recordingLog) << "Opened indexed clip" << _name << "with" << _index.size() << "chunks," << _frameCount << "frames";
+    return _frameCount > 0;
+}
+
+bool ChunkedClip::readIndex() {
+    quint64 size = _device->size();
+    if (size < _firstChunkOffset + sizeof(Footer)) {
+        return false;
+    }
+
+    Footer footer;
+    quint64 footerOffset = size - sizeof(Footer);
+    if (!_device->seek(footerOffset) || !readStruct(*_device, footer) || footer.magic != FOOTER_MAGIC) {
+        return false;
+    }
+    if (footer.indexOffset < _firstChunkOffset || footer.indexOffset + sizeof(IndexHeader) > footerOffset) {
+        return false;
+    }
+
+    IndexHeader indexHeader;
+    if (!_device->seek(footer.indexOffset) || !readStruct(*_device, indexHeader) || indexHeader.magic != INDEX_MAGIC) {
+        return false;
+    }
+    quint64 indexSize = (quint64)indexHeader.chunkCount * sizeof(ChunkIndexEntry);
+    if (footer.indexOffset + sizeof(IndexHeader) + indexSize > footerOffset) {
+        return false;
+    }
+    _index.resize(indexHeader.chunkCount);
+    if (_device->read(reinterpret_cast<char*>(_index.data()), indexSize) != (qint64)indexSize) {
+        _index.clear();
+        return false;
+    }
+
+    // The final frame type map supersedes the one written when the file was opened, since frame types
+    // may have been registered while recording
+    uint32_t metadataSize;
+    if (readStruct(*_device, metadataSize) && _device->pos() + metadataSize <= footerOffset) {
+        auto metadata = QJsonDocument::fromBinaryData(_device->read(metadataSize));
+        if (metadata.isObject() && metadata.object().contains(Clip::FRAME_TYPE_MAP)) {
+            _header = metadata;
+        }
+    }
+    return true;
+}
+
+void ChunkedClip::rebuildIndex() {
+    _index.clear();
+    quint64 size = _device->size();
+    quint64 offset = _firstChunkOffset;
+    while (offset + sizeof(ChunkHeader) <= size && _device->seek(offset)) {
+        ChunkHeader chunkHeader;
+        if (!readStruct(*_device, chunkHeader) || chunkHeader.magic != CHUNK_MAGIC) {
+            break;
+        }
+        quint64 nextOffset = offset + sizeof(ChunkHeader) + chunkHeader.dataSize;
+        if (nextOffset > size) {
+            break;
+        }
+        _index.push_back({ offset, chunkHeader.firstTime, chunkHeader.lastTime, chunkHeader.frameCount });
+        offset = nextOffset;
+    }
+}
+
+// Internal only function, needs no locking
+bool ChunkedClip::loadChunk(size_t chunkIndex) const {
+    if (_loadedChunk == chunkIndex) {
+        return !_chunkFrames.empty();
+    }
+
+    _loadedChunk = chunkIndex;
+    if (_prefetchedChunk == chunkIndex) {
+        // only waits if playback caught up with the prefetch
+        _chunkFrames = _prefetch.result();
+        _prefetchedChunk = SIZE_MAX;
+    } else {
+        _chunkFrames = readChunk(chunkIndex);
+    }
+    prefetchChunk(chunkIndex + 1);
+    return !_chunkFrames.empty();
+}
+
+// Internal only function, needs no locking
+void ChunkedClip::prefetchChunk(size_t chunkIndex) const {
+    if (chunkIndex >= _index.size() || chunkIndex == _prefetchedChunk || _prefetch.isRunning()) {
+        return;
+    }
+    _prefetchedChunk = chunkIndex;
+    _prefetch = QtConcurrent::run(QThreadPool::globalInstance(), [this, chunkIndex] {
+        return readChunk(chunkIndex);
+    });
+}
+
+// The index and the translation map do not change once the clip is open, only the device needs a lock
+std::vector<FrameConstPointer> ChunkedClip::readChunk(size_t chunkIndex) const {
+    std::vector<FrameConstPointer> frames;
+    const auto& entry = _index[chunkIndex];
+    ChunkHeader chunkHeader;
+    QByteArray compressed;
+    {
+        std::unique_lock<std::mutex> lock(_deviceMutex);
+        if (!_device->seek(entry.fileOffset) || !readStruct(*_device, chunkHeader) || chunkHeader.magic != CHUNK_MAGIC) {
+            qCWarning(recordingLog) << "Damaged chunk" << chunkIndex << "in" << _name;
+            return frames;
+        }
+        compressed = _device->read(chunkHeader.dataSize);
+    }
+
+    QByteArray data = qUncompress(compressed);
+    const char* current = data.constData();
+    const char* end = current + data.size();
+    frames.reserve(chunkHeader.frameCount);
+    while (end - current >= (ptrdiff_t)sizeof(ChunkFrameHeader)) {
+        ChunkFrameHeader frameHeader;
+        memcpy(&frameHeader, current, sizeof(ChunkFrameHeader));
+        current += sizeof(ChunkFrameHeader);
+        if ((quint64)(end - current) < frameHeader.size) {
+            qCWarning(recordingLog) << "Truncated frame in chunk" << chunkIndex << "of" << _name;
+            break;
+        }
+        auto translated = _translationMap.find(frameHeader.type);
+        if (translated != _translationMap.end()) {
+            auto frame = std::make_shared<Frame>();
+            frame->type = translated.value();
+            frame->timeOffset = frameHeader.timeOffset;
+            frame->data = QByteArray(current, frameHeader.size);
+            frames.push_back(frame);
+        }
+        current += frameHeader.size;
+    }
+    return frames;
+}
+
+// Internal only function, needs no locking
+void ChunkedClip::settle() const {
+    while (_chunkIndex < _index.size()) {
+        loadChunk(_chunkIndex);
+        if (_frameIndex < _chunkFrames.size()) {
+            return;
+        }
+        ++_chunkIndex;
+        _frameIndex = 0;
+    }
+}
+
+Clip::Pointer ChunkedClip::duplicate() const {
+    auto result = newClip();
+    Locker lock(_mutex);
+    for (size_t i = 0; i < _index.size(); ++i) {
+        loadChunk(i);
+        for (const auto& frame : _chunkFrames) {
+            result->addFrame(frame);
+        }
+    }
+    return result;
+}
+
+float ChunkedClip::duration() const {
+    Locker lock(_mutex);
+    if (_index.empty()) {
+        return 0;
+    }
+    return Frame::frameTimeToSeconds(_index.back().lastTime);
+}
+
+size_t ChunkedClip::frameCount() const {
+    Locker lock(_mutex);
+    return _frameCount;
+}
+
+void ChunkedClip::seekFrameTime(Frame::Time offset) {
+    Locker lock(_mutex);
+    // first chunk that ends at or after the offset
+    auto itr = std::lower_bound(_index.begin(), _index.end(), offset,
+        [](const ChunkIndexEntry& a, Frame::Time b)->bool {
+            return a.lastTime < b;
+        }
+    );
+    _chunkIndex = itr - _index.begin();
+    _frameIndex = 0;
+    if (_chunkIndex < _index.size() && loadChunk(_chunkIndex)) {
+        auto frameItr = std::lower_bound(_chunkFrames.begin(), _chunkFrames.end(), offset,
+            [](const FrameConstPointer& a, Frame::Time b)->bool {
+                return a->timeOffset < b;
+            }
+        );
+        _frameIndex = frameItr - _chunkFrames.begin();
+    }
+    settle();
+}
+
+Frame::Time ChunkedClip::positionFrameTime() const {
+    Locker lock(_mutex);
+    settle();
+    Frame::Time result = Frame::INVALID_TIME;
+    if (_chunkIndex < _index.size()) {
+        result = _chunkFrames[_frameIndex]->timeOffset;
+    }
+    return result;
+}
+
+FrameConstPointer ChunkedClip::peekFrame() const {
+    Locker lock(_mutex);
+    settle();
+    FrameConstPointer result;
+    if (_chunkIndex < _index.size()) {
+        result = _chunkFrames[_frameIndex];
+    }
+    return result;
+}
+
+FrameConstPointer ChunkedClip::nextFrame() {
+    Locker lock(_mutex);
+    settle();
+    FrameConstPointer result;
+    if (_chunkIndex < _index.size()) {
+        result = _chunkFrames[_frameIndex++];
+    }
+    return result;
+}
+
+void ChunkedClip::skipFrame() {
+    Locker lock(_mutex);
+    settle();
+    if (_chunkIndex < _index.size()) {
+        ++_frameIndex;
+    }
+}
+
+void ChunkedClip::addFrame(FrameConstPointer) {
+    throw std::runtime_error("Indexed clips are read only, use duplicate to create a read/write clip");
+}
+
+void ChunkedClip::reset() {
+    _prefetch.waitForFinished();
+    _prefetchedChunk = SIZE_MAX;
+    _index.clear();
+    _frameCount = 0;
+    _chunkIndex = 0;
+    _frameIndex = 0;
+    _loadedChunk = SIZE_MAX;
+    _chunkFrames.clear();
+    _header = QJsonDocument();
+}
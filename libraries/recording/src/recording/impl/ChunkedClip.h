@@ -0,0 +1,95 @@
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+#ifndef hifi_Recording_Impl_ChunkedClip_h
+#define hifi_Recording_Impl_ChunkedClip_h
+
+#include "../Clip.h"
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <QtCore/QFuture>
+#include <QtCore/QIODevice>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QMap>
+
+#include "ChunkedClipFormat.h"
+
+namespace recording {
+
+// Read only clip over an indexed (chunked) recording.  Only the index is read up front, frames are decompressed
+// one chunk at a time as playback reaches them, so opening and seeking do not depend on the length of the clip.
+// While a chunk is played the next one is read and decompressed on a thread pool thread.
+class ChunkedClip : public Clip {
+public:
+    using Pointer = std::shared_ptr<ChunkedClip>;
+
+    // Stream from a file on disk
+    ChunkedClip(const QString& filePath);
+    // Read from data already in memory, such as a downloaded clip
+    ChunkedClip(const QByteArray& data, const QString& name);
+    virtual ~ChunkedClip();
+
+    static bool isChunkedFile(const QString& filePath);
+    static bool isChunkedData(const QByteArray& data);
+
+    virtual Clip::Pointer duplicate() const override;
+    virtual QString getName() const override { return _name; }
+
+    virtual float duration() const override;
+    // Frames of types unknown to this application are counted but skipped during playback
+    virtual size_t frameCount() const override;
+
+    virtual void seekFrameTime(Frame::Time offset) override;
+    virtual Frame::Time positionFrameTime() const override;
+
+    virtual FrameConstPointer peekFrame() const override;
+    virtual FrameConstPointer nextFrame() override;
+    virtual void skipFrame() override;
+    virtual void addFrame(FrameConstPointer) override;
+
+    const QJsonDocument& getHeader() const { return _header; }
+
+protected:
+    virtual void reset() override;
+
+private:
+    bool open();
+    bool readIndex();
+    void rebuildIndex();
+    bool loadChunk(size_t chunkIndex) const;
+    // reads and decompresses a chunk, safe to call from any thread
+    std::vector<FrameConstPointer> readChunk(size_t chunkIndex) const;
+    void prefetchChunk(size_t chunkIndex) const;
+    // skip to the first valid frame at or after the current position
+    void settle() const;
+
+    std::unique_ptr<QIODevice> _device;
+    mutable std::mutex _deviceMutex;
+    QString _name;
+    QJsonDocument _header;
+    QMap<FrameType, FrameType> _translationMap;
+    std::vector<chunked::ChunkIndexEntry> _index;
+    size_t _frameCount { 0 };
+    quint64 _firstChunkOffset { 0 };
+
+    mutable size_t _chunkIndex { 0 };
+    mutable size_t _frameIndex { 0 };
+    mutable size_t _loadedChunk { SIZE_MAX };
+    mutable std::vector<FrameConstPointer> _chunkFrames;
+
+    // at most one prefetch is in flight, the destructor waits for it
+    mutable size_t _prefetchedChunk { SIZE_MAX };
+    mutable QFuture<std::vector<FrameConstPointer>> _prefetch;
+};
+
+}
+
+#endif
@@ -0,0 +1,90 @@
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+#ifndef hifi_Recording_Impl_ChunkedClipFormat_h
+#define hifi_Recording_Impl_ChunkedClipFormat_h
+
+#include <stdint.h>
+
+#include "../Frame.h"
+
+// Layout of indexed (chunked) clip files
+//
+//    FileHeader fileHeader;
+//    uint32_t headerSize; char header[headerSize];    // QJsonDocument binary data, same content as the legacy header frame
+//    {
+//        ChunkHeader chunkHeader;
+//        char data[chunkHeader.dataSize];             // qCompress'ed run of ChunkFrameHeader + frame data
+//    } chunks[];
+//    IndexHeader indexHeader;
+//    ChunkIndexEntry entries[indexHeader.chunkCount];
+//    uint32_t metadataSize; char metadata[metadataSize];  // QJsonDocument binary data, final frame type map
+//    Footer footer;
+//
+// Each chunk holds roughly a second of frames, so a reader only ever decompresses a small part of the file and
+// can locate any time offset with a binary search over the index.  The index is written last; if it is missing
+// (for instance a recording that was interrupted) the reader rebuilds it by walking the chunk headers.
+namespace recording {
+
+namespace chunked {
+
+static const uint32_t FILE_MAGIC = 0x43524648;   // 'HFRC'
+static const uint32_t CHUNK_MAGIC = 0x4B434648;  // 'HFCK'
+static const uint32_t INDEX_MAGIC = 0x58494648;  // 'HFIX'
+static const uint32_t FOOTER_MAGIC = 0x45494648; // 'HFIE'
+
+static const uint16_t VERSION = 1;
+
+// A chunk is closed as soon as either limit is reached
+static const uint32_t CHUNK_TARGET_BYTES = 64 * 1024;
+static const Frame::Time CHUNK_TARGET_DURATION = 1000; // milliseconds
+
+#pragma pack(push, 1)
+struct FileHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t reserved;
+};
+
+struct ChunkHeader {
+    uint32_t magic;
+    uint32_t frameCount;
+    Frame::Time firstTime;
+    Frame::Time lastTime;
+    uint32_t dataSize;
+};
+
+struct ChunkFrameHeader {
+    FrameType type;
+    Frame::Time timeOffset;
+    uint32_t size;
+};
+
+struct IndexHeader {
+    uint32_t magic;
+    uint32_t chunkCount;
+};
+
+struct ChunkIndexEntry {
+    quint64 fileOffset; // offset of the ChunkHeader
+    Frame::Time firstTime;
+    Frame::Time lastTime;
+    uint32_t frameCount;
+};
+
+struct Footer {
+    quint64 indexOffset;
+    uint32_t magic;
+};
+#pragma pack(pop)
+
+}
+
+}
+
+#endif
@@ -24,14 +24,12 @@
 #include <PerfStat.h>
 #include <ViewFrustum.h>
 #include <GLMHelpers.h>
-#include <TBBHelpers.h>
 
 #include <model-networking/SimpleMeshProxy.h>
 #include <graphics-scripting/Forward.h>
 #include <graphics/BufferViewHelpers.h>
 #include <DualQuaternion.h>
 
-#include <glm/gtc/packing.hpp>
 
 #include "AbstractViewStateInterface.h"
 #include "MeshPartPayload.h"
@@ -309,6 +307,7 @@ bool Model::updateGeometry() {
             initializeBlendshapes(mesh, i);
             i++;
         }
+        _sparseBlendshapes = DependencyManager::get<ModelBlender>()->getSparseBlendshapes(_renderGeometry);
         _blendshapeOffsetsInitialized = true;
         needFullUpdate = true;
         emit rigReady();
@@ -987,6 +986,7 @@ void Model::removeFromScene(const render::ScenePointer& scene, render::Transacti
 
     _blendshapeOffsets.clear();
     _blendshapeOffsetsInitialized = false;
+    _sparseBlendshapes.reset();
 
     _addedToScene = false;
 
@@ -1402,6 +1402,7 @@ void Model::deleteGeometry() {
     _deleteGeometryCounter++;
     _blendshapeOffsets.clear();
     _blendshapeOffsetsInitialized = false;
+    _sparseBlendshapes.reset();
     _meshStates.clear();
     _rig.destroyAnimGraph();
     _blendedBlendshapeCoefficients.clear();
@@ -1479,6 +1480,7 @@ void Model::createRenderItemSet() {
             shapeID++;
         }
     }
+    _sparseBlendshapes = DependencyManager::get<ModelBlender>()->getSparseBlendshapes(_renderGeometry);
     _blendshapeOffsetsInitialized = true;
 }
 
@@ -1565,123 +1567,76 @@ public:
 };
 
 
-using packBlendshapeOffsetTo = void(glm::uvec4& packed, const BlendshapeOffsetUnpacked& unpacked);
-
-void packBlendshapeOffsetTo_Pos_F32_3xSN10_Nor_3xSN10_Tan_3xSN10(glm::uvec4& packed, const BlendshapeOffsetUnpacked& unpacked) {
-    float len = glm::compMax(glm::abs(unpacked.positionOffset));
-    glm::vec3 normalizedPos(unpacked.positionOffset);
-    if (len > 1.0f) {
-        normalizedPos /= len;
-    } else {
-        len = 1.0f;
-    }
-
-    packed = glm::uvec4(
-        glm::floatBitsToUint(len),
-        glm::packSnorm3x10_1x2(glm::vec4(normalizedPos, 0.0f)),
-        glm::packSnorm3x10_1x2(glm::vec4(unpacked.normalOffset, 0.0f)),
-        glm::packSnorm3x10_1x2(glm::vec4(unpacked.tangentOffset, 0.0f))
-    );
-}
-
 class Blender : public QRunnable {
 public:
 
-    Blender(ModelPointer model, int blendNumber, const Geometry::WeakPointer& geometry, const QVector<float>& blendshapeCoefficients);
+    Blender(ModelPointer model, int blendNumber, const Geometry::WeakPointer& geometry, const QVector<float>& blendshapeCoefficients,
+            const SparseModelBlendshapesPointer& blendshapes);
 
     virtual void run() override;
 
 private:
+    bool meshSizesMatch() const;
 
     ModelPointer _model;
     int _blendNumber;
     Geometry::WeakPointer _geometry;
     QVector<float> _blendshapeCoefficients;
+    SparseModelBlendshapesPointer _blendshapes;
 };
 
-Blender::Blender(ModelPointer model, int blendNumber, const Geometry::WeakPointer& geometry, const QVector<float>& blendshapeCoefficients) :
+Blender::Blender(ModelPointer model, int blendNumber, const Geometry::WeakPointer& geometry, const QVector<float>& blendshapeCoefficients,
+                 const SparseModelBlendshapesPointer& blendshapes) :
     _model(model),
     _blendNumber(blendNumber),
     _geometry(geometry),
-    _blendshapeCoefficients(blendshapeCoefficients) {
+    _blendshapeCoefficients(blendshapeCoefficients),
+    _blendshapes(blendshapes) {
+}
+
+// Each blendshaped mesh must have its offsets allocated by the model, with one offset per vertex
+bool Blender::meshSizesMatch() const {
+    const auto& meshes = _model->getHFMModel().meshes;
+    if (meshes.size() != (int)_blendshapes->size()) {
+        return false;
+    }
+    for (int meshIndex = 0; meshIndex < meshes.size(); meshIndex++) {
+        const auto& meshBlendshapes = (*_blendshapes)[meshIndex];
+        if (!meshBlendshapes) {
+            continue;
+        }
+        auto modelMeshBlendshapeOffsets = _model->_blendshapeOffsets.find(meshIndex);
+        if (modelMeshBlendshapeOffsets == _model->_blendshapeOffsets.end() ||
+            meshes.at(meshIndex).vertices.size() != modelMeshBlendshapeOffsets->second.size() ||
+            meshBlendshapes->getNumVertices() != modelMeshBlendshapeOffsets->second.size()) {
+            return false;
+        }
+    }
+    return true;
 }
 
 void Blender::run() {
-    QVector<BlendshapeOffset> blendshapeOffsets;
-    QVector<int> blendedMeshSizes;
-    if (_model && _model->isLoaded()) {
+    BlendedResultCache::Result blended;
+    if (_model && _model->isLoaded() && _blendshapes && meshSizesMatch()) {
         DETAILED_PROFILE_RANGE_EX(simulation_animation, __FUNCTION__, 0xFFFF0000, 0, { { "url", _model->getURL().toString() } });
-        int offset = 0;
-        auto meshes = _model->getHFMModel().meshes;
-        int meshIndex = 0;
-        foreach(const HFMMesh& mesh, meshes) {
-            auto modelMeshBlendshapeOffsets = _model->_blendshapeOffsets.find(meshIndex++);
-            if (mesh.blendshapes.isEmpty() || modelMeshBlendshapeOffsets == _model->_blendshapeOffsets.end()) {
-                // Not blendshaped or not initialized
-                blendedMeshSizes.push_back(0);
-                continue;
-            }
-
-            if (mesh.vertices.size() != modelMeshBlendshapeOffsets->second.size()) {
-                // Mesh sizes don't match.  Something has gone wrong
-                blendedMeshSizes.push_back(0);
-                continue;
-            }
-
-            blendshapeOffsets += modelMeshBlendshapeOffsets->second;
-            BlendshapeOffset* meshBlendshapeOffsets = blendshapeOffsets.data() + offset;
-            int numVertices = modelMeshBlendshapeOffsets->second.size();
-            blendedMeshSizes.push_back(numVertices);
-            offset += numVertices;
-            std::vector<BlendshapeOffsetUnpacked> unpackedBlendshapeOffsets(modelMeshBlendshapeOffsets->second.size());
-
-            const float NORMAL_COEFFICIENT_SCALE = 0.01f;
-            for (int i = 0, n = qMin(_blendshapeCoefficients.size(), mesh.blendshapes.size()); i < n; i++) {
-                float vertexCoefficient = _blendshapeCoefficients.at(i);
-                const float EPSILON = 0.0001f;
-                if (vertexCoefficient < EPSILON) {
-                    continue;
-                }
-
-                float normalCoefficient = vertexCoefficient * NORMAL_COEFFICIENT_SCALE;
-                const HFMBlendshape& blendshape = mesh.blendshapes.at(i);
 
-                tbb::parallel_for(tbb::blocked_range<int>(0, blendshape.indices.size()), [&](const tbb::blocked_range<int>& range) {
-                    for (auto j = range.begin(); j < range.end(); j++) {
-                        int index = blendshape.indices.at(j);
-
-                        auto& currentBlendshapeOffset = unpackedBlendshapeOffsets[index];
-                        currentBlendshapeOffset.positionOffset += blendshape.vertices.at(j) * vertexCoefficient;
-
-                        currentBlendshapeOffset.normalOffset += blendshape.normals.at(j) * normalCoefficient;
-                        if (j < blendshape.tangents.size()) {
-                            currentBlendshapeOffset.tangentOffset += blendshape.tangents.at(j) * normalCoefficient;
-                        }
-                    }
-                });
-            }
-
-            // Blendshape offsets are generrated, now let's pack it on its way to gpu
-            tbb::parallel_for(tbb::blocked_range<int>(0, (int) unpackedBlendshapeOffsets.size()), [&](const tbb::blocked_range<int>& range) {
-                auto unpacked = unpackedBlendshapeOffsets.data() + range.begin();
-                auto packed = meshBlendshapeOffsets + range.begin();
-                for (auto j = range.begin(); j < range.end(); j++) {
-                    packBlendshapeOffsetTo_Pos_F32_3xSN10_Nor_3xSN10_Tan_3xSN10((*packed).packedPosNorTan, (*unpacked));
-
-                    unpacked++;
-                    packed++;
-                }
-            });
+        // instances of the same model with the same quantized coefficients share their offsets
+        auto coefficients = quantizeBlendshapeCoefficients(_blendshapeCoefficients);
+        auto& resultCache = DependencyManager::get<ModelBlender>()->getBlendedResultCache();
+        if (!resultCache.find(_blendshapes, coefficients, blended)) {
+            blendSparseModelBlendshapes(*_blendshapes, coefficients, blended.offsets, blended.meshSizes);
+            resultCache.insert(_blendshapes, coefficients, blended);
         }
     }
     // post the result to the ModelBlender, which will dispatch to the model if still alive
     QMetaObject::invokeMethod(DependencyManager::get<ModelBlender>().data(), "setBlendedVertices",
-        Q_ARG(ModelPointer, _model), Q_ARG(int, _blendNumber), Q_ARG(QVector<BlendshapeOffset>, blendshapeOffsets), Q_ARG(QVector<int>, blendedMeshSizes));
+        Q_ARG(ModelPointer, _model), Q_ARG(int, _blendNumber), Q_ARG(QVector<BlendshapeOffset>, blended.offsets), Q_ARG(QVector<int>, blended.meshSizes));
 }
 
 bool Model::maybeStartBlender() {
     if (isLoaded()) {
-        QThreadPool::globalInstance()->start(new Blender(getThisPointer(), ++_blendNumber, _renderGeometry, _blendshapeCoefficients));
+        QThreadPool::globalInstance()->start(new Blender(getThisPointer(), ++_blendNumber, _renderGeometry, _blendshapeCoefficients,
+                                                         _sparseBlendshapes));
         return true;
     }
     return false;
@@ -1710,6 +1665,37 @@ ModelBlender::ModelBlender() :
 ModelBlender::~ModelBlender() {
 }
 
+SparseModelBlendshapesPointer ModelBlender::getSparseBlendshapes(const Geometry::Pointer& geometry) {
+    if (!geometry || !geometry->isHFMModelLoaded()) {
+        return SparseModelBlendshapesPointer();
+    }
+    HFMModelWeakPointer hfmModel = geometry->getHFMModelPointer();
+
+    Lock lock(_mutex);
+    auto it = _sparseBlendshapes.find(hfmModel);
+    if (it != _sparseBlendshapes.end()) {
+        auto blendshapes = it->second.lock();
+        if (blendshapes) {
+            return blendshapes;
+        }
+    }
+    lock.unlock();
+
+    // only the sparse data is kept, the cache is keyed by the model itself so an entry can't match another model
+    auto blendshapes = std::make_shared<const SparseModelBlendshapes>(buildSparseModelBlendshapes(geometry->getHFMModel()));
+
+    lock.lock();
+    for (auto expired = _sparseBlendshapes.begin(); expired != _sparseBlendshapes.end();) {
+        if (expired->first.expired() || expired->second.expired()) {
+            expired = _sparseBlendshapes.erase(expired);
+        } else {
+            ++expired;
+        }
+    }
+    _sparseBlendshapes[hfmModel] = blendshapes;
+    return blendshapes;
+}
+
 void ModelBlender::noteRequiresBlend(ModelPointer model) {
     Lock lock(_mutex);
     if (_modelsRequiringBlendsSet.find(model) == _modelsRequiringBlendsSet.end()) {
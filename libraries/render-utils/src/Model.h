@@ -17,6 +17,7 @@
 #include <QUrl>
 #include <QMutex>
 
+#include <map>
 #include <unordered_map>
 #include <unordered_set>
 #include <functional>
@@ -37,6 +38,7 @@
 #include "GeometryCache.h"
 #include "TextureCache.h"
 #include "Rig.h"
+#include "SparseBlendshapes.h"
 
 // Use dual quaternion skinning!
 // Must match define in Skinning.slh
@@ -75,17 +77,6 @@ struct SortedTriangleSet {
     int subMeshIndex;
 };
 
-struct BlendshapeOffsetPacked {
-    glm::uvec4 packedPosNorTan;
-};
-
-struct BlendshapeOffsetUnpacked {
-    glm::vec3 positionOffset;
-    glm::vec3 normalOffset;
-    glm::vec3 tangentOffset;
-};
-
-using BlendshapeOffset = BlendshapeOffsetPacked;
 using BlendShapeOperator = std::function<void(int, const QVector<BlendshapeOffset>&, const QVector<int>&, const render::ItemIDs&)>;
 
 /// A generic 3D model displaying geometry loaded from a URL.
@@ -445,6 +436,7 @@ protected:
     QVector<float> _blendedBlendshapeCoefficients;
     int _blendNumber { 0 };
     bool _blendshapeOffsetsInitialized { false };
+    SparseModelBlendshapesPointer _sparseBlendshapes;
 
     mutable QMutex _mutex{ QMutex::Recursive };
 
@@ -532,6 +524,11 @@ public:
 
     bool shouldComputeBlendshapes() { return _computeBlendshapes; }
 
+    /// Returns the blendshapes of the geometry preprocessed for blending, shared by all the models of the same geometry.
+    SparseModelBlendshapesPointer getSparseBlendshapes(const Geometry::Pointer& geometry);
+
+    BlendedResultCache& getBlendedResultCache() { return _blendedResultCache; }
+
 public slots:
     void setBlendedVertices(ModelPointer model, int blendNumber, QVector<BlendshapeOffset> blendshapeOffsets, QVector<int> blendedMeshSizes);
     void setComputeBlendshapes(bool computeBlendshapes) { _computeBlendshapes = computeBlendshapes; }
@@ -549,6 +546,10 @@ private:
     Mutex _mutex;
 
     bool _computeBlendshapes { true };
+
+    using HFMModelWeakPointer = std::weak_ptr<const HFMModel>;
+    std::map<HFMModelWeakPointer, std::weak_ptr<const SparseModelBlendshapes>, std::owner_less<HFMModelWeakPointer>> _sparseBlendshapes;
+    BlendedResultCache _blendedResultCache;
 };
 
 
@@ -0,0 +1,277 @@
+//
+//  SparseBlendshapes.cpp
+//  render-utils/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SparseBlendshapes.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#include <glm/gtc/packing.hpp>
+#include <glm/gtx/component_wise.hpp>
+
+#include <TBBHelpers.h>
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#include <xmmintrin.h>
+#define SPARSE_BLENDSHAPES_SSE
+#endif
+
+static const float BLENDSHAPE_COEFFICIENT_QUANTUM = 1.0f / 1024.0f;
+static const float MIN_BLENDSHAPE_COEFFICIENT = 0.0001f;
+static const float NORMAL_COEFFICIENT_SCALE = 0.01f;
+
+void packBlendshapeOffsetTo_Pos_F32_3xSN10_Nor_3xSN10_Tan_3xSN10(glm::uvec4& packed, const BlendshapeOffsetUnpacked& unpacked) {
+    float len = glm::compMax(glm::abs(unpacked.positionOffset));
+    glm::vec3 normalizedPos(unpacked.positionOffset);
+    if (len > 1.0f) {
+        normalizedPos /= len;
+    } else {
+        len = 1.0f;
+    }
+
+    packed = glm::uvec4(
+        glm::floatBitsToUint(len),
+        glm::packSnorm3x10_1x2(glm::vec4(normalizedPos, 0.0f)),
+        glm::packSnorm3x10_1x2(glm::vec4(unpacked.normalOffset, 0.0f)),
+        glm::packSnorm3x10_1x2(glm::vec4(unpacked.tangentOffset, 0.0f))
+    );
+}
+
+SparseBlendshapes::SparseBlendshapes(const HFMMesh& mesh) :
+    _numVertices(mesh.vertices.size()),
+    _numBlocks((mesh.vertices.size() + VERTEX_BLOCK_SIZE - 1) / VERTEX_BLOCK_SIZE)
+{
+    _blendshapes.resize(mesh.blendshapes.size());
+    for (int i = 0; i < mesh.blendshapes.size(); i++) {
+        const HFMBlendshape& blendshape = mesh.blendshapes.at(i);
+        auto& sparse = _blendshapes[i];
+
+        // sort the deltas by vertex, the ones of invalid vertices are dropped
+        std::vector<std::pair<int, int>> entries;
+        entries.reserve(blendshape.indices.size());
+        for (int j = 0, n = std::min(blendshape.indices.size(), blendshape.vertices.size()); j < n; j++) {
+            int index = blendshape.indices.at(j);
+            if (index >= 0 && index < _numVertices) {
+                entries.emplace_back(index, j);
+            }
+        }
+        std::stable_sort(entries.begin(), entries.end(), [](const std::pair<int, int>& a, const std::pair<int, int>& b) {
+            return a.first < b.first;
+        });
+
+        sparse.blockIndices.reserve(entries.size());
+        for (auto& component : sparse.components) {
+            component.reserve(entries.size());
+        }
+        sparse.blockStarts.assign(_numBlocks + 1, (int)entries.size());
+
+        int block = -1;
+        for (size_t e = 0; e < entries.size(); e++) {
+            int index = entries[e].first;
+            int j = entries[e].second;
+            while (block < index / VERTEX_BLOCK_SIZE) {
+                sparse.blockStarts[++block] = (int)e;
+            }
+            sparse.blockIndices.push_back((uint16_t)(index % VERTEX_BLOCK_SIZE));
+
+            glm::vec3 position = blendshape.vertices.at(j);
+            glm::vec3 normal = j < blendshape.normals.size() ? blendshape.normals.at(j) : glm::vec3(0.0f);
+            glm::vec3 tangent = j < blendshape.tangents.size() ? blendshape.tangents.at(j) : glm::vec3(0.0f);
+            for (int c = 0; c < 3; c++) {
+                sparse.components[c].push_back(position[c]);
+                sparse.components[3 + c].push_back(normal[c]);
+                sparse.components[6 + c].push_back(tangent[c]);
+            }
+        }
+    }
+}
+
+// Scales the deltas of a component four at a time and adds them to the vertices of the block
+static inline void accumulateComponent(const float* deltas, const uint16_t* indices, int begin, int end, float coefficient,
+                                       float* accumulated) {
+    int i = begin;
+#ifdef SPARSE_BLENDSHAPES_SSE
+    const __m128 scale = _mm_set1_ps(coefficient);
+    alignas(16) float scaled[4];
+    for (; i + 4 <= end; i += 4) {
+        _mm_store_ps(scaled, _mm_mul_ps(_mm_loadu_ps(deltas + i), scale));
+        accumulated[indices[i]] += scaled[0];
+        accumulated[indices[i + 1]] += scaled[1];
+        accumulated[indices[i + 2]] += scaled[2];
+        accumulated[indices[i + 3]] += scaled[3];
+    }
+#endif
+    for (; i < end; i++) {
+        accumulated[indices[i]] += deltas[i] * coefficient;
+    }
+}
+
+void SparseBlendshapes::blendBlock(int block, const std::vector<float>& coefficients, BlendshapeOffset* offsets) const {
+    const int blockBegin = block * VERTEX_BLOCK_SIZE;
+    const int blockSize = std::min(VERTEX_BLOCK_SIZE, _numVertices - blockBegin);
+
+    float accumulated[NUM_COMPONENTS][VERTEX_BLOCK_SIZE];
+    memset(accumulated, 0, sizeof(accumulated));
+
+    for (int i = 0, n = std::min((int)coefficients.size(), getNumBlendshapes()); i < n; i++) {
+        float vertexCoefficient = coefficients[i];
+        if (vertexCoefficient == 0.0f) {
+            continue;
+        }
+        const auto& blendshape = _blendshapes[i];
+        int begin = blendshape.blockStarts[block];
+        int end = blendshape.blockStarts[block + 1];
+        if (begin == end) {
+            continue;
+        }
+
+        float normalCoefficient = vertexCoefficient * NORMAL_COEFFICIENT_SCALE;
+        for (int c = 0; c < NUM_COMPONENTS; c++) {
+            accumulateComponent(blendshape.components[c].data(), blendshape.blockIndices.data(), begin, end,
+                                c < 3 ? vertexCoefficient : normalCoefficient, accumulated[c]);
+        }
+    }
+
+    BlendshapeOffset* packed = offsets + blockBegin;
+    for (int v = 0; v < blockSize; v++) {
+        BlendshapeOffsetUnpacked unpacked;
+        unpacked.positionOffset = glm::vec3(accumulated[0][v], accumulated[1][v], accumulated[2][v]);
+        unpacked.normalOffset = glm::vec3(accumulated[3][v], accumulated[4][v], accumulated[5][v]);
+        unpacked.tangentOffset = glm::vec3(accumulated[6][v], accumulated[7][v], accumulated[8][v]);
+        packBlendshapeOffsetTo_Pos_F32_3xSN10_Nor_3xSN10_Tan_3xSN10(packed[v].packedPosNorTan, unpacked);
+    }
+}
+
+void SparseBlendshapes::blend(const std::vector<float>& coefficients, BlendshapeOffset* offsets) const {
+    tbb::parallel_for(tbb::blocked_range<int>(0, _numBlocks), [&](const tbb::blocked_range<int>& range) {
+        for (int block = range.begin(); block < range.end(); block++) {
+            blendBlock(block, coefficients, offsets);
+        }
+    });
+}
+
+SparseModelBlendshapes buildSparseModelBlendshapes(const HFMModel& model) {
+    SparseModelBlendshapes blendshapes;
+    blendshapes.reserve(model.meshes.size());
+    for (const auto& mesh : model.meshes) {
+        blendshapes.push_back(mesh.blendshapes.isEmpty() ? nullptr : std::make_shared<const SparseBlendshapes>(mesh));
+    }
+    return blendshapes;
+}
+
+QuantizedBlendshapeCoefficients quantizeBlendshapeCoefficients(const QVector<float>& coefficients) {
+    QuantizedBlendshapeCoefficients quantized(coefficients.size(), 0);
+    for (int i = 0; i < coefficients.size(); i++) {
+        float coefficient = coefficients.at(i);
+        if (coefficient >= MIN_BLENDSHAPE_COEFFICIENT) {
+            quantized[i] = (uint16_t)std::min(std::round(coefficient / BLENDSHAPE_COEFFICIENT_QUANTUM), (float)UINT16_MAX);
+        }
+    }
+    while (!quantized.empty() && quantized.back() == 0) {
+        quantized.pop_back();
+    }
+    return quantized;
+}
+
+void blendSparseModelBlendshapes(const SparseModelBlendshapes& blendshapes, const QuantizedBlendshapeCoefficients& coefficients,
+                                 QVector<BlendshapeOffset>& offsets, QVector<int>& meshSizes) {
+    std::vector<float> blendCoefficients(coefficients.size());
+    for (size_t i = 0; i < coefficients.size(); i++) {
+        blendCoefficients[i] = coefficients[i] * BLENDSHAPE_COEFFICIENT_QUANTUM;
+    }
+
+    int numOffsets = 0;
+    for (const auto& meshBlendshapes : blendshapes) {
+        numOffsets += meshBlendshapes ? meshBlendshapes->getNumVertices() : 0;
+    }
+    offsets.resize(numOffsets);
+    meshSizes.clear();
+    meshSizes.reserve((int)blendshapes.size());
+
+    int offset = 0;
+    for (const auto& meshBlendshapes : blendshapes) {
+        if (!meshBlendshapes) {
+            // Not blendshaped
+            meshSizes.push_back(0);
+            continue;
+        }
+        meshBlendshapes->blend(blendCoefficients, offsets.data() + offset);
+        meshSizes.push_back(meshBlendshapes->getNumVertices());
+        offset += meshBlendshapes->getNumVertices();
+    }
+}
+
+QByteArray BlendedResultCache::makeKey(const SparseModelBlendshapesPointer& blendshapes,
+                                       const QuantizedBlendshapeCoefficients& coefficients) {
+    const SparseModelBlendshapes* address = blendshapes.get();
+    QByteArray key;
+    key.reserve((int)(sizeof(address) + coefficients.size() * sizeof(uint16_t)));
+    key.append(reinterpret_cast<const char*>(&address), sizeof(address));
+    key.append(reinterpret_cast<const char*>(coefficients.data()), (int)(coefficients.size() * sizeof(uint16_t)));
+    return key;
+}
+
+bool BlendedResultCache::find(const SparseModelBlendshapesPointer& blendshapes, const QuantizedBlendshapeCoefficients& coefficients,
+                              Result& result) {
+    auto key = makeKey(blendshapes, coefficients);
+    std::unique_lock<std::mutex> lock(_mutex);
+    auto it = _entries.find(key);
+    if (it == _entries.end()) {
+        ++_numMisses;
+        return false;
+    }
+    ++_numHits;
+    // the vectors are implicitly shared, the instances don't copy the offsets
+    result = it.value().result;
+    return true;
+}
+
+void BlendedResultCache::insert(const SparseModelBlendshapesPointer& blendshapes, const QuantizedBlendshapeCoefficients& coefficients,
+                                const Result& result) {
+    if (result.offsets.size() > _maxOffsets) {
+        return;
+    }
+
+    auto key = makeKey(blendshapes, coefficients);
+    std::unique_lock<std::mutex> lock(_mutex);
+    if (_entries.contains(key)) {
+        return;
+    }
+
+    while (_numOffsets + result.offsets.size() > _maxOffsets && !_insertionOrder.empty()) {
+        auto oldest = _entries.find(_insertionOrder.front());
+        _numOffsets -= oldest.value().result.offsets.size();
+        _entries.erase(oldest);
+        _insertionOrder.pop_front();
+    }
+
+    _entries.insert(key, { blendshapes, result });
+    _insertionOrder.push_back(key);
+    _numOffsets += result.offsets.size();
+}
+
+void BlendedResultCache::clear() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _entries.clear();
+    _insertionOrder.clear();
+    _numOffsets = 0;
+}
+
+quint64 BlendedResultCache::getNumHits() const {
+    std::unique_lock<std::mutex> lock(_mutex);
+    return _numHits;
+}
+
+quint64 BlendedResultCache::getNumMisses() const {
+    std::unique_lock<std::mutex> lock(_mutex);
+    return _numMisses;
+}
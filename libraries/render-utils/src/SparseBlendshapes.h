@@ -0,0 +1,134 @@
+//
+//  SparseBlendshapes.h
+//  render-utils/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_SparseBlendshapes_h
+#define hifi_SparseBlendshapes_h
+
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QHash>
+#include <QtCore/QVector>
+
+#include <glm/glm.hpp>
+
+#include <hfm/HFM.h>
+
+struct BlendshapeOffsetPacked {
+    glm::uvec4 packedPosNorTan;
+};
+
+struct BlendshapeOffsetUnpacked {
+    glm::vec3 positionOffset;
+    glm::vec3 normalOffset;
+    glm::vec3 tangentOffset;
+};
+
+using BlendshapeOffset = BlendshapeOffsetPacked;
+
+void packBlendshapeOffsetTo_Pos_F32_3xSN10_Nor_3xSN10_Tan_3xSN10(glm::uvec4& packed, const BlendshapeOffsetUnpacked& unpacked);
+
+// The blendshapes of a mesh, preprocessed at load into sparse structures of arrays sorted by vertex.
+// Blending accumulates them in blocks of vertices that stay in cache, and packs each block as soon as it is done.
+class SparseBlendshapes {
+public:
+    static const int VERTEX_BLOCK_SIZE = 256;
+
+    SparseBlendshapes(const HFMMesh& mesh);
+
+    int getNumVertices() const { return _numVertices; }
+    int getNumBlendshapes() const { return (int)_blendshapes.size(); }
+
+    // Writes the packed offsets of all the vertices of the mesh, blendshapes with a null coefficient are skipped
+    void blend(const std::vector<float>& coefficients, BlendshapeOffset* offsets) const;
+
+private:
+    // position, normal and tangent components
+    static const int NUM_COMPONENTS = 9;
+
+    struct Blendshape {
+        // vertex indices relative to their block, and the deltas of each component for these vertices
+        std::vector<uint16_t> blockIndices;
+        std::vector<float> components[NUM_COMPONENTS];
+
+        // first entry of each block of vertices, followed by the number of entries
+        std::vector<int> blockStarts;
+    };
+
+    void blendBlock(int block, const std::vector<float>& coefficients, BlendshapeOffset* offsets) const;
+
+    std::vector<Blendshape> _blendshapes;
+    int _numVertices { 0 };
+    int _numBlocks { 0 };
+};
+
+using SparseBlendshapesPointer = std::shared_ptr<const SparseBlendshapes>;
+
+// The sparse blendshapes of each mesh of a model, null for the meshes without blendshapes
+using SparseModelBlendshapes = std::vector<SparseBlendshapesPointer>;
+using SparseModelBlendshapesPointer = std::shared_ptr<const SparseModelBlendshapes>;
+
+SparseModelBlendshapes buildSparseModelBlendshapes(const HFMModel& model);
+
+// Blendshape coefficients quantized to a fixed step, trailing null coefficients removed.
+// Instances of a model with quantized-equal coefficients get the same blended offsets.
+using QuantizedBlendshapeCoefficients = std::vector<uint16_t>;
+
+QuantizedBlendshapeCoefficients quantizeBlendshapeCoefficients(const QVector<float>& coefficients);
+
+// Blends all the meshes of a model into one buffer of offsets, with the number of offsets of each mesh
+void blendSparseModelBlendshapes(const SparseModelBlendshapes& blendshapes, const QuantizedBlendshapeCoefficients& coefficients,
+                                 QVector<BlendshapeOffset>& offsets, QVector<int>& meshSizes);
+
+// Recently blended offsets, shared between the instances of a model that blend with the same quantized coefficients.
+// The oldest results are dropped once they hold too many offsets.  All methods are thread safe.
+class BlendedResultCache {
+public:
+    static const int DEFAULT_MAX_OFFSETS = 1 << 20;
+
+    struct Result {
+        QVector<BlendshapeOffset> offsets;
+        QVector<int> meshSizes;
+    };
+
+    BlendedResultCache(int maxOffsets = DEFAULT_MAX_OFFSETS) : _maxOffsets(maxOffsets) {}
+
+    bool find(const SparseModelBlendshapesPointer& blendshapes, const QuantizedBlendshapeCoefficients& coefficients,
+              Result& result);
+    void insert(const SparseModelBlendshapesPointer& blendshapes, const QuantizedBlendshapeCoefficients& coefficients,
+                const Result& result);
+
+    void clear();
+
+    quint64 getNumHits() const;
+    quint64 getNumMisses() const;
+
+private:
+    struct Entry {
+        // keeps the blendshapes alive, so their address in the key can't be reused by another model
+        SparseModelBlendshapesPointer blendshapes;
+        Result result;
+    };
+
+    static QByteArray makeKey(const SparseModelBlendshapesPointer& blendshapes, const QuantizedBlendshapeCoefficients& coefficients);
+
+    mutable std::mutex _mutex;
+    QHash<QByteArray, Entry> _entries;
+    std::deque<QByteArray> _insertionOrder;
+    int _maxOffsets;
+    int _numOffsets { 0 };
+    quint64 _numHits { 0 };
+    quint64 _numMisses { 0 };
+};
+
+#endif // hifi_SparseBlendshapes_h
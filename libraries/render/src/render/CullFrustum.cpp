@@ -0,0 +1,105 @@
+//
+//  CullFrustum.cpp
+//  render/src/render
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "CullFrustum.h"
+
+#include <cmath>
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#include <xmmintrin.h>
+#define CULL_FRUSTUM_SSE
+#endif
+
+using namespace render;
+
+void CullFrustum::setPlanes(const ViewFrustum& frustum) {
+    const auto planes = frustum.getPlanes();
+    for (int i = 0; i < NUM_PADDED_PLANES; i++) {
+        // a null plane with a null distance never rejects a bound
+        glm::vec3 normal(0.0f);
+        float distance = 0.0f;
+        if (i < ViewFrustum::NUM_PLANES) {
+            normal = planes[i].getNormal();
+            distance = planes[i].getDCoefficient();
+        }
+        _normalX[i] = normal.x;
+        _normalY[i] = normal.y;
+        _normalZ[i] = normal.z;
+        _absNormalX[i] = fabsf(normal.x);
+        _absNormalY[i] = fabsf(normal.y);
+        _absNormalZ[i] = fabsf(normal.z);
+        _distance[i] = distance;
+    }
+}
+
+// The distance of the box to a plane is the distance of its center plus or minus its half extents projected on the plane
+// normal, which is the distance of its farthest or nearest vertex
+#ifdef CULL_FRUSTUM_SSE
+
+template <bool Farthest>
+static inline bool boxInFrontOfPlanes(const AABox& box, const float* normalX, const float* normalY, const float* normalZ,
+                                      const float* absNormalX, const float* absNormalY, const float* absNormalZ,
+                                      const float* distance, int numPlanes) {
+    const glm::vec3 halfScale = 0.5f * box.getScale();
+    const glm::vec3 center = box.getCorner() + halfScale;
+
+    const __m128 centerX = _mm_set1_ps(center.x);
+    const __m128 centerY = _mm_set1_ps(center.y);
+    const __m128 centerZ = _mm_set1_ps(center.z);
+    const __m128 halfScaleX = _mm_set1_ps(halfScale.x);
+    const __m128 halfScaleY = _mm_set1_ps(halfScale.y);
+    const __m128 halfScaleZ = _mm_set1_ps(halfScale.z);
+    const __m128 zero = _mm_setzero_ps();
+
+    for (int i = 0; i < numPlanes; i += 4) {
+        __m128 centerDistance = _mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(normalX + i), centerX), _mm_mul_ps(_mm_loadu_ps(normalY + i), centerY)),
+            _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(normalZ + i), centerZ), _mm_loadu_ps(distance + i)));
+        __m128 extent = _mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(absNormalX + i), halfScaleX), _mm_mul_ps(_mm_loadu_ps(absNormalY + i), halfScaleY)),
+            _mm_mul_ps(_mm_loadu_ps(absNormalZ + i), halfScaleZ));
+        __m128 vertexDistance = Farthest ? _mm_add_ps(centerDistance, extent) : _mm_sub_ps(centerDistance, extent);
+        if (_mm_movemask_ps(_mm_cmplt_ps(vertexDistance, zero)) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+#else
+
+template <bool Farthest>
+static inline bool boxInFrontOfPlanes(const AABox& box, const float* normalX, const float* normalY, const float* normalZ,
+                                      const float* absNormalX, const float* absNormalY, const float* absNormalZ,
+                                      const float* distance, int numPlanes) {
+    const glm::vec3 halfScale = 0.5f * box.getScale();
+    const glm::vec3 center = box.getCorner() + halfScale;
+
+    for (int i = 0; i < numPlanes; i++) {
+        float centerDistance = normalX[i] * center.x + normalY[i] * center.y + normalZ[i] * center.z + distance[i];
+        float extent = absNormalX[i] * halfScale.x + absNormalY[i] * halfScale.y + absNormalZ[i] * halfScale.z;
+        if ((Farthest ? centerDistance + extent : centerDistance - extent) < 0.0f) {
+            return false;
+        }
+    }
+    return true;
+}
+
+#endif
+
+bool CullFrustum::boxIntersects(const AABox& box) const {
+    return boxInFrontOfPlanes<true>(box, _normalX, _normalY, _normalZ, _absNormalX, _absNormalY, _absNormalZ, _distance,
+                                    ViewFrustum::NUM_PLANES);
+}
+
+bool CullFrustum::boxInside(const AABox& box) const {
+    return boxInFrontOfPlanes<false>(box, _normalX, _normalY, _normalZ, _absNormalX, _absNormalY, _absNormalZ, _distance,
+                                     ViewFrustum::NUM_PLANES);
+}
@@ -0,0 +1,46 @@
+//
+//  CullFrustum.h
+//  render/src/render
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_render_CullFrustum_h
+#define hifi_render_CullFrustum_h
+
+#include <AABox.h>
+#include <ViewFrustum.h>
+
+namespace render {
+
+    // The planes of a view frustum laid out to test many bounds against them, four planes at a time where SSE is available.
+    // Gives the same answers as ViewFrustum::boxIntersectsFrustum and ViewFrustum::boxInsideFrustum.
+    class CullFrustum {
+    public:
+        CullFrustum() {}
+        CullFrustum(const ViewFrustum& frustum) { setPlanes(frustum); }
+
+        void setPlanes(const ViewFrustum& frustum);
+
+        bool boxIntersects(const AABox& box) const;
+        bool boxInside(const AABox& box) const;
+
+    private:
+        // the planes are padded to two groups of four with planes that every bound passes
+        static const int NUM_PADDED_PLANES = 8;
+
+        float _normalX[NUM_PADDED_PLANES] { 0.0f };
+        float _normalY[NUM_PADDED_PLANES] { 0.0f };
+        float _normalZ[NUM_PADDED_PLANES] { 0.0f };
+        float _absNormalX[NUM_PADDED_PLANES] { 0.0f };
+        float _absNormalY[NUM_PADDED_PLANES] { 0.0f };
+        float _absNormalZ[NUM_PADDED_PLANES] { 0.0f };
+        float _distance[NUM_PADDED_PLANES] { 0.0f };
+    };
+
+}
+
+#endif // hifi_render_CullFrustum_h
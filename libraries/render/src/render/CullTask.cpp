@@ -13,17 +13,24 @@
 
 #include <algorithm>
 #include <assert.h>
+#include <thread>
 
 #include <PerfStat.h>
 #include <OctreeUtils.h>
+#include <TBBHelpers.h>
 
 using namespace render;
 
+// Big selections are split between jobs of at least this many items
+static const size_t MIN_ITEMS_PER_CULL_JOB = 2048;
+static const size_t MAX_NUM_CULL_JOBS = 8;
+
 CullTest::CullTest(CullFunctor& functor, RenderArgs* pargs, RenderDetails::Item& renderDetails, ViewFrustumPointer antiFrustum) :
     _functor(functor),
     _args(pargs),
     _renderDetails(renderDetails),
-    _antiFrustum(antiFrustum) {
+    _antiFrustum(antiFrustum),
+    _frustum(pargs->getViewFrustum()) {
     // FIXME: Keep this code here even though we don't use it yet
     /*_eyePos = _args->getViewFrustum().getPosition();
     float a = glm::degrees(Octree::getPerspectiveAccuracyAngle(_args->_sizeScale, _args->_boundaryLevelAdjust));
@@ -35,7 +42,7 @@ CullTest::CullTest(CullFunctor& functor, RenderArgs* pargs, RenderDetails::Item&
 }
 
 bool CullTest::frustumTest(const AABox& bound) {
-    if (!_args->getViewFrustum().boxIntersectsFrustum(bound)) {
+    if (!_frustum.boxIntersects(bound)) {
         _renderDetails._outOfView++;
         return false;
     }
@@ -165,7 +172,11 @@ void FetchSpatialTree::run(const RenderContextPointer& renderContext, const Inpu
             const auto pixelResolution = frustumResolution.x > 0 ? frustumResolution : glm::ivec2(2048, 2048);
             threshold = glm::max(threshold, glm::min(frustumSize.x / pixelResolution.x, frustumSize.y / pixelResolution.y));
         }
-        scene->getSpatialTree().selectCellItems(outSelection, filter, queryFrustum, threshold);
+
+        // One view through the multi view selection, which traverses the branches of big trees in parallel
+        ItemSpatialTree::ItemSelections selections(1);
+        scene->getSpatialTree().selectCellItems(selections, filter, { queryFrustum }, { threshold });
+        std::swap(outSelection, selections[0]);
     }
 }
 
@@ -173,6 +184,7 @@ void CullSpatialSelection::configure(const Config& config) {
     _justFrozeFrustum = _justFrozeFrustum || (config.freezeFrustum && !_freezeFrustum);
     _freezeFrustum = config.freezeFrustum;
     _skipCulling = config.skipCulling;
+    _parallelCulling = config.parallelCulling;
 }
 
 void CullSpatialSelection::run(const RenderContextPointer& renderContext,
@@ -270,6 +282,9 @@ void CullSpatialSelection::run(const RenderContextPointer& renderContext,
                 }
             }
 
+        } else if (_parallelCulling && inSelection.numItems() >= 2 * MIN_ITEMS_PER_CULL_JOB) {
+            PerformanceTimer perfTimer("parallelItems");
+            cullInParallel(renderContext, inSelection, filter, details, outItems);
         } else {
 
             // inside & fit items: easy, just filter
@@ -352,6 +367,89 @@ void CullSpatialSelection::run(const RenderContextPointer& renderContext,
     std::static_pointer_cast<Config>(renderContext->jobConfig)->numItems = (int)outItems.size();
 }
 
+void CullSpatialSelection::cullInParallel(const RenderContextPointer& renderContext, const ItemSpatialTree::ItemSelection& inSelection,
+                                          const ItemFilter& filter, RenderDetails::Item& details, ItemBounds& outItems) {
+    RenderArgs* args = renderContext->args;
+    auto& scene = renderContext->_scene;
+
+    // The parts of the selection in the order they are culled one after the other, and the tests they need
+    struct Part {
+        const ItemIDs& items;
+        bool frustumTest;
+        bool solidAngleTest;
+    };
+    const Part parts[] = {
+        { inSelection.insideItems, false, false },
+        { inSelection.insideSubcellItems, false, true },
+        { inSelection.partialItems, true, false },
+        { inSelection.partialSubcellItems, true, true },
+    };
+
+    // The meta cull groups get their sub items once the outputs of the jobs are put back together
+    struct JobOutput {
+        ItemBounds items;
+        std::vector<size_t> metaCullGroups;
+        RenderDetails::Item details;
+    };
+
+    size_t numItems = inSelection.numItems();
+    size_t numJobs = std::min(MAX_NUM_CULL_JOBS, (size_t)std::max(1u, std::thread::hardware_concurrency()));
+    numJobs = std::max((size_t)1, std::min(numJobs, numItems / MIN_ITEMS_PER_CULL_JOB));
+    std::vector<JobOutput> outputs(numJobs);
+
+    // Each job culls a contiguous range of the whole selection
+    auto cullJob = [&](size_t job) {
+        auto& output = outputs[job];
+        CullTest test(_cullFunctor, args, output.details);
+        size_t begin = numItems * job / numJobs;
+        size_t end = numItems * (job + 1) / numJobs;
+        output.items.reserve(end - begin);
+
+        size_t partBegin = 0;
+        for (const auto& part : parts) {
+            size_t partEnd = partBegin + part.items.size();
+            size_t first = std::max(begin, partBegin);
+            size_t last = std::min(end, partEnd);
+            for (size_t i = first; i < last; i++) {
+                auto id = part.items[i - partBegin];
+                auto& item = scene->getItem(id);
+                if (filter.test(item.getKey())) {
+                    ItemBound itemBound(id, item.getBound());
+                    if ((!part.frustumTest || test.frustumTest(itemBound.bound)) &&
+                        (!part.solidAngleTest || test.solidAngleTest(itemBound.bound))) {
+                        if (item.getKey().isMetaCullGroup()) {
+                            output.metaCullGroups.push_back(output.items.size());
+                        }
+                        output.items.emplace_back(itemBound);
+                    }
+                }
+            }
+            partBegin = partEnd;
+        }
+    };
+
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, numJobs, 1), [&](const tbb::blocked_range<size_t>& range) {
+        for (size_t job = range.begin(); job < range.end(); job++) {
+            cullJob(job);
+        }
+    });
+
+    // Put the outputs back together in the order of the selection, as if it was culled on one thread
+    for (auto& output : outputs) {
+        details._outOfView += output.details._outOfView;
+        details._tooSmall += output.details._tooSmall;
+
+        auto metaCullGroup = output.metaCullGroups.begin();
+        for (size_t i = 0; i < output.items.size(); i++) {
+            outItems.emplace_back(output.items[i]);
+            if (metaCullGroup != output.metaCullGroups.end() && *metaCullGroup == i) {
+                scene->getItem(output.items[i].id).fetchMetaSubItemBounds(outItems, (*scene));
+                ++metaCullGroup;
+            }
+        }
+    }
+}
+
 void CullShapeBounds::run(const RenderContextPointer& renderContext, const Inputs& inputs, Outputs& outputs) {
     assert(renderContext->args);
     assert(renderContext->args->hasViewFrustum());
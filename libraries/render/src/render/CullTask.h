@@ -14,6 +14,7 @@
 
 #include "Engine.h"
 #include "ViewFrustum.h"
+#include "CullFrustum.h"
 
 namespace render {
 
@@ -28,6 +29,7 @@ namespace render {
         RenderArgs* _args;
         RenderDetails::Item& _renderDetails;
         ViewFrustumPointer _antiFrustum;
+        CullFrustum _frustum;
         glm::vec3 _eyePos;
         float _squareTanAlpha;
 
@@ -86,15 +88,18 @@ namespace render {
         Q_PROPERTY(int numItems READ getNumItems)
         Q_PROPERTY(bool freezeFrustum MEMBER freezeFrustum WRITE setFreezeFrustum)
         Q_PROPERTY(bool skipCulling MEMBER skipCulling WRITE setSkipCulling)
+        Q_PROPERTY(bool parallelCulling MEMBER parallelCulling WRITE setParallelCulling)
     public:
         int numItems{ 0 };
         int getNumItems() { return numItems; }
 
         bool freezeFrustum{ false };
         bool skipCulling{ false };
+        bool parallelCulling{ true };
     public slots:
         void setFreezeFrustum(bool enabled) { freezeFrustum = enabled; emit dirty(); }
         void setSkipCulling(bool enabled) { skipCulling = enabled; emit dirty(); }
+        void setParallelCulling(bool enabled) { parallelCulling = enabled; emit dirty(); }
     signals:
         void dirty();
     };
@@ -103,7 +108,12 @@ namespace render {
         bool _freezeFrustum{ false }; // initialized by Config
         bool _justFrozeFrustum{ false };
         bool _skipCulling{ false };
+        bool _parallelCulling{ true };
         ViewFrustum _frozenFrustum;
+
+        // Test the bounds of big selections on several threads
+        void cullInParallel(const RenderContextPointer& renderContext, const ItemSpatialTree::ItemSelection& inSelection,
+                            const ItemFilter& filter, RenderDetails::Item& details, ItemBounds& outItems);
     public:
         using Config = CullSpatialSelectionConfig;
         using Inputs = render::VaryingSet2<ItemSpatialTree::ItemSelection, ItemFilter>;
@@ -10,6 +10,9 @@
 //
 #include "SpatialTree.h"
 
+#include <algorithm>
+
+#include <TBBHelpers.h>
 #include <ViewFrustum.h>
 
 using namespace render;
@@ -435,27 +438,6 @@ ItemSpatialTree::Index ItemSpatialTree::resetItem(Index oldCell, const ItemKey&
     }
 }
 
-int Octree::select(CellSelection& selection, const FrustumSelector& selector) const {
-
-    Index cellID = ROOT_CELL;
-    auto cell = getConcreteCell(cellID);
-    int numSelectedsIn = (int)selection.size();
-
-    // Always include the root cell partially containing potentially outer objects
-    selectCellBrick(cellID, selection, false);
-
-    // then traverse deeper
-    for (int i = 0; i < NUM_OCTANTS; i++) {
-        Index subCellID = cell.child((Link)i);
-        if (subCellID != INVALID_CELL) {
-            selectTraverse(subCellID, selection, selector);
-        }
-    }
-
-    return (int)selection.size() - numSelectedsIn;
-}
-
-
 Octree::Location::Intersection Octree::Location::intersectCell(const Location& cell, const Coord4f frustum[6]) {
     const Coord3f CornerOffsets[8] = {
         { 0.0, 0.0, 0.0 },
@@ -514,124 +496,191 @@ Octree::Location::Intersection Octree::Location::intersectCell(const Location& c
     return Inside;
 }
 
-int Octree::selectTraverse(Index cellID, CellSelection& selection, const FrustumSelector& selector) const {
+int Octree::selectCellBrick(Index cellID, CellSelection& selection, bool inside) const {
     int numSelectedsIn = (int) selection.size();
     auto cell = getConcreteCell(cellID);
+    selection.cells(inside).push_back(cellID);
+
+    if (!cell.isBrickEmpty()) {
+        // Collect the items of this cell
+        selection.bricks(inside).push_back(cell.brick());
+    }
+
+    return (int) selection.size() - numSelectedsIn;
+}
 
-    auto cellLocation = cell.getlocation();
+// Below this many cells, traversing the tree takes less time than handing its branches over to other threads
+static const int MIN_CELLS_FOR_PARALLEL_SELECT = 4096;
 
-    auto intersection = Octree::Location::intersectCell(cellLocation, selector.frustum);
-    switch (intersection) {
-        case Octree::Location::Outside:
-            // cell is outside, stop traversing this branch
-            return 0;
-            break;
-        case Octree::Location::Inside: {
-            // traverse all the Cell Branch and collect items in the selection
-            selectBranch(cellID, selection, selector);
-            break;
+static void appendCellSelection(Octree::CellSelection& selection, const Octree::CellSelection& branchSelection) {
+    selection.insideCells.insert(selection.insideCells.end(), branchSelection.insideCells.begin(), branchSelection.insideCells.end());
+    selection.insideBricks.insert(selection.insideBricks.end(), branchSelection.insideBricks.begin(), branchSelection.insideBricks.end());
+    selection.partialCells.insert(selection.partialCells.end(), branchSelection.partialCells.begin(), branchSelection.partialCells.end());
+    selection.partialBricks.insert(selection.partialBricks.end(), branchSelection.partialBricks.begin(), branchSelection.partialBricks.end());
+}
+
+void Octree::select(CellSelection* selections, const FrustumSelector* const* selectors, int numViews) const {
+    for (int firstView = 0; firstView < numViews; firstView += MAX_NUM_SELECT_VIEWS) {
+        int numGroupViews = std::min(numViews - firstView, (int)MAX_NUM_SELECT_VIEWS);
+        auto groupSelections = selections + firstView;
+        auto groupSelectors = selectors + firstView;
+
+        // Always include the root cell partially containing potentially outer objects
+        for (int v = 0; v < numGroupViews; v++) {
+            selectCellBrick(ROOT_CELL, groupSelections[v], false);
+        }
+
+        ViewIntersections intersections;
+        intersections.fill(Location::Intersect);
+
+        Indices branchCells;
+        const auto& root = getConcreteCell(ROOT_CELL);
+        for (int i = 0; i < NUM_OCTANTS; i++) {
+            Index subCellID = root.child((Link)i);
+            if (subCellID != INVALID_CELL) {
+                branchCells.push_back(subCellID);
+            }
         }
-        case Octree::Location::Intersect:
-        default: {
-            // Cell is partially in
-
-            // Test for lod
-            auto cellLocation = cell.getlocation();
-            float test = selector.testThreshold(cellLocation.getCenter(), Octree::getCoordSubcellWidth(cellLocation.depth));
-            if (test < 0.0f) {
-                return 0;
+
+        if (getNumAllocatedCells() < MIN_CELLS_FOR_PARALLEL_SELECT || branchCells.size() < 2) {
+            for (auto subCellID : branchCells) {
+                selectTraverseViews(subCellID, intersections, groupSelections, groupSelectors, numGroupViews);
             }
+            continue;
+        }
 
-            // Select this cell partially in frustum
-            selectCellBrick(cellID, selection, false);
+        // then traverse the branches in parallel, each one in its own selections appended in octant order,
+        // which gives the same selections as traversing them one after the other
+        using BranchSelections = std::array<CellSelection, MAX_NUM_SELECT_VIEWS>;
+        std::vector<BranchSelections> branchSelections(branchCells.size());
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, branchCells.size(), 1), [&](const tbb::blocked_range<size_t>& range) {
+            for (size_t b = range.begin(); b < range.end(); b++) {
+                selectTraverseViews(branchCells[b], intersections, branchSelections[b].data(), groupSelectors, numGroupViews);
+            }
+        });
 
-            // then traverse deeper
-            for (int i = 0; i < NUM_OCTANTS; i++) {
-                Index subCellID = cell.child((Link)i);
-                if (subCellID != INVALID_CELL) {
-                    selectTraverse(subCellID, selection, selector);
-                }
+        for (auto& branchSelection : branchSelections) {
+            for (int v = 0; v < numGroupViews; v++) {
+                appendCellSelection(groupSelections[v], branchSelection[v]);
             }
         }
     }
-
-    return (int) selection.size() - numSelectedsIn;
 }
 
+// A view stops traversing the branch when the cell is outside of it or too small for it,
+// and stops testing the cell against its frustum once the cell is inside of it
+void Octree::selectTraverseViews(Index cellID, ViewIntersections intersections, CellSelection* selections,
+                                 const FrustumSelector* const* selectors, int numViews) const {
+    const auto& cell = getConcreteCell(cellID);
+    const auto& cellLocation = cell.getlocation();
+
+    bool isSelected = false;
+    for (int v = 0; v < numViews; v++) {
+        if (intersections[v] == Location::Outside) {
+            continue;
+        }
+        if (intersections[v] == Location::Intersect) {
+            intersections[v] = Location::intersectCell(cellLocation, selectors[v]->frustum);
+            if (intersections[v] == Location::Outside) {
+                continue;
+            }
+        }
 
-int Octree::selectBranch(Index cellID, CellSelection& selection, const FrustumSelector& selector) const {
-    int numSelectedsIn = (int) selection.size();
-    auto cell = getConcreteCell(cellID);
+        // Test for lod
+        float test = selectors[v]->testThreshold(cellLocation.getCenter(), Octree::getCoordSubcellWidth(cellLocation.depth));
+        if (test < 0.0f) {
+            intersections[v] = Location::Outside;
+            continue;
+        }
 
-    auto cellLocation = cell.getlocation();
-    float test = selector.testThreshold(cellLocation.getCenter(), Octree::getCoordSubcellWidth(cellLocation.depth));
-    if (test < 0.0f) {
-        return 0;
+        selectCellBrick(cellID, selections[v], intersections[v] == Location::Inside);
+        isSelected = true;
     }
 
-    // Select this cell fully inside the frustum
-    selectCellBrick(cellID, selection, true);
+    if (!isSelected) {
+        return;
+    }
 
     // then traverse deeper
     for (int i = 0; i < NUM_OCTANTS; i++) {
         Index subCellID = cell.child((Link)i);
         if (subCellID != INVALID_CELL) {
-            selectBranch(subCellID, selection, selector);
+            selectTraverseViews(subCellID, intersections, selections, selectors, numViews);
         }
     }
-
-    return (int) selection.size() - numSelectedsIn;
 }
 
-int Octree::selectCellBrick(Index cellID, CellSelection& selection, bool inside) const {
-    int numSelectedsIn = (int) selection.size();
-    auto cell = getConcreteCell(cellID);
-    selection.cells(inside).push_back(cellID);
-
-    if (!cell.isBrickEmpty()) {
-        // Collect the items of this cell
-        selection.bricks(inside).push_back(cell.brick());
-    }
-
-    return (int) selection.size() - numSelectedsIn;
+int ItemSpatialTree::selectCells(CellSelection& selection, const ViewFrustum& frustum, float threshold) const {
+    int numSelectedsIn = (int)selection.size();
+    auto selector = evalSelector(frustum, threshold);
+    const FrustumSelector* selectors[] = { selector.get() };
+    Octree::select(&selection, selectors, 1);
+    return (int)selection.size() - numSelectedsIn;
 }
 
-int ItemSpatialTree::selectCells(CellSelection& selection, const ViewFrustum& frustum, float threshold) const {
+std::unique_ptr<Octree::FrustumSelector> ItemSpatialTree::evalSelector(const ViewFrustum& frustum, float threshold) const {
     auto worldPlanes = frustum.getPlanes();
     if (frustum.isPerspective()) {
-        PerspectiveSelector selector;
+        auto selector = std::unique_ptr<PerspectiveSelector>(new PerspectiveSelector());
         for (int i = 0; i < ViewFrustum::NUM_PLANES; i++) {
             ::Plane octPlane;
             octPlane.setNormalAndPoint(worldPlanes[i].getNormal(), evalCoordf(worldPlanes[i].getPoint(), ROOT_DEPTH));
-            selector.frustum[i] = Coord4f(octPlane.getNormal(), octPlane.getDCoefficient());
+            selector->frustum[i] = Coord4f(octPlane.getNormal(), octPlane.getDCoefficient());
         }
 
-        selector.eyePos = evalCoordf(frustum.getPosition(), ROOT_DEPTH);
-        selector.setAngle(threshold);
+        selector->eyePos = evalCoordf(frustum.getPosition(), ROOT_DEPTH);
+        selector->setAngle(threshold);
 
-        return Octree::select(selection, selector);
+        return std::move(selector);
     } else {
-        OrthographicSelector selector;
+        auto selector = std::unique_ptr<OrthographicSelector>(new OrthographicSelector());
         for (int i = 0; i < ViewFrustum::NUM_PLANES; i++) {
             ::Plane octPlane;
             octPlane.setNormalAndPoint(worldPlanes[i].getNormal(), evalCoordf(worldPlanes[i].getPoint(), ROOT_DEPTH));
-            selector.frustum[i] = Coord4f(octPlane.getNormal(), octPlane.getDCoefficient());
+            selector->frustum[i] = Coord4f(octPlane.getNormal(), octPlane.getDCoefficient());
         }
 
         // Divide the threshold (which is in world distance units) by the dimension of the octree
         // as all further computations will be done in normalized octree units
         threshold *= getInvCellWidth(ROOT_DEPTH);
-        selector.setSize(threshold);
+        selector->setSize(threshold);
 
-        return Octree::select(selection, selector);
+        return std::move(selector);
     }
 }
 
 int ItemSpatialTree::selectCellItems(ItemSelection& selection, const ItemFilter& filter, const ViewFrustum& frustum, 
                                      float threshold) const {
     selectCells(selection.cellSelection, frustum, threshold);
+    collectItems(selection);
+    return (int) selection.numItems();
+}
+
+void ItemSpatialTree::selectCellItems(ItemSelections& selections, const ItemFilter& filter, const std::vector<ViewFrustum>& frustums,
+                                      const std::vector<float>& thresholds) const {
+    assert(frustums.size() == thresholds.size());
+    int numViews = (int)frustums.size();
+    selections.resize(numViews);
+
+    std::vector<std::unique_ptr<FrustumSelector>> viewSelectors;
+    std::vector<const FrustumSelector*> selectors;
+    std::vector<CellSelection> cellSelections(numViews);
+    for (int v = 0; v < numViews; v++) {
+        viewSelectors.push_back(evalSelector(frustums[v], thresholds[v]));
+        selectors.push_back(viewSelectors.back().get());
+        std::swap(cellSelections[v], selections[v].cellSelection);
+    }
+
+    Octree::select(cellSelections.data(), selectors.data(), numViews);
+
+    for (int v = 0; v < numViews; v++) {
+        std::swap(selections[v].cellSelection, cellSelections[v]);
+        collectItems(selections[v]);
+    }
+}
 
-    // Just grab the items in every selected bricks
+// Just grab the items in every selected bricks
+void ItemSpatialTree::collectItems(ItemSelection& selection) const {
     for (auto brickId : selection.cellSelection.insideBricks) {
         auto& brickItems = getConcreteBrick(brickId).items;
         selection.insideItems.insert(selection.insideItems.end(), brickItems.begin(), brickItems.end());
@@ -647,9 +696,4 @@ int ItemSpatialTree::selectCellItems(ItemSelection& selection, const ItemFilter&
         auto& brickSubcellItems = getConcreteBrick(brickId).subcellItems;
         selection.partialSubcellItems.insert(selection.partialSubcellItems.end(), brickSubcellItems.begin(), brickSubcellItems.end());
     }
-
-    return (int) selection.numItems();
 }
-
-
-
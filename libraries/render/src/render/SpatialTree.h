@@ -335,16 +335,23 @@ namespace render {
             float testThreshold(const Coord3f& point, float size) const override;
         };
 
-        int select(CellSelection& selection, const FrustumSelector& selector) const;
-        int selectTraverse(Index cellID, CellSelection& selection, const FrustumSelector& selector) const;
-        int selectBranch(Index cellID, CellSelection& selection, const FrustumSelector& selector) const;
         int selectCellBrick(Index cellID, CellSelection& selection, bool inside) const;
 
+        // Select the cells seen by several views in one traversal of the tree, one selection per selector.
+        // The views are traversed MAX_NUM_SELECT_VIEWS at a time and the branches of the root are traversed in parallel
+        // when the tree is big enough, the selections are the same as selecting each view on its own.
+        static const int MAX_NUM_SELECT_VIEWS = 8;
+        void select(CellSelection* selections, const FrustumSelector* const* selectors, int numViews) const;
+
 
         int getNumAllocatedCells() const { return (int)_cells.size(); }
         int getNumFreeCells() const { return (int)_freeCells.size(); }
             
     protected:
+        using ViewIntersections = std::array<Location::Intersection, MAX_NUM_SELECT_VIEWS>;
+        void selectTraverseViews(Index cellID, ViewIntersections intersections, CellSelection* selections,
+                                 const FrustumSelector* const* selectors, int numViews) const;
+
         Index allocateCell(Index parent, const Location& location);
         void freeCell(Index index);
 
@@ -447,6 +454,7 @@ namespace render {
         Index resetItem(Index oldCell, const ItemKey& oldKey, const AABox& bound, const ItemID& item, ItemKey& newKey);
 
         // Selection and traverse
+        std::unique_ptr<FrustumSelector> evalSelector(const ViewFrustum& frustum, float threshold) const;
         int selectCells(CellSelection& selection, const ViewFrustum& frustum, float threshold) const;
 
         class ItemSelection {
@@ -475,6 +483,15 @@ namespace render {
 
         int selectCellItems(ItemSelection& selection, const ItemFilter& filter, const ViewFrustum& frustum, 
                             float threshold) const;
+
+        // Select the items of several views (main view, secondary camera, mirrors...) in one traversal of the tree,
+        // selections are resized to the number of frustums and each gets the items of its frustum and threshold
+        using ItemSelections = std::vector<ItemSelection>;
+        void selectCellItems(ItemSelections& selections, const ItemFilter& filter, const std::vector<ViewFrustum>& frustums,
+                             const std::vector<float>& thresholds) const;
+
+    protected:
+        void collectItems(ItemSelection& selection) const;
     };
 }
 
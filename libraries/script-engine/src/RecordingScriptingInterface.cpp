@@ -220,7 +220,14 @@ void RecordingScriptingInterface::saveRecording(const QString& filename) {
         return;
     }
 
-    recording::Clip::toFile(filename, _lastClip);
+    auto writer = recording::Clip::toFile(filename, _lastClip, [filename](bool success) {
+        if (!success) {
+            qCWarning(scriptengine) << "Failed to save recording to" << filename;
+        }
+    });
+    if (!writer) {
+        qCWarning(scriptengine) << "Failed to save recording to" << filename << ", the recording is empty";
+    }
 }
 
 bool RecordingScriptingInterface::saveRecordingToAsset(QScriptValue getClipAtpUrl) {
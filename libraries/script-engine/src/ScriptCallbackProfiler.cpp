@@ -0,0 +1,148 @@
+//
+//  ScriptCallbackProfiler.cpp
+//  libraries/script-engine/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ScriptCallbackProfiler.h"
+
+#include <algorithm>
+#include <vector>
+
+#include <QtCore/QVariantList>
+
+const int ScriptCallbackProfiler::DEFAULT_MAX_ENTRIES = 20;
+
+// after the first overrun of a callback only every Nth one is reported, so a slow callback can't flood the log
+static const quint64 OVERRUN_WARNING_INTERVAL = 100;
+
+bool ScriptCallbackProfiler::record(const QUuid& entityID, const QUrl& script, const QString& callbackName, quint64 usecs) {
+    quint64 budget = _budgetUsecs;
+    bool overrun = budget > 0 && usecs > budget;
+    if (budget > 0) {
+        _frameUsecs[entityID] += usecs;
+    }
+
+    if (!_enabled && !overrun) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto& stats = _callbackStats[CallbackKey(entityID, callbackName)];
+    stats.script = script;
+    ++stats.calls;
+    stats.totalUsecs += usecs;
+    stats.maxUsecs = std::max(stats.maxUsecs, usecs);
+    if (overrun) {
+        ++stats.overruns;
+        return (stats.overruns % OVERRUN_WARNING_INTERVAL) == 1;
+    }
+    return false;
+}
+
+void ScriptCallbackProfiler::recordDeferral(const QUuid& entityID, const QUrl& script, const QString& callbackName) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto& stats = _callbackStats[CallbackKey(entityID, callbackName)];
+    stats.script = script;
+    ++stats.deferrals;
+}
+
+bool ScriptCallbackProfiler::isOverFrameBudget(const QUuid& entityID) const {
+    quint64 budget = _budgetUsecs;
+    if (budget == 0) {
+        return false;
+    }
+    return _frameUsecs.value(entityID, 0) > budget;
+}
+
+struct ProfileTotals {
+    QString name;
+    quint64 calls { 0 };
+    quint64 totalUsecs { 0 };
+    quint64 maxUsecs { 0 };
+    quint64 overruns { 0 };
+    quint64 deferrals { 0 };
+
+    void add(const ScriptCallbackProfiler::CallbackStats& stats) {
+        calls += stats.calls;
+        totalUsecs += stats.totalUsecs;
+        maxUsecs = std::max(maxUsecs, stats.maxUsecs);
+        overruns += stats.overruns;
+        deferrals += stats.deferrals;
+    }
+
+    QVariantMap toVariantMap(const QString& key) const {
+        QVariantMap map;
+        map[key] = name;
+        map["calls"] = calls;
+        map["total_usecs"] = totalUsecs;
+        map["average_usecs"] = calls > 0 ? totalUsecs / calls : 0;
+        map["max_usecs"] = maxUsecs;
+        map["overruns"] = overruns;
+        map["deferrals"] = deferrals;
+        return map;
+    }
+};
+
+static QVariantList topEntries(const QHash<QString, ProfileTotals>& totals, const QString& key, int maxEntries) {
+    std::vector<const ProfileTotals*> sorted;
+    sorted.reserve(totals.size());
+    for (const auto& entry : totals) {
+        sorted.push_back(&entry);
+    }
+    std::sort(sorted.begin(), sorted.end(), [](const ProfileTotals* a, const ProfileTotals* b) {
+        return a->totalUsecs > b->totalUsecs;
+    });
+
+    QVariantList list;
+    for (int i = 0; i < (int)sorted.size() && i < maxEntries; ++i) {
+        list << sorted[i]->toVariantMap(key);
+    }
+    return list;
+}
+
+QVariantMap ScriptCallbackProfiler::toVariantMap(int maxEntries) const {
+    QHash<QString, ProfileTotals> callbacks;
+    QHash<QString, ProfileTotals> entities;
+    QHash<QString, ProfileTotals> scripts;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (auto it = _callbackStats.cbegin(); it != _callbackStats.cend(); ++it) {
+            const auto& entityID = it.key().first;
+            QString scriptName = it.value().script.toString();
+            QString entityName = entityID.isNull() ? QString() : entityID.toString();
+            QString callbackName = (entityName.isEmpty() ? scriptName : entityName) + " " + it.key().second;
+
+            auto& callbackTotals = callbacks[callbackName];
+            callbackTotals.name = callbackName;
+            callbackTotals.add(it.value());
+
+            if (!entityName.isEmpty()) {
+                auto& entityTotals = entities[entityName];
+                entityTotals.name = entityName;
+                entityTotals.add(it.value());
+            }
+
+            auto& scriptTotals = scripts[scriptName];
+            scriptTotals.name = scriptName;
+            scriptTotals.add(it.value());
+        }
+    }
+
+    QVariantMap map;
+    map["enabled"] = (bool)_enabled;
+    map["budget_usecs"] = (quint64)_budgetUsecs;
+    map["callbacks"] = topEntries(callbacks, "callback", maxEntries);
+    map["entities"] = topEntries(entities, "entity", maxEntries);
+    map["scripts"] = topEntries(scripts, "script", maxEntries);
+    return map;
+}
+
+void ScriptCallbackProfiler::reset() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _callbackStats.clear();
+}
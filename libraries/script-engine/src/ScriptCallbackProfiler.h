@@ -0,0 +1,74 @@
+//
+//  ScriptCallbackProfiler.h
+//  libraries/script-engine/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ScriptCallbackProfiler_h
+#define hifi_ScriptCallbackProfiler_h
+
+#include <atomic>
+#include <mutex>
+
+#include <QtCore/QHash>
+#include <QtCore/QPair>
+#include <QtCore/QUrl>
+#include <QtCore/QUuid>
+#include <QtCore/QVariantMap>
+
+// Accounts the time a script engine spends in each script callback, keyed by the entity that defined it (null for
+// non-entity scripts) and the callback name, and enforces an optional per callback time budget.
+// Recording happens on the script thread, snapshots can be taken from any thread.
+class ScriptCallbackProfiler {
+public:
+    struct CallbackStats {
+        QUrl script;
+        quint64 calls { 0 };
+        quint64 totalUsecs { 0 };
+        quint64 maxUsecs { 0 };
+        quint64 overruns { 0 };
+        quint64 deferrals { 0 };
+    };
+
+    void setEnabled(bool enabled) { _enabled = enabled; }
+    bool isEnabled() const { return _enabled; }
+
+    // 0 disables the budget
+    void setBudgetUsecs(quint64 budgetUsecs) { _budgetUsecs = budgetUsecs; }
+    quint64 getBudgetUsecs() const { return _budgetUsecs; }
+
+    // callbacks only need to be timed when profiling or enforcing a budget
+    bool isActive() const { return _enabled || _budgetUsecs > 0; }
+
+    // Returns true if the callback overran the budget and a warning should be logged about it
+    bool record(const QUuid& entityID, const QUrl& script, const QString& callbackName, quint64 usecs);
+    void recordDeferral(const QUuid& entityID, const QUrl& script, const QString& callbackName);
+
+    // Called at the start of every script frame, the budget is also applied to all the callbacks of an entity in one frame
+    void startFrame() { _frameUsecs.clear(); }
+    bool isOverFrameBudget(const QUuid& entityID) const;
+
+    // The callbacks, entities and scripts that used the most time, most expensive first
+    QVariantMap toVariantMap(int maxEntries = DEFAULT_MAX_ENTRIES) const;
+    void reset();
+
+    static const int DEFAULT_MAX_ENTRIES;
+
+private:
+    using CallbackKey = QPair<QUuid, QString>;
+
+    mutable std::mutex _mutex;
+    QHash<CallbackKey, CallbackStats> _callbackStats;
+
+    // only used on the script thread
+    QHash<QUuid, quint64> _frameUsecs;
+
+    std::atomic<bool> _enabled { false };
+    std::atomic<quint64> _budgetUsecs { 0 };
+};
+
+#endif // hifi_ScriptCallbackProfiler_h
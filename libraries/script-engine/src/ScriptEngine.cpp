@@ -1101,6 +1101,7 @@ void ScriptEngine::run() {
     // TODO: Integrate this with signals/slots instead of reimplementing throttling for ScriptEngine
     while (!_isFinished) {
         auto beforeSleep = clock::now();
+        _callbackProfiler.startFrame();
 
         // Throttle to SCRIPT_FPS
         // We'd like to try to keep the script at a solid SCRIPT_FPS update rate. And so we will
@@ -1197,8 +1198,11 @@ void ScriptEngine::run() {
                     emit update(deltaTime);
                 }
                 auto postUpdate = clock::now();
-                auto elapsed = (postUpdate - preUpdate);
-                totalUpdates += std::chrono::duration_cast<std::chrono::microseconds>(elapsed);
+                auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(postUpdate - preUpdate);
+                totalUpdates += elapsed;
+                if (_callbackProfiler.isActive()) {
+                    recordCallback(EntityItemID(), QUrl(_fileNameString), "update", elapsed.count());
+                }
             }
         }
         _lastUpdate = now;
@@ -1318,6 +1322,10 @@ void ScriptEngine::updateMemoryCost(const qint64& deltaSize) {
 }
 
 void ScriptEngine::timerFired() {
+    fireTimer(reinterpret_cast<QTimer*>(sender()));
+}
+
+void ScriptEngine::fireTimer(QTimer* callingTimer) {
     {
         auto engine = DependencyManager::get<ScriptEngines>();
         if (!engine || engine->isStopped()) {
@@ -1326,9 +1334,26 @@ void ScriptEngine::timerFired() {
         }
     }
 
-    QTimer* callingTimer = reinterpret_cast<QTimer*>(sender());
     CallbackData timerData = _timerFunctionMap.value(callingTimer);
 
+    // an entity that has used up its callback budget this frame has its timers deferred to the next frame
+    if (timerData.function.isValid() && _callbackProfiler.isOverFrameBudget(timerData.definingEntityIdentifier)) {
+        _callbackProfiler.recordDeferral(timerData.definingEntityIdentifier, timerData.definingSandboxURL, "timer");
+        const int DEFERRED_TIMER_MSECS = (int)(MSECS_PER_SECOND / SCRIPT_FPS);
+        if (!callingTimer->isActive()) {
+            callingTimer->start(DEFERRED_TIMER_MSECS);
+        } else if (!_deferredIntervalTimers.contains(callingTimer)) {
+            // an interval keeps its schedule and the deferred tick runs late instead, ticks that are deferred again
+            // before it runs are coalesced into it.  The timer is the context, so stopping it cancels the tick.
+            _deferredIntervalTimers.insert(callingTimer);
+            QTimer::singleShot(DEFERRED_TIMER_MSECS, callingTimer, [this, callingTimer] {
+                _deferredIntervalTimers.remove(callingTimer);
+                fireTimer(callingTimer);
+            });
+        }
+        return;
+    }
+
     if (!callingTimer->isActive()) {
         // this timer is done, we can kill it
         _timerFunctionMap.remove(callingTimer);
@@ -1339,7 +1364,8 @@ void ScriptEngine::timerFired() {
     if (timerData.function.isValid()) {
         PROFILE_RANGE(script, __FUNCTION__);
         auto preTimer = p_high_resolution_clock::now();
-        callWithEnvironment(timerData.definingEntityIdentifier, timerData.definingSandboxURL, timerData.function, timerData.function, QScriptValueList());
+        callWithEnvironment(timerData.definingEntityIdentifier, timerData.definingSandboxURL, timerData.function, timerData.function, QScriptValueList(),
+                            "timer");
         auto postTimer = p_high_resolution_clock::now();
         auto elapsed = (postTimer - preTimer);
         _totalTimerExecution += std::chrono::duration_cast<std::chrono::microseconds>(elapsed);
@@ -1394,6 +1420,7 @@ void ScriptEngine::stopTimer(QTimer *timer) {
     if (_timerFunctionMap.contains(timer)) {
         timer->stop();
         _timerFunctionMap.remove(timer);
+        _deferredIntervalTimers.remove(timer);
         delete timer;
     } else {
         qCDebug(scriptengine) << "stopTimer -- not in _timerFunctionMap" << timer;
@@ -1873,7 +1900,7 @@ void ScriptEngine::include(const QStringList& includeFiles, QScriptValue callbac
                         evaluate(contents, url.toString());
                     };
 
-                    doWithEnvironment(capturedEntityIdentifier, capturedSandboxURL, operation);
+                    doWithEnvironment(capturedEntityIdentifier, capturedSandboxURL, operation, "include");
                     if (hasUncaughtException()) {
                         emit unhandledException(cloneUncaughtException("evaluateInclude"));
                         clearExceptions();
@@ -1886,7 +1913,8 @@ void ScriptEngine::include(const QStringList& includeFiles, QScriptValue callbac
         _parentURL = parentURL;
 
         if (callback.isFunction()) {
-            callWithEnvironment(capturedEntityIdentifier, capturedSandboxURL, QScriptValue(callback), QScriptValue(), QScriptValueList());
+            callWithEnvironment(capturedEntityIdentifier, capturedSandboxURL, QScriptValue(callback), QScriptValue(), QScriptValueList(),
+                                "includeCallback");
         }
 
         loader->deleteLater();
@@ -1967,7 +1995,8 @@ void ScriptEngine::forwardHandlerCall(const EntityItemID& entityID, const QStrin
             // and the entity scripts may be for entities other than the one this is a handler for.
             // Fortunately, the definingEntityIdentifier captured the entity script id (if any) when the handler was added.
             CallbackData& handler = handlersForEvent[i];
-            callWithEnvironment(handler.definingEntityIdentifier, handler.definingSandboxURL, handler.function, QScriptValue(), eventHandlerArgs);
+            callWithEnvironment(handler.definingEntityIdentifier, handler.definingSandboxURL, handler.function, QScriptValue(), eventHandlerArgs,
+                                eventName);
         }
     }
 }
@@ -2311,7 +2340,7 @@ void ScriptEngine::entityScriptContentAvailable(const EntityItemID& entityID, co
         }
     };
 
-    doWithEnvironment(entityID, sandboxURL, initialization);
+    doWithEnvironment(entityID, sandboxURL, initialization, "construct");
 
     if (entityScriptObject.isError()) {
         auto exception = entityScriptObject;
@@ -2461,12 +2490,22 @@ void ScriptEngine::refreshFileScript(const EntityItemID& entityID) {
 // Even if entityID is supplied as currentEntityIdentifier, this still documents the source
 // of the code being executed (e.g., if we ever sandbox different entity scripts, or provide different
 // global values for different entity scripts).
-void ScriptEngine::doWithEnvironment(const EntityItemID& entityID, const QUrl& sandboxURL, std::function<void()> operation) {
+// When callbackName is given and profiling or a callback budget is enabled, the operation is timed and accounted to
+// the entity and callback.  Nested callbacks are accounted to the outermost one.
+void ScriptEngine::doWithEnvironment(const EntityItemID& entityID, const QUrl& sandboxURL, std::function<void()> operation,
+                                     const QString& callbackName) {
     EntityItemID oldIdentifier = currentEntityIdentifier;
     QUrl oldSandboxURL = currentSandboxURL;
     currentEntityIdentifier = entityID;
     currentSandboxURL = sandboxURL;
 
+    bool profileCallback = !callbackName.isEmpty() && !_isProfilingCallback && _callbackProfiler.isActive();
+    p_high_resolution_clock::time_point preCallback;
+    if (profileCallback) {
+        _isProfilingCallback = true;
+        preCallback = p_high_resolution_clock::now();
+    }
+
 #if DEBUG_CURRENT_ENTITY
     QScriptValue oldData = this->globalObject().property("debugEntityID");
     this->globalObject().setProperty("debugEntityID", entityID.toScriptValue(this)); // Make the entityID available to javascript as a global.
@@ -2475,16 +2514,32 @@ void ScriptEngine::doWithEnvironment(const EntityItemID& entityID, const QUrl& s
 #else
     operation();
 #endif
+
+    if (profileCallback) {
+        _isProfilingCallback = false;
+        auto elapsed = p_high_resolution_clock::now() - preCallback;
+        recordCallback(entityID, sandboxURL, callbackName, std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+    }
+
     maybeEmitUncaughtException(!entityID.isNull() ? entityID.toString() : __FUNCTION__);
     currentEntityIdentifier = oldIdentifier;
     currentSandboxURL = oldSandboxURL;
 }
 
-void ScriptEngine::callWithEnvironment(const EntityItemID& entityID, const QUrl& sandboxURL, QScriptValue function, QScriptValue thisObject, QScriptValueList args) {
+void ScriptEngine::callWithEnvironment(const EntityItemID& entityID, const QUrl& sandboxURL, QScriptValue function, QScriptValue thisObject, QScriptValueList args,
+                                       const QString& callbackName) {
     auto operation = [&]() {
         function.call(thisObject, args);
     };
-    doWithEnvironment(entityID, sandboxURL, operation);
+    doWithEnvironment(entityID, sandboxURL, operation, callbackName);
+}
+
+void ScriptEngine::recordCallback(const EntityItemID& entityID, const QUrl& sandboxURL, const QString& callbackName, quint64 usecs) {
+    if (_callbackProfiler.record(entityID, sandboxURL, callbackName, usecs)) {
+        QString source = entityID.isNull() ? getFilename() : entityID.toString();
+        scriptWarningMessage(QString("%1 callback '%2' took %3 usecs, over the callback budget of %4 usecs")
+            .arg(source).arg(callbackName).arg(usecs).arg(_callbackProfiler.getBudgetUsecs()));
+    }
 }
 
 void ScriptEngine::callEntityScriptMethod(const EntityItemID& entityID, const QString& methodName, const QStringList& params, const QUuid& remoteCallerID) {
@@ -2548,7 +2603,7 @@ void ScriptEngine::callEntityScriptMethod(const EntityItemID& entityID, const QS
 
             QScriptValue oldData = this->globalObject().property("Script").property("remoteCallerID");
             this->globalObject().property("Script").setProperty("remoteCallerID", remoteCallerID.toString()); // Make the remoteCallerID available to javascript as a global.
-            callWithEnvironment(entityID, details.definingSandboxURL, entityScript.property(methodName), entityScript, args);
+            callWithEnvironment(entityID, details.definingSandboxURL, entityScript.property(methodName), entityScript, args, methodName);
             this->globalObject().property("Script").setProperty("remoteCallerID", oldData);
         }
     }
@@ -2586,7 +2641,7 @@ void ScriptEngine::callEntityScriptMethod(const EntityItemID& entityID, const QS
             QScriptValueList args;
             args << entityID.toScriptValue(this);
             args << event.toScriptValue(this);
-            callWithEnvironment(entityID, details.definingSandboxURL, entityScript.property(methodName), entityScript, args);
+            callWithEnvironment(entityID, details.definingSandboxURL, entityScript.property(methodName), entityScript, args, methodName);
         }
     }
 }
@@ -2625,7 +2680,7 @@ void ScriptEngine::callEntityScriptMethod(const EntityItemID& entityID, const QS
             args << entityID.toScriptValue(this);
             args << otherID.toScriptValue(this);
             args << collisionToScriptValue(this, collision);
-            callWithEnvironment(entityID, details.definingSandboxURL, entityScript.property(methodName), entityScript, args);
+            callWithEnvironment(entityID, details.definingSandboxURL, entityScript.property(methodName), entityScript, args, methodName);
         }
     }
 }
@@ -40,6 +40,7 @@
 #include "Quat.h"
 #include "Mat4.h"
 #include "ScriptCache.h"
+#include "ScriptCallbackProfiler.h"
 #include "ScriptUUID.h"
 #include "Vec3.h"
 #include "ConsoleScriptingInterface.h"
@@ -452,6 +453,28 @@ public:
      */
     Q_INVOKABLE void endProfileRange(const QString& label) const;
 
+    /**jsdoc
+     * Enable or disable timing of the callbacks (timers, event handlers, entity methods, updates) run by this script
+     * engine.
+     * @function Script.setCallbackProfilingEnabled
+     * @param {boolean} enabled
+     */
+    Q_INVOKABLE void setCallbackProfilingEnabled(bool enabled) { _callbackProfiler.setEnabled(enabled); }
+
+    /**jsdoc
+     * Get the callbacks, entities and scripts that used the most time in this script engine, most expensive first.
+     * @function Script.getCallbackProfile
+     * @returns {object}
+     */
+    Q_INVOKABLE QVariantMap getCallbackProfile() const { return _callbackProfiler.toVariantMap(); }
+
+    /**jsdoc
+     * @function Script.resetCallbackProfile
+     */
+    Q_INVOKABLE void resetCallbackProfile() { _callbackProfiler.reset(); }
+
+    ScriptCallbackProfiler& getCallbackProfiler() { return _callbackProfiler; }
+
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     // Entity Script Related methods
 
@@ -741,6 +764,7 @@ protected:
 
     QString logException(const QScriptValue& exception);
     void timerFired();
+    void fireTimer(QTimer* callingTimer);
     void stopAllTimers();
     void stopAllTimersForEntityScript(const EntityItemID& entityID);
     void refreshFileScript(const EntityItemID& entityID);
@@ -767,8 +791,11 @@ protected:
 
     EntityItemID currentEntityIdentifier; // Contains the defining entity script entity id during execution, if any. Empty for interface script execution.
     QUrl currentSandboxURL; // The toplevel url string for the entity script that loaded the code being executed, else empty.
-    void doWithEnvironment(const EntityItemID& entityID, const QUrl& sandboxURL, std::function<void()> operation);
-    void callWithEnvironment(const EntityItemID& entityID, const QUrl& sandboxURL, QScriptValue function, QScriptValue thisObject, QScriptValueList args);
+    void doWithEnvironment(const EntityItemID& entityID, const QUrl& sandboxURL, std::function<void()> operation,
+                           const QString& callbackName = QString());
+    void callWithEnvironment(const EntityItemID& entityID, const QUrl& sandboxURL, QScriptValue function, QScriptValue thisObject, QScriptValueList args,
+                             const QString& callbackName = QString());
+    void recordCallback(const EntityItemID& entityID, const QUrl& sandboxURL, const QString& callbackName, quint64 usecs);
 
     Context _context;
     Type _type;
@@ -779,6 +806,8 @@ protected:
     std::atomic<bool> _isStopping { false };
     bool _isInitialized { false };
     QHash<QTimer*, CallbackData> _timerFunctionMap;
+    // intervals with a tick deferred by the callback budget that has not run yet
+    QSet<QTimer*> _deferredIntervalTimers;
     QSet<QUrl> _includedURLs;
     mutable QReadWriteLock _entityScriptsLock { QReadWriteLock::Recursive };
     QHash<EntityItemID, EntityScriptDetails> _entityScripts;
@@ -810,6 +839,9 @@ protected:
 
     std::chrono::microseconds _totalTimerExecution { 0 };
 
+    ScriptCallbackProfiler _callbackProfiler;
+    bool _isProfilingCallback { false };
+
     static const QString _SETTINGS_ENABLE_EXTENDED_MODULE_COMPAT;
     static const QString _SETTINGS_ENABLE_EXTENDED_EXCEPTIONS;
 
@@ -17,6 +17,11 @@
 
 #include "NumericalConstants.h"
 
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#include <emmintrin.h>
+#define GLM_HELPERS_SSE
+#endif
+
 const vec3 Vectors::UNIT_X{ 1.0f, 0.0f, 0.0f };
 const vec3 Vectors::UNIT_Y{ 0.0f, 1.0f, 0.0f };
 const vec3 Vectors::UNIT_Z{ 0.0f, 0.0f, 1.0f };
@@ -110,6 +115,34 @@ int unpackFloatVec3FromSignedTwoByteFixed(const unsigned char* sourceBuffer, glm
     return sourceBuffer - startPosition;
 }
 
+int unpackFloatVec3sFromSignedTwoByteFixed(const unsigned char* sourceBuffer, glm::vec3* destination, int numVectors, int radix) {
+    static_assert(sizeof(glm::vec3) == 3 * sizeof(float), "vec3 arrays must be tightly packed");
+    if (numVectors <= 0) {
+        return 0;
+    }
+    float* values = &destination[0].x;
+    const int numValues = 3 * numVectors;
+    int i = 0;
+
+#ifdef GLM_HELPERS_SSE
+    // dividing by a power of two is the same as multiplying by its inverse
+    const __m128 scale = _mm_set1_ps(1.0f / (float)(1 << radix));
+    for (; i + 8 <= numValues; i += 8) {
+        __m128i fixedValues = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sourceBuffer + i * sizeof(int16_t)));
+        // sign extend the 16 bit values to 32 bits
+        __m128i low = _mm_srai_epi32(_mm_unpacklo_epi16(fixedValues, fixedValues), 16);
+        __m128i high = _mm_srai_epi32(_mm_unpackhi_epi16(fixedValues, fixedValues), 16);
+        _mm_storeu_ps(values + i, _mm_mul_ps(_mm_cvtepi32_ps(low), scale));
+        _mm_storeu_ps(values + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(high), scale));
+    }
+#endif
+
+    for (; i < numValues; i++) {
+        unpackFloatScalarFromSignedTwoByteFixed((const int16_t*)(sourceBuffer + i * sizeof(int16_t)), values + i, radix);
+    }
+    return numValues * sizeof(int16_t);
+}
+
 int packFloatAngleToTwoByte(unsigned char* buffer, float degrees) {
     const float ANGLE_CONVERSION_RATIO = (std::numeric_limits<uint16_t>::max() / 360.0f);
 
@@ -231,6 +264,61 @@ int unpackOrientationQuatFromSixBytes(const unsigned char* buffer, glm::quat& qu
     return 6;
 }
 
+int unpackOrientationQuatsFromSixBytes(const unsigned char* buffer, glm::quat* quatsOutput, int numQuats) {
+    const int BYTES_PER_QUAT = 6;
+    int i = 0;
+
+#ifdef GLM_HELPERS_SSE
+    // same arithmetic as unpackOrientationQuatFromSixBytes, four quats at a time
+    const uint32_t NUM_BITS_PER_COMPONENT = 15;
+    const __m128 RANGE = _mm_set1_ps((float)((1 << NUM_BITS_PER_COMPONENT) - 1));
+    const __m128 MAGNITUDE = _mm_set1_ps(1.0f / sqrtf(2.0f));
+    const __m128 TWO_MAGNITUDE = _mm_set1_ps(2.0f * (1.0f / sqrtf(2.0f)));
+    const __m128 ONE = _mm_set1_ps(1.0f);
+    const __m128 SIGN = _mm_set1_ps(-0.0f);
+
+    for (; i + 4 <= numQuats; i += 4) {
+        alignas(16) int32_t components[3][4];
+        uint8_t largestComponents[4];
+        for (int j = 0; j < 4; j++) {
+            const unsigned char* quatBuffer = buffer + (i + j) * BYTES_PER_QUAT;
+            components[0][j] = ((0x7f & quatBuffer[0]) << 8) | quatBuffer[1];
+            components[1][j] = ((0x7f & quatBuffer[2]) << 8) | quatBuffer[3];
+            components[2][j] = ((0x7f & quatBuffer[4]) << 8) | quatBuffer[5];
+            largestComponents[j] = ((0x80 & quatBuffer[2]) >> 6) | ((0x80 & quatBuffer[0]) >> 7);
+        }
+
+        alignas(16) float floatComponents[4][4];
+        __m128 squaredLength = ONE;
+        for (int k = 0; k < 3; k++) {
+            __m128 value = _mm_cvtepi32_ps(_mm_load_si128(reinterpret_cast<const __m128i*>(components[k])));
+            value = _mm_sub_ps(_mm_mul_ps(_mm_div_ps(value, RANGE), TWO_MAGNITUDE), MAGNITUDE);
+            squaredLength = _mm_sub_ps(squaredLength, _mm_mul_ps(value, value));
+            _mm_store_ps(floatComponents[k], value);
+        }
+        // missingComponent is always negative.
+        _mm_store_ps(floatComponents[3], _mm_xor_ps(_mm_sqrt_ps(squaredLength), SIGN));
+
+        for (int j = 0; j < 4; j++) {
+            glm::quat& quatOutput = quatsOutput[i + j];
+            for (int c = 0, k = 0; c < 4; c++) {
+                if (c != largestComponents[j]) {
+                    quatOutput[c] = floatComponents[k][j];
+                    k++;
+                } else {
+                    quatOutput[c] = floatComponents[3][j];
+                }
+            }
+        }
+    }
+#endif
+
+    for (; i < numQuats; i++) {
+        unpackOrientationQuatFromSixBytes(buffer + i * BYTES_PER_QUAT, quatsOutput[i]);
+    }
+    return numQuats * BYTES_PER_QUAT;
+}
+
 bool closeEnough(float a, float b, float relativeError) {
     assert(relativeError >= 0.0f);
     // NOTE: we add EPSILON to the denominator so we can avoid checking for division by zero.
@@ -115,6 +115,8 @@ int unpackOrientationQuatFromBytes(const unsigned char* buffer, glm::quat& quatO
 // error of +- 4.3e-5 error per compoenent.
 int packOrientationQuatToSixBytes(unsigned char* buffer, const glm::quat& quatInput);
 int unpackOrientationQuatFromSixBytes(const unsigned char* buffer, glm::quat& quatOutput);
+// unpacks consecutive six byte quats, several at a time where SSE is available, and returns the number of bytes read
+int unpackOrientationQuatsFromSixBytes(const unsigned char* buffer, glm::quat* quatsOutput, int numQuats);
 
 // Ratios need the be highly accurate when less than 10, but not very accurate above 10, and they
 // are never greater than 1000 to 1, this allows us to encode each component in 16bits
@@ -137,6 +139,8 @@ int unpackFloatScalarFromSignedTwoByteFixed(const int16_t* byteFixedPointer, flo
 // A convenience for sending vec3's as fixed-point floats
 int packFloatVec3ToSignedTwoByteFixed(unsigned char* destBuffer, const glm::vec3& srcVector, int radix);
 int unpackFloatVec3FromSignedTwoByteFixed(const unsigned char* sourceBuffer, glm::vec3& destination, int radix);
+// unpacks consecutive fixed-point vec3's, several at a time where SSE is available, and returns the number of bytes read
+int unpackFloatVec3sFromSignedTwoByteFixed(const unsigned char* sourceBuffer, glm::vec3* destination, int numVectors, int radix);
 
 bool closeEnough(float a, float b, float relativeError);
 
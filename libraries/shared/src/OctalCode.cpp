@@ -65,8 +65,10 @@ size_t bytesRequiredForCodeLength(unsigned char threeBitCodes) {
 }
 
 int branchIndexWithDescendant(const unsigned char* ancestorOctalCode, const unsigned char* descendantOctalCode) {
-    int parentSections = numberOfThreeBitSectionsInCode(ancestorOctalCode);
+    return branchIndexWithDescendant(numberOfThreeBitSectionsInCode(ancestorOctalCode), descendantOctalCode);
+}
 
+int branchIndexWithDescendant(int parentSections, const unsigned char* descendantOctalCode) {
     int branchStartBit = parentSections * 3;
     // Note: this does not appear to be "multi-byte length code" safe. When octal codes are larger than 255 bytes
     // long, the length code is stored in two bytes. The "1" below appears to assume that the length is always one
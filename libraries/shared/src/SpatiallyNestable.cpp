@@ -11,7 +11,11 @@
 
 #include "SpatiallyNestable.h"
 
+#include <algorithm>
+#include <future>
 #include <queue>
+#include <thread>
+#include <unordered_set>
 
 #include "DependencyManager.h"
 #include "SharedUtil.h"
@@ -36,6 +40,7 @@ SpatiallyNestable::SpatiallyNestable(NestableType nestableType, QUuid id) :
 
 SpatiallyNestable::~SpatiallyNestable() {
     forEachChild([&](SpatiallyNestablePointer object) {
+        object->invalidateWorldTransform();
         object->parentDeleted();
     });
 }
@@ -67,12 +72,17 @@ const QUuid SpatiallyNestable::getParentID() const {
 }
 
 void SpatiallyNestable::setParentID(const QUuid& parentID) {
+    bool changed = false;
     _idLock.withWriteLock([&] {
         if (_parentID != parentID) {
             _parentID = parentID;
             _parentKnowsMe = false;
+            changed = true;
         }
     });
+    if (changed) {
+        worldTransformChanged();
+    }
 
     if (!_parentKnowsMe) {
         bool success = false;
@@ -171,7 +181,10 @@ void SpatiallyNestable::forgetChild(SpatiallyNestablePointer newChild) const {
 }
 
 void SpatiallyNestable::setParentJointIndex(quint16 parentJointIndex) {
-    _parentJointIndex = parentJointIndex;
+    if (_parentJointIndex != parentJointIndex) {
+        _parentJointIndex = parentJointIndex;
+        worldTransformChanged();
+    }
     auto parent = _parent.lock();
     if (parent) {
         parent->recalculateChildCauterization();
@@ -502,6 +515,7 @@ void SpatiallyNestable::setWorldTransform(const glm::vec3& position, const glm::
             }
         });
         if (changed) {
+            worldTransformChanged();
             locationChanged(false);
         }
     }
@@ -545,6 +559,9 @@ void SpatiallyNestable::setWorldPosition(const glm::vec3& position, bool& succes
             _translationChanged = usecTimestampNow();
         }
     });
+    if (changed) {
+        worldTransformChanged();
+    }
     if (success && changed) {
         locationChanged(tellPhysics);
     }
@@ -598,6 +615,9 @@ void SpatiallyNestable::setWorldOrientation(const glm::quat& orientation, bool&
             _rotationChanged = usecTimestampNow();
         }
     });
+    if (changed) {
+        worldTransformChanged();
+    }
     if (success && changed) {
         locationChanged(tellPhysics);
     }
@@ -733,14 +753,133 @@ glm::vec3 SpatiallyNestable::getParentAngularVelocity(bool& success) const {
 
 const Transform SpatiallyNestable::getTransform(bool& success, int depth) const {
     Transform result;
+    if (getCachedWorldTransform(result)) {
+        success = true;
+        return result;
+    }
+
+    // read before computing, so that a change made meanwhile leaves the cache invalid
+    uint32_t generation = _worldTransformGeneration;
+
     // return a world-space transform for this object's location
     Transform parentTransform = getParentTransform(success, depth);
     _transformLock.withReadLock([&] {
         Transform::mult(result, parentTransform, _transform);
     });
+    if (success && canCacheWorldTransform()) {
+        setCachedWorldTransform(result, generation);
+    }
     return result;
 }
 
+void SpatiallyNestable::worldTransformChanged() {
+    invalidateWorldTransform();
+    queueWorldTransformUpdate();
+}
+
+void SpatiallyNestable::invalidateWorldTransform() const {
+    _worldTransformGeneration++;
+    forEachChild([&](const SpatiallyNestablePointer& child) {
+        child->invalidateWorldTransform();
+    });
+}
+
+bool SpatiallyNestable::canCacheWorldTransform() const {
+    // joints and the scale of a parent can change without telling the children, so only plain entity hierarchies are cached
+    if (_nestableType != NestableType::Entity || _parentJointIndex != INVALID_JOINT_INDEX || getScalesWithParent()) {
+        return false;
+    }
+    if (getParentID().isNull()) {
+        return true;
+    }
+
+    // a change above us only invalidates our cache if it can reach us through our parent's cache
+    SpatiallyNestablePointer parent = _parent.lock();
+    Transform parentTransform;
+    return parent && _parentKnowsMe && parent->getCachedWorldTransform(parentTransform);
+}
+
+bool SpatiallyNestable::getCachedWorldTransform(Transform& result) const {
+    uint32_t version = _worldTransformCacheVersion.load(std::memory_order_acquire);
+    if (version & 1) {
+        return false;
+    }
+
+    Transform cachedTransform = _worldTransformCache;
+    uint32_t cachedGeneration = _worldTransformCacheGeneration;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (_worldTransformCacheVersion.load(std::memory_order_relaxed) != version ||
+        cachedGeneration != _worldTransformGeneration.load()) {
+        return false;
+    }
+
+    result = cachedTransform;
+    return true;
+}
+
+void SpatiallyNestable::setCachedWorldTransform(const Transform& transform, uint32_t generation) const {
+    uint32_t version = _worldTransformCacheVersion.load();
+    // if another thread is writing the cache let it win
+    if ((version & 1) || !_worldTransformCacheVersion.compare_exchange_strong(version, version + 1)) {
+        return;
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+
+    _worldTransformCache = transform;
+    _worldTransformCacheGeneration = generation;
+
+    _worldTransformCacheVersion.store(version + 2, std::memory_order_release);
+}
+
+void SpatiallyNestable::updateWorldTransforms(const std::vector<SpatiallyNestablePointer>& objects) {
+    // levels smaller than this are updated on the calling thread
+    const size_t MIN_OBJECTS_PER_THREAD = 256;
+    const size_t MAX_THREADS = std::max(1u, std::thread::hardware_concurrency());
+
+    auto updateObjects = [](const SpatiallyNestablePointer* begin, const SpatiallyNestablePointer* end,
+                            std::vector<SpatiallyNestablePointer>& children) {
+        for (auto object = begin; object != end; ++object) {
+            bool success;
+            (*object)->getTransform(success);
+            for (auto& child : (*object)->getChildren()) {
+                children.push_back(child);
+            }
+        }
+    };
+
+    // the same object may be queued several times in a frame
+    std::vector<SpatiallyNestablePointer> level;
+    std::unordered_set<SpatiallyNestable*> queued;
+    for (auto& object : objects) {
+        if (object && queued.insert(object.get()).second) {
+            level.push_back(object);
+        }
+    }
+
+    for (int depth = 0; !level.empty() && depth <= MAX_PARENTING_CHAIN_SIZE; depth++) {
+        size_t numThreads = std::max((size_t)1, std::min(MAX_THREADS, level.size() / MIN_OBJECTS_PER_THREAD));
+        size_t objectsPerThread = (level.size() + numThreads - 1) / numThreads;
+        std::vector<std::vector<SpatiallyNestablePointer>> children(numThreads);
+
+        std::vector<std::future<void>> futures;
+        for (size_t i = 1; i < numThreads; i++) {
+            size_t begin = std::min(level.size(), i * objectsPerThread);
+            size_t end = std::min(level.size(), begin + objectsPerThread);
+            futures.push_back(std::async(std::launch::async, updateObjects,
+                                         level.data() + begin, level.data() + end, std::ref(children[i])));
+        }
+        updateObjects(level.data(), level.data() + std::min(level.size(), objectsPerThread), children[0]);
+        for (auto& future : futures) {
+            future.wait();
+        }
+
+        level.clear();
+        for (auto& threadChildren : children) {
+            level.insert(level.end(), threadChildren.begin(), threadChildren.end());
+        }
+    }
+}
+
 const Transform SpatiallyNestable::getTransform() const {
     bool success;
     Transform result = getTransform(success);
@@ -803,6 +942,7 @@ void SpatiallyNestable::setTransform(const Transform& transform, bool& success)
             }
         });
         if (changed) {
+            worldTransformChanged();
             locationChanged();
         }
     }
@@ -857,6 +997,9 @@ void SpatiallyNestable::setSNScale(const glm::vec3& scale, bool& success) {
             _scaleChanged = usecTimestampNow();
         }
     });
+    if (changed) {
+        worldTransformChanged();
+    }
     if (success && changed) {
         locationChanged();
     }
@@ -889,6 +1032,7 @@ void SpatiallyNestable::setLocalTransform(const Transform& transform) {
     });
 
     if (changed) {
+        worldTransformChanged();
         locationChanged();
     }
 }
@@ -916,6 +1060,7 @@ void SpatiallyNestable::setLocalPosition(const glm::vec3& position, bool tellPhy
         }
     });
     if (changed) {
+        worldTransformChanged();
         locationChanged(tellPhysics);
     }
 }
@@ -943,6 +1088,7 @@ void SpatiallyNestable::setLocalOrientation(const glm::quat& orientation) {
         }
     });
     if (changed) {
+        worldTransformChanged();
         locationChanged();
     }
 }
@@ -999,6 +1145,7 @@ void SpatiallyNestable::setLocalSNScale(const glm::vec3& scale) {
         }
     });
     if (changed) {
+        worldTransformChanged();
         dimensionsChanged();
     }
 }
@@ -1313,6 +1460,7 @@ void SpatiallyNestable::setLocalTransformAndVelocities(
     });
 
     if (changed) {
+        worldTransformChanged();
         locationChanged(false);
     }
 }
@@ -12,6 +12,9 @@
 #ifndef hifi_SpatiallyNestable_h
 #define hifi_SpatiallyNestable_h
 
+#include <atomic>
+#include <vector>
+
 #include <QUuid>
 
 #include "Transform.h"
@@ -87,6 +90,10 @@ public:
 
     virtual Transform getParentTransform(bool& success, int depth = 0) const;
 
+    // Refreshes the cached world transforms of these objects and of all their descendants, parents before children.
+    // Each level of the hierarchy is split over a few threads when it is large enough.
+    static void updateWorldTransforms(const std::vector<SpatiallyNestablePointer>& objects);
+
     void setWorldTransform(const glm::vec3& position, const glm::quat& orientation);
     virtual glm::vec3 getWorldPosition(bool& success) const;
     virtual glm::vec3 getWorldPosition() const;
@@ -227,6 +234,10 @@ protected:
     virtual void forgetChild(SpatiallyNestablePointer newChild) const;
     virtual void recalculateChildCauterization() const { }
 
+    // called when the world transform of this object (and so of its descendants) changed because of its own
+    // local transform or parenting, so the cached world transforms can be refreshed with updateWorldTransforms
+    virtual void queueWorldTransformUpdate() { }
+
     mutable ReadWriteLockable _childrenLock;
     mutable QHash<QUuid, SpatiallyNestableWeakPointer> _children;
 
@@ -258,6 +269,21 @@ private:
     bool _isDead { false };
     bool _queryAACubeIsPuffed { false };
 
+    // The world transform of an entity that isn't attached to a joint is cached.  The cache is valid while its
+    // generation matches _worldTransformGeneration, which is bumped on an object and all its descendants whenever
+    // its local transform or parenting changes.  The cache is written under a sequence lock, _worldTransformCacheVersion
+    // is odd while it is being written, so that it can be read without taking any lock.
+    mutable std::atomic<uint32_t> _worldTransformGeneration { 1 };
+    mutable std::atomic<uint32_t> _worldTransformCacheVersion { 0 };
+    mutable Transform _worldTransformCache;
+    mutable uint32_t _worldTransformCacheGeneration { 0 };
+
+    void worldTransformChanged();
+    void invalidateWorldTransform() const;
+    bool canCacheWorldTransform() const;
+    bool getCachedWorldTransform(Transform& result) const;
+    void setCachedWorldTransform(const Transform& transform, uint32_t generation) const;
+
     void breakParentingLoop() const;
 };
 
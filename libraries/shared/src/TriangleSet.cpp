@@ -11,9 +11,36 @@
 
 #include "TriangleSet.h"
 
+#include <algorithm>
+#include <future>
+
 #include "GLMHelpers.h"
 
-#include <list>
+//
+// on x86 architecture, assume that SSE2 is present
+//
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#define TRIANGLE_SET_SSE
+#include <xmmintrin.h>
+#endif
+
+static const uint32_t INVALID_TRIANGLE = (uint32_t)-1;
+
+// leaves with up to this many triangles are kept when the surface area heuristic says splitting them doesn't pay off
+static const uint32_t MAX_LEAF_TRIANGLES = 8;
+static const uint32_t MIN_SPLIT_TRIANGLES = 3;
+static const int SAH_BINS = 16;
+// cost of visiting a node relative to testing a triangle
+static const float SAH_TRAVERSAL_COST = 1.0f;
+// past this depth nodes are split at the median, which bounds the depth of the hierarchy for degenerate meshes
+static const int MAX_SAH_DEPTH = 40;
+
+// large subtrees are built on their own thread, this gives at most 2 ^ MAX_PARALLEL_BUILD_DEPTH build threads
+static const uint32_t PARALLEL_BUILD_MIN_TRIANGLES = 16384;
+static const int MAX_PARALLEL_BUILD_DEPTH = 3;
+
+// traversal stack kept on the stack, deeper hierarchies allocate theirs
+static const int MAX_TRAVERSAL_STACK = 256;
 
 void TriangleSet::insert(const Triangle& t) {
     _isBalanced = false;
@@ -29,7 +56,9 @@ void TriangleSet::clear() {
     _bounds.clear();
     _isBalanced = false;
 
-    _triangleTree.clear();
+    _nodes.clear();
+    _packets.clear();
+    _depth = 0;
 }
 
 bool TriangleSet::convexHullContains(const glm::vec3& point) const {
@@ -52,424 +81,648 @@ bool TriangleSet::convexHullContains(const glm::vec3& point) const {
 void TriangleSet::debugDump() {
     qDebug() << __FUNCTION__;
     qDebug() << "bounds:" << getBounds();
-    qDebug() << "triangles:" << size() << "at top level....";
-    qDebug() << "----- _triangleTree -----";
-    _triangleTree.debugDump();
+    qDebug() << "triangles:" << size() << "nodes:" << _nodes.size() << "triangle packets:" << _packets.size();
 }
 
-void TriangleSet::balanceTree() {
-    _triangleTree.reset(_bounds);
+namespace {
 
-    // insert all the triangles
-    for (size_t i = 0; i < _triangles.size(); i++) {
-        _triangleTree.insert(i);
-    }
+struct BuildBounds {
+    glm::vec3 min { FLT_MAX };
+    glm::vec3 max { -FLT_MAX };
 
-    _isBalanced = true;
+    void add(const glm::vec3& point) {
+        min = glm::min(min, point);
+        max = glm::max(max, point);
+    }
+    void add(const BuildBounds& other) {
+        min = glm::min(min, other.min);
+        max = glm::max(max, other.max);
+    }
+    float getArea() const {
+        glm::vec3 dimensions = max - min;
+        if (dimensions.x < 0.0f) {
+            return 0.0f;
+        }
+        return 2.0f * (dimensions.x * dimensions.y + dimensions.y * dimensions.z + dimensions.z * dimensions.x);
+    }
+};
+
+struct BuildNode {
+    BuildBounds bounds;
+    int32_t left { -1 }; // -1 for leaves
+    int32_t right { -1 };
+    uint32_t first { 0 }; // range of a leaf in the triangle order
+    uint32_t count { 0 };
+};
+
+// Builds a binary hierarchy with the binned surface area heuristic, reordering the triangle indices so that
+// the triangles of each leaf are contiguous
+class BuildTree {
+public:
+    BuildTree(const std::vector<Triangle>& triangles) {
+        _triangleBounds.resize(triangles.size());
+        _centroids.resize(triangles.size());
+        order.resize(triangles.size());
+        for (size_t i = 0; i < triangles.size(); i++) {
+            auto& bounds = _triangleBounds[i];
+            bounds.add(triangles[i].v0);
+            bounds.add(triangles[i].v1);
+            bounds.add(triangles[i].v2);
+            _centroids[i] = 0.5f * (bounds.min + bounds.max);
+            order[i] = (uint32_t)i;
+        }
+    }
 
-#if WANT_DEBUGGING
-    debugDump();
-#endif
-}
+    void build() {
+        nodes.clear();
+        buildNode(nodes, 0, (uint32_t)order.size(), 0);
+    }
 
-// With an octree: 8 ^ MAX_DEPTH = 4096 leaves
-//static const int MAX_DEPTH = 4;
-// With a k-d tree: 2 ^ MAX_DEPTH = 4096 leaves
-static const int MAX_DEPTH = 12;
+    std::vector<BuildNode> nodes; // the root is the first node
+    std::vector<uint32_t> order;
 
-TriangleSet::TriangleTreeCell::TriangleTreeCell(std::vector<Triangle>& allTriangles, const AABox& bounds, int depth) :
-    _allTriangles(allTriangles)
-{
-    reset(bounds, depth);
-}
+private:
+    int32_t buildNode(std::vector<BuildNode>& target, uint32_t begin, uint32_t end, int depth);
 
-void TriangleSet::TriangleTreeCell::clear() {
-    _population = 0;
-    _triangleIndices.clear();
-    _bounds.clear();
-    _children.first.reset();
-    _children.second.reset();
-}
+    std::vector<BuildBounds> _triangleBounds;
+    std::vector<glm::vec3> _centroids;
+};
 
-void TriangleSet::TriangleTreeCell::reset(const AABox& bounds, int depth) {
-    clear();
-    _bounds = bounds;
-    _depth = depth;
+static int32_t appendSubtree(std::vector<BuildNode>& nodes, const std::vector<BuildNode>& subtree) {
+    int32_t offset = (int32_t)nodes.size();
+    for (auto node : subtree) {
+        if (node.left >= 0) {
+            node.left += offset;
+            node.right += offset;
+        }
+        nodes.push_back(node);
+    }
+    return offset;
 }
 
-void TriangleSet::TriangleTreeCell::debugDump() {
-    qDebug() << __FUNCTION__;
-    qDebug() << "               bounds:" << getBounds();
-    qDebug() << "                depth:" << _depth;
-    qDebug() << "           population:" << _population << "this level or below"
-             << " ---- triangleIndices:" << _triangleIndices.size() << "in this cell";
+int32_t BuildTree::buildNode(std::vector<BuildNode>& target, uint32_t begin, uint32_t end, int depth) {
+    int32_t index = (int32_t)target.size();
+    target.emplace_back();
 
-    int numChildren = 0;
-    if (_children.first) {
-        numChildren++;
-    } else if (_children.second) {
-        numChildren++;
-    }
-    qDebug() << "child cells:" << numChildren;
-    if (_depth < MAX_DEPTH) {
-        if (_children.first) {
-            qDebug() << "child: 0";
-            _children.first->debugDump();
-        }
-        if (_children.second) {
-            qDebug() << "child: 1";
-            _children.second->debugDump();
-        }
+    BuildBounds bounds;
+    BuildBounds centroidBounds;
+    for (uint32_t i = begin; i < end; i++) {
+        bounds.add(_triangleBounds[order[i]]);
+        centroidBounds.add(_centroids[order[i]]);
     }
-}
+    target[index].bounds = bounds;
 
-std::pair<AABox, AABox> TriangleSet::TriangleTreeCell::getTriangleTreeCellChildBounds() {
-    std::pair<AABox, AABox> toReturn;
-    int axis = 0;
-    // find biggest axis
-    glm::vec3 dimensions = _bounds.getDimensions();
-    for (int i = 0; i < 3; i++) {
-        if (dimensions[i] >= dimensions[(i + 1) % 3] && dimensions[i] >= dimensions[(i + 2) % 3]) {
-            axis = i;
-            break;
-        }
+    uint32_t count = end - begin;
+    if (count < MIN_SPLIT_TRIANGLES) {
+        target[index].first = begin;
+        target[index].count = count;
+        return index;
     }
 
-    // The new boxes are half the size in the largest dimension
-    glm::vec3 newDimensions = dimensions;
-    newDimensions[axis] *= 0.5f;
-    toReturn.first.setBox(_bounds.getCorner(), newDimensions);
-    glm::vec3 offset = glm::vec3(0.0f);
-    offset[axis] = newDimensions[axis];
-    toReturn.second.setBox(_bounds.getCorner() + offset, newDimensions);
-    return toReturn;
-}
+    glm::vec3 centroidExtent = centroidBounds.max - centroidBounds.min;
+    uint32_t middle = begin;
+
+    if (depth < MAX_SAH_DEPTH && (centroidExtent.x > 0.0f || centroidExtent.y > 0.0f || centroidExtent.z > 0.0f)) {
+        auto getBin = [&](uint32_t triangle, int axis) {
+            float scale = SAH_BINS / centroidExtent[axis];
+            int bin = (int)((_centroids[triangle][axis] - centroidBounds.min[axis]) * scale);
+            return std::min(std::max(bin, 0), SAH_BINS - 1);
+        };
 
-void TriangleSet::TriangleTreeCell::insert(size_t triangleIndex) {
-    _population++;
+        float bestCost = FLT_MAX;
+        int bestAxis = -1;
+        int bestBin = -1;
+        for (int axis = 0; axis < 3; axis++) {
+            if (centroidExtent[axis] <= 0.0f) {
+                continue;
+            }
 
-    // if we're not yet at the max depth, then check which child the triangle fits in
-    if (_depth < MAX_DEPTH) {
-        const Triangle& triangle = _allTriangles[triangleIndex];
-        auto childBounds = getTriangleTreeCellChildBounds();
+            BuildBounds binBounds[SAH_BINS];
+            uint32_t binCounts[SAH_BINS] = { 0 };
+            for (uint32_t i = begin; i < end; i++) {
+                int bin = getBin(order[i], axis);
+                binCounts[bin]++;
+                binBounds[bin].add(_triangleBounds[order[i]]);
+            }
 
-        auto insertOperator = [&](const AABox& childBound, std::shared_ptr<TriangleTreeCell>& child) {
-            // if the child AABox would contain the triangle...
-            if (childBound.contains(triangle)) {
-                // if the child cell doesn't yet exist, create it...
-                if (!child) {
-                    child = std::make_shared<TriangleTreeCell>(_allTriangles, childBound, _depth + 1);
+            // sweep from the right to get the area and count on the right of each split, then from the left
+            float rightAreas[SAH_BINS];
+            uint32_t rightCounts[SAH_BINS];
+            BuildBounds accumulated;
+            uint32_t accumulatedCount = 0;
+            for (int bin = SAH_BINS - 1; bin > 0; bin--) {
+                accumulated.add(binBounds[bin]);
+                accumulatedCount += binCounts[bin];
+                rightAreas[bin] = accumulated.getArea();
+                rightCounts[bin] = accumulatedCount;
+            }
+
+            accumulated = BuildBounds();
+            accumulatedCount = 0;
+            for (int bin = 0; bin < SAH_BINS - 1; bin++) {
+                accumulated.add(binBounds[bin]);
+                accumulatedCount += binCounts[bin];
+                if (accumulatedCount == 0 || rightCounts[bin + 1] == 0) {
+                    continue;
+                }
+                float cost = accumulated.getArea() * accumulatedCount + rightAreas[bin + 1] * rightCounts[bin + 1];
+                if (cost < bestCost) {
+                    bestCost = cost;
+                    bestAxis = axis;
+                    bestBin = bin;
                 }
+            }
+        }
 
-                // insert the triangleIndex in the child cell
-                child->insert(triangleIndex);
-                return true;
+        if (bestAxis >= 0) {
+            float area = bounds.getArea();
+            float splitCost = area > 0.0f ? SAH_TRAVERSAL_COST + bestCost / area : (float)count;
+            if (count <= MAX_LEAF_TRIANGLES && splitCost >= (float)count) {
+                target[index].first = begin;
+                target[index].count = count;
+                return index;
             }
-            return false;
-        };
-        if (insertOperator(childBounds.first, _children.first) || insertOperator(childBounds.second, _children.second)) {
-            return;
+
+            auto it = std::partition(order.begin() + begin, order.begin() + end, [&](uint32_t triangle) {
+                return getBin(triangle, bestAxis) <= bestBin;
+            });
+            middle = (uint32_t)(it - order.begin());
         }
+    } else if (count <= MAX_LEAF_TRIANGLES) {
+        target[index].first = begin;
+        target[index].count = count;
+        return index;
     }
-    // either we're at max depth, or the triangle doesn't fit in one of our
-    // children and so we want to just record it here
-    _triangleIndices.push_back(triangleIndex);
-}
 
-bool TriangleSet::findRayIntersection(const glm::vec3& origin, const glm::vec3& direction, const glm::vec3& invDirection, float& distance,
-                                      BoxFace& face, Triangle& triangle, bool precision, bool allowBackface) {
-    if (!_isBalanced) {
-        balanceTree();
+    if (middle == begin || middle == end) {
+        // no useful split, split at the median along the longest axis
+        glm::vec3 dimensions = bounds.max - bounds.min;
+        int axis = (dimensions.x >= dimensions.y && dimensions.x >= dimensions.z) ? 0 : (dimensions.y >= dimensions.z ? 1 : 2);
+        middle = begin + count / 2;
+        std::nth_element(order.begin() + begin, order.begin() + middle, order.begin() + end, [&](uint32_t a, uint32_t b) {
+            return _centroids[a][axis] < _centroids[b][axis];
+        });
     }
 
-    float localDistance = distance;
-    int trianglesTouched = 0;
-    bool hit = _triangleTree.findRayIntersection(origin, direction, invDirection, localDistance, face, triangle, precision, trianglesTouched, allowBackface);
-    if (hit) {
-        distance = localDistance;
+    int32_t left;
+    int32_t right;
+    if (count >= PARALLEL_BUILD_MIN_TRIANGLES && depth < MAX_PARALLEL_BUILD_DEPTH) {
+        // the two halves touch disjoint ranges of the triangle order
+        std::vector<BuildNode> rightNodes;
+        auto rightBuild = std::async(std::launch::async, [&] {
+            buildNode(rightNodes, middle, end, depth + 1);
+        });
+        left = buildNode(target, begin, middle, depth + 1);
+        rightBuild.get();
+        right = appendSubtree(target, rightNodes);
+    } else {
+        left = buildNode(target, begin, middle, depth + 1);
+        right = buildNode(target, middle, end, depth + 1);
     }
 
-#if WANT_DEBUGGING
-    if (precision) {
-        qDebug() << "trianglesTouched :" << trianglesTouched << "out of:" << _triangleTree._population << "_triangles.size:" << _triangles.size();
-    }
-#endif
-    return hit;
+    target[index].left = left;
+    target[index].right = right;
+    return index;
 }
 
-// Determine of the given ray (origin/direction) in model space intersects with any triangles
-// in the set. If an intersection occurs, the distance and surface normal will be provided.
-bool TriangleSet::TriangleTreeCell::findRayIntersectionInternal(const glm::vec3& origin, const glm::vec3& direction,
-                                                                  float& distance, BoxFace& face, Triangle& triangle, bool precision,
-                                                                  int& trianglesTouched, bool allowBackface) {
-    bool intersectedSomething = false;
-    float bestDistance = FLT_MAX;
-    Triangle bestTriangle;
-
-    if (precision) {
-        for (const auto& triangleIndex : _triangleIndices) {
-            const auto& thisTriangle = _allTriangles[triangleIndex];
-            float thisTriangleDistance;
-            trianglesTouched++;
-            if (findRayTriangleIntersection(origin, direction, thisTriangle, thisTriangleDistance, allowBackface)) {
-                if (thisTriangleDistance < bestDistance) {
-                    bestDistance = thisTriangleDistance;
-                    bestTriangle = thisTriangle;
-                    intersectedSomething = true;
+// Collapses a binary node and up to one more level below it into a 4-wide node, returns the index of the wide node
+static int32_t addWideNode(const BuildTree& tree, int32_t buildIndex, const std::vector<Triangle>& triangles,
+                           std::vector<TriangleSet::Node>& nodes, std::vector<TriangleSet::TrianglePacket>& packets,
+                           int depth, int& maxDepth) {
+    maxDepth = std::max(maxDepth, depth);
+
+    const auto& buildNodes = tree.nodes;
+    const int WIDTH = TriangleSet::NODE_WIDTH;
+
+    // open the internal child with the largest area until there are four children
+    int32_t children[WIDTH];
+    int numChildren = 0;
+    const auto& buildNode = buildNodes[buildIndex];
+    if (buildNode.left < 0) {
+        children[numChildren++] = buildIndex;
+    } else {
+        children[numChildren++] = buildNode.left;
+        children[numChildren++] = buildNode.right;
+        while (numChildren < WIDTH) {
+            int largest = -1;
+            float largestArea = -1.0f;
+            for (int i = 0; i < numChildren; i++) {
+                const auto& child = buildNodes[children[i]];
+                if (child.left >= 0 && child.bounds.getArea() > largestArea) {
+                    largest = i;
+                    largestArea = child.bounds.getArea();
                 }
             }
+            if (largest < 0) {
+                break;
+            }
+            int32_t opened = children[largest];
+            children[largest] = buildNodes[opened].left;
+            children[numChildren++] = buildNodes[opened].right;
         }
-    } else {
-        intersectedSomething = true;
-        bestDistance = distance;
     }
 
-    if (intersectedSomething) {
-        distance = bestDistance;
-        triangle = bestTriangle;
+    int32_t nodeIndex = (int32_t)nodes.size();
+    nodes.emplace_back();
+    for (int i = 0; i < WIDTH; i++) {
+        // unused children get an empty box, and are skipped by their child index
+        glm::vec3 min { 0.0f };
+        glm::vec3 max { 0.0f };
+        int32_t childIndex = -1;
+        uint32_t packetCount = 0;
+
+        if (i < numChildren) {
+            const auto& child = buildNodes[children[i]];
+            min = child.bounds.min;
+            max = child.bounds.max;
+            if (child.left < 0) {
+                childIndex = (int32_t)packets.size();
+                packetCount = (child.count + WIDTH - 1) / WIDTH;
+                for (uint32_t first = 0; first < child.count; first += WIDTH) {
+                    TriangleSet::TrianglePacket packet;
+                    for (int lane = 0; lane < WIDTH; lane++) {
+                        uint32_t triangleIndex = first + lane < child.count ? tree.order[child.first + first + lane] : INVALID_TRIANGLE;
+                        glm::vec3 v0 { 0.0f };
+                        glm::vec3 e1 { 0.0f };
+                        glm::vec3 e2 { 0.0f };
+                        if (triangleIndex != INVALID_TRIANGLE) {
+                            const auto& triangle = triangles[triangleIndex];
+                            v0 = triangle.v0;
+                            e1 = triangle.v1 - triangle.v0;
+                            e2 = triangle.v2 - triangle.v0;
+                        }
+                        packet.v0x[lane] = v0.x;
+                        packet.v0y[lane] = v0.y;
+                        packet.v0z[lane] = v0.z;
+                        packet.e1x[lane] = e1.x;
+                        packet.e1y[lane] = e1.y;
+                        packet.e1z[lane] = e1.z;
+                        packet.e2x[lane] = e2.x;
+                        packet.e2y[lane] = e2.y;
+                        packet.e2z[lane] = e2.z;
+                        packet.triangles[lane] = triangleIndex;
+                    }
+                    packets.push_back(packet);
+                }
+            } else {
+                childIndex = addWideNode(tree, children[i], triangles, nodes, packets, depth + 1, maxDepth);
+            }
+        }
+
+        auto& node = nodes[nodeIndex];
+        node.minX[i] = min.x;
+        node.minY[i] = min.y;
+        node.minZ[i] = min.z;
+        node.maxX[i] = max.x;
+        node.maxY[i] = max.y;
+        node.maxZ[i] = max.z;
+        node.children[i] = childIndex;
+        node.packetCounts[i] = packetCount;
     }
+    return nodeIndex;
+}
 
-    return intersectedSomething;
+// Returns a bit mask of the children of the node whose box the ray enters before maxDistance, with their entry distances
+static inline int intersectRayNode(const glm::vec3& origin, const glm::vec3& invDirection, const TriangleSet::Node& node,
+                                   float maxDistance, float distances[TriangleSet::NODE_WIDTH]) {
+#ifdef TRIANGLE_SET_SSE
+    __m128 originX = _mm_set1_ps(origin.x);
+    __m128 originY = _mm_set1_ps(origin.y);
+    __m128 originZ = _mm_set1_ps(origin.z);
+    __m128 invX = _mm_set1_ps(invDirection.x);
+    __m128 invY = _mm_set1_ps(invDirection.y);
+    __m128 invZ = _mm_set1_ps(invDirection.z);
+
+    __m128 t1 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(node.minX), originX), invX);
+    __m128 t2 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(node.maxX), originX), invX);
+    __m128 entryDistance = _mm_min_ps(t1, t2);
+    __m128 exitDistance = _mm_max_ps(t1, t2);
+
+    t1 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(node.minY), originY), invY);
+    t2 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(node.maxY), originY), invY);
+    entryDistance = _mm_max_ps(entryDistance, _mm_min_ps(t1, t2));
+    exitDistance = _mm_min_ps(exitDistance, _mm_max_ps(t1, t2));
+
+    t1 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(node.minZ), originZ), invZ);
+    t2 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(node.maxZ), originZ), invZ);
+    entryDistance = _mm_max_ps(entryDistance, _mm_min_ps(t1, t2));
+    exitDistance = _mm_min_ps(exitDistance, _mm_max_ps(t1, t2));
+
+    // a ray starting inside a box enters it at zero
+    entryDistance = _mm_max_ps(entryDistance, _mm_setzero_ps());
+    __m128 hit = _mm_and_ps(_mm_cmple_ps(entryDistance, exitDistance), _mm_cmplt_ps(entryDistance, _mm_set1_ps(maxDistance)));
+    _mm_storeu_ps(distances, entryDistance);
+    return _mm_movemask_ps(hit);
+#else
+    int mask = 0;
+    for (int i = 0; i < TriangleSet::NODE_WIDTH; i++) {
+        float t1 = (node.minX[i] - origin.x) * invDirection.x;
+        float t2 = (node.maxX[i] - origin.x) * invDirection.x;
+        float entry = std::min(t1, t2);
+        float exit = std::max(t1, t2);
+
+        t1 = (node.minY[i] - origin.y) * invDirection.y;
+        t2 = (node.maxY[i] - origin.y) * invDirection.y;
+        entry = std::max(entry, std::min(t1, t2));
+        exit = std::min(exit, std::max(t1, t2));
+
+        t1 = (node.minZ[i] - origin.z) * invDirection.z;
+        t2 = (node.maxZ[i] - origin.z) * invDirection.z;
+        entry = std::max(entry, std::min(t1, t2));
+        exit = std::min(exit, std::max(t1, t2));
+
+        entry = std::max(entry, 0.0f);
+        distances[i] = entry;
+        if (entry <= exit && entry < maxDistance) {
+            mask |= 1 << i;
+        }
+    }
+    return mask;
+#endif
 }
 
-bool TriangleSet::TriangleTreeCell::findRayIntersection(const glm::vec3& origin, const glm::vec3& direction, const glm::vec3& invDirection,
-                                                        float& distance, BoxFace& face, Triangle& triangle, bool precision, int& trianglesTouched,
-                                                        bool allowBackface) {
-    if (_population < 1) {
-        return false; // no triangles below here, so we can't intersect
-    }
-
-    float bestLocalDistance = FLT_MAX;
-    BoxFace bestLocalFace;
-    Triangle bestLocalTriangle;
-    bool intersects = false;
-
-    // Check our local triangle set first
-    // The distance passed in here is the distance to our bounding box.  If !precision, that distance is used
-    {
-        float internalDistance = distance;
-        BoxFace internalFace { UNKNOWN_FACE };
-        Triangle internalTriangle;
-        if (findRayIntersectionInternal(origin, direction, internalDistance, internalFace, internalTriangle, precision, trianglesTouched, allowBackface)) {
-            bestLocalDistance = internalDistance;
-            bestLocalFace = internalFace;
-            bestLocalTriangle = internalTriangle;
-            intersects = true;
+// Tests the ray against four triangles at once, the same way as findRayTriangleIntersection, and keeps the closest hit
+static inline void intersectRayPacket(const glm::vec3& origin, const glm::vec3& direction,
+                                      const TriangleSet::TrianglePacket& packet, bool allowBackface,
+                                      float& bestDistance, uint32_t& bestTriangle) {
+#ifdef TRIANGLE_SET_SSE
+    __m128 directionX = _mm_set1_ps(direction.x);
+    __m128 directionY = _mm_set1_ps(direction.y);
+    __m128 directionZ = _mm_set1_ps(direction.z);
+    __m128 e1x = _mm_loadu_ps(packet.e1x);
+    __m128 e1y = _mm_loadu_ps(packet.e1y);
+    __m128 e1z = _mm_loadu_ps(packet.e1z);
+    __m128 e2x = _mm_loadu_ps(packet.e2x);
+    __m128 e2y = _mm_loadu_ps(packet.e2y);
+    __m128 e2z = _mm_loadu_ps(packet.e2z);
+
+    // P = cross(direction, e2)
+    __m128 px = _mm_sub_ps(_mm_mul_ps(directionY, e2z), _mm_mul_ps(directionZ, e2y));
+    __m128 py = _mm_sub_ps(_mm_mul_ps(directionZ, e2x), _mm_mul_ps(directionX, e2z));
+    __m128 pz = _mm_sub_ps(_mm_mul_ps(directionX, e2y), _mm_mul_ps(directionY, e2x));
+    __m128 det = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1x, px), _mm_mul_ps(e1y, py)), _mm_mul_ps(e1z, pz));
+
+    __m128 epsilon = _mm_set1_ps(EPSILON);
+    __m128 valid = allowBackface ? _mm_cmpge_ps(_mm_andnot_ps(_mm_set1_ps(-0.0f), det), epsilon) : _mm_cmpge_ps(det, epsilon);
+    if (_mm_movemask_ps(valid) == 0) {
+        return;
+    }
+    __m128 invDet = _mm_div_ps(_mm_set1_ps(1.0f), det);
+
+    // T = origin - v0
+    __m128 tx = _mm_sub_ps(_mm_set1_ps(origin.x), _mm_loadu_ps(packet.v0x));
+    __m128 ty = _mm_sub_ps(_mm_set1_ps(origin.y), _mm_loadu_ps(packet.v0y));
+    __m128 tz = _mm_sub_ps(_mm_set1_ps(origin.z), _mm_loadu_ps(packet.v0z));
+    __m128 u = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(tx, px), _mm_mul_ps(ty, py)), _mm_mul_ps(tz, pz)), invDet);
+    __m128 zero = _mm_setzero_ps();
+    __m128 one = _mm_set1_ps(1.0f);
+    valid = _mm_and_ps(valid, _mm_and_ps(_mm_cmpge_ps(u, zero), _mm_cmple_ps(u, one)));
+
+    // Q = cross(T, e1)
+    __m128 qx = _mm_sub_ps(_mm_mul_ps(ty, e1z), _mm_mul_ps(tz, e1y));
+    __m128 qy = _mm_sub_ps(_mm_mul_ps(tz, e1x), _mm_mul_ps(tx, e1z));
+    __m128 qz = _mm_sub_ps(_mm_mul_ps(tx, e1y), _mm_mul_ps(ty, e1x));
+    __m128 v = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(directionX, qx), _mm_mul_ps(directionY, qy)),
+                                     _mm_mul_ps(directionZ, qz)), invDet);
+    valid = _mm_and_ps(valid, _mm_and_ps(_mm_cmpge_ps(v, zero), _mm_cmple_ps(_mm_add_ps(u, v), one)));
+
+    __m128 t = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(e2x, qx), _mm_mul_ps(e2y, qy)), _mm_mul_ps(e2z, qz)), invDet);
+    valid = _mm_and_ps(valid, _mm_and_ps(_mm_cmpgt_ps(t, epsilon), _mm_cmplt_ps(t, _mm_set1_ps(bestDistance))));
+
+    int mask = _mm_movemask_ps(valid);
+    if (mask == 0) {
+        return;
+    }
+    float distances[TriangleSet::NODE_WIDTH];
+    _mm_storeu_ps(distances, t);
+    for (int lane = 0; lane < TriangleSet::NODE_WIDTH; lane++) {
+        if ((mask & (1 << lane)) && distances[lane] < bestDistance) {
+            bestDistance = distances[lane];
+            bestTriangle = packet.triangles[lane];
+        }
+    }
+#else
+    for (int lane = 0; lane < TriangleSet::NODE_WIDTH; lane++) {
+        if (packet.triangles[lane] == INVALID_TRIANGLE) {
+            continue;
+        }
+        glm::vec3 v0(packet.v0x[lane], packet.v0y[lane], packet.v0z[lane]);
+        glm::vec3 e1(packet.e1x[lane], packet.e1y[lane], packet.e1z[lane]);
+        glm::vec3 e2(packet.e2x[lane], packet.e2y[lane], packet.e2z[lane]);
+        float distance;
+        if (findRayTriangleIntersection(origin, direction, v0, v0 + e1, v0 + e2, distance, allowBackface) &&
+                distance < bestDistance) {
+            bestDistance = distance;
+            bestTriangle = packet.triangles[lane];
         }
     }
+#endif
+}
 
-    // if we're not yet at the max depth, then check our children
-    if (_depth < MAX_DEPTH) {
-        std::list<SortedTriangleCell> sortedTriangleCells;
-        auto sortingOperator = [&](std::shared_ptr<TriangleTreeCell>& child) {
-            if (child) {
-                float priority = FLT_MAX;
-                if (child->getBounds().contains(origin)) {
-                    priority = 0.0f;
-                } else {
-                    float childBoundDistance = FLT_MAX;
-                    BoxFace childBoundFace;
-                    glm::vec3 childBoundNormal;
-                    if (child->getBounds().findRayIntersection(origin, direction, invDirection, childBoundDistance, childBoundFace, childBoundNormal)) {
-                        // We only need to add this cell if it's closer than the local triangle set intersection (if there was one)
-                        if (childBoundDistance < bestLocalDistance) {
-                            priority = childBoundDistance;
-                        }
-                    }
-                }
+struct TraversalEntry {
+    int32_t child;
+    uint32_t packetCount;
+    float distance;
+};
+
+// Each level of the traversal pops one entry and pushes at most four, so the stack is bounded by the depth
+static TraversalEntry* getTraversalStack(int depth, TraversalEntry* fixedStack, std::vector<TraversalEntry>& allocatedStack) {
+    int stackSize = depth * (TriangleSet::NODE_WIDTH - 1) + 1;
+    if (stackSize <= MAX_TRAVERSAL_STACK) {
+        return fixedStack;
+    }
+    allocatedStack.resize(stackSize);
+    return allocatedStack.data();
+}
 
-                if (priority < FLT_MAX) {
-                    if (sortedTriangleCells.size() > 0 && priority < sortedTriangleCells.front().first) {
-                        sortedTriangleCells.emplace_front(priority, child);
-                    } else {
-                        sortedTriangleCells.emplace_back(priority, child);
-                    }
-                }
-            }
-        };
-        sortingOperator(_children.first);
-        sortingOperator(_children.second);
-
-        for (auto it = sortedTriangleCells.begin(); it != sortedTriangleCells.end(); ++it) {
-            const SortedTriangleCell& sortedTriangleCell = *it;
-            float childDistance = sortedTriangleCell.first;
-            // We can exit once childDistance > bestLocalDistance
-            if (childDistance > bestLocalDistance) {
-                break;
-            }
-            // If we're inside the child cell and !precision, we need the actual distance to the cell bounds
-            if (!precision && childDistance < EPSILON) {
-                BoxFace childBoundFace;
-                glm::vec3 childBoundNormal;
-                sortedTriangleCell.second->getBounds().findRayIntersection(origin, direction, invDirection, childDistance, childBoundFace, childBoundNormal);
-            }
-            BoxFace childFace;
-            Triangle childTriangle;
-            if (sortedTriangleCell.second->findRayIntersection(origin, direction, invDirection, childDistance, childFace, childTriangle, precision, trianglesTouched)) {
-                if (childDistance < bestLocalDistance) {
-                    bestLocalDistance = childDistance;
-                    bestLocalFace = childFace;
-                    bestLocalTriangle = childTriangle;
-                    intersects = true;
-                    break;
-                }
+// A zero direction component gives an infinite inverse, and 0 * inf would be NaN in the slab test when the ray
+// starts on a slab plane.  A finite inverse keeps those rays inside the slab, like rays parallel to it.
+static inline glm::vec3 getSlabInverse(const glm::vec3& invDirection) {
+    return glm::clamp(invDirection, glm::vec3(-FLT_MAX), glm::vec3(FLT_MAX));
+}
+
+// Pushes the hit children of a node so that the closest one is popped first
+static inline void pushChildren(const TriangleSet::Node& node, int hitMask, const float distances[TriangleSet::NODE_WIDTH],
+                                TraversalEntry* stack, int& stackSize) {
+    int hits[TriangleSet::NODE_WIDTH];
+    int numHits = 0;
+    for (int i = 0; i < TriangleSet::NODE_WIDTH; i++) {
+        if ((hitMask & (1 << i)) && node.children[i] >= 0) {
+            // insert sorted from farthest to closest
+            int j = numHits++;
+            while (j > 0 && distances[hits[j - 1]] < distances[i]) {
+                hits[j] = hits[j - 1];
+                j--;
             }
+            hits[j] = i;
         }
     }
 
-    if (intersects) {
-        distance = bestLocalDistance;
-        face = bestLocalFace;
-        triangle = bestLocalTriangle;
+    for (int i = 0; i < numHits; i++) {
+        stack[stackSize++] = { node.children[hits[i]], node.packetCounts[hits[i]], distances[hits[i]] };
     }
-    return intersects;
 }
 
-bool TriangleSet::findParabolaIntersection(const glm::vec3& origin, const glm::vec3& velocity, const glm::vec3& acceleration,
-                                           float& parabolicDistance, BoxFace& face, Triangle& triangle, bool precision, bool allowBackface) {
+} // namespace
+
+void TriangleSet::balanceTree() {
+    _nodes.clear();
+    _packets.clear();
+    _depth = 0;
+
+    if (!_triangles.empty()) {
+        BuildTree tree(_triangles);
+        tree.build();
+        _nodes.reserve(tree.nodes.size() / 2 + 1);
+        _packets.reserve(_triangles.size() / NODE_WIDTH + tree.nodes.size() / 2 + 1);
+        addWideNode(tree, 0, _triangles, _nodes, _packets, 1, _depth);
+    }
+
+    _isBalanced = true;
+
+#if WANT_DEBUGGING
+    debugDump();
+#endif
+}
+
+// Determine of the given ray (origin/direction) in model space intersects with any triangles
+// in the set. If an intersection occurs, the distance and surface normal will be provided.
+bool TriangleSet::findRayIntersection(const glm::vec3& origin, const glm::vec3& direction, const glm::vec3& invDirection, float& distance,
+                                      BoxFace& face, Triangle& triangle, bool precision, bool allowBackface) {
     if (!_isBalanced) {
         balanceTree();
     }
 
-    float localDistance = parabolicDistance;
-    int trianglesTouched = 0;
-    bool hit = _triangleTree.findParabolaIntersection(origin, velocity, acceleration, localDistance, face, triangle, precision, trianglesTouched, allowBackface);
-    if (hit) {
-        parabolicDistance = localDistance;
+    if (_nodes.empty()) {
+        return false;
     }
 
-#if WANT_DEBUGGING
-    if (precision) {
-        qDebug() << "trianglesTouched :" << trianglesTouched << "out of:" << _triangleTree._population << "_triangles.size:" << _triangles.size();
+    // without precision the distance passed in, to our bounding box, is used
+    if (!precision) {
+        return true;
     }
-#endif
-    return hit;
-}
 
-bool TriangleSet::TriangleTreeCell::findParabolaIntersectionInternal(const glm::vec3& origin, const glm::vec3& velocity,
-                                                                       const glm::vec3& acceleration, float& parabolicDistance,
-                                                                       BoxFace& face, Triangle& triangle, bool precision,
-                                                                       int& trianglesTouched, bool allowBackface) {
-    bool intersectedSomething = false;
     float bestDistance = FLT_MAX;
-    Triangle bestTriangle;
-
-    if (precision) {
-        for (const auto& triangleIndex : _triangleIndices) {
-            const auto& thisTriangle = _allTriangles[triangleIndex];
-            float thisTriangleDistance;
-            trianglesTouched++;
-            if (findParabolaTriangleIntersection(origin, velocity, acceleration, thisTriangle, thisTriangleDistance, allowBackface)) {
-                if (thisTriangleDistance < bestDistance) {
-                    bestDistance = thisTriangleDistance;
-                    bestTriangle = thisTriangle;
-                    intersectedSomething = true;
-                }
+    uint32_t bestTriangle = INVALID_TRIANGLE;
+    glm::vec3 slabInverse = getSlabInverse(invDirection);
+
+    TraversalEntry fixedStack[MAX_TRAVERSAL_STACK];
+    std::vector<TraversalEntry> allocatedStack;
+    TraversalEntry* stack = getTraversalStack(_depth, fixedStack, allocatedStack);
+    int stackSize = 0;
+    stack[stackSize++] = { 0, 0, 0.0f };
+
+    while (stackSize > 0) {
+        TraversalEntry entry = stack[--stackSize];
+        if (entry.distance >= bestDistance) {
+            continue;
+        }
+
+        if (entry.packetCount > 0) {
+            for (uint32_t i = 0; i < entry.packetCount; i++) {
+                intersectRayPacket(origin, direction, _packets[entry.child + i], allowBackface, bestDistance, bestTriangle);
             }
+            continue;
         }
-    } else {
-        intersectedSomething = true;
-        bestDistance = parabolicDistance;
+
+        const auto& node = _nodes[entry.child];
+        float childDistances[NODE_WIDTH];
+        int hitMask = intersectRayNode(origin, slabInverse, node, bestDistance, childDistances);
+        pushChildren(node, hitMask, childDistances, stack, stackSize);
     }
 
-    if (intersectedSomething) {
-        parabolicDistance = bestDistance;
-        triangle = bestTriangle;
+    if (bestTriangle == INVALID_TRIANGLE) {
+        return false;
     }
 
-    return intersectedSomething;
+    distance = bestDistance;
+    face = UNKNOWN_FACE;
+    triangle = _triangles[bestTriangle];
+    return true;
 }
 
-bool TriangleSet::TriangleTreeCell::findParabolaIntersection(const glm::vec3& origin, const glm::vec3& velocity,
-                                                               const glm::vec3& acceleration, float& parabolicDistance,
-                                                               BoxFace& face, Triangle& triangle, bool precision,
-                                                               int& trianglesTouched, bool allowBackface) {
-    if (_population < 1) {
-        return false; // no triangles below here, so we can't intersect
-    }
-
-    float bestLocalDistance = FLT_MAX;
-    BoxFace bestLocalFace;
-    Triangle bestLocalTriangle;
-    bool intersects = false;
-
-    // Check our local triangle set first
-    // The distance passed in here is the distance to our bounding box.  If !precision, that distance is used
-    {
-        float internalDistance = parabolicDistance;
-        BoxFace internalFace;
-        Triangle internalTriangle;
-        if (findParabolaIntersectionInternal(origin, velocity, acceleration, internalDistance, internalFace, internalTriangle, precision, trianglesTouched, allowBackface)) {
-            bestLocalDistance = internalDistance;
-            bestLocalFace = internalFace;
-            bestLocalTriangle = internalTriangle;
-            intersects = true;
-        }
+bool TriangleSet::findParabolaIntersection(const glm::vec3& origin, const glm::vec3& velocity, const glm::vec3& acceleration,
+                                           float& parabolicDistance, BoxFace& face, Triangle& triangle, bool precision, bool allowBackface) {
+    if (!_isBalanced) {
+        balanceTree();
     }
 
-    // if we're not yet at the max depth, then check our children
-    if (_depth < MAX_DEPTH) {
-        std::list<SortedTriangleCell> sortedTriangleCells;
-        auto sortingOperator = [&](std::shared_ptr<TriangleTreeCell>& child) {
-            if (child) {
-                float priority = FLT_MAX;
-                if (child->getBounds().contains(origin)) {
-                    priority = 0.0f;
-                } else {
-                    float childBoundDistance = FLT_MAX;
-                    BoxFace childBoundFace;
-                    glm::vec3 childBoundNormal;
-                    if (child->getBounds().findParabolaIntersection(origin, velocity, acceleration, childBoundDistance, childBoundFace, childBoundNormal)) {
-                        // We only need to add this cell if it's closer than the local triangle set intersection (if there was one)
-                        if (childBoundDistance < bestLocalDistance) {
-                            priority = childBoundDistance;
-                        }
-                    }
-                }
+    if (_nodes.empty()) {
+        return false;
+    }
+
+    // without precision the distance passed in, to our bounding box, is used
+    if (!precision) {
+        return true;
+    }
+
+    float bestDistance = FLT_MAX;
+    uint32_t bestTriangle = INVALID_TRIANGLE;
+
+    TraversalEntry fixedStack[MAX_TRAVERSAL_STACK];
+    std::vector<TraversalEntry> allocatedStack;
+    TraversalEntry* stack = getTraversalStack(_depth, fixedStack, allocatedStack);
+    int stackSize = 0;
+    stack[stackSize++] = { 0, 0, 0.0f };
+
+    while (stackSize > 0) {
+        TraversalEntry entry = stack[--stackSize];
+        if (entry.distance >= bestDistance) {
+            continue;
+        }
 
-                if (priority < FLT_MAX) {
-                    if (sortedTriangleCells.size() > 0 && priority < sortedTriangleCells.front().first) {
-                        sortedTriangleCells.emplace_front(priority, child);
-                    } else {
-                        sortedTriangleCells.emplace_back(priority, child);
+        if (entry.packetCount > 0) {
+            for (uint32_t i = 0; i < entry.packetCount; i++) {
+                const auto& packet = _packets[entry.child + i];
+                for (int lane = 0; lane < NODE_WIDTH; lane++) {
+                    uint32_t triangleIndex = packet.triangles[lane];
+                    float triangleDistance;
+                    if (triangleIndex != INVALID_TRIANGLE &&
+                            findParabolaTriangleIntersection(origin, velocity, acceleration, _triangles[triangleIndex],
+                                                             triangleDistance, allowBackface) &&
+                            triangleDistance < bestDistance) {
+                        bestDistance = triangleDistance;
+                        bestTriangle = triangleIndex;
                     }
                 }
             }
-        };
-        sortingOperator(_children.first);
-        sortingOperator(_children.second);
-
-        for (auto it = sortedTriangleCells.begin(); it != sortedTriangleCells.end(); ++it) {
-            const SortedTriangleCell& sortedTriangleCell = *it;
-            float childDistance = sortedTriangleCell.first;
-            // We can exit once childDistance > bestLocalDistance
-            if (childDistance > bestLocalDistance) {
-                break;
-            }
-            // If we're inside the child cell and !precision, we need the actual distance to the cell bounds
-            if (!precision && childDistance < EPSILON) {
-                BoxFace childBoundFace;
-                glm::vec3 childBoundNormal;
-                sortedTriangleCell.second->getBounds().findParabolaIntersection(origin, velocity, acceleration, childDistance, childBoundFace, childBoundNormal);
+            continue;
+        }
+
+        // parabolas are rare enough that their boxes are tested one at a time
+        const auto& node = _nodes[entry.child];
+        float childDistances[NODE_WIDTH];
+        int hitMask = 0;
+        for (int i = 0; i < NODE_WIDTH; i++) {
+            if (node.children[i] < 0) {
+                continue;
             }
-            BoxFace childFace;
-            Triangle childTriangle;
-            if (sortedTriangleCell.second->findParabolaIntersection(origin, velocity, acceleration, childDistance, childFace, childTriangle, precision, trianglesTouched)) {
-                if (childDistance < bestLocalDistance) {
-                    bestLocalDistance = childDistance;
-                    bestLocalFace = childFace;
-                    bestLocalTriangle = childTriangle;
-                    intersects = true;
-                    break;
+            glm::vec3 corner(node.minX[i], node.minY[i], node.minZ[i]);
+            AABox childBounds(corner, glm::vec3(node.maxX[i], node.maxY[i], node.maxZ[i]) - corner);
+            float childDistance = FLT_MAX;
+            if (childBounds.contains(origin)) {
+                childDistance = 0.0f;
+            } else {
+                BoxFace childFace;
+                glm::vec3 childNormal;
+                if (!childBounds.findParabolaIntersection(origin, velocity, acceleration, childDistance, childFace, childNormal)) {
+                    continue;
                 }
             }
+            if (childDistance < bestDistance) {
+                childDistances[i] = childDistance;
+                hitMask |= 1 << i;
+            }
         }
+        pushChildren(node, hitMask, childDistances, stack, stackSize);
     }
 
-    if (intersects) {
-        parabolicDistance = bestLocalDistance;
-        face = bestLocalFace;
-        triangle = bestLocalTriangle;
+    if (bestTriangle == INVALID_TRIANGLE) {
+        return false;
     }
-    return intersects;
+
+    parabolicDistance = bestDistance;
+    face = UNKNOWN_FACE;
+    triangle = _triangles[bestTriangle];
+    return true;
 }
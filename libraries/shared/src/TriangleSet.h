@@ -11,59 +11,18 @@
 
 #pragma once
 
+#include <stdint.h>
 #include <vector>
-#include <memory>
 
 #include "AABox.h"
 #include "GeometryUtil.h"
 
+// A set of triangles with a bounding volume hierarchy for ray and parabola picks.
+// The hierarchy is built with the surface area heuristic, then collapsed into a flat array of 4-wide nodes so that a
+// ray is tested against four child boxes at once.  Leaves hold their triangles in packets of four, tested at once too.
 class TriangleSet {
-
-    class TriangleTreeCell {
-    public:
-        TriangleTreeCell(std::vector<Triangle>& allTriangles) : _allTriangles(allTriangles) {}
-        TriangleTreeCell(std::vector<Triangle>& allTriangles, const AABox& bounds, int depth);
-
-        void insert(size_t triangleIndex);
-        void reset(const AABox& bounds, int depth = 0);
-        void clear();
-
-        bool findRayIntersection(const glm::vec3& origin, const glm::vec3& direction, const glm::vec3& invDirection,
-            float& distance, BoxFace& face, Triangle& triangle, bool precision, int& trianglesTouched,
-            bool allowBackface = false);
-        bool findParabolaIntersection(const glm::vec3& origin, const glm::vec3& velocity, const glm::vec3& acceleration,
-            float& parabolicDistance, BoxFace& face, Triangle& triangle, bool precision, int& trianglesTouched,
-            bool allowBackface = false);
-
-        const AABox& getBounds() const { return _bounds; }
-
-        void debugDump();
-
-    protected:
-        // checks our internal list of triangles
-        bool findRayIntersectionInternal(const glm::vec3& origin, const glm::vec3& direction,
-            float& distance, BoxFace& face, Triangle& triangle, bool precision, int& trianglesTouched,
-            bool allowBackface = false);
-        bool findParabolaIntersectionInternal(const glm::vec3& origin, const glm::vec3& velocity, const glm::vec3& acceleration,
-            float& parabolicDistance, BoxFace& face, Triangle& triangle, bool precision, int& trianglesTouched,
-            bool allowBackface = false);
-
-        std::pair<AABox, AABox> getTriangleTreeCellChildBounds();
-
-        std::vector<Triangle>& _allTriangles;
-        std::pair<std::shared_ptr<TriangleTreeCell>, std::shared_ptr<TriangleTreeCell>> _children;
-        int _depth { 0 };
-        int _population { 0 };
-        AABox _bounds;
-        std::vector<size_t> _triangleIndices;
-
-        friend class TriangleSet;
-    };
-
-    using SortedTriangleCell = std::pair<float, std::shared_ptr<TriangleTreeCell>>;
-
 public:
-    TriangleSet() : _triangleTree(_triangles) {}
+    TriangleSet() {}
 
     void debugDump();
 
@@ -86,9 +45,41 @@ public:
     bool convexHullContains(const glm::vec3& point) const;
     const AABox& getBounds() const { return _bounds; }
 
+    static const int NODE_WIDTH = 4;
+
+    // Bounds of the four children of a node, stored by component so they can be tested together
+    struct Node {
+        float minX[NODE_WIDTH];
+        float minY[NODE_WIDTH];
+        float minZ[NODE_WIDTH];
+        float maxX[NODE_WIDTH];
+        float maxY[NODE_WIDTH];
+        float maxZ[NODE_WIDTH];
+        // a child is a node index, or the first packet of a leaf when its packet count isn't zero, or -1 if unused
+        int32_t children[NODE_WIDTH];
+        uint32_t packetCounts[NODE_WIDTH];
+    };
+
+    // Four triangles stored by component, as an origin vertex and two edges
+    struct TrianglePacket {
+        float v0x[NODE_WIDTH];
+        float v0y[NODE_WIDTH];
+        float v0z[NODE_WIDTH];
+        float e1x[NODE_WIDTH];
+        float e1y[NODE_WIDTH];
+        float e1z[NODE_WIDTH];
+        float e2x[NODE_WIDTH];
+        float e2y[NODE_WIDTH];
+        float e2z[NODE_WIDTH];
+        // index in the triangle list, INVALID_TRIANGLE for the unused lanes of the last packet of a leaf
+        uint32_t triangles[NODE_WIDTH];
+    };
+
 protected:
     bool _isBalanced { false };
     std::vector<Triangle> _triangles;
-    TriangleTreeCell _triangleTree;
+    std::vector<Node> _nodes;
+    std::vector<TrianglePacket> _packets;
+    int _depth { 0 }; // of the hierarchy in nodes, bounds the traversal stack
     AABox _bounds;
 };
@@ -0,0 +1,35 @@
+//
+//  AudioTestUtils.h
+//  libraries/test-utils/src/test-utils
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioTestUtils_h
+#define hifi_AudioTestUtils_h
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// a 150Hz voiced sound, exactly 160 samples per period at 24kHz
+static const int TONE_PERIOD = 160;
+
+inline int16_t tone(int n) {
+    const float TWO_PI = 6.283185307f;
+    float phase = TWO_PI * (float)(n % TONE_PERIOD) / (float)TONE_PERIOD;
+    return (int16_t)(8000.0f * (sinf(phase) + 0.5f * sinf(2.0f * phase) + 0.25f * sinf(3.0f * phase)));
+}
+
+inline std::vector<int16_t> makeTone(int start, int numSamples) {
+    std::vector<int16_t> samples(numSamples);
+    for (int i = 0; i < numSamples; i++) {
+        samples[i] = tone(start + i);
+    }
+    return samples;
+}
+
+#endif // hifi_AudioTestUtils_h
@@ -15,11 +15,40 @@
 #include "Space.h"
 #include <cstring>
 #include <algorithm>
+#include <future>
+#include <thread>
 
 #include <glm/gtx/quaternion.hpp>
 
 using namespace workload;
 
+// Proxies are indexed by the cell of this size containing their center
+static const float CELL_SIZE = 32.0f;
+// Cell bounds are padded so a center rounded onto a cell face is still inside its cell
+static const float CELL_PADDING = 0.001f * CELL_SIZE;
+static const uint64_t INVALID_CELL_KEY = (uint64_t)-1;
+
+// Touched proxies are classified in parallel jobs of at least this many proxies
+static const size_t MIN_PROXIES_PER_CLASSIFY_JOB = 4096;
+static const size_t MAX_NUM_CLASSIFY_JOBS = 8;
+
+static uint8_t classifySphere(const Sphere& sphere, const Views& views) {
+    glm::vec3 proxyCenter = glm::vec3(sphere);
+    float proxyRadius = sphere.w;
+    uint8_t region = Region::UNKNOWN;
+    for (const auto& view : views) {
+        // for each 'view' we need only increment 'k' below the current value of 'region'
+        for (uint8_t k = 0; k < region; ++k) {
+            float touchDistance = proxyRadius + view.regions[k].w;
+            if (distance2(proxyCenter, glm::vec3(view.regions[k])) < touchDistance * touchDistance) {
+                region = k;
+                break;
+            }
+        }
+    }
+    return region;
+}
+
 Space::Space() : Collection() {
 }
 
@@ -31,6 +60,9 @@ void Space::processTransactionFrame(const Transaction& transaction) {
     if (maxID > (Index) _proxies.size()) {
         _proxies.resize(maxID + 100); // allocate the maxId and more
         _owners.resize(maxID + 100);
+        _proxyCells.resize(maxID + 100, INVALID_CELL_KEY);
+        _proxyCellSlots.resize(maxID + 100, 0);
+        _isTouched.resize(maxID + 100, 0);
     }
     // Now we know for sure that we have enough items in the array to
     // capture anything coming from the transaction
@@ -56,6 +88,9 @@ void Space::processResets(const Transaction::Resets& transactions) {
         item.prevRegion = item.region = Region::UNKNOWN;
 
         _owners[proxyID] = (std::get<2>(reset));
+
+        placeInGrid(proxyID);
+        touchProxy(proxyID);
     }
 }
 
@@ -72,6 +107,8 @@ void Space::processRemoves(const Transaction::Removes& transactions) {
         // Kill it
         item.prevRegion = item.region = Region::INVALID;
         _owners[removedID] = Owner();
+
+        removeFromGrid(removedID);
     }
 }
 
@@ -87,37 +124,193 @@ void Space::processUpdates(const Transaction::Updates& transactions) {
 
         // Update the item
         item.sphere = (std::get<1>(update));
+
+        placeInGrid(updateID);
+        touchProxy(updateID);
     }
 }
 
+glm::ivec3 Space::evalCellCoord(const glm::vec3& position) const {
+    return glm::ivec3(glm::floor(position * (1.0f / CELL_SIZE)));
+}
+
+Space::CellKey Space::evalCellKey(const glm::ivec3& coord) const {
+    // 21 bits per axis is plenty for cells of CELL_SIZE
+    const CellKey MASK = (1 << 21) - 1;
+    return (((CellKey)coord.x & MASK) << 42) | (((CellKey)coord.y & MASK) << 21) | ((CellKey)coord.z & MASK);
+}
+
+void Space::placeInGrid(int32_t proxyID) {
+    const auto& sphere = _proxies[proxyID].sphere;
+    auto coord = evalCellCoord(glm::vec3(sphere));
+    auto key = evalCellKey(coord);
+    if (key != _proxyCells[proxyID]) {
+        removeFromGrid(proxyID);
+        auto& cell = _cells[key];
+        if (cell.proxies.empty()) {
+            cell.coord = coord;
+            cell.maxRadius = 0.0f;
+        }
+        _proxyCells[proxyID] = key;
+        _proxyCellSlots[proxyID] = (uint32_t)cell.proxies.size();
+        cell.proxies.push_back(proxyID);
+    }
+    // the max radius of a cell never shrinks until the cell is empty, it only needs to be conservative
+    auto& cell = _cells[key];
+    cell.maxRadius = std::max(cell.maxRadius, sphere.w);
+}
+
+void Space::removeFromGrid(int32_t proxyID) {
+    auto key = _proxyCells[proxyID];
+    if (key == INVALID_CELL_KEY) {
+        return;
+    }
+    auto cellItr = _cells.find(key);
+    if (cellItr != _cells.end()) {
+        auto& cellProxies = cellItr->second.proxies;
+        auto slot = _proxyCellSlots[proxyID];
+        // swap the last proxy of the cell in the slot
+        auto lastProxyID = cellProxies.back();
+        cellProxies[slot] = lastProxyID;
+        _proxyCellSlots[lastProxyID] = slot;
+        cellProxies.pop_back();
+        if (cellProxies.empty()) {
+            _cells.erase(cellItr);
+        }
+    }
+    _proxyCells[proxyID] = INVALID_CELL_KEY;
+}
+
+void Space::touchProxy(int32_t proxyID) {
+    if (!_isTouched[proxyID]) {
+        _isTouched[proxyID] = 1;
+        _touchedProxies.push_back(proxyID);
+    }
+}
+
+void Space::touchCellsNearMovedRegions() {
+    // the region of a proxy only depends on which region spheres it touches, a proxy can't change region unless one of
+    // the spheres moved or changed size across it
+    std::vector<std::pair<Sphere, Sphere>> movedRegions;
+    for (size_t j = 0; j < _views.size(); ++j) {
+        for (uint8_t k = 0; k < Region::NUM_VIEW_REGIONS; ++k) {
+            const auto& prevRegion = _classifiedViews[j].regions[k];
+            const auto& region = _views[j].regions[k];
+            if (prevRegion != region) {
+                movedRegions.emplace_back(prevRegion, region);
+            }
+        }
+    }
+    if (movedRegions.empty()) {
+        return;
+    }
+
+    enum Touch { NONE = 0, SOME, ALL };
+    auto evalTouch = [](const glm::vec3& cellMin, const glm::vec3& cellMax, float maxRadius, const Sphere& region) {
+        glm::vec3 center = glm::vec3(region);
+        glm::vec3 nearest = glm::clamp(center, cellMin, cellMax);
+        glm::vec3 farthest = glm::max(glm::abs(center - cellMin), glm::abs(center - cellMax));
+        if (glm::dot(farthest, farthest) < region.w * region.w) {
+            return ALL;
+        }
+        float touchDistance = region.w + maxRadius;
+        if (distance2(nearest, center) >= touchDistance * touchDistance) {
+            return NONE;
+        }
+        return SOME;
+    };
+
+    for (const auto& cellEntry : _cells) {
+        const auto& cell = cellEntry.second;
+        glm::vec3 cellMin = glm::vec3(cell.coord) * CELL_SIZE - glm::vec3(CELL_PADDING);
+        glm::vec3 cellMax = cellMin + glm::vec3(CELL_SIZE + 2.0f * CELL_PADDING);
+        for (const auto& movedRegion : movedRegions) {
+            auto prevTouch = evalTouch(cellMin, cellMax, cell.maxRadius, movedRegion.first);
+            auto touch = evalTouch(cellMin, cellMax, cell.maxRadius, movedRegion.second);
+            if (prevTouch == SOME || touch == SOME || prevTouch != touch) {
+                for (auto proxyID : cell.proxies) {
+                    touchProxy(proxyID);
+                }
+                break;
+            }
+        }
+    }
+}
+
+void Space::classifyTouchedProxies(std::vector<Space::Change>& changes) {
+    // classify in proxy order so the changes come out in the same order as a classification of all the proxies
+    std::sort(_touchedProxies.begin(), _touchedProxies.end());
+
+    size_t numTouched = _touchedProxies.size();
+    size_t numJobs = std::min(MAX_NUM_CLASSIFY_JOBS, (size_t)std::max(1u, std::thread::hardware_concurrency()));
+    numJobs = std::max((size_t)1, std::min(numJobs, numTouched / MIN_PROXIES_PER_CLASSIFY_JOB));
+
+    std::vector<std::vector<Space::Change>> jobChanges(numJobs);
+    auto classifyJob = [&](size_t job) {
+        auto& outChanges = jobChanges[job];
+        size_t end = numTouched * (job + 1) / numJobs;
+        for (size_t i = numTouched * job / numJobs; i < end; ++i) {
+            auto proxyID = _touchedProxies[i];
+            Proxy& proxy = _proxies[proxyID];
+            if (proxy.region < Region::INVALID) {
+                proxy.prevRegion = proxy.region;
+                proxy.region = classifySphere(proxy.sphere, _views);
+                if (proxy.region != proxy.prevRegion) {
+                    outChanges.emplace_back(Space::Change(proxyID, proxy.region, proxy.prevRegion));
+                }
+            }
+        }
+    };
+
+    std::vector<std::future<void>> jobs;
+    for (size_t job = 1; job < numJobs; ++job) {
+        jobs.push_back(std::async(std::launch::async, classifyJob, job));
+    }
+    classifyJob(0);
+    for (auto& job : jobs) {
+        job.wait();
+    }
+
+    for (auto& outChanges : jobChanges) {
+        changes.insert(changes.end(), outChanges.begin(), outChanges.end());
+    }
+
+    for (auto proxyID : _touchedProxies) {
+        _isTouched[proxyID] = 0;
+    }
+    _touchedProxies.clear();
+}
+
 void Space::categorizeAndGetChanges(std::vector<Space::Change>& changes) {
     std::unique_lock<std::mutex> lock(_proxiesMutex);
     uint32_t numProxies = (uint32_t)_proxies.size();
-    uint32_t numViews = (uint32_t)_views.size();
-    for (uint32_t i = 0; i < numProxies; ++i) {
-        Proxy& proxy = _proxies[i];
-        if (proxy.region < Region::INVALID) {
-            glm::vec3 proxyCenter = glm::vec3(proxy.sphere);
-            float proxyRadius = proxy.sphere.w;
-            uint8_t region = Region::UNKNOWN;
-            for (uint32_t j = 0; j < numViews; ++j) {
-                auto& view = _views[j];
-                // for each 'view' we need only increment 'k' below the current value of 'region'
-                for (uint8_t k = 0; k < region; ++k) {
-                    float touchDistance = proxyRadius + view.regions[k].w;
-                    if (distance2(proxyCenter, glm::vec3(view.regions[k])) < touchDistance * touchDistance) {
-                        region = k;
-                        break;
-                    }
-                }
+
+    if (_needsFullClassification || _views.size() != _classifiedViews.size()) {
+        _needsFullClassification = false;
+        for (uint32_t i = 0; i < numProxies; ++i) {
+            if (_proxies[i].region < Region::INVALID) {
+                touchProxy((int32_t)i);
             }
-            proxy.prevRegion = proxy.region;
-            proxy.region = region;
-            if (proxy.region != proxy.prevRegion) {
-                changes.emplace_back(Space::Change((int32_t)i, proxy.region, proxy.prevRegion));
+        }
+    } else {
+        touchCellsNearMovedRegions();
+
+        // the proxies that changed region last time need their prevRegion to catch up
+        for (auto proxyID : _changedProxies) {
+            if (proxyID < (int32_t)numProxies) {
+                touchProxy(proxyID);
             }
         }
     }
+    _classifiedViews = _views;
+
+    auto firstChange = changes.size();
+    classifyTouchedProxies(changes);
+
+    _changedProxies.clear();
+    for (auto i = firstChange; i < changes.size(); ++i) {
+        _changedProxies.push_back(changes[i].proxyId);
+    }
 }
 
 uint32_t Space::copyProxyValues(Proxy* proxies, uint32_t numDestProxies) const {
@@ -149,7 +342,15 @@ void Space::clear() {
     _IDAllocator.clear();
     _proxies.clear();
     _owners.clear();
+    _cells.clear();
+    _proxyCells.clear();
+    _proxyCellSlots.clear();
+    _touchedProxies.clear();
+    _isTouched.clear();
+    _changedProxies.clear();
+    _needsFullClassification = true;
     _views.clear();
+    _classifiedViews.clear();
 }
 
 void Space::setViews(const Views& views) {
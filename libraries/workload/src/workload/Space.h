@@ -16,6 +16,7 @@
 #define hifi_workload_Space_h
 
 #include <memory>
+#include <unordered_map>
 #include <vector>
 #include <glm/glm.hpp>
 
@@ -59,12 +60,41 @@ private:
     void processRemoves(const Transaction::Removes& transactions);
     void processUpdates(const Transaction::Updates& transactions);
 
+    // The proxies are kept in a uniform grid of cells over their centers, so that only the proxies that moved and the
+    // proxies in the cells crossed by the boundary of a region that moved need to be classified again
+    using CellKey = uint64_t;
+    class Cell {
+    public:
+        glm::ivec3 coord;
+        std::vector<int32_t> proxies;
+        float maxRadius { 0.0f };
+    };
+
+    CellKey evalCellKey(const glm::ivec3& coord) const;
+    glm::ivec3 evalCellCoord(const glm::vec3& position) const;
+    void placeInGrid(int32_t proxyID);
+    void removeFromGrid(int32_t proxyID);
+    void touchProxy(int32_t proxyID);
+    void touchCellsNearMovedRegions();
+    void classifyTouchedProxies(std::vector<Change>& changes);
+
     // The database of proxies is protected for editing by a mutex
     mutable std::mutex _proxiesMutex;
     Proxy::Vector _proxies;
     std::vector<Owner> _owners;
 
+    std::unordered_map<CellKey, Cell> _cells;
+    std::vector<CellKey> _proxyCells;
+    std::vector<uint32_t> _proxyCellSlots;
+
+    // the proxies to classify in the next categorizeAndGetChanges
+    std::vector<int32_t> _touchedProxies;
+    std::vector<uint8_t> _isTouched;
+    std::vector<int32_t> _changedProxies;
+    bool _needsFullClassification { true };
+
     Views _views;
+    Views _classifiedViews;
 };
 
 using SpacePointer = std::shared_ptr<Space>;
@@ -0,0 +1,270 @@
+//
+//  AudioDynamicsTests.cpp
+//  tests/audio/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioDynamicsTests.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <AudioDynamicsBlock.h>
+#include <AudioGate.h>
+#include <AudioLimiter.h>
+#include <AudioReverb.h>
+
+QTEST_MAIN(AudioDynamicsTests)
+
+static const int SAMPLE_RATE = 48000;
+static const int FRAMES_PER_CALL = 480;
+
+// odd, so the vector loops are followed by a scalar tail
+static const int NUM_FRAMES = 253;
+
+static uint32_t randomBits() {
+    return ((uint32_t)rand() << 30) ^ ((uint32_t)rand() << 15) ^ (uint32_t)rand();
+}
+
+// a 440Hz tone in [-1.0f, 1.0f]
+static float tone(int n) {
+    const float TWO_PI = 6.283185307f;
+    return sinf(TWO_PI * 440.0f * (float)n / (float)SAMPLE_RATE);
+}
+
+static int maxDifference(const int16_t* a, const int16_t* b, int numSamples) {
+    int difference = 0;
+    for (int i = 0; i < numSamples; i++) {
+        difference = std::max(difference, std::abs(a[i] - b[i]));
+    }
+    return difference;
+}
+
+void AudioDynamicsTests::testKernelsMatchReference() {
+    srand(1);
+
+    for (int numChannels = 1; numChannels <= 4; numChannels *= 2) {
+        int numSamples = NUM_FRAMES * numChannels;
+
+        // floats from far below to far above the log2 domain, with signed zeros
+        std::vector<float> input(numSamples);
+        for (auto& x : input) {
+            x = (float)(rand() % 2001 - 1000) / 1000.0f * powf(2.0f, (float)(rand() % 60 - 40));
+        }
+        input[0] = 0.0f;
+        input[1] = -0.0f;
+
+        std::vector<int32_t> expected(NUM_FRAMES);
+        std::vector<int32_t> actual(NUM_FRAMES);
+        peaklog2Block_ref(input.data(), expected.data(), NUM_FRAMES, numChannels);
+        peaklog2Block(input.data(), actual.data(), NUM_FRAMES, numChannels);
+        QVERIFY(actual == expected);
+
+        // gain and dither can be fused into one rounding, so the output may differ by 1
+        std::vector<float> gain(NUM_FRAMES);
+        std::vector<float> dither(NUM_FRAMES);
+        for (int n = 0; n < NUM_FRAMES; n++) {
+            gain[n] = (float)(rand() % 1000) * 30.0f;
+            dither[n] = (float)(rand() % 2001 - 1000) / 1000.0f;
+        }
+        for (auto& x : input) {
+            x = std::min(std::max(x, -1.0f), 1.0f);
+        }
+        std::vector<int16_t> expectedOutput(numSamples);
+        std::vector<int16_t> actualOutput(numSamples);
+        applyGainBlock_ref(input.data(), gain.data(), dither.data(), expectedOutput.data(), NUM_FRAMES, numChannels);
+        applyGainBlock(input.data(), gain.data(), dither.data(), actualOutput.data(), NUM_FRAMES, numChannels);
+        QVERIFY(maxDifference(actualOutput.data(), expectedOutput.data(), numSamples) <= 1);
+
+        std::vector<int32_t> fixedInput(numSamples);
+        std::vector<int32_t> fixedGain(NUM_FRAMES);
+        for (auto& x : fixedInput) {
+            x = (int32_t)randomBits() >> 1;
+        }
+        for (auto& g : fixedGain) {
+            g = (int32_t)(randomBits() & 0x7fffffff);
+        }
+        applyGainQ31Block_ref(fixedInput.data(), fixedGain.data(), expectedOutput.data(), NUM_FRAMES, numChannels);
+        applyGainQ31Block(fixedInput.data(), fixedGain.data(), actualOutput.data(), NUM_FRAMES, numChannels);
+        QVERIFY(actualOutput == expectedOutput);
+    }
+
+    // the whole range, including the edges of each exponent and x <= 0
+    for (int i = 0; i < 1000; i++) {
+        std::vector<int32_t> input(NUM_FRAMES);
+        for (auto& x : input) {
+            x = (int32_t)randomBits() >> (rand() % 31);
+        }
+        input[0] = 0;
+        input[1] = 1;
+        input[2] = -1;
+        input[3] = 0x7fffffff;
+        input[4] = (int32_t)0x80000000;
+        input[5] = 0x3fffffff;
+        input[6] = 0x40000000;
+
+        std::vector<int32_t> expected(NUM_FRAMES);
+        std::vector<int32_t> actual(NUM_FRAMES);
+        fixlog2Block_ref(input.data(), expected.data(), NUM_FRAMES);
+        fixlog2Block(input.data(), actual.data(), NUM_FRAMES);
+        QVERIFY(actual == expected);
+
+        fixexp2Block_ref(input.data(), expected.data(), NUM_FRAMES);
+        fixexp2Block(input.data(), actual.data(), NUM_FRAMES);
+        QVERIFY(actual == expected);
+    }
+}
+
+void AudioDynamicsTests::testLimiterCeiling() {
+    const int NUM_CALLS = 100;
+    const float CEILING = 32768.0f * powf(10.0f, -0.3f / 20.0f);
+
+    // +12dB over full scale
+    for (int numChannels = 1; numChannels <= 4; numChannels *= 2) {
+        AudioLimiter limiter(SAMPLE_RATE, numChannels);
+        std::vector<float> input(FRAMES_PER_CALL * numChannels);
+        std::vector<int16_t> output(FRAMES_PER_CALL * numChannels);
+
+        int peak = 0;
+        for (int call = 0; call < NUM_CALLS; call++) {
+            for (int i = 0; i < FRAMES_PER_CALL; i++) {
+                float x = 4.0f * tone(call * FRAMES_PER_CALL + i);
+                for (int c = 0; c < numChannels; c++) {
+                    input[i * numChannels + c] = (c & 1) ? -x : x;
+                }
+            }
+            limiter.render(input.data(), output.data(), FRAMES_PER_CALL);
+            for (auto sample : output) {
+                peak = std::max(peak, std::abs((int)sample));
+            }
+        }
+
+        // within the dither of the ceiling, and limited rather than clipped
+        QVERIFY(peak <= (int)CEILING + 1);
+        QVERIFY(peak > (int)CEILING - 100);
+    }
+}
+
+void AudioDynamicsTests::testGate() {
+    const int NUM_CALLS = 100;
+    AudioGate gate(SAMPLE_RATE, 2);
+    std::vector<int16_t> samples(FRAMES_PER_CALL * 2);
+
+    // a loud tone passes unchanged
+    for (int call = 0; call < NUM_CALLS; call++) {
+        for (int i = 0; i < FRAMES_PER_CALL; i++) {
+            samples[2 * i + 0] = samples[2 * i + 1] = (int16_t)(16000.0f * tone(call * FRAMES_PER_CALL + i));
+        }
+        gate.render(samples.data(), samples.data(), FRAMES_PER_CALL);
+    }
+    int peak = 0;
+    for (auto sample : samples) {
+        peak = std::max(peak, std::abs((int)sample));
+    }
+    QVERIFY(peak > 15900 && peak <= 16000);
+
+    // low noise is gated off
+    srand(1);
+    for (int call = 0; call < NUM_CALLS; call++) {
+        for (auto& sample : samples) {
+            sample = (int16_t)(rand() % 41 - 20);
+        }
+        gate.render(samples.data(), samples.data(), FRAMES_PER_CALL);
+    }
+    QVERIFY(std::all_of(samples.begin(), samples.end(), [](int16_t sample) { return sample == 0; }));
+}
+
+void AudioDynamicsTests::testReverbConversion() {
+    AudioReverb reverb((float)SAMPLE_RATE);
+    ReverbParameters parameters;
+    reverb.getParameters(&parameters);
+    parameters.wetDryMix = 0.0f;
+    reverb.setParameters(&parameters);
+
+    // with a dry mix, the output is the input through the format conversions
+    srand(1);
+    const int NUM_FRAMES_PER_CALL = 487;
+    std::vector<float> input(NUM_FRAMES_PER_CALL * 2);
+    std::vector<float> output(NUM_FRAMES_PER_CALL * 2);
+    std::vector<int16_t> input16(NUM_FRAMES_PER_CALL * 2);
+    std::vector<int16_t> output16(NUM_FRAMES_PER_CALL * 2);
+    for (int call = 0; call < 10; call++) {
+        for (int i = 0; i < NUM_FRAMES_PER_CALL * 2; i++) {
+            input[i] = (float)(rand() % 20001 - 10000) / 10000.0f;
+            input16[i] = (int16_t)(rand() % 65536 - 32768);
+        }
+        reverb.render(input.data(), output.data(), NUM_FRAMES_PER_CALL);
+        QVERIFY(output == input);
+
+        // within the dither
+        reverb.render(input16.data(), output16.data(), NUM_FRAMES_PER_CALL);
+        QVERIFY(maxDifference(output16.data(), input16.data(), NUM_FRAMES_PER_CALL * 2) <= 1);
+    }
+}
+
+void AudioDynamicsTests::benchmarkDynamics() {
+    const int NUM_CALLS = 10000;
+    const int NUM_SAMPLES = NUM_CALLS * FRAMES_PER_CALL * 2;
+
+    std::vector<float> input(FRAMES_PER_CALL * 2);
+    std::vector<int16_t> input16(FRAMES_PER_CALL * 2);
+    std::vector<int16_t> output16(FRAMES_PER_CALL * 2);
+    for (int i = 0; i < FRAMES_PER_CALL; i++) {
+        input16[2 * i + 0] = input16[2 * i + 1] = (int16_t)(20000.0f * tone(i));
+        input[2 * i + 0] = input[2 * i + 1] = 2.0f * tone(i);
+    }
+
+    QElapsedTimer timer;
+
+    // the mixer's per-listener limiter
+    AudioLimiter limiter(SAMPLE_RATE, 2);
+    timer.start();
+    for (int call = 0; call < NUM_CALLS; call++) {
+        limiter.render(input.data(), output16.data(), FRAMES_PER_CALL);
+    }
+    qDebug() << "AudioLimiter (stereo):" << (double)timer.nsecsElapsed() / NUM_SAMPLES << "ns per sample";
+
+    AudioGate gate(SAMPLE_RATE, 2);
+    timer.start();
+    for (int call = 0; call < NUM_CALLS; call++) {
+        gate.render(input16.data(), output16.data(), FRAMES_PER_CALL);
+    }
+    qDebug() << "AudioGate (stereo):" << (double)timer.nsecsElapsed() / NUM_SAMPLES << "ns per sample";
+
+    AudioReverb reverb((float)SAMPLE_RATE);
+    timer.start();
+    for (int call = 0; call < NUM_CALLS; call++) {
+        reverb.render(input16.data(), output16.data(), FRAMES_PER_CALL);
+    }
+    qDebug() << "AudioReverb (stereo):" << (double)timer.nsecsElapsed() / NUM_SAMPLES << "ns per sample";
+
+    // the stateless stages, vectorized and scalar
+    std::vector<int32_t> peak(DYNAMICS_BLOCK);
+    std::vector<float> gain(DYNAMICS_BLOCK, 8192.0f);
+    std::vector<float> dither(DYNAMICS_BLOCK, 0.0f);
+    const int NUM_BLOCKS = NUM_SAMPLES / (DYNAMICS_BLOCK * 2);
+
+    timer.start();
+    for (int block = 0; block < NUM_BLOCKS; block++) {
+        peaklog2Block(input.data(), peak.data(), DYNAMICS_BLOCK, 2);
+        fixexp2Block(peak.data(), peak.data(), DYNAMICS_BLOCK);
+        applyGainBlock(input.data(), gain.data(), dither.data(), output16.data(), DYNAMICS_BLOCK, 2);
+    }
+    auto dispatchedNsecs = timer.nsecsElapsed();
+
+    timer.start();
+    for (int block = 0; block < NUM_BLOCKS; block++) {
+        peaklog2Block_ref(input.data(), peak.data(), DYNAMICS_BLOCK, 2);
+        fixexp2Block_ref(peak.data(), peak.data(), DYNAMICS_BLOCK);
+        applyGainBlock_ref(input.data(), gain.data(), dither.data(), output16.data(), DYNAMICS_BLOCK, 2);
+    }
+    auto referenceNsecs = timer.nsecsElapsed();
+
+    qDebug() << "Limiter block stages:" << (double)dispatchedNsecs / NUM_SAMPLES << "ns per sample,"
+        << (double)referenceNsecs / NUM_SAMPLES << "ns per sample scalar";
+}
@@ -0,0 +1,26 @@
+//
+//  AudioDynamicsTests.h
+//  tests/audio/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioDynamicsTests_h
+#define hifi_AudioDynamicsTests_h
+
+#include <QtTest/QtTest>
+
+class AudioDynamicsTests : public QObject {
+    Q_OBJECT
+private slots:
+    void testKernelsMatchReference();
+    void testLimiterCeiling();
+    void testGate();
+    void testReverbConversion();
+    void benchmarkDynamics();
+};
+
+#endif // hifi_AudioDynamicsTests_h
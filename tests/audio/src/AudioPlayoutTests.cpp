@@ -0,0 +1,87 @@
+//
+//  AudioPlayoutTests.cpp
+//  tests/audio/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioPlayoutTests.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <AudioPlayout.h>
+#include <test-utils/AudioTestUtils.h>
+
+QTEST_MAIN(AudioPlayoutTests)
+
+static const int FRAME = AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL;
+
+// the largest difference between the samples and the tone from the given start
+static int toneError(const int16_t* samples, int numSamples, int start) {
+    int error = 0;
+    for (int i = 0; i < numSamples; i++) {
+        error = std::max(error, std::abs(samples[i] - tone(start + i)));
+    }
+    return error;
+}
+
+void AudioPlayoutTests::testConcealmentContinuesPitch() {
+    const int HISTORY = 4 * FRAME;
+    auto history = makeTone(0, HISTORY);
+
+    AudioPLC concealment;
+    QVERIFY(!concealment.canConceal());
+    concealment.remember(history.data(), HISTORY);
+    QVERIFY(concealment.canConceal());
+
+    // the first 10ms continue the waveform
+    std::vector<int16_t> concealed(FRAME);
+    concealment.conceal(concealed.data(), FRAME);
+    QVERIFY(concealment.isConcealing());
+    QVERIFY(toneError(concealed.data(), FRAME, HISTORY) <= 2);
+
+    // the audio that arrives next is cross-faded in without a seam
+    auto arrived = makeTone(HISTORY + FRAME, FRAME);
+    concealment.recover(arrived.data(), FRAME);
+    QVERIFY(!concealment.isConcealing());
+    QVERIFY(toneError(arrived.data(), FRAME, HISTORY + FRAME) <= 2);
+
+    // a long gap fades out by 60ms, then stays silent
+    concealment.remember(arrived.data(), FRAME);
+    std::vector<int16_t> gap(6 * FRAME);
+    concealment.conceal(gap.data(), 6 * FRAME);
+    QVERIFY(toneError(gap.data(), FRAME, HISTORY + 2 * FRAME) <= 2);
+    int lastPeak = 0;
+    for (int i = 5 * FRAME; i < 6 * FRAME; i++) {
+        lastPeak = std::max(lastPeak, std::abs((int)gap[i]));
+    }
+    QVERIFY(lastPeak < 3000);
+    QVERIFY(!concealment.canConceal());
+    concealment.conceal(gap.data(), FRAME);
+    QVERIFY(std::all_of(gap.begin(), gap.begin() + FRAME, [](int16_t sample) { return sample == 0; }));
+}
+
+void AudioPlayoutTests::testTimeStretchKeepsPitch() {
+    AudioTimeStretch timeStretch;
+    std::vector<int16_t> output(FRAME + timeStretch.getMaxStretchFrames());
+
+    // a whole period is cut out, so the rest lines up with the start of the block
+    auto block = makeTone(0, FRAME);
+    int compressedFrames = timeStretch.compress(block.data(), FRAME, output.data());
+    QCOMPARE(compressedFrames, FRAME - TONE_PERIOD);
+    QVERIFY(toneError(output.data(), compressedFrames, 0) <= 2);
+
+    // whole periods are repeated from the history before the block
+    const int HISTORY = 2 * FRAME;
+    auto history = makeTone(0, HISTORY);
+    block = makeTone(HISTORY, FRAME);
+    int expandedFrames = timeStretch.expand(history.data(), HISTORY, block.data(), FRAME, output.data());
+    QVERIFY(expandedFrames > FRAME);
+    QCOMPARE((expandedFrames - FRAME) % TONE_PERIOD, 0);
+    QVERIFY(toneError(output.data(), expandedFrames, HISTORY) <= 2);
+}
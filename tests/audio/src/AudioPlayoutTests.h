@@ -0,0 +1,23 @@
+//
+//  AudioPlayoutTests.h
+//  tests/audio/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioPlayoutTests_h
+#define hifi_AudioPlayoutTests_h
+
+#include <QtTest/QtTest>
+
+class AudioPlayoutTests : public QObject {
+    Q_OBJECT
+private slots:
+    void testConcealmentContinuesPitch();
+    void testTimeStretchKeepsPitch();
+};
+
+#endif // hifi_AudioPlayoutTests_h
@@ -0,0 +1,212 @@
+//
+//  AvatarJointCodecTests.cpp
+//  tests/avatars/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AvatarJointCodecTests.h"
+
+#include <AvatarJointCodec.h>
+#include <GLMHelpers.h>
+#include <SharedUtil.h>
+
+QTEST_MAIN(AvatarJointCodecTests)
+
+using namespace AvatarJointCodec;
+
+static const int NUM_JOINTS = 60;
+static const int TRANSLATION_RADIX = 14;
+static const int MAX_BUFFER_SIZE = NUM_JOINTS * 12 + 64;
+
+// A skeleton swaying smoothly, every joint is sent each frame
+struct JointFrame {
+    std::vector<int> joints;
+    std::vector<QuantizedRotation> rotations;
+    std::vector<QuantizedTranslation> translations;
+};
+
+static JointFrame makeFrame(int frame) {
+    JointFrame result;
+    for (int i = 0; i < NUM_JOINTS; i++) {
+        float phase = 0.05f * frame + (float)i;
+        glm::quat rotation = glm::angleAxis(0.5f * sinf(phase), glm::normalize(glm::vec3(1.0f, (float)i, 2.0f)));
+        glm::vec3 translation(0.1f * cosf(phase), 0.2f + 0.01f * i, 0.05f * sinf(phase));
+        result.joints.push_back(i);
+        result.rotations.push_back(quantizeRotation(rotation));
+        result.translations.push_back(quantizeTranslation(translation, TRANSLATION_RADIX));
+    }
+    return result;
+}
+
+// Decodes one encoding, returns the number of joint values that were reconstructed and checks them against the frame
+static int decodeFrame(History& history, const unsigned char* data, int size, const JointFrame& frame) {
+    EncodedJoints encoded;
+    int numJoints = (int)frame.joints.size();
+    if (read(data, size, numJoints, numJoints, encoded) != size) {
+        return -1;
+    }
+    std::vector<uint8_t> validRotations(NUM_JOINTS, 1);
+    std::vector<uint8_t> validTranslations(NUM_JOINTS, 1);
+    std::vector<QuantizedRotation> rotations;
+    std::vector<QuantizedTranslation> translations;
+    decode(history, encoded, validRotations, rotations, validTranslations, translations);
+
+    int numDecoded = 0;
+    size_t rotationIndex = 0;
+    size_t translationIndex = 0;
+    for (int i = 0; i < NUM_JOINTS; i++) {
+        if (validRotations[i]) {
+            if (!(rotations[rotationIndex++] == frame.rotations[i])) {
+                return -1;
+            }
+            numDecoded++;
+        }
+        if (validTranslations[i]) {
+            if (!(translations[translationIndex++] == frame.translations[i])) {
+                return -1;
+            }
+            numDecoded++;
+        }
+    }
+    return numDecoded;
+}
+
+void AvatarJointCodecTests::testRoundTrip() {
+    const int NUM_FRAMES = 100;
+    History sender;
+    History receiver;
+    unsigned char buffer[MAX_BUFFER_SIZE];
+    for (int frame = 0; frame < NUM_FRAMES; frame++) {
+        JointFrame joints = makeFrame(frame);
+        int size = encode(sender, frame == 0, NUM_JOINTS, joints.joints, joints.rotations,
+                          joints.joints, joints.translations, buffer);
+        QVERIFY(size <= (int)(NUM_JOINTS * 12 + maxEncodingOverhead(NUM_JOINTS)));
+        QCOMPARE(decodeFrame(receiver, buffer, size, joints), 2 * NUM_JOINTS);
+    }
+}
+
+void AvatarJointCodecTests::testPacketLoss() {
+    const int NUM_FRAMES = 200;
+    const int LOST_FRAME_INTERVAL = 23;
+    History sender;
+    History receiver;
+    unsigned char buffer[MAX_BUFFER_SIZE];
+    int lastLostFrame = -1;
+    for (int frame = 0; frame < NUM_FRAMES; frame++) {
+        JointFrame joints = makeFrame(frame);
+        int size = encode(sender, frame == 0, NUM_JOINTS, joints.joints, joints.rotations,
+                          joints.joints, joints.translations, buffer);
+        if (frame % LOST_FRAME_INTERVAL == LOST_FRAME_INTERVAL - 1) {
+            lastLostFrame = frame;
+            continue;
+        }
+
+        // joints predicted from the lost values are skipped, never wrong, and every joint is refreshed in time
+        int numDecoded = decodeFrame(receiver, buffer, size, joints);
+        QVERIFY(numDecoded >= 0);
+        if (lastLostFrame < 0 || frame - lastLostFrame > JOINT_REFRESH_INTERVAL) {
+            QCOMPARE(numDecoded, 2 * NUM_JOINTS);
+        }
+    }
+}
+
+void AvatarJointCodecTests::testStalePacket() {
+    const int NUM_FRAMES = 20;
+    const int STALE_FRAME = 5;
+    History sender;
+    History receiver;
+    unsigned char buffer[MAX_BUFFER_SIZE];
+    unsigned char staleBuffer[MAX_BUFFER_SIZE];
+    int staleSize = 0;
+    for (int frame = 0; frame < NUM_FRAMES; frame++) {
+        JointFrame joints = makeFrame(frame);
+        int size = encode(sender, frame == 0, NUM_JOINTS, joints.joints, joints.rotations,
+                          joints.joints, joints.translations, buffer);
+        if (frame == STALE_FRAME) {
+            memcpy(staleBuffer, buffer, size);
+            staleSize = size;
+        }
+        QCOMPARE(decodeFrame(receiver, buffer, size, joints), 2 * NUM_JOINTS);
+
+        // a late duplicate is dropped without losing track of the stream
+        if (frame > STALE_FRAME) {
+            QCOMPARE(decodeFrame(receiver, staleBuffer, staleSize, makeFrame(STALE_FRAME)), 0);
+        }
+    }
+}
+
+void AvatarJointCodecTests::testLongLoss() {
+    const int NUM_FRAMES = 20;
+    const int NUM_LOST_FRAMES = 150;
+    History sender;
+    History receiver;
+    unsigned char buffer[MAX_BUFFER_SIZE];
+    int frame = 0;
+    for (int i = 0; i < NUM_FRAMES; i++, frame++) {
+        JointFrame joints = makeFrame(frame);
+        int size = encode(sender, frame == 0, NUM_JOINTS, joints.joints, joints.rotations,
+                          joints.joints, joints.translations, buffer);
+        QCOMPARE(decodeFrame(receiver, buffer, size, joints), 2 * NUM_JOINTS);
+    }
+
+    // after losing more encodings than the sequence gap, predicted encodings look older than the history
+    for (int i = 0; i < NUM_LOST_FRAMES; i++, frame++) {
+        JointFrame joints = makeFrame(frame);
+        encode(sender, false, NUM_JOINTS, joints.joints, joints.rotations, joints.joints, joints.translations, buffer);
+    }
+    JointFrame joints = makeFrame(frame++);
+    int size = encode(sender, false, NUM_JOINTS, joints.joints, joints.rotations,
+                      joints.joints, joints.translations, buffer);
+    QCOMPARE(decodeFrame(receiver, buffer, size, joints), 0);
+
+    // the next refresh is accepted and the stream continues from it
+    for (int i = 0; i < NUM_FRAMES; i++, frame++) {
+        JointFrame joints = makeFrame(frame);
+        int size = encode(sender, i == 0, NUM_JOINTS, joints.joints, joints.rotations,
+                          joints.joints, joints.translations, buffer);
+        QCOMPARE(decodeFrame(receiver, buffer, size, joints), 2 * NUM_JOINTS);
+    }
+}
+
+void AvatarJointCodecTests::testMalformedData() {
+    JointFrame joints = makeFrame(0);
+    History sender;
+    unsigned char buffer[MAX_BUFFER_SIZE];
+    int size = encode(sender, true, NUM_JOINTS, joints.joints, joints.rotations, joints.joints, joints.translations, buffer);
+
+    EncodedJoints encoded;
+    QCOMPARE(read(buffer, size, NUM_JOINTS, NUM_JOINTS, encoded), size);
+    QCOMPARE(read(buffer, size - 1, NUM_JOINTS, NUM_JOINTS, encoded), -1);
+    QCOMPARE(read(buffer, 1, NUM_JOINTS, NUM_JOINTS, encoded), -1);
+
+    // an invalid prediction, and a Golomb prefix longer than any difference
+    unsigned char junk[16];
+    memset(junk, 0xff, sizeof(junk));
+    QCOMPARE(read(junk, sizeof(junk), 1, 0, encoded), -1);
+    memset(junk, 0, sizeof(junk));
+    junk[2] = 0x40;
+    QCOMPARE(read(junk, sizeof(junk), 1, 0, encoded), -1);
+}
+
+void AvatarJointCodecTests::benchmarkEncodedSize() {
+    const int NUM_FRAMES = 1000;
+    History sender;
+    unsigned char buffer[MAX_BUFFER_SIZE];
+    int64_t encodedBytes = 0;
+    auto start = usecTimestampNow();
+    for (int frame = 0; frame < NUM_FRAMES; frame++) {
+        JointFrame joints = makeFrame(frame);
+        encodedBytes += encode(sender, frame == 0, NUM_JOINTS, joints.joints, joints.rotations,
+                               joints.joints, joints.translations, buffer);
+    }
+    auto usecs = usecTimestampNow() - start;
+
+    int64_t rawBytes = (int64_t)NUM_FRAMES * NUM_JOINTS * 12;
+    qDebug() << "Joint data:" << (float)encodedBytes / NUM_FRAMES << "bytes per frame, six byte encoding"
+        << (float)rawBytes / NUM_FRAMES << "," << (float)usecs / NUM_FRAMES << "usecs per frame";
+    QVERIFY(encodedBytes < rawBytes / 2);
+}
@@ -0,0 +1,27 @@
+//
+//  AvatarJointCodecTests.h
+//  tests/avatars/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AvatarJointCodecTests_h
+#define hifi_AvatarJointCodecTests_h
+
+#include <QtTest/QtTest>
+
+class AvatarJointCodecTests : public QObject {
+    Q_OBJECT
+private slots:
+    void testRoundTrip();
+    void testPacketLoss();
+    void testStalePacket();
+    void testLongLoss();
+    void testMalformedData();
+    void benchmarkEncodedSize();
+};
+
+#endif // hifi_AvatarJointCodecTests_h
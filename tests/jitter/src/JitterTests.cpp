@@ -15,19 +15,127 @@
 #include <sys/socket.h>
 #include <arpa/inet.h>
 #endif
+#include <algorithm>
 #include <cerrno>
+#include <cmath>
 #include <stdio.h>
+#include <vector>
 
-#include <NumericalConstants.h>
+#include <InboundAudioStream.h>
 #include <MovingMinMaxAvg.h>
+#include <NumericalConstants.h>
+#include <ReceivedMessage.h>
 #include <SequenceNumberStats.h>
 #include <SharedUtil.h> // for usecTimestampNow
 #include <SimpleMovingAverage.h>
 #include <StDev.h>
+#include <test-utils/AudioTestUtils.h>
 
 // Uncomment this to run manually
 //#define RUN_MANUALLY
 
+// The playout of an audio stream under simulated network loss and jitter
+
+static const int FRAME = AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL;
+
+struct PlayoutResult {
+    int silentPops { 0 };
+    float averageFramesAvailable { 0.0f };
+    int samplesConcealed { 0 };
+    int compressions { 0 };
+    int expansions { 0 };
+};
+
+// Plays the tone through a mono stream popped every 10ms, the way the mixer does.  Packet i is sent on tick i and
+// received on tick arrivals[i], or never when that is negative; the result covers the ticks from measureFrom on.
+static PlayoutResult simulatePlayout(bool adaptive, const std::vector<int>& arrivals, int measureFrom) {
+    InboundAudioStream stream(AudioConstants::MONO, FRAME, 100, -1);
+    stream.setAdaptivePlayoutEnabled(adaptive);
+
+    PlayoutResult result;
+    int numTicks = (int)arrivals.size();
+    for (int tick = 0; tick < numTicks; tick++) {
+        for (int i = 0; i < numTicks; i++) {
+            if (arrivals[i] != tick) {
+                continue;
+            }
+            quint16 sequence = (quint16)i;
+            uint32_t codecNameLength = 0;
+            auto samples = makeTone(i * FRAME, FRAME);
+            QByteArray data;
+            data.append(reinterpret_cast<const char*>(&sequence), sizeof(sequence));
+            data.append(reinterpret_cast<const char*>(&codecNameLength), sizeof(codecNameLength));
+            data.append(reinterpret_cast<const char*>(samples.data()), FRAME * sizeof(int16_t));
+            ReceivedMessage message(data, PacketType::MixedAudio, versionForPacketType(PacketType::MixedAudio), HifiSockAddr());
+            stream.parseData(message);
+        }
+
+        bool popped = stream.popFrames(1, true) > 0;
+        if (tick < measureFrom) {
+            continue;
+        }
+        bool silent = true;
+        if (popped) {
+            auto output = stream.getLastPopOutput();
+            for (int i = 0; i < FRAME && silent; i++) {
+                silent = output[i] == 0;
+            }
+        }
+        result.silentPops += silent ? 1 : 0;
+        result.averageFramesAvailable += (float)stream.getFramesAvailable() / (float)(numTicks - measureFrom);
+    }
+    result.samplesConcealed = stream.getSamplesConcealed();
+    result.compressions = stream.getTimeStretchCompressions();
+    result.expansions = stream.getTimeStretchExpansions();
+    return result;
+}
+
+void JitterTests::testLossIsConcealed() {
+    const int NUM_PACKETS = 1000;
+    const int LOSS_PERCENT = 5;
+    const int WARMUP_TICKS = 10;
+
+    srand(1);
+    std::vector<int> arrivals(NUM_PACKETS);
+    for (int i = 0; i < NUM_PACKETS; i++) {
+        bool lost = i > WARMUP_TICKS && (rand() % 100) < LOSS_PERCENT;
+        arrivals[i] = lost ? -1 : i;
+    }
+
+    auto plain = simulatePlayout(false, arrivals, WARMUP_TICKS);
+    auto adaptive = simulatePlayout(true, arrivals, WARMUP_TICKS);
+    qDebug() << "5% loss, silent pops:" << plain.silentPops << "without adaptive playout," << adaptive.silentPops << "with;"
+        << adaptive.samplesConcealed << "samples concealed," << adaptive.compressions << "compressions";
+
+    QVERIFY(plain.silentPops > 0);
+    QCOMPARE(adaptive.silentPops, 0);
+}
+
+void JitterTests::testDelaySpikeIsDrained() {
+    const int NUM_PACKETS = 600;
+    const int SPIKE_START = 100;
+    const int SPIKE_FRAMES = 8;
+    const int MEASURE_FROM = 400;
+
+    // an 80ms stall, after which the delayed packets arrive at once
+    std::vector<int> arrivals(NUM_PACKETS);
+    for (int i = 0; i < NUM_PACKETS; i++) {
+        bool delayed = i >= SPIKE_START && i < SPIKE_START + SPIKE_FRAMES;
+        arrivals[i] = delayed ? SPIKE_START + SPIKE_FRAMES : i;
+    }
+
+    auto plain = simulatePlayout(false, arrivals, MEASURE_FROM);
+    auto adaptive = simulatePlayout(true, arrivals, MEASURE_FROM);
+    qDebug() << "80ms delay spike, frames buffered after:" << plain.averageFramesAvailable << "without adaptive playout,"
+        << adaptive.averageFramesAvailable << "with;" << adaptive.compressions << "compressions," << adaptive.expansions
+        << "expansions";
+
+    // without time stretching the stall's latency stays in the buffer for good
+    QVERIFY(plain.averageFramesAvailable > SPIKE_FRAMES - 1);
+    QVERIFY(adaptive.averageFramesAvailable < 4.0f);
+    QCOMPARE(adaptive.silentPops, 0);
+}
+
 #ifndef RUN_MANUALLY
 
 QTEST_MAIN(JitterTests)
@@ -0,0 +1,153 @@
+//
+//  ResourceSchedulingTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ResourceSchedulingTests.h"
+
+#include <cfloat>
+
+#include <DependencyManager.h>
+#include <ResourceCache.h>
+
+QTEST_MAIN(ResourceSchedulingTests)
+
+using PendingRequest = ResourceCacheSharedItems::PendingRequest;
+using PendingRequestHeap = ResourceCacheSharedItems::PendingRequestHeap;
+
+static QSharedPointer<Resource> makeResource(const QString& url) {
+    auto resource = QSharedPointer<Resource>::create(QUrl(url));
+    resource->setSelf(resource);
+    return resource;
+}
+
+static PendingRequest makeRequest(const QSharedPointer<Resource>& resource, float priority, uint64_t sequence) {
+    PendingRequest request;
+    request.resource = resource;
+    request.key = resource.data();
+    request.priority = priority;
+    request.sequence = sequence;
+    return request;
+}
+
+void ResourceSchedulingTests::initTestCase() {
+    DependencyManager::set<ResourceCacheSharedItems>();
+}
+
+void ResourceSchedulingTests::testHeapOrdering() {
+    const float PRIORITIES[] = { 3.0f, 1.0f, 4.0f, 1.0f, 5.0f, 9.0f, 2.0f, 6.0f, 5.0f, 3.0f };
+    const int NUM_REQUESTS = sizeof(PRIORITIES) / sizeof(PRIORITIES[0]);
+
+    QList<QSharedPointer<Resource>> resources;
+    PendingRequestHeap heap;
+    for (int i = 0; i < NUM_REQUESTS; i++) {
+        resources.append(makeResource(QString("http://localhost/%1").arg(i)));
+        heap.push(makeRequest(resources.last(), PRIORITIES[i], i));
+    }
+    QCOMPARE(heap.size(), NUM_REQUESTS);
+
+    // highest priority first, requests of equal priority in the order they were queued
+    auto previous = heap.pop();
+    QCOMPARE(previous.priority, 9.0f);
+    while (!heap.isEmpty()) {
+        auto request = heap.pop();
+        QVERIFY(request.priority < previous.priority ||
+            (request.priority == previous.priority && request.sequence > previous.sequence));
+        previous = request;
+    }
+    QCOMPARE(previous.priority, 1.0f);
+    QCOMPARE(previous.sequence, (uint64_t)3);
+}
+
+void ResourceSchedulingTests::testHeapUpdate() {
+    const int NUM_REQUESTS = 8;
+
+    QList<QSharedPointer<Resource>> resources;
+    PendingRequestHeap heap;
+    for (int i = 0; i < NUM_REQUESTS; i++) {
+        resources.append(makeResource(QString("http://localhost/%1").arg(i)));
+        heap.push(makeRequest(resources.last(), (float)i, i));
+    }
+
+    // raising and lowering a priority moves the request in place
+    heap.update(resources[2].data(), 100.0f);
+    QCOMPARE(heap.top().key, resources[2].data());
+    heap.update(resources[2].data(), -100.0f);
+    QCOMPARE(heap.top().key, resources[7].data());
+
+    // pushing a queued resource again replaces its request instead of duplicating it
+    heap.push(makeRequest(resources[0], 50.0f, NUM_REQUESTS));
+    QCOMPARE(heap.size(), NUM_REQUESTS);
+    QCOMPARE(heap.top().key, resources[0].data());
+    QVERIFY(heap.find(resources[0].data()));
+
+    // a full pass re-reads the priorities and drops the freed resources
+    QObject owner;
+    resources[5]->setLoadPriority(&owner, 10.0f);
+    resources[6].reset();
+    heap.reprioritizeAll();
+    QCOMPARE(heap.size(), NUM_REQUESTS - 1);
+    QCOMPARE(heap.top().key, resources[5].data());
+
+    int popped = 0;
+    float previousPriority = FLT_MAX;
+    while (!heap.isEmpty()) {
+        auto request = heap.pop();
+        QVERIFY(request.resource);
+        QVERIFY(request.priority <= previousPriority);
+        previousPriority = request.priority;
+        popped++;
+    }
+    QCOMPARE(popped, NUM_REQUESTS - 1);
+}
+
+void ResourceSchedulingTests::testRequestLimit() {
+    const uint32_t REQUEST_LIMIT = 4;
+    const int NUM_HTTP_REQUESTS = 6;
+    const int NUM_FILE_REQUESTS = 2;
+
+    auto sharedItems = DependencyManager::get<ResourceCacheSharedItems>();
+    sharedItems->clear();
+    sharedItems->setRequestLimit(REQUEST_LIMIT);
+
+    QList<QSharedPointer<Resource>> httpResources;
+    for (int i = 0; i < NUM_HTTP_REQUESTS; i++) {
+        httpResources.append(makeResource(QString("http://localhost/%1").arg(i)));
+        QCOMPARE(sharedItems->appendRequest(httpResources.last()), (uint32_t)i < REQUEST_LIMIT);
+    }
+
+    // the limit is shared by all the protocols, so the local files wait too
+    QList<QSharedPointer<Resource>> fileResources;
+    for (int i = 0; i < NUM_FILE_REQUESTS; i++) {
+        fileResources.append(makeResource(QString("file:///%1").arg(i)));
+        QVERIFY(!sharedItems->appendRequest(fileResources.last()));
+    }
+    QCOMPARE(sharedItems->getLoadingRequestsCount(), REQUEST_LIMIT);
+    QCOMPARE(sharedItems->getPendingRequestsCount(), (uint32_t)(NUM_HTTP_REQUESTS + NUM_FILE_REQUESTS - REQUEST_LIMIT));
+    QVERIFY(!sharedItems->getHighestPendingRequest());
+
+    // a queued request made again is not queued twice
+    QVERIFY(!sharedItems->appendRequest(httpResources.last()));
+    QCOMPARE(sharedItems->getPendingRequestsCount(), (uint32_t)(NUM_HTTP_REQUESTS + NUM_FILE_REQUESTS - REQUEST_LIMIT));
+
+    // each finished request frees one slot, local files are started first
+    for (int i = 0; i < NUM_FILE_REQUESTS; i++) {
+        sharedItems->removeRequest(httpResources[i]);
+        QCOMPARE(sharedItems->getHighestPendingRequest(), fileResources[i]);
+        QVERIFY(!sharedItems->getHighestPendingRequest());
+        QCOMPARE(sharedItems->getLoadingRequestsCount(), REQUEST_LIMIT);
+    }
+    for (int i = REQUEST_LIMIT; i < NUM_HTTP_REQUESTS; i++) {
+        sharedItems->removeRequest(httpResources[i - REQUEST_LIMIT + NUM_FILE_REQUESTS]);
+        QCOMPARE(sharedItems->getHighestPendingRequest(), httpResources[i]);
+        QCOMPARE(sharedItems->getLoadingRequestsCount(), REQUEST_LIMIT);
+    }
+    QCOMPARE(sharedItems->getPendingRequestsCount(), (uint32_t)0);
+
+    sharedItems->clear();
+}
@@ -0,0 +1,25 @@
+//
+//  ResourceSchedulingTests.h
+//  tests/networking/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ResourceSchedulingTests_h
+#define hifi_ResourceSchedulingTests_h
+
+#include <QtTest/QtTest>
+
+class ResourceSchedulingTests : public QObject {
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void testHeapOrdering();
+    void testHeapUpdate();
+    void testRequestLimit();
+};
+
+#endif // hifi_ResourceSchedulingTests_h
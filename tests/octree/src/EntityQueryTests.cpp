@@ -0,0 +1,199 @@
+//
+//  EntityQueryTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntityQueryTests.h"
+
+#include <AccountManager.h>
+#include <AddressManager.h>
+#include <EntityTree.h>
+#include <NodeList.h>
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+
+QTEST_MAIN(EntityQueryTests)
+
+static const int NUM_BENCHMARK_ENTITIES = 100000;
+static const int NUM_BENCHMARK_NAMES = 1000;
+static const int NUM_BENCHMARK_QUERIES = 100;
+static const float WORLD_HALF_SIZE = 1000.0f;
+static const float QUERY_RADIUS = 500.0f;
+
+static const PickFilter SEARCH_FILTER(PickFilter::getBitMask(PickFilter::FlagBit::DOMAIN_ENTITIES) |
+                                      PickFilter::getBitMask(PickFilter::FlagBit::AVATAR_ENTITIES));
+
+static EntityTypes::EntityType entityType(int i) {
+    // most entities are boxes, a few are text
+    return i % 50 == 0 ? EntityTypes::Text : (i % 5 == 0 ? EntityTypes::Sphere : EntityTypes::Box);
+}
+
+static QString entityName(int i, int numNames) {
+    return QString("Entity %1").arg(i % numNames);
+}
+
+static EntityTreePointer makeTree(int numEntities, int numNames) {
+    auto tree = std::make_shared<EntityTree>();
+    tree->setIsClient(false);
+    tree->createRootElement();
+    srand(1);
+    tree->withWriteLock([&] {
+        for (int i = 0; i < numEntities; i++) {
+            EntityItemProperties properties;
+            properties.setType(entityType(i));
+            properties.setName(entityName(i, numNames));
+            properties.setPosition(glm::vec3(randFloatInRange(-WORLD_HALF_SIZE, WORLD_HALF_SIZE), randFloatInRange(-10.0f, 10.0f),
+                                             randFloatInRange(-WORLD_HALF_SIZE, WORLD_HALF_SIZE)));
+            properties.setDimensions(glm::vec3(randFloatInRange(0.1f, 2.0f)));
+            tree->addEntity(EntityItemID(QUuid::createUuid()), properties);
+        }
+    });
+    return tree;
+}
+
+// The results of a sphere query filtered one entity at a time, as the tree did before it had indexes
+static QSet<QUuid> findInSphere(const EntityTreePointer& tree, const glm::vec3& center, float radius,
+                                std::function<bool(const EntityItemPointer&)> filter) {
+    QVector<QUuid> entities;
+    tree->evalEntitiesInSphere(center, radius, SEARCH_FILTER, entities);
+    QSet<QUuid> found;
+    for (const auto& id : entities) {
+        if (filter(tree->findEntityByID(id))) {
+            found.insert(id);
+        }
+    }
+    return found;
+}
+
+static QSet<QUuid> toSet(const QVector<QUuid>& ids) {
+    QSet<QUuid> set;
+    for (const auto& id : ids) {
+        set.insert(id);
+    }
+    return set;
+}
+
+void EntityQueryTests::initTestCase() {
+    DependencyManager::registerInheritance<LimitedNodeList, NodeList>();
+    DependencyManager::set<AccountManager>();
+    DependencyManager::set<AddressManager>();
+    DependencyManager::set<NodeList>(NodeType::EntityServer);
+}
+
+void EntityQueryTests::testIndexedQueriesMatchTraversal() {
+    const int NUM_NAMES = 100;
+    auto tree = makeTree(5000, NUM_NAMES);
+    const glm::vec3 center(100.0f, 0.0f, -100.0f);
+
+    tree->withReadLock([&] {
+        for (int i = 0; i < 5; i++) {
+            QString name = entityName(i, NUM_NAMES);
+            auto expected = findInSphere(tree, center, QUERY_RADIUS, [&](const EntityItemPointer& entity) {
+                return entity->getName() == name;
+            });
+            QVERIFY(!expected.isEmpty());
+
+            QVector<QUuid> found;
+            tree->evalEntitiesInSphereWithName(center, QUERY_RADIUS, name, true, SEARCH_FILTER, found);
+            QCOMPARE(toSet(found), expected);
+
+            tree->evalEntitiesInSphereWithName(center, QUERY_RADIUS, name.toUpper(), false, SEARCH_FILTER, found);
+            QCOMPARE(toSet(found), expected);
+
+            tree->evalEntitiesInSphereWithName(center, QUERY_RADIUS, name.toUpper(), true, SEARCH_FILTER, found);
+            QVERIFY(found.isEmpty());
+        }
+
+        // the text entities are few enough to be found through the index, the boxes through the tree
+        for (auto type : { EntityTypes::Text, EntityTypes::Box }) {
+            auto expected = findInSphere(tree, center, QUERY_RADIUS, [&](const EntityItemPointer& entity) {
+                return entity->getType() == type;
+            });
+            QVERIFY(!expected.isEmpty());
+
+            QVector<QUuid> found;
+            tree->evalEntitiesInSphereWithType(center, QUERY_RADIUS, type, SEARCH_FILTER, found);
+            QCOMPARE(toSet(found), expected);
+        }
+
+        QVector<QUuid> found;
+        tree->evalEntitiesInSphereWithName(center, QUERY_RADIUS, "No such entity", true, SEARCH_FILTER, found);
+        QVERIFY(found.isEmpty());
+    });
+}
+
+void EntityQueryTests::testIndexUpdates() {
+    auto tree = makeTree(1000, 100);
+    const glm::vec3 center(0.0f);
+    const float radius = 2.0f * WORLD_HALF_SIZE;
+
+    QVector<QUuid> found;
+    tree->withReadLock([&] {
+        tree->evalEntitiesInSphereWithName(center, radius, entityName(1, 100), true, SEARCH_FILTER, found);
+    });
+    QCOMPARE(found.size(), 10);
+
+    // renamed entities move in the index
+    auto renamed = tree->findEntityByID(found[0]);
+    renamed->setName("Renamed");
+    tree->withReadLock([&] {
+        tree->evalEntitiesInSphereWithName(center, radius, "renamed", false, SEARCH_FILTER, found);
+        QCOMPARE(found, QVector<QUuid>({ renamed->getID() }));
+        tree->evalEntitiesInSphereWithName(center, radius, entityName(1, 100), true, SEARCH_FILTER, found);
+        QCOMPARE(found.size(), 9);
+    });
+
+    // deleted entities leave the index
+    tree->withWriteLock([&] {
+        tree->deleteEntity(renamed->getID(), true);
+    });
+    tree->withReadLock([&] {
+        tree->evalEntitiesInSphereWithName(center, radius, "Renamed", true, SEARCH_FILTER, found);
+        QVERIFY(found.isEmpty());
+    });
+}
+
+void EntityQueryTests::benchmarkQueries() {
+    auto start = usecTimestampNow();
+    auto tree = makeTree(NUM_BENCHMARK_ENTITIES, NUM_BENCHMARK_NAMES);
+    qDebug() << "Added" << NUM_BENCHMARK_ENTITIES << "entities in" << (float)(usecTimestampNow() - start) / USECS_PER_MSEC << "ms";
+
+    const glm::vec3 center(0.0f);
+    tree->withReadLock([&] {
+        size_t numTraversalFound = 0;
+        start = usecTimestampNow();
+        for (int i = 0; i < NUM_BENCHMARK_QUERIES; i++) {
+            QString name = entityName(i, NUM_BENCHMARK_NAMES);
+            numTraversalFound += findInSphere(tree, center, QUERY_RADIUS, [&](const EntityItemPointer& entity) {
+                return entity->getName() == name;
+            }).size();
+        }
+        auto traversalUsecs = usecTimestampNow() - start;
+
+        size_t numIndexedFound = 0;
+        start = usecTimestampNow();
+        for (int i = 0; i < NUM_BENCHMARK_QUERIES; i++) {
+            QVector<QUuid> found;
+            tree->evalEntitiesInSphereWithName(center, QUERY_RADIUS, entityName(i, NUM_BENCHMARK_NAMES), true, SEARCH_FILTER, found);
+            numIndexedFound += found.size();
+        }
+        auto indexedUsecs = usecTimestampNow() - start;
+        QCOMPARE(numIndexedFound, numTraversalFound);
+
+        qDebug() << "Find by name through the tree:" << (float)traversalUsecs / NUM_BENCHMARK_QUERIES / USECS_PER_MSEC << "ms per query";
+        qDebug() << "Find by name through the index:" << (float)indexedUsecs / NUM_BENCHMARK_QUERIES / USECS_PER_MSEC << "ms per query";
+
+        start = usecTimestampNow();
+        for (int i = 0; i < NUM_BENCHMARK_QUERIES; i++) {
+            QVector<QUuid> found;
+            tree->evalEntitiesInSphereWithType(center, QUERY_RADIUS, EntityTypes::Text, SEARCH_FILTER, found);
+        }
+        qDebug() << "Find text entities through the index:"
+            << (float)(usecTimestampNow() - start) / NUM_BENCHMARK_QUERIES / USECS_PER_MSEC << "ms per query";
+    });
+}
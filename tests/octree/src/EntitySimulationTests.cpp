@@ -0,0 +1,190 @@
+//
+//  EntitySimulationTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntitySimulationTests.h"
+
+#include <AccountManager.h>
+#include <AddressManager.h>
+#include <EntityTree.h>
+#include <NodeList.h>
+#include <NumericalConstants.h>
+#include <PhysicsHelpers.h>
+#include <SharedUtil.h>
+#include <SimpleEntitySimulation.h>
+#include <test-utils/GLMTestUtils.h>
+
+QTEST_MAIN(EntitySimulationTests)
+
+static const int NUM_BENCHMARK_ENTITIES = 50000;
+static const int NUM_BENCHMARK_FRAMES = 60;
+static const quint64 FRAME_USECS = USECS_PER_SECOND / 60;
+static const float WORLD_HALF_SIZE = 1000.0f;
+
+// A tree of entities that spin, move, accelerate and slow down, simulated by a SimpleEntitySimulation when there is one
+static EntityTreePointer makeTree(int numEntities, bool withSimulation, std::vector<EntityItemPointer>& entities) {
+    auto tree = std::make_shared<EntityTree>();
+    tree->setIsClient(false);
+    tree->createRootElement();
+    if (withSimulation) {
+        SimpleEntitySimulationPointer simulation { new SimpleEntitySimulation() };
+        simulation->setEntityTree(tree);
+        tree->setSimulation(simulation);
+    }
+
+    srand(1);
+    entities.clear();
+    tree->withWriteLock([&] {
+        for (int i = 0; i < numEntities; i++) {
+            EntityItemProperties properties;
+            properties.setType(EntityTypes::Box);
+            properties.setPosition(glm::vec3(randFloatInRange(-WORLD_HALF_SIZE, WORLD_HALF_SIZE), randFloatInRange(-10.0f, 10.0f),
+                                             randFloatInRange(-WORLD_HALF_SIZE, WORLD_HALF_SIZE)));
+            properties.setDimensions(glm::vec3(randFloatInRange(0.1f, 2.0f)));
+            if (i % 3 != 0) {
+                properties.setVelocity(randVector() * randFloatInRange(0.1f, 2.0f));
+            }
+            if (i % 3 != 1) {
+                properties.setAngularVelocity(randVector() * randFloatInRange(0.1f, 3.0f));
+            }
+            if (i % 5 == 0) {
+                properties.setDamping(0.5f);
+                properties.setAngularDamping(0.5f);
+            }
+            if (i % 7 == 0) {
+                properties.setAcceleration(glm::vec3(0.0f, -1.0f, 0.0f));
+            }
+            entities.push_back(tree->addEntity(EntityItemID(QUuid::createUuid()), properties));
+        }
+    });
+    return tree;
+}
+
+void EntitySimulationTests::initTestCase() {
+    DependencyManager::registerInheritance<LimitedNodeList, NodeList>();
+    DependencyManager::set<AccountManager>();
+    DependencyManager::set<AddressManager>();
+    DependencyManager::set<NodeList>(NodeType::EntityServer);
+}
+
+void EntitySimulationTests::testParallelKinematicsMatchSerial() {
+    const int NUM_ENTITIES = 5000;
+    std::vector<EntityItemPointer> parallelEntities;
+    auto parallelTree = makeTree(NUM_ENTITIES, true, parallelEntities);
+    std::vector<EntityItemPointer> serialEntities;
+    auto serialTree = makeTree(NUM_ENTITIES, false, serialEntities);
+
+    quint64 now = usecTimestampNow();
+    for (int i = 0; i < NUM_ENTITIES; i++) {
+        parallelEntities[i]->setLastSimulated(now);
+        serialEntities[i]->setLastSimulated(now);
+    }
+
+    for (int frame = 0; frame < 10; frame++) {
+        now += FRAME_USECS;
+        parallelTree->withWriteLock([&] {
+            parallelTree->getSimulation()->moveSimpleKinematics(now);
+        });
+        for (auto& entity : serialEntities) {
+            entity->simulate(now);
+        }
+    }
+
+    // the batch runs the same arithmetic as EntityItem::simulate, so the results are identical
+    for (int i = 0; i < NUM_ENTITIES; i++) {
+        QCOMPARE(parallelEntities[i]->getLocalPosition(), serialEntities[i]->getLocalPosition());
+        QVERIFY(parallelEntities[i]->getLocalOrientation() == serialEntities[i]->getLocalOrientation());
+        QCOMPARE(parallelEntities[i]->getLocalVelocity(), serialEntities[i]->getLocalVelocity());
+        QCOMPARE(parallelEntities[i]->getLocalAngularVelocity(), serialEntities[i]->getLocalAngularVelocity());
+        QCOMPARE(parallelEntities[i]->getLastSimulated(), now);
+    }
+}
+
+void EntitySimulationTests::testStoppedEntitiesLeaveKinematics() {
+    std::vector<EntityItemPointer> entities;
+    auto tree = makeTree(0, true, entities);
+    auto simulation = tree->getSimulation();
+
+    EntityItemPointer entity;
+    tree->withWriteLock([&] {
+        EntityItemProperties properties;
+        properties.setType(EntityTypes::Box);
+        properties.setVelocity(glm::vec3(0.0f, 0.0f, 0.5f * KINEMATIC_LINEAR_SPEED_THRESHOLD));
+        entity = tree->addEntity(EntityItemID(QUuid::createUuid()), properties);
+    });
+    QVERIFY(entity->isMovingRelativeToParent());
+
+    quint64 now = usecTimestampNow();
+    entity->setLastSimulated(now);
+    glm::vec3 position = entity->getLocalPosition();
+    tree->withWriteLock([&] {
+        // too slow to keep moving: the first step stops it, the second drops it from the kinematic entities
+        simulation->moveSimpleKinematics(now + FRAME_USECS);
+        QVERIFY(!entity->isMovingRelativeToParent());
+        QCOMPARE(entity->getLocalPosition(), position);
+        simulation->moveSimpleKinematics(now + 2 * FRAME_USECS);
+
+        // a velocity set behind the simulation's back is not integrated
+        entity->setLocalVelocity(glm::vec3(1.0f, 0.0f, 0.0f));
+        simulation->moveSimpleKinematics(now + 3 * FRAME_USECS);
+        QCOMPARE(entity->getLocalPosition(), position);
+        QCOMPARE(entity->getLastSimulated(), now + FRAME_USECS);
+    });
+}
+
+void EntitySimulationTests::benchmarkKinematics() {
+    std::vector<EntityItemPointer> entities;
+    auto start = usecTimestampNow();
+    auto tree = makeTree(NUM_BENCHMARK_ENTITIES, true, entities);
+    qDebug() << "Added" << NUM_BENCHMARK_ENTITIES << "kinematic entities in" << (float)(usecTimestampNow() - start) / USECS_PER_MSEC << "ms";
+    auto simulation = tree->getSimulation();
+
+    quint64 now = usecTimestampNow();
+    for (auto& entity : entities) {
+        entity->setLastSimulated(now);
+    }
+
+    // the serial step the simulation used to take, entity by entity
+    start = usecTimestampNow();
+    for (int frame = 0; frame < NUM_BENCHMARK_FRAMES; frame++) {
+        now += FRAME_USECS;
+        tree->withWriteLock([&] {
+            for (auto& entity : entities) {
+                entity->simulate(now);
+            }
+        });
+    }
+    auto serialUsecs = usecTimestampNow() - start;
+
+    start = usecTimestampNow();
+    for (int frame = 0; frame < NUM_BENCHMARK_FRAMES; frame++) {
+        now += FRAME_USECS;
+        tree->withWriteLock([&] {
+            simulation->moveSimpleKinematics(now);
+        });
+    }
+    auto parallelUsecs = usecTimestampNow() - start;
+
+    // a full update, including the resort of the tree, runs on the real clock
+    now = usecTimestampNow();
+    for (auto& entity : entities) {
+        entity->setLastSimulated(now);
+    }
+    start = usecTimestampNow();
+    for (int frame = 0; frame < NUM_BENCHMARK_FRAMES; frame++) {
+        tree->withWriteLock([&] {
+            simulation->updateEntities();
+        });
+    }
+    auto updateUsecs = usecTimestampNow() - start;
+
+    qDebug() << "Serial kinematic step:" << (float)serialUsecs / NUM_BENCHMARK_FRAMES / USECS_PER_MSEC << "ms per frame";
+    qDebug() << "Batched kinematic step:" << (float)parallelUsecs / NUM_BENCHMARK_FRAMES / USECS_PER_MSEC << "ms per frame";
+    qDebug() << "Full simulation update:" << (float)updateUsecs / NUM_BENCHMARK_FRAMES / USECS_PER_MSEC << "ms per frame";
+}
@@ -0,0 +1,25 @@
+//
+//  EntitySimulationTests.h
+//  tests/octree/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntitySimulationTests_h
+#define hifi_EntitySimulationTests_h
+
+#include <QtTest/QtTest>
+
+class EntitySimulationTests : public QObject {
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void testParallelKinematicsMatchSerial();
+    void testStoppedEntitiesLeaveKinematics();
+    void benchmarkKinematics();
+};
+
+#endif // hifi_EntitySimulationTests_h
@@ -0,0 +1,268 @@
+//
+//  OctreeStorageTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "OctreeStorageTests.h"
+
+#include <thread>
+
+#include <AccountManager.h>
+#include <AddressManager.h>
+#include <EntityTree.h>
+#include <NodeList.h>
+#include <NumericalConstants.h>
+#include <OctalCode.h>
+#include <OctreeElementPool.h>
+#include <SharedUtil.h>
+
+QTEST_MAIN(OctreeStorageTests)
+
+static const int NUM_BENCHMARK_LEAVES = 200000;
+static const int NUM_BENCHMARK_TRAVERSALS = 10;
+static const float WORLD_HALF_SIZE = 1000.0f;
+static const float LEAF_SCALE = 0.5f;
+
+class CountElementsOperator : public RecurseOctreeOperator {
+public:
+    virtual bool preRecursion(const OctreeElementPointer& element) override { ++count; return true; }
+    virtual bool postRecursion(const OctreeElementPointer& element) override { return true; }
+    int count { 0 };
+};
+
+static bool countElementsOperation(const OctreeElementPointer& element, void* extraData) {
+    ++*static_cast<int*>(extraData);
+    return true;
+}
+
+static float noSortingOperation(const OctreeElementPointer& element, void* extraData) {
+    return 0.0f;
+}
+
+static EntityTreePointer makeTree(int numLeaves) {
+    auto tree = std::make_shared<EntityTree>();
+    tree->createRootElement();
+    srand(1);
+    tree->withWriteLock([&] {
+        for (int i = 0; i < numLeaves; i++) {
+            tree->getOrCreateChildElementAt(randFloatInRange(-WORLD_HALF_SIZE, WORLD_HALF_SIZE), randFloatInRange(-10.0f, 10.0f),
+                                            randFloatInRange(-WORLD_HALF_SIZE, WORLD_HALF_SIZE), LEAF_SCALE);
+        }
+    });
+    return tree;
+}
+
+void OctreeStorageTests::initTestCase() {
+    DependencyManager::registerInheritance<LimitedNodeList, NodeList>();
+    DependencyManager::set<AccountManager>();
+    DependencyManager::set<AddressManager>();
+    DependencyManager::set<NodeList>(NodeType::EntityServer);
+}
+
+void OctreeStorageTests::testChildStorage() {
+    auto tree = std::make_shared<EntityTree>();
+    tree->createRootElement();
+    auto root = tree->getRoot();
+    auto numBlocks = OctreeElement::getExternalChildrenCount();
+
+    // the children of an element share one block, which only exists while it has children
+    for (int i = 0; i < NUMBER_OF_CHILDREN; i += 2) {
+        auto child = root->addChildAtIndex(i);
+        QVERIFY(child);
+        QCOMPARE(root->getChildAtIndex(i), child);
+        QCOMPARE(root->getChildRefAtIndex(i), child);
+        QCOMPARE(OctreeElement::getExternalChildrenCount(), numBlocks + 1);
+    }
+    QCOMPARE(root->getChildCount(), NUMBER_OF_CHILDREN / 2);
+    for (int i = 1; i < NUMBER_OF_CHILDREN; i += 2) {
+        QVERIFY(!root->getChildAtIndex(i));
+        QVERIFY(!root->getChildRefAtIndex(i));
+    }
+
+    // grandchildren get their own block
+    root->getChildAtIndex(0)->addChildAtIndex(3);
+    QCOMPARE(OctreeElement::getExternalChildrenCount(), numBlocks + 2);
+
+    auto removed = root->removeChildAtIndex(2);
+    QVERIFY(removed);
+    QVERIFY(!root->getChildAtIndex(2));
+    QCOMPARE(root->getChildCount(), NUMBER_OF_CHILDREN / 2 - 1);
+
+    for (int i = 0; i < NUMBER_OF_CHILDREN; i++) {
+        root->deleteChildAtIndex(i);
+    }
+    QVERIFY(root->isLeaf());
+    QCOMPARE(OctreeElement::getExternalChildrenCount(), numBlocks);
+}
+
+void OctreeStorageTests::testTraversalsVisitAllElements() {
+    auto tree = makeTree(5000);
+    tree->withReadLock([&] {
+        int numElements = 0;
+        tree->recurseTreeWithOperation(countElementsOperation, &numElements);
+        QVERIFY(numElements > 5000);
+
+        int numSortedElements = 0;
+        tree->recurseTreeWithOperationSorted(countElementsOperation, noSortingOperation, &numSortedElements);
+        QCOMPARE(numSortedElements, numElements);
+
+        CountElementsOperator countOperator;
+        tree->recurseTreeWithOperator(&countOperator);
+        QCOMPARE(countOperator.count, numElements);
+    });
+}
+
+// the rebuilt octal codes of the children are the code of their parent with one more branch
+static bool checkOctalCodesOperation(const OctreeElementPointer& element, void* extraData) {
+    auto& numMismatches = *static_cast<int*>(extraData);
+    unsigned char* octalCode = element->createOctalCode();
+    if (numberOfThreeBitSectionsInCode(octalCode) != element->getOctalCodeSections()) {
+        ++numMismatches;
+    }
+
+    glm::vec3 corner;
+    copyFirstVertexForCode(octalCode, (float*)&corner);
+    if (corner * (float)TREE_SCALE - (float)HALF_TREE_SCALE != element->getCorner()) {
+        ++numMismatches;
+    }
+
+    for (int i = 0; i < NUMBER_OF_CHILDREN; i++) {
+        const auto& child = element->getChildRefAtIndex(i);
+        if (child) {
+            unsigned char* expectedCode = childOctalCode(octalCode, i);
+            unsigned char* childCode = child->createOctalCode();
+            if (memcmp(childCode, expectedCode, bytesRequiredForCodeLength(*expectedCode)) != 0) {
+                ++numMismatches;
+            }
+            delete[] childCode;
+            delete[] expectedCode;
+        }
+    }
+    delete[] octalCode;
+    return true;
+}
+
+void OctreeStorageTests::testImplicitOctalCodes() {
+    auto tree = makeTree(5000);
+    tree->withReadLock([&] {
+        int numMismatches = 0;
+        tree->recurseTreeWithOperation(checkOctalCodesOperation, &numMismatches);
+        QCOMPARE(numMismatches, 0);
+    });
+}
+
+void OctreeStorageTests::testDeepOctalCodes() {
+    const int NUM_PATHS = 1000;
+
+    // random paths down to the deepest elements the tree creates, where the float cube can't tell the branches apart
+    auto tree = std::make_shared<EntityTree>();
+    tree->createRootElement();
+    srand(1);
+    int numMismatches = 0;
+    tree->withWriteLock([&] {
+        for (int path = 0; path < NUM_PATHS; path++) {
+            OctreeElementPointer element = tree->getRoot();
+            unsigned char* expectedCode = new unsigned char[1] { 0 };
+            while (element->getScale() > SMALLEST_REASONABLE_OCTREE_ELEMENT_SCALE) {
+                int childIndex = rand() % NUMBER_OF_CHILDREN;
+                element = element->addChildAtIndex(childIndex);
+                unsigned char* childCode = childOctalCode(expectedCode, childIndex);
+                delete[] expectedCode;
+                expectedCode = childCode;
+
+                unsigned char* octalCode = element->createOctalCode();
+                if (memcmp(octalCode, expectedCode, bytesRequiredForCodeLength(*expectedCode)) != 0) {
+                    ++numMismatches;
+                }
+                delete[] octalCode;
+            }
+            QVERIFY(element->getOctalCodeSections() >= 24);
+            delete[] expectedCode;
+        }
+    });
+    QCOMPARE(numMismatches, 0);
+}
+
+void OctreeStorageTests::testBlockPoolFreesSlabs() {
+    // a block size used by nothing else, so the pool starts empty
+    const size_t BLOCK_SIZE = 1000;
+    const size_t NUM_BLOCKS = 4 * OctreeBlockPool::DEFAULT_BLOCKS_PER_SLAB;
+    auto& pool = OctreeBlockPool::forSize<BLOCK_SIZE>();
+
+    std::vector<void*> blocks;
+    for (size_t i = 0; i < NUM_BLOCKS; i++) {
+        blocks.push_back(OctreeBlockPool::allocate<BLOCK_SIZE>());
+    }
+    QVERIFY(pool.getNumSlabs() >= 4);
+    QVERIFY(pool.getAllocatedBlocks() >= NUM_BLOCKS);
+
+    // blocks freed by another thread go back to the pool when it ends
+    std::thread releasingThread([&] {
+        for (size_t i = 0; i < NUM_BLOCKS / 2; i++) {
+            OctreeBlockPool::deallocate<BLOCK_SIZE>(blocks[i]);
+        }
+    });
+    releasingThread.join();
+    for (size_t i = NUM_BLOCKS / 2; i < NUM_BLOCKS; i++) {
+        OctreeBlockPool::deallocate<BLOCK_SIZE>(blocks[i]);
+    }
+    OctreeBlockPool::flushThreadCache<BLOCK_SIZE>();
+
+    // only one empty slab is kept
+    QCOMPARE(pool.getAllocatedBlocks(), (size_t)0);
+    QVERIFY(pool.getNumSlabs() <= 1);
+
+    // the children blocks of a cleared tree don't keep their slabs
+    const size_t CHILDREN_BLOCK_SIZE = sizeof(OctreeElementPointer) * NUMBER_OF_CHILDREN;
+    auto& childrenPool = OctreeBlockPool::forSize<CHILDREN_BLOCK_SIZE>();
+    OctreeBlockPool::flushThreadCache<CHILDREN_BLOCK_SIZE>();
+    auto numSlabs = childrenPool.getNumSlabs();
+    auto tree = makeTree(5000);
+    QVERIFY(childrenPool.getNumSlabs() > numSlabs);
+    tree.reset();
+    OctreeBlockPool::flushThreadCache<CHILDREN_BLOCK_SIZE>();
+    QVERIFY(childrenPool.getNumSlabs() <= std::max(numSlabs, (size_t)1));
+}
+
+void OctreeStorageTests::benchmarkLargeTree() {
+    auto memoryBefore = OctreeElement::getTotalMemoryUsage();
+    auto start = usecTimestampNow();
+    auto tree = makeTree(NUM_BENCHMARK_LEAVES);
+    auto usecs = usecTimestampNow() - start;
+
+    int numElements = 0;
+    tree->recurseTreeWithOperation(countElementsOperation, &numElements);
+    qDebug() << "Built" << numElements << "elements in" << (float)usecs / USECS_PER_MSEC << "ms,"
+        << (OctreeElement::getTotalMemoryUsage() - memoryBefore) / numElements << "bytes per element,"
+        << OctreeElement::getExternalChildrenCount() << "child blocks";
+
+    tree->withReadLock([&] {
+        start = usecTimestampNow();
+        for (int i = 0; i < NUM_BENCHMARK_TRAVERSALS; i++) {
+            int count = 0;
+            tree->recurseTreeWithOperation(countElementsOperation, &count);
+            QCOMPARE(count, numElements);
+        }
+        usecs = usecTimestampNow() - start;
+        qDebug() << "Operation traversal:" << (float)usecs / NUM_BENCHMARK_TRAVERSALS / USECS_PER_MSEC << "ms";
+
+        start = usecTimestampNow();
+        for (int i = 0; i < NUM_BENCHMARK_TRAVERSALS; i++) {
+            CountElementsOperator countOperator;
+            tree->recurseTreeWithOperator(&countOperator);
+            QCOMPARE(countOperator.count, numElements);
+        }
+        usecs = usecTimestampNow() - start;
+        qDebug() << "Operator traversal:" << (float)usecs / NUM_BENCHMARK_TRAVERSALS / USECS_PER_MSEC << "ms";
+    });
+
+    start = usecTimestampNow();
+    tree.reset();
+    usecs = usecTimestampNow() - start;
+    qDebug() << "Destroyed tree in" << (float)usecs / USECS_PER_MSEC << "ms";
+}
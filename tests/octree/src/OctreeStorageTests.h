@@ -0,0 +1,28 @@
+//
+//  OctreeStorageTests.h
+//  tests/octree/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OctreeStorageTests_h
+#define hifi_OctreeStorageTests_h
+
+#include <QtTest/QtTest>
+
+class OctreeStorageTests : public QObject {
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void testChildStorage();
+    void testTraversalsVisitAllElements();
+    void testImplicitOctalCodes();
+    void testDeepOctalCodes();
+    void testBlockPoolFreesSlabs();
+    void benchmarkLargeTree();
+};
+
+#endif // hifi_OctreeStorageTests_h
@@ -0,0 +1,160 @@
+//
+//  PickBatchingTests.cpp
+//  tests/pointers/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "PickBatchingTests.h"
+
+#include <atomic>
+#include <cfloat>
+
+#include <DependencyManager.h>
+#include <PickManager.h>
+
+QTEST_MAIN(PickBatchingTests)
+
+static const QUuid IGNORED_ENTITY_ID = QUuid::createUuid();
+
+class TestPickResult : public PickResult {
+public:
+    TestPickResult(const QVariantMap& pickVariant) : PickResult(pickVariant) {}
+    TestPickResult(IntersectionType type, float distance) : type(type), distance(distance) {}
+
+    bool doesIntersect() const override { return type != NONE; }
+
+    PickResultPointer compareAndProcessNewResult(const PickResultPointer& newRes) override {
+        auto newTestRes = std::static_pointer_cast<TestPickResult>(newRes);
+        if (newTestRes->distance < distance) {
+            return std::make_shared<TestPickResult>(*newTestRes);
+        }
+        return std::make_shared<TestPickResult>(*this);
+    }
+
+    bool checkOrFilterAgainstMaxDistance(float maxDistance) override { return distance < maxDistance; }
+
+    IntersectionType type { NONE };
+    float distance { FLT_MAX };
+};
+
+// Intersects a made up scene: each target is hit at a distance that depends on the origin of the ray
+class TestPick : public Pick<PickRay> {
+public:
+    TestPick(const PickRay& mathPick, const PickFilter& filter, float maxDistance, bool enabled) :
+        Pick<PickRay>(mathPick, filter, maxDistance, enabled) {}
+
+    PickRay getMathematicalPick() const override { return _mathPick; }
+    PickResultPointer getDefaultResult(const QVariantMap& pickVariant) const override {
+        return std::make_shared<TestPickResult>(pickVariant);
+    }
+
+    PickResultPointer getEntityIntersection(const PickRay& pick) override {
+        numIntersections++;
+        if (getIgnoreItems().contains(IGNORED_ENTITY_ID) || pick.origin.x < 0.0f) {
+            return std::make_shared<TestPickResult>(pick.toVariantMap());
+        }
+        return std::make_shared<TestPickResult>(ENTITY, 1.0f + pick.origin.x);
+    }
+    PickResultPointer getOverlayIntersection(const PickRay& pick) override {
+        numIntersections++;
+        if (pick.origin.y < 0.0f) {
+            return std::make_shared<TestPickResult>(pick.toVariantMap());
+        }
+        return std::make_shared<TestPickResult>(OVERLAY, 2.0f + pick.origin.y);
+    }
+    PickResultPointer getAvatarIntersection(const PickRay& pick) override {
+        numIntersections++;
+        return std::make_shared<TestPickResult>(AVATAR, 3.0f + pick.origin.z);
+    }
+    PickResultPointer getHUDIntersection(const PickRay& pick) override {
+        numIntersections++;
+        return std::make_shared<TestPickResult>(HUD, 4.0f);
+    }
+
+    bool canIntersectEntitiesOffMainThread() const override { return true; }
+    Transform getResultTransform() const override { return Transform(); }
+
+    static std::atomic<int> numIntersections;
+};
+
+std::atomic<int> TestPick::numIntersections { 0 };
+
+void PickBatchingTests::initTestCase() {
+    DependencyManager::set<PickManager>();
+}
+
+void PickBatchingTests::cleanupTestCase() {
+    DependencyManager::destroy<PickManager>();
+}
+
+void PickBatchingTests::testBatchedMatchesSerial() {
+    auto pickManager = DependencyManager::get<PickManager>();
+    pickManager->setShouldPickHUDOperator([] { return true; });
+    // the serial path must get to every pick in one update
+    pickManager->setPerFrameTimeBudget(10 * USECS_PER_SECOND);
+
+    const PickFilter::Flags FILTERS[] = {
+        PickFilter::Flags(),
+        PickFilter::getBitMask(PickFilter::DOMAIN_ENTITIES),
+        PickFilter::getBitMask(PickFilter::LOCAL_ENTITIES),
+        PickFilter::getBitMask(PickFilter::DOMAIN_ENTITIES) | PickFilter::getBitMask(PickFilter::AVATARS),
+        PickFilter::getBitMask(PickFilter::HUD),
+    };
+    const int NUM_FILTERS = sizeof(FILTERS) / sizeof(FILTERS[0]);
+    const int NUM_ORIGINS = 4;
+    const float MAX_DISTANCES[] = { 0.0f, 2.5f, -1.0f };
+
+    // several picks share a ray and a filter, so the batched path shares their intersections
+    std::vector<unsigned int> pickIDs;
+    std::vector<std::shared_ptr<TestPick>> picks;
+    for (int i = 0; i < 60; i++) {
+        glm::vec3 origin((float)(i % NUM_ORIGINS) - 1.0f, (float)(i % 3) - 1.0f, (float)(i % 2));
+        PickRay ray(origin, glm::vec3(0.0f, 0.0f, -1.0f));
+        float maxDistance = MAX_DISTANCES[(i / 7) % 3];
+        auto pick = std::make_shared<TestPick>(ray, PickFilter(FILTERS[i % NUM_FILTERS]), maxDistance, i % 11 != 0);
+        if (i % 5 == 1) {
+            pick->setIgnoreItems({ IGNORED_ENTITY_ID });
+        }
+        pickIDs.push_back(pickManager->addPick(PickQuery::Ray, pick));
+        picks.push_back(pick);
+    }
+
+    pickManager->setBatchedPicking(false);
+    pickManager->update();
+    std::vector<TestPickResult> serialResults;
+    for (auto id : pickIDs) {
+        serialResults.push_back(*pickManager->getPrevPickResultTyped<TestPickResult>(id));
+    }
+    int serialIntersections = TestPick::numIntersections;
+
+    // forget the serial results, so the ones checked below come from the batched path
+    for (auto& pick : picks) {
+        pick->setPickResult(pick->getDefaultResult(QVariantMap()));
+    }
+    TestPick::numIntersections = 0;
+    pickManager->setBatchedPicking(true);
+    pickManager->update();
+    pickManager->waitForPickJobs();
+
+    // shared intersections are computed once, like the cache of the serial path
+    QCOMPARE((int)TestPick::numIntersections, serialIntersections);
+
+    // the entity intersections of the workers are published by the next update
+    pickManager->update();
+    for (size_t i = 0; i < pickIDs.size(); i++) {
+        auto result = pickManager->getPrevPickResultTyped<TestPickResult>(pickIDs[i]);
+        QVERIFY(result);
+        QCOMPARE(result->type, serialResults[i].type);
+        QCOMPARE(result->distance, serialResults[i].distance);
+    }
+    pickManager->waitForPickJobs();
+
+    for (auto id : pickIDs) {
+        pickManager->removePick(id);
+    }
+    pickManager->setBatchedPicking(false);
+}
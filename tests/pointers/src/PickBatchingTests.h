@@ -0,0 +1,24 @@
+//
+//  PickBatchingTests.h
+//  tests/pointers/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_PickBatchingTests_h
+#define hifi_PickBatchingTests_h
+
+#include <QtTest/QtTest>
+
+class PickBatchingTests : public QObject {
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void testBatchedMatchesSerial();
+    void cleanupTestCase();
+};
+
+#endif // hifi_PickBatchingTests_h
@@ -0,0 +1,150 @@
+//
+//  AvatarFrameBenchmark.cpp
+//  tests/recording/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AvatarFrameBenchmark.h"
+
+#include <QtTest/QtTest>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QJsonDocument>
+
+#include <AvatarData.h>
+#include <GLMHelpers.h>
+
+static const int NUM_JOINTS = 72;
+static const int NUM_FRAMES = 60 * 60; // one minute of 60Hz avatar frames
+static const float FRAME_RATE = 60.0f;
+static const float ROTATION_TOLERANCE = 0.0001f;
+static const float TRANSLATION_TOLERANCE = 2.0f / 4096.0f;
+
+// Fingers and face joints are mostly left at their default pose in real recordings, the rest of the
+// skeleton moves every frame.
+static QVector<JointData> animatedJoints(int frame) {
+    float time = (float)frame / FRAME_RATE;
+    QVector<JointData> joints(NUM_JOINTS);
+    for (int i = 0; i < NUM_JOINTS; i++) {
+        JointData& joint = joints[i];
+        bool isStatic = (i % 5) == 4;
+        joint.rotationIsDefaultPose = isStatic;
+        joint.translationIsDefaultPose = i > 1;
+        glm::vec3 axis = glm::normalize(glm::vec3(1.0f, (float)(i % 3), (float)(i % 7) + 1.0f));
+        joint.rotation = glm::angleAxis(0.5f * sinf(time * (1.0f + 0.1f * i)), axis);
+        joint.translation = glm::vec3(0.1f * sinf(time), 1.0f + 0.05f * cosf(time * 2.0f), 0.1f * i / NUM_JOINTS);
+    }
+    return joints;
+}
+
+static void recordFrames(QVector<QByteArray>& jsonFrames, QVector<QByteArray>& compactFrames) {
+    AvatarData avatar;
+    avatar.setRecordingBasis();
+    AvatarFrameCodec::EncoderState encoder;
+    for (int frame = 0; frame < NUM_FRAMES; frame++) {
+        avatar.setWorldPosition(glm::vec3(0.01f * frame, 0.0f, 0.0f));
+        avatar.setRawJointData(animatedJoints(frame));
+        jsonFrames.push_back(QJsonDocument(avatar.toJson()).toBinaryData());
+        compactFrames.push_back(AvatarData::toFrame(avatar, encoder));
+    }
+}
+
+static bool jointsMatch(const QVector<JointData>& expected, const QVector<JointData>& actual) {
+    if (expected.size() != actual.size()) {
+        return false;
+    }
+    for (int i = 0; i < expected.size(); i++) {
+        if (expected[i].rotationIsDefaultPose != actual[i].rotationIsDefaultPose ||
+            expected[i].translationIsDefaultPose != actual[i].translationIsDefaultPose) {
+            return false;
+        }
+        if (!expected[i].rotationIsDefaultPose &&
+            fabsf(glm::dot(expected[i].rotation, actual[i].rotation)) < 1.0f - ROTATION_TOLERANCE) {
+            return false;
+        }
+        if (!expected[i].translationIsDefaultPose &&
+            glm::distance(expected[i].translation, actual[i].translation) > TRANSLATION_TOLERANCE) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void testAvatarFrameRoundTrip() {
+    QVector<QByteArray> jsonFrames;
+    QVector<QByteArray> compactFrames;
+    recordFrames(jsonFrames, compactFrames);
+
+    AvatarData player;
+    for (int frame = 0; frame < NUM_FRAMES; frame++) {
+        AvatarData::fromFrame(compactFrames[frame], player);
+        QVERIFY(jointsMatch(animatedJoints(frame), player.getRawJointData()));
+    }
+
+    // legacy frames still load
+    AvatarData legacyPlayer;
+    AvatarData::fromFrame(jsonFrames.last(), legacyPlayer);
+    QVERIFY(jointsMatch(animatedJoints(NUM_FRAMES - 1), legacyPlayer.getRawJointData()));
+}
+
+void testAvatarFrameSeek() {
+    QVector<QByteArray> jsonFrames;
+    QVector<QByteArray> compactFrames;
+    recordFrames(jsonFrames, compactFrames);
+
+    // start playback half way between two keyframes, the exact pose must be back by the next keyframe
+    const int interval = (int)AvatarFrameCodec::DEFAULT_KEYFRAME_INTERVAL;
+    const int seekFrame = interval + interval / 2;
+    AvatarData player;
+    for (int frame = seekFrame; frame <= 2 * interval; frame++) {
+        AvatarData::fromFrame(compactFrames[frame], player);
+    }
+    QVERIFY(jointsMatch(animatedJoints(2 * interval), player.getRawJointData()));
+
+    // blendshapes from after the keyframe are cleared by seeking back to it
+    const int NUM_BLENDSHAPES = 8;
+    AvatarData recorder;
+    recorder.setRecordingBasis();
+    recorder.getHeadOrientation(); // creates the head
+    AvatarFrameCodec::EncoderState encoder;
+    compactFrames.clear();
+    for (int frame = 0; frame <= 2 * interval; frame++) {
+        recorder.setBlendshapeCoefficients(QVector<float>(frame > interval ? NUM_BLENDSHAPES : 0, 0.5f));
+        recorder.setRawJointData(animatedJoints(frame));
+        compactFrames.push_back(AvatarData::toFrame(recorder, encoder));
+    }
+    AvatarData seekingPlayer;
+    AvatarData::fromFrame(compactFrames[2 * interval], seekingPlayer);
+    QCOMPARE(seekingPlayer.getHeadData()->getBlendshapeCoefficients().size(), NUM_BLENDSHAPES);
+    AvatarData::fromFrame(compactFrames[interval], seekingPlayer);
+    for (float coefficient : seekingPlayer.getHeadData()->getBlendshapeCoefficients()) {
+        QCOMPARE(coefficient, 0.0f);
+    }
+}
+
+void benchmarkAvatarFrameDecode() {
+    QVector<QByteArray> jsonFrames;
+    QVector<QByteArray> compactFrames;
+    recordFrames(jsonFrames, compactFrames);
+
+    auto report = [](const char* name, const QVector<QByteArray>& frames) {
+        AvatarData player;
+        qint64 totalBytes = 0;
+        QElapsedTimer timer;
+        timer.start();
+        for (const auto& frame : frames) {
+            AvatarData::fromFrame(frame, player);
+            totalBytes += frame.size();
+        }
+        qint64 elapsedNSecs = timer.nsecsElapsed();
+        float seconds = (float)frames.size() / FRAME_RATE;
+        qDebug().noquote() << name << ":" << (float)elapsedNSecs / (frames.size() * NSECS_PER_USEC) << "usecs/frame,"
+            << (float)totalBytes / seconds << "bytes/sec";
+    };
+
+    report("JSON avatar frames   ", jsonFrames);
+    report("Compact avatar frames", compactFrames);
+}
@@ -0,0 +1,19 @@
+//
+//  AvatarFrameBenchmark.h
+//  tests/recording/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+#ifndef hifi_AvatarFrameBenchmark_h
+#define hifi_AvatarFrameBenchmark_h
+
+void testAvatarFrameRoundTrip();
+void testAvatarFrameSeek();
+void benchmarkAvatarFrameDecode();
+
+#endif // hifi_AvatarFrameBenchmark_h
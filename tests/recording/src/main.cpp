@@ -28,10 +28,13 @@
 #endif
 
 #include <recording/Clip.h>
+#include <recording/ClipWriter.h>
 #include <recording/Frame.h>
+#include <recording/impl/FileClip.h>
 
 #include <SharedUtil.h>
 
+#include "AvatarFrameBenchmark.h"
 #include "Constants.h"
 
 using namespace recording;
@@ -68,7 +71,7 @@ void testFilePersist() {
     QVERIFY(writeClip->frameCount() == 1);
     QVERIFY(writeClip->duration() == 5.0f);
 
-    Clip::toFile(fileName, writeClip);
+    QVERIFY(Clip::toFile(fileName, writeClip)->waitForFinished());
     readClip = Clip::fromFile(fileName);
     QVERIFY(readClip != Clip::Pointer());
     QVERIFY(readClip->frameCount() == 1);
@@ -92,7 +95,7 @@ void testFilePersist() {
     writeClip->addFrame(std::make_shared<Frame>(Frame::TYPE_INVALID - 1, 10.0f, QByteArray()));
     QVERIFY(writeClip->frameCount() == 2);
     QVERIFY(writeClip->duration() == 10.0f);
-    Clip::toFile(fileName, writeClip);
+    QVERIFY(Clip::toFile(fileName, writeClip)->waitForFinished());
 
     // Verify that the read version of the clip ignores the unknown frame type
     readClip = Clip::fromFile(fileName);
@@ -119,10 +122,64 @@ void testClipOrdering() {
     Q_UNUSED(lastFrameTimeOffset); // FIXME - Unix build not yet upgraded to Qt 5.5.1 we can remove this once it is
 }
 
+void testIndexedClip() {
+    QTemporaryFile file;
+    QString fileName;
+    if (file.open()) {
+        fileName = file.fileName();
+        file.close();
+    }
+
+    // several chunks worth of frames, ten minutes at 100Hz
+    const Frame::Time FRAME_INTERVAL = 10;
+    const size_t FRAME_COUNT = 60 * 1000;
+    auto writer = ClipWriter::create(fileName);
+    for (size_t i = 0; i < FRAME_COUNT; ++i) {
+        writer->addFrame(std::make_shared<Frame>(TEST_FRAME_TYPE, (float)(i * FRAME_INTERVAL), QByteArray(100, (char)i)));
+    }
+    writer->finish();
+    QVERIFY(writer->waitForFinished());
+
+    auto readClip = Clip::fromFile(fileName);
+    QVERIFY(readClip != Clip::Pointer());
+    QVERIFY(readClip->frameCount() == FRAME_COUNT);
+    QVERIFY(readClip->duration() == Frame::frameTimeToSeconds((FRAME_COUNT - 1) * FRAME_INTERVAL));
+
+    // seeking lands on the first frame at or after the requested time
+    readClip->seekFrameTime(FRAME_INTERVAL * 12345 + 1);
+    QVERIFY(readClip->positionFrameTime() == FRAME_INTERVAL * 12346);
+    auto frame = readClip->nextFrame();
+    QVERIFY(frame && frame->data == QByteArray(100, (char)12346));
+    readClip->seekFrameTime(0);
+    QVERIFY(readClip->positionFrameTime() == 0);
+
+    // a clip whose index was never written, e.g. after a crash, is still readable
+    {
+        QFile truncated(fileName);
+        QVERIFY(truncated.open(QFile::ReadWrite));
+        QVERIFY(truncated.resize(truncated.size() / 2));
+    }
+    readClip = Clip::fromFile(fileName);
+    QVERIFY(readClip != Clip::Pointer());
+    QVERIFY(readClip->frameCount() > 0 && readClip->frameCount() < FRAME_COUNT);
+
+    // clips in the original flat format still load
+    auto writeClip = Clip::newClip();
+    writeClip->addFrame(std::make_shared<Frame>(TEST_FRAME_TYPE, 5.0f, QByteArray()));
+    QVERIFY(FileClip::write(fileName, writeClip));
+    readClip = Clip::fromFile(fileName);
+    QVERIFY(readClip != Clip::Pointer());
+    QVERIFY(readClip->frameCount() == 1);
+}
+
 int main(int, const char**) {
     setupHifiApplication("Recording Test");
 
     testFrameTypeRegistration();
     testFilePersist();
     testClipOrdering();
+    testIndexedClip();
+    testAvatarFrameRoundTrip();
+    testAvatarFrameSeek();
+    benchmarkAvatarFrameDecode();
 }
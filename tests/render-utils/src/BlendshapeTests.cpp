@@ -0,0 +1,231 @@
+//
+//  BlendshapeTests.cpp
+//  tests/render-utils/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "BlendshapeTests.h"
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+
+#include <glm/gtc/packing.hpp>
+
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+
+#include <SparseBlendshapes.h>
+
+QTEST_MAIN(BlendshapeTests)
+
+static const int NUM_BENCHMARK_VERTICES = 30000;
+static const int NUM_BENCHMARK_BLENDSHAPES = 50;
+static const int NUM_BENCHMARK_BLENDSHAPE_VERTICES = 3000;
+static const int NUM_BENCHMARK_INSTANCES = 100;
+static const int NUM_BENCHMARK_EXPRESSIONS = 5;
+
+static HFMModel makeModel(int numVertices, int numBlendshapes, int numBlendshapeVertices) {
+    std::mt19937 generator(1);
+    std::uniform_real_distribution<float> delta(-0.1f, 0.1f);
+    auto randomVector = [&] { return glm::vec3(delta(generator), delta(generator), delta(generator)); };
+
+    HFMMesh mesh;
+    mesh.vertices.resize(numVertices);
+    std::vector<int> vertexIndices(numVertices);
+    std::iota(vertexIndices.begin(), vertexIndices.end(), 0);
+    for (int i = 0; i < numBlendshapes; i++) {
+        HFMBlendshape blendshape;
+        std::shuffle(vertexIndices.begin(), vertexIndices.end(), generator);
+        for (int j = 0; j < numBlendshapeVertices; j++) {
+            blendshape.indices.push_back(vertexIndices[j]);
+            blendshape.vertices.push_back(randomVector());
+            blendshape.normals.push_back(randomVector());
+            // some blendshapes have no tangents
+            if (i % 2 == 0) {
+                blendshape.tangents.push_back(randomVector());
+            }
+        }
+        mesh.blendshapes.push_back(blendshape);
+    }
+
+    HFMModel model;
+    model.meshes.push_back(HFMMesh());
+    model.meshes.push_back(mesh);
+    return model;
+}
+
+static QVector<float> makeCoefficients(int numBlendshapes, int seed) {
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<float> coefficient(0.0f, 1.0f);
+    QVector<float> coefficients;
+    for (int i = 0; i < numBlendshapes; i++) {
+        // most blendshapes are inactive at any time
+        coefficients.push_back(i % 3 == 0 ? coefficient(generator) : 0.0f);
+    }
+    return coefficients;
+}
+
+// The blend done by the model before the sparse blendshapes, one blendshape after the other
+static QVector<BlendshapeOffset> denseBlend(const HFMMesh& mesh, const QuantizedBlendshapeCoefficients& coefficients) {
+    const float QUANTUM = 1.0f / 1024.0f;
+    const float NORMAL_COEFFICIENT_SCALE = 0.01f;
+    std::vector<BlendshapeOffsetUnpacked> unpacked(mesh.vertices.size(), { glm::vec3(0.0f), glm::vec3(0.0f), glm::vec3(0.0f) });
+    for (int i = 0, n = std::min((int)coefficients.size(), mesh.blendshapes.size()); i < n; i++) {
+        float vertexCoefficient = coefficients[i] * QUANTUM;
+        if (vertexCoefficient == 0.0f) {
+            continue;
+        }
+        float normalCoefficient = vertexCoefficient * NORMAL_COEFFICIENT_SCALE;
+        const HFMBlendshape& blendshape = mesh.blendshapes.at(i);
+        for (int j = 0; j < blendshape.indices.size(); j++) {
+            auto& offset = unpacked[blendshape.indices.at(j)];
+            offset.positionOffset += blendshape.vertices.at(j) * vertexCoefficient;
+            offset.normalOffset += blendshape.normals.at(j) * normalCoefficient;
+            if (j < blendshape.tangents.size()) {
+                offset.tangentOffset += blendshape.tangents.at(j) * normalCoefficient;
+            }
+        }
+    }
+
+    QVector<BlendshapeOffset> offsets(mesh.vertices.size());
+    for (int v = 0; v < mesh.vertices.size(); v++) {
+        packBlendshapeOffsetTo_Pos_F32_3xSN10_Nor_3xSN10_Tan_3xSN10(offsets[v].packedPosNorTan, unpacked[v]);
+    }
+    return offsets;
+}
+
+static bool isNear(const BlendshapeOffset& a, const BlendshapeOffset& b) {
+    // the packed components may round differently when the sums differ in their last bits
+    const float SNORM10_STEP = 1.0f / 511.0f;
+    const float EPSILON = 2.0f * SNORM10_STEP;
+    float lengthA = glm::uintBitsToFloat(a.packedPosNorTan.x);
+    float lengthB = glm::uintBitsToFloat(b.packedPosNorTan.x);
+    glm::vec3 positionA = glm::vec3(glm::unpackSnorm3x10_1x2(a.packedPosNorTan.y)) * lengthA;
+    glm::vec3 positionB = glm::vec3(glm::unpackSnorm3x10_1x2(b.packedPosNorTan.y)) * lengthB;
+    for (int c = 1; c < 4; c++) {
+        glm::vec4 componentA = glm::unpackSnorm3x10_1x2(a.packedPosNorTan[c]);
+        glm::vec4 componentB = glm::unpackSnorm3x10_1x2(b.packedPosNorTan[c]);
+        if (glm::any(glm::greaterThan(glm::abs(glm::vec3(componentA - componentB)), glm::vec3(EPSILON)))) {
+            return false;
+        }
+    }
+    return glm::all(glm::lessThanEqual(glm::abs(positionA - positionB), glm::vec3(EPSILON * std::max(lengthA, lengthB))));
+}
+
+void BlendshapeTests::testSparseBlendMatchesDenseBlend() {
+    const int NUM_VERTICES = 1000;
+    auto model = makeModel(NUM_VERTICES, 10, 300);
+    auto blendshapes = buildSparseModelBlendshapes(model);
+    QCOMPARE((int)blendshapes.size(), 2);
+    QVERIFY(!blendshapes[0]);
+    QVERIFY(blendshapes[1]);
+
+    auto coefficients = quantizeBlendshapeCoefficients(makeCoefficients(10, 2));
+    QVector<BlendshapeOffset> offsets;
+    QVector<int> meshSizes;
+    blendSparseModelBlendshapes(blendshapes, coefficients, offsets, meshSizes);
+    QCOMPARE(meshSizes, QVector<int>({ 0, NUM_VERTICES }));
+    QCOMPARE(offsets.size(), NUM_VERTICES);
+
+    auto expected = denseBlend(model.meshes[1], coefficients);
+    int numMismatches = 0;
+    for (int v = 0; v < NUM_VERTICES; v++) {
+        numMismatches += isNear(offsets[v], expected[v]) ? 0 : 1;
+    }
+    QCOMPARE(numMismatches, 0);
+}
+
+void BlendshapeTests::testQuantizedCoefficients() {
+    auto quantized = quantizeBlendshapeCoefficients({ 0.5f, -0.2f, 0.00001f, 1.0f, 0.0f, 0.0f });
+    QCOMPARE(quantized, QuantizedBlendshapeCoefficients({ 512, 0, 0, 1024 }));
+
+    // coefficients closer than the quantization step blend the same
+    QCOMPARE(quantizeBlendshapeCoefficients({ 0.25f, 0.75f }), quantizeBlendshapeCoefficients({ 0.2502f, 0.7499f }));
+    QVERIFY(quantizeBlendshapeCoefficients({ 0.25f }) != quantizeBlendshapeCoefficients({ 0.26f }));
+}
+
+void BlendshapeTests::testSharedResults() {
+    auto model = makeModel(1000, 10, 300);
+    auto blendshapes = std::make_shared<SparseModelBlendshapes>(buildSparseModelBlendshapes(model));
+    auto otherBlendshapes = std::make_shared<SparseModelBlendshapes>(buildSparseModelBlendshapes(model));
+    auto coefficients = quantizeBlendshapeCoefficients(makeCoefficients(10, 3));
+
+    BlendedResultCache cache(2000);
+    BlendedResultCache::Result result;
+    QVERIFY(!cache.find(blendshapes, coefficients, result));
+
+    blendSparseModelBlendshapes(*blendshapes, coefficients, result.offsets, result.meshSizes);
+    cache.insert(blendshapes, coefficients, result);
+
+    BlendedResultCache::Result shared;
+    QVERIFY(cache.find(blendshapes, coefficients, shared));
+    QVERIFY(shared.offsets.constData() == result.offsets.constData());
+    QCOMPARE(shared.meshSizes, result.meshSizes);
+
+    // other models and other coefficients don't share the result
+    QVERIFY(!cache.find(otherBlendshapes, coefficients, shared));
+    QVERIFY(!cache.find(blendshapes, quantizeBlendshapeCoefficients(makeCoefficients(10, 4)), shared));
+    QCOMPARE(cache.getNumHits(), (quint64)1);
+    QCOMPARE(cache.getNumMisses(), (quint64)3);
+
+    // the oldest result is dropped when the cache is full
+    cache.insert(otherBlendshapes, coefficients, result);
+    cache.insert(otherBlendshapes, quantizeBlendshapeCoefficients(makeCoefficients(10, 4)), result);
+    QVERIFY(!cache.find(blendshapes, coefficients, shared));
+    QVERIFY(cache.find(otherBlendshapes, coefficients, shared));
+}
+
+void BlendshapeTests::benchmarkBlend() {
+    auto model = makeModel(NUM_BENCHMARK_VERTICES, NUM_BENCHMARK_BLENDSHAPES, NUM_BENCHMARK_BLENDSHAPE_VERTICES);
+    auto buildStart = usecTimestampNow();
+    auto blendshapes = std::make_shared<SparseModelBlendshapes>(buildSparseModelBlendshapes(model));
+    qDebug() << "Preprocessed" << NUM_BENCHMARK_BLENDSHAPES << "blendshapes in"
+        << (float)(usecTimestampNow() - buildStart) / USECS_PER_MSEC << "ms";
+
+    // a crowd of instances making a few expressions, with coefficients that differ less than the quantization step
+    std::vector<QuantizedBlendshapeCoefficients> instanceCoefficients;
+    for (int i = 0; i < NUM_BENCHMARK_INSTANCES; i++) {
+        auto coefficients = makeCoefficients(NUM_BENCHMARK_BLENDSHAPES, i % NUM_BENCHMARK_EXPRESSIONS);
+        for (auto& coefficient : coefficients) {
+            const float QUANTUM = 1.0f / 1024.0f;
+            coefficient = glm::round(coefficient / QUANTUM) * QUANTUM + 0.0001f * (i % 3);
+        }
+        instanceCoefficients.push_back(quantizeBlendshapeCoefficients(coefficients));
+    }
+
+    auto start = usecTimestampNow();
+    for (const auto& coefficients : instanceCoefficients) {
+        auto offsets = denseBlend(model.meshes[1], coefficients);
+    }
+    auto denseUsecs = usecTimestampNow() - start;
+
+    start = usecTimestampNow();
+    for (const auto& coefficients : instanceCoefficients) {
+        QVector<BlendshapeOffset> offsets;
+        QVector<int> meshSizes;
+        blendSparseModelBlendshapes(*blendshapes, coefficients, offsets, meshSizes);
+    }
+    auto sparseUsecs = usecTimestampNow() - start;
+
+    BlendedResultCache cache;
+    start = usecTimestampNow();
+    for (const auto& coefficients : instanceCoefficients) {
+        BlendedResultCache::Result result;
+        if (!cache.find(blendshapes, coefficients, result)) {
+            blendSparseModelBlendshapes(*blendshapes, coefficients, result.offsets, result.meshSizes);
+            cache.insert(blendshapes, coefficients, result);
+        }
+    }
+    auto sharedUsecs = usecTimestampNow() - start;
+    QCOMPARE(cache.getNumMisses(), (quint64)NUM_BENCHMARK_EXPRESSIONS);
+
+    qDebug() << NUM_BENCHMARK_INSTANCES << "instances of" << NUM_BENCHMARK_VERTICES << "vertices:";
+    qDebug() << "Dense blend:" << (float)denseUsecs / USECS_PER_MSEC << "ms";
+    qDebug() << "Sparse blend:" << (float)sparseUsecs / USECS_PER_MSEC << "ms";
+    qDebug() << "Sparse blend with shared results:" << (float)sharedUsecs / USECS_PER_MSEC << "ms";
+}
@@ -0,0 +1,281 @@
+//
+//  CullingTests.cpp
+//  tests/render/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "CullingTests.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <GLMHelpers.h>
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+#include <ViewFrustum.h>
+
+#include <render/CullFrustum.h>
+#include <render/CullTask.h>
+#include <render/Scene.h>
+
+QTEST_MAIN(CullingTests)
+
+static const int NUM_BENCHMARK_ITEMS = 100000;
+static const int NUM_BENCHMARK_FRAMES = 10;
+static const int NUM_BENCHMARK_VIEWS = 4;
+static const float WORLD_HALF_SIZE = 500.0f;
+static const float MAX_ITEM_SIZE = 10.0f;
+static const float LOD_ANGLE_HALF_TAN = 0.01f;
+
+struct CullTestItem {
+    using Pointer = std::shared_ptr<CullTestItem>;
+    AABox bound;
+};
+
+namespace render {
+    template <> const ItemKey payloadGetKey(const CullTestItem::Pointer& item) { return ItemKey::Builder::opaqueShape().build(); }
+    template <> const Item::Bound payloadGetBound(const CullTestItem::Pointer& item) { return item->bound; }
+}
+
+static AABox randomBox() {
+    glm::vec3 corner(randFloatInRange(-WORLD_HALF_SIZE, WORLD_HALF_SIZE), randFloatInRange(-WORLD_HALF_SIZE, WORLD_HALF_SIZE) * 0.1f,
+                     randFloatInRange(-WORLD_HALF_SIZE, WORLD_HALF_SIZE));
+    glm::vec3 dimensions(randFloatInRange(0.1f, MAX_ITEM_SIZE), randFloatInRange(0.1f, MAX_ITEM_SIZE), randFloatInRange(0.1f, MAX_ITEM_SIZE));
+    return AABox(corner, dimensions);
+}
+
+static ViewFrustum makeFrustum(const glm::vec3& position, float yaw) {
+    ViewFrustum frustum;
+    frustum.setProjection(glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 2.0f * WORLD_HALF_SIZE));
+    frustum.setPosition(position);
+    frustum.setOrientation(glm::angleAxis(yaw, Vectors::UNIT_Y));
+    frustum.calculate();
+    return frustum;
+}
+
+// All the tests share a scene of random items
+static const render::ScenePointer& getScene() {
+    static render::ScenePointer scene;
+    if (!scene) {
+        srand(1);
+        scene = std::make_shared<render::Scene>(glm::vec3(-16384.0f), 32768.0f);
+        render::Transaction transaction;
+        for (int i = 0; i < NUM_BENCHMARK_ITEMS; i++) {
+            auto item = std::make_shared<CullTestItem>();
+            item->bound = randomBox();
+            transaction.resetItem(scene->allocateID(), std::make_shared<render::Payload<CullTestItem>>(item));
+        }
+        scene->enqueueTransaction(transaction);
+        scene->processTransactionQueue();
+    }
+    return scene;
+}
+
+// Same as the LOD test used by the interface
+static bool shouldRender(const RenderArgs* args, const AABox& bounds) {
+    auto pos = args->getViewFrustum().getPosition() - bounds.calcCenter();
+    auto dim = bounds.getDimensions();
+    return 0.25f * glm::dot(dim, dim) >= args->_lodAngleHalfTanSq * glm::dot(pos, pos);
+}
+
+// Fetch and cull the scene as the render engine does, there is no gpu context so this runs headless
+static render::ItemBounds cullScene(const ViewFrustum& frustum, bool parallel) {
+    const auto& scene = getScene();
+    RenderArgs args(gpu::ContextPointer(), 1.0f, 0, LOD_ANGLE_HALF_TAN);
+    args.setViewFrustum(frustum);
+    args._scene = scene;
+
+    auto renderContext = std::make_shared<render::RenderContext>();
+    renderContext->args = &args;
+    renderContext->_scene = scene;
+    auto config = std::make_shared<render::CullSpatialSelection::Config>();
+    config->parallelCulling = parallel;
+    renderContext->jobConfig = config;
+
+    auto filter = render::ItemFilter::Builder::opaqueShape().build();
+    render::ItemSpatialTree::ItemSelection selection;
+    scene->getSpatialTree().selectCellItems(selection, filter, frustum, LOD_ANGLE_HALF_TAN);
+
+    render::CullSpatialSelection cull(shouldRender, render::RenderDetails::ITEM);
+    cull.configure(*config);
+    render::ItemBounds culledItems;
+    cull.run(renderContext, render::CullSpatialSelection::Inputs(render::Varying(selection), render::Varying(filter)), culledItems);
+    return culledItems;
+}
+
+void CullingTests::testCullFrustumMatchesViewFrustum() {
+    const int NUM_BOXES = 10000;
+    auto frustum = makeFrustum(glm::vec3(0.0f), 0.0f);
+    render::CullFrustum cullFrustum(frustum);
+
+    int numIntersecting = 0;
+    int numIntersectMismatches = 0;
+    int numInsideMismatches = 0;
+    for (int i = 0; i < NUM_BOXES; i++) {
+        auto box = randomBox();
+        bool intersects = frustum.boxIntersectsFrustum(box);
+        numIntersecting += intersects ? 1 : 0;
+        numIntersectMismatches += (cullFrustum.boxIntersects(box) != intersects) ? 1 : 0;
+        numInsideMismatches += (cullFrustum.boxInside(box) != frustum.boxInsideFrustum(box)) ? 1 : 0;
+    }
+    QVERIFY(numIntersecting > 0 && numIntersecting < NUM_BOXES);
+    QCOMPARE(numIntersectMismatches, 0);
+    QCOMPARE(numInsideMismatches, 0);
+}
+
+// The single view traversal of the octree used before the multi view selection, kept as the reference
+struct ReferenceSelection {
+    using Octree = render::Octree;
+
+    static void select(const Octree& tree, Octree::CellSelection& selection, const Octree::FrustumSelector& selector) {
+        auto cell = tree.getConcreteCell(Octree::ROOT_CELL);
+
+        // Always include the root cell partially containing potentially outer objects
+        tree.selectCellBrick(Octree::ROOT_CELL, selection, false);
+
+        for (int i = 0; i < Octree::NUM_OCTANTS; i++) {
+            Octree::Index subCellID = cell.child((Octree::Link)i);
+            if (subCellID != Octree::INVALID_CELL) {
+                selectTraverse(tree, subCellID, selection, selector);
+            }
+        }
+    }
+
+    static void selectTraverse(const Octree& tree, Octree::Index cellID, Octree::CellSelection& selection,
+                               const Octree::FrustumSelector& selector) {
+        auto cell = tree.getConcreteCell(cellID);
+        auto cellLocation = cell.getlocation();
+
+        switch (Octree::Location::intersectCell(cellLocation, selector.frustum)) {
+            case Octree::Location::Outside:
+                return;
+            case Octree::Location::Inside:
+                selectBranch(tree, cellID, selection, selector);
+                return;
+            case Octree::Location::Intersect:
+            default: {
+                float test = selector.testThreshold(cellLocation.getCenter(), Octree::getCoordSubcellWidth(cellLocation.depth));
+                if (test < 0.0f) {
+                    return;
+                }
+                tree.selectCellBrick(cellID, selection, false);
+                for (int i = 0; i < Octree::NUM_OCTANTS; i++) {
+                    Octree::Index subCellID = cell.child((Octree::Link)i);
+                    if (subCellID != Octree::INVALID_CELL) {
+                        selectTraverse(tree, subCellID, selection, selector);
+                    }
+                }
+            }
+        }
+    }
+
+    static void selectBranch(const Octree& tree, Octree::Index cellID, Octree::CellSelection& selection,
+                             const Octree::FrustumSelector& selector) {
+        auto cell = tree.getConcreteCell(cellID);
+        auto cellLocation = cell.getlocation();
+        float test = selector.testThreshold(cellLocation.getCenter(), Octree::getCoordSubcellWidth(cellLocation.depth));
+        if (test < 0.0f) {
+            return;
+        }
+        tree.selectCellBrick(cellID, selection, true);
+        for (int i = 0; i < Octree::NUM_OCTANTS; i++) {
+            Octree::Index subCellID = cell.child((Octree::Link)i);
+            if (subCellID != Octree::INVALID_CELL) {
+                selectBranch(tree, subCellID, selection, selector);
+            }
+        }
+    }
+};
+
+void CullingTests::testMultiViewSelection() {
+    const auto& tree = getScene()->getSpatialTree();
+    auto filter = render::ItemFilter::Builder::opaqueShape().build();
+
+    // more views than are traversed together, so the views are split in groups
+    const int NUM_VIEWS = render::Octree::MAX_NUM_SELECT_VIEWS + 3;
+    std::vector<ViewFrustum> frustums;
+    std::vector<float> thresholds;
+    for (int v = 0; v < NUM_VIEWS; v++) {
+        frustums.push_back(makeFrustum(glm::vec3(10.0f * v, 0.0f, 0.0f), TWO_PI * (float)v / NUM_VIEWS));
+        thresholds.push_back(LOD_ANGLE_HALF_TAN * (float)(1 + v % 3));
+    }
+
+    render::ItemSpatialTree::ItemSelections selections;
+    tree.selectCellItems(selections, filter, frustums, thresholds);
+    QCOMPARE((int)selections.size(), NUM_VIEWS);
+
+    for (int v = 0; v < NUM_VIEWS; v++) {
+        render::Octree::CellSelection expected;
+        auto selector = tree.evalSelector(frustums[v], thresholds[v]);
+        ReferenceSelection::select(tree, expected, *selector);
+
+        const auto& cellSelection = selections[v].cellSelection;
+        QVERIFY(expected.size() > 0);
+        QVERIFY(cellSelection.insideCells == expected.insideCells);
+        QVERIFY(cellSelection.insideBricks == expected.insideBricks);
+        QVERIFY(cellSelection.partialCells == expected.partialCells);
+        QVERIFY(cellSelection.partialBricks == expected.partialBricks);
+        QVERIFY(selections[v].numItems() > 0);
+    }
+}
+
+void CullingTests::testParallelCulling() {
+    auto frustum = makeFrustum(glm::vec3(0.0f), 0.0f);
+    auto items = cullScene(frustum, false);
+    auto parallelItems = cullScene(frustum, true);
+
+    QVERIFY(!items.empty());
+    QCOMPARE(parallelItems.size(), items.size());
+    for (size_t i = 0; i < items.size(); i++) {
+        QCOMPARE(parallelItems[i].id, items[i].id);
+    }
+}
+
+void CullingTests::benchmarkCulling() {
+    getScene();
+    qDebug() << NUM_BENCHMARK_ITEMS << "items in" << getScene()->getSpatialTree().getNumAllocatedCells() << "cells";
+
+    auto runFrames = [](bool parallel) {
+        size_t numCulled = 0;
+        auto start = usecTimestampNow();
+        for (int frame = 0; frame < NUM_BENCHMARK_FRAMES; frame++) {
+            numCulled += cullScene(makeFrustum(glm::vec3(0.0f), TWO_PI * (float)frame / NUM_BENCHMARK_FRAMES), parallel).size();
+        }
+        auto usecs = usecTimestampNow() - start;
+        qDebug() << (parallel ? "Parallel cull:" : "Single thread cull:")
+            << (float)usecs / NUM_BENCHMARK_FRAMES / USECS_PER_MSEC << "ms per frame," << numCulled / NUM_BENCHMARK_FRAMES << "items";
+        return numCulled;
+    };
+    QCOMPARE(runFrames(true), runFrames(false));
+
+    // several views selected one after the other, then in one traversal
+    const auto& tree = getScene()->getSpatialTree();
+    auto filter = render::ItemFilter::Builder::opaqueShape().build();
+    std::vector<ViewFrustum> frustums;
+    std::vector<float> thresholds;
+    for (int v = 0; v < NUM_BENCHMARK_VIEWS; v++) {
+        frustums.push_back(makeFrustum(glm::vec3(0.0f), TWO_PI * (float)v / NUM_BENCHMARK_VIEWS));
+        thresholds.push_back(LOD_ANGLE_HALF_TAN);
+    }
+
+    auto start = usecTimestampNow();
+    for (int frame = 0; frame < NUM_BENCHMARK_FRAMES; frame++) {
+        for (int v = 0; v < NUM_BENCHMARK_VIEWS; v++) {
+            render::ItemSpatialTree::ItemSelection selection;
+            tree.selectCellItems(selection, filter, frustums[v], thresholds[v]);
+        }
+    }
+    auto usecs = usecTimestampNow() - start;
+    qDebug() << NUM_BENCHMARK_VIEWS << "views selected one by one:" << (float)usecs / NUM_BENCHMARK_FRAMES / USECS_PER_MSEC << "ms per frame";
+
+    start = usecTimestampNow();
+    for (int frame = 0; frame < NUM_BENCHMARK_FRAMES; frame++) {
+        render::ItemSpatialTree::ItemSelections selections;
+        tree.selectCellItems(selections, filter, frustums, thresholds);
+    }
+    usecs = usecTimestampNow() - start;
+    qDebug() << NUM_BENCHMARK_VIEWS << "views selected together:" << (float)usecs / NUM_BENCHMARK_FRAMES / USECS_PER_MSEC << "ms per frame";
+}
@@ -0,0 +1,25 @@
+//
+//  CullingTests.h
+//  tests/render/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_CullingTests_h
+#define hifi_CullingTests_h
+
+#include <QtTest/QtTest>
+
+class CullingTests : public QObject {
+    Q_OBJECT
+private slots:
+    void testCullFrustumMatchesViewFrustum();
+    void testMultiViewSelection();
+    void testParallelCulling();
+    void benchmarkCulling();
+};
+
+#endif // hifi_CullingTests_h
@@ -12,6 +12,7 @@
 #include "GLMHelpersTests.h"
 
 #include <NumericalConstants.h>
+#include <SharedUtil.h>
 #include <StreamUtils.h>
 
 #include <test-utils/QTestExtensions.h>
@@ -105,6 +106,38 @@ void GLMHelpersTests::testSixByteOrientationCompression() {
     testQuatCompression(-(ROT_Z_30 * ROT_X_90 * ROT_Y_180));
 }
 
+void GLMHelpersTests::testBatchUnpacking() {
+    // an odd count so the batched functions also go through their remainder
+    const int NUM_VALUES = 103;
+    const int TRANSLATION_RADIX = 14;
+
+    std::vector<uint8_t> quatBytes(NUM_VALUES * 6);
+    std::vector<uint8_t> vectorBytes(NUM_VALUES * 6);
+    for (int i = 0; i < NUM_VALUES; i++) {
+        glm::quat rotation = glm::normalize(glm::quat(randFloatInRange(-1.0f, 1.0f), randFloatInRange(-1.0f, 1.0f),
+                                                      randFloatInRange(-1.0f, 1.0f), randFloatInRange(-1.0f, 1.0f)));
+        packOrientationQuatToSixBytes(quatBytes.data() + i * 6, rotation);
+        glm::vec3 translation(randFloatInRange(-1.0f, 1.0f), randFloatInRange(-1.0f, 1.0f), randFloatInRange(-1.0f, 1.0f));
+        packFloatVec3ToSignedTwoByteFixed(vectorBytes.data() + i * 6, translation, TRANSLATION_RADIX);
+    }
+
+    std::vector<glm::quat> rotations(NUM_VALUES);
+    std::vector<glm::vec3> translations(NUM_VALUES);
+    QCOMPARE(unpackOrientationQuatsFromSixBytes(quatBytes.data(), rotations.data(), NUM_VALUES), NUM_VALUES * 6);
+    QCOMPARE(unpackFloatVec3sFromSignedTwoByteFixed(vectorBytes.data(), translations.data(), NUM_VALUES, TRANSLATION_RADIX),
+             NUM_VALUES * 6);
+
+    // the batched functions must give exactly what the one at a time functions give
+    for (int i = 0; i < NUM_VALUES; i++) {
+        glm::quat rotation;
+        unpackOrientationQuatFromSixBytes(quatBytes.data() + i * 6, rotation);
+        QVERIFY(rotations[i] == rotation);
+        glm::vec3 translation;
+        unpackFloatVec3FromSignedTwoByteFixed(vectorBytes.data() + i * 6, translation, TRANSLATION_RADIX);
+        QVERIFY(translations[i] == translation);
+    }
+}
+
 #define LOOPS 500000
 
 void GLMHelpersTests::testSimd() {
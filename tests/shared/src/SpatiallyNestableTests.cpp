@@ -0,0 +1,167 @@
+//
+//  SpatiallyNestableTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SpatiallyNestableTests.h"
+
+#include <QtCore/QHash>
+
+#include <GLMHelpers.h>
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+#include <SpatiallyNestable.h>
+
+QTEST_MAIN(SpatiallyNestableTests)
+
+static const int NUM_BENCHMARK_OBJECTS = 10000;
+static const int BENCHMARK_BRANCHING = 4;
+static const int NUM_BENCHMARK_FRAMES = 10;
+static const int QUERIES_PER_FRAME = 10;
+
+class TestNestable : public SpatiallyNestable {
+public:
+    TestNestable(NestableType nestableType = NestableType::Entity) : SpatiallyNestable(nestableType, QUuid::createUuid()) {}
+
+    // every joint has the same transform, which moves without notifying the children, like an animated skeleton
+    glm::vec3 getAbsoluteJointTranslationInObjectFrame(int index) const override { return jointTranslation; }
+    glm::quat getAbsoluteJointRotationInObjectFrame(int index) const override { return jointRotation; }
+
+    glm::vec3 jointTranslation;
+    glm::quat jointRotation;
+};
+
+class TestParentFinder : public SpatialParentFinder {
+public:
+    SpatiallyNestableWeakPointer find(QUuid parentID, bool& success, SpatialParentTree* entityTree = nullptr) const override {
+        auto itr = objects.find(parentID);
+        success = itr != objects.end();
+        return success ? itr.value() : SpatiallyNestableWeakPointer();
+    }
+
+    QHash<QUuid, SpatiallyNestableWeakPointer> objects;
+};
+
+static std::shared_ptr<TestNestable> addObject(const SpatiallyNestablePointer& parent, const glm::vec3& localPosition,
+                                                NestableType nestableType = NestableType::Entity) {
+    auto object = std::make_shared<TestNestable>(nestableType);
+    DependencyManager::get<TestParentFinder>()->objects[object->getID()] = object;
+    if (parent) {
+        object->setParentID(parent->getID());
+    }
+    object->setLocalPosition(localPosition);
+    return object;
+}
+
+static bool isNear(const glm::vec3& a, const glm::vec3& b) {
+    return glm::distance(a, b) < EPSILON;
+}
+
+void SpatiallyNestableTests::initTestCase() {
+    DependencyManager::registerInheritance<SpatialParentFinder, TestParentFinder>();
+    DependencyManager::set<TestParentFinder>();
+}
+
+void SpatiallyNestableTests::testCachedTransformFollowsParents() {
+    auto root = addObject(nullptr, glm::vec3(1.0f, 0.0f, 0.0f));
+    auto middle = addObject(root, glm::vec3(0.0f, 1.0f, 0.0f));
+    auto leaf = addObject(middle, glm::vec3(0.0f, 0.0f, 1.0f));
+
+    // the first query fills the caches, the second one reads them
+    QVERIFY(isNear(leaf->getWorldPosition(), glm::vec3(1.0f, 1.0f, 1.0f)));
+    QVERIFY(isNear(leaf->getWorldPosition(), glm::vec3(1.0f, 1.0f, 1.0f)));
+
+    root->setLocalPosition(glm::vec3(2.0f, 0.0f, 0.0f));
+    QVERIFY(isNear(leaf->getWorldPosition(), glm::vec3(2.0f, 1.0f, 1.0f)));
+
+    root->setLocalOrientation(glm::angleAxis(PI_OVER_TWO, Vectors::UNIT_Z));
+    SpatiallyNestable::updateWorldTransforms({ root });
+    QVERIFY(isNear(middle->getWorldPosition(), glm::vec3(1.0f, 0.0f, 0.0f)));
+    QVERIFY(isNear(leaf->getWorldPosition(), glm::vec3(1.0f, 0.0f, 1.0f)));
+
+    middle->setParentID(QUuid());
+    QVERIFY(isNear(leaf->getWorldPosition(), glm::vec3(0.0f, 1.0f, 1.0f)));
+}
+
+void SpatiallyNestableTests::testJointChildrenAreNotCached() {
+    auto avatar = addObject(nullptr, glm::vec3(0.0f), NestableType::Avatar);
+    auto child = addObject(avatar, glm::vec3(0.0f, 1.0f, 0.0f));
+    QVERIFY(isNear(child->getWorldPosition(), glm::vec3(0.0f, 1.0f, 0.0f)));
+
+    auto jointChild = addObject(child, glm::vec3(0.0f, 0.0f, 1.0f));
+    jointChild->setParentJointIndex(0);
+    QVERIFY(isNear(jointChild->getWorldPosition(), glm::vec3(0.0f, 1.0f, 1.0f)));
+
+    avatar->setLocalPosition(glm::vec3(1.0f, 0.0f, 0.0f));
+    QVERIFY(isNear(child->getWorldPosition(), glm::vec3(1.0f, 1.0f, 0.0f)));
+    QVERIFY(isNear(jointChild->getWorldPosition(), glm::vec3(1.0f, 1.0f, 1.0f)));
+
+    // the joint moves, the next query of the child follows it
+    child->jointTranslation = glm::vec3(0.0f, 0.0f, 2.0f);
+    QVERIFY(isNear(jointChild->getWorldPosition(), glm::vec3(1.0f, 1.0f, 3.0f)));
+
+    child->jointRotation = glm::angleAxis(PI_OVER_TWO, Vectors::UNIT_X);
+    QVERIFY(isNear(jointChild->getWorldPosition(), glm::vec3(1.0f, 0.0f, 2.0f)));
+    QVERIFY(isNear(jointChild->getWorldOrientation() * Vectors::UNIT_Z, -Vectors::UNIT_Y));
+
+    // and the parent itself is not affected
+    QVERIFY(isNear(child->getWorldPosition(), glm::vec3(1.0f, 1.0f, 0.0f)));
+}
+
+void SpatiallyNestableTests::benchmarkNestedHierarchy() {
+    std::vector<SpatiallyNestablePointer> objects;
+    objects.push_back(addObject(nullptr, glm::vec3(0.0f)));
+    for (int i = 1; i < NUM_BENCHMARK_OBJECTS; i++) {
+        float angle = TWO_PI * (float)(i % BENCHMARK_BRANCHING) / BENCHMARK_BRANCHING;
+        objects.push_back(addObject(objects[(i - 1) / BENCHMARK_BRANCHING], glm::vec3(cosf(angle), 0.1f, sinf(angle))));
+    }
+    auto& root = objects[0];
+
+    // every frame the root moves and every object is queried a few times, as rendering, physics and scripts do
+    auto runFrames = [&](bool updateWorldTransforms) {
+        glm::vec3 checksum;
+        auto start = usecTimestampNow();
+        for (int frame = 0; frame < NUM_BENCHMARK_FRAMES; frame++) {
+            root->setLocalPosition(glm::vec3((float)frame, 0.0f, 0.0f));
+            if (updateWorldTransforms) {
+                SpatiallyNestable::updateWorldTransforms({ root });
+            }
+            for (int query = 0; query < QUERIES_PER_FRAME; query++) {
+                for (auto& object : objects) {
+                    checksum += object->getWorldPosition();
+                }
+            }
+        }
+        auto usecs = usecTimestampNow() - start;
+        qDebug() << (updateWorldTransforms ? "Updated once per frame:" : "Updated lazily on query:")
+            << (float)usecs / NUM_BENCHMARK_FRAMES / USECS_PER_MSEC << "ms per frame, checksum" << checksum.x;
+        return checksum;
+    };
+
+    auto lazyChecksum = runFrames(false);
+    auto updatedChecksum = runFrames(true);
+    QVERIFY(lazyChecksum == updatedChecksum);
+
+    // the uncached cost: objects that aren't entities walk up the parent chain on every query
+    std::vector<SpatiallyNestablePointer> uncached;
+    uncached.push_back(addObject(nullptr, glm::vec3(0.0f), NestableType::Overlay));
+    for (int i = 1; i < NUM_BENCHMARK_OBJECTS; i++) {
+        float angle = TWO_PI * (float)(i % BENCHMARK_BRANCHING) / BENCHMARK_BRANCHING;
+        uncached.push_back(addObject(uncached[(i - 1) / BENCHMARK_BRANCHING], glm::vec3(cosf(angle), 0.1f, sinf(angle)),
+                                     NestableType::Overlay));
+    }
+    auto start = usecTimestampNow();
+    glm::vec3 checksum;
+    for (int query = 0; query < QUERIES_PER_FRAME; query++) {
+        for (auto& object : uncached) {
+            checksum += object->getWorldPosition();
+        }
+    }
+    auto usecs = usecTimestampNow() - start;
+    qDebug() << "Uncached:" << (float)usecs / USECS_PER_MSEC << "ms per frame, checksum" << checksum.x;
+}
@@ -0,0 +1,463 @@
+//
+//  TriangleSetTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "TriangleSetTests.h"
+
+#include <list>
+#include <memory>
+#include <random>
+
+#include <QtCore/QFile>
+#include <QtCore/QTextStream>
+
+#include <GeometryUtil.h>
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+#include <TriangleSet.h>
+
+QTEST_MAIN(TriangleSetTests)
+
+// Set to an .obj file to benchmark against real model data, otherwise a generated mesh is used
+static const char* MODEL_PATH_ENV = "HIFI_TRIANGLE_SET_BENCHMARK_MODEL";
+
+static const int NUM_QUERIES = 1000;
+
+// a bumpy sphere, roughly like a detailed scanned model
+static std::vector<Triangle> generateMesh(int rings, int segments) {
+    std::mt19937 generator(1);
+    std::uniform_real_distribution<float> noise(0.9f, 1.1f);
+
+    std::vector<glm::vec3> vertices;
+    for (int ring = 0; ring <= rings; ring++) {
+        float polar = PI * (float)ring / rings;
+        for (int segment = 0; segment < segments; segment++) {
+            float azimuth = TWO_PI * (float)segment / segments;
+            float radius = noise(generator);
+            vertices.emplace_back(radius * sinf(polar) * cosf(azimuth), radius * cosf(polar), radius * sinf(polar) * sinf(azimuth));
+        }
+    }
+
+    std::vector<Triangle> triangles;
+    for (int ring = 0; ring < rings; ring++) {
+        for (int segment = 0; segment < segments; segment++) {
+            int a = ring * segments + segment;
+            int b = ring * segments + (segment + 1) % segments;
+            int c = a + segments;
+            int d = b + segments;
+            triangles.push_back({ vertices[a], vertices[b], vertices[c] });
+            triangles.push_back({ vertices[b], vertices[d], vertices[c] });
+        }
+    }
+    return triangles;
+}
+
+static std::vector<Triangle> loadOBJ(const QString& path) {
+    std::vector<Triangle> triangles;
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return triangles;
+    }
+
+    std::vector<glm::vec3> vertices;
+    QTextStream stream(&file);
+    while (!stream.atEnd()) {
+        auto parts = stream.readLine().split(' ', QString::SkipEmptyParts);
+        if (parts.size() >= 4 && parts[0] == "v") {
+            vertices.emplace_back(parts[1].toFloat(), parts[2].toFloat(), parts[3].toFloat());
+        } else if (parts.size() >= 4 && parts[0] == "f") {
+            // faces are fans of 1-based vertex indices, possibly followed by texture and normal indices
+            std::vector<int> indices;
+            for (int i = 1; i < parts.size(); i++) {
+                int index = parts[i].split('/')[0].toInt();
+                indices.push_back(index < 0 ? (int)vertices.size() + index : index - 1);
+            }
+            for (size_t i = 2; i < indices.size(); i++) {
+                if (indices[0] >= 0 && indices[0] < (int)vertices.size() &&
+                    indices[i - 1] >= 0 && indices[i - 1] < (int)vertices.size() &&
+                    indices[i] >= 0 && indices[i] < (int)vertices.size()) {
+                    triangles.push_back({ vertices[indices[0]], vertices[indices[i - 1]], vertices[indices[i]] });
+                }
+            }
+        }
+    }
+    return triangles;
+}
+
+struct Ray {
+    glm::vec3 origin;
+    glm::vec3 direction;
+};
+
+// rays from around the bounds of the set, aimed at points inside it
+static std::vector<Ray> generateRays(const AABox& bounds, int count) {
+    std::mt19937 generator(2);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    glm::vec3 center = bounds.calcCenter();
+    glm::vec3 dimensions = bounds.getDimensions();
+    float radius = glm::length(dimensions);
+
+    std::vector<Ray> rays;
+    for (int i = 0; i < count; i++) {
+        glm::vec3 target = bounds.getCorner() + dimensions * glm::vec3(unit(generator), unit(generator), unit(generator));
+        glm::vec3 offset = glm::normalize(glm::vec3(unit(generator), unit(generator), unit(generator)) - 0.5f) * radius;
+        glm::vec3 origin = (i % 4 == 0) ? center : center + offset;
+        rays.push_back({ origin, glm::normalize(target - origin) });
+    }
+    return rays;
+}
+
+static bool findBruteForceIntersection(const std::vector<Triangle>& triangles, const Ray& ray, float& distance) {
+    bool hit = false;
+    distance = FLT_MAX;
+    for (const auto& triangle : triangles) {
+        float triangleDistance;
+        if (findRayTriangleIntersection(ray.origin, ray.direction, triangle, triangleDistance) && triangleDistance < distance) {
+            distance = triangleDistance;
+            hit = true;
+        }
+    }
+    return hit;
+}
+
+static bool findBruteForceParabolaIntersection(const std::vector<Triangle>& triangles, const glm::vec3& origin,
+                                               const glm::vec3& velocity, const glm::vec3& acceleration, float& distance) {
+    bool hit = false;
+    distance = FLT_MAX;
+    for (const auto& triangle : triangles) {
+        float triangleDistance;
+        if (findParabolaTriangleIntersection(origin, velocity, acceleration, triangle, triangleDistance) && triangleDistance < distance) {
+            distance = triangleDistance;
+            hit = true;
+        }
+    }
+    return hit;
+}
+
+// The k-d tree of cells that TriangleSet used before its BVH, kept as the baseline of the benchmark
+class LegacyTriangleTree {
+public:
+    LegacyTriangleTree(const std::vector<Triangle>& triangles, const AABox& bounds) : _triangles(triangles) {
+        _root = std::make_shared<Cell>(bounds, 0);
+        for (size_t i = 0; i < _triangles.size(); i++) {
+            insert(*_root, i);
+        }
+    }
+
+    bool findRayIntersection(const glm::vec3& origin, const glm::vec3& direction, float& distance) const {
+        return findRayIntersection(*_root, origin, direction, 1.0f / direction, distance);
+    }
+
+private:
+    static const int MAX_DEPTH = 12;
+
+    struct Cell {
+        Cell(const AABox& bounds, int depth) : bounds(bounds), depth(depth) {}
+        AABox bounds;
+        int depth;
+        int population { 0 };
+        std::vector<size_t> triangleIndices;
+        std::shared_ptr<Cell> children[2];
+    };
+
+    static void getChildBounds(const AABox& bounds, AABox childBounds[2]) {
+        glm::vec3 dimensions = bounds.getDimensions();
+        int axis = 0;
+        for (int i = 0; i < 3; i++) {
+            if (dimensions[i] >= dimensions[(i + 1) % 3] && dimensions[i] >= dimensions[(i + 2) % 3]) {
+                axis = i;
+                break;
+            }
+        }
+        glm::vec3 newDimensions = dimensions;
+        newDimensions[axis] *= 0.5f;
+        glm::vec3 offset(0.0f);
+        offset[axis] = newDimensions[axis];
+        childBounds[0].setBox(bounds.getCorner(), newDimensions);
+        childBounds[1].setBox(bounds.getCorner() + offset, newDimensions);
+    }
+
+    void insert(Cell& cell, size_t triangleIndex) {
+        cell.population++;
+        if (cell.depth < MAX_DEPTH) {
+            AABox childBounds[2];
+            getChildBounds(cell.bounds, childBounds);
+            for (int i = 0; i < 2; i++) {
+                if (childBounds[i].contains(_triangles[triangleIndex])) {
+                    if (!cell.children[i]) {
+                        cell.children[i] = std::make_shared<Cell>(childBounds[i], cell.depth + 1);
+                    }
+                    insert(*cell.children[i], triangleIndex);
+                    return;
+                }
+            }
+        }
+        cell.triangleIndices.push_back(triangleIndex);
+    }
+
+    bool findRayIntersection(const Cell& cell, const glm::vec3& origin, const glm::vec3& direction,
+                             const glm::vec3& invDirection, float& distance) const {
+        if (cell.population < 1) {
+            return false;
+        }
+
+        bool intersects = false;
+        float bestDistance = FLT_MAX;
+        for (auto triangleIndex : cell.triangleIndices) {
+            float triangleDistance;
+            if (findRayTriangleIntersection(origin, direction, _triangles[triangleIndex], triangleDistance) &&
+                    triangleDistance < bestDistance) {
+                bestDistance = triangleDistance;
+                intersects = true;
+            }
+        }
+
+        std::list<std::pair<float, const Cell*>> sortedCells;
+        for (const auto& child : cell.children) {
+            if (!child) {
+                continue;
+            }
+            float priority = FLT_MAX;
+            if (child->bounds.contains(origin)) {
+                priority = 0.0f;
+            } else {
+                float childDistance = FLT_MAX;
+                BoxFace childFace;
+                glm::vec3 childNormal;
+                if (child->bounds.findRayIntersection(origin, direction, invDirection, childDistance, childFace, childNormal) &&
+                        childDistance < bestDistance) {
+                    priority = childDistance;
+                }
+            }
+            if (priority < FLT_MAX) {
+                if (!sortedCells.empty() && priority < sortedCells.front().first) {
+                    sortedCells.emplace_front(priority, child.get());
+                } else {
+                    sortedCells.emplace_back(priority, child.get());
+                }
+            }
+        }
+
+        for (const auto& sortedCell : sortedCells) {
+            if (sortedCell.first > bestDistance) {
+                break;
+            }
+            float childDistance = sortedCell.first;
+            if (findRayIntersection(*sortedCell.second, origin, direction, invDirection, childDistance) &&
+                    childDistance < bestDistance) {
+                bestDistance = childDistance;
+                intersects = true;
+                break;
+            }
+        }
+
+        if (intersects) {
+            distance = bestDistance;
+        }
+        return intersects;
+    }
+
+    const std::vector<Triangle>& _triangles;
+    std::shared_ptr<Cell> _root;
+};
+
+void TriangleSetTests::initTestCase() {
+    _modelPath = qgetenv(MODEL_PATH_ENV);
+}
+
+void TriangleSetTests::testRayIntersectionMatchesBruteForce() {
+    auto triangles = generateMesh(40, 60);
+    TriangleSet triangleSet;
+    for (const auto& triangle : triangles) {
+        triangleSet.insert(triangle);
+    }
+
+    auto rays = generateRays(triangleSet.getBounds(), NUM_QUERIES);
+    for (const auto& ray : rays) {
+        float expectedDistance;
+        bool expectedHit = findBruteForceIntersection(triangles, ray, expectedDistance);
+
+        float distance = FLT_MAX;
+        BoxFace face;
+        Triangle triangle;
+        bool hit = triangleSet.findRayIntersection(ray.origin, ray.direction, 1.0f / ray.direction, distance, face, triangle, true);
+
+        QCOMPARE(hit, expectedHit);
+        if (hit) {
+            QVERIFY(fabsf(distance - expectedDistance) < EPSILON);
+        }
+    }
+}
+
+void TriangleSetTests::testAxisAlignedRays() {
+    // a floor of unit quads, so that rays along the grid lines start on the planes of the boxes around them
+    const int GRID_SIZE = 20;
+    std::vector<Triangle> triangles;
+    for (int x = 0; x < GRID_SIZE; x++) {
+        for (int z = 0; z < GRID_SIZE; z++) {
+            glm::vec3 a(x, 0.0f, z);
+            glm::vec3 b(x + 1, 0.0f, z);
+            glm::vec3 c(x, 0.0f, z + 1);
+            glm::vec3 d(x + 1, 0.0f, z + 1);
+            triangles.push_back({ a, c, b });
+            triangles.push_back({ b, c, d });
+        }
+    }
+    TriangleSet triangleSet;
+    for (const auto& triangle : triangles) {
+        triangleSet.insert(triangle);
+    }
+
+    // straight down, with zero x and z components
+    const glm::vec3 DOWN(0.0f, -1.0f, 0.0f);
+    for (int x = 0; x <= GRID_SIZE; x++) {
+        for (int z = 0; z < GRID_SIZE; z++) {
+            Ray ray { glm::vec3(x, 1.0f, z + 0.25f), DOWN };
+            float expectedDistance;
+            QVERIFY(findBruteForceIntersection(triangles, ray, expectedDistance));
+
+            float distance = FLT_MAX;
+            BoxFace face;
+            Triangle triangle;
+            QVERIFY(triangleSet.findRayIntersection(ray.origin, ray.direction, 1.0f / ray.direction, distance, face, triangle, true));
+            QVERIFY(fabsf(distance - expectedDistance) < EPSILON);
+        }
+    }
+
+    // along the axes from the center of a mesh
+    auto mesh = generateMesh(40, 60);
+    TriangleSet meshSet;
+    for (const auto& triangle : mesh) {
+        meshSet.insert(triangle);
+    }
+    for (int axis = 0; axis < 3; axis++) {
+        for (float sign : { -1.0f, 1.0f }) {
+            Ray ray { meshSet.getBounds().calcCenter(), glm::vec3(0.0f) };
+            ray.direction[axis] = sign;
+            float expectedDistance;
+            bool expectedHit = findBruteForceIntersection(mesh, ray, expectedDistance);
+
+            float distance = FLT_MAX;
+            BoxFace face;
+            Triangle triangle;
+            bool hit = meshSet.findRayIntersection(ray.origin, ray.direction, 1.0f / ray.direction, distance, face, triangle, true);
+            QCOMPARE(hit, expectedHit);
+            if (hit) {
+                QVERIFY(fabsf(distance - expectedDistance) < EPSILON);
+            }
+        }
+    }
+}
+
+void TriangleSetTests::testParabolaIntersectionMatchesBruteForce() {
+    auto triangles = generateMesh(20, 30);
+    TriangleSet triangleSet;
+    for (const auto& triangle : triangles) {
+        triangleSet.insert(triangle);
+    }
+
+    const glm::vec3 ACCELERATION(0.0f, -0.5f, 0.0f);
+    const float SPEED = 2.0f;
+    auto rays = generateRays(triangleSet.getBounds(), NUM_QUERIES / 10);
+    for (const auto& ray : rays) {
+        glm::vec3 velocity = ray.direction * SPEED;
+        float expectedDistance;
+        bool expectedHit = findBruteForceParabolaIntersection(triangles, ray.origin, velocity, ACCELERATION, expectedDistance);
+
+        float distance = FLT_MAX;
+        BoxFace face;
+        Triangle triangle;
+        bool hit = triangleSet.findParabolaIntersection(ray.origin, velocity, ACCELERATION, distance, face, triangle, true);
+
+        QCOMPARE(hit, expectedHit);
+        if (hit) {
+            QVERIFY(fabsf(distance - expectedDistance) < EPSILON);
+        }
+    }
+}
+
+void TriangleSetTests::testEmptySet() {
+    TriangleSet triangleSet;
+    float distance = FLT_MAX;
+    BoxFace face;
+    Triangle triangle;
+    glm::vec3 direction(0.0f, 0.0f, -1.0f);
+    QCOMPARE(triangleSet.findRayIntersection(glm::vec3(0.0f), direction, 1.0f / direction, distance, face, triangle, true), false);
+}
+
+void TriangleSetTests::benchmarkBuildAndQuery() {
+    std::vector<Triangle> triangles;
+    if (!_modelPath.isEmpty()) {
+        triangles = loadOBJ(_modelPath);
+        qDebug() << "Loaded" << triangles.size() << "triangles from" << _modelPath;
+    }
+    if (triangles.empty()) {
+        triangles = generateMesh(400, 500);
+        qDebug() << "Generated" << triangles.size() << "triangles, set" << MODEL_PATH_ENV << "to use a model";
+    }
+
+    TriangleSet triangleSet;
+    triangleSet.reserve(triangles.size());
+    for (const auto& triangle : triangles) {
+        triangleSet.insert(triangle);
+    }
+
+    auto start = usecTimestampNow();
+    triangleSet.balanceTree();
+    auto buildUsecs = usecTimestampNow() - start;
+
+    auto rays = generateRays(triangleSet.getBounds(), NUM_QUERIES);
+
+    int hits = 0;
+    start = usecTimestampNow();
+    for (const auto& ray : rays) {
+        float distance = FLT_MAX;
+        BoxFace face;
+        Triangle triangle;
+        if (triangleSet.findRayIntersection(ray.origin, ray.direction, 1.0f / ray.direction, distance, face, triangle, true)) {
+            hits++;
+        }
+    }
+    auto queryUsecs = usecTimestampNow() - start;
+
+    // the cell tree TriangleSet used before
+    start = usecTimestampNow();
+    LegacyTriangleTree legacyTree(triangles, triangleSet.getBounds());
+    auto legacyBuildUsecs = usecTimestampNow() - start;
+
+    int legacyHits = 0;
+    start = usecTimestampNow();
+    for (const auto& ray : rays) {
+        float distance = FLT_MAX;
+        if (legacyTree.findRayIntersection(ray.origin, ray.direction, distance)) {
+            legacyHits++;
+        }
+    }
+    auto legacyQueryUsecs = usecTimestampNow() - start;
+
+    // the brute force baseline is slow, a tenth of the rays is enough
+    int bruteForceHits = 0;
+    int bruteForceQueries = NUM_QUERIES / 10;
+    start = usecTimestampNow();
+    for (int i = 0; i < bruteForceQueries; i++) {
+        float distance;
+        if (findBruteForceIntersection(triangles, rays[i], distance)) {
+            bruteForceHits++;
+        }
+    }
+    auto bruteForceUsecs = usecTimestampNow() - start;
+
+    qDebug() << "Build took" << (float)buildUsecs / USECS_PER_MSEC << "ms";
+    qDebug() << "Ray query took" << (float)queryUsecs / NUM_QUERIES << "us on average," << hits << "hits of" << NUM_QUERIES;
+    qDebug() << "Cell tree build took" << (float)legacyBuildUsecs / USECS_PER_MSEC << "ms";
+    qDebug() << "Cell tree ray query took" << (float)legacyQueryUsecs / NUM_QUERIES << "us on average,"
+        << legacyHits << "hits of" << NUM_QUERIES;
+    qDebug() << "Brute force query took" << (float)bruteForceUsecs / bruteForceQueries << "us on average";
+    QVERIFY(hits > 0);
+}
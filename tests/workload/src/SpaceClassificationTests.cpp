@@ -0,0 +1,158 @@
+//
+//  SpaceClassificationTests.cpp
+//  tests/workload/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SpaceClassificationTests.h"
+
+#include <glm/gtx/norm.hpp>
+
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+#include <workload/Space.h>
+
+QTEST_MAIN(SpaceClassificationTests)
+
+static const float WORLD_HALF_WIDTH = 500.0f;
+static const float MIN_RADIUS = 0.1f;
+static const float MAX_RADIUS = 5.0f;
+static const int NUM_FRAMES = 20;
+// each frame the view walks this far and this fraction of the proxies move
+static const float VIEW_STEP = 1.0f;
+static const float MOVING_FRACTION = 0.01f;
+
+static workload::Sphere randomSphere() {
+    return workload::Sphere(randFloatInRange(-WORLD_HALF_WIDTH, WORLD_HALF_WIDTH), randFloatInRange(-0.1f, 0.1f) * WORLD_HALF_WIDTH,
+                            randFloatInRange(-WORLD_HALF_WIDTH, WORLD_HALF_WIDTH), randFloatInRange(MIN_RADIUS, MAX_RADIUS));
+}
+
+static workload::Views makeViews(const glm::vec3& origin) {
+    workload::View view;
+    view.origin = origin;
+    workload::View::updateRegionsDefault(view);
+    return workload::Views({ view });
+}
+
+static std::vector<workload::ProxyID> addProxies(workload::Space& space, int numProxies) {
+    std::vector<workload::ProxyID> proxyIDs;
+    workload::Transaction transaction;
+    for (int i = 0; i < numProxies; i++) {
+        proxyIDs.push_back(space.allocateID());
+        transaction.reset(proxyIDs.back(), randomSphere(), workload::Owner());
+    }
+    space.enqueueTransaction(transaction);
+    space.processTransactionQueue();
+    return proxyIDs;
+}
+
+static void moveProxies(workload::Space& space, const std::vector<workload::ProxyID>& proxyIDs) {
+    workload::Transaction transaction;
+    int numMoving = (int)(MOVING_FRACTION * proxyIDs.size());
+    for (int i = 0; i < numMoving; i++) {
+        transaction.update(proxyIDs[rand() % proxyIDs.size()], randomSphere());
+    }
+    space.enqueueTransaction(transaction);
+    space.processTransactionQueue();
+}
+
+// The classification of every proxy against every region, as the space used to do it every frame
+static std::vector<uint8_t> classifyAll(const workload::Space& space, const workload::Views& views) {
+    std::vector<workload::Proxy> proxies(space.getNumAllocatedProxies());
+    proxies.resize(space.copyProxyValues(proxies.data(), (uint32_t)proxies.size()));
+    std::vector<uint8_t> regions(proxies.size(), workload::Region::INVALID);
+    for (size_t i = 0; i < proxies.size(); i++) {
+        if (proxies[i].region < workload::Region::INVALID) {
+            uint8_t region = workload::Region::UNKNOWN;
+            for (const auto& view : views) {
+                for (uint8_t k = 0; k < region; ++k) {
+                    float touchDistance = proxies[i].sphere.w + view.regions[k].w;
+                    if (glm::distance2(glm::vec3(proxies[i].sphere), glm::vec3(view.regions[k])) < touchDistance * touchDistance) {
+                        region = k;
+                        break;
+                    }
+                }
+            }
+            regions[i] = region;
+        }
+    }
+    return regions;
+}
+
+void SpaceClassificationTests::testIncrementalClassification() {
+    const int NUM_PROXIES = 20000;
+    srand(1);
+    workload::Space space;
+    auto proxyIDs = addProxies(space, NUM_PROXIES);
+
+    workload::Changes changes;
+    for (int frame = 0; frame < NUM_FRAMES; frame++) {
+        auto views = makeViews(glm::vec3(VIEW_STEP * frame, 0.0f, 0.0f));
+        space.setViews(views);
+        if (frame > 0) {
+            moveProxies(space, proxyIDs);
+        }
+
+        changes.clear();
+        space.categorizeAndGetChanges(changes);
+
+        // every proxy has the region a full classification gives it, and the changes are reported in proxy order
+        auto expectedRegions = classifyAll(space, views);
+        for (auto proxyID : proxyIDs) {
+            QCOMPARE(space.getRegion(proxyID), expectedRegions[proxyID]);
+        }
+        for (size_t i = 1; i < changes.size(); i++) {
+            QVERIFY(changes[i - 1].proxyId < changes[i].proxyId);
+        }
+        if (frame == 0) {
+            QVERIFY(!changes.empty());
+        }
+    }
+}
+
+void SpaceClassificationTests::benchmarkScaling() {
+    srand(1);
+    for (int numProxies : { 10000, 100000, 400000 }) {
+        workload::Space space;
+        auto proxyIDs = addProxies(space, numProxies);
+
+        // static proxies, moving view
+        uint64_t usecs = 0;
+        size_t numChanges = 0;
+        for (int frame = 0; frame < NUM_FRAMES; frame++) {
+            space.setViews(makeViews(glm::vec3(VIEW_STEP * frame, 0.0f, 0.0f)));
+            workload::Changes changes;
+            auto start = usecTimestampNow();
+            space.categorizeAndGetChanges(changes);
+            usecs += frame > 0 ? usecTimestampNow() - start : 0;
+            numChanges += changes.size();
+        }
+        float staticMsecs = (float)usecs / (NUM_FRAMES - 1) / USECS_PER_MSEC;
+
+        // one percent of the proxies moving every frame
+        usecs = 0;
+        for (int frame = 0; frame < NUM_FRAMES; frame++) {
+            space.setViews(makeViews(glm::vec3(VIEW_STEP * (NUM_FRAMES + frame), 0.0f, 0.0f)));
+            moveProxies(space, proxyIDs);
+            workload::Changes changes;
+            auto start = usecTimestampNow();
+            space.categorizeAndGetChanges(changes);
+            usecs += usecTimestampNow() - start;
+        }
+        float movingMsecs = (float)usecs / NUM_FRAMES / USECS_PER_MSEC;
+
+        // the cost of classifying every proxy
+        auto views = makeViews(glm::vec3(0.0f));
+        auto start = usecTimestampNow();
+        auto regions = classifyAll(space, views);
+        float fullMsecs = (float)(usecTimestampNow() - start) / USECS_PER_MSEC;
+
+        qDebug() << numProxies << "proxies:" << staticMsecs << "ms with a moving view," << movingMsecs
+            << "ms with moving proxies," << fullMsecs << "ms to classify all of them," << numChanges << "changes";
+        QVERIFY(regions.size() >= (size_t)numProxies);
+    }
+}
@@ -0,0 +1,24 @@
+//
+//  SpaceClassificationTests.h
+//  tests/workload/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_workload_SpaceClassificationTests_h
+#define hifi_workload_SpaceClassificationTests_h
+
+#include <QtTest/QtTest>
+
+class SpaceClassificationTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testIncrementalClassification();
+    void benchmarkScaling();
+};
+
+#endif // hifi_workload_SpaceClassificationTests_h
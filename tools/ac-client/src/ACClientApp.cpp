@@ -11,6 +11,8 @@
 
 #include "ACClientApp.h"
 
+#include <algorithm>
+
 #include <QDataStream>
 #include <QThread>
 #include <QLoggingCategory>
@@ -18,10 +20,17 @@
 
 #include <NetworkLogging.h>
 #include <NetworkingConstants.h>
+#include <NumericalConstants.h>
 #include <SharedLogging.h>
 #include <AddressManager.h>
 #include <DependencyManager.h>
+#include <MessagesClient.h>
 #include <SettingHandle.h>
+#include <SharedUtil.h>
+
+static const QString LOAD_CHANNEL_PREFIX = "ac-client-load-";
+static const int LOAD_SEND_INTERVAL_MSECS = 10;
+static const int DOMAIN_CONNECTION_TIMEOUT_MSECS = 4000;
 
 ACClientApp::ACClientApp(int argc, char* argv[]) :
     QCoreApplication(argc, argv)
@@ -47,6 +56,18 @@ ACClientApp::ACClientApp(int argc, char* argv[]) :
     const QCommandLineOption listenPortOption("listenPort", "listen port", QString::number(INVALID_PORT));
     parser.addOption(listenPortOption);
 
+    const QCommandLineOption messagesLoadOption("messagesLoad", "load the messages mixer, subscribe to and send on this many channels", "channels");
+    parser.addOption(messagesLoadOption);
+
+    const QCommandLineOption messagesRateOption("messagesRate", "messages sent per second on each load channel", "10");
+    parser.addOption(messagesRateOption);
+
+    const QCommandLineOption messagesSizeOption("messagesSize", "bytes of data in each load message", "256");
+    parser.addOption(messagesSizeOption);
+
+    const QCommandLineOption messagesDurationOption("messagesDuration", "seconds to run the messages mixer load for", "10");
+    parser.addOption(messagesDurationOption);
+
     if (!parser.parse(QCoreApplication::arguments())) {
         qCritical() << parser.errorText() << endl;
         parser.showHelp();
@@ -98,11 +119,22 @@ ACClientApp::ACClientApp(int argc, char* argv[]) :
         _password = pieces[1];
     }
 
+    if (parser.isSet(messagesLoadOption)) {
+        _loadChannels = std::max(parser.value(messagesLoadOption).toInt(), 1);
+        _loadRate = parser.isSet(messagesRateOption) ? std::max(parser.value(messagesRateOption).toInt(), 1) : 10;
+        _loadSize = parser.isSet(messagesSizeOption) ? parser.value(messagesSizeOption).toInt() : 256;
+        _loadSize = std::max(_loadSize, (int)sizeof(quint64));
+        _loadDuration = parser.isSet(messagesDurationOption) ? std::max(parser.value(messagesDurationOption).toInt(), 1) : 10;
+    }
+
     DependencyManager::registerInheritance<LimitedNodeList, NodeList>();
 
     DependencyManager::set<AccountManager>([&]{ return QString("Mozilla/5.0 (HighFidelityACClient)"); });
     DependencyManager::set<AddressManager>();
     DependencyManager::set<NodeList>(NodeType::Agent, listenPort);
+    if (_loadChannels > 0) {
+        DependencyManager::set<MessagesClient>();
+    }
 
     auto accountManager = DependencyManager::get<AccountManager>();
     accountManager->setIsAgent(true);
@@ -159,7 +191,17 @@ ACClientApp::ACClientApp(int argc, char* argv[]) :
     QTimer* doTimer = new QTimer(this);
     doTimer->setSingleShot(true);
     connect(doTimer, &QTimer::timeout, this, &ACClientApp::timedOut);
-    doTimer->start(4000);
+    doTimer->start(DOMAIN_CONNECTION_TIMEOUT_MSECS + _loadDuration * (int)MSECS_PER_SECOND);
+
+    if (_loadChannels > 0) {
+        auto messagesClient = DependencyManager::get<MessagesClient>();
+        connect(messagesClient.data(), &MessagesClient::dataReceived, this, &ACClientApp::loadDataReceived);
+
+        // the messages client subscribes again when the messages mixer is activated
+        for (int i = 0; i < _loadChannels; i++) {
+            messagesClient->subscribe(LOAD_CHANNEL_PREFIX + QString::number(i));
+        }
+    }
 }
 
 ACClientApp::~ACClientApp() {
@@ -212,6 +254,13 @@ void ACClientApp::nodeActivated(SharedNodePointer node) {
             qDebug() << "saw MessagesMixer";
         }
         _sawMessagesMixer = true;
+        if (_loadChannels > 0) {
+            startMessagesLoad();
+        }
+    }
+
+    if (_loadChannels > 0) {
+        return;
     }
 
     if (_sawEntityServer && _sawAudioMixer && _sawAvatarMixer && _sawAssetServer && _sawMessagesMixer) {
@@ -226,6 +275,75 @@ void ACClientApp::nodeKilled(SharedNodePointer node) {
     qDebug() << "nodeKilled";
 }
 
+void ACClientApp::startMessagesLoad() {
+    if (_loadTimer) {
+        return;
+    }
+    if (_verbose) {
+        qDebug() << "sending" << _loadRate << "messages per second of" << _loadSize << "bytes on" << _loadChannels
+            << "channels for" << _loadDuration << "seconds";
+    }
+
+    _loadStart = usecTimestampNow();
+    _loadTimer = new QTimer(this);
+    connect(_loadTimer, &QTimer::timeout, this, &ACClientApp::sendLoadMessages);
+    _loadTimer->start(LOAD_SEND_INTERVAL_MSECS);
+}
+
+void ACClientApp::sendLoadMessages() {
+    auto now = usecTimestampNow();
+    auto elapsed = now - _loadStart;
+    if (elapsed >= (quint64)_loadDuration * USECS_PER_SECOND) {
+        _loadTimer->stop();
+        printMessagesLoadResults();
+        finish(0);
+        return;
+    }
+
+    // catch up with the rate, whatever the timer precision
+    quint64 messagesDue = elapsed * _loadRate * _loadChannels / USECS_PER_SECOND;
+    if (messagesDue <= _loadMessagesSent) {
+        return;
+    }
+
+    // the send time leads the data, the receiver measures the latency from it
+    QByteArray data(_loadSize, 0);
+    memcpy(data.data(), &now, sizeof(now));
+
+    auto messagesClient = DependencyManager::get<MessagesClient>();
+    while (_loadMessagesSent < messagesDue) {
+        messagesClient->sendData(LOAD_CHANNEL_PREFIX + QString::number(_loadMessagesSent % _loadChannels), data);
+        ++_loadMessagesSent;
+    }
+}
+
+void ACClientApp::loadDataReceived(QString channel, QByteArray data, QUuid senderID, bool localOnly) {
+    if (localOnly || !channel.startsWith(LOAD_CHANNEL_PREFIX) || data.size() < (int)sizeof(quint64)) {
+        return;
+    }
+    ++_loadMessagesReceived;
+    _loadBytesReceived += data.size();
+
+    // only the messages of this client were timed with its clock
+    if (senderID == DependencyManager::get<NodeList>()->getSessionUUID()) {
+        quint64 sentTime;
+        memcpy(&sentTime, data.constData(), sizeof(sentTime));
+        _loadLatencySum += usecTimestampNow() - sentTime;
+        ++_loadOwnMessagesReceived;
+    }
+}
+
+void ACClientApp::printMessagesLoadResults() {
+    float seconds = (float)(usecTimestampNow() - _loadStart) / USECS_PER_SECOND;
+    qDebug() << "messages sent:" << _loadMessagesSent << "-" << _loadMessagesSent / seconds << "per second";
+    qDebug() << "messages received:" << _loadMessagesReceived << "-" << _loadMessagesReceived / seconds << "per second,"
+        << _loadBytesReceived / (seconds * BYTES_PER_KILOBIT) << "kbps";
+    if (_loadOwnMessagesReceived > 0) {
+        qDebug() << "average latency:" << (float)_loadLatencySum / _loadOwnMessagesReceived / USECS_PER_MSEC << "ms,"
+            << "over" << _loadOwnMessagesReceived << "messages sent by this client";
+    }
+}
+
 void ACClientApp::timedOut() {
     if (_verbose) {
         qDebug() << "timed out: " << _sawEntityServer << _sawAudioMixer <<
@@ -270,6 +388,7 @@ void ACClientApp::finish(int exitCode) {
     nodeList->getPacketReceiver().setShouldDropPackets(true);
 
     // remove the NodeList from the DependencyManager
+    DependencyManager::destroy<MessagesClient>();
     DependencyManager::destroy<NodeList>();
 
     printFailedServers();
@@ -14,6 +14,7 @@
 #define hifi_ACClientApp_h
 
 #include <QCoreApplication>
+#include <QTimer>
 #include <udt/Constants.h>
 #include <udt/Socket.h>
 #include <ReceivedMessage.h>
@@ -34,12 +35,16 @@ private slots:
     void nodeActivated(SharedNodePointer node);
     void nodeKilled(SharedNodePointer node);
     void notifyPacketVersionMismatch();
+    void sendLoadMessages();
+    void loadDataReceived(QString channel, QByteArray data, QUuid senderID, bool localOnly);
 
 private:
     NodeList* _nodeList;
     void timedOut();
     void printFailedServers();
     void finish(int exitCode);
+    void startMessagesLoad();
+    void printMessagesLoadResults();
     bool _verbose;
 
     bool _sawEntityServer { false };
@@ -50,6 +55,19 @@ private:
 
     QString _username;
     QString _password;
+
+    // messages mixer load test
+    int _loadChannels { 0 };
+    int _loadRate { 0 };
+    int _loadSize { 0 };
+    int _loadDuration { 0 };
+    QTimer* _loadTimer { nullptr };
+    quint64 _loadStart { 0 };
+    quint64 _loadMessagesSent { 0 };
+    quint64 _loadMessagesReceived { 0 };
+    quint64 _loadBytesReceived { 0 };
+    quint64 _loadOwnMessagesReceived { 0 };
+    quint64 _loadLatencySum { 0 }; // of the messages sent by this client
 };
 
 #endif //hifi_ACClientApp_h
@@ -0,0 +1,604 @@
+//
+//  SwarmAgent.cpp
+//  tools/swarm/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SwarmAgent.h"
+
+#include <QDataStream>
+
+#include <glm/gtc/quaternion.hpp>
+
+#include <AudioConstants.h>
+#include <AvatarData.h>
+#include <EntityItemProperties.h>
+#include <GLMHelpers.h>
+#include <NodeList.h>
+#include <NodePermissions.h>
+#include <NumericalConstants.h>
+#include <OctreeQuery.h>
+#include <SharedUtil.h>
+#include <ViewFrustum.h>
+#include <shared/ConicalViewFrustum.h>
+
+static const int AVATAR_SEND_INTERVAL_MSECS = 20; // interface sends its avatar 50 times a second
+static const int QUERY_INTERVAL_MSECS = 1000;
+static const int MAX_CATCH_UP_AUDIO_FRAMES = 5;
+static const float WALK_RADIUS = 1.0f;
+static const float WALK_SPEED = 0.2f; // radians per second around the walk circle
+static const float ENTITY_ORBIT_RADIUS = 2.0f;
+static const int ENTITY_LIFETIME_MARGIN_SECS = 60; // left entities expire on their own if the agent can't erase them
+
+// A few seconds of voiced, syllabic sound with pauses, shared by every agent from a different offset
+static const std::vector<int16_t>& speechLoop() {
+    static const std::vector<int16_t> loop = [] {
+        const int LOOP_SECS = 4;
+        const float PITCH = 140.0f;
+        const float SYLLABLES_PER_SECOND = 4.0f;
+        const int NUM_HARMONICS = 4;
+        const float AMPLITUDE = 0.25f * AudioConstants::MAX_SAMPLE_VALUE;
+
+        std::vector<int16_t> samples(LOOP_SECS * AudioConstants::SAMPLE_RATE);
+        for (size_t i = 0; i < samples.size(); i++) {
+            float t = (float)i / AudioConstants::SAMPLE_RATE;
+            float envelope = 0.5f * (1.0f - cosf(TWO_PI * SYLLABLES_PER_SECOND * t));
+            float value = 0.0f;
+            for (int harmonic = 1; harmonic <= NUM_HARMONICS; harmonic++) {
+                value += sinf(TWO_PI * PITCH * harmonic * t) / harmonic;
+            }
+            value = value * envelope + 0.05f * (randFloat() - 0.5f);
+            samples[i] = (int16_t)glm::clamp(AMPLITUDE * value, (float)AudioConstants::MIN_SAMPLE_VALUE,
+                                             (float)AudioConstants::MAX_SAMPLE_VALUE);
+        }
+        return samples;
+    }();
+    return loop;
+}
+
+SwarmAgent::SwarmAgent(int index, const Options& options) :
+    _index(index),
+    _options(options)
+{
+}
+
+SwarmAgent::~SwarmAgent() {
+}
+
+QString SwarmAgent::getChannelName(Channel channel) {
+    switch (channel) {
+        case Domain:
+            return "domain-server";
+        case Audio:
+            return NodeType::getNodeTypeName(NodeType::AudioMixer).toLower().replace(' ', '-');
+        case Avatars:
+            return NodeType::getNodeTypeName(NodeType::AvatarMixer).toLower().replace(' ', '-');
+        case Entities:
+            return NodeType::getNodeTypeName(NodeType::EntityServer).toLower().replace(' ', '-');
+        default:
+            return QString();
+    }
+}
+
+QString SwarmAgent::getDeniedReason() const {
+    std::lock_guard<std::mutex> lock(_deniedReasonMutex);
+    return _deniedReason;
+}
+
+void SwarmAgent::start() {
+    _startUsecs = usecTimestampNow();
+    _machineFingerprint = QUuid::createUuid();
+    _servers[Domain].sockAddr = _options.domainServer;
+    _audioOffset = ((size_t)_index * 7919) % speechLoop().size();
+
+    _socket = new udt::Socket(this);
+    _socket->bind(QHostAddress::LocalHost);
+    _socket->setPacketFilterOperator([](const udt::Packet& packet) {
+        // an agent can't adapt to other protocol versions, drop what it would misread
+        return NLPacket::versionInHeader(packet) == versionForPacketType(NLPacket::typeInHeader(packet));
+    });
+    _socket->setPacketHandler([this](std::unique_ptr<udt::Packet> packet) {
+        handlePacket(std::move(packet));
+    });
+    _socket->setMessageHandler([this](std::unique_ptr<udt::Packet> packet) {
+        // nothing the agent acts on comes reliably, the messages are only counted
+        Channel channel = channelForSockAddr(packet->getSenderSockAddr());
+        if (channel != NUM_CHANNELS) {
+            ++_received[channel].packets;
+            _received[channel].bytes += packet->getDataSize();
+        }
+    });
+
+    _avatar.reset(new AvatarData());
+    _avatar->setDisplayName(QString("swarm-%1").arg(_index));
+    _entityQuery.reset(new OctreeQuery(true));
+
+    _checkInTimer = new QTimer(this);
+    connect(_checkInTimer, &QTimer::timeout, this, &SwarmAgent::sendDomainCheckIn);
+    _checkInTimer->start(DOMAIN_SERVER_CHECK_IN_MSECS);
+
+    _audioTimer = new QTimer(this);
+    _audioTimer->setTimerType(Qt::PreciseTimer);
+    connect(_audioTimer, &QTimer::timeout, this, &SwarmAgent::sendAudio);
+    _audioTimer->start((int)AudioConstants::NETWORK_FRAME_MSECS);
+
+    _avatarTimer = new QTimer(this);
+    _avatarTimer->setTimerType(Qt::PreciseTimer);
+    connect(_avatarTimer, &QTimer::timeout, this, &SwarmAgent::sendAvatarData);
+    _avatarTimer->start(AVATAR_SEND_INTERVAL_MSECS);
+
+    _queryTimer = new QTimer(this);
+    connect(_queryTimer, &QTimer::timeout, this, &SwarmAgent::sendQueriesAndPings);
+    _queryTimer->start(QUERY_INTERVAL_MSECS);
+
+    if (_options.numEntities > 0 && _options.entityEditRate > 0.0f) {
+        _entityTimer = new QTimer(this);
+        connect(_entityTimer, &QTimer::timeout, this, &SwarmAgent::sendEntityEdit);
+        _entityTimer->start(std::max((int)(MSECS_PER_SECOND / (_options.entityEditRate * _options.numEntities)), 1));
+    }
+
+    sendDomainCheckIn();
+}
+
+void SwarmAgent::stop() {
+    for (auto timer : { _checkInTimer, _audioTimer, _avatarTimer, _queryTimer, _entityTimer }) {
+        if (timer) {
+            timer->stop();
+        }
+    }
+
+    eraseEntities();
+
+    if (!_sessionUUID.isNull()) {
+        send(NLPacket::create(PacketType::DomainDisconnectRequest, 0), Domain);
+    }
+}
+
+void SwarmAgent::sendDomainCheckIn() {
+    bool isConnected = !_sessionUUID.isNull();
+    auto packet = NLPacket::create(isConnected ? PacketType::DomainListRequest : PacketType::DomainConnectRequest);
+    QDataStream packetStream(packet.get());
+
+    if (!isConnected) {
+        // not an assignment or an ICE client, no hardware address and a fingerprint of our own
+        packetStream << QUuid();
+        QByteArray protocolVersionSig = protocolVersionsSignature();
+        packetStream.writeBytes(protocolVersionSig.constData(), protocolVersionSig.size());
+        packetStream << QString() << _machineFingerprint;
+    }
+
+    // without an address for our public socket the domain-server uses the one it hears us on
+    quint16 port = _socket->localPort();
+    QList<NodeType_t> nodeTypesOfInterest { NodeType::AudioMixer, NodeType::AvatarMixer, NodeType::EntityServer };
+    packetStream << (NodeType_t)NodeType::Agent << HifiSockAddr(QHostAddress(), port)
+        << HifiSockAddr(QHostAddress::LocalHost, port) << nodeTypesOfInterest << QString();
+
+    if (isConnected) {
+        // the agent keeps no list a delta could be applied to, always ask for a full one
+        packetStream << (quint32)0;
+    } else {
+        packetStream << QString();
+    }
+
+    send(std::move(packet), Domain);
+}
+
+void SwarmAgent::handlePacket(std::unique_ptr<udt::Packet> packet) {
+    auto nlPacket = NLPacket::fromBase(std::move(packet));
+    Channel channel = channelForSockAddr(nlPacket->getSenderSockAddr());
+    if (channel == NUM_CHANNELS) {
+        return;
+    }
+    ++_received[channel].packets;
+    _received[channel].bytes += nlPacket->getDataSize();
+
+    switch (nlPacket->getType()) {
+        case PacketType::DomainList:
+            if (channel == Domain) {
+                processDomainList(*nlPacket);
+            }
+            break;
+        case PacketType::DomainConnectionDenied: {
+            std::lock_guard<std::mutex> lock(_deniedReasonMutex);
+            if (_deniedReason.isEmpty()) {
+                _deniedReason = "connection denied by the domain-server";
+                qWarning() << "Swarm agent" << _index << "was denied a connection to the domain-server";
+            }
+            break;
+        }
+        case PacketType::Ping:
+            processPing(*nlPacket, channel);
+            break;
+        case PacketType::PingReply:
+            processPingReply(*nlPacket, channel);
+            break;
+        default:
+            break;
+    }
+
+    if (channel != Domain && !_servers[channel].heardFrom) {
+        _servers[channel].heardFrom = true;
+        checkConnected();
+    }
+}
+
+void SwarmAgent::processDomainList(NLPacket& packet) {
+    QByteArray payload = QByteArray::fromRawData(packet.getPayload(), (int)packet.getPayloadSize());
+    QDataStream packetStream(payload);
+
+    QUuid domainUUID;
+    NLPacket::LocalID domainLocalID;
+    QUuid sessionUUID;
+    NLPacket::LocalID sessionLocalID;
+    NodePermissions permissions;
+    bool authenticatePackets;
+    quint32 listRevision;
+    quint32 baseRevision;
+    quint32 listNodeCount;
+    QList<QUuid> removedNodes;
+    packetStream >> domainUUID >> domainLocalID >> sessionUUID >> sessionLocalID >> permissions >> authenticatePackets
+        >> listRevision >> baseRevision >> listNodeCount >> removedNodes;
+
+    if (!_sessionUUID.isNull() && (sessionUUID != _sessionUUID || sessionLocalID != _sessionLocalID)) {
+        qWarning() << "Swarm agent" << _index << "was given a new session by the domain-server";
+        for (auto& server : _servers) {
+            if (&server != &_servers[Domain]) {
+                server = Server();
+            }
+        }
+        _connectUsecs = 0;
+        _entitiesAdded = false;
+    }
+    _domainUUID = domainUUID;
+    _domainLocalID = domainLocalID;
+    _sessionUUID = sessionUUID;
+    _sessionLocalID = sessionLocalID;
+    _authenticatePackets = authenticatePackets;
+    _avatar->setSessionUUID(sessionUUID);
+
+    while (!packetStream.atEnd()) {
+        qint8 nodeType;
+        QUuid nodeUUID;
+        QUuid connectionSecret;
+        HifiSockAddr publicSocket;
+        HifiSockAddr localSocket;
+        NodePermissions nodePermissions;
+        bool isReplicated;
+        NLPacket::LocalID nodeLocalID;
+        packetStream >> nodeType >> nodeUUID >> publicSocket >> localSocket >> nodePermissions >> isReplicated
+            >> nodeLocalID >> connectionSecret;
+        if (packetStream.status() != QDataStream::Ok) {
+            break;
+        }
+
+        Channel channel = nodeType == NodeType::AudioMixer ? Audio :
+            nodeType == NodeType::AvatarMixer ? Avatars :
+            nodeType == NodeType::EntityServer ? Entities : NUM_CHANNELS;
+        if (channel == NUM_CHANNELS) {
+            continue;
+        }
+
+        // servers on the domain-server's machine are reached at its address
+        if (publicSocket.getAddress().isNull()) {
+            publicSocket.setAddress(_servers[Domain].sockAddr.getAddress());
+        }
+
+        Server& server = _servers[channel];
+        if (server.uuid != nodeUUID) {
+            server = Server();
+            server.uuid = nodeUUID;
+            server.hmac.reset(new HMACAuth());
+        }
+        server.sockAddr = publicSocket;
+        server.localID = nodeLocalID;
+        server.hmac->setKey(connectionSecret);
+    }
+}
+
+void SwarmAgent::processPing(NLPacket& packet, Channel channel) {
+    PingType_t pingType;
+    quint64 pingTime;
+    packet.readPrimitive(&pingType);
+    packet.readPrimitive(&pingTime);
+
+    // a mixer activates our socket when it hears the reply
+    auto replyPacket = NLPacket::create(PacketType::PingReply, sizeof(PingType_t) + 2 * sizeof(quint64));
+    replyPacket->writePrimitive(pingType);
+    replyPacket->writePrimitive(pingTime);
+    replyPacket->writePrimitive(usecTimestampNow());
+    send(std::move(replyPacket), channel, &packet.getSenderSockAddr());
+}
+
+void SwarmAgent::processPingReply(NLPacket& packet, Channel channel) {
+    PingType_t pingType;
+    quint64 pingTime;
+    packet.readPrimitive(&pingType);
+    packet.readPrimitive(&pingTime);
+
+    quint64 now = usecTimestampNow();
+    if (pingTime > now) {
+        return;
+    }
+    quint64 roundTripUsecs = now - pingTime;
+    PingStats& stats = _pings[channel];
+    ++stats.numReplies;
+    stats.totalUsecs += roundTripUsecs;
+    quint64 maxUsecs = stats.maxUsecs;
+    while (roundTripUsecs > maxUsecs && !stats.maxUsecs.compare_exchange_weak(maxUsecs, roundTripUsecs)) {
+    }
+}
+
+void SwarmAgent::checkConnected() {
+    if (_connectUsecs > 0) {
+        return;
+    }
+    for (int channel = Audio; channel < NUM_CHANNELS; channel++) {
+        if (!_servers[channel].heardFrom) {
+            return;
+        }
+    }
+    _connectUsecs = std::max(usecTimestampNow() - _startUsecs, (quint64)1);
+    addEntities();
+}
+
+SwarmAgent::Channel SwarmAgent::channelForSockAddr(const HifiSockAddr& sockAddr) const {
+    for (int channel = 0; channel < NUM_CHANNELS; channel++) {
+        if (_servers[channel].sockAddr == sockAddr) {
+            return (Channel)channel;
+        }
+    }
+    return NUM_CHANNELS;
+}
+
+SwarmAgent::Server* SwarmAgent::serverForChannel(Channel channel) {
+    Server& server = _servers[channel];
+    if (channel != Domain && server.uuid.isNull()) {
+        return nullptr;
+    }
+    return &server;
+}
+
+// Fills in the header as LimitedNodeList would and sends the packet to the server of the channel
+void SwarmAgent::send(std::unique_ptr<NLPacket> packet, Channel channel, const HifiSockAddr* overrideSockAddr) {
+    Server* server = serverForChannel(channel);
+    if (!server || (_sessionUUID.isNull() && packet->getType() != PacketType::DomainConnectRequest)) {
+        return;
+    }
+
+    PacketType type = packet->getType();
+    if (!PacketTypeEnum::getNonSourcedPackets().contains(type)) {
+        packet->writeSourceID(_sessionLocalID);
+    }
+    if (_authenticatePackets && server->hmac && !PacketTypeEnum::getNonSourcedPackets().contains(type) &&
+        !PacketTypeEnum::getNonVerifiedPackets().contains(type)) {
+        packet->writeVerificationHash(*server->hmac);
+    }
+
+    ++_sent[channel].packets;
+    _sent[channel].bytes += packet->getDataSize();
+    _socket->writePacket(std::move(packet), overrideSockAddr ? *overrideSockAddr : server->sockAddr);
+}
+
+// Walks a small circle around a home on a disk of the spread radius
+glm::vec3 SwarmAgent::getPosition(float seconds) const {
+    const float GOLDEN_ANGLE = 2.39996f;
+    float homeAngle = _index * GOLDEN_ANGLE;
+    float homeRadius = _options.spread * sqrtf(fmodf(_index * 0.618034f, 1.0f));
+    glm::vec3 home(homeRadius * cosf(homeAngle), 0.0f, homeRadius * sinf(homeAngle));
+
+    float walkAngle = homeAngle + WALK_SPEED * seconds;
+    return home + glm::vec3(WALK_RADIUS * cosf(walkAngle), 0.0f, WALK_RADIUS * sinf(walkAngle));
+}
+
+void SwarmAgent::sendAudio() {
+    if (!serverForChannel(Audio)) {
+        return;
+    }
+
+    // catch up with the frame rate, whatever the timer precision, dropping frames we are too late for
+    quint64 elapsed = usecTimestampNow() - _startUsecs;
+    quint64 framesDue = elapsed / AudioConstants::NETWORK_FRAME_USECS;
+    if (framesDue > _audioFramesSent + MAX_CATCH_UP_AUDIO_FRAMES) {
+        _audioFramesSent = framesDue - MAX_CATCH_UP_AUDIO_FRAMES;
+    }
+
+    float seconds = (float)elapsed / USECS_PER_SECOND;
+    glm::vec3 position = getPosition(seconds);
+    glm::quat orientation = glm::angleAxis(-WALK_SPEED * seconds, Vectors::UNIT_Y);
+    const glm::vec3 AVATAR_DIMENSIONS(0.6f, 1.8f, 0.6f);
+    glm::vec3 boundingBoxCorner = position - 0.5f * AVATAR_DIMENSIONS;
+
+    const auto& loop = speechLoop();
+    for (; _audioFramesSent < framesDue; ++_audioFramesSent) {
+        // alternate talk spurts and pauses as a noise gate would
+        if (--_talkSpurtFrames <= 0) {
+            _isTalking = !_isTalking;
+            _talkSpurtFrames = _isTalking ? randIntInRange(100, 400) : randIntInRange(50, 300);
+        }
+
+        auto packet = NLPacket::create(_isTalking ? PacketType::MicrophoneAudioNoEcho : PacketType::SilentAudioFrame);
+        packet->writePrimitive(_audioSequence++);
+        packet->writeString(QString("pcm"));
+        if (_isTalking) {
+            quint8 channelFlag = 0;
+            packet->writePrimitive(channelFlag);
+        } else {
+            quint16 numSilentSamples = AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL;
+            packet->writePrimitive(numSilentSamples);
+        }
+        packet->writePrimitive(position);
+        packet->writePrimitive(orientation);
+        packet->writePrimitive(boundingBoxCorner);
+        packet->writePrimitive(AVATAR_DIMENSIONS);
+
+        if (_isTalking) {
+            int16_t samples[AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL];
+            for (int i = 0; i < AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL; i++) {
+                samples[i] = loop[(_audioOffset + i) % loop.size()];
+            }
+            packet->write(reinterpret_cast<const char*>(samples), sizeof(samples));
+        }
+        _audioOffset = (_audioOffset + AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL) % loop.size();
+
+        send(std::move(packet), Audio);
+    }
+}
+
+void SwarmAgent::sendAvatarData() {
+    if (!serverForChannel(Avatars)) {
+        return;
+    }
+
+    float seconds = (float)(usecTimestampNow() - _startUsecs) / USECS_PER_SECOND;
+    bool success;
+    _avatar->setWorldPosition(getPosition(seconds), success);
+    _avatar->setWorldOrientation(glm::angleAxis(-WALK_SPEED * seconds, Vectors::UNIT_Y));
+
+    // a skeleton swaying out of phase from joint to joint
+    QVector<JointData> joints(_options.numJoints);
+    for (int i = 0; i < _options.numJoints; i++) {
+        float phase = 2.0f * seconds + 0.5f * i + _index;
+        joints[i].rotation = glm::angleAxis(0.3f * sinf(phase), glm::normalize(glm::vec3(1.0f, 0.1f * i, 0.5f)));
+        joints[i].translation = glm::vec3(0.0f, 0.1f + 0.01f * sinf(phase), 0.0f);
+        joints[i].rotationIsDefaultPose = false;
+        joints[i].translationIsDefaultPose = false;
+    }
+    _avatar->setRawJointData(joints);
+
+    AvatarData::AvatarDataDetail dataDetail = (randFloat() < AVATAR_SEND_FULL_UPDATE_RATIO) ?
+        AvatarData::SendAllData : AvatarData::CullSmallData;
+    QByteArray avatarByteArray = _avatar->toByteArrayStateful(dataDetail);
+
+    int maximumByteArraySize = NLPacket::maxPayloadSize(PacketType::AvatarData) - sizeof(AvatarDataSequenceNumber);
+    if (avatarByteArray.size() > maximumByteArraySize) {
+        avatarByteArray = _avatar->toByteArrayStateful(AvatarData::MinimumData, true);
+    }
+    _avatar->doneEncoding(true);
+
+    auto packet = NLPacket::create(PacketType::AvatarData, avatarByteArray.size() + sizeof(AvatarDataSequenceNumber));
+    packet->writePrimitive(_avatarSequence++);
+    packet->write(avatarByteArray);
+    send(std::move(packet), Avatars);
+}
+
+void SwarmAgent::sendQueriesAndPings() {
+    for (int channel = Audio; channel < NUM_CHANNELS; channel++) {
+        if (serverForChannel((Channel)channel)) {
+            auto pingPacket = NLPacket::create(PacketType::Ping, sizeof(PingType_t) + sizeof(quint64) + sizeof(int64_t));
+            pingPacket->writePrimitive(PingType::Agnostic);
+            pingPacket->writePrimitive(usecTimestampNow());
+            pingPacket->writePrimitive((int64_t)0);
+            send(std::move(pingPacket), (Channel)channel);
+        }
+    }
+
+    float seconds = (float)(usecTimestampNow() - _startUsecs) / USECS_PER_SECOND;
+    ViewFrustum view;
+    view.setPosition(getPosition(seconds) + glm::vec3(0.0f, 1.6f, 0.0f));
+    view.setOrientation(glm::angleAxis(-WALK_SPEED * seconds, Vectors::UNIT_Y));
+    view.setProjection(DEFAULT_FIELD_OF_VIEW_DEGREES, DEFAULT_ASPECT_RATIO, DEFAULT_NEAR_CLIP, DEFAULT_FAR_CLIP);
+    view.calculate();
+    ConicalViewFrustum conicalView { view };
+
+    if (serverForChannel(Avatars)) {
+        auto avatarQuery = NLPacket::create(PacketType::AvatarQuery);
+        auto destinationBuffer = reinterpret_cast<unsigned char*>(avatarQuery->getPayload());
+        uint8_t numFrustums = 1;
+        memcpy(destinationBuffer, &numFrustums, sizeof(numFrustums));
+        int size = sizeof(numFrustums) + conicalView.serialize(destinationBuffer + sizeof(numFrustums));
+        avatarQuery->setPayloadSize(size);
+        send(std::move(avatarQuery), Avatars);
+    }
+
+    if (serverForChannel(Entities)) {
+        _entityQuery->setConicalViews({ conicalView });
+        auto entityQuery = NLPacket::create(PacketType::EntityQuery);
+        int size = _entityQuery->getBroadcastData(reinterpret_cast<unsigned char*>(entityQuery->getPayload()));
+        entityQuery->setPayloadSize(size);
+        send(std::move(entityQuery), Entities);
+    }
+}
+
+// Edits are prefixed with a sequence number and a timestamp, as OctreeEditPacketSender does
+std::unique_ptr<NLPacket> SwarmAgent::createEditPacket(PacketType type, const QByteArray& editMessage) {
+    // adds are sent reliably, like interface does
+    auto packet = NLPacket::create(type, -1, type == PacketType::EntityAdd);
+    packet->writePrimitive(_editSequence++);
+    packet->writePrimitive(usecTimestampNow());
+    packet->write(editMessage);
+    return packet;
+}
+
+void SwarmAgent::addEntities() {
+    if (_entitiesAdded || !serverForChannel(Entities)) {
+        return;
+    }
+    _entitiesAdded = true;
+
+    if (_entityIDs.empty()) {
+        for (int i = 0; i < _options.numEntities; i++) {
+            _entityIDs.push_back(QUuid::createUuid());
+        }
+    }
+
+    float seconds = (float)(usecTimestampNow() - _startUsecs) / USECS_PER_SECOND;
+    for (size_t i = 0; i < _entityIDs.size(); i++) {
+        EntityItemProperties properties;
+        properties.setType(EntityTypes::Box);
+        properties.setName(QString("swarm-%1-%2").arg(_index).arg(i));
+        properties.setPosition(getPosition(seconds) + glm::vec3(ENTITY_ORBIT_RADIUS, 1.0f + i, 0.0f));
+        properties.setDimensions(glm::vec3(0.3f));
+        properties.setCollisionless(true);
+        properties.setLifetime((float)(_options.durationSecs + ENTITY_LIFETIME_MARGIN_SECS));
+        properties.setLastEdited(usecTimestampNow());
+
+        QByteArray editMessage(NLPacket::maxPayloadSize(PacketType::EntityAdd), 0);
+        EntityPropertyFlags didntFitProperties;
+        if (EntityItemProperties::encodeEntityEditPacket(PacketType::EntityAdd, _entityIDs[i], properties, editMessage,
+                                                         properties.getChangedProperties(), didntFitProperties)
+                != OctreeElement::NONE) {
+            send(createEditPacket(PacketType::EntityAdd, editMessage), Entities);
+        }
+    }
+}
+
+void SwarmAgent::sendEntityEdit() {
+    if (!_entitiesAdded || _entityIDs.empty()) {
+        return;
+    }
+
+    // the entities orbit the agent, one of them moves each tick
+    size_t i = _nextEntityEdit++ % _entityIDs.size();
+    float seconds = (float)(usecTimestampNow() - _startUsecs) / USECS_PER_SECOND;
+    float angle = seconds + TWO_PI * i / _entityIDs.size();
+
+    EntityItemProperties properties;
+    properties.setPosition(getPosition(seconds) +
+        glm::vec3(ENTITY_ORBIT_RADIUS * cosf(angle), 1.0f + i, ENTITY_ORBIT_RADIUS * sinf(angle)));
+    properties.setLastEdited(usecTimestampNow());
+
+    QByteArray editMessage(NLPacket::maxPayloadSize(PacketType::EntityEdit), 0);
+    EntityPropertyFlags didntFitProperties;
+    if (EntityItemProperties::encodeEntityEditPacket(PacketType::EntityEdit, _entityIDs[i], properties, editMessage,
+                                                     properties.getChangedProperties(), didntFitProperties)
+            != OctreeElement::NONE) {
+        send(createEditPacket(PacketType::EntityEdit, editMessage), Entities);
+    }
+}
+
+void SwarmAgent::eraseEntities() {
+    if (!_entitiesAdded) {
+        return;
+    }
+    for (const auto& entityID : _entityIDs) {
+        QByteArray editMessage(NLPacket::maxPayloadSize(PacketType::EntityErase), 0);
+        if (EntityItemProperties::encodeEraseEntityMessage(entityID, editMessage)) {
+            send(createEditPacket(PacketType::EntityErase, editMessage), Entities);
+        }
+    }
+    _entitiesAdded = false;
+}
@@ -0,0 +1,166 @@
+//
+//  SwarmAgent.h
+//  tools/swarm/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_SwarmAgent_h
+#define hifi_SwarmAgent_h
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <QObject>
+#include <QTimer>
+#include <QUuid>
+
+#include <glm/glm.hpp>
+
+#include <HifiSockAddr.h>
+#include <HMACAuth.h>
+#include <NLPacket.h>
+#include <NodeType.h>
+#include <udt/Socket.h>
+
+class AvatarData;
+class OctreeQuery;
+
+// One synthetic user.  An agent speaks the client side of the protocol on its own socket, without a NodeList, so that many
+// of them can share one process: it checks in with the domain-server, answers the pings of the mixers and sends them
+// microphone audio, avatar motion, queries and entity edits at the rates interface does.
+class SwarmAgent : public QObject {
+    Q_OBJECT
+public:
+    struct Options {
+        HifiSockAddr domainServer;
+        int numJoints { 60 };
+        int numEntities { 2 };
+        float entityEditRate { 2.0f }; // edits per second of each entity
+        float spread { 20.0f }; // radius of the circle the agents are placed on
+        int durationSecs { 30 };
+    };
+
+    // where traffic went to or came from
+    enum Channel {
+        Domain = 0,
+        Audio,
+        Avatars,
+        Entities,
+        NUM_CHANNELS
+    };
+
+    struct Counters {
+        std::atomic<quint64> packets { 0 };
+        std::atomic<quint64> bytes { 0 };
+    };
+
+    struct PingStats {
+        std::atomic<quint64> numReplies { 0 };
+        std::atomic<quint64> totalUsecs { 0 };
+        std::atomic<quint64> maxUsecs { 0 };
+    };
+
+    SwarmAgent(int index, const Options& options);
+    ~SwarmAgent();
+
+    static QString getChannelName(Channel channel);
+
+    bool hasConnected() const { return _connectUsecs > 0; }
+    quint64 getConnectUsecs() const { return _connectUsecs; }
+    QString getDeniedReason() const;
+
+    const Counters& getSent(Channel channel) const { return _sent[channel]; }
+    const Counters& getReceived(Channel channel) const { return _received[channel]; }
+    const PingStats& getPingStats(Channel channel) const { return _pings[channel]; }
+
+public slots:
+    // must be called on the thread the agent was moved to
+    void start();
+    void stop();
+
+private slots:
+    void sendDomainCheckIn();
+    void sendAudio();
+    void sendAvatarData();
+    void sendQueriesAndPings();
+    void sendEntityEdit();
+
+private:
+    struct Server {
+        QUuid uuid;
+        HifiSockAddr sockAddr;
+        NLPacket::LocalID localID { 0 };
+        std::unique_ptr<HMACAuth> hmac;
+        bool heardFrom { false };
+    };
+
+    void handlePacket(std::unique_ptr<udt::Packet> packet);
+    void processDomainList(NLPacket& packet);
+    void processPing(NLPacket& packet, Channel channel);
+    void processPingReply(NLPacket& packet, Channel channel);
+    void checkConnected();
+
+    Channel channelForSockAddr(const HifiSockAddr& sockAddr) const;
+    Server* serverForChannel(Channel channel);
+    void send(std::unique_ptr<NLPacket> packet, Channel channel, const HifiSockAddr* overrideSockAddr = nullptr);
+
+    glm::vec3 getPosition(float seconds) const;
+    std::unique_ptr<NLPacket> createEditPacket(PacketType type, const QByteArray& editMessage);
+    void addEntities();
+    void eraseEntities();
+
+    const int _index;
+    const Options _options;
+
+    udt::Socket* _socket { nullptr };
+    QTimer* _checkInTimer { nullptr };
+    QTimer* _audioTimer { nullptr };
+    QTimer* _avatarTimer { nullptr };
+    QTimer* _queryTimer { nullptr };
+    QTimer* _entityTimer { nullptr };
+
+    // domain session
+    QUuid _domainUUID;
+    NLPacket::LocalID _domainLocalID { 0 };
+    QUuid _sessionUUID;
+    NLPacket::LocalID _sessionLocalID { 0 };
+    bool _authenticatePackets { false };
+    QUuid _machineFingerprint;
+    mutable std::mutex _deniedReasonMutex;
+    QString _deniedReason;
+
+    Server _servers[NUM_CHANNELS];
+
+    quint64 _startUsecs { 0 };
+    std::atomic<quint64> _connectUsecs { 0 };
+
+    // audio
+    quint16 _audioSequence { 0 };
+    quint64 _audioFramesSent { 0 };
+    size_t _audioOffset { 0 };
+    int _talkSpurtFrames { 0 };
+    bool _isTalking { false };
+
+    // avatar
+    std::unique_ptr<AvatarData> _avatar;
+    quint16 _avatarSequence { 0 };
+
+    // entities
+    std::unique_ptr<OctreeQuery> _entityQuery;
+    std::vector<QUuid> _entityIDs;
+    bool _entitiesAdded { false };
+    size_t _nextEntityEdit { 0 };
+    quint16 _editSequence { 0 };
+
+    Counters _sent[NUM_CHANNELS];
+    Counters _received[NUM_CHANNELS];
+    PingStats _pings[NUM_CHANNELS];
+};
+
+#endif // hifi_SwarmAgent_h
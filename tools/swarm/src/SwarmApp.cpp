@@ -0,0 +1,370 @@
+//
+//  SwarmApp.cpp
+//  tools/swarm/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SwarmApp.h"
+
+#include <algorithm>
+#include <iostream>
+
+#include <QCommandLineParser>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QLoggingCategory>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+
+#include <DomainHandler.h>
+#include <NetworkAccessManager.h>
+#include <NetworkLogging.h>
+#include <NumericalConstants.h>
+#include <SharedLogging.h>
+#include <SharedUtil.h>
+
+static const QString DEFAULT_REPORT_PATH = "swarm-report.json";
+static const int MAX_FINAL_STATS_WAIT_MSECS = 5000;
+
+SwarmApp::SwarmApp(int argc, char* argv[]) :
+    QCoreApplication(argc, argv)
+{
+    QCommandLineParser parser;
+    parser.setApplicationDescription("High Fidelity mixer load generator");
+
+    const QCommandLineOption helpOption = parser.addHelpOption();
+
+    const QCommandLineOption verboseOutput("v", "verbose output");
+    parser.addOption(verboseOutput);
+
+    const QCommandLineOption domainAddressOption("d", "domain-server address", "127.0.0.1:40102");
+    parser.addOption(domainAddressOption);
+
+    const QCommandLineOption httpPortOption("httpPort", "domain-server HTTP port the mixer stats are read from",
+                                            QString::number(DOMAIN_SERVER_HTTP_PORT));
+    parser.addOption(httpPortOption);
+
+    const QCommandLineOption agentsOption("agents", "number of synthetic agents", "10");
+    parser.addOption(agentsOption);
+
+    const QCommandLineOption durationOption("duration", "seconds to run the full load for", "30");
+    parser.addOption(durationOption);
+
+    const QCommandLineOption rampUpOption("rampUp", "seconds over which the agents are started", "5");
+    parser.addOption(rampUpOption);
+
+    const QCommandLineOption threadsOption("threads", "threads the agents are spread over", "cores");
+    parser.addOption(threadsOption);
+
+    const QCommandLineOption jointsOption("joints", "avatar joints each agent animates", "60");
+    parser.addOption(jointsOption);
+
+    const QCommandLineOption entitiesOption("entities", "entities each agent adds and keeps editing", "2");
+    parser.addOption(entitiesOption);
+
+    const QCommandLineOption editRateOption("editRate", "edits per second of each entity", "2");
+    parser.addOption(editRateOption);
+
+    const QCommandLineOption spreadOption("spread", "radius in meters of the area the agents are placed in", "20");
+    parser.addOption(spreadOption);
+
+    const QCommandLineOption statsIntervalOption("statsInterval", "seconds between polls of the mixer stats", "5");
+    parser.addOption(statsIntervalOption);
+
+    const QCommandLineOption reportOption("report", "file the JSON report is written to, - for stdout", DEFAULT_REPORT_PATH);
+    parser.addOption(reportOption);
+
+    if (!parser.parse(QCoreApplication::arguments())) {
+        qCritical() << parser.errorText() << endl;
+        parser.showHelp();
+        Q_UNREACHABLE();
+    }
+
+    if (parser.isSet(helpOption)) {
+        parser.showHelp();
+        Q_UNREACHABLE();
+    }
+
+    _verbose = parser.isSet(verboseOutput);
+    if (!_verbose) {
+        const_cast<QLoggingCategory*>(&networking())->setEnabled(QtDebugMsg, false);
+        const_cast<QLoggingCategory*>(&networking())->setEnabled(QtInfoMsg, false);
+        const_cast<QLoggingCategory*>(&networking())->setEnabled(QtWarningMsg, false);
+
+        const_cast<QLoggingCategory*>(&shared())->setEnabled(QtDebugMsg, false);
+        const_cast<QLoggingCategory*>(&shared())->setEnabled(QtInfoMsg, false);
+        const_cast<QLoggingCategory*>(&shared())->setEnabled(QtWarningMsg, false);
+    }
+
+    QString domainServerAddress = parser.isSet(domainAddressOption) ? parser.value(domainAddressOption) : "127.0.0.1:40102";
+    QStringList addressPieces = domainServerAddress.split(":");
+    quint16 domainPort = addressPieces.size() > 1 ? addressPieces[1].toUShort() : DEFAULT_DOMAIN_SERVER_PORT;
+    _agentOptions.domainServer = HifiSockAddr(addressPieces[0], domainPort, true);
+
+    _httpPort = parser.isSet(httpPortOption) ? parser.value(httpPortOption).toUShort() : DOMAIN_SERVER_HTTP_PORT;
+    _numAgents = parser.isSet(agentsOption) ? std::max(parser.value(agentsOption).toInt(), 1) : _numAgents;
+    _agentOptions.durationSecs = parser.isSet(durationOption) ? std::max(parser.value(durationOption).toInt(), 1)
+                                                              : _agentOptions.durationSecs;
+    _rampUpSecs = parser.isSet(rampUpOption) ? std::max(parser.value(rampUpOption).toInt(), 0) : _rampUpSecs;
+    _agentOptions.numJoints = parser.isSet(jointsOption) ? glm::clamp(parser.value(jointsOption).toInt(), 0, 255)
+                                                          : _agentOptions.numJoints;
+    _agentOptions.numEntities = parser.isSet(entitiesOption) ? std::max(parser.value(entitiesOption).toInt(), 0)
+                                                              : _agentOptions.numEntities;
+    _agentOptions.entityEditRate = parser.isSet(editRateOption) ? std::max(parser.value(editRateOption).toFloat(), 0.0f)
+                                                                 : _agentOptions.entityEditRate;
+    _agentOptions.spread = parser.isSet(spreadOption) ? std::max(parser.value(spreadOption).toFloat(), 0.0f)
+                                                       : _agentOptions.spread;
+    _statsIntervalSecs = parser.isSet(statsIntervalOption) ? std::max(parser.value(statsIntervalOption).toInt(), 1)
+                                                            : _statsIntervalSecs;
+    _reportPath = parser.isSet(reportOption) ? parser.value(reportOption) : DEFAULT_REPORT_PATH;
+
+    int numThreads = parser.isSet(threadsOption) ? parser.value(threadsOption).toInt() : QThread::idealThreadCount();
+    numThreads = glm::clamp(numThreads, 1, _numAgents);
+    for (int i = 0; i < numThreads; i++) {
+        auto thread = new QThread(this);
+        thread->setObjectName(QString("Swarm Agents %1").arg(i));
+        thread->start();
+        _threads.push_back(thread);
+    }
+
+    qDebug() << "Starting" << _numAgents << "agents on" << numThreads << "threads over" << _rampUpSecs << "seconds against"
+        << _agentOptions.domainServer << ", full load for" << _agentOptions.durationSecs << "seconds";
+
+    _startUsecs = usecTimestampNow();
+
+    _rampUpTimer = new QTimer(this);
+    connect(_rampUpTimer, &QTimer::timeout, this, &SwarmApp::startNextAgent);
+    _rampUpTimer->start(std::max(_rampUpSecs * (int)MSECS_PER_SECOND / _numAgents, 1));
+
+    _statsTimer = new QTimer(this);
+    connect(_statsTimer, &QTimer::timeout, this, &SwarmApp::pollMixerStats);
+    _statsTimer->start(_statsIntervalSecs * (int)MSECS_PER_SECOND);
+}
+
+SwarmApp::~SwarmApp() {
+    for (auto thread : _threads) {
+        thread->quit();
+        thread->wait();
+    }
+}
+
+void SwarmApp::startNextAgent() {
+    int index = (int)_agents.size();
+    auto agent = new SwarmAgent(index, _agentOptions);
+    QThread* thread = _threads[index % _threads.size()];
+    agent->moveToThread(thread);
+    connect(thread, &QThread::finished, agent, &QObject::deleteLater);
+    QMetaObject::invokeMethod(agent, "start");
+    _agents.push_back(agent);
+
+    if ((int)_agents.size() == _numAgents) {
+        _rampUpTimer->stop();
+
+        // the agents that started last still have to connect, measure from when they had a few seconds to
+        const int CONNECT_GRACE_MSECS = 3000;
+        QTimer::singleShot(CONNECT_GRACE_MSECS, this, [this] {
+            _loadStartUsecs = usecTimestampNow();
+            _loadStartTotals = getTotals();
+            QTimer::singleShot(_agentOptions.durationSecs * (int)MSECS_PER_SECOND, this, &SwarmApp::finish);
+        });
+    }
+}
+
+SwarmApp::Totals SwarmApp::getTotals() const {
+    Totals totals;
+    for (auto agent : _agents) {
+        for (int i = 0; i < SwarmAgent::NUM_CHANNELS; i++) {
+            auto channel = (SwarmAgent::Channel)i;
+            totals.sentPackets[i] += agent->getSent(channel).packets;
+            totals.sentBytes[i] += agent->getSent(channel).bytes;
+            totals.receivedPackets[i] += agent->getReceived(channel).packets;
+            totals.receivedBytes[i] += agent->getReceived(channel).bytes;
+        }
+    }
+    return totals;
+}
+
+void SwarmApp::pollMixerStats() {
+    float seconds = (float)(usecTimestampNow() - _startUsecs) / USECS_PER_SECOND;
+    QUrl nodesURL(QString("http://%1:%2/nodes.json").arg(_agentOptions.domainServer.getAddress().toString()).arg(_httpPort));
+
+    ++_pendingStatsRequests;
+    QNetworkReply* reply = NetworkAccessManager::getInstance().get(QNetworkRequest(nodesURL));
+    connect(reply, &QNetworkReply::finished, this, [this, reply, seconds] {
+        reply->deleteLater();
+        if (reply->error() == QNetworkReply::NoError) {
+            QJsonArray nodes = QJsonDocument::fromJson(reply->readAll()).object()["nodes"].toArray();
+            for (const auto& node : nodes) {
+                QString type = node.toObject()["type"].toString();
+                for (int channel = SwarmAgent::Audio; channel < SwarmAgent::NUM_CHANNELS; channel++) {
+                    if (type == SwarmAgent::getChannelName((SwarmAgent::Channel)channel)) {
+                        requestNodeStats(node.toObject()["uuid"].toString(), type, seconds);
+                    }
+                }
+            }
+        } else if (_verbose) {
+            qDebug() << "Failed to read the domain nodes:" << reply->errorString();
+        }
+        statsRequestDone();
+    });
+}
+
+void SwarmApp::requestNodeStats(const QString& uuid, const QString& type, float seconds) {
+    QUrl statsURL(QString("http://%1:%2/nodes/%3.json").arg(_agentOptions.domainServer.getAddress().toString())
+                  .arg(_httpPort).arg(uuid));
+
+    ++_pendingStatsRequests;
+    QNetworkReply* reply = NetworkAccessManager::getInstance().get(QNetworkRequest(statsURL));
+    connect(reply, &QNetworkReply::finished, this, [this, reply, uuid, type, seconds] {
+        reply->deleteLater();
+        if (reply->error() == QNetworkReply::NoError) {
+            QJsonObject sample;
+            sample["time_secs"] = seconds;
+            sample["stats"] = QJsonDocument::fromJson(reply->readAll()).object();
+
+            QJsonObject mixer = _mixers[uuid].toObject();
+            QJsonArray samples = mixer["samples"].toArray();
+            samples.append(sample);
+            mixer["type"] = type;
+            mixer["samples"] = samples;
+            _mixers[uuid] = mixer;
+        }
+        statsRequestDone();
+    });
+}
+
+void SwarmApp::statsRequestDone() {
+    --_pendingStatsRequests;
+    if (_isFinishing && _pendingStatsRequests == 0) {
+        exitWithReport();
+    }
+}
+
+void SwarmApp::finish() {
+    _loadEndUsecs = usecTimestampNow();
+    _loadEndTotals = getTotals();
+    _statsTimer->stop();
+
+    for (auto agent : _agents) {
+        QMetaObject::invokeMethod(agent, "stop", Qt::BlockingQueuedConnection);
+    }
+
+    // one last look at the mixers while they still carry the load
+    _isFinishing = true;
+    pollMixerStats();
+    QTimer::singleShot(MAX_FINAL_STATS_WAIT_MSECS, this, &SwarmApp::exitWithReport);
+}
+
+QJsonObject SwarmApp::createReport() const {
+    float loadSeconds = std::max((float)(_loadEndUsecs - _loadStartUsecs) / USECS_PER_SECOND, 1.0f);
+
+    int numConnected = 0;
+    int numDenied = 0;
+    quint64 minConnectUsecs = UINT64_MAX;
+    quint64 maxConnectUsecs = 0;
+    quint64 totalConnectUsecs = 0;
+    for (auto agent : _agents) {
+        if (agent->hasConnected()) {
+            quint64 connectUsecs = agent->getConnectUsecs();
+            ++numConnected;
+            minConnectUsecs = std::min(minConnectUsecs, connectUsecs);
+            maxConnectUsecs = std::max(maxConnectUsecs, connectUsecs);
+            totalConnectUsecs += connectUsecs;
+        } else if (!agent->getDeniedReason().isEmpty()) {
+            ++numDenied;
+        }
+    }
+
+    QJsonObject report;
+    report["agents"] = _numAgents;
+    report["connected_agents"] = numConnected;
+    report["denied_agents"] = numDenied;
+    report["threads"] = (int)_threads.size();
+    report["ramp_up_secs"] = _rampUpSecs;
+    report["load_secs"] = loadSeconds;
+    report["joints_per_agent"] = _agentOptions.numJoints;
+    report["entities_per_agent"] = _agentOptions.numEntities;
+    report["entity_edit_rate"] = _agentOptions.entityEditRate;
+
+    if (numConnected > 0) {
+        QJsonObject connectTime;
+        connectTime["min"] = (double)minConnectUsecs / USECS_PER_MSEC;
+        connectTime["mean"] = (double)totalConnectUsecs / numConnected / USECS_PER_MSEC;
+        connectTime["max"] = (double)maxConnectUsecs / USECS_PER_MSEC;
+        report["connect_time_msecs"] = connectTime;
+    }
+
+    // traffic rates are over the full load only, the totals include the ramp up
+    auto traffic = [&](quint64 startPackets, quint64 endPackets, quint64 startBytes, quint64 endBytes) {
+        QJsonObject object;
+        object["total_packets"] = (double)endPackets;
+        object["total_bytes"] = (double)endBytes;
+        object["packets_per_second"] = (endPackets - startPackets) / loadSeconds;
+        object["kbps"] = (endBytes - startBytes) / (loadSeconds * BYTES_PER_KILOBIT);
+        return object;
+    };
+
+    QJsonObject channels;
+    for (int i = 0; i < SwarmAgent::NUM_CHANNELS; i++) {
+        auto channel = (SwarmAgent::Channel)i;
+        QJsonObject channelObject;
+        channelObject["sent"] = traffic(_loadStartTotals.sentPackets[i], _loadEndTotals.sentPackets[i],
+                                        _loadStartTotals.sentBytes[i], _loadEndTotals.sentBytes[i]);
+        channelObject["received"] = traffic(_loadStartTotals.receivedPackets[i], _loadEndTotals.receivedPackets[i],
+                                            _loadStartTotals.receivedBytes[i], _loadEndTotals.receivedBytes[i]);
+
+        quint64 numReplies = 0;
+        quint64 totalUsecs = 0;
+        quint64 maxUsecs = 0;
+        for (auto agent : _agents) {
+            const auto& pings = agent->getPingStats(channel);
+            numReplies += pings.numReplies;
+            totalUsecs += pings.totalUsecs;
+            maxUsecs = std::max(maxUsecs, (quint64)pings.maxUsecs);
+        }
+        if (numReplies > 0) {
+            QJsonObject ping;
+            ping["replies"] = (double)numReplies;
+            ping["mean"] = (double)totalUsecs / numReplies / USECS_PER_MSEC;
+            ping["max"] = (double)maxUsecs / USECS_PER_MSEC;
+            channelObject["ping_msecs"] = ping;
+        }
+        channels[SwarmAgent::getChannelName(channel)] = channelObject;
+    }
+    report["agent_traffic"] = channels;
+    report["mixers"] = _mixers;
+    return report;
+}
+
+void SwarmApp::exitWithReport() {
+    static bool hasExited = false;
+    if (hasExited) {
+        return;
+    }
+    hasExited = true;
+
+    QJsonObject report = createReport();
+    QByteArray json = QJsonDocument(report).toJson();
+    if (_reportPath == "-") {
+        std::cout << json.constData();
+    } else {
+        QFile reportFile(_reportPath);
+        if (reportFile.open(QIODevice::WriteOnly)) {
+            reportFile.write(json);
+            qDebug() << "Report written to" << _reportPath;
+        } else {
+            qCritical() << "Unable to write the report to" << _reportPath;
+        }
+    }
+
+    // a perf gate fails when the domain could not take every agent
+    int numConnected = report["connected_agents"].toInt();
+    qDebug() << numConnected << "of" << _numAgents << "agents connected to every mixer," << _mixers.size()
+        << "mixers reported stats";
+    QCoreApplication::exit(numConnected == _numAgents ? 0 : 1);
+}
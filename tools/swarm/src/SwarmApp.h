@@ -0,0 +1,75 @@
+//
+//  SwarmApp.h
+//  tools/swarm/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_SwarmApp_h
+#define hifi_SwarmApp_h
+
+#include <vector>
+
+#include <QCoreApplication>
+#include <QJsonObject>
+#include <QThread>
+#include <QTimer>
+
+#include "SwarmAgent.h"
+
+// Runs a swarm of synthetic agents against a local domain and writes what the mixers and the agents saw to a JSON report.
+// The mixer stats are polled from the domain-server's HTTP interface while the load runs.
+class SwarmApp : public QCoreApplication {
+    Q_OBJECT
+public:
+    SwarmApp(int argc, char* argv[]);
+    ~SwarmApp();
+
+private slots:
+    void startNextAgent();
+    void pollMixerStats();
+    void finish();
+
+private:
+    // per channel totals over every agent
+    struct Totals {
+        quint64 sentPackets[SwarmAgent::NUM_CHANNELS] {};
+        quint64 sentBytes[SwarmAgent::NUM_CHANNELS] {};
+        quint64 receivedPackets[SwarmAgent::NUM_CHANNELS] {};
+        quint64 receivedBytes[SwarmAgent::NUM_CHANNELS] {};
+    };
+
+    Totals getTotals() const;
+    void requestNodeStats(const QString& uuid, const QString& type, float seconds);
+    void statsRequestDone();
+    QJsonObject createReport() const;
+    void exitWithReport();
+
+    bool _verbose { false };
+    SwarmAgent::Options _agentOptions;
+    int _numAgents { 10 };
+    int _rampUpSecs { 5 };
+    int _statsIntervalSecs { 5 };
+    quint16 _httpPort { 0 };
+    QString _reportPath;
+
+    std::vector<QThread*> _threads;
+    std::vector<SwarmAgent*> _agents;
+    QTimer* _rampUpTimer { nullptr };
+    QTimer* _statsTimer { nullptr };
+
+    quint64 _startUsecs { 0 };
+    quint64 _loadStartUsecs { 0 };
+    quint64 _loadEndUsecs { 0 };
+    Totals _loadStartTotals;
+    Totals _loadEndTotals;
+
+    QJsonObject _mixers; // stats samples by node UUID
+    int _pendingStatsRequests { 0 };
+    bool _isFinishing { false };
+};
+
+#endif // hifi_SwarmApp_h
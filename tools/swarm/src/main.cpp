@@ -0,0 +1,23 @@
+//
+//  main.cpp
+//  tools/swarm/src
+//
+//  Copyright 2019 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <SettingInterface.h>
+#include <SharedUtil.h>
+
+#include "SwarmApp.h"
+
+int main(int argc, char* argv[]) {
+    setupHifiApplication("Swarm");
+
+    Setting::init();
+
+    SwarmApp app(argc, argv);
+    return app.exec();
+}